@@ -10,7 +10,6 @@
 #include "point_light_entity.hpp"
 #include "two_d_entity.hpp"
 #include "ae_image.hpp"
-#include "radix_sort.hpp"
 
 // libraries
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -20,7 +19,15 @@ namespace ae {
     // The constructor of the Arundos application. Sets up the base application.
     Arundos::Arundos() {
 
-        test_radix_sort();
+        // Measure the allocators that have their own memory against the budgets as well.
+        m_memoryManager.trackAllocator("ecs stack", ae_memory::memoryTag_ecs, m_deStackAllocator, 0, m_ecsMemoryBudget);
+        for (std::size_t i = 0; i < m_frameArenas.getNumFrames(); i++) {
+            m_memoryManager.trackAllocator("frame arena " + std::to_string(i),
+                                           ae_memory::memoryTag_frame,
+                                           m_frameArenas.getArena(i),
+                                           0,
+                                           m_frameMemoryBudget);
+        };
 
         // Load the default game objects into the scene.
         loadGameObjects();
@@ -47,6 +54,19 @@ namespace ae {
             // Instruct the entity component system (ECS) to run it's system to update applicable entity component data.
             m_aeECS.runSystems();
 
+            // Measure the memory in use against the budgets once a frame.
+            m_memoryManager.update();
+            AE_MEMORY_TRACK_END_FRAME();
+
+#ifdef ECS_DEBUG
+            // Dump the ECS and memory statistics periodically to help size the ECS limits, allocators, and budgets.
+            if (++m_ecsStatsFrameCounter >= ECS_STATS_DUMP_INTERVAL) {
+                m_ecsStatsFrameCounter = 0;
+                m_aeECS.getStats().writeJson("ecs_stats.json");
+                m_memoryManager.writeJson("memory_stats.json");
+            }
+#endif
+
             // TODO allow for option to limit frame timing, aka lock FPS, if desired but allow other systems to continue to run
             //time_delta = glm::min(time_delta, MAX_FRAME_TIME);
         }
@@ -55,6 +75,11 @@ namespace ae {
         vkDeviceWaitIdle(m_aeDevice.device());
 
         m_aeECS.destroyAllEntities();
+
+#ifdef AE_MEMORY_TRACKING
+        // Everything still allocated once the entities are destroyed is written out to look for leaks.
+        ae_memory::AeAllocationTracker::getInstance().writeJson("allocation_dump.json");
+#endif
     }
 
 
@@ -77,7 +102,7 @@ namespace ae {
 
         //==============================================================================================================
         // Load the flat vase object model from the file
-        std::shared_ptr<Ae3DModel> aeModel = m_aeResourceManager.use3DModel("assets_NOTPRODUCTION/models/TEMP_flat_vase.obj");
+        Ae3DModelHandle aeModel = m_aeResourceManager.use3DModel("assets_NOTPRODUCTION/models/TEMP_flat_vase.obj");
         // ECS version of flatVase
         auto testFlatVase = GameObjectEntity(m_aeECS, m_gameComponents);
         testFlatVase.m_worldPosition = {-0.5f, 0.5f, 0.0f};
@@ -86,7 +111,7 @@ namespace ae {
 
 
         auto &testFlatVaseProperties = m_gameMaterials.m_simpleMaterial.m_materialComponent.requiredByEntityReference(testFlatVase.getEntityId());
-        testFlatVaseProperties.m_fragmentTextures[0].m_texture = nullptr;
+        testFlatVaseProperties.m_fragmentTextures[0].m_texture = {};
         testFlatVaseProperties.m_fragmentTextures[0].m_sampler = nullptr;
 
         testFlatVase.enableEntity();
@@ -102,7 +127,7 @@ namespace ae {
 
 
         auto &testSmoothVaseProperties = m_gameMaterials.m_simpleMaterial.m_materialComponent.requiredByEntityReference(testSmoothVase.getEntityId());
-        testSmoothVaseProperties.m_fragmentTextures[0].m_texture = nullptr;
+        testSmoothVaseProperties.m_fragmentTextures[0].m_texture = {};
         testSmoothVaseProperties.m_fragmentTextures[0].m_sampler = nullptr;
 
         testSmoothVase.enableEntity();
@@ -118,7 +143,7 @@ namespace ae {
 
 
         auto &testFloorProperties = m_gameMaterials.m_simpleMaterial.m_materialComponent.requiredByEntityReference(testFloor.getEntityId());
-        testFloorProperties.m_fragmentTextures[0].m_texture = nullptr;
+        testFloorProperties.m_fragmentTextures[0].m_texture = {};
         testFloorProperties.m_fragmentTextures[0].m_sampler = nullptr;
 
         testFloor.enableEntity();
@@ -126,8 +151,8 @@ namespace ae {
 
         // Load the viking object model from the file
         aeModel = m_aeResourceManager.use3DModel("assets_NOTPRODUCTION/models/TEMP_viking_room.obj");
-        std::shared_ptr<AeImage> aeImage = AeImage::createImageFromFile(m_aeDevice,
-                                                                        "assets_NOTPRODUCTION/models/TEMP_viking_room.png");
+        AeImageHandle aeImage = m_aeResourceManager.useImage(
+                "assets_NOTPRODUCTION/models/TEMP_viking_room.png");
         // ECS version of the floor
         auto vikingRoom = GameObjectEntity(m_aeECS, m_gameComponents);
         vikingRoom.m_worldPosition = {0.0f, 0.25f, 1.5f};
@@ -310,7 +335,7 @@ namespace ae {
                 {{0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}}
         };
 
-        aeImage = AeImage::createImageFromFile(m_aeDevice, "assets_NOTPRODUCTION/ui_textures/TEMP_statue.jpg");
+        aeImage = m_aeResourceManager.useImage("assets_NOTPRODUCTION/ui_textures/TEMP_statue.jpg");
         std::shared_ptr<Ae2DModel> ae2DModel = Ae2DModel::createModelFromFile(m_aeDevice, vertices);
         // ECS version of the floor
         auto triangle = TwoDEntity(m_aeECS,m_gameComponents);
@@ -0,0 +1,196 @@
+/// \file ae_alloc_bench.cpp
+/// Replays allocation traces against every engine allocator and the system allocator, and reports the throughput,
+/// latency, peak resident set size, and fragmentation of each.
+///
+/// Usage: ae_alloc_bench [options]
+///   --ops <n>            The number of operations of each synthetic trace, 1000000 by default.
+///   --repetitions <n>    The number of times each case is replayed to measure the throughput, 5 by default.
+///   --threads <n>        The number of threads of the multi-threaded case, up to 8 by default.
+///   --memory <MiB>       The memory given to each engine allocator, 128 by default.
+///   --seed <n>           The seed of the synthetic traces.
+///   --trace <file>       Also replays a recorded trace, may be given more than once.
+///   --case <text>        Only replays the cases whose name contains the text.
+///   --subject <text>     Only replays against the subjects whose name contains the text. The free list allocator
+///                        is only replayed when chosen this way.
+///   --write-traces <dir> Writes the synthetic traces to a directory, to be edited and replayed with --trace.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "ae_allocation_benchmark.hpp"
+#include "ae_allocation_trace.hpp"
+#include "ae_benchmark_subjects.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::size_t m_numOps = 1000000;
+        std::size_t m_numRepetitions = 5;
+        std::size_t m_numThreads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 8);
+        std::size_t m_memorySizeMiB = 128;
+        std::uint64_t m_seed = 0x5eed;
+        std::vector<std::string> m_traceFilepaths;
+        std::string m_caseFilter;
+        std::string m_subjectFilter;
+        std::string m_traceDirectory;
+        std::string m_jsonFilepath;
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_alloc_bench [options]\n"
+                     "  --ops <n>            Operations of each synthetic trace (default 1000000)\n"
+                     "  --repetitions <n>    Replays of each case to measure the throughput (default 5)\n"
+                     "  --threads <n>        Threads of the multi-threaded case (default up to 8)\n"
+                     "  --memory <MiB>       Memory given to each engine allocator (default 128)\n"
+                     "  --seed <n>           Seed of the synthetic traces\n"
+                     "  --trace <file>       Also replay a recorded trace, may be repeated\n"
+                     "  --case <text>        Only replay cases whose name contains the text\n"
+                     "  --subject <text>     Only replay against subjects whose name contains the text,\n"
+                     "                       the free list allocator is only replayed when chosen\n"
+                     "  --write-traces <dir> Write the synthetic traces to a directory\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--ops") {
+                options.m_numOps = std::stoull(value);
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::stoull(value);
+            } else if (option == "--threads") {
+                options.m_numThreads = std::max<std::size_t>(std::stoull(value), 2);
+            } else if (option == "--memory") {
+                options.m_memorySizeMiB = std::stoull(value);
+            } else if (option == "--seed") {
+                options.m_seed = std::stoull(value);
+            } else if (option == "--trace") {
+                options.m_traceFilepaths.push_back(value);
+            } else if (option == "--case") {
+                options.m_caseFilter = value;
+            } else if (option == "--subject") {
+                options.m_subjectFilter = value;
+            } else if (option == "--write-traces") {
+                options.m_traceDirectory = value;
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Creates the synthetic cases and loads the recorded ones.
+    std::vector<ae_bench::AeBenchmarkCase> createCases(const BenchmarkOptions& t_options) {
+        using ae_bench::AeAllocationTrace;
+        std::size_t numOps = t_options.m_numOps;
+        std::uint64_t seed = t_options.m_seed;
+
+        std::vector<ae_bench::AeBenchmarkCase> cases;
+        auto addCase = [&](AeAllocationTrace t_trace) {
+            std::string name = t_trace.getName();
+            std::vector<AeAllocationTrace> traces;
+            traces.push_back(std::move(t_trace));
+            cases.push_back({std::move(name), std::move(traces)});
+        };
+
+        addCase(AeAllocationTrace::createFixedSize("fixed size", numOps, 64, 4096, seed));
+        addCase(AeAllocationTrace::createMixedSize("mixed size", numOps, 16, 4096, 4096, seed + 1));
+        addCase(AeAllocationTrace::createLifo("lifo", numOps, 16, 4096, 256, seed + 2));
+        addCase(AeAllocationTrace::createRandomFree("random free", numOps, 16, 4096, 16384, seed + 3));
+
+        // Each thread replays its own mixed size trace, split from the same total number of operations.
+        ae_bench::AeBenchmarkCase multiThreadedCase{"multi-threaded", {}};
+        for (std::size_t i = 0; i < t_options.m_numThreads; i++) {
+            multiThreadedCase.m_traces.push_back(AeAllocationTrace::createMixedSize(
+                    "multi-threaded " + std::to_string(i),
+                    numOps / t_options.m_numThreads,
+                    16,
+                    4096,
+                    1024,
+                    seed + 4 + i));
+        };
+        cases.push_back(std::move(multiThreadedCase));
+
+        for (const auto& filepath: t_options.m_traceFilepaths) {
+            AeAllocationTrace trace = AeAllocationTrace::load(filepath);
+            std::string name = "recorded " + trace.getName();
+            std::vector<AeAllocationTrace> traces;
+            traces.push_back(std::move(trace));
+            cases.push_back({std::move(name), std::move(traces)});
+        };
+
+        return cases;
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+        std::vector<ae_bench::AeBenchmarkCase> cases = createCases(options);
+
+        if (!options.m_traceDirectory.empty()) {
+            for (const auto& benchmarkCase: cases) {
+                for (const auto& trace: benchmarkCase.m_traces) {
+                    std::string filename = trace.getName();
+                    std::replace(filename.begin(), filename.end(), ' ', '_');
+                    trace.save(options.m_traceDirectory + "/" + filename + ".trace");
+                };
+            };
+        };
+
+        ae_bench::AeAllocationBenchmark benchmark{options.m_numRepetitions};
+        for (auto& benchmarkCase: cases) {
+            if (benchmarkCase.m_name.find(options.m_caseFilter) != std::string::npos) {
+                benchmark.addCase(std::move(benchmarkCase));
+            };
+        };
+        for (auto& subject: ae_bench::createBenchmarkSubjects(options.m_memorySizeMiB << 20)) {
+            bool isChosen = options.m_subjectFilter.empty() ?
+                            subject->isIncludedByDefault() :
+                            subject->getName().find(options.m_subjectFilter) != std::string::npos;
+            if (isChosen) {
+                benchmark.addSubject(std::move(subject));
+            };
+        };
+
+        benchmark.run(std::cerr);
+        benchmark.printResults(std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            benchmark.writeJson(options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
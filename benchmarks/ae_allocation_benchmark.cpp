@@ -0,0 +1,523 @@
+/// \file ae_allocation_benchmark.cpp
+/// The AeAllocationBenchmark class is implemented.
+#include "ae_allocation_benchmark.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace ae_bench {
+
+    namespace {
+
+        /// The clock every operation is timed with.
+        using BenchmarkClock = std::chrono::steady_clock;
+
+        /// The phases each thread replays its trace in.
+        enum ReplayPhase {
+            replayPhase_warmUp,
+            replayPhase_throughput,
+            replayPhase_latency
+        };
+
+        /// The state of a thread replaying its trace.
+        struct ThreadReplay {
+            /// The trace the thread replays.
+            const AeAllocationTrace* m_trace = nullptr;
+
+            /// The allocation in each slot of the trace.
+            std::vector<void*> m_slots;
+
+            /// The time each operation took during the latency phase, in nanoseconds.
+            std::vector<std::uint32_t> m_latencies;
+
+            /// The reason the replay failed, empty if it has not.
+            std::string m_failure;
+
+            /// If the memory in use and fragmentation are measured when the trace has the most bytes allocated.
+            bool m_isSampled = false;
+
+            /// The bytes the subject had in use when the trace had the most bytes allocated.
+            std::size_t m_memoryInUseAtPeak = 0;
+
+            /// The fragmentation of the subject when the trace had the most bytes allocated.
+            double m_fragmentationAtPeak = 0.0;
+        };
+
+        /// A AeBenchmarkBarrier blocks each thread that arrives until a number of threads have arrived, then lets
+        /// them all continue and can be used again.
+        class AeBenchmarkBarrier {
+        public:
+
+            /// Constructor of AeBenchmarkBarrier.
+            /// \param t_numThreads The number of threads that must arrive to release the barrier.
+            explicit AeBenchmarkBarrier(std::size_t const t_numThreads) : m_numThreads{t_numThreads} {};
+
+            /// Waits until every thread has arrived.
+            void arriveAndWait() {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                std::size_t generation = m_generation;
+                if (++m_numArrived == m_numThreads) {
+                    m_numArrived = 0;
+                    m_generation++;
+                    m_released.notify_all();
+                    return;
+                };
+                m_released.wait(lock, [&]() { return generation != m_generation; });
+            };
+
+        private:
+
+            /// The number of threads that must arrive to release the barrier.
+            std::size_t m_numThreads;
+
+            /// The number of threads that have arrived since the barrier was last released.
+            std::size_t m_numArrived = 0;
+
+            /// The number of times the barrier has been released.
+            std::size_t m_generation = 0;
+
+            /// Guards the counts of the barrier.
+            std::mutex m_mutex;
+
+            /// Notified when the barrier is released.
+            std::condition_variable m_released;
+        };
+
+
+
+        /// Replays an operation of a trace.
+        inline void replayOp(AeBenchmarkSubject& t_subject,
+                             const AeAllocationTraceOp& t_op,
+                             std::vector<void*>& t_slots) {
+            if (t_op.m_type == allocationTraceOp_allocate) {
+                t_slots[t_op.m_slot] = t_subject.allocate(t_op.m_size, t_op.m_alignment);
+            } else {
+                t_subject.deallocate(t_slots[t_op.m_slot]);
+                t_slots[t_op.m_slot] = nullptr;
+            };
+        };
+
+
+
+        /// Replays a trace for a phase. If an allocation fails the live allocations are freed and the failure recorded,
+        /// a thread that has failed does not replay any further phases.
+        void replayPhase(AeBenchmarkSubject& t_subject,
+                         ThreadReplay& t_replay,
+                         ReplayPhase const t_phase,
+                         std::size_t const t_numRepetitions) {
+            if (!t_replay.m_failure.empty()) {
+                return;
+            };
+
+            const std::vector<AeAllocationTraceOp>& ops = t_replay.m_trace->getOps();
+            try {
+                if (t_phase == replayPhase_latency) {
+                    t_replay.m_latencies.resize(ops.size());
+                    std::size_t peakOpIndex = t_replay.m_trace->getPeakOpIndex();
+
+                    for (std::size_t i = 0; i < ops.size(); i++) {
+                        auto start = BenchmarkClock::now();
+                        replayOp(t_subject, ops[i], t_replay.m_slots);
+                        auto end = BenchmarkClock::now();
+                        t_replay.m_latencies[i] = static_cast<std::uint32_t>(std::min<std::int64_t>(
+                                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                                UINT32_MAX));
+
+                        if (i == peakOpIndex && t_replay.m_isSampled) {
+                            t_replay.m_memoryInUseAtPeak = t_subject.getMemoryInUse();
+                            t_replay.m_fragmentationAtPeak = t_subject.getFragmentation();
+                        };
+                    };
+                    return;
+                };
+
+                std::size_t numRepetitions = t_phase == replayPhase_warmUp ? 1 : t_numRepetitions;
+                for (std::size_t repetition = 0; repetition < numRepetitions; repetition++) {
+                    for (const auto& op: ops) {
+                        replayOp(t_subject, op, t_replay.m_slots);
+                    };
+                };
+            } catch (const std::exception& e) {
+                t_replay.m_failure = e.what();
+
+                std::vector<void*> liveAllocations;
+                for (void*& allocation: t_replay.m_slots) {
+                    if (allocation != nullptr) {
+                        liveAllocations.push_back(allocation);
+                        allocation = nullptr;
+                    };
+                };
+                t_subject.deallocateAll(liveAllocations);
+            };
+        };
+
+
+
+        /// Gets the time it takes to read the clock, the median of many back to back reads.
+        double measureTimerOverhead() {
+            constexpr std::size_t numSamples = 10001;
+            std::vector<std::int64_t> samples(numSamples);
+            for (auto& sample: samples) {
+                auto start = BenchmarkClock::now();
+                auto end = BenchmarkClock::now();
+                sample = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            };
+
+            std::nth_element(samples.begin(), samples.begin() + numSamples / 2, samples.end());
+            return static_cast<double>(samples[numSamples / 2]);
+        };
+
+
+
+        /// Resets the peak resident set size of the process, only Linux allows it.
+        /// \return True if the peak was reset.
+        bool resetPeakResidentSetSize() {
+#if defined(__linux__)
+            std::ofstream clearRefs{"/proc/self/clear_refs"};
+            clearRefs << "5";
+            clearRefs.flush();
+            return static_cast<bool>(clearRefs);
+#else
+            return false;
+#endif
+        };
+
+
+
+#if defined(__linux__)
+        /// Reads a size the kernel reports in the status of the process.
+        /// \param t_field The name of the size, such as VmRSS.
+        /// \return The size in bytes, 0 if it is not reported.
+        std::size_t readProcessStatusSize(const std::string& t_field) {
+            std::ifstream status{"/proc/self/status"};
+            std::string line;
+            while (std::getline(status, line)) {
+                if (line.rfind(t_field + ":", 0) == 0) {
+                    return std::stoull(line.substr(t_field.size() + 1)) * 1024;
+                };
+            };
+            return 0;
+        };
+#endif
+
+
+
+        /// Gets the peak resident set size of the process since it started, or since it was last reset.
+        /// \return The peak resident set size in bytes.
+        std::size_t getPeakResidentSetSize() {
+#if defined(_WIN32)
+            PROCESS_MEMORY_COUNTERS memoryCounters{};
+            GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters));
+            return memoryCounters.PeakWorkingSetSize;
+#elif defined(__linux__)
+            // The high water mark is the peak clear_refs resets, the peak of the resource usage is never reset.
+            return readProcessStatusSize("VmHWM");
+#else
+            rusage usage{};
+            getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+            return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+            return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+        };
+
+
+
+        /// Gets the resident set size of the process, where the platform does not report it the peak is used instead.
+        /// \return The resident set size in bytes.
+        std::size_t getResidentSetSize() {
+#if defined(_WIN32)
+            PROCESS_MEMORY_COUNTERS memoryCounters{};
+            GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters));
+            return memoryCounters.WorkingSetSize;
+#elif defined(__linux__)
+            return readProcessStatusSize("VmRSS");
+#else
+            return getPeakResidentSetSize();
+#endif
+        };
+
+
+
+        /// Escapes the characters of a string that are not allowed within a JSON string.
+        std::string escapeJsonString(const std::string& t_string) {
+            std::string escapedString;
+            escapedString.reserve(t_string.size());
+            for (char character: t_string) {
+                switch (character) {
+                    case '"': escapedString += "\\\""; break;
+                    case '\\': escapedString += "\\\\"; break;
+                    case '\n': escapedString += "\\n"; break;
+                    case '\t': escapedString += "\\t"; break;
+                    default: escapedString += character; break;
+                };
+            };
+            return escapedString;
+        };
+    }
+
+
+
+    AeAllocationBenchmark::AeAllocationBenchmark(std::size_t const t_numRepetitions) :
+            m_numRepetitions{std::max<std::size_t>(t_numRepetitions, 1)},
+            m_timerOverheadNs{measureTimerOverhead()},
+            m_isPeakRssPerCase{resetPeakResidentSetSize()} {
+    };
+
+
+
+    AeAllocationBenchmark::~AeAllocationBenchmark() = default;
+
+
+
+    void AeAllocationBenchmark::addCase(AeBenchmarkCase t_case) {
+        if (t_case.m_traces.empty()) {
+            throw std::runtime_error("The benchmark case " + t_case.m_name + " has no traces!");
+        };
+        m_cases.push_back(std::move(t_case));
+    };
+
+
+
+    void AeAllocationBenchmark::addSubject(std::unique_ptr<AeBenchmarkSubject> t_subject) {
+        m_subjects.push_back(std::move(t_subject));
+    };
+
+
+
+    void AeAllocationBenchmark::run(std::ostream& t_log) {
+        for (const auto& benchmarkCase: m_cases) {
+            for (const auto& subject: m_subjects) {
+                bool canReplay = std::all_of(benchmarkCase.m_traces.begin(),
+                                             benchmarkCase.m_traces.end(),
+                                             [&](const AeAllocationTrace& t_trace) {
+                                                 return subject->canReplay(t_trace, benchmarkCase.m_traces.size());
+                                             });
+                if (!canReplay) {
+                    continue;
+                };
+
+                t_log << "Replaying " << benchmarkCase.m_name << " against " << subject->getName() << "..."
+                      << std::endl;
+                m_results.push_back(runCase(*subject, benchmarkCase));
+            };
+        };
+    };
+
+
+
+    // A single trace is replayed on the calling thread so allocators that keep state for each thread only ever see
+    // the one thread, several traces are replayed on their own threads that start each phase together.
+    AeBenchmarkResult AeAllocationBenchmark::runCase(AeBenchmarkSubject& t_subject, const AeBenchmarkCase& t_case) {
+        std::size_t numThreads = t_case.m_traces.size();
+
+        AeBenchmarkResult result{};
+        result.m_caseName = t_case.m_name;
+        result.m_subjectName = t_subject.getName();
+        result.m_numThreads = numThreads;
+        result.m_hasMemoryStatistics = numThreads == 1 && t_subject.hasMemoryStatistics();
+
+        std::vector<ThreadReplay> replays(numThreads);
+        for (std::size_t i = 0; i < numThreads; i++) {
+            const AeAllocationTrace& trace = t_case.m_traces[i];
+            replays[i].m_trace = &trace;
+            replays[i].m_slots.assign(trace.getNumSlots(), nullptr);
+            replays[i].m_isSampled = result.m_hasMemoryStatistics;
+            result.m_numOps += trace.getOps().size();
+            result.m_peakLiveBytes += trace.getPeakLiveBytes();
+        };
+
+        t_subject.prepare(t_case.m_traces.front());
+        resetPeakResidentSetSize();
+        std::size_t startRss = getResidentSetSize();
+
+        BenchmarkClock::time_point start;
+        BenchmarkClock::time_point end;
+        if (numThreads == 1) {
+            replayPhase(t_subject, replays[0], replayPhase_warmUp, m_numRepetitions);
+            start = BenchmarkClock::now();
+            replayPhase(t_subject, replays[0], replayPhase_throughput, m_numRepetitions);
+            end = BenchmarkClock::now();
+            replayPhase(t_subject, replays[0], replayPhase_latency, m_numRepetitions);
+        } else {
+            AeBenchmarkBarrier barrier{numThreads + 1};
+            std::vector<std::thread> threads;
+            for (auto& replay: replays) {
+                threads.emplace_back([&]() {
+                    for (ReplayPhase phase: {replayPhase_warmUp, replayPhase_throughput, replayPhase_latency}) {
+                        barrier.arriveAndWait();
+                        replayPhase(t_subject, replay, phase, m_numRepetitions);
+                    };
+                    barrier.arriveAndWait();
+                });
+            };
+
+            // The calling thread only releases the threads into each phase and times the throughput phase.
+            barrier.arriveAndWait();
+            barrier.arriveAndWait();
+            start = BenchmarkClock::now();
+            barrier.arriveAndWait();
+            end = BenchmarkClock::now();
+            barrier.arriveAndWait();
+            for (auto& thread: threads) {
+                thread.join();
+            };
+        };
+
+        result.m_peakRssBytes = getPeakResidentSetSize();
+        result.m_rssGrowthBytes = result.m_peakRssBytes > startRss ? result.m_peakRssBytes - startRss : 0;
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if (seconds > 0.0) {
+            result.m_opsPerSecond = static_cast<double>(result.m_numOps * m_numRepetitions) / seconds;
+        };
+
+        std::vector<std::uint32_t> latencies;
+        for (const auto& replay: replays) {
+            latencies.insert(latencies.end(), replay.m_latencies.begin(), replay.m_latencies.end());
+            if (!replay.m_failure.empty() && !result.m_hasFailed) {
+                result.m_hasFailed = true;
+                result.m_failure = replay.m_failure;
+            };
+        };
+        if (!latencies.empty()) {
+            auto getPercentile = [&](double t_percentile) {
+                auto index = static_cast<std::size_t>(t_percentile * static_cast<double>(latencies.size() - 1));
+                std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+                return static_cast<double>(latencies[index]);
+            };
+            result.m_p50LatencyNs = getPercentile(0.50);
+            result.m_p99LatencyNs = getPercentile(0.99);
+            result.m_maxLatencyNs = static_cast<double>(*std::max_element(latencies.begin(), latencies.end()));
+        };
+
+        if (result.m_hasMemoryStatistics) {
+            result.m_memoryInUseAtPeak = replays[0].m_memoryInUseAtPeak;
+            result.m_fragmentationAtPeak = replays[0].m_fragmentationAtPeak;
+        };
+
+        return result;
+    };
+
+
+
+    void AeAllocationBenchmark::printResults(std::ostream& t_stream) const {
+        std::ios_base::fmtflags flags = t_stream.flags();
+
+        t_stream << std::left << std::setw(28) << "case" << std::setw(16) << "subject" << std::right
+                 << std::setw(8) << "threads" << std::setw(12) << "Mops/s" << std::setw(10) << "p50 ns"
+                 << std::setw(10) << "p99 ns" << std::setw(14) << "peak RSS MiB" << std::setw(12) << "growth MiB"
+                 << std::setw(12) << "overhead" << std::setw(10) << "frag" << "\n";
+
+        t_stream << std::fixed;
+        for (const auto& result: m_results) {
+            t_stream << std::left << std::setw(28) << result.m_caseName << std::setw(16) << result.m_subjectName
+                     << std::right << std::setw(8) << result.m_numThreads;
+            if (result.m_hasFailed) {
+                t_stream << "  failed: " << result.m_failure << "\n";
+                continue;
+            };
+
+            t_stream << std::setprecision(2) << std::setw(12) << result.m_opsPerSecond / 1.0e6
+                     << std::setprecision(0) << std::setw(10) << result.m_p50LatencyNs << std::setw(10)
+                     << result.m_p99LatencyNs << std::setprecision(1) << std::setw(14)
+                     << static_cast<double>(result.m_peakRssBytes) / static_cast<double>(1 << 20) << std::setw(12)
+                     << static_cast<double>(result.m_rssGrowthBytes) / static_cast<double>(1 << 20);
+            if (result.m_hasMemoryStatistics && result.m_peakLiveBytes > 0) {
+                // The overhead is the memory in use for each byte the trace asked for.
+                t_stream << std::setprecision(2) << std::setw(12)
+                         << static_cast<double>(result.m_memoryInUseAtPeak) /
+                            static_cast<double>(result.m_peakLiveBytes)
+                         << std::setw(10) << result.m_fragmentationAtPeak;
+            } else {
+                t_stream << std::setw(12) << "-" << std::setw(10) << "-";
+            };
+            t_stream << "\n";
+        };
+
+        t_stream << "Latencies include " << std::setprecision(0) << m_timerOverheadNs << " ns of timer overhead.";
+        if (!m_isPeakRssPerCase) {
+            t_stream << " Peak RSS is the peak of the process so far, run a single case to measure it alone.";
+        };
+        t_stream << "\n";
+
+        t_stream.flags(flags);
+    };
+
+
+
+    std::string AeAllocationBenchmark::toJson() const {
+        std::ostringstream json;
+        json << std::setprecision(10);
+
+        json << "{\n";
+        json << "  \"benchmark\": \"ae_alloc_bench\",\n";
+        json << "  \"repetitions\": " << m_numRepetitions << ",\n";
+        json << "  \"timerOverheadNs\": " << m_timerOverheadNs << ",\n";
+        json << "  \"peakRssIsPerCase\": " << (m_isPeakRssPerCase ? "true" : "false") << ",\n";
+        json << "  \"results\": [";
+
+        for (std::size_t i = 0; i < m_results.size(); i++) {
+            const AeBenchmarkResult& result = m_results[i];
+            json << (i == 0 ? "\n" : ",\n") << "    {";
+            json << "\"case\": \"" << escapeJsonString(result.m_caseName) << "\", ";
+            json << "\"subject\": \"" << escapeJsonString(result.m_subjectName) << "\", ";
+            json << "\"threads\": " << result.m_numThreads << ", ";
+            json << "\"ops\": " << result.m_numOps << ", ";
+            json << "\"failed\": " << (result.m_hasFailed ? "true" : "false") << ", ";
+            if (result.m_hasFailed) {
+                json << "\"failure\": \"" << escapeJsonString(result.m_failure) << "\", ";
+            };
+            json << "\"opsPerSecond\": " << result.m_opsPerSecond << ", ";
+            json << "\"p50LatencyNs\": " << result.m_p50LatencyNs << ", ";
+            json << "\"p99LatencyNs\": " << result.m_p99LatencyNs << ", ";
+            json << "\"maxLatencyNs\": " << result.m_maxLatencyNs << ", ";
+            json << "\"peakRssBytes\": " << result.m_peakRssBytes << ", ";
+            json << "\"rssGrowthBytes\": " << result.m_rssGrowthBytes << ", ";
+            json << "\"peakLiveBytes\": " << result.m_peakLiveBytes << ", ";
+            if (result.m_hasMemoryStatistics) {
+                json << "\"memoryInUseAtPeak\": " << result.m_memoryInUseAtPeak << ", ";
+                json << "\"fragmentationAtPeak\": " << result.m_fragmentationAtPeak;
+            } else {
+                json << "\"memoryInUseAtPeak\": null, \"fragmentationAtPeak\": null";
+            };
+            json << "}";
+        };
+
+        json << "\n  ]\n}\n";
+        return json.str();
+    };
+
+
+
+    void AeAllocationBenchmark::writeJson(const std::string& t_filepath) const {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Could not open " + t_filepath + " to write the benchmark results!");
+        };
+        file << toJson();
+    };
+
+} // namespace ae_bench
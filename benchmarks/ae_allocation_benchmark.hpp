@@ -0,0 +1,164 @@
+/// \file ae_allocation_benchmark.hpp
+/// The AeAllocationBenchmark class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocation_trace.hpp"
+#include "ae_benchmark_subjects.hpp"
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ae_bench {
+
+    /// A case of the benchmark, a trace to replay on each thread that replays at once.
+    struct AeBenchmarkCase {
+        /// The name the results of the case are reported under.
+        std::string m_name;
+
+        /// The trace each thread replays, a single trace is replayed on the calling thread.
+        std::vector<AeAllocationTrace> m_traces;
+    };
+
+    /// The result of replaying a case against a subject.
+    struct AeBenchmarkResult {
+        /// The name of the case.
+        std::string m_caseName;
+
+        /// The name of the subject.
+        std::string m_subjectName;
+
+        /// The number of threads that replayed the case at once.
+        std::size_t m_numThreads = 0;
+
+        /// The number of operations of one replay of the case, across every thread.
+        std::size_t m_numOps = 0;
+
+        /// If an allocation failed, the rest of the results then only cover the replays up to the failure.
+        bool m_hasFailed = false;
+
+        /// The reason the replay failed.
+        std::string m_failure;
+
+        /// The operations done each second across every thread.
+        double m_opsPerSecond = 0.0;
+
+        /// The median time an operation took, in nanoseconds.
+        double m_p50LatencyNs = 0.0;
+
+        /// The time 99% of the operations took at most, in nanoseconds.
+        double m_p99LatencyNs = 0.0;
+
+        /// The longest time an operation took, in nanoseconds.
+        double m_maxLatencyNs = 0.0;
+
+        /// The peak resident set size of the process while the case was replayed, in bytes. It includes the memory
+        /// of the other subjects that earlier cases have touched.
+        std::size_t m_peakRssBytes = 0;
+
+        /// How far the peak resident set size rose above the resident set size before the case, in bytes.
+        std::size_t m_rssGrowthBytes = 0;
+
+        /// The most bytes the case has allocated at once, summed across the threads.
+        std::size_t m_peakLiveBytes = 0;
+
+        /// If the memory in use and fragmentation were measured, they are not for the system allocator or when
+        /// replaying on several threads.
+        bool m_hasMemoryStatistics = false;
+
+        /// The bytes the subject had in use when the case had the most bytes allocated, including its overhead.
+        std::size_t m_memoryInUseAtPeak = 0;
+
+        /// The fragmentation of the subject when the case had the most bytes allocated.
+        double m_fragmentationAtPeak = 0.0;
+    };
+
+    /// A AeAllocationBenchmark replays cases of allocation traces against subjects and records, for each pair, the
+    /// throughput, the latency of the operations, the peak resident set size, and the memory overhead and
+    /// fragmentation at the point the case has the most memory allocated. Every case is replayed once to warm the
+    /// subject, then a number of times to measure the throughput, then once more timing each operation, since timing
+    /// each operation slows the replay down.
+    class AeAllocationBenchmark {
+    public:
+
+        /// Constructor of AeAllocationBenchmark.
+        /// \param t_numRepetitions The number of times each case is replayed to measure the throughput.
+        explicit AeAllocationBenchmark(std::size_t t_numRepetitions);
+
+        /// Destructor of AeAllocationBenchmark.
+        ~AeAllocationBenchmark();
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeAllocationBenchmark(const AeAllocationBenchmark&) = delete;
+        AeAllocationBenchmark& operator=(const AeAllocationBenchmark&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeAllocationBenchmark(AeAllocationBenchmark&&) = delete;
+        AeAllocationBenchmark& operator=(AeAllocationBenchmark&&) = delete;
+
+        /// Adds a case to be replayed.
+        /// \param t_case The case.
+        void addCase(AeBenchmarkCase t_case);
+
+        /// Adds a subject the cases are replayed against. A subject is kept for every case it replays so an allocator
+        /// keeping state for each thread, such as the thread caching allocator, is set up only once.
+        /// \param t_subject The subject.
+        void addSubject(std::unique_ptr<AeBenchmarkSubject> t_subject);
+
+        /// Replays every case against every subject that can replay it.
+        /// \param t_log The stream the progress is written to.
+        void run(std::ostream& t_log);
+
+        /// Gets the results of the cases that have been replayed.
+        /// \return The results.
+        [[nodiscard]] const std::vector<AeBenchmarkResult>& getResults() const { return m_results; };
+
+        /// Writes the results as a table.
+        /// \param t_stream The stream to write the table to.
+        void printResults(std::ostream& t_stream) const;
+
+        /// Converts the results to a JSON document.
+        /// \return The JSON document.
+        [[nodiscard]] std::string toJson() const;
+
+        /// Writes the results to a file as JSON.
+        /// \param t_filepath The path of the file to write.
+        void writeJson(const std::string& t_filepath) const;
+
+    private:
+
+        /// Replays a case against a subject.
+        /// \param t_subject The subject.
+        /// \param t_case The case.
+        /// \return The result.
+        AeBenchmarkResult runCase(AeBenchmarkSubject& t_subject, const AeBenchmarkCase& t_case);
+
+        /// The number of times each case is replayed to measure the throughput.
+        std::size_t m_numRepetitions;
+
+        /// The time it takes to read the clock, which is included in the latency of every operation.
+        double m_timerOverheadNs;
+
+        /// If the peak resident set size can be reset before each case, otherwise it is the peak of the process so far.
+        bool m_isPeakRssPerCase;
+
+        /// The cases to replay.
+        std::vector<AeBenchmarkCase> m_cases;
+
+        /// The subjects the cases are replayed against.
+        std::vector<std::unique_ptr<AeBenchmarkSubject>> m_subjects;
+
+        /// The results of the cases that have been replayed.
+        std::vector<AeBenchmarkResult> m_results;
+
+    protected:
+
+    };
+
+} // namespace ae_bench
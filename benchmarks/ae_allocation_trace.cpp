@@ -0,0 +1,335 @@
+/// \file ae_allocation_trace.cpp
+/// The AeAllocationTrace class is implemented.
+#include "ae_allocation_trace.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace ae_bench {
+
+    namespace {
+
+        /// The most slots a loaded trace may use, so a corrupt file cannot make the replay allocate too many slots.
+        constexpr std::uint32_t MAX_LOADED_SLOTS = std::uint32_t{1} << 26;
+
+        /// Gets a random size whose base two logarithm is spread evenly between that of the minimum and maximum, so
+        /// small allocations are far more common than large ones as they are in a game.
+        std::size_t getRandomSize(std::size_t const t_minSize, std::size_t const t_maxSize, std::mt19937_64& t_random) {
+            std::uniform_real_distribution<double> exponent{std::log2(static_cast<double>(t_minSize)),
+                                                            std::log2(static_cast<double>(t_maxSize))};
+            auto size = static_cast<std::size_t>(std::exp2(exponent(t_random)));
+            return std::clamp(size, t_minSize, t_maxSize);
+        };
+
+        /// Gets a random alignment, one in sixteen allocations asks for a cache line and the rest for the default.
+        std::size_t getRandomAlignment(std::mt19937_64& t_random) {
+            return (t_random() & 15) == 0 ? 64 : 8;
+        };
+    }
+
+
+
+    AeAllocationTrace::AeAllocationTrace(std::string t_name) : m_name{std::move(t_name)} {
+    };
+
+
+
+    AeAllocationTrace AeAllocationTrace::createFixedSize(std::string t_name,
+                                                         std::size_t const t_numOps,
+                                                         std::size_t const t_size,
+                                                         std::size_t const t_maxLiveAllocations,
+                                                         std::uint64_t const t_seed) {
+        AeAllocationTrace trace{std::move(t_name)};
+        std::mt19937_64 random{t_seed};
+
+        trace.addChurn(t_numOps, t_maxLiveAllocations, false, [t_size]() {
+            return std::make_pair(t_size, std::size_t{8});
+        }, random);
+        trace.freeLiveAllocations();
+        return trace;
+    };
+
+
+
+    AeAllocationTrace AeAllocationTrace::createMixedSize(std::string t_name,
+                                                         std::size_t const t_numOps,
+                                                         std::size_t const t_minSize,
+                                                         std::size_t const t_maxSize,
+                                                         std::size_t const t_maxLiveAllocations,
+                                                         std::uint64_t const t_seed) {
+        AeAllocationTrace trace{std::move(t_name)};
+        std::mt19937_64 random{t_seed};
+
+        trace.addChurn(t_numOps, t_maxLiveAllocations, false, [&]() {
+            return std::make_pair(getRandomSize(t_minSize, t_maxSize, random), getRandomAlignment(random));
+        }, random);
+        trace.freeLiveAllocations();
+        return trace;
+    };
+
+
+
+    AeAllocationTrace AeAllocationTrace::createLifo(std::string t_name,
+                                                    std::size_t const t_numOps,
+                                                    std::size_t const t_minSize,
+                                                    std::size_t const t_maxSize,
+                                                    std::size_t const t_maxLiveAllocations,
+                                                    std::uint64_t const t_seed) {
+        AeAllocationTrace trace{std::move(t_name)};
+        std::mt19937_64 random{t_seed};
+
+        trace.addChurn(t_numOps, t_maxLiveAllocations, true, [&]() {
+            return std::make_pair(getRandomSize(t_minSize, t_maxSize, random), getRandomAlignment(random));
+        }, random);
+        trace.freeLiveAllocations();
+        return trace;
+    };
+
+
+
+    AeAllocationTrace AeAllocationTrace::createRandomFree(std::string t_name,
+                                                          std::size_t const t_numOps,
+                                                          std::size_t const t_minSize,
+                                                          std::size_t const t_maxSize,
+                                                          std::size_t const t_batchSize,
+                                                          std::uint64_t const t_seed) {
+        AeAllocationTrace trace{std::move(t_name)};
+        std::mt19937_64 random{t_seed};
+
+        std::vector<std::uint32_t> batchSlots;
+        while (trace.m_ops.size() + 1 < t_numOps) {
+            // Each allocation of the batch needs room for its deallocation within the number of operations.
+            std::size_t batchSize = std::min(t_batchSize, (t_numOps - trace.m_ops.size()) / 2);
+            batchSlots.clear();
+            for (std::size_t i = 0; i < batchSize; i++) {
+                batchSlots.push_back(trace.getFreeSlot());
+                trace.addAllocation(batchSlots.back(),
+                                    getRandomSize(t_minSize, t_maxSize, random),
+                                    getRandomAlignment(random));
+            };
+
+            std::shuffle(batchSlots.begin(), batchSlots.end(), random);
+            for (std::uint32_t slot: batchSlots) {
+                trace.addDeallocation(slot);
+            };
+        };
+
+        return trace;
+    };
+
+
+
+    // Slots are numbered by the file, so they are allocated on demand rather than handed out by getFreeSlot.
+    AeAllocationTrace AeAllocationTrace::load(const std::string& t_filepath) {
+        std::ifstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Could not open the allocation trace " + t_filepath + "!");
+        };
+
+        std::string name = t_filepath.substr(t_filepath.find_last_of("/\\") + 1);
+        AeAllocationTrace trace{name.substr(0, name.find_last_of('.'))};
+
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(file, line)) {
+            lineNumber++;
+            if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            };
+
+            std::istringstream lineStream{line};
+            char type = 0;
+            std::uint64_t slot = 0;
+            std::uint64_t size = 0;
+            std::uint64_t alignment = 0;
+            lineStream >> type >> slot;
+            if (type == 'a') {
+                lineStream >> size >> alignment;
+            };
+
+            auto error = [&](const std::string& t_reason) {
+                return std::runtime_error("Line " + std::to_string(lineNumber) + " of the allocation trace " +
+                                          t_filepath + " " + t_reason + "!");
+            };
+
+            if (!lineStream || (type != 'a' && type != 'f')) {
+                throw error("is not an operation");
+            };
+            if (slot >= MAX_LOADED_SLOTS) {
+                throw error("uses a slot beyond " + std::to_string(MAX_LOADED_SLOTS));
+            };
+            if (slot >= trace.m_numSlots) {
+                trace.m_numSlots = slot + 1;
+                trace.m_slotSequenceNumbers.resize(trace.m_numSlots, 0);
+                trace.m_slotSizes.resize(trace.m_numSlots, 0);
+            };
+
+            if (type == 'a') {
+                if (trace.m_slotSequenceNumbers[slot] != 0) {
+                    throw error("allocates into a slot that is in use");
+                };
+                if (size == 0 || size > std::numeric_limits<std::uint32_t>::max()) {
+                    throw error("allocates an unsupported size");
+                };
+                if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > 256) {
+                    throw error("allocates with an alignment that is not a power of 2 up to 256");
+                };
+                trace.addAllocation(static_cast<std::uint32_t>(slot), size, alignment);
+            } else {
+                if (trace.m_slotSequenceNumbers[slot] == 0) {
+                    throw error("frees a slot that is not in use");
+                };
+                trace.addDeallocation(static_cast<std::uint32_t>(slot));
+            };
+        };
+
+        trace.freeLiveAllocations();
+        return trace;
+    };
+
+
+
+    void AeAllocationTrace::save(const std::string& t_filepath) const {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Could not open " + t_filepath + " to write the allocation trace!");
+        };
+
+        file << "# ae allocation trace " << m_name << "\n";
+        for (const auto& op: m_ops) {
+            if (op.m_type == allocationTraceOp_allocate) {
+                file << "a " << op.m_slot << " " << op.m_size << " " << op.m_alignment << "\n";
+            } else {
+                file << "f " << op.m_slot << "\n";
+            };
+        };
+    };
+
+
+
+    void AeAllocationTrace::addAllocation(std::uint32_t const t_slot,
+                                          std::size_t const t_size,
+                                          std::size_t const t_alignment) {
+        m_ops.push_back({allocationTraceOp_allocate,
+                         t_slot,
+                         static_cast<std::uint32_t>(t_size),
+                         static_cast<std::uint32_t>(t_alignment)});
+
+        m_slotSequenceNumbers[t_slot] = m_nextSequenceNumber;
+        m_slotSizes[t_slot] = t_size;
+        m_liveStack.emplace_back(t_slot, m_nextSequenceNumber);
+        m_numLiveAllocations++;
+
+        // The first allocation decides the size the rest must have for the trace to be fixed size.
+        if (m_nextSequenceNumber == 1) {
+            m_fixedSize = t_size;
+        } else if (t_size != m_fixedSize) {
+            m_fixedSize = 0;
+        };
+        m_nextSequenceNumber++;
+        m_maxAlignment = std::max(m_maxAlignment, t_alignment);
+
+        m_liveBytes += t_size;
+        if (m_liveBytes > m_peakLiveBytes) {
+            m_peakLiveBytes = m_liveBytes;
+            m_peakOpIndex = m_ops.size() - 1;
+        };
+    };
+
+
+
+    // The stack of live allocations drops freed entries as they reach its end, so freeing the last live entry on the
+    // stack is freeing the newest live allocation.
+    void AeAllocationTrace::addDeallocation(std::uint32_t const t_slot) {
+        m_ops.push_back({allocationTraceOp_deallocate, t_slot, 0, 0});
+
+        auto isFreed = [this](const std::pair<std::uint32_t, std::uint64_t>& t_entry) {
+            return m_slotSequenceNumbers[t_entry.first] != t_entry.second;
+        };
+        while (!m_liveStack.empty() && isFreed(m_liveStack.back())) {
+            m_liveStack.pop_back();
+        };
+        if (m_liveStack.back().first == t_slot) {
+            m_liveStack.pop_back();
+        } else {
+            m_isLifo = false;
+        };
+
+        m_liveBytes -= m_slotSizes[t_slot];
+        m_slotSequenceNumbers[t_slot] = 0;
+        m_freeSlots.push_back(t_slot);
+        m_numLiveAllocations--;
+
+        // Keep the freed entries from outgrowing the live ones when allocations are not freed in order.
+        if (m_liveStack.size() > 2 * m_numLiveAllocations + 64) {
+            m_liveStack.erase(std::remove_if(m_liveStack.begin(), m_liveStack.end(), isFreed), m_liveStack.end());
+        };
+    };
+
+
+
+    void AeAllocationTrace::addChurn(std::size_t const t_numOps,
+                                     std::size_t const t_maxLiveAllocations,
+                                     bool const t_isLifo,
+                                     const std::function<std::pair<std::size_t, std::size_t>()>& t_getAllocation,
+                                     std::mt19937_64& t_random) {
+        std::vector<std::uint32_t> liveSlots;
+        std::uniform_real_distribution<double> chance{0.0, 1.0};
+
+        // Every live allocation is freed at the end of the trace, which takes one operation each.
+        while (m_ops.size() + liveSlots.size() < t_numOps) {
+            double allocateChance = 1.0 - static_cast<double>(liveSlots.size()) /
+                                          static_cast<double>(t_maxLiveAllocations);
+            if (liveSlots.empty() || chance(t_random) < allocateChance) {
+                auto [size, alignment] = t_getAllocation();
+                liveSlots.push_back(getFreeSlot());
+                addAllocation(liveSlots.back(), size, alignment);
+                continue;
+            };
+
+            // Free the newest allocation or swap a random one to the back to free it.
+            if (!t_isLifo) {
+                std::swap(liveSlots[t_random() % liveSlots.size()], liveSlots.back());
+            };
+            addDeallocation(liveSlots.back());
+            liveSlots.pop_back();
+        };
+    };
+
+
+
+    std::uint32_t AeAllocationTrace::getFreeSlot() {
+        if (!m_freeSlots.empty()) {
+            std::uint32_t slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            return slot;
+        };
+
+        m_slotSequenceNumbers.push_back(0);
+        m_slotSizes.push_back(0);
+        return static_cast<std::uint32_t>(m_numSlots++);
+    };
+
+
+
+    void AeAllocationTrace::freeLiveAllocations() {
+        while (m_numLiveAllocations > 0) {
+            auto [slot, sequenceNumber] = m_liveStack.back();
+            if (m_slotSequenceNumbers[slot] == sequenceNumber) {
+                addDeallocation(slot);
+            } else {
+                m_liveStack.pop_back();
+            };
+        };
+    };
+
+} // namespace ae_bench
@@ -0,0 +1,240 @@
+/// \file ae_allocation_trace.hpp
+/// The AeAllocationTrace class is defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ae_bench {
+
+    /// The kinds of operation in an allocation trace.
+    enum AllocationTraceOpType {
+        allocationTraceOp_allocate,
+        allocationTraceOp_deallocate
+    };
+
+    /// A single operation of an allocation trace. Allocations are stored in numbered slots, so a deallocation names the
+    /// slot of the allocation it frees rather than an address.
+    struct AeAllocationTraceOp {
+        /// If the operation allocates or deallocates.
+        AllocationTraceOpType m_type = allocationTraceOp_allocate;
+
+        /// The slot the allocation is stored in, or freed from.
+        std::uint32_t m_slot = 0;
+
+        /// The size in bytes to allocate, unused by deallocations.
+        std::uint32_t m_size = 0;
+
+        /// The alignment to allocate with, unused by deallocations.
+        std::uint32_t m_alignment = 0;
+    };
+
+    /// A AeAllocationTrace is a sequence of allocations and deallocations that can be replayed against any allocator.
+    /// Traces are either generated to model a pattern of use, or loaded from a file recorded from the engine. Every
+    /// trace frees all of its allocations by its end, so an allocator is empty again once a trace has been replayed.
+    ///
+    /// A trace file has one operation per line, "a <slot> <size> <alignment>" to allocate and "f <slot>" to free, blank
+    /// lines and lines starting with # are ignored.
+    class AeAllocationTrace {
+    public:
+
+        /// Creates a trace of allocations that are all the same size, freed in a random order while at most a number
+        /// of allocations are live.
+        /// \param t_name The name of the trace.
+        /// \param t_numOps The number of operations, including the deallocations at the end of the trace.
+        /// \param t_size The size in bytes of every allocation.
+        /// \param t_maxLiveAllocations The most allocations live at once.
+        /// \param t_seed The seed of the random number generator.
+        /// \return The trace.
+        static AeAllocationTrace createFixedSize(std::string t_name,
+                                                 std::size_t t_numOps,
+                                                 std::size_t t_size,
+                                                 std::size_t t_maxLiveAllocations,
+                                                 std::uint64_t t_seed);
+
+        /// Creates a trace of allocations whose sizes are spread evenly across the powers of two between a minimum and
+        /// maximum, freed in a random order while at most a number of allocations are live.
+        /// \param t_name The name of the trace.
+        /// \param t_numOps The number of operations, including the deallocations at the end of the trace.
+        /// \param t_minSize The smallest size in bytes of an allocation.
+        /// \param t_maxSize The largest size in bytes of an allocation.
+        /// \param t_maxLiveAllocations The most allocations live at once.
+        /// \param t_seed The seed of the random number generator.
+        /// \return The trace.
+        static AeAllocationTrace createMixedSize(std::string t_name,
+                                                 std::size_t t_numOps,
+                                                 std::size_t t_minSize,
+                                                 std::size_t t_maxSize,
+                                                 std::size_t t_maxLiveAllocations,
+                                                 std::uint64_t t_seed);
+
+        /// Creates a trace where every deallocation frees the newest live allocation, as a stack allocator requires.
+        /// \param t_name The name of the trace.
+        /// \param t_numOps The number of operations, including the deallocations at the end of the trace.
+        /// \param t_minSize The smallest size in bytes of an allocation.
+        /// \param t_maxSize The largest size in bytes of an allocation.
+        /// \param t_maxLiveAllocations The most allocations live at once.
+        /// \param t_seed The seed of the random number generator.
+        /// \return The trace.
+        static AeAllocationTrace createLifo(std::string t_name,
+                                            std::size_t t_numOps,
+                                            std::size_t t_minSize,
+                                            std::size_t t_maxSize,
+                                            std::size_t t_maxLiveAllocations,
+                                            std::uint64_t t_seed);
+
+        /// Creates a trace that repeatedly makes a batch of allocations and then frees the whole batch in a random
+        /// order, such as loading and unloading a level.
+        /// \param t_name The name of the trace.
+        /// \param t_numOps The number of operations.
+        /// \param t_minSize The smallest size in bytes of an allocation.
+        /// \param t_maxSize The largest size in bytes of an allocation.
+        /// \param t_batchSize The number of allocations in each batch.
+        /// \param t_seed The seed of the random number generator.
+        /// \return The trace.
+        static AeAllocationTrace createRandomFree(std::string t_name,
+                                                  std::size_t t_numOps,
+                                                  std::size_t t_minSize,
+                                                  std::size_t t_maxSize,
+                                                  std::size_t t_batchSize,
+                                                  std::uint64_t t_seed);
+
+        /// Loads a recorded trace from a file, allocations still live at the end of the file are freed newest first.
+        /// \param t_filepath The path of the trace file.
+        /// \return The trace, named after the file.
+        static AeAllocationTrace load(const std::string& t_filepath);
+
+        /// Writes the trace to a file that can be loaded again.
+        /// \param t_filepath The path of the file to write.
+        void save(const std::string& t_filepath) const;
+
+        /// Gets the name of the trace.
+        /// \return The name.
+        [[nodiscard]] const std::string& getName() const { return m_name; };
+
+        /// Gets the operations of the trace in the order they are replayed.
+        /// \return The operations.
+        [[nodiscard]] const std::vector<AeAllocationTraceOp>& getOps() const { return m_ops; };
+
+        /// Gets the number of slots the allocations of the trace are stored in.
+        /// \return The number of slots.
+        [[nodiscard]] std::size_t getNumSlots() const { return m_numSlots; };
+
+        /// Gets if every deallocation of the trace frees the newest live allocation.
+        /// \return True if the trace can be replayed by a stack allocator.
+        [[nodiscard]] bool isLifo() const { return m_isLifo; };
+
+        /// Gets the size every allocation of the trace has.
+        /// \return The size in bytes, 0 if the allocations are not all the same size.
+        [[nodiscard]] std::size_t getFixedSize() const { return m_fixedSize; };
+
+        /// Gets the largest alignment any allocation of the trace asks for.
+        /// \return The alignment.
+        [[nodiscard]] std::size_t getMaxAlignment() const { return m_maxAlignment; };
+
+        /// Gets the most bytes the trace has allocated at once.
+        /// \return The size in bytes.
+        [[nodiscard]] std::size_t getPeakLiveBytes() const { return m_peakLiveBytes; };
+
+        /// Gets the index of the operation after which the trace has the most bytes allocated.
+        /// \return The index of the operation.
+        [[nodiscard]] std::size_t getPeakOpIndex() const { return m_peakOpIndex; };
+
+    private:
+
+        /// Constructor of AeAllocationTrace, the traces are made by the create functions and load.
+        /// \param t_name The name of the trace.
+        explicit AeAllocationTrace(std::string t_name);
+
+        /// Adds an allocation to the trace.
+        /// \param t_slot The slot the allocation is stored in, it must be empty.
+        /// \param t_size The size in bytes to allocate.
+        /// \param t_alignment The alignment to allocate with, must be a power of 2.
+        void addAllocation(std::uint32_t t_slot, std::size_t t_size, std::size_t t_alignment);
+
+        /// Adds a deallocation to the trace.
+        /// \param t_slot The slot of the allocation to free, it must hold an allocation.
+        void addDeallocation(std::uint32_t t_slot);
+
+        /// Adds allocations and deallocations of random live allocations until the trace has a number of operations.
+        /// Each step allocates with a chance that falls as the number of live allocations nears the maximum, so the
+        /// trace settles at about half the maximum live.
+        /// \param t_numOps The number of operations the trace has once its live allocations have been freed.
+        /// \param t_maxLiveAllocations The most allocations live at once.
+        /// \param t_isLifo If deallocations free the newest live allocation rather than a random one.
+        /// \param t_getAllocation Gets the size and alignment of the next allocation.
+        /// \param t_random The random number generator.
+        void addChurn(std::size_t t_numOps,
+                      std::size_t t_maxLiveAllocations,
+                      bool t_isLifo,
+                      const std::function<std::pair<std::size_t, std::size_t>()>& t_getAllocation,
+                      std::mt19937_64& t_random);
+
+        /// Gets an empty slot, reusing the most recently emptied slot first.
+        /// \return The slot.
+        std::uint32_t getFreeSlot();
+
+        /// Frees the allocations still live newest first so the trace ends with nothing allocated.
+        void freeLiveAllocations();
+
+        /// The name of the trace.
+        std::string m_name;
+
+        /// The operations of the trace.
+        std::vector<AeAllocationTraceOp> m_ops;
+
+        /// The number of slots the allocations are stored in.
+        std::size_t m_numSlots = 0;
+
+        /// The slots allocations were stored in and the sequence number of the allocation, oldest first. Entries of
+        /// allocations that have since been freed are only removed once they reach the end.
+        std::vector<std::pair<std::uint32_t, std::uint64_t>> m_liveStack;
+
+        /// The sequence number of the allocation in each slot, 0 if the slot is empty.
+        std::vector<std::uint64_t> m_slotSequenceNumbers;
+
+        /// The size of the allocation in each slot.
+        std::vector<std::size_t> m_slotSizes;
+
+        /// The slots that have been emptied and not reused yet.
+        std::vector<std::uint32_t> m_freeSlots;
+
+        /// The sequence number to give the next allocation.
+        std::uint64_t m_nextSequenceNumber = 1;
+
+        /// The number of allocations currently live.
+        std::size_t m_numLiveAllocations = 0;
+
+        /// The number of bytes currently allocated by the trace.
+        std::size_t m_liveBytes = 0;
+
+        /// If every deallocation frees the newest live allocation.
+        bool m_isLifo = true;
+
+        /// The size every allocation has, 0 if they are not all the same size.
+        std::size_t m_fixedSize = 0;
+
+        /// The largest alignment any allocation asks for.
+        std::size_t m_maxAlignment = 0;
+
+        /// The most bytes allocated at once.
+        std::size_t m_peakLiveBytes = 0;
+
+        /// The index of the operation after which the most bytes are allocated.
+        std::size_t m_peakOpIndex = 0;
+
+    protected:
+
+    };
+
+} // namespace ae_bench
@@ -0,0 +1,373 @@
+/// \file ae_benchmark_subjects.cpp
+/// The allocators the allocation traces are replayed against are implemented.
+#include "ae_benchmark_subjects.hpp"
+
+// dependencies
+#include "ae_pool_allocator.hpp"
+#include "ae_free_linked_list_allocator.hpp"
+#include "ae_tlsf_allocator.hpp"
+#include "ae_slab_allocator.hpp"
+#include "ae_thread_caching_allocator.hpp"
+
+// libraries
+
+// std
+#include <cstddef>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace ae_bench {
+
+    namespace {
+
+        /// Allocates the memory a subject gives its allocator.
+        void* allocateSubjectMemory(std::size_t const t_memorySize) {
+            void* memoryPtr = malloc(t_memorySize);
+            if (memoryPtr == nullptr) {
+                throw std::bad_alloc();
+            };
+            return memoryPtr;
+        };
+    }
+
+
+
+    AeBenchmarkSubject::AeBenchmarkSubject(std::string t_name) : m_name{std::move(t_name)} {
+    };
+
+
+
+    AeBenchmarkSubject::~AeBenchmarkSubject() = default;
+
+
+
+    void AeBenchmarkSubject::deallocateAll(const std::vector<void*>& t_liveAllocations) {
+        for (void* allocation: t_liveAllocations) {
+            deallocate(allocation);
+        };
+    };
+
+
+
+    AeAllocatorSubject::AeAllocatorSubject(std::string t_name,
+                                           BenchmarkAllocator const t_allocator,
+                                           std::size_t const t_memorySize) :
+            AeBenchmarkSubject(std::move(t_name)),
+            m_allocatorType{t_allocator},
+            m_memoryPtr{allocateSubjectMemory(t_memorySize)},
+            m_memorySize{t_memorySize} {
+
+        switch (m_allocatorType) {
+            case benchmarkAllocator_pool:
+                // The pool is created by prepare once the size of the allocations is known.
+                break;
+            case benchmarkAllocator_freeList:
+                m_allocator = std::make_unique<ae_memory::AeFreeLinkedListAllocator>(m_memorySize, m_memoryPtr);
+                break;
+            case benchmarkAllocator_tlsf:
+                m_allocator = std::make_unique<ae_memory::AeTlsfAllocator>(m_memorySize, m_memoryPtr);
+                break;
+            case benchmarkAllocator_slab:
+                // Half of the memory is given to the allocator the slab falls back to for large allocations.
+                m_fallbackAllocator = std::make_unique<ae_memory::AeTlsfAllocator>(
+                        m_memorySize / 2,
+                        ae_memory::AeAllocatorBase::addToPointer(m_memorySize / 2, m_memoryPtr));
+                m_allocator = std::make_unique<ae_memory::AeSlabAllocator>(m_memorySize / 2,
+                                                                          m_memoryPtr,
+                                                                          m_fallbackAllocator.get());
+                break;
+            case benchmarkAllocator_threadCaching:
+                m_allocator = std::make_unique<ae_memory::AeThreadCachingAllocator>(m_memorySize, m_memoryPtr);
+                break;
+        };
+    };
+
+
+
+    // The slab allocator is destroyed before the allocator it falls back to.
+    AeAllocatorSubject::~AeAllocatorSubject() {
+        m_allocator.reset();
+        m_fallbackAllocator.reset();
+        free(m_memoryPtr);
+    };
+
+
+
+    // Only the thread caching allocator is thread-safe, and the pool can only serve allocations of its chunk size.
+    bool AeAllocatorSubject::canReplay(const AeAllocationTrace& t_trace, std::size_t const t_numThreads) const {
+        if (m_allocatorType == benchmarkAllocator_threadCaching) {
+            return true;
+        };
+        if (t_numThreads > 1) {
+            return false;
+        };
+        if (m_allocatorType == benchmarkAllocator_pool) {
+            return t_trace.getFixedSize() >= sizeof(void*);
+        };
+        return true;
+    };
+
+
+
+    void AeAllocatorSubject::prepare(const AeAllocationTrace& t_trace) {
+        if (m_allocatorType != benchmarkAllocator_pool) {
+            return;
+        };
+
+        m_allocator.reset();
+        m_poolAlignment = t_trace.getMaxAlignment();
+        m_allocator = std::make_unique<ae_memory::AePoolAllocator>(m_memorySize,
+                                                                  m_memoryPtr,
+                                                                  t_trace.getFixedSize(),
+                                                                  m_poolAlignment);
+    };
+
+
+
+    void* AeAllocatorSubject::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+        if (m_allocatorType == benchmarkAllocator_pool) {
+            return m_allocator->allocate(t_allocationSize, m_poolAlignment);
+        };
+        return m_allocator->allocate(t_allocationSize, t_byteAlignment);
+    };
+
+
+
+    void AeAllocatorSubject::deallocate(void* const t_allocatedMemoryPtr) {
+        m_allocator->deallocate(t_allocatedMemoryPtr);
+    };
+
+
+
+    std::size_t AeAllocatorSubject::getMemoryInUse() const {
+        std::size_t memoryInUse = m_allocator->getMemoryInUse();
+        if (m_fallbackAllocator) {
+            memoryInUse += m_fallbackAllocator->getMemoryInUse();
+        };
+        return memoryInUse;
+    };
+
+
+
+    double AeAllocatorSubject::getFragmentation() const {
+        return m_allocator->getFragmentation();
+    };
+
+
+
+    AeStackSubject::AeStackSubject(std::size_t const t_memorySize) :
+            AeBenchmarkSubject("stack"),
+            m_memoryPtr{allocateSubjectMemory(t_memorySize)},
+            m_allocator{std::make_unique<ae_memory::AeStackAllocator>(t_memorySize, m_memoryPtr)} {
+    };
+
+
+
+    AeStackSubject::~AeStackSubject() {
+        m_allocator.reset();
+        free(m_memoryPtr);
+    };
+
+
+
+    bool AeStackSubject::canReplay(const AeAllocationTrace& t_trace, std::size_t const t_numThreads) const {
+        return t_numThreads == 1 && t_trace.isLifo();
+    };
+
+
+
+    void AeStackSubject::prepare([[maybe_unused]] const AeAllocationTrace& t_trace) {
+        m_allocator->clearStack();
+        m_markers.clear();
+    };
+
+
+
+    void* AeStackSubject::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+        ae_memory::AeStackAllocator::StackMarker marker = m_allocator->getMarker();
+        void* allocation = m_allocator->allocate(t_allocationSize, t_byteAlignment);
+        m_markers.push_back(marker);
+        return allocation;
+    };
+
+
+
+    // The marker of the oldest allocation is the bottom of the stack, which the stack can only be cleared back to.
+    void AeStackSubject::deallocate([[maybe_unused]] void* const t_allocatedMemoryPtr) {
+        if (m_markers.size() == 1) {
+            m_allocator->clearStack();
+        } else {
+            m_allocator->deallocateToMarker(m_markers.back());
+        };
+        m_markers.pop_back();
+    };
+
+
+
+    void AeStackSubject::deallocateAll([[maybe_unused]] const std::vector<void*>& t_liveAllocations) {
+        m_allocator->clearStack();
+        m_markers.clear();
+    };
+
+
+
+    std::size_t AeStackSubject::getMemoryInUse() const {
+        return m_allocator->getMemoryInUse();
+    };
+
+
+
+    double AeStackSubject::getFragmentation() const {
+        return m_allocator->getFragmentation();
+    };
+
+
+
+    AeDeStackSubject::AeDeStackSubject(std::size_t const t_memorySize) :
+            AeBenchmarkSubject("de-stack"),
+            m_memoryPtr{allocateSubjectMemory(t_memorySize)},
+            m_allocator{std::make_unique<ae_memory::AeDeStackAllocator>(t_memorySize, m_memoryPtr)} {
+    };
+
+
+
+    AeDeStackSubject::~AeDeStackSubject() {
+        m_allocator.reset();
+        free(m_memoryPtr);
+    };
+
+
+
+    bool AeDeStackSubject::canReplay(const AeAllocationTrace& t_trace, std::size_t const t_numThreads) const {
+        return t_numThreads == 1 && t_trace.isLifo();
+    };
+
+
+
+    void AeDeStackSubject::prepare([[maybe_unused]] const AeAllocationTrace& t_trace) {
+        m_allocator->clearDoubleEndedStack();
+        m_bottomMarkers.clear();
+        m_topMarkers.clear();
+    };
+
+
+
+    // Allocations alternate ends, so with an even number of live allocations the next comes from the bottom.
+    void* AeDeStackSubject::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+        if (m_bottomMarkers.size() == m_topMarkers.size()) {
+            ae_memory::AeDeStackAllocator::BottomStackMarker marker = m_allocator->getBottomStackMarker();
+            void* allocation = m_allocator->allocateFromBottom(t_allocationSize, t_byteAlignment);
+            m_bottomMarkers.push_back(marker);
+            return allocation;
+        };
+
+        ae_memory::AeDeStackAllocator::TopStackMarker marker = m_allocator->getTopStackMarker();
+        void* allocation = m_allocator->allocateFromTop(t_allocationSize, t_byteAlignment);
+        m_topMarkers.push_back(marker);
+        return allocation;
+    };
+
+
+
+    // The newest allocation came from the bottom if the bottom has more live allocations than the top.
+    void AeDeStackSubject::deallocate([[maybe_unused]] void* const t_allocatedMemoryPtr) {
+        if (m_bottomMarkers.size() > m_topMarkers.size()) {
+            m_allocator->deallocateToBottomMarker(m_bottomMarkers.back());
+            m_bottomMarkers.pop_back();
+        } else {
+            m_allocator->deallocateToTopMarker(m_topMarkers.back());
+            m_topMarkers.pop_back();
+        };
+    };
+
+
+
+    void AeDeStackSubject::deallocateAll([[maybe_unused]] const std::vector<void*>& t_liveAllocations) {
+        m_allocator->clearDoubleEndedStack();
+        m_bottomMarkers.clear();
+        m_topMarkers.clear();
+    };
+
+
+
+    std::size_t AeDeStackSubject::getMemoryInUse() const {
+        return m_allocator->getMemoryInUse();
+    };
+
+
+
+    double AeDeStackSubject::getFragmentation() const {
+        return m_allocator->getFragmentation();
+    };
+
+
+
+    AeSystemSubject::AeSystemSubject() : AeBenchmarkSubject("system malloc") {
+    };
+
+
+
+    AeSystemSubject::~AeSystemSubject() = default;
+
+
+
+    bool AeSystemSubject::canReplay([[maybe_unused]] const AeAllocationTrace& t_trace,
+                                    [[maybe_unused]] std::size_t const t_numThreads) const {
+        return true;
+    };
+
+
+
+    // Plain malloc is used whenever it already gives the alignment, as most allocations in a game would.
+    void* AeSystemSubject::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+#if defined(_WIN32)
+        void* allocation = _aligned_malloc(t_allocationSize, t_byteAlignment);
+#else
+        void* allocation;
+        if (t_byteAlignment <= alignof(std::max_align_t)) {
+            allocation = malloc(t_allocationSize);
+        } else {
+            // aligned_alloc needs the size to be a multiple of the alignment.
+            std::size_t alignedSize = (t_allocationSize + t_byteAlignment - 1) & ~(t_byteAlignment - 1);
+            allocation = aligned_alloc(t_byteAlignment, alignedSize);
+        };
+#endif
+        if (allocation == nullptr) {
+            throw std::bad_alloc();
+        };
+        return allocation;
+    };
+
+
+
+    void AeSystemSubject::deallocate(void* const t_allocatedMemoryPtr) {
+#if defined(_WIN32)
+        _aligned_free(t_allocatedMemoryPtr);
+#else
+        free(t_allocatedMemoryPtr);
+#endif
+    };
+
+
+
+    std::vector<std::unique_ptr<AeBenchmarkSubject>> createBenchmarkSubjects(std::size_t const t_memorySize) {
+        std::vector<std::unique_ptr<AeBenchmarkSubject>> subjects;
+        subjects.push_back(std::make_unique<AeSystemSubject>());
+        subjects.push_back(std::make_unique<AeStackSubject>(t_memorySize));
+        subjects.push_back(std::make_unique<AeDeStackSubject>(t_memorySize));
+        subjects.push_back(std::make_unique<AeAllocatorSubject>("pool", benchmarkAllocator_pool, t_memorySize));
+        subjects.push_back(std::make_unique<AeAllocatorSubject>("free list",
+                                                                benchmarkAllocator_freeList,
+                                                                t_memorySize));
+        subjects.push_back(std::make_unique<AeAllocatorSubject>("tlsf", benchmarkAllocator_tlsf, t_memorySize));
+        subjects.push_back(std::make_unique<AeAllocatorSubject>("slab", benchmarkAllocator_slab, t_memorySize));
+        subjects.push_back(std::make_unique<AeAllocatorSubject>("thread caching",
+                                                                benchmarkAllocator_threadCaching,
+                                                                t_memorySize));
+        return subjects;
+    };
+
+} // namespace ae_bench
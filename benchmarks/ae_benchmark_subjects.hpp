@@ -0,0 +1,272 @@
+/// \file ae_benchmark_subjects.hpp
+/// The allocators the allocation traces are replayed against are defined.
+#pragma once
+
+// dependencies
+#include "ae_allocation_trace.hpp"
+#include "ae_allocator_base.hpp"
+#include "ae_stack_allocator.hpp"
+#include "ae_de_stack_allocator.hpp"
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ae_bench {
+
+    /// A AeBenchmarkSubject is an allocator the allocation traces are replayed against, it hides how each allocator
+    /// has to be set up and driven so every allocator can be replayed the same way.
+    class AeBenchmarkSubject {
+    public:
+
+        /// Constructor of AeBenchmarkSubject.
+        /// \param t_name The name the results of the subject are reported under.
+        explicit AeBenchmarkSubject(std::string t_name);
+
+        /// Destructor of AeBenchmarkSubject.
+        virtual ~AeBenchmarkSubject();
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeBenchmarkSubject(const AeBenchmarkSubject&) = delete;
+        AeBenchmarkSubject& operator=(const AeBenchmarkSubject&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeBenchmarkSubject(AeBenchmarkSubject&&) = delete;
+        AeBenchmarkSubject& operator=(AeBenchmarkSubject&&) = delete;
+
+        /// Gets the name the results of the subject are reported under.
+        /// \return The name.
+        [[nodiscard]] const std::string& getName() const { return m_name; };
+
+        /// Gets if the subject is replayed when no subjects are chosen on the command line.
+        /// \return True if the subject is replayed by default.
+        [[nodiscard]] virtual bool isIncludedByDefault() const { return true; };
+
+        /// Gets if the subject can replay a trace, such as a stack allocator only being able to replay traces that free
+        /// in the reverse order they allocate.
+        /// \param t_trace The trace to replay.
+        /// \param t_numThreads The number of threads replaying a trace at once.
+        /// \return True if the subject can replay the trace.
+        [[nodiscard]] virtual bool canReplay(const AeAllocationTrace& t_trace, std::size_t t_numThreads) const = 0;
+
+        /// Prepares the subject to replay a trace, it must be empty.
+        /// \param t_trace The trace to be replayed.
+        virtual void prepare([[maybe_unused]] const AeAllocationTrace& t_trace) {};
+
+        /// Allocates memory.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the returned memory.
+        /// \return The allocated memory.
+        virtual void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) = 0;
+
+        /// Deallocates memory allocated by the subject.
+        /// \param t_allocatedMemoryPtr The memory to deallocate.
+        virtual void deallocate(void* t_allocatedMemoryPtr) = 0;
+
+        /// Deallocates every live allocation after a replay has failed part way through.
+        /// \param t_liveAllocations The live allocations, in the order they were allocated.
+        virtual void deallocateAll(const std::vector<void*>& t_liveAllocations);
+
+        /// Gets if the subject can report the memory it uses and how fragmented it is.
+        /// \return True if getMemoryInUse and getFragmentation are meaningful.
+        [[nodiscard]] virtual bool hasMemoryStatistics() const { return true; };
+
+        /// Gets the number of bytes the subject has allocated, including its overhead.
+        /// \return The number of bytes in use.
+        [[nodiscard]] virtual std::size_t getMemoryInUse() const = 0;
+
+        /// Gets how fragmented the free memory of the subject is.
+        /// \return The fragmentation, from 0 to 1.
+        [[nodiscard]] virtual double getFragmentation() const = 0;
+
+    private:
+
+        /// The name the results of the subject are reported under.
+        std::string m_name;
+
+    protected:
+
+    };
+
+
+
+    /// The kinds of engine allocator that are replayed through AeAllocatorSubject.
+    enum BenchmarkAllocator {
+        benchmarkAllocator_pool,
+        benchmarkAllocator_freeList,
+        benchmarkAllocator_tlsf,
+        benchmarkAllocator_slab,
+        benchmarkAllocator_threadCaching
+    };
+
+    /// A AeAllocatorSubject replays traces against an engine allocator that can free its allocations in any order. The
+    /// pool allocator is recreated for each trace with the trace's allocation size as its chunk size.
+    class AeAllocatorSubject : public AeBenchmarkSubject {
+    public:
+
+        /// Constructor of AeAllocatorSubject.
+        /// \param t_name The name the results of the subject are reported under.
+        /// \param t_allocator The kind of engine allocator.
+        /// \param t_memorySize The size of the memory the allocator is given.
+        AeAllocatorSubject(std::string t_name, BenchmarkAllocator t_allocator, std::size_t t_memorySize);
+
+        /// Destructor of AeAllocatorSubject.
+        ~AeAllocatorSubject() override;
+
+        /// The free list allocator does not merge freed chunks yet, so its free list grows with every deallocation and
+        /// the default traces take too long to replay against it.
+        /// \return False for the free list allocator.
+        [[nodiscard]] bool isIncludedByDefault() const override {
+            return m_allocatorType != benchmarkAllocator_freeList;
+        };
+
+        [[nodiscard]] bool canReplay(const AeAllocationTrace& t_trace, std::size_t t_numThreads) const override;
+        void prepare(const AeAllocationTrace& t_trace) override;
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+        void deallocate(void* t_allocatedMemoryPtr) override;
+        [[nodiscard]] std::size_t getMemoryInUse() const override;
+        [[nodiscard]] double getFragmentation() const override;
+
+    private:
+
+        /// The kind of engine allocator.
+        BenchmarkAllocator m_allocatorType;
+
+        /// The memory the allocators are given.
+        void* m_memoryPtr;
+
+        /// The size of the memory the allocators are given.
+        std::size_t m_memorySize;
+
+        /// The alignment of the chunks of the pool allocator, every allocation from the pool must ask for it.
+        std::size_t m_poolAlignment = 0;
+
+        /// The allocator the slab allocator falls back to for allocations too large for its size classes.
+        std::unique_ptr<ae_memory::AeAllocatorBase> m_fallbackAllocator;
+
+        /// The allocator the traces are replayed against.
+        std::unique_ptr<ae_memory::AeAllocatorBase> m_allocator;
+
+    protected:
+
+    };
+
+
+
+    /// A AeStackSubject replays traces that free in reverse order against the stack allocator, freeing each allocation
+    /// by rolling the stack back to the marker taken before it was made.
+    class AeStackSubject : public AeBenchmarkSubject {
+    public:
+
+        /// Constructor of AeStackSubject.
+        /// \param t_memorySize The size of the memory the stack allocator is given.
+        explicit AeStackSubject(std::size_t t_memorySize);
+
+        /// Destructor of AeStackSubject.
+        ~AeStackSubject() override;
+
+        [[nodiscard]] bool canReplay(const AeAllocationTrace& t_trace, std::size_t t_numThreads) const override;
+        void prepare(const AeAllocationTrace& t_trace) override;
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+        void deallocate(void* t_allocatedMemoryPtr) override;
+        void deallocateAll(const std::vector<void*>& t_liveAllocations) override;
+        [[nodiscard]] std::size_t getMemoryInUse() const override;
+        [[nodiscard]] double getFragmentation() const override;
+
+    private:
+
+        /// The memory the stack allocator is given.
+        void* m_memoryPtr;
+
+        /// The stack allocator.
+        std::unique_ptr<ae_memory::AeStackAllocator> m_allocator;
+
+        /// The marker taken before each live allocation, oldest first.
+        std::vector<ae_memory::AeStackAllocator::StackMarker> m_markers;
+
+    protected:
+
+    };
+
+
+
+    /// A AeDeStackSubject replays traces that free in reverse order against the double ended stack allocator,
+    /// alternating which end each allocation is made from.
+    class AeDeStackSubject : public AeBenchmarkSubject {
+    public:
+
+        /// Constructor of AeDeStackSubject.
+        /// \param t_memorySize The size of the memory the double ended stack allocator is given.
+        explicit AeDeStackSubject(std::size_t t_memorySize);
+
+        /// Destructor of AeDeStackSubject.
+        ~AeDeStackSubject() override;
+
+        [[nodiscard]] bool canReplay(const AeAllocationTrace& t_trace, std::size_t t_numThreads) const override;
+        void prepare(const AeAllocationTrace& t_trace) override;
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+        void deallocate(void* t_allocatedMemoryPtr) override;
+        void deallocateAll(const std::vector<void*>& t_liveAllocations) override;
+        [[nodiscard]] std::size_t getMemoryInUse() const override;
+        [[nodiscard]] double getFragmentation() const override;
+
+    private:
+
+        /// The memory the double ended stack allocator is given.
+        void* m_memoryPtr;
+
+        /// The double ended stack allocator.
+        std::unique_ptr<ae_memory::AeDeStackAllocator> m_allocator;
+
+        /// The marker taken before each live allocation from the bottom of the stack, oldest first.
+        std::vector<ae_memory::AeDeStackAllocator::BottomStackMarker> m_bottomMarkers;
+
+        /// The marker taken before each live allocation from the top of the stack, oldest first.
+        std::vector<ae_memory::AeDeStackAllocator::TopStackMarker> m_topMarkers;
+
+    protected:
+
+    };
+
+
+
+    /// A AeSystemSubject replays traces against the allocator of the C runtime, as the baseline the engine allocators
+    /// are judged against.
+    class AeSystemSubject : public AeBenchmarkSubject {
+    public:
+
+        /// Constructor of AeSystemSubject.
+        AeSystemSubject();
+
+        /// Destructor of AeSystemSubject.
+        ~AeSystemSubject() override;
+
+        [[nodiscard]] bool canReplay(const AeAllocationTrace& t_trace, std::size_t t_numThreads) const override;
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+        void deallocate(void* t_allocatedMemoryPtr) override;
+
+        /// The C runtime does not report the memory it uses.
+        /// \return False.
+        [[nodiscard]] bool hasMemoryStatistics() const override { return false; };
+
+        [[nodiscard]] std::size_t getMemoryInUse() const override { return 0; };
+        [[nodiscard]] double getFragmentation() const override { return 0.0; };
+
+    private:
+
+    protected:
+
+    };
+
+
+
+    /// Creates a subject for every engine allocator and the system allocator.
+    /// \param t_memorySize The size of the memory each engine allocator is given.
+    /// \return The subjects.
+    std::vector<std::unique_ptr<AeBenchmarkSubject>> createBenchmarkSubjects(std::size_t t_memorySize);
+
+} // namespace ae_bench
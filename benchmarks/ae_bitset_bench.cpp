@@ -0,0 +1,404 @@
+/// \file ae_bitset_bench.cpp
+/// Times ae::HierarchicalBitset against std::vector<bool>, std::bitset and std::unordered_set as a set of entity IDs,
+/// the way the ECS keeps the entities each system has to update or clean up, at a few numbers of possible IDs and
+/// fractions of them in the set. Each container is timed:
+/// - inserting and erasing random IDs, and checking random IDs are in the set, reported per ID,
+/// - iterating over the IDs in the set, finding the lowest ID in the set, the union and intersection with another set
+///   of the same density and clearing the set, reported per call.
+/// std::bitset is sized at compile time, so it always holds the largest number of IDs the benchmark allows.
+///
+/// Usage: ae_bitset_bench [options]
+///   --sizes <n,n,...>      The numbers of possible IDs, 16000,1000000 by default, at most 1048576.
+///   --densities <p,p,...>  The percentages of the possible IDs in the set, 1,50 by default.
+///   --repetitions <n>      The number of times each case is timed, the median is reported, 5 by default.
+///   --json <file>          Writes the results to a file as JSON.
+
+// dependencies
+#include "hierarchical_bitset.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+    /// The size of the std::bitset, and so the largest number of possible IDs.
+    constexpr std::size_t MAX_NUM_BITS = std::size_t{1} << 20;
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_sizes{16000, 1000000};
+        std::vector<double> m_densities{1.0, 50.0};
+        std::size_t m_numRepetitions = 5;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one container took for an operation.
+    struct SetResult {
+        std::string m_subjectName;
+        std::string m_operationName;
+        std::size_t m_numBits = 0;
+        std::size_t m_numSet = 0;
+        double m_nsPerOperation = 0.0;
+    };
+
+    /// A set of IDs in a ae::HierarchicalBitset.
+    class HierarchicalSubject {
+    public:
+        explicit HierarchicalSubject(std::size_t t_numBits) : m_bitset{t_numBits} {};
+        void insert(std::size_t t_id) { m_bitset.set(t_id); };
+        void erase(std::size_t t_id) { m_bitset.reset(t_id); };
+        [[nodiscard]] bool contains(std::size_t t_id) const { return m_bitset.test(t_id); };
+        template<typename TFunction>
+        void forEach(TFunction&& t_function) const { m_bitset.forEachSet(t_function); };
+        [[nodiscard]] std::size_t findFirst() const { return m_bitset.findFirstSet(); };
+        void unite(const HierarchicalSubject& t_other) { m_bitset |= t_other.m_bitset; };
+        void intersect(const HierarchicalSubject& t_other) { m_bitset &= t_other.m_bitset; };
+        void clear() { m_bitset.clear(); };
+
+    private:
+        ae::HierarchicalBitset m_bitset;
+    };
+
+    /// A set of IDs in a std::vector<bool>.
+    class VectorBoolSubject {
+    public:
+        explicit VectorBoolSubject(std::size_t t_numBits) : m_bits(t_numBits, false) {};
+        void insert(std::size_t t_id) { m_bits[t_id] = true; };
+        void erase(std::size_t t_id) { m_bits[t_id] = false; };
+        [[nodiscard]] bool contains(std::size_t t_id) const { return m_bits[t_id]; };
+        template<typename TFunction>
+        void forEach(TFunction&& t_function) const {
+            for (std::size_t id = 0; id < m_bits.size(); id++) {
+                if (m_bits[id]) {
+                    t_function(id);
+                };
+            };
+        };
+        [[nodiscard]] std::size_t findFirst() const {
+            auto first = std::find(m_bits.begin(), m_bits.end(), true);
+            return first == m_bits.end() ? ae::HierarchicalBitset::npos : static_cast<std::size_t>(first - m_bits.begin());
+        };
+        void unite(const VectorBoolSubject& t_other) {
+            for (std::size_t id = 0; id < m_bits.size(); id++) {
+                m_bits[id] = m_bits[id] || t_other.m_bits[id];
+            };
+        };
+        void intersect(const VectorBoolSubject& t_other) {
+            for (std::size_t id = 0; id < m_bits.size(); id++) {
+                m_bits[id] = m_bits[id] && t_other.m_bits[id];
+            };
+        };
+        void clear() { std::fill(m_bits.begin(), m_bits.end(), false); };
+
+    private:
+        std::vector<bool> m_bits;
+    };
+
+    /// A set of IDs in a std::bitset of the largest size.
+    class BitsetSubject {
+    public:
+        explicit BitsetSubject(std::size_t t_numBits) :
+                m_numBits{t_numBits}, m_bits{std::make_unique<std::bitset<MAX_NUM_BITS>>()} {};
+        void insert(std::size_t t_id) { m_bits->set(t_id); };
+        void erase(std::size_t t_id) { m_bits->reset(t_id); };
+        [[nodiscard]] bool contains(std::size_t t_id) const { return m_bits->test(t_id); };
+        template<typename TFunction>
+        void forEach(TFunction&& t_function) const {
+            for (std::size_t id = 0; id < m_numBits; id++) {
+                if ((*m_bits)[id]) {
+                    t_function(id);
+                };
+            };
+        };
+        [[nodiscard]] std::size_t findFirst() const {
+            for (std::size_t id = 0; id < m_numBits; id++) {
+                if ((*m_bits)[id]) {
+                    return id;
+                };
+            };
+            return ae::HierarchicalBitset::npos;
+        };
+        void unite(const BitsetSubject& t_other) { *m_bits |= *t_other.m_bits; };
+        void intersect(const BitsetSubject& t_other) { *m_bits &= *t_other.m_bits; };
+        void clear() { m_bits->reset(); };
+
+    private:
+        std::size_t m_numBits;
+        std::unique_ptr<std::bitset<MAX_NUM_BITS>> m_bits;
+    };
+
+    /// A set of IDs in a std::unordered_set.
+    class UnorderedSetSubject {
+    public:
+        explicit UnorderedSetSubject(std::size_t) {};
+        void insert(std::size_t t_id) { m_ids.insert(t_id); };
+        void erase(std::size_t t_id) { m_ids.erase(t_id); };
+        [[nodiscard]] bool contains(std::size_t t_id) const { return m_ids.count(t_id) == 1; };
+        template<typename TFunction>
+        void forEach(TFunction&& t_function) const {
+            for (std::size_t id: m_ids) {
+                t_function(id);
+            };
+        };
+        [[nodiscard]] std::size_t findFirst() const {
+            return m_ids.empty() ? ae::HierarchicalBitset::npos : *std::min_element(m_ids.begin(), m_ids.end());
+        };
+        void unite(const UnorderedSetSubject& t_other) { m_ids.insert(t_other.m_ids.begin(), t_other.m_ids.end()); };
+        void intersect(const UnorderedSetSubject& t_other) {
+            for (auto id = m_ids.begin(); id != m_ids.end();) {
+                id = t_other.m_ids.count(*id) == 1 ? std::next(id) : m_ids.erase(id);
+            };
+        };
+        void clear() { m_ids.clear(); };
+
+    private:
+        std::unordered_set<std::size_t> m_ids;
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_bitset_bench [options]\n"
+                     "  --sizes <n,n,...>      Numbers of possible IDs (default 16000,1000000, at most 1048576)\n"
+                     "  --densities <p,p,...>  Percentages of the possible IDs in the set (default 1,50)\n"
+                     "  --repetitions <n>      Timings of each case, the median is reported (default 5)\n"
+                     "  --json <file>          Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--sizes" || option == "--densities") {
+                std::stringstream values{value};
+                std::string element;
+                if (option == "--sizes") {
+                    options.m_sizes.clear();
+                    while (std::getline(values, element, ',')) {
+                        options.m_sizes.push_back(std::clamp<std::size_t>(std::stoull(element), 64, MAX_NUM_BITS));
+                    };
+                } else {
+                    options.m_densities.clear();
+                    while (std::getline(values, element, ',')) {
+                        options.m_densities.push_back(std::clamp(std::stod(element), 0.0, 100.0));
+                    };
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Keeps a value from being optimised away.
+    volatile std::size_t g_sink = 0;
+
+    /// Times a task.
+    /// \return The time the task took in nanoseconds.
+    template<typename TTask>
+    double timeNs(TTask&& t_task) {
+        auto start = std::chrono::steady_clock::now();
+        t_task();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    };
+
+    /// Makes a fresh set holding the same IDs as another, since the containers are not all cheap to copy.
+    template<typename TSubject>
+    TSubject copySubject(const TSubject& t_subject, std::size_t t_numBits) {
+        TSubject copy{t_numBits};
+        t_subject.forEach([&copy](std::size_t t_id) { copy.insert(t_id); });
+        return copy;
+    };
+
+    /// Times every operation of one container.
+    /// \tparam TSubject The container.
+    /// \param t_ids The IDs put in the set, in a random order.
+    /// \param t_otherIds The IDs of the other set of the unions and intersections.
+    /// \param t_queryIds Random IDs checked to be in the set.
+    template<typename TSubject>
+    void runSubject(const std::string& t_subjectName,
+                    std::size_t t_numBits,
+                    const std::vector<std::size_t>& t_ids,
+                    const std::vector<std::size_t>& t_otherIds,
+                    const std::vector<std::size_t>& t_queryIds,
+                    const BenchmarkOptions& t_options,
+                    std::vector<SetResult>& t_results) {
+        TSubject other{t_numBits};
+        for (std::size_t id: t_otherIds) {
+            other.insert(id);
+        };
+
+        auto perId = [](double t_ns, std::size_t t_numIds) { return t_ns / static_cast<double>(std::max<std::size_t>(t_numIds, 1)); };
+        std::map<std::string, std::vector<double>> operationTimes;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            TSubject subject{t_numBits};
+            operationTimes["insert"].push_back(perId(timeNs([&]() {
+                for (std::size_t id: t_ids) {
+                    subject.insert(id);
+                };
+            }), t_ids.size()));
+
+            operationTimes["contains"].push_back(perId(timeNs([&]() {
+                std::size_t numFound = 0;
+                for (std::size_t id: t_queryIds) {
+                    numFound += subject.contains(id);
+                };
+                g_sink = numFound;
+            }), t_queryIds.size()));
+
+            operationTimes["iterate"].push_back(timeNs([&]() {
+                std::size_t sum = 0;
+                subject.forEach([&sum](std::size_t t_id) { sum += t_id; });
+                g_sink = sum;
+            }));
+
+            operationTimes["find first"].push_back(timeNs([&]() {
+                g_sink = subject.findFirst();
+            }));
+
+            // Erases then reinserts every other ID, both timed together.
+            double eraseNs = timeNs([&]() {
+                for (std::size_t i = 0; i < t_ids.size(); i += 2) {
+                    subject.erase(t_ids[i]);
+                };
+                for (std::size_t i = 0; i < t_ids.size(); i += 2) {
+                    subject.insert(t_ids[i]);
+                };
+            });
+            operationTimes["erase + reinsert"].push_back(perId(eraseNs, t_ids.size()));
+
+            TSubject unionSubject = copySubject(subject, t_numBits);
+            operationTimes["union"].push_back(timeNs([&]() { unionSubject.unite(other); }));
+            TSubject intersectionSubject = copySubject(subject, t_numBits);
+            operationTimes["intersection"].push_back(timeNs([&]() { intersectionSubject.intersect(other); }));
+
+            operationTimes["clear"].push_back(timeNs([&]() { unionSubject.clear(); }));
+            if (unionSubject.findFirst() != ae::HierarchicalBitset::npos) {
+                throw std::runtime_error(t_subjectName + " was not cleared!");
+            };
+        };
+
+        for (auto& [operationName, times]: operationTimes) {
+            std::sort(times.begin(), times.end());
+            t_results.push_back({t_subjectName, operationName, t_numBits, t_ids.size(), times[times.size() / 2]});
+        };
+    };
+
+    /// Times every container at one number of possible IDs and density.
+    void runCase(std::size_t t_numBits, double t_density, const BenchmarkOptions& t_options,
+                 std::vector<SetResult>& t_results) {
+        std::mt19937_64 random{t_numBits};
+        auto numIds = static_cast<std::size_t>(static_cast<double>(t_numBits) * t_density / 100.0);
+        auto pickIds = [&]() {
+            std::vector<std::size_t> ids(t_numBits);
+            for (std::size_t id = 0; id < t_numBits; id++) {
+                ids[id] = id;
+            };
+            std::shuffle(ids.begin(), ids.end(), random);
+            ids.resize(numIds);
+            return ids;
+        };
+        std::vector<std::size_t> ids = pickIds();
+        std::vector<std::size_t> otherIds = pickIds();
+        std::vector<std::size_t> queryIds(std::max<std::size_t>(numIds, 1000));
+        for (auto& id: queryIds) {
+            id = random() % t_numBits;
+        };
+
+        runSubject<VectorBoolSubject>("std::vector<bool>", t_numBits, ids, otherIds, queryIds, t_options, t_results);
+        runSubject<BitsetSubject>("std::bitset", t_numBits, ids, otherIds, queryIds, t_options, t_results);
+        runSubject<UnorderedSetSubject>("std::unordered_set", t_numBits, ids, otherIds, queryIds, t_options,
+                                        t_results);
+        runSubject<HierarchicalSubject>("ae::HierarchicalBitset", t_numBits, ids, otherIds, queryIds, t_options,
+                                        t_results);
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<SetResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(24) << "container" << std::setw(18) << "operation" << std::right
+                 << std::setw(10) << "ids" << std::setw(10) << "in set" << std::setw(14) << "ns" << "\n";
+        for (const auto& result: t_results) {
+            t_stream << std::left << std::setw(24) << result.m_subjectName << std::setw(18) << result.m_operationName
+                     << std::right << std::setw(10) << result.m_numBits << std::setw(10) << result.m_numSet
+                     << std::fixed << std::setprecision(2) << std::setw(14) << result.m_nsPerOperation << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<SetResult>& t_results, const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"container\": \"" << result.m_subjectName
+                 << "\", \"operation\": \"" << result.m_operationName << "\", \"ids\": " << result.m_numBits
+                 << ", \"in_set\": " << result.m_numSet << ", \"ns\": " << result.m_nsPerOperation << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+
+        std::vector<SetResult> results;
+        for (std::size_t numBits: options.m_sizes) {
+            for (double density: options.m_densities) {
+                std::cerr << "Timing " << numBits << " possible IDs with " << density << "% of them in the set.\n";
+                runCase(numBits, density, options, results);
+            };
+        };
+
+        std::cout << "insert, contains and erase + reinsert are per ID, the other operations per call.\n";
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,285 @@
+/// \file ae_bvh_bench.cpp
+/// Times building, refitting and querying ae::LinearBvh over random AABBs, with the queries also timed against the
+/// linear batch functions of simd_geometry.hpp they replace:
+/// - building the tree with 30 and 63 bit Morton codes on the calling thread and on the engine's job system,
+/// - refitting the tree after every box moves, on the calling thread and on the job system,
+/// - culling against a camera's frustum, casting a ray and finding the boxes within a sphere,
+/// - finding every overlapping pair of boxes on the job system, the broadphase of collision detection.
+/// The boxes are spread so the number of boxes around each point stays the same as the number of boxes grows, the
+/// way a larger world holds more entities.
+///
+/// Usage: ae_bvh_bench [options]
+///   --counts <n,n,...>   The numbers of boxes, 10000,100000,1000000 by default.
+///   --repetitions <n>    The number of times each case is timed, the median is reported, 5 by default.
+///   --workers <n>        The number of job system workers, one fewer than the hardware threads by default.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "ae_job_system.hpp"
+#include "linear_bvh.hpp"
+#include "simd_geometry.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_counts{10000, 100000, 1000000};
+        std::size_t m_numRepetitions = 5;
+        std::size_t m_numWorkers = ae_jobs::AeJobSystem::defaultNumWorkers();
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one case took.
+    struct BvhResult {
+        std::string m_caseName;
+        std::size_t m_numPrimitives = 0;
+        double m_milliseconds = 0.0;
+        std::size_t m_numFound = 0;
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_bvh_bench [options]\n"
+                     "  --counts <n,n,...>   Numbers of boxes (default 10000,100000,1000000)\n"
+                     "  --repetitions <n>    Timings of each case, the median is reported (default 5)\n"
+                     "  --workers <n>        Job system workers (default one fewer than the hardware threads)\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--counts") {
+                options.m_counts.clear();
+                std::stringstream counts{value};
+                std::string count;
+                while (std::getline(counts, count, ',')) {
+                    options.m_counts.push_back(std::max<std::size_t>(std::stoull(count), 1));
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--workers") {
+                options.m_numWorkers = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Times a task.
+    /// \return The time the task took in milliseconds.
+    template<typename TTask>
+    double timeMs(TTask&& t_task) {
+        auto start = std::chrono::steady_clock::now();
+        t_task();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    /// Makes boxes half a unit to two units across, spread through a cube sized for about one box in every 64 cubic
+    /// units.
+    ae::AabbSoa makeBoxes(std::size_t t_numBoxes, float t_halfExtent) {
+        std::mt19937 random{static_cast<std::mt19937::result_type>(t_numBoxes)};
+        std::uniform_real_distribution<float> position{-t_halfExtent, t_halfExtent};
+        std::uniform_real_distribution<float> halfSize{0.25f, 1.0f};
+        ae::AabbSoa boxes{};
+        boxes.resize(t_numBoxes);
+        for (std::size_t box = 0; box < t_numBoxes; box++) {
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float center = position(random);
+                float size = halfSize(random);
+                boxes.m_min[axis][box] = center - size;
+                boxes.m_max[axis][box] = center + size;
+            };
+        };
+        return boxes;
+    };
+
+    /// Times every case for one number of boxes.
+    void runCase(std::size_t t_numBoxes, ae_jobs::AeJobSystem& t_jobSystem, const BenchmarkOptions& t_options,
+                 std::vector<BvhResult>& t_results) {
+        const float halfExtent = 2.0f * std::cbrt(static_cast<float>(t_numBoxes));
+        ae::AabbSoa boxes = makeBoxes(t_numBoxes, halfExtent);
+        ae::AabbSoa movedBoxes = boxes;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            for (auto& position: movedBoxes.m_min[axis]) {
+                position += 0.1f;
+            };
+            for (auto& position: movedBoxes.m_max[axis]) {
+                position += 0.1f;
+            };
+        };
+
+        // A camera at the centre looking down -z, 90 degrees wide, seeing a tenth of the way across the world.
+        const float near = 0.1f;
+        const float far = halfExtent * 0.2f;
+        const float projection[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+                                      0.0f, 1.0f, 0.0f, 0.0f,
+                                      0.0f, 0.0f, far / (near - far), -1.0f,
+                                      0.0f, 0.0f, -(far * near) / (far - near), 0.0f};
+        const ae::Frustum frustum = ae::Frustum::fromViewProjection(projection);
+        const std::array<float, 3> sphereCenter{1.0f, 2.0f, 3.0f};
+        const float sphereRadius = 8.0f;
+
+        // Rays from random points in random directions, timed together.
+        std::mt19937 random{7};
+        std::uniform_real_distribution<float> position{-halfExtent, halfExtent};
+        std::uniform_real_distribution<float> direction{-1.0f, 1.0f};
+        std::vector<ae::Ray> rays(100);
+        for (auto& ray: rays) {
+            ray = {{position(random), position(random), position(random)},
+                   {direction(random), direction(random), direction(random)}};
+        };
+
+        ae::LinearBvh bvh{};
+        std::vector<uint8_t> isFound;
+        std::vector<float> hitDistances;
+
+        struct Case {
+            const char* m_name;
+            std::function<std::size_t()> m_task;
+        };
+        const std::vector<Case> cases{
+                {"build 30 bit", [&]() { bvh.build(boxes, ae::mortonCodeBits_30); return bvh.getNodes().size(); }},
+                {"build 63 bit", [&]() { bvh.build(boxes, ae::mortonCodeBits_63); return bvh.getNodes().size(); }},
+                {"job build 30 bit", [&]() { bvh.parallelBuild(t_jobSystem, boxes, ae::mortonCodeBits_30); return bvh.getNodes().size(); }},
+                {"job build 63 bit", [&]() { bvh.parallelBuild(t_jobSystem, boxes, ae::mortonCodeBits_63); return bvh.getNodes().size(); }},
+                {"refit", [&]() { bvh.refit(movedBoxes); return bvh.getNodes().size(); }},
+                {"job refit", [&]() { bvh.parallelRefit(t_jobSystem, movedBoxes); return bvh.getNodes().size(); }},
+                {"frustum linear", [&]() { return ae::cullAabbs(frustum, movedBoxes, isFound); }},
+                {"frustum bvh", [&]() {
+                    std::size_t numFound = 0;
+                    bvh.queryFrustum(frustum, [&numFound](uint32_t) { numFound++; });
+                    return numFound;
+                }},
+                {"100 rays linear", [&]() {
+                    std::size_t numHits = 0;
+                    for (const auto& ray: rays) {
+                        numHits += ae::raycastAabbs(ray, halfExtent, movedBoxes, hitDistances) != ae::NO_HIT;
+                    };
+                    return numHits;
+                }},
+                {"100 rays bvh", [&]() {
+                    std::size_t numHits = 0;
+                    for (const auto& ray: rays) {
+                        numHits += bvh.raycast(ray, halfExtent) != ae::NO_HIT;
+                    };
+                    return numHits;
+                }},
+                {"sphere linear", [&]() { return ae::overlapSphereAabbs(sphereCenter, sphereRadius, movedBoxes, isFound); }},
+                {"sphere bvh", [&]() {
+                    std::size_t numFound = 0;
+                    bvh.querySphere(sphereCenter, sphereRadius, [&numFound](uint32_t) { numFound++; });
+                    return numFound;
+                }},
+                {"job pairs bvh", [&]() {
+                    std::atomic<std::size_t> numPairs{0};
+                    bvh.parallelFindOverlappingPairs(t_jobSystem, [&numPairs](uint32_t, uint32_t) {
+                        numPairs.fetch_add(1, std::memory_order_relaxed);
+                    });
+                    return numPairs.load();
+                }}};
+
+        // The queries are timed on the refit tree of the moved boxes, which the build and refit cases leave behind.
+        for (const Case& benchmarkCase: cases) {
+            std::size_t numFound = 0;
+            std::vector<double> times;
+            for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+                times.push_back(timeMs([&]() { numFound = benchmarkCase.m_task(); }));
+            };
+            std::sort(times.begin(), times.end());
+            t_results.push_back({benchmarkCase.m_name, t_numBoxes, times[times.size() / 2], numFound});
+        };
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<BvhResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(20) << "case" << std::right << std::setw(10) << "boxes" << std::setw(14)
+                 << "ms" << std::setw(12) << "found" << "\n";
+        for (const auto& result: t_results) {
+            t_stream << std::left << std::setw(20) << result.m_caseName << std::right << std::setw(10)
+                     << result.m_numPrimitives << std::fixed << std::setprecision(3) << std::setw(14)
+                     << result.m_milliseconds << std::setw(12) << result.m_numFound << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<BvhResult>& t_results, const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"case\": \"" << result.m_caseName << "\", \"boxes\": "
+                 << result.m_numPrimitives << ", \"ms\": " << result.m_milliseconds << ", \"found\": "
+                 << result.m_numFound << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+        ae_jobs::AeJobSystem jobSystem{options.m_numWorkers};
+
+        std::vector<BvhResult> results;
+        for (std::size_t numBoxes: options.m_counts) {
+            std::cerr << "Timing " << numBoxes << " boxes.\n";
+            runCase(numBoxes, jobSystem, options, results);
+        };
+
+        std::cout << "Timed with " << jobSystem.getNumThreads() << " job system threads.\n";
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
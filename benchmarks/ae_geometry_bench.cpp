@@ -0,0 +1,418 @@
+/// \file ae_geometry_bench.cpp
+/// Times the batch bounding volume functions of simd_geometry.hpp against the same calculations done one entity at a
+/// time on arrays of structures, the way the entity data is laid out in Entity3DSSBOData:
+/// - transforming model OBBs to world AABBs, as collision.comp does,
+/// - culling AABBs and spheres against a camera's frustum,
+/// - casting a picking ray against AABBs,
+/// - finding the AABBs within a sphere.
+/// Each case is reported per entity. Which SIMD path is timed depends on the compiler flags the benchmark is built
+/// with, AVX2 needs -mavx2 or /arch:AVX2.
+///
+/// Usage: ae_geometry_bench [options]
+///   --counts <n,n,...>   The numbers of entities, 1000,100000,1000000 by default.
+///   --repetitions <n>    The number of times each case is timed, the median is reported, 5 by default.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "simd_geometry.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_counts{1000, 100000, 1000000};
+        std::size_t m_numRepetitions = 5;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one layout took for one operation, per entity.
+    struct GeometryResult {
+        std::string m_layoutName;
+        std::string m_operationName;
+        std::size_t m_numEntities = 0;
+        double m_nsPerEntity = 0.0;
+    };
+
+    /// An entity as the per entity loops see it, its model matrix and the index of its model's OBB.
+    struct EntityAos {
+        float m_modelMatrix[16];
+        uint32_t m_obbIndex;
+    };
+
+    /// A box in the layout of VkAabbPositionsKHR.
+    struct AabbAos {
+        float m_positions[6];
+    };
+
+    /// A sphere.
+    struct SphereAos {
+        float m_center[3];
+        float m_radius;
+    };
+
+    /// The entities in both layouts.
+    struct Scene {
+        std::vector<EntityAos> m_entities;
+        std::vector<AabbAos> m_modelObbs;
+        std::vector<AabbAos> m_aabbs;
+        std::vector<SphereAos> m_spheres;
+
+        ae::TransformSoa m_transforms;
+        std::vector<uint32_t> m_obbIndices;
+        ae::AabbSoa m_modelObbsSoa;
+        ae::AabbSoa m_aabbsSoa;
+        ae::SphereSoa m_spheresSoa;
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_geometry_bench [options]\n"
+                     "  --counts <n,n,...>   Numbers of entities (default 1000,100000,1000000)\n"
+                     "  --repetitions <n>    Timings of each case, the median is reported (default 5)\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--counts") {
+                options.m_counts.clear();
+                std::stringstream counts{value};
+                std::string count;
+                while (std::getline(counts, count, ',')) {
+                    options.m_counts.push_back(std::max<std::size_t>(std::stoull(count), 1));
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Keeps a value from being optimised away.
+    volatile float g_sink = 0.0f;
+
+    /// Times a task.
+    /// \return The time the task took in nanoseconds.
+    template<typename TTask>
+    double timeNs(TTask&& t_task) {
+        auto start = std::chrono::steady_clock::now();
+        t_task();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    };
+
+    /// Makes entities with random model matrices spread through a cube around the camera, with random boxes and
+    /// spheres about the size of a model.
+    Scene makeScene(std::size_t t_numEntities) {
+        std::mt19937 random{static_cast<std::mt19937::result_type>(t_numEntities)};
+        std::uniform_real_distribution<float> position{-500.0f, 500.0f};
+        std::uniform_real_distribution<float> angle{-3.14159f, 3.14159f};
+        std::uniform_real_distribution<float> size{0.5f, 4.0f};
+
+        Scene scene{};
+        constexpr std::size_t numModels = 16;
+        scene.m_modelObbs.resize(numModels);
+        scene.m_modelObbsSoa.resize(numModels);
+        for (std::size_t model = 0; model < numModels; model++) {
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                scene.m_modelObbs[model].m_positions[axis] = -size(random);
+                scene.m_modelObbs[model].m_positions[axis + 3] = size(random);
+            };
+            scene.m_modelObbsSoa.set(model, scene.m_modelObbs[model].m_positions);
+        };
+
+        scene.m_entities.resize(t_numEntities);
+        scene.m_aabbs.resize(t_numEntities);
+        scene.m_spheres.resize(t_numEntities);
+        scene.m_transforms.resize(t_numEntities);
+        scene.m_obbIndices.resize(t_numEntities);
+        scene.m_aabbsSoa.resize(t_numEntities);
+        scene.m_spheresSoa.resize(t_numEntities);
+        for (std::size_t entity = 0; entity < t_numEntities; entity++) {
+            // A rotation about y then a scale, enough for the transform to touch every element.
+            float yaw = angle(random);
+            float scale = size(random);
+            EntityAos& entityAos = scene.m_entities[entity];
+            std::fill(std::begin(entityAos.m_modelMatrix), std::end(entityAos.m_modelMatrix), 0.0f);
+            entityAos.m_modelMatrix[0] = scale * std::cos(yaw);
+            entityAos.m_modelMatrix[2] = -scale * std::sin(yaw);
+            entityAos.m_modelMatrix[5] = scale;
+            entityAos.m_modelMatrix[8] = scale * std::sin(yaw);
+            entityAos.m_modelMatrix[10] = scale * std::cos(yaw);
+            entityAos.m_modelMatrix[12] = position(random);
+            entityAos.m_modelMatrix[13] = position(random);
+            entityAos.m_modelMatrix[14] = position(random);
+            entityAos.m_modelMatrix[15] = 1.0f;
+            entityAos.m_obbIndex = static_cast<uint32_t>(random() % numModels);
+            scene.m_transforms.set(entity, entityAos.m_modelMatrix);
+            scene.m_obbIndices[entity] = entityAos.m_obbIndex;
+
+            SphereAos& sphere = scene.m_spheres[entity];
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float halfSize = size(random);
+                sphere.m_center[axis] = position(random);
+                scene.m_aabbs[entity].m_positions[axis] = sphere.m_center[axis] - halfSize;
+                scene.m_aabbs[entity].m_positions[axis + 3] = sphere.m_center[axis] + halfSize;
+                scene.m_spheresSoa.m_center[axis][entity] = sphere.m_center[axis];
+            };
+            sphere.m_radius = size(random);
+            scene.m_spheresSoa.m_radius[entity] = sphere.m_radius;
+            scene.m_aabbsSoa.set(entity, scene.m_aabbs[entity].m_positions);
+        };
+        return scene;
+    };
+
+    /// collision.comp one entity at a time.
+    void transformObbsAos(const Scene& t_scene, std::vector<AabbAos>& t_worldAabbs) {
+        t_worldAabbs.resize(t_scene.m_entities.size());
+        for (std::size_t entity = 0; entity < t_scene.m_entities.size(); entity++) {
+            const float* modelMatrix = t_scene.m_entities[entity].m_modelMatrix;
+            const float* obb = t_scene.m_modelObbs[t_scene.m_entities[entity].m_obbIndex].m_positions;
+            float* aabb = t_worldAabbs[entity].m_positions;
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                aabb[axis] = modelMatrix[12 + axis];
+                aabb[axis + 3] = modelMatrix[12 + axis];
+                for (std::size_t obbAxis = 0; obbAxis < 3; obbAxis++) {
+                    float e = modelMatrix[obbAxis * 4 + axis] * obb[obbAxis];
+                    float f = modelMatrix[obbAxis * 4 + axis] * obb[obbAxis + 3];
+                    aabb[axis] += e < f ? e : f;
+                    aabb[axis + 3] += e < f ? f : e;
+                };
+            };
+        };
+    };
+
+    /// Frustum culls boxes one at a time, stopping at the first plane a box is behind.
+    std::size_t cullAabbsAos(const ae::Frustum& t_frustum, const std::vector<AabbAos>& t_aabbs,
+                             std::vector<uint8_t>& t_isVisible) {
+        t_isVisible.resize(t_aabbs.size());
+        std::size_t numVisible = 0;
+        for (std::size_t box = 0; box < t_aabbs.size(); box++) {
+            bool isVisible = true;
+            for (const ae::Plane& plane: t_frustum.m_planes) {
+                float distance = plane.m_distance;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    distance += plane.m_normal[axis] * t_aabbs[box].m_positions[plane.m_normal[axis] >= 0.0f ? axis + 3 : axis];
+                };
+                if (distance < 0.0f) {
+                    isVisible = false;
+                    break;
+                };
+            };
+            t_isVisible[box] = isVisible ? 1 : 0;
+            numVisible += t_isVisible[box];
+        };
+        return numVisible;
+    };
+
+    /// Frustum culls spheres one at a time, stopping at the first plane a sphere is behind.
+    std::size_t cullSpheresAos(const ae::Frustum& t_frustum, const std::vector<SphereAos>& t_spheres,
+                               std::vector<uint8_t>& t_isVisible) {
+        t_isVisible.resize(t_spheres.size());
+        std::size_t numVisible = 0;
+        for (std::size_t sphere = 0; sphere < t_spheres.size(); sphere++) {
+            bool isVisible = true;
+            for (const ae::Plane& plane: t_frustum.m_planes) {
+                float distance = plane.m_distance;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    distance += plane.m_normal[axis] * t_spheres[sphere].m_center[axis];
+                };
+                if (distance + t_spheres[sphere].m_radius < 0.0f) {
+                    isVisible = false;
+                    break;
+                };
+            };
+            t_isVisible[sphere] = isVisible ? 1 : 0;
+            numVisible += t_isVisible[sphere];
+        };
+        return numVisible;
+    };
+
+    /// Casts a ray against boxes one at a time.
+    std::size_t raycastAabbsAos(const ae::Ray& t_ray, float t_maxDistance, const std::vector<AabbAos>& t_aabbs) {
+        std::size_t closestHit = ae::NO_HIT;
+        float closestDistance = std::numeric_limits<float>::infinity();
+        for (std::size_t box = 0; box < t_aabbs.size(); box++) {
+            float entry = 0.0f;
+            float exit = t_maxDistance;
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float inverse = 1.0f / t_ray.m_direction[axis];
+                float minDistance = (t_aabbs[box].m_positions[axis] - t_ray.m_origin[axis]) * inverse;
+                float maxDistance = (t_aabbs[box].m_positions[axis + 3] - t_ray.m_origin[axis]) * inverse;
+                entry = std::max(entry, std::min(minDistance, maxDistance));
+                exit = std::min(exit, std::max(minDistance, maxDistance));
+            };
+            if (entry <= exit && entry < closestDistance) {
+                closestDistance = entry;
+                closestHit = box;
+            };
+        };
+        return closestHit;
+    };
+
+    /// Finds the boxes within a sphere one at a time.
+    std::size_t overlapSphereAabbsAos(const std::array<float, 3>& t_center, float t_radius,
+                                      const std::vector<AabbAos>& t_aabbs, std::vector<uint8_t>& t_isOverlapping) {
+        t_isOverlapping.resize(t_aabbs.size());
+        std::size_t numOverlapping = 0;
+        for (std::size_t box = 0; box < t_aabbs.size(); box++) {
+            float squaredDistance = 0.0f;
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float closest = std::min(std::max(t_center[axis], t_aabbs[box].m_positions[axis]),
+                                         t_aabbs[box].m_positions[axis + 3]);
+                squaredDistance += (t_center[axis] - closest) * (t_center[axis] - closest);
+            };
+            t_isOverlapping[box] = squaredDistance <= t_radius * t_radius ? 1 : 0;
+            numOverlapping += t_isOverlapping[box];
+        };
+        return numOverlapping;
+    };
+
+    /// Times every operation in both layouts for one number of entities.
+    void runCase(std::size_t t_numEntities, const BenchmarkOptions& t_options, std::vector<GeometryResult>& t_results) {
+        Scene scene = makeScene(t_numEntities);
+
+        // A camera at the origin looking down -z, 90 degrees wide, from 0.1 to 300.
+        const float near = 0.1f;
+        const float far = 300.0f;
+        const float projection[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+                                      0.0f, 1.0f, 0.0f, 0.0f,
+                                      0.0f, 0.0f, far / (near - far), -1.0f,
+                                      0.0f, 0.0f, -(far * near) / (far - near), 0.0f};
+        const ae::Frustum frustum = ae::Frustum::fromViewProjection(projection);
+        const ae::Ray ray{{0.0f, 0.0f, 0.0f}, {0.3f, -0.2f, -1.0f}};
+        const std::array<float, 3> sphereCenter{10.0f, 0.0f, -20.0f};
+        const float sphereRadius = 50.0f;
+
+        std::vector<AabbAos> worldAabbsAos;
+        ae::AabbSoa worldAabbsSoa{};
+        std::vector<uint8_t> isSelected;
+        std::vector<float> hitDistances;
+
+        struct Operation {
+            const char* m_layoutName;
+            const char* m_operationName;
+            std::function<void()> m_task;
+        };
+        const std::vector<Operation> operations{
+                {"per entity", "obb to aabb", [&]() { transformObbsAos(scene, worldAabbsAos); g_sink = worldAabbsAos.back().m_positions[0]; }},
+                {"soa batch", "obb to aabb", [&]() { ae::transformObbsToAabbs(scene.m_transforms, scene.m_obbIndices, scene.m_modelObbsSoa, worldAabbsSoa); g_sink = worldAabbsSoa.m_min[0].back(); }},
+                {"per entity", "frustum aabbs", [&]() { g_sink = static_cast<float>(cullAabbsAos(frustum, scene.m_aabbs, isSelected)); }},
+                {"soa batch", "frustum aabbs", [&]() { g_sink = static_cast<float>(ae::cullAabbs(frustum, scene.m_aabbsSoa, isSelected)); }},
+                {"per entity", "frustum spheres", [&]() { g_sink = static_cast<float>(cullSpheresAos(frustum, scene.m_spheres, isSelected)); }},
+                {"soa batch", "frustum spheres", [&]() { g_sink = static_cast<float>(ae::cullSpheres(frustum, scene.m_spheresSoa, isSelected)); }},
+                {"per entity", "raycast", [&]() { g_sink = static_cast<float>(raycastAabbsAos(ray, 1000.0f, scene.m_aabbs)); }},
+                {"soa batch", "raycast", [&]() { g_sink = static_cast<float>(ae::raycastAabbs(ray, 1000.0f, scene.m_aabbsSoa, hitDistances)); }},
+                {"per entity", "sphere overlap", [&]() { g_sink = static_cast<float>(overlapSphereAabbsAos(sphereCenter, sphereRadius, scene.m_aabbs, isSelected)); }},
+                {"soa batch", "sphere overlap", [&]() { g_sink = static_cast<float>(ae::overlapSphereAabbs(sphereCenter, sphereRadius, scene.m_aabbsSoa, isSelected)); }}};
+
+        for (const Operation& operation: operations) {
+            // The first call sizes the outputs so only the calculation is timed.
+            operation.m_task();
+            std::vector<double> times;
+            for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+                times.push_back(timeNs(operation.m_task) / static_cast<double>(t_numEntities));
+            };
+            std::sort(times.begin(), times.end());
+            t_results.push_back({operation.m_layoutName, operation.m_operationName, t_numEntities, times[times.size() / 2]});
+        };
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<GeometryResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(14) << "layout" << std::setw(18) << "operation" << std::right
+                 << std::setw(10) << "entities" << std::setw(14) << "ns/entity" << "\n";
+        for (const auto& result: t_results) {
+            t_stream << std::left << std::setw(14) << result.m_layoutName << std::setw(18) << result.m_operationName
+                     << std::right << std::setw(10) << result.m_numEntities << std::fixed << std::setprecision(3)
+                     << std::setw(14) << result.m_nsPerEntity << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<GeometryResult>& t_results, const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"layout\": \"" << result.m_layoutName << "\", \"operation\": \""
+                 << result.m_operationName << "\", \"entities\": " << result.m_numEntities
+                 << ", \"ns_per_entity\": " << result.m_nsPerEntity << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+
+#if defined(AE_SIMD_AVX2)
+        std::cout << "SoA batches use AVX2.\n";
+#elif defined(AE_SIMD_SSE2)
+        std::cout << "SoA batches use SSE2.\n";
+#else
+        std::cout << "SoA batches use scalar code.\n";
+#endif
+
+        std::vector<GeometryResult> results;
+        for (std::size_t numEntities: options.m_counts) {
+            std::cerr << "Timing " << numEntities << " entities.\n";
+            runCase(numEntities, options, results);
+        };
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,444 @@
+/// \file ae_hash_map_bench.cpp
+/// Times ae::flat_hash_map against std::unordered_map, and std::map where the engine uses it, on the key types of the
+/// engine's hot lookups:
+/// - entity IDs, like the map from entities to object SSBO slots,
+/// - shared pointers to models, like the material layers' maps of the entities drawn with each model,
+/// - file paths, like the resource manager's maps of loaded models and images,
+/// - vertices, like the map that removes duplicate vertices while a model is loaded.
+/// Each map is timed inserting every key, finding every key in a random order, looking for keys it does not hold,
+/// erasing and reinserting half the keys, and iterating over every element. File paths are also found by
+/// std::string_view, which ae::flat_hash_map takes as it is while std::unordered_map needs a std::string made from it.
+/// Vertices are also timed removing the duplicates from a mesh's stream of vertices, as loading a model does.
+///
+/// Usage: ae_hash_map_bench [options]
+///   --sizes <n,n,...>    The numbers of keys, 1000,100000,1000000 by default.
+///   --repetitions <n>    The number of times each case is timed, the median is reported, 5 by default.
+///   --case <text>        Only runs the cases whose name contains the text, ecs_id, model, path or vertex.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "flat_hash_map.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_sizes{1000, 100000, 1000000};
+        std::size_t m_numRepetitions = 5;
+        std::string m_caseFilter;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one map took for each operation on one of its keys.
+    struct LookupResult {
+        std::string m_caseName;
+        std::string m_subjectName;
+        std::string m_operationName;
+        std::size_t m_numKeys = 0;
+        double m_nsPerOperation = 0.0;
+    };
+
+    /// Stands in for Ae3DModel, only its address is hashed.
+    struct Model {
+        std::uint64_t m_data[4]{};
+    };
+
+    /// The same layout as Ae3DModel::Vertex.
+    struct Vertex {
+        float m_position[3];
+        float m_color[3];
+        float m_normal[3];
+        float m_uv[2];
+
+        bool operator==(const Vertex& t_other) const {
+            return std::equal(std::begin(m_position), std::end(m_uv), std::begin(t_other.m_position));
+        };
+    };
+
+    /// Hashes a vertex the way the engine hashes Ae3DModel::Vertex, combining the hash of each float.
+    struct VertexHash {
+        std::size_t operator()(const Vertex& t_vertex) const {
+            std::size_t seed = 0;
+            for (const float* value = std::begin(t_vertex.m_position); value != std::end(t_vertex.m_uv); value++) {
+                seed ^= std::hash<float>{}(*value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            };
+            return seed;
+        };
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_hash_map_bench [options]\n"
+                     "  --sizes <n,n,...>    Numbers of keys (default 1000,100000,1000000)\n"
+                     "  --repetitions <n>    Timings of each case, the median is reported (default 5)\n"
+                     "  --case <text>        Only run cases whose name contains the text (ecs_id, model, path, "
+                     "vertex)\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--sizes") {
+                options.m_sizes.clear();
+                std::stringstream sizes{value};
+                std::string size;
+                while (std::getline(sizes, size, ',')) {
+                    options.m_sizes.push_back(std::max<std::size_t>(std::stoull(size), 2));
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--case") {
+                options.m_caseFilter = value;
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Keeps a value from being optimised away.
+    volatile std::size_t g_sink = 0;
+
+    /// Times a task.
+    /// \return The time the task took in nanoseconds.
+    template<typename TTask>
+    double timeNs(TTask&& t_task) {
+        auto start = std::chrono::steady_clock::now();
+        t_task();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    };
+
+    /// Times every operation of one map on a set of keys.
+    /// \tparam TMap The type of map, mapping the keys to their index.
+    /// \param t_keys The keys the map holds.
+    /// \param t_missingKeys Keys the map does not hold.
+    /// \param t_lookupOrder A random order of the indices of the keys.
+    template<typename TMap, typename TKey>
+    void runSubject(const std::string& t_caseName,
+                    const std::string& t_subjectName,
+                    const std::vector<TKey>& t_keys,
+                    const std::vector<TKey>& t_missingKeys,
+                    const std::vector<std::size_t>& t_lookupOrder,
+                    const BenchmarkOptions& t_options,
+                    std::vector<LookupResult>& t_results) {
+        std::map<std::string, std::vector<double>> operationTimes;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            TMap map{};
+            operationTimes["insert"].push_back(timeNs([&]() {
+                for (std::size_t index = 0; index < t_keys.size(); index++) {
+                    map.emplace(t_keys[index], index);
+                };
+            }));
+            if (map.size() != t_keys.size()) {
+                throw std::runtime_error(t_subjectName + " lost keys of the " + t_caseName + " case!");
+            };
+
+            operationTimes["find hit"].push_back(timeNs([&]() {
+                std::size_t sum = 0;
+                for (std::size_t index: t_lookupOrder) {
+                    sum += map.find(t_keys[index])->second;
+                };
+                g_sink = sum;
+            }));
+
+            operationTimes["find miss"].push_back(timeNs([&]() {
+                std::size_t numFound = 0;
+                for (const auto& key: t_missingKeys) {
+                    numFound += map.find(key) != map.end();
+                };
+                g_sink = numFound;
+            }));
+
+            // Erases then reinserts every other key, both timed together, in a random order.
+            double eraseNs = timeNs([&]() {
+                for (std::size_t i = 0; i < t_lookupOrder.size(); i += 2) {
+                    map.erase(t_keys[t_lookupOrder[i]]);
+                };
+                for (std::size_t i = 0; i < t_lookupOrder.size(); i += 2) {
+                    map.emplace(t_keys[t_lookupOrder[i]], t_lookupOrder[i]);
+                };
+            });
+            operationTimes["erase + reinsert"].push_back(eraseNs / 2.0);
+
+            operationTimes["iterate"].push_back(timeNs([&]() {
+                std::size_t sum = 0;
+                for (const auto& element: map) {
+                    sum += element.second;
+                };
+                g_sink = sum;
+            }));
+        };
+
+        for (auto& [operationName, times]: operationTimes) {
+            std::sort(times.begin(), times.end());
+            t_results.push_back({t_caseName, t_subjectName, operationName, t_keys.size(),
+                                 times[times.size() / 2] / static_cast<double>(t_keys.size())});
+        };
+    };
+
+    /// Gets a random order of the indices of a number of keys.
+    std::vector<std::size_t> makeLookupOrder(std::size_t t_numKeys, std::mt19937_64& t_random) {
+        std::vector<std::size_t> order(t_numKeys);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            order[index] = index;
+        };
+        std::shuffle(order.begin(), order.end(), t_random);
+        return order;
+    };
+
+    /// Entity IDs are handed out from the lowest free ID, so the IDs in use are mostly a dense range.
+    void runEcsIdCase(std::size_t t_numKeys, const BenchmarkOptions& t_options, std::vector<LookupResult>& t_results) {
+        std::mt19937_64 random{1};
+        std::vector<std::size_t> keys(t_numKeys);
+        std::vector<std::size_t> missingKeys(t_numKeys);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            keys[index] = index;
+            missingKeys[index] = t_numKeys + index;
+        };
+        std::vector<std::size_t> order = makeLookupOrder(t_numKeys, random);
+
+        runSubject<std::map<std::size_t, std::size_t>>("ecs_id", "std::map", keys, missingKeys, order, t_options,
+                                                       t_results);
+        runSubject<std::unordered_map<std::size_t, std::size_t>>("ecs_id", "std::unordered_map", keys, missingKeys,
+                                                                 order, t_options, t_results);
+        runSubject<ae::flat_hash_map<std::size_t, std::size_t>>("ecs_id", "ae::flat_hash_map", keys, missingKeys,
+                                                                order, t_options, t_results);
+    };
+
+    /// Models are keyed by their shared pointer, which hashes the address of the model.
+    void runModelCase(std::size_t t_numKeys, const BenchmarkOptions& t_options, std::vector<LookupResult>& t_results) {
+        std::mt19937_64 random{2};
+        std::vector<std::shared_ptr<Model>> keys(t_numKeys);
+        std::vector<std::shared_ptr<Model>> missingKeys(t_numKeys);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            keys[index] = std::make_shared<Model>();
+            missingKeys[index] = std::make_shared<Model>();
+        };
+        std::vector<std::size_t> order = makeLookupOrder(t_numKeys, random);
+
+        using Key = std::shared_ptr<Model>;
+        runSubject<std::map<Key, std::size_t>>("model", "std::map", keys, missingKeys, order, t_options, t_results);
+        runSubject<std::unordered_map<Key, std::size_t>>("model", "std::unordered_map", keys, missingKeys, order,
+                                                         t_options, t_results);
+        runSubject<ae::flat_hash_map<Key, std::size_t>>("model", "ae::flat_hash_map", keys, missingKeys, order,
+                                                        t_options, t_results);
+    };
+
+    /// Assets are keyed by the path they were loaded from. Besides the usual operations, the paths are found by
+    /// std::string_view.
+    void runPathCase(std::size_t t_numKeys, const BenchmarkOptions& t_options, std::vector<LookupResult>& t_results) {
+        std::mt19937_64 random{3};
+        std::vector<std::string> keys(t_numKeys);
+        std::vector<std::string> missingKeys(t_numKeys);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            keys[index] = "assets/models/environment/model_" + std::to_string(index) + ".obj";
+            missingKeys[index] = "assets/models/environment/missing_" + std::to_string(index) + ".obj";
+        };
+        std::vector<std::size_t> order = makeLookupOrder(t_numKeys, random);
+
+        using FlatMap = ae::flat_hash_map<std::string, std::size_t, ae::string_hash, std::equal_to<>>;
+        runSubject<std::unordered_map<std::string, std::size_t>>("path", "std::unordered_map", keys, missingKeys,
+                                                                 order, t_options, t_results);
+        runSubject<FlatMap>("path", "ae::flat_hash_map", keys, missingKeys, order, t_options, t_results);
+
+        std::vector<std::string_view> views(keys.begin(), keys.end());
+        std::unordered_map<std::string, std::size_t> unorderedMap;
+        FlatMap flatMap;
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            unorderedMap.emplace(keys[index], index);
+            flatMap.emplace(keys[index], index);
+        };
+        std::vector<double> unorderedTimes;
+        std::vector<double> flatTimes;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            unorderedTimes.push_back(timeNs([&]() {
+                std::size_t sum = 0;
+                for (std::size_t index: order) {
+                    sum += unorderedMap.find(std::string{views[index]})->second;
+                };
+                g_sink = sum;
+            }));
+            flatTimes.push_back(timeNs([&]() {
+                std::size_t sum = 0;
+                for (std::size_t index: order) {
+                    sum += flatMap.find(views[index])->second;
+                };
+                g_sink = sum;
+            }));
+        };
+        std::sort(unorderedTimes.begin(), unorderedTimes.end());
+        std::sort(flatTimes.begin(), flatTimes.end());
+        auto numKeys = static_cast<double>(t_numKeys);
+        t_results.push_back({"path", "std::unordered_map", "find string_view", t_numKeys,
+                             unorderedTimes[unorderedTimes.size() / 2] / numKeys});
+        t_results.push_back({"path", "ae::flat_hash_map", "find string_view", t_numKeys,
+                             flatTimes[flatTimes.size() / 2] / numKeys});
+    };
+
+    /// Removes the duplicates from a stream of vertices the way loading a model does, each vertex of a mesh is shared
+    /// by about 6 triangles.
+    template<typename TMap>
+    void runVertexDeduplication(const std::string& t_subjectName,
+                                const std::vector<Vertex>& t_vertexStream,
+                                std::size_t t_numUniqueVertices,
+                                const BenchmarkOptions& t_options,
+                                std::vector<LookupResult>& t_results) {
+        std::vector<double> times;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            std::vector<std::uint32_t> indices;
+            indices.reserve(t_vertexStream.size());
+            times.push_back(timeNs([&]() {
+                TMap uniqueVertices{};
+                for (const Vertex& vertex: t_vertexStream) {
+                    auto element = uniqueVertices.emplace(vertex, static_cast<std::uint32_t>(uniqueVertices.size()));
+                    indices.push_back(static_cast<std::uint32_t>(element.first->second));
+                };
+                if (uniqueVertices.size() != t_numUniqueVertices) {
+                    throw std::runtime_error(t_subjectName + " lost vertices while removing duplicates!");
+                };
+            }));
+        };
+        std::sort(times.begin(), times.end());
+        t_results.push_back({"vertex", t_subjectName, "deduplicate", t_numUniqueVertices,
+                             times[times.size() / 2] / static_cast<double>(t_vertexStream.size())});
+    };
+
+    /// Vertices of a grid mesh, keyed by every one of their floats.
+    void runVertexCase(std::size_t t_numKeys, const BenchmarkOptions& t_options, std::vector<LookupResult>& t_results) {
+        std::mt19937_64 random{4};
+        auto makeVertex = [](std::size_t t_index, float t_offset) {
+            auto x = static_cast<float>(t_index % 1024);
+            auto z = static_cast<float>(t_index / 1024) + t_offset;
+            return Vertex{{x, 0.0f, z}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {x / 1024.0f, z / 1024.0f}};
+        };
+        std::vector<Vertex> keys(t_numKeys);
+        std::vector<Vertex> missingKeys(t_numKeys);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            keys[index] = makeVertex(index, 0.0f);
+            missingKeys[index] = makeVertex(index, 0.5f);
+        };
+        std::vector<std::size_t> order = makeLookupOrder(t_numKeys, random);
+
+        runSubject<std::unordered_map<Vertex, std::size_t, VertexHash>>("vertex", "std::unordered_map", keys,
+                                                                        missingKeys, order, t_options, t_results);
+        runSubject<ae::flat_hash_map<Vertex, std::size_t, VertexHash>>("vertex", "ae::flat_hash_map", keys,
+                                                                       missingKeys, order, t_options, t_results);
+
+        // Each vertex appears in the stream once for each of about 6 triangles sharing it, triangles near each other
+        // in the stream sharing vertices.
+        std::vector<Vertex> vertexStream;
+        vertexStream.reserve(t_numKeys * 6);
+        for (std::size_t index = 0; index < t_numKeys; index++) {
+            for (std::size_t corner = 0; corner < 6; corner++) {
+                std::size_t neighbour = std::min(index + corner % 3, t_numKeys - 1);
+                vertexStream.push_back(keys[corner < 3 ? index : neighbour]);
+            };
+        };
+        runVertexDeduplication<std::unordered_map<Vertex, std::uint32_t, VertexHash>>(
+                "std::unordered_map", vertexStream, t_numKeys, t_options, t_results);
+        runVertexDeduplication<ae::flat_hash_map<Vertex, std::uint32_t, VertexHash>>(
+                "ae::flat_hash_map", vertexStream, t_numKeys, t_options, t_results);
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<LookupResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(10) << "case" << std::setw(22) << "map" << std::setw(20) << "operation"
+                 << std::right << std::setw(10) << "keys" << std::setw(12) << "ns / op" << "\n";
+        for (const auto& result: t_results) {
+            t_stream << std::left << std::setw(10) << result.m_caseName << std::setw(22) << result.m_subjectName
+                     << std::setw(20) << result.m_operationName << std::right << std::setw(10) << result.m_numKeys
+                     << std::fixed << std::setprecision(2) << std::setw(12) << result.m_nsPerOperation << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<LookupResult>& t_results, const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"case\": \"" << result.m_caseName << "\", \"map\": \""
+                 << result.m_subjectName << "\", \"operation\": \"" << result.m_operationName << "\", \"keys\": "
+                 << result.m_numKeys << ", \"ns_per_operation\": " << result.m_nsPerOperation << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+
+        using CaseFunction = void (*)(std::size_t, const BenchmarkOptions&, std::vector<LookupResult>&);
+        const std::pair<const char*, CaseFunction> cases[] = {{"ecs_id", runEcsIdCase},
+                                                              {"model", runModelCase},
+                                                              {"path", runPathCase},
+                                                              {"vertex", runVertexCase}};
+
+        std::vector<LookupResult> results;
+        for (const auto& [caseName, runCase]: cases) {
+            if (std::string{caseName}.find(options.m_caseFilter) == std::string::npos) {
+                continue;
+            };
+            for (std::size_t numKeys: options.m_sizes) {
+                std::cerr << "Timing the " << caseName << " case with " << numKeys << " keys.\n";
+                runCase(numKeys, options, results);
+            };
+        };
+
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
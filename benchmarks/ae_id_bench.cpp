@@ -0,0 +1,287 @@
+/// \file ae_id_bench.cpp
+/// Times how well entity ID allocation holds up when many threads allocate and free IDs at once, from 1 to 32
+/// threads. The lock free ae::ConcurrentIdAllocator is compared against a ae::HierarchicalBitset behind a global
+/// mutex, which is how a single threaded ID allocator would have to be shared. Each thread repeatedly allocates a
+/// batch of IDs and frees them again, and every ID handed out is checked to not already be in use.
+///
+/// Usage: ae_id_bench [options]
+///   --threads <n,n,...>  The numbers of threads, 1,2,4,8,16,32 by default.
+///   --ids <n>            The number of IDs, 16000 by default like the engine's maximum number of entities.
+///   --operations <n>     The number of allocations each thread makes, 1000000 by default.
+///   --batch <n>          The number of IDs each thread holds before freeing them, 64 by default.
+///   --repetitions <n>    The number of times each case is timed, the median is reported, 5 by default.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "concurrent_id_allocator.hpp"
+#include "hierarchical_bitset.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_threadCounts{1, 2, 4, 8, 16, 32};
+        std::size_t m_numIds = 16000;
+        std::size_t m_numOperations = 1000000;
+        std::size_t m_batchSize = 64;
+        std::size_t m_numRepetitions = 5;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one subject took with a number of threads.
+    struct ContentionResult {
+        std::string m_subjectName;
+        std::size_t m_numThreads = 1;
+        double m_medianNs = 0.0;
+        double m_allocationsPerSecond = 0.0;
+    };
+
+    /// The engine's hierarchical bitset shared between threads by a global lock.
+    class LockedBitsetIds {
+    public:
+
+        explicit LockedBitsetIds(std::size_t t_numIds) : m_bitset{t_numIds} {};
+
+        std::size_t allocate() {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            std::size_t id = m_bitset.findFirstZero();
+            if (id != m_bitset.npos) {
+                m_bitset.set(id);
+            };
+            return id;
+        };
+
+        void free(std::size_t t_id) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_bitset.reset(t_id);
+        };
+
+    private:
+
+        std::mutex m_mutex;
+
+        ae::HierarchicalBitset m_bitset;
+
+    protected:
+
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_id_bench [options]\n"
+                     "  --threads <n,n,...>  Numbers of threads (default 1,2,4,8,16,32)\n"
+                     "  --ids <n>            Number of IDs (default 16000)\n"
+                     "  --operations <n>     Allocations made by each thread (default 1000000)\n"
+                     "  --batch <n>          IDs each thread holds before freeing them (default 64)\n"
+                     "  --repetitions <n>    Timings of each case, the median is reported (default 5)\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--threads") {
+                options.m_threadCounts.clear();
+                std::stringstream threadCounts{value};
+                std::string threadCount;
+                while (std::getline(threadCounts, threadCount, ',')) {
+                    options.m_threadCounts.push_back(std::max<std::size_t>(std::stoull(threadCount), 1));
+                };
+            } else if (option == "--ids") {
+                options.m_numIds = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--operations") {
+                options.m_numOperations = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--batch") {
+                options.m_batchSize = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+
+        // Every thread has to be able to hold a full batch at once.
+        std::size_t maxThreads = *std::max_element(options.m_threadCounts.begin(), options.m_threadCounts.end());
+        if (maxThreads * options.m_batchSize > options.m_numIds) {
+            throw std::runtime_error("There are not enough IDs for every thread to hold a batch, raise --ids or lower "
+                                     "--batch!");
+        };
+        return options;
+    };
+
+    /// Runs the threads of one timing, all of them start together once they have been created.
+    /// \tparam TIds The type of ID allocator.
+    /// \return The time from the threads starting to the last one finishing.
+    template<typename TIds>
+    double timeContention(TIds& t_ids, std::size_t t_numThreads, const BenchmarkOptions& t_options) {
+        // A flag per ID catches an ID being handed to two threads at once.
+        std::unique_ptr<std::atomic<bool>[]> idsInUse = std::make_unique<std::atomic<bool>[]>(t_options.m_numIds);
+        for (std::size_t id = 0; id < t_options.m_numIds; id++) {
+            idsInUse[id].store(false, std::memory_order_relaxed);
+        };
+
+        std::atomic<std::size_t> numReady{0};
+        std::atomic<bool> isStarted{false};
+        std::atomic<bool> isFailed{false};
+        std::vector<std::thread> threads;
+        for (std::size_t threadIndex = 0; threadIndex < t_numThreads; threadIndex++) {
+            threads.emplace_back([&]() {
+                std::vector<std::size_t> batch;
+                batch.reserve(t_options.m_batchSize);
+                numReady.fetch_add(1);
+                while (!isStarted.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                };
+
+                for (std::size_t numAllocated = 0; numAllocated < t_options.m_numOperations;) {
+                    while (batch.size() < t_options.m_batchSize && numAllocated < t_options.m_numOperations) {
+                        std::size_t id = t_ids.allocate();
+                        if (id >= t_options.m_numIds || idsInUse[id].exchange(true, std::memory_order_relaxed)) {
+                            isFailed.store(true);
+                            return;
+                        };
+                        batch.push_back(id);
+                        numAllocated++;
+                    };
+                    for (std::size_t id: batch) {
+                        idsInUse[id].store(false, std::memory_order_relaxed);
+                        t_ids.free(id);
+                    };
+                    batch.clear();
+                };
+            });
+        };
+
+        while (numReady.load() < t_numThreads) {
+            std::this_thread::yield();
+        };
+        auto start = std::chrono::steady_clock::now();
+        isStarted.store(true, std::memory_order_release);
+        for (auto& thread: threads) {
+            thread.join();
+        };
+        auto end = std::chrono::steady_clock::now();
+
+        if (isFailed.load()) {
+            throw std::runtime_error("An ID was handed out twice or not at all with " + std::to_string(t_numThreads)
+                                     + " threads!");
+        };
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    };
+
+    /// Times one subject with a number of threads and records the median.
+    /// \tparam TIds The type of ID allocator, created afresh for every timing.
+    template<typename TIds>
+    void runCase(const std::string& t_subjectName,
+                 std::size_t t_numThreads,
+                 const BenchmarkOptions& t_options,
+                 std::vector<ContentionResult>& t_results) {
+        std::vector<double> times;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            TIds ids{t_options.m_numIds};
+            times.push_back(timeContention(ids, t_numThreads, t_options));
+        };
+        std::sort(times.begin(), times.end());
+
+        ContentionResult result{};
+        result.m_subjectName = t_subjectName;
+        result.m_numThreads = t_numThreads;
+        result.m_medianNs = times[times.size() / 2];
+        result.m_allocationsPerSecond = static_cast<double>(t_numThreads * t_options.m_numOperations)
+                                        / (result.m_medianNs * 1.0e-9);
+        t_results.push_back(result);
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<ContentionResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(16) << "subject" << std::right << std::setw(10) << "threads"
+                 << std::setw(14) << "median ms" << std::setw(18) << "M allocs / s" << std::setw(16) << "ns / alloc"
+                 << "\n";
+        for (const auto& result: t_results) {
+            double numAllocations = result.m_allocationsPerSecond * result.m_medianNs * 1.0e-9;
+            t_stream << std::left << std::setw(16) << result.m_subjectName << std::right << std::setw(10)
+                     << result.m_numThreads << std::fixed << std::setprecision(2) << std::setw(14)
+                     << result.m_medianNs * 1.0e-6 << std::setw(18) << result.m_allocationsPerSecond * 1.0e-6
+                     << std::setw(16) << result.m_medianNs / numAllocations << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<ContentionResult>& t_results,
+                   const BenchmarkOptions& t_options,
+                   const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"ids\": " << t_options.m_numIds << ",\n  \"operations\": " << t_options.m_numOperations
+             << ",\n  \"batch\": " << t_options.m_batchSize << ",\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"subject\": \"" << result.m_subjectName
+                 << "\", \"threads\": " << result.m_numThreads << ", \"median_ns\": " << result.m_medianNs
+                 << ", \"allocations_per_second\": " << result.m_allocationsPerSecond << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+
+        std::vector<ContentionResult> results;
+        for (std::size_t numThreads: options.m_threadCounts) {
+            std::cerr << "Allocating IDs on " << numThreads << " threads.\n";
+            runCase<LockedBitsetIds>("mutex + bitset", numThreads, options, results);
+            runCase<ae::ConcurrentIdAllocator>("lock free", numThreads, options, results);
+        };
+
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
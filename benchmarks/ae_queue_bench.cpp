@@ -0,0 +1,422 @@
+/// \file ae_queue_bench.cpp
+/// Times the throughput of the engine's lock free ring buffer, queue and work stealing deque against the same
+/// containers behind a mutex. The ring buffer passes items from one producer to one consumer, the queue from a number
+/// of producers to as many consumers, and the deque's owner pushes and pops items while a number of thieves steal
+/// them. Every item is checked to arrive exactly once by summing them.
+///
+/// Usage: ae_queue_bench [options]
+///   --items <n>          The number of items passed through each container, 2000000 by default.
+///   --capacity <n>       The capacity of the ring buffers and queues, 1024 by default.
+///   --threads <n,n,...>  The numbers of producers and consumers, and of thieves, 1,2,4,8 by default.
+///   --repetitions <n>    The number of times each case is timed, the median is reported, 5 by default.
+///   --case <text>        Only runs the cases whose name contains the text, spsc, mpmc or deque.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "spsc_ring_buffer.hpp"
+#include "mpmc_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::uint64_t m_numItems = 2000000;
+        std::size_t m_capacity = 1024;
+        std::vector<std::size_t> m_threadCounts{1, 2, 4, 8};
+        std::size_t m_numRepetitions = 5;
+        std::string m_caseFilter;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one subject took to pass the items through.
+    struct ThroughputResult {
+        std::string m_caseName;
+        std::string m_subjectName;
+        std::size_t m_numThreads = 0;
+        double m_medianNs = 0.0;
+        double m_itemsPerSecond = 0.0;
+    };
+
+    /// A bounded queue behind a mutex, the baseline of the ring buffer and queue.
+    class LockedQueue {
+    public:
+
+        explicit LockedQueue(std::size_t t_capacity) : m_capacity{t_capacity} {};
+
+        bool tryPush(std::uint64_t t_value) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_items.size() == m_capacity) {
+                return false;
+            };
+            m_items.push_back(t_value);
+            return true;
+        };
+
+        bool tryPop(std::uint64_t& t_value) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_items.empty()) {
+                return false;
+            };
+            t_value = m_items.front();
+            m_items.pop_front();
+            return true;
+        };
+
+    private:
+
+        std::size_t m_capacity;
+
+        std::mutex m_mutex;
+
+        std::deque<std::uint64_t> m_items;
+
+    protected:
+
+    };
+
+    /// A deque behind a mutex, the baseline of the work stealing deque.
+    class LockedDeque {
+    public:
+
+        explicit LockedDeque(std::size_t) {};
+
+        void push(std::uint64_t t_value) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_items.push_back(t_value);
+        };
+
+        bool pop(std::uint64_t& t_value) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_items.empty()) {
+                return false;
+            };
+            t_value = m_items.back();
+            m_items.pop_back();
+            return true;
+        };
+
+        bool steal(std::uint64_t& t_value) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if (m_items.empty()) {
+                return false;
+            };
+            t_value = m_items.front();
+            m_items.pop_front();
+            return true;
+        };
+
+    private:
+
+        std::mutex m_mutex;
+
+        std::deque<std::uint64_t> m_items;
+
+    protected:
+
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_queue_bench [options]\n"
+                     "  --items <n>          Items passed through each container (default 2000000)\n"
+                     "  --capacity <n>       Capacity of the ring buffers and queues (default 1024)\n"
+                     "  --threads <n,n,...>  Numbers of producers and consumers, and of thieves (default 1,2,4,8)\n"
+                     "  --repetitions <n>    Timings of each case, the median is reported (default 5)\n"
+                     "  --case <text>        Only run cases whose name contains the text, spsc, mpmc or deque\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--items") {
+                options.m_numItems = std::max<std::uint64_t>(std::stoull(value), 1);
+            } else if (option == "--capacity") {
+                options.m_capacity = std::max<std::size_t>(std::stoull(value), 2);
+            } else if (option == "--threads") {
+                options.m_threadCounts.clear();
+                std::stringstream threadCounts{value};
+                std::string threadCount;
+                while (std::getline(threadCounts, threadCount, ',')) {
+                    options.m_threadCounts.push_back(std::max<std::size_t>(std::stoull(threadCount), 1));
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--case") {
+                options.m_caseFilter = value;
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                printUsage();
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Starts a group of threads together and times them until the last one finishes.
+    /// \param t_threadFunctions The work of each thread.
+    /// \return The time from the threads starting to the last one finishing.
+    double timeThreads(const std::vector<std::function<void()>>& t_threadFunctions) {
+        std::atomic<std::size_t> numReady{0};
+        std::atomic<bool> isStarted{false};
+        std::vector<std::thread> threads;
+        for (const auto& threadFunction: t_threadFunctions) {
+            threads.emplace_back([&]() {
+                numReady.fetch_add(1);
+                while (!isStarted.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                };
+                threadFunction();
+            });
+        };
+
+        while (numReady.load() < t_threadFunctions.size()) {
+            std::this_thread::yield();
+        };
+        auto start = std::chrono::steady_clock::now();
+        isStarted.store(true, std::memory_order_release);
+        for (auto& thread: threads) {
+            thread.join();
+        };
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    };
+
+    /// Passes the items 1 to the number of items from producers to consumers through a queue.
+    /// \tparam TQueue The type of queue, with tryPush and tryPop.
+    template<typename TQueue>
+    double timeQueue(std::size_t t_numProducers, std::size_t t_numConsumers, const BenchmarkOptions& t_options) {
+        TQueue queue{t_options.m_capacity};
+        std::atomic<std::uint64_t> numPopped{0};
+        std::atomic<std::uint64_t> sum{0};
+
+        std::vector<std::function<void()>> threadFunctions;
+        for (std::size_t producer = 0; producer < t_numProducers; producer++) {
+            threadFunctions.emplace_back([&, producer]() {
+                for (std::uint64_t item = producer + 1; item <= t_options.m_numItems; item += t_numProducers) {
+                    while (!queue.tryPush(item)) {
+                        std::this_thread::yield();
+                    };
+                };
+            });
+        };
+        for (std::size_t consumer = 0; consumer < t_numConsumers; consumer++) {
+            threadFunctions.emplace_back([&]() {
+                std::uint64_t localSum = 0;
+                std::uint64_t item = 0;
+                while (numPopped.load(std::memory_order_relaxed) < t_options.m_numItems) {
+                    if (queue.tryPop(item)) {
+                        localSum += item;
+                        numPopped.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    };
+                };
+                sum.fetch_add(localSum);
+            });
+        };
+
+        double time = timeThreads(threadFunctions);
+        if (sum.load() != t_options.m_numItems * (t_options.m_numItems + 1) / 2) {
+            throw std::runtime_error("Items were lost or duplicated by a queue!");
+        };
+        return time;
+    };
+
+    /// Pushes the items 1 to the number of items onto a deque, its owner pops every other batch back off while
+    /// thieves steal the rest.
+    /// \tparam TDeque The type of deque, with push, pop and steal.
+    template<typename TDeque>
+    double timeDeque(std::size_t t_numThieves, const BenchmarkOptions& t_options) {
+        TDeque deque{t_options.m_capacity};
+        std::atomic<std::uint64_t> numTaken{0};
+        std::atomic<std::uint64_t> sum{0};
+
+        std::vector<std::function<void()>> threadFunctions;
+        threadFunctions.emplace_back([&]() {
+            constexpr std::uint64_t batchSize = 64;
+            std::uint64_t localSum = 0;
+            std::uint64_t item = 0;
+            for (std::uint64_t first = 1; first <= t_options.m_numItems; first += batchSize) {
+                std::uint64_t last = std::min(first + batchSize - 1, t_options.m_numItems);
+                for (std::uint64_t value = first; value <= last; value++) {
+                    deque.push(value);
+                };
+                // Like a worker running the jobs it made, the owner takes some back before making more.
+                for (std::uint64_t i = 0; i < batchSize / 2 && deque.pop(item); i++) {
+                    localSum += item;
+                    numTaken.fetch_add(1, std::memory_order_relaxed);
+                };
+            };
+            while (numTaken.load(std::memory_order_relaxed) < t_options.m_numItems) {
+                if (deque.pop(item)) {
+                    localSum += item;
+                    numTaken.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                };
+            };
+            sum.fetch_add(localSum);
+        });
+        for (std::size_t thief = 0; thief < t_numThieves; thief++) {
+            threadFunctions.emplace_back([&]() {
+                std::uint64_t localSum = 0;
+                std::uint64_t item = 0;
+                while (numTaken.load(std::memory_order_relaxed) < t_options.m_numItems) {
+                    if (deque.steal(item)) {
+                        localSum += item;
+                        numTaken.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    };
+                };
+                sum.fetch_add(localSum);
+            });
+        };
+
+        double time = timeThreads(threadFunctions);
+        if (sum.load() != t_options.m_numItems * (t_options.m_numItems + 1) / 2) {
+            throw std::runtime_error("Items were lost or duplicated by a deque!");
+        };
+        return time;
+    };
+
+    /// Times a case a number of times and records the median.
+    void runCase(const std::string& t_caseName,
+                 const std::string& t_subjectName,
+                 std::size_t t_numThreads,
+                 const BenchmarkOptions& t_options,
+                 const std::function<double()>& t_timeCase,
+                 std::vector<ThroughputResult>& t_results) {
+        std::vector<double> times;
+        for (std::size_t repetition = 0; repetition < t_options.m_numRepetitions; repetition++) {
+            times.push_back(t_timeCase());
+        };
+        std::sort(times.begin(), times.end());
+
+        ThroughputResult result{};
+        result.m_caseName = t_caseName;
+        result.m_subjectName = t_subjectName;
+        result.m_numThreads = t_numThreads;
+        result.m_medianNs = times[times.size() / 2];
+        result.m_itemsPerSecond = static_cast<double>(t_options.m_numItems) / (result.m_medianNs * 1.0e-9);
+        t_results.push_back(result);
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<ThroughputResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(8) << "case" << std::setw(22) << "subject" << std::right << std::setw(10)
+                 << "threads" << std::setw(14) << "median ms" << std::setw(16) << "M items / s" << "\n";
+        for (const auto& result: t_results) {
+            t_stream << std::left << std::setw(8) << result.m_caseName << std::setw(22) << result.m_subjectName
+                     << std::right << std::setw(10) << result.m_numThreads << std::fixed << std::setprecision(2)
+                     << std::setw(14) << result.m_medianNs * 1.0e-6 << std::setw(16)
+                     << result.m_itemsPerSecond * 1.0e-6 << "\n";
+        };
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<ThroughputResult>& t_results,
+                   const BenchmarkOptions& t_options,
+                   const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Failed to open " + t_filepath + " to write the results!");
+        };
+
+        file << "{\n  \"items\": " << t_options.m_numItems << ",\n  \"capacity\": " << t_options.m_capacity
+             << ",\n  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const auto& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {\"case\": \"" << result.m_caseName << "\", \"subject\": \""
+                 << result.m_subjectName << "\", \"threads\": " << result.m_numThreads << ", \"median_ns\": "
+                 << result.m_medianNs << ", \"items_per_second\": " << result.m_itemsPerSecond << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+
+        std::vector<ThroughputResult> results;
+        auto isChosen = [&](const std::string& t_caseName) {
+            return t_caseName.find(options.m_caseFilter) != std::string::npos;
+        };
+
+        if (isChosen("spsc")) {
+            std::cerr << "Passing items from one producer to one consumer.\n";
+            runCase("spsc", "mutex + std::deque", 1, options,
+                    [&]() { return timeQueue<LockedQueue>(1, 1, options); }, results);
+            runCase("spsc", "SpscRingBuffer", 1, options,
+                    [&]() { return timeQueue<ae::SpscRingBuffer<std::uint64_t>>(1, 1, options); }, results);
+        };
+
+        for (std::size_t numThreads: options.m_threadCounts) {
+            if (isChosen("mpmc")) {
+                std::cerr << "Passing items from " << numThreads << " producers to as many consumers.\n";
+                runCase("mpmc", "mutex + std::deque", numThreads, options,
+                        [&]() { return timeQueue<LockedQueue>(numThreads, numThreads, options); }, results);
+                runCase("mpmc", "MpmcQueue", numThreads, options,
+                        [&]() { return timeQueue<ae::MpmcQueue<std::uint64_t>>(numThreads, numThreads, options); },
+                        results);
+            };
+            if (isChosen("deque")) {
+                std::cerr << "Stealing items with " << numThreads << " thieves.\n";
+                runCase("deque", "mutex + std::deque", numThreads, options,
+                        [&]() { return timeDeque<LockedDeque>(numThreads, options); }, results);
+                runCase("deque", "WorkStealingDeque", numThreads, options,
+                        [&]() { return timeDeque<ae::WorkStealingDeque<std::uint64_t>>(numThreads, options); },
+                        results);
+            };
+        };
+
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,351 @@
+/// \file ae_sort_bench.cpp
+/// Times the engine's radix sorts against std::sort on uint32, uint64 and float keys, and on keys with an index
+/// payload, from a thousand to ten million elements. Every sorted result is checked against std::sort.
+///
+/// Usage: ae_sort_bench [options]
+///   --sizes <n,n,...>    The numbers of elements sorted, 1000,10000,100000,1000000,10000000 by default.
+///   --repetitions <n>    The number of times each sort is timed, the median is reported, 5 by default.
+///   --threads <n>        The number of threads of the parallel radix sort, one per hardware thread by default.
+///   --seed <n>           The seed of the keys.
+///   --case <text>        Only sorts the cases whose name contains the text.
+///   --json <file>        Writes the results to a file as JSON.
+
+// dependencies
+#include "ae_tlsf_allocator.hpp"
+#include "radix_sort.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /// The settings of the benchmark given on the command line.
+    struct BenchmarkOptions {
+        std::vector<std::size_t> m_sizes{1000, 10000, 100000, 1000000, 10000000};
+        std::size_t m_numRepetitions = 5;
+        std::size_t m_numThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        std::uint64_t m_seed = 0x5eed;
+        std::string m_caseFilter;
+        std::string m_jsonFilepath;
+    };
+
+    /// The median time one sort of one case took.
+    struct SortResult {
+        std::string m_caseName;
+        std::string m_subjectName;
+        std::size_t m_numElements = 0;
+        std::size_t m_numThreads = 1;
+        double m_medianNs = 0.0;
+        double m_stdSortMedianNs = 0.0;
+    };
+
+    /// The scratch memory the radix sorts borrow from, like the engine's sorts would.
+    class ScratchAllocator {
+    public:
+
+        explicit ScratchAllocator(std::size_t t_size) :
+                m_memory{std::make_unique<unsigned char[]>(t_size)},
+                m_allocator{t_size, m_memory.get()} {};
+
+        ae_memory::AeAllocatorBase* get() { return &m_allocator; };
+
+    private:
+
+        std::unique_ptr<unsigned char[]> m_memory;
+
+        ae_memory::AeTlsfAllocator m_allocator;
+
+    protected:
+
+    };
+
+    /// Prints how the benchmark is used.
+    void printUsage() {
+        std::cout << "Usage: ae_sort_bench [options]\n"
+                     "  --sizes <n,n,...>    Numbers of elements sorted (default 1000 to 10000000)\n"
+                     "  --repetitions <n>    Timings of each sort, the median is reported (default 5)\n"
+                     "  --threads <n>        Threads of the parallel radix sort (default one per hardware thread)\n"
+                     "  --seed <n>           Seed of the keys\n"
+                     "  --case <text>        Only sort cases whose name contains the text\n"
+                     "  --json <file>        Write the results to a file as JSON\n";
+    };
+
+    /// Reads the command line.
+    BenchmarkOptions parseOptions(int const t_argc, char** const t_argv) {
+        BenchmarkOptions options{};
+        for (int i = 1; i < t_argc; i++) {
+            std::string option = t_argv[i];
+            if (option == "--help" || option == "-h") {
+                printUsage();
+                std::exit(EXIT_SUCCESS);
+            };
+            if (i + 1 >= t_argc) {
+                throw std::runtime_error("The option " + option + " needs a value!");
+            };
+
+            std::string value = t_argv[++i];
+            if (option == "--sizes") {
+                options.m_sizes.clear();
+                std::stringstream sizes{value};
+                std::string size;
+                while (std::getline(sizes, size, ',')) {
+                    options.m_sizes.push_back(std::stoull(size));
+                };
+            } else if (option == "--repetitions") {
+                options.m_numRepetitions = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--threads") {
+                options.m_numThreads = std::max<std::size_t>(std::stoull(value), 1);
+            } else if (option == "--seed") {
+                options.m_seed = std::stoull(value);
+            } else if (option == "--case") {
+                options.m_caseFilter = value;
+            } else if (option == "--json") {
+                options.m_jsonFilepath = value;
+            } else {
+                throw std::runtime_error("Unknown option " + option + "!");
+            };
+        };
+        return options;
+    };
+
+    /// Times a sort of a fresh copy of the input for each repetition.
+    /// \return The median time in nanoseconds.
+    template<typename TInput>
+    double timeSort(const TInput& t_input,
+                    TInput& t_output,
+                    std::size_t t_numRepetitions,
+                    const std::function<void(TInput&)>& t_sort) {
+        std::vector<double> times;
+        for (std::size_t i = 0; i < t_numRepetitions; i++) {
+            t_output = t_input;
+            auto start = std::chrono::steady_clock::now();
+            t_sort(t_output);
+            auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        };
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    };
+
+    /// Sorts keys alone with std::sort and the radix sorts.
+    template<typename TKey>
+    void runKeysCase(const std::string& t_caseName,
+                     const std::vector<TKey>& t_keys,
+                     const BenchmarkOptions& t_options,
+                     ae::AeThreadPool& t_threadPool,
+                     ae_memory::AeAllocatorBase* t_allocator,
+                     std::vector<SortResult>& t_results) {
+        std::vector<TKey> expected;
+        double stdSortNs = timeSort<std::vector<TKey>>(t_keys, expected, t_options.m_numRepetitions,
+                                                       [](std::vector<TKey>& t_sorted) {
+            std::sort(t_sorted.begin(), t_sorted.end());
+        });
+        t_results.push_back({t_caseName, "std::sort", t_keys.size(), 1, stdSortNs, stdSortNs});
+
+        // Keys are compared by value, std::sort may order -0.0 and 0.0 either way while the radix sort puts -0.0 first.
+        auto check = [&](const std::vector<TKey>& t_sorted, const std::string& t_subjectName) {
+            for (std::size_t i = 0; i < t_sorted.size(); i++) {
+                if (t_sorted[i] != expected[i]) {
+                    throw std::runtime_error(t_subjectName + " sorted the " + t_caseName + " case incorrectly!");
+                };
+            };
+        };
+
+        std::vector<TKey> sorted;
+        double radixSortNs = timeSort<std::vector<TKey>>(t_keys, sorted, t_options.m_numRepetitions,
+                                                         [&](std::vector<TKey>& t_sorted) {
+            ae::radixSort(t_sorted.data(), t_sorted.size(), t_allocator);
+        });
+        check(sorted, "ae::radixSort");
+        t_results.push_back({t_caseName, "ae::radixSort", t_keys.size(), 1, radixSortNs, stdSortNs});
+
+        double parallelRadixSortNs = timeSort<std::vector<TKey>>(t_keys, sorted, t_options.m_numRepetitions,
+                                                                 [&](std::vector<TKey>& t_sorted) {
+            ae::parallelRadixSort(t_threadPool, t_sorted.data(), t_sorted.size(), t_allocator);
+        });
+        check(sorted, "ae::parallelRadixSort");
+        t_results.push_back({t_caseName, "ae::parallelRadixSort", t_keys.size(), t_threadPool.getNumThreads(),
+                             parallelRadixSortNs, stdSortNs});
+    };
+
+    /// Sorts keys with the index of each key as its payload, the way draw keys are sorted, with std::sort of key
+    /// index pairs and the radix sorts.
+    void runKeyIndexCase(const std::string& t_caseName,
+                         const std::vector<std::uint32_t>& t_keys,
+                         const BenchmarkOptions& t_options,
+                         ae::AeThreadPool& t_threadPool,
+                         ae_memory::AeAllocatorBase* t_allocator,
+                         std::vector<SortResult>& t_results) {
+        using KeyIndexPairs = std::vector<std::pair<std::uint32_t, std::uint32_t>>;
+        KeyIndexPairs pairs(t_keys.size());
+        for (std::size_t i = 0; i < t_keys.size(); i++) {
+            pairs[i] = {t_keys[i], static_cast<std::uint32_t>(i)};
+        };
+
+        // Sorting the pairs by key and index gives the same order as a stable sort by key.
+        KeyIndexPairs expected;
+        double stdSortNs = timeSort<KeyIndexPairs>(pairs, expected, t_options.m_numRepetitions,
+                                                   [](KeyIndexPairs& t_sorted) {
+            std::sort(t_sorted.begin(), t_sorted.end());
+        });
+        t_results.push_back({t_caseName, "std::sort", t_keys.size(), 1, stdSortNs, stdSortNs});
+
+        // The radix sorts take the keys and indices as separate arrays.
+        struct KeysAndIndices {
+            std::vector<std::uint32_t> m_keys;
+            std::vector<std::uint32_t> m_indices;
+        };
+        KeysAndIndices input{t_keys, std::vector<std::uint32_t>(t_keys.size())};
+        std::iota(input.m_indices.begin(), input.m_indices.end(), 0);
+
+        auto check = [&](const KeysAndIndices& t_sorted, const std::string& t_subjectName) {
+            for (std::size_t i = 0; i < expected.size(); i++) {
+                if (t_sorted.m_keys[i] != expected[i].first || t_sorted.m_indices[i] != expected[i].second) {
+                    throw std::runtime_error(t_subjectName + " sorted the " + t_caseName + " case incorrectly!");
+                };
+            };
+        };
+
+        KeysAndIndices sorted;
+        double radixSortNs = timeSort<KeysAndIndices>(input, sorted, t_options.m_numRepetitions,
+                                                      [&](KeysAndIndices& t_sorted) {
+            ae::radixSort(t_sorted.m_keys.data(), t_sorted.m_indices.data(), t_sorted.m_keys.size(), t_allocator);
+        });
+        check(sorted, "ae::radixSort");
+        t_results.push_back({t_caseName, "ae::radixSort", t_keys.size(), 1, radixSortNs, stdSortNs});
+
+        double parallelRadixSortNs = timeSort<KeysAndIndices>(input, sorted, t_options.m_numRepetitions,
+                                                              [&](KeysAndIndices& t_sorted) {
+            ae::parallelRadixSort(t_threadPool,
+                                  t_sorted.m_keys.data(),
+                                  t_sorted.m_indices.data(),
+                                  t_sorted.m_keys.size(),
+                                  t_allocator);
+        });
+        check(sorted, "ae::parallelRadixSort");
+        t_results.push_back({t_caseName, "ae::parallelRadixSort", t_keys.size(), t_threadPool.getNumThreads(),
+                             parallelRadixSortNs, stdSortNs});
+    };
+
+    /// Prints the results as a table.
+    void printResults(const std::vector<SortResult>& t_results, std::ostream& t_stream) {
+        t_stream << std::left << std::setw(22) << "case" << std::setw(24) << "subject" << std::right
+                 << std::setw(10) << "elements" << std::setw(8) << "threads" << std::setw(14) << "median ms"
+                 << std::setw(12) << "ns/elem" << std::setw(12) << "Melem/s" << std::setw(10) << "speedup" << "\n";
+
+        t_stream << std::fixed;
+        for (const auto& result: t_results) {
+            double numElements = static_cast<double>(result.m_numElements);
+            t_stream << std::left << std::setw(22) << result.m_caseName << std::setw(24) << result.m_subjectName
+                     << std::right << std::setw(10) << result.m_numElements << std::setw(8) << result.m_numThreads
+                     << std::setprecision(3) << std::setw(14) << result.m_medianNs / 1.0e6
+                     << std::setprecision(2) << std::setw(12) << result.m_medianNs / numElements
+                     << std::setw(12) << numElements * 1.0e3 / result.m_medianNs
+                     << std::setw(10) << result.m_stdSortMedianNs / result.m_medianNs << "\n";
+        };
+        t_stream << "Speedup is the std::sort time of the same case over the subject's time.\n";
+    };
+
+    /// Writes the results to a file as JSON.
+    void writeJson(const std::vector<SortResult>& t_results,
+                   const BenchmarkOptions& t_options,
+                   const std::string& t_filepath) {
+        std::ofstream file{t_filepath};
+        if (!file) {
+            throw std::runtime_error("Could not open " + t_filepath + " to write the benchmark results!");
+        };
+
+        file << std::setprecision(10);
+        file << "{\n";
+        file << "  \"benchmark\": \"ae_sort_bench\",\n";
+        file << "  \"repetitions\": " << t_options.m_numRepetitions << ",\n";
+        file << "  \"results\": [";
+        for (std::size_t i = 0; i < t_results.size(); i++) {
+            const SortResult& result = t_results[i];
+            file << (i == 0 ? "\n" : ",\n") << "    {";
+            file << "\"case\": \"" << result.m_caseName << "\", ";
+            file << "\"subject\": \"" << result.m_subjectName << "\", ";
+            file << "\"elements\": " << result.m_numElements << ", ";
+            file << "\"threads\": " << result.m_numThreads << ", ";
+            file << "\"medianNs\": " << result.m_medianNs << ", ";
+            file << "\"speedupOverStdSort\": " << result.m_stdSortMedianNs / result.m_medianNs;
+            file << "}";
+        };
+        file << "\n  ]\n}\n";
+    };
+}
+
+
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parseOptions(argc, argv);
+        ae::AeThreadPool threadPool{options.m_numThreads};
+
+        // The largest case needs scratch memory for a uint64 key, or a uint32 key and index, per element, with room
+        // for the counts of each thread and the allocator's own overhead.
+        std::size_t maxSize = *std::max_element(options.m_sizes.begin(), options.m_sizes.end());
+        ScratchAllocator scratchAllocator{maxSize * sizeof(std::uint64_t) + (std::size_t{16} << 20)};
+
+        std::mt19937_64 random{options.m_seed};
+        std::uniform_real_distribution<float> floatDistribution{-1.0e6f, 1.0e6f};
+
+        std::vector<SortResult> results;
+        auto isChosen = [&](const std::string& t_caseName) {
+            return t_caseName.find(options.m_caseFilter) != std::string::npos;
+        };
+        for (std::size_t size: options.m_sizes) {
+            std::cerr << "Sorting " << size << " elements.\n";
+
+            std::vector<std::uint32_t> uint32Keys(size);
+            std::vector<std::uint64_t> uint64Keys(size);
+            std::vector<float> floatKeys(size);
+            for (std::size_t i = 0; i < size; i++) {
+                uint32Keys[i] = static_cast<std::uint32_t>(random());
+                uint64Keys[i] = random();
+                floatKeys[i] = floatDistribution(random);
+            };
+
+            if (isChosen("uint32")) {
+                runKeysCase("uint32", uint32Keys, options, threadPool, scratchAllocator.get(), results);
+            };
+            if (isChosen("uint64")) {
+                runKeysCase("uint64", uint64Keys, options, threadPool, scratchAllocator.get(), results);
+            };
+            if (isChosen("float")) {
+                runKeysCase("float", floatKeys, options, threadPool, scratchAllocator.get(), results);
+            };
+            if (isChosen("uint32 + index")) {
+                runKeyIndexCase("uint32 + index", uint32Keys, options, threadPool, scratchAllocator.get(), results);
+            };
+        };
+
+        printResults(results, std::cout);
+
+        if (!options.m_jsonFilepath.empty()) {
+            writeJson(results, options, options.m_jsonFilepath);
+        };
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    };
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,240 @@
+/// \file ae_engine_config.cpp
+/// The AeEngineConfig class is implemented.
+#include "ae_engine_config.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ae {
+
+    namespace {
+
+        /// Removes the whitespace from the start and end of a string.
+        std::string trim(const std::string& t_string) {
+            std::size_t first = t_string.find_first_not_of(" \t\r\n");
+            if (first == std::string::npos) {
+                return "";
+            };
+            std::size_t last = t_string.find_last_not_of(" \t\r\n");
+            return t_string.substr(first, last - first + 1);
+        };
+
+        /// Reduces a limit to the maximum the device supports and reports the reduction.
+        std::size_t reduceToDeviceLimit(const char* t_key, std::size_t t_limit, std::size_t t_deviceLimit) {
+            if (t_limit > t_deviceLimit) {
+                std::cout << "Engine limit " << t_key << " reduced from " << t_limit << " to " << t_deviceLimit
+                          << " to fit the device.\n";
+                return t_deviceLimit;
+            };
+            return t_limit;
+        };
+    }
+
+
+
+    // Read the specified limits from the file then size the host limits that were not specified.
+    AeEngineLimits AeEngineConfig::loadLimits(const std::string& t_filepath) {
+        AeEngineLimits limits{};
+
+        std::ifstream file{t_filepath};
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (file.is_open() && std::getline(file, line)) {
+            lineNumber++;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') {
+                continue;
+            };
+
+            std::size_t separator = line.find('=');
+            if (separator == std::string::npos) {
+                throw std::runtime_error("Engine configuration line " + std::to_string(lineNumber) +
+                                         " is not a \"key = value\" pair: " + t_filepath);
+            };
+            std::string key = trim(line.substr(0, separator));
+            std::string value = trim(line.substr(separator + 1));
+
+            if (key == "max_entities") {
+                limits.m_maxNumEntities = parseLimit(key, value);
+            } else if (key == "max_objects") {
+                limits.m_maxObjects = parseLimit(key, value);
+            } else if (key == "max_models") {
+                limits.m_maxModels = parseLimit(key, value);
+            } else if (key == "de_stack_allocator_bytes") {
+                limits.m_deStackAllocatorBytes = parseLimit(key, value);
+            } else if (key == "free_list_allocator_bytes") {
+                limits.m_freeListAllocatorBytes = parseLimit(key, value);
+            } else if (key == "frame_arena_bytes") {
+                limits.m_frameArenaBytes = parseLimit(key, value);
+            } else if (key == "slab_allocator_bytes") {
+                limits.m_slabAllocatorBytes = parseLimit(key, value);
+            } else {
+                throw std::runtime_error("Unknown engine configuration key \"" + key + "\": " + t_filepath);
+            };
+        };
+
+        std::size_t physicalMemoryBytes = getPhysicalMemoryBytes();
+        if (physicalMemoryBytes == 0) {
+            physicalMemoryBytes = FALLBACK_PHYSICAL_MEMORY_BYTES;
+        };
+
+        if (limits.m_maxNumEntities == 0) {
+            limits.m_maxNumEntities = std::clamp(physicalMemoryBytes / PHYSICAL_MEMORY_BYTES_PER_ENTITY,
+                                                 MIN_AUTO_ENTITIES,
+                                                 MAX_AUTO_ENTITIES);
+        };
+
+        // The allocators are sized from the number of entities, but never more than a fraction of the physical memory
+        // so a large configured number of entities can not take the whole machine.
+        if (limits.m_deStackAllocatorBytes == 0) {
+            limits.m_deStackAllocatorBytes = std::min(limits.m_maxNumEntities * DE_STACK_BYTES_PER_ENTITY,
+                                                      physicalMemoryBytes / PHYSICAL_MEMORY_FRACTION);
+        };
+
+        if (limits.m_freeListAllocatorBytes == 0) {
+            limits.m_freeListAllocatorBytes = std::clamp(limits.m_maxNumEntities * FREE_LIST_BYTES_PER_ENTITY,
+                                                         MIN_FREE_LIST_BYTES,
+                                                         std::max(MIN_FREE_LIST_BYTES,
+                                                                  physicalMemoryBytes / PHYSICAL_MEMORY_FRACTION));
+        };
+
+        if (limits.m_frameArenaBytes == 0) {
+            limits.m_frameArenaBytes = std::clamp(limits.m_maxNumEntities * FRAME_ARENA_BYTES_PER_ENTITY,
+                                                  MIN_FRAME_ARENA_BYTES,
+                                                  std::max(MIN_FRAME_ARENA_BYTES,
+                                                           physicalMemoryBytes / PHYSICAL_MEMORY_FRACTION /
+                                                           MAX_FRAMES_IN_FLIGHT));
+        };
+
+        if (limits.m_slabAllocatorBytes == 0) {
+            limits.m_slabAllocatorBytes = std::clamp(limits.m_maxNumEntities * SLAB_BYTES_PER_ENTITY,
+                                                     MIN_SLAB_BYTES,
+                                                     std::max(MIN_SLAB_BYTES,
+                                                              physicalMemoryBytes / PHYSICAL_MEMORY_FRACTION));
+        };
+
+        return limits;
+    };
+
+
+
+    // Size the object and model limits from the host visible memory and the storage buffer range of the device.
+    AeEngineLimits AeEngineConfig::fitToDevice(const AeEngineLimits& t_limits, VkPhysicalDevice t_physicalDevice) {
+        AeEngineLimits limits = t_limits;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(t_physicalDevice, &properties);
+
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(t_physicalDevice, &memoryProperties);
+
+        // The number of textures is compiled into the shaders, so it can only be checked.
+        if (properties.limits.maxPerStageDescriptorSamplers < MAX_TEXTURES ||
+            properties.limits.maxDescriptorSetSamplers < MAX_TEXTURES) {
+            throw std::runtime_error("The device does not support the number of textures the shaders were compiled "
+                                     "with, MAX_TEXTURES!");
+        };
+
+        // The object buffers are host visible, find the largest heap they could be allocated from.
+        VkDeviceSize hostVisibleHeapBytes = 0;
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+                hostVisibleHeapBytes = std::max(hostVisibleHeapBytes,
+                                                memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size);
+            };
+        };
+
+        // Every object has an entry in the 3D SSBO, the 2D SSBO, and the draw indirect buffer of each frame in flight.
+        std::size_t drawIndirectBytesPerObject = MAX_3D_MATERIALS * DRAW_INDEXED_INDIRECT_COMMAND_SIZE;
+        std::size_t bytesPerObject = MAX_FRAMES_IN_FLIGHT * (sizeof(Entity3DSSBOData) +
+                                                             sizeof(Entity2DSSBOData) +
+                                                             drawIndirectBytesPerObject);
+
+        std::size_t storageBufferRange = properties.limits.maxStorageBufferRange;
+        std::size_t maxDeviceObjects = std::min({static_cast<std::size_t>(hostVisibleHeapBytes / DEVICE_MEMORY_FRACTION) /
+                                                 bytesPerObject,
+                                                 storageBufferRange / sizeof(Entity3DSSBOData),
+                                                 storageBufferRange / drawIndirectBytesPerObject,
+                                                 static_cast<std::size_t>(std::numeric_limits<ssbo_idx>::max())});
+        std::size_t maxDeviceModels = std::min(storageBufferRange / sizeof(VkAabbPositionsKHR),
+                                               static_cast<std::size_t>(std::numeric_limits<ssbo_idx>::max()));
+
+        if (limits.m_maxObjects == 0) {
+            limits.m_maxObjects = std::min(std::max(DEFAULT_MAX_OBJECTS, limits.m_maxNumEntities), maxDeviceObjects);
+        } else {
+            limits.m_maxObjects = reduceToDeviceLimit("max_objects", limits.m_maxObjects, maxDeviceObjects);
+        };
+
+        if (limits.m_maxModels == 0) {
+            limits.m_maxModels = std::min(std::max(DEFAULT_MAX_MODELS, limits.m_maxObjects / OBJECTS_PER_AUTO_MODEL),
+                                          maxDeviceModels);
+        } else {
+            limits.m_maxModels = reduceToDeviceLimit("max_models", limits.m_maxModels, maxDeviceModels);
+        };
+
+        return limits;
+    };
+
+
+
+    // Ask the operating system for the amount of physical memory.
+    std::size_t AeEngineConfig::getPhysicalMemoryBytes() {
+#if defined(_WIN32)
+        MEMORYSTATUSEX memoryStatus{};
+        memoryStatus.dwLength = sizeof(memoryStatus);
+        if (GlobalMemoryStatusEx(&memoryStatus)) {
+            return static_cast<std::size_t>(memoryStatus.ullTotalPhys);
+        };
+        return 0;
+#else
+        long numPages = sysconf(_SC_PHYS_PAGES);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (numPages <= 0 || pageSize <= 0) {
+            return 0;
+        };
+        return static_cast<std::size_t>(numPages) * static_cast<std::size_t>(pageSize);
+#endif
+    };
+
+
+
+    // Read a number, or "auto" which is stored as 0. std::stoull accepts a sign and wraps negative numbers around, so
+    // the value must start with a digit.
+    std::size_t AeEngineConfig::parseLimit(const std::string& t_key, const std::string& t_value) {
+        if (t_value == "auto") {
+            return 0;
+        };
+
+        std::size_t numCharactersRead = 0;
+        unsigned long long limit = 0;
+        if (!t_value.empty() && std::isdigit(static_cast<unsigned char>(t_value[0]))) {
+            try {
+                limit = std::stoull(t_value, &numCharactersRead);
+            } catch (const std::exception&) {
+                numCharactersRead = 0;
+            };
+        };
+
+        if (numCharactersRead != t_value.size() || limit == 0) {
+            throw std::runtime_error("Engine configuration value for \"" + t_key + "\" must be a positive number or "
+                                     "auto: " + t_value);
+        };
+        return static_cast<std::size_t>(limit);
+    };
+
+} // namespace ae
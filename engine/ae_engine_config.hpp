@@ -0,0 +1,118 @@
+/// \file ae_engine_config.hpp
+/// The AeEngineLimits structure and the AeEngineConfig class are defined. The engine limits size the ECS, the
+/// allocators, and the GPU buffers at startup. They are read from a configuration file and any limit that is not
+/// specified is sized from the hardware, so low end machines do not run out of memory and high end machines are not
+/// held to the limits of a low end machine.
+#pragma once
+
+// dependencies
+#include "ae_engine_constants.hpp"
+
+// libraries
+#include <vulkan/vulkan_core.h>
+
+//std
+#include <cstdint>
+#include <string>
+
+namespace ae {
+
+    /// The limits the engine is sized with. A limit of 0 means the limit is sized from the hardware.
+    struct AeEngineLimits {
+        /// The maximum number of entities that can exist in the ECS.
+        std::size_t m_maxNumEntities = 0;
+
+        /// The maximum number of objects that can be rendered at a given time, sizes the object SSBOs.
+        std::size_t m_maxObjects = 0;
+
+        /// The maximum number of models that can be loaded at a given time, sizes the model OBB SSBO.
+        std::size_t m_maxModels = 0;
+
+        /// The number of bytes given to the double ended stack allocator used for component data.
+        std::size_t m_deStackAllocatorBytes = 0;
+
+        /// The number of bytes given to the free list allocator.
+        std::size_t m_freeListAllocatorBytes = 0;
+
+        /// The number of bytes in the arena of each frame in flight, used for memory only needed for a frame.
+        std::size_t m_frameArenaBytes = 0;
+
+        /// The number of bytes given to the slab allocator used for small objects.
+        std::size_t m_slabAllocatorBytes = 0;
+    };
+
+    /// Reads the engine limits from a configuration file and sizes the limits that are not specified from the
+    /// hardware. The configuration file has a "key = value" pair per line, lines starting with # are comments, and a
+    /// value of "auto" sizes that limit from the hardware. The keys are max_entities, max_objects, max_models,
+    /// de_stack_allocator_bytes, free_list_allocator_bytes, frame_arena_bytes, and slab_allocator_bytes.
+    class AeEngineConfig {
+    public:
+
+        /// Reads the engine limits from the configuration file and sizes the limits that depend on the host, the
+        /// number of entities and the allocators, from the physical memory. A missing file sizes every limit from the
+        /// hardware. The GPU limits are left for fitToDevice.
+        /// \param t_filepath The configuration file.
+        /// \return The engine limits with the host limits sized.
+        static AeEngineLimits loadLimits(const std::string& t_filepath);
+
+        /// Sizes the GPU limits that were not specified from the device, and reduces the specified GPU limits the
+        /// device can not support. Also checks the device supports the limits compiled into the shaders.
+        /// \param t_limits The engine limits returned by loadLimits.
+        /// \param t_physicalDevice The GPU the limits are fitted to.
+        /// \return The engine limits with every limit sized.
+        static AeEngineLimits fitToDevice(const AeEngineLimits& t_limits, VkPhysicalDevice t_physicalDevice);
+
+        /// Gets the amount of physical memory of the host.
+        /// \return The number of bytes of physical memory, 0 if it could not be determined.
+        static std::size_t getPhysicalMemoryBytes();
+
+    private:
+
+        /// Physical memory assumed when the physical memory of the host can not be determined.
+        static constexpr std::size_t FALLBACK_PHYSICAL_MEMORY_BYTES = std::size_t{4} << 30;
+
+        /// Physical memory given to each automatically sized entity.
+        static constexpr std::size_t PHYSICAL_MEMORY_BYTES_PER_ENTITY = std::size_t{256} << 10;
+
+        /// The bounds of the automatically sized number of entities. Every entity indexed array of the ECS is
+        /// iterated in full by some operations so very large limits have a cost even when unused.
+        static constexpr std::size_t MIN_AUTO_ENTITIES = 4096;
+        static constexpr std::size_t MAX_AUTO_ENTITIES = std::size_t{1} << 20;
+
+        /// Double ended stack allocator memory given to each entity. Each component using the maximum entity array
+        /// storage method reserves its data for every possible entity from this allocator.
+        static constexpr std::size_t DE_STACK_BYTES_PER_ENTITY = std::size_t{32} << 10;
+
+        /// Free list allocator memory given to each entity, and the smallest free list allocator.
+        static constexpr std::size_t FREE_LIST_BYTES_PER_ENTITY = 256;
+        static constexpr std::size_t MIN_FREE_LIST_BYTES = 1000000;
+
+        /// Frame arena memory given to each entity, and the smallest frame arena. The lists of entities the systems
+        /// act on each frame are allocated from the frame arena.
+        static constexpr std::size_t FRAME_ARENA_BYTES_PER_ENTITY = 256;
+        static constexpr std::size_t MIN_FRAME_ARENA_BYTES = std::size_t{1} << 20;
+
+        /// Slab allocator memory given to each entity, and the smallest slab allocator. The nodes of the components
+        /// stored in unordered maps are allocated from the slab allocator.
+        static constexpr std::size_t SLAB_BYTES_PER_ENTITY = 128;
+        static constexpr std::size_t MIN_SLAB_BYTES = std::size_t{1} << 20;
+
+        /// The automatically sized limits may use at most this fraction of the host visible device memory, and the
+        /// allocators at most this fraction of the physical memory.
+        static constexpr std::size_t DEVICE_MEMORY_FRACTION = 4;
+        static constexpr std::size_t PHYSICAL_MEMORY_FRACTION = 4;
+
+        /// The number of rendered objects per automatically sized model.
+        static constexpr std::size_t OBJECTS_PER_AUTO_MODEL = 16;
+
+        /// Reads a limit from a configuration value.
+        /// \param t_key The key of the value, used for error messages.
+        /// \param t_value The value, a number or "auto".
+        /// \return The limit, 0 for "auto".
+        static std::size_t parseLimit(const std::string& t_key, const std::string& t_value);
+
+    protected:
+
+    };
+
+} // namespace ae
@@ -8,7 +8,7 @@
 #include <vector>
 #include <memory>
 #include "ae_ecs_constants.hpp"
-#include <unordered_set>
+#include <bitset>
 #include <vulkan/vulkan_core.h>
 
 /// The maximum number of frames allowed to be in the rendering queue at a given time.
@@ -16,7 +16,8 @@
 // TODO Make the shaders automatically update their values if this value is updated.v
 static const std::size_t MAX_FRAMES_IN_FLIGHT = 2;
 
-/// The maximum number of textures the engine will support loaded into the texture SSBO.
+/// The maximum number of textures the engine will support loaded into the texture SSBO. This is compiled into the
+/// shaders so it can not be changed by the engine limits, the engine limits only check the device supports it.
 static const std::size_t MAX_TEXTURES = 8;
 
 /// Defines the maximum allowed materials that are applicable to 3D objects, and the maximum number of textures that any
@@ -29,11 +30,13 @@ static const std::size_t MAX_3D_MATERIAL_TEXTURES = 10;
 static const std::size_t MAX_2D_MATERIALS = 20;
 static const std::size_t MAX_2D_MATERIAL_TEXTURES = 10;
 
-/// The maximum number of objects that are allowed to be rendered at a given time.
-static const std::size_t MAX_OBJECTS = 16384;
+/// The maximum number of objects that are allowed to be rendered at a given time when the engine limits do not
+/// specify one. Auto sized engine limits never go below this.
+static const std::size_t DEFAULT_MAX_OBJECTS = 16384;
 
-/// The maximum number of models that are allowed to be loaded at a given time.
-static const std::size_t MAX_MODELS = 1024;
+/// The maximum number of models that are allowed to be loaded at a given time when the engine limits do not specify
+/// one. Auto sized engine limits never go below this.
+static const std::size_t DEFAULT_MAX_MODELS = 1024;
 
 /// The maximum number of allowed gpu particles at a single time
 static const std::size_t MAX_PARTICLES = 1024;
@@ -110,9 +113,13 @@ namespace ae {
 
 
     /// A image buffer structure that tracks an images position within the image buffer and which entities use the image
-    /// with which materials.
+    /// with which materials. The structures are stored in an array indexed by the index of the image's handle, an
+    /// image that no entity uses has an empty entity material map.
     struct ImageBufferInfo{
 
+        /// Creates an image buffer structure for an image that is not in the image buffer.
+        ImageBufferInfo() = default;
+
         /// Creates an image buffer structure to track a image's position within the image buffer and which entities use
         /// the image with which materials.
         /// \param t_imageBufferIndex The index of the image in the image buffer.
@@ -120,14 +127,14 @@ namespace ae {
         /// \param t_materialId The material ID corresponding to the material the entity is using the image with.
         ImageBufferInfo(uint64_t t_imageBufferIndex, ecs_id t_entityID, material_id t_materialId){
             m_imageBufferIndex = t_imageBufferIndex;
-            m_entityMaterialMap.insert(std::pair<ecs_id,std::unordered_set<material_id>>(t_entityID,{t_materialId}));
+            m_entityMaterialMap[t_entityID].set(t_materialId);
         };
 
         /// Index for a specific image in the image buffer.
-        uint64_t m_imageBufferIndex;
+        uint64_t m_imageBufferIndex = 0;
 
         /// For an image records the entities that use the image and which of the entities materials references the
-        /// image.
-        std::map<ecs_id,std::unordered_set<material_id>> m_entityMaterialMap{};
+        /// image, a bit for each material indexed by the material ID.
+        std::map<ecs_id,std::bitset<MAX_3D_MATERIALS>> m_entityMaterialMap{};
     };
 } // namespace ae
\ No newline at end of file
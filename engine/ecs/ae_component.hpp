@@ -7,8 +7,13 @@
 #include "ae_component_base.hpp"
 #include "stl_wrappers.hpp"
 #include "ae_de_stack_allocator.hpp"
+#include "ae_ecs_snapshot.hpp"
+#include "ae_ecs_fork.hpp"
+#include "cow_paged_array.hpp"
 
 #include <cstdint>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
 
 namespace ae_ecs {
@@ -24,14 +29,15 @@ namespace ae_ecs {
 
         enum ComponentStorageMethod{
             componentStorageMethod_maxEntityArray = 0,
-            componentStorageMethod_unorderedMap
+            componentStorageMethod_unorderedMap,
+            componentStorageMethod_copyOnWritePages
         };
 
         /// Function to create a component, specify the specific manager for the component, and allocate memory for the
         /// component data.
         /// \param t_componentManager The component manager that will manage this component.
 		explicit AeComponent(AeECS& t_ecs,
-                             std::size_t t_numInitialElements=MAX_NUM_ENTITIES,
+                             std::size_t t_numInitialElements=DEFAULT_MAX_NUM_ENTITIES,
                              ComponentStorageMethod t_componentStorageMethod=componentStorageMethod_maxEntityArray) :
                              m_ecs{t_ecs},
                              m_componentStorageMethod{t_componentStorageMethod},
@@ -40,9 +46,9 @@ namespace ae_ecs {
             switch (m_componentStorageMethod) {
                 case componentStorageMethod_maxEntityArray: {
                     m_bottomStackMarker = m_ecs.m_deStackAllocator.getBottomStackMarker();
-                    m_componentDataArray = static_cast<T*>(m_ecs.m_deStackAllocator.allocateFromBottom(sizeof(T)*MAX_NUM_ENTITIES));
+                    m_componentDataArray = static_cast<T*>(m_ecs.m_deStackAllocator.allocateFromBottom(sizeof(T)*m_ecs.getMaxNumEntities()));
                     T templateComponentData;
-                    for (ecs_id i = 1; i < MAX_NUM_ENTITIES; i++) {
+                    for (ecs_id i = 1; i < m_ecs.getMaxNumEntities(); i++) {
                         m_componentDataArray[i] = templateComponentData;
                     };
                     break;
@@ -52,6 +58,10 @@ namespace ae_ecs {
                             t_numInitialElements, m_ecs.m_freeListAllocator);
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    m_componentDataPages = std::make_unique<ae::CowPagedArray<T>>(m_ecs.getMaxNumEntities());
+                    break;
+                }
             };
 		};
 
@@ -69,6 +79,10 @@ namespace ae_ecs {
                     m_componentDataMap = nullptr;
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    m_componentDataPages = nullptr;
+                    break;
+                }
             };
 
 		};
@@ -94,6 +108,10 @@ namespace ae_ecs {
                     return getWriteableDataReference(t_entityId);
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    return getWriteableDataReference(t_entityId);
+                    break;
+                }
                 default:
                     throw std::runtime_error("No valid component storage method specified.");
             };
@@ -113,6 +131,11 @@ namespace ae_ecs {
                     m_componentDataMap->erase(t_entityId);
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    T templateComponentData;
+                    m_componentDataPages->write(t_entityId) = templateComponentData;
+                    break;
+                }
             };
         };
 
@@ -130,6 +153,10 @@ namespace ae_ecs {
                     return m_componentDataMap->at(t_entityId);
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    return m_componentDataPages->write(t_entityId);
+                    break;
+                }
                 default:
                     throw std::runtime_error("No valid component storage method specified.");
             };
@@ -147,15 +174,303 @@ namespace ae_ecs {
                     return m_componentDataMap->at(t_entityId);
                     break;
                 }
+                case componentStorageMethod_copyOnWritePages: {
+                    return m_componentDataPages->read(t_entityId);
+                    break;
+                }
                 default:
                     throw std::runtime_error("No valid component storage method specified.");
             };
         };
 
+        /// Gets the memory usage and number of entities using this component.
+        /// \return The statistics of the component.
+        AeComponentStats getComponentStats() override {
+            AeComponentStats stats{};
+            stats.m_componentId = m_componentId;
+            stats.m_dataTypeName = AeEcsStats::demangleTypeName(typeid(T).name());
+            stats.m_elementSize = sizeof(T);
+            stats.m_entityCount = m_componentManager.getComponentEntities(m_componentId).size();
+            stats.m_bytesUsed = stats.m_entityCount * sizeof(T);
+
+            switch (m_componentStorageMethod) {
+                case componentStorageMethod_maxEntityArray: {
+                    stats.m_storageMethod = "maxEntityArray";
+                    stats.m_bytesReserved = sizeof(T) * m_ecs.getMaxNumEntities();
+                    break;
+                }
+                case componentStorageMethod_unorderedMap: {
+                    // Each node holds the value, the cached hash, and the next node pointer.
+                    stats.m_storageMethod = "unorderedMap";
+                    stats.m_bytesReserved = m_componentDataMap->bucket_count() * sizeof(void*) +
+                                            m_componentDataMap->size() * (sizeof(std::pair<const ecs_id, T>) +
+                                                                          sizeof(std::size_t) + sizeof(void*));
+                    break;
+                }
+                case componentStorageMethod_copyOnWritePages: {
+                    stats.m_storageMethod = "copyOnWritePages";
+                    stats.m_bytesReserved = m_componentDataPages->getNumDistinctPages() *
+                                            ae::CowPagedArray<T>::m_pageSizeBytes +
+                                            m_componentDataPages->getNumPages() * sizeof(void*) * 2;
+                    break;
+                }
+            };
+
+            return stats;
+        };
+
+        /// Get data for a specific entity within a fork of the ECS. Writing to the data only modifies the fork.
+        /// \param t_fork The fork of the ECS the data belongs to.
+        /// \param t_entityID The ID of the entity to return the component data for.
+        T& getWriteableDataReference(AeEcsFork& t_fork, ecs_id t_entityId) {
+            return getForkedComponentData(t_fork).m_pages->write(t_entityId);
+        };
+
+        /// Get data for a specific entity within a fork of the ECS.
+        /// \param t_fork The fork of the ECS the data belongs to.
+        /// \param t_entityID The ID of the entity to return the component data for.
+        const T& getReadOnlyDataReference(const AeEcsFork& t_fork, ecs_id t_entityId) const {
+            return getForkedComponentData(const_cast<AeEcsFork&>(t_fork)).m_pages->read(t_entityId);
+        };
+
 	private:
 
+        /// Finds the data of this component within a fork.
+        /// \param t_fork The fork of the ECS.
+        /// \return The forked component data.
+        AeForkedComponentData<T>& getForkedComponentData(AeEcsFork& t_fork) const {
+            auto componentDataIterator = t_fork.m_componentData.find(m_componentId);
+            if (componentDataIterator == t_fork.m_componentData.end()) {
+                throw std::runtime_error("The component is not part of the fork. Only components using copy on write "
+                                         "pages can be forked.");
+            };
+            return static_cast<AeForkedComponentData<T>&>(*componentDataIterator->second);
+        };
+
 	protected:
 
+        /// Specifies if the component data can be stored in a snapshot. Trivially copyable data is always persisted,
+        /// components holding other data must override this along with saveEntitySnapshot and loadEntitySnapshot.
+        /// Entities lose components that are not persisted when a snapshot is loaded.
+        /// \return True if the component data is stored in snapshots.
+        virtual bool isSnapshotPersistent() const { return std::is_trivially_copyable<T>::value; };
+
+        /// Writes the data of a single entity to a snapshot. Components whose data holds pointers to assets should
+        /// override this and write the asset references using the writer.
+        /// \param t_data The entity data to be written.
+        /// \param t_writer The writer the snapshot is being written with.
+        virtual void saveEntitySnapshot(const T& t_data, AeSnapshotWriter& t_writer) {
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                t_writer.write(t_data);
+            }
+        };
+
+        /// Reads the data of a single entity from a snapshot. Must read exactly what saveEntitySnapshot wrote.
+        /// \param t_data The entity data to be restored.
+        /// \param t_reader The reader the snapshot is being read with.
+        virtual void loadEntitySnapshot(T& t_data, AeSnapshotReader& t_reader) {
+            if constexpr (std::is_trivially_copyable<T>::value) {
+                t_data = t_reader.read<T>();
+            }
+        };
+
+        /// Writes the component header and the component data of the specified entities to a snapshot. Trivially
+        /// copyable data stored in an array is written as the raw array so it can be restored with a single copy.
+        /// \param t_writer The writer the snapshot is being written with.
+        /// \param t_entityIds The living entities that use this component.
+        void saveSnapshotData(AeSnapshotWriter& t_writer, const std::vector<ecs_id>& t_entityIds) override {
+            EcsSnapshotComponentHeader header{};
+            header.m_componentId = m_componentId;
+            header.m_typeHash = AeEcsSnapshot::hashTypeName(typeid(T).name());
+            header.m_elementSize = sizeof(T);
+            header.m_storageMethod = m_componentStorageMethod;
+
+            if (!isSnapshotPersistent()) {
+                header.m_payloadLayout = ecsSnapshotPayloadLayout_notPersisted;
+            } else if (std::is_trivially_copyable<T>::value &&
+                       m_componentStorageMethod == componentStorageMethod_maxEntityArray) {
+                header.m_payloadLayout = ecsSnapshotPayloadLayout_rawArray;
+            } else {
+                header.m_payloadLayout = ecsSnapshotPayloadLayout_entityRecords;
+            };
+
+            // Write the header now and fill in the payload size once the payload has been written.
+            std::size_t headerOffset = t_writer.getSize();
+            t_writer.write(header);
+            std::size_t payloadOffset = t_writer.getSize();
+
+            switch (header.m_payloadLayout) {
+                case ecsSnapshotPayloadLayout_rawArray: {
+                    t_writer.writeBytes(m_componentDataArray, sizeof(T) * m_ecs.getMaxNumEntities());
+                    break;
+                }
+                case ecsSnapshotPayloadLayout_entityRecords: {
+                    t_writer.write<std::uint64_t>(t_entityIds.size());
+                    for (ecs_id entityId: t_entityIds) {
+                        t_writer.write<std::uint64_t>(entityId);
+
+                        // Reserve the record size and fill it in once the entity data has been written.
+                        std::size_t recordSizeOffset = t_writer.getSize();
+                        t_writer.write<std::uint64_t>(0);
+                        saveEntitySnapshot(getReadOnlyDataReference(entityId), t_writer);
+
+                        std::uint64_t recordSize = t_writer.getSize() - recordSizeOffset - sizeof(std::uint64_t);
+                        t_writer.overwriteBytes(recordSizeOffset, &recordSize, sizeof(recordSize));
+                    };
+                    break;
+                }
+                default:
+                    break;
+            };
+
+            header.m_payloadSize = t_writer.getSize() - payloadOffset;
+            t_writer.overwriteBytes(headerOffset, &header, sizeof(header));
+        };
+
+        /// Checks that the data of a snapshot was saved from this type of component, in a layout it can restore.
+        /// \param t_header The header the component wrote when the snapshot was saved.
+        void checkSnapshotHeader(const EcsSnapshotComponentHeader& t_header) const override {
+            if (t_header.m_typeHash != AeEcsSnapshot::hashTypeName(typeid(T).name()) ||
+                t_header.m_elementSize != sizeof(T)) {
+                throw std::runtime_error("The snapshot component data does not match the type of the component it is "
+                                         "being restored into!");
+            };
+
+            switch (t_header.m_payloadLayout) {
+                case ecsSnapshotPayloadLayout_rawArray: {
+                    if (!std::is_trivially_copyable<T>::value) {
+                        throw std::runtime_error("The snapshot component array can only be restored into a trivially "
+                                                 "copyable component!");
+                    };
+                    if (t_header.m_payloadSize != sizeof(T) * m_ecs.getMaxNumEntities()) {
+                        throw std::runtime_error("The snapshot component array was saved with a different maximum "
+                                                 "number of entities!");
+                    };
+                    break;
+                }
+                case ecsSnapshotPayloadLayout_entityRecords:
+                case ecsSnapshotPayloadLayout_notPersisted:
+                    break;
+                default:
+                    throw std::runtime_error("The snapshot component data has an unknown layout!");
+            };
+        };
+
+        /// Restores the component data from a snapshot. The entity signatures have already been restored when this is
+        /// called.
+        /// \param t_reader The reader positioned at the start of the component payload.
+        /// \param t_header The header the component wrote when the snapshot was saved.
+        void loadSnapshotData(AeSnapshotReader& t_reader, const EcsSnapshotComponentHeader& t_header) override {
+            checkSnapshotHeader(t_header);
+
+            switch (t_header.m_payloadLayout) {
+                case ecsSnapshotPayloadLayout_rawArray: {
+                    if constexpr (std::is_trivially_copyable<T>::value) {
+                        if (m_componentStorageMethod == componentStorageMethod_maxEntityArray) {
+                            // Bulk copy the entire array.
+                            t_reader.readBytes(m_componentDataArray, t_header.m_payloadSize);
+                        } else {
+                            // The storage method has changed since the snapshot was saved, only copy the data of the
+                            // entities that use the component.
+                            const std::uint8_t* rawArray = t_reader.skipBytes(t_header.m_payloadSize);
+                            for (ecs_id entityId: m_componentManager.getComponentEntities(m_componentId)) {
+                                std::memcpy(&getRestoredDataReference(entityId),
+                                            rawArray + entityId * sizeof(T),
+                                            sizeof(T));
+                            };
+                        };
+                    }
+                    break;
+                }
+                case ecsSnapshotPayloadLayout_entityRecords: {
+                    auto numRecords = t_reader.read<std::uint64_t>();
+                    for (std::uint64_t i = 0; i < numRecords; i++) {
+                        auto entityId = t_reader.read<std::uint64_t>();
+                        auto recordSize = t_reader.read<std::uint64_t>();
+                        if (recordSize > t_reader.getSize() - t_reader.getPosition()) {
+                            throw std::runtime_error("The snapshot component record runs past the end of the "
+                                                     "snapshot! The snapshot is truncated or corrupt.");
+                        };
+                        std::size_t recordEnd = t_reader.getPosition() + recordSize;
+
+                        // The restored signatures of entities that are not living are empty.
+                        if (entityId >= m_ecs.getMaxNumEntities() ||
+                            !m_componentManager.getComponentSignature(static_cast<ecs_id>(entityId))
+                                    .test(m_componentId)) {
+                            throw std::runtime_error("The snapshot component record is for an entity that is not "
+                                                     "living or does not use the component!");
+                        };
+
+                        loadEntitySnapshot(getRestoredDataReference(static_cast<ecs_id>(entityId)), t_reader);
+
+                        // Always continue from the end of the record in case the component did not read all of it.
+                        t_reader.setPosition(recordEnd);
+                    };
+                    break;
+                }
+                default:
+                    break;
+            };
+        };
+
+        /// Gets the storage for an entity's data being restored from a snapshot without flagging the entity as updated.
+        /// Map storage has the entity entry created.
+        /// \param t_entityId The ID of the entity being restored.
+        /// \return The storage of the entity data.
+        T& getRestoredDataReference(ecs_id t_entityId) {
+            switch (m_componentStorageMethod) {
+                case componentStorageMethod_maxEntityArray: {
+                    return m_componentDataArray[t_entityId];
+                }
+                case componentStorageMethod_unorderedMap: {
+                    T templateComponentData;
+                    m_componentDataMap->operator[](t_entityId) = templateComponentData;
+                    return m_componentDataMap->at(t_entityId);
+                }
+                case componentStorageMethod_copyOnWritePages: {
+                    return m_componentDataPages->write(t_entityId);
+                }
+                default:
+                    throw std::runtime_error("No valid component storage method specified.");
+            };
+        };
+
+        /// Moves an entity's data to a new entity ID when the entity IDs are compacted.
+        /// \param t_oldEntityId The ID the entity had.
+        /// \param t_newEntityId The ID the entity now has, its data is currently unused.
+        void moveEntityData(ecs_id t_oldEntityId, ecs_id t_newEntityId) override {
+            switch (m_componentStorageMethod) {
+                case componentStorageMethod_maxEntityArray: {
+                    m_componentDataArray[t_newEntityId] = std::move(m_componentDataArray[t_oldEntityId]);
+                    m_componentDataArray[t_oldEntityId] = T{};
+                    break;
+                }
+                case componentStorageMethod_unorderedMap: {
+                    auto entityDataNode = m_componentDataMap->extract(t_oldEntityId);
+                    if (!entityDataNode.empty()) {
+                        entityDataNode.key() = t_newEntityId;
+                        m_componentDataMap->insert(std::move(entityDataNode));
+                    };
+                    break;
+                }
+                case componentStorageMethod_copyOnWritePages: {
+                    T entityData = std::move(m_componentDataPages->write(t_oldEntityId));
+                    m_componentDataPages->write(t_oldEntityId) = T{};
+                    m_componentDataPages->write(t_newEntityId) = std::move(entityData);
+                    break;
+                }
+            };
+        };
+
+        /// Creates a fork of the component data that shares its pages with this component.
+        /// \return The forked component data, nullptr if the component does not store its data in copy on write pages.
+        std::unique_ptr<AeForkedComponentDataBase> forkComponentData() override {
+            if (m_componentStorageMethod != componentStorageMethod_copyOnWritePages) {
+                return nullptr;
+            };
+            return std::make_unique<AeForkedComponentData<T>>(m_componentDataPages->fork());
+        };
+
         /// Defines how the component data will be stored.
         ComponentStorageMethod m_componentStorageMethod;
 
@@ -166,6 +481,9 @@ namespace ae_ecs {
         /// Pointer to the component data if storing using an unordered map.
         std::unique_ptr<ae::unordered_map<ecs_id,T,ae_memory::AeAllocatorBase>> m_componentDataMap = nullptr;
 
+        /// Pointer to the component data if storing using copy on write pages that can be shared with forks of the ECS.
+        std::unique_ptr<ae::CowPagedArray<T>> m_componentDataPages = nullptr;
+
         /// Reference to ECS that manages this component.
         ae_ecs::AeECS& m_ecs;
 	};
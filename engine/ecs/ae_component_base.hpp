@@ -5,6 +5,8 @@
 
 #include "ae_ecs.hpp"
 #include "ae_component_manager.hpp"
+#include "ae_ecs_snapshot.hpp"
+#include "ae_ecs_fork.hpp"
 
 #include <cstdint>
 
@@ -15,6 +17,8 @@ namespace ae_ecs {
     /// The class providing the base framework for a component.
 	class AeComponentBase {
         friend class AeComponentManager;
+        friend class AeEcsSnapshot;
+        friend class AeEcsFork;
 
 	public:
 
@@ -54,6 +58,11 @@ namespace ae_ecs {
         std::vector<ecs_id> getMyEntities();
 
 
+        /// Gets the memory usage and number of entities using this component.
+        /// \return The statistics of the component.
+        virtual AeComponentStats getComponentStats()=0;
+
+
         /// Alerts the component manager that a system requires this component to operate.
         /// \param t_systemId The ID of the system that requires this component to operate.
         void requiredBySystem(ecs_id t_systemId);
@@ -72,6 +81,32 @@ namespace ae_ecs {
         /// \param t_entityId
         virtual void removeEntityData(ecs_id t_entityId)=0;
 
+        /// Writes the component header and the component data of the specified entities to a snapshot.
+        /// \param t_writer The writer the snapshot is being written with.
+        /// \param t_entityIds The living entities that use this component.
+        virtual void saveSnapshotData(AeSnapshotWriter& t_writer, const std::vector<ecs_id>& t_entityIds)=0;
+
+        /// Checks that the data of a snapshot can be restored into this component, throwing if it can not. Called for
+        /// every component before the current entities are destroyed, so a snapshot that can not be restored leaves the
+        /// world as it was.
+        /// \param t_header The header the component wrote when the snapshot was saved.
+        virtual void checkSnapshotHeader(const EcsSnapshotComponentHeader& t_header) const=0;
+
+        /// Restores the component data from a snapshot. The entity signatures have already been restored when this is
+        /// called.
+        /// \param t_reader The reader positioned at the start of the component payload.
+        /// \param t_header The header the component wrote when the snapshot was saved.
+        virtual void loadSnapshotData(AeSnapshotReader& t_reader, const EcsSnapshotComponentHeader& t_header)=0;
+
+        /// Creates a fork of the component data that shares its pages with this component.
+        /// \return The forked component data, nullptr if the component does not store its data in copy on write pages.
+        virtual std::unique_ptr<AeForkedComponentDataBase> forkComponentData()=0;
+
+        /// Moves an entity's data to a new entity ID when the entity IDs are compacted.
+        /// \param t_oldEntityId The ID the entity had.
+        /// \param t_newEntityId The ID the entity now has, its data is currently unused.
+        virtual void moveEntityData(ecs_id t_oldEntityId, ecs_id t_newEntityId)=0;
+
         /// ID for the unique component created
         ecs_id m_componentId;
 
@@ -9,8 +9,11 @@
 
 namespace ae_ecs {
 
-	// Initialize the component manager.
-	AeComponentManager::AeComponentManager(){};
+	// Initialize the component manager with a cleared signature for every possible entity.
+	AeComponentManager::AeComponentManager(std::size_t t_maxNumEntities, ae_memory::AeFrameArenas& t_frameArenas) :
+        m_frameArenas{t_frameArenas},
+        m_entityComponentSignatures(t_maxNumEntities),
+        m_enabledEntities{t_maxNumEntities}{};
 
 
 	// Destroy the component manager.
@@ -78,16 +81,10 @@ namespace ae_ecs {
                     // If the entity is currently already in the system's list of entities that have been updated and needs
                     // to be acted upon it should be removed from that list since it no longer has one of the required
                     // components to be compatible with that system.
-                    auto it = find(m_systemEntityUpdateSignatures[systemId].begin(),
-                                   m_systemEntityUpdateSignatures[systemId].end(),
-                                   t_entityId);
-
-                    if (it != m_systemEntityUpdateSignatures[systemId].end()) {
-                        m_systemEntityUpdateSignatures[systemId].erase(it);
-                    };
+                    m_systemEntityUpdateSignatures.at(systemId).reset(t_entityId);
 
                     // Flag that this entity has been destroyed to this system.
-                    m_systemEntityDestroyedSignatures[systemId].push_back(t_entityId);
+                    m_systemEntityDestroyedSignatures.at(systemId).set(t_entityId);
                 };
             };
         };
@@ -101,6 +98,7 @@ namespace ae_ecs {
 	// on it.
 	void AeComponentManager::enableEntity(ecs_id t_entityId) {
 		m_entityComponentSignatures[t_entityId].set(MAX_NUM_COMPONENTS);
+        m_enabledEntities.set(t_entityId);
 	};
 
 
@@ -109,6 +107,7 @@ namespace ae_ecs {
 	// should not work on it.
 	void AeComponentManager::disableEntity(ecs_id t_entityId) {
 		m_entityComponentSignatures[t_entityId].reset(MAX_NUM_COMPONENTS);
+        m_enabledEntities.reset(t_entityId);
 	};
 
 
@@ -129,10 +128,8 @@ namespace ae_ecs {
 
             if( m_systemComponentSignatures[systemId].operator==(entityComponentSignature.operator&=(m_systemComponentSignatures[systemId]))){
                 if(m_systemComponentSignatures[systemId].test(t_componentId)){
-                    // Add the entity to the update list if it is unique. No need to have duplicates in the list.
-                    if(std::find(m_systemEntityUpdateSignatures[systemId].begin(), m_systemEntityUpdateSignatures[systemId].end(), t_entityId) == m_systemEntityUpdateSignatures[systemId].end()){
-                        m_systemEntityUpdateSignatures[systemId].push_back(t_entityId);
-                    }
+                    // Add the entity to the update list, setting its bit again does not duplicate it.
+                    m_systemEntityUpdateSignatures.at(systemId).set(t_entityId);
                 }
             };
         };
@@ -140,6 +137,91 @@ namespace ae_ecs {
 
 
 
+    // Rebuild the m_systemEntityUpdateSignatures of every system from all the entities that are compatible with it.
+    void AeComponentManager::allEntitiesComponentsUpdated(){
+        for(auto& systemSignaturePair : m_systemComponentSignatures) {
+            ae::HierarchicalBitset& updatedEntities = m_systemEntityUpdateSignatures.at(systemSignaturePair.first);
+            updatedEntities.clear();
+
+            for(ecs_id entityId=0; entityId < m_entityComponentSignatures.size() ; entityId++){
+                // Ignore if the entity has not yet been enabled, the same as when a single component is updated.
+                std::bitset<MAX_NUM_COMPONENTS+1> entityComponentSignature = m_entityComponentSignatures[entityId];
+                if(entityComponentSignature.none()){
+                    continue;
+                };
+                entityComponentSignature.set(MAX_NUM_COMPONENTS);
+
+                if(systemSignaturePair.second.operator==(entityComponentSignature.operator&=(systemSignaturePair.second))){
+                    updatedEntities.set(entityId);
+                };
+            };
+        };
+    };
+
+
+
+    // Move the component data and signatures to the new entity IDs then fix up the system entity lists. An entity is
+    // only ever moved to an ID that was free, so the moves can be applied one after another.
+    void AeComponentManager::remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves){
+        // Replace the moved entity IDs in the lists the systems have yet to act on.
+        auto remapList = [](ae::HierarchicalBitset& t_entityIds, const EntityIdMove& t_entityIdMove){
+            if(t_entityIds.test(t_entityIdMove.m_oldId)){
+                t_entityIds.reset(t_entityIdMove.m_oldId);
+                t_entityIds.set(t_entityIdMove.m_newId);
+            };
+        };
+
+        for(auto& entityIdMove : t_entityIdMoves){
+            for(auto& component : m_components){
+                if(m_entityComponentSignatures[entityIdMove.m_oldId].test(component.first)){
+                    component.second->moveEntityData(entityIdMove.m_oldId, entityIdMove.m_newId);
+                };
+            };
+
+            setComponentSignature(entityIdMove.m_newId, m_entityComponentSignatures[entityIdMove.m_oldId]);
+            setComponentSignature(entityIdMove.m_oldId, {});
+
+            for(auto& systemEntities : m_systemEntityUpdateSignatures){
+                remapList(systemEntities.second, entityIdMove);
+            };
+            for(auto& systemEntities : m_systemEntityDestroyedSignatures){
+                remapList(systemEntities.second, entityIdMove);
+            };
+        };
+    };
+
+
+
+    // Ask each component for its statistics.
+    std::vector<AeComponentStats> AeComponentManager::getComponentStats(){
+        std::vector<AeComponentStats> componentStats;
+        componentStats.reserve(m_components.size());
+        for(auto& component : m_components){
+            componentStats.push_back(component.second->getComponentStats());
+        };
+
+        std::sort(componentStats.begin(), componentStats.end(),
+                  [](const AeComponentStats& t_a, const AeComponentStats& t_b){
+                      return t_a.m_componentId < t_b.m_componentId;
+                  });
+        return componentStats;
+    };
+
+
+
+    // Gather the destroyed lists of all the systems.
+    std::vector<ecs_id> AeComponentManager::getPendingDestroyedEntities(){
+        std::vector<ecs_id> pendingEntities;
+        for(auto& systemEntities : m_systemEntityDestroyedSignatures){
+            systemEntities.second.forEachSet([&pendingEntities](ecs_id t_entityId){
+                pendingEntities.push_back(t_entityId);
+            });
+        };
+        return pendingEntities;
+    };
+
+
+
 	// Check to see if the bit in the entityComponentSignature of the entity is set high that corresponds to the
 	// component. If high then the component is used by the entity.
 	bool AeComponentManager::isComponentUsed(ecs_id t_entityId, ecs_id t_componentId) {
@@ -163,7 +245,19 @@ namespace ae_ecs {
 
         // Reset the component signature for the entity so the next entity that is assigned the ID has a fresh slate. If
         // the for loop above worked properly this should only be resetting the last bit.
-        m_entityComponentSignatures[t_entityId].reset();
+        setComponentSignature(t_entityId, {});
+    };
+
+
+
+    // Set the signature and the entity's bit in the enabled entities from the signature's last bit.
+    void AeComponentManager::setComponentSignature(ecs_id t_entityId, std::bitset<MAX_NUM_COMPONENTS + 1> t_signature){
+        m_entityComponentSignatures[t_entityId] = t_signature;
+        if(t_signature.test(MAX_NUM_COMPONENTS)){
+            m_enabledEntities.set(t_entityId);
+        } else {
+            m_enabledEntities.reset(t_entityId);
+        };
     };
 
 
@@ -178,8 +272,8 @@ namespace ae_ecs {
         m_systemComponentSignatures[t_systemId].set(MAX_NUM_COMPONENTS);
 
         // Get a systemEntityUpdate signature for the system.
-        m_systemEntityUpdateSignatures[t_systemId] = {};
-        m_systemEntityDestroyedSignatures[t_systemId] = {};
+        m_systemEntityUpdateSignatures.insert_or_assign(t_systemId, ae::HierarchicalBitset{getMaxNumEntities()});
+        m_systemEntityDestroyedSignatures.insert_or_assign(t_systemId, ae::HierarchicalBitset{getMaxNumEntities()});
     };
 
 
@@ -208,13 +302,13 @@ namespace ae_ecs {
 	};
 
     void AeComponentManager::clearSystemEntityUpdateSignatures(ecs_id t_systemId){
-        m_systemEntityUpdateSignatures[t_systemId].clear();
+        m_systemEntityUpdateSignatures.at(t_systemId).clear();
     };
 
 
     // Clear the system's entity destroyed signature so the entities do not keep attempting to be destroyed.
     void AeComponentManager::clearSystemEntityDestroyedSignatures(ecs_id t_systemId){
-        m_systemEntityDestroyedSignatures[t_systemId].clear();
+        m_systemEntityDestroyedSignatures.at(t_systemId).clear();
     };
 
 
@@ -228,26 +322,30 @@ namespace ae_ecs {
 
 	// Compare the system component signature of interest to the entity component signatures and return a list of
     // entities whose component signatures match the system's component signature and the system can act upon.
-    std::vector<ecs_id> AeComponentManager::getEnabledSystemsEntities(ecs_id t_systemId) {
+    ecs_entityList AeComponentManager::getEnabledSystemsEntities(ecs_id t_systemId) {
 
         // The set of valid entities for a system to act upon.
-        std::vector<ecs_id> enabledEntities;
+        ecs_entityList enabledEntities = m_frameArenas.makeVector<ecs_id>();
 
         auto systemSignaturePair = m_systemComponentSignatures.find(t_systemId);
         if(systemSignaturePair != m_systemComponentSignatures.end()){
-            // Loop through the entity component signatures
-            for(ecs_id entityId=0; entityId < MAX_NUM_ENTITIES ; entityId++){
+            // Reserve for every enabled entity, growing the list would leave each old buffer in the frame arena.
+            enabledEntities.reserve(m_enabledEntities.count());
+
+            // Loop through the component signatures of the enabled entities, the system's signature always has the
+            // enabled bit set so no other entity could match it.
+            m_enabledEntities.forEachSet([&](ecs_id t_entityId){
 
                 // Need to isolate the entity component signature since the &= operator puts the result back into the
                 // left hand variable.
-                std::bitset<MAX_NUM_COMPONENTS+1> entityComponentSignature = m_entityComponentSignatures[entityId];
+                std::bitset<MAX_NUM_COMPONENTS+1> entityComponentSignature = m_entityComponentSignatures[t_entityId];
 
                 // If the entities component signature matches the system's component signature add it to the list of entity
                 // indexes being returned.
-                if( m_systemComponentSignatures[t_systemId].operator==(entityComponentSignature.operator&=(systemSignaturePair->second))){
-                    enabledEntities.push_back(entityId);
+                if( systemSignaturePair->second.operator==(entityComponentSignature.operator&=(systemSignaturePair->second))){
+                    enabledEntities.push_back(t_entityId);
                 };
-            };
+            });
         }
 
         return enabledEntities;
@@ -255,21 +353,60 @@ namespace ae_ecs {
 
 
     // Returns the vector of entities
-    std::vector<ecs_id> AeComponentManager::getUpdatedSystemEntities(ecs_id t_systemId) {
-        std::vector<ecs_id> enabledUpdatedEntities;
+    ecs_entityList AeComponentManager::getUpdatedSystemEntities(ecs_id t_systemId) {
+        const ae::HierarchicalBitset& updatedEntities = m_systemEntityUpdateSignatures.at(t_systemId);
+        ecs_entityList enabledUpdatedEntities = m_frameArenas.makeVector<ecs_id>();
+        enabledUpdatedEntities.reserve(updatedEntities.count());
 
         // Check if the entities that are to be updated are still enabled when this system is executing.
-        for(auto entityId : m_systemEntityUpdateSignatures[t_systemId]){
-            if(m_entityComponentSignatures[entityId].test(MAX_NUM_COMPONENTS)){
-                enabledUpdatedEntities.push_back(entityId);
+        updatedEntities.forEachSet([&](ecs_id t_entityId){
+            if(m_enabledEntities.test(t_entityId)){
+                enabledUpdatedEntities.push_back(t_entityId);
             }
-        }
+        });
         return enabledUpdatedEntities;
     };
 
     // Returns the vector of entities
-    std::vector<ecs_id> AeComponentManager::getDestroyedSystemEntities(ecs_id t_systemId) {
-        return m_systemEntityDestroyedSignatures[t_systemId];
+    ecs_entityList AeComponentManager::getDestroyedSystemEntities(ecs_id t_systemId) {
+        const ae::HierarchicalBitset& systemDestroyedEntities = m_systemEntityDestroyedSignatures.at(t_systemId);
+        ecs_entityList destroyedEntities = m_frameArenas.makeVector<ecs_id>();
+        destroyedEntities.reserve(systemDestroyedEntities.count());
+        systemDestroyedEntities.forEachSet([&destroyedEntities](ecs_id t_entityId){
+            destroyedEntities.push_back(t_entityId);
+        });
+        return destroyedEntities;
+    };
+
+
+
+    // The same match as getEnabledSystemsEntities, counted instead of listed.
+    std::size_t AeComponentManager::getNumEnabledSystemEntities(ecs_id t_systemId) const {
+        auto systemSignaturePair = m_systemComponentSignatures.find(t_systemId);
+        if(systemSignaturePair == m_systemComponentSignatures.end()){
+            return 0;
+        };
+
+        std::size_t numEnabledEntities = 0;
+        m_enabledEntities.forEachSet([&](ecs_id t_entityId){
+            if((m_entityComponentSignatures[t_entityId] & systemSignaturePair->second) == systemSignaturePair->second){
+                numEnabledEntities++;
+            };
+        });
+        return numEnabledEntities;
+    };
+
+
+
+    // Only the updated entities that are still enabled are counted, as only those are listed.
+    std::size_t AeComponentManager::getNumUpdatedSystemEntities(ecs_id t_systemId) const {
+        return m_systemEntityUpdateSignatures.at(t_systemId).countCommon(m_enabledEntities);
+    };
+
+
+
+    std::size_t AeComponentManager::getNumDestroyedSystemEntities(ecs_id t_systemId) const {
+        return m_systemEntityDestroyedSignatures.at(t_systemId).count();
     };
 
 
@@ -285,7 +422,7 @@ namespace ae_ecs {
         evalComponentSignature.set(t_componentId);
 
         // Loop through the entity component signatures
-        for(ecs_id entityId=0; entityId < MAX_NUM_ENTITIES ; entityId++){
+        for(ecs_id entityId=0; entityId < m_entityComponentSignatures.size() ; entityId++){
             auto entityComponentSignature = m_entityComponentSignatures[entityId];
             if((entityComponentSignature.operator&=(evalComponentSignature)).any()){
                 valid_entities.push_back(entityId);
@@ -295,10 +432,11 @@ namespace ae_ecs {
         return  valid_entities;
     };
 
-    std::vector<ecs_id> AeComponentManager::getEntitiesWithSpecifiedComponents(std::vector<ecs_id>& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds){
+    ecs_entityList AeComponentManager::getEntitiesWithSpecifiedComponents(const ecs_entityList& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds){
 
         // The set of entities that use one or more of the specified optional components.
-        std::vector<ecs_id> compatibleComponentEntities;
+        ecs_entityList compatibleComponentEntities = m_frameArenas.makeVector<ecs_id>();
+        compatibleComponentEntities.reserve(t_entityIds.size());
 
         // Create a signature for the optional components.
         std::bitset<MAX_NUM_COMPONENTS + 1> optionalComponentsSignature = {0};
@@ -4,7 +4,9 @@
 #pragma once
 
 #include "ae_ecs_constants.hpp"
+#include "ae_ecs_stats.hpp"
 #include "pre_allocated_stack.hpp"
+#include "hierarchical_bitset.hpp"
 
 #include <cstdint>
 #include <bitset>
@@ -19,6 +21,8 @@ namespace ae_ecs {
 
     /// A class that is used to register and organize components and correlate them to entities and systems.
 	class AeComponentManager {
+        friend class AeEcsSnapshot;
+        friend class AeEcsFork;
 
 		/// component type ID counter variable
 		static inline ecs_id componentIdCount = 0;
@@ -26,11 +30,17 @@ namespace ae_ecs {
 	public:
 
         /// Create the component manager and initialize the component ID stack.
-		AeComponentManager();
+        /// \param t_maxNumEntities The maximum number of entities that can exist.
+        /// \param t_frameArenas The frame arenas the lists of entities handed to the systems are allocated from.
+		AeComponentManager(std::size_t t_maxNumEntities, ae_memory::AeFrameArenas& t_frameArenas);
 
         /// Destroy the component manager.
 		~AeComponentManager();
 
+        /// Gets the maximum number of entities that can exist.
+        /// \return The maximum number of entities.
+        [[nodiscard]] std::size_t getMaxNumEntities() const { return m_entityComponentSignatures.size(); };
+
         /// Release the component ID and put it back on the top of the stack.
         /// \param t_componentId The component ID to be released.
 		void releaseComponentId(ecs_id t_componentId);
@@ -68,6 +78,23 @@ namespace ae_ecs {
         /// \param t_componentId The ID of the component.
         void entitiesComponentUpdated(ecs_id t_entityId, ecs_id t_componentId);
 
+        /// Flags every entity, enabled or not, as updated for all the systems it is compatible with. Used when entity
+        /// data has been replaced in bulk, such as when a snapshot is loaded.
+        void allEntitiesComponentsUpdated();
+
+        /// Moves the signatures and component data of renumbered entities and updates the entity IDs in the system
+        /// update and destroyed lists.
+        /// \param t_entityIdMoves The entities that have been renumbered.
+        void remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves);
+
+        /// Collects the statistics of every component.
+        /// \return The statistics of the components ordered by component ID.
+        std::vector<AeComponentStats> getComponentStats();
+
+        /// Gets the entity IDs that are in any system's destroyed list and have not been cleaned up yet.
+        /// \return The IDs pending clean up.
+        std::vector<ecs_id> getPendingDestroyedEntities();
+
         /// Checks to see if an entity uses a component.
         /// \param t_entityId The ID of the entity
         /// \param t_componentId The ID of the component.
@@ -109,16 +136,31 @@ namespace ae_ecs {
         /// Compares system component signatures to the entity component signatures and returns a list of all enabled
         /// entities compatible with the system.
         /// \param t_systemId The ID of the system to be removed.
-        std::vector<ecs_id> getEnabledSystemsEntities(ecs_id t_systemId);
+        ecs_entityList getEnabledSystemsEntities(ecs_id t_systemId);
 
         /// Returns a list of enabled, compatible, entities that the system is to utilize that have had data been updated since the
         /// last system run loop.
         /// \param t_systemId The ID of the system to be removed.
-        std::vector<ecs_id> getUpdatedSystemEntities(ecs_id t_systemId);
+        ecs_entityList getUpdatedSystemEntities(ecs_id t_systemId);
 
         /// Returns a list of entities that have been destroyed since the system last ran.
         /// \param t_systemId The ID of the system to be removed.
-        std::vector<ecs_id> getDestroyedSystemEntities(ecs_id t_systemId);
+        ecs_entityList getDestroyedSystemEntities(ecs_id t_systemId);
+
+        /// Counts the entities getEnabledSystemsEntities would return, without building the list in the frame arena.
+        /// \param t_systemId The ID of the system.
+        /// \return The number of enabled entities compatible with the system.
+        std::size_t getNumEnabledSystemEntities(ecs_id t_systemId) const;
+
+        /// Counts the entities getUpdatedSystemEntities would return, without building the list in the frame arena.
+        /// \param t_systemId The ID of the system.
+        /// \return The number of enabled entities updated since the system last ran.
+        std::size_t getNumUpdatedSystemEntities(ecs_id t_systemId) const;
+
+        /// Counts the entities getDestroyedSystemEntities would return, without building the list in the frame arena.
+        /// \param t_systemId The ID of the system.
+        /// \return The number of entities destroyed since the system last ran.
+        std::size_t getNumDestroyedSystemEntities(ecs_id t_systemId) const;
 
         /// Returns the entities that use the specified component;
         /// \param t_componentId The component ID the list of entities should be returned for.
@@ -128,7 +170,7 @@ namespace ae_ecs {
         /// \param t_entityIds The entities to be check to see if they contain the optional component IDs.
         /// \param t_optionalComponentIds The optional components that the entities must have one or more of to be
         /// included in the returned vector.
-        std::vector<ecs_id> getEntitiesWithSpecifiedComponents(std::vector<ecs_id>& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds);
+        ecs_entityList getEntitiesWithSpecifiedComponents(const ecs_entityList& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds);
 
 		/// Function to allocate an ID to a specific component class so every component spawned from that class can be identified.
 		/// \tparam T The component class being allocated an ID.
@@ -142,6 +184,14 @@ namespace ae_ecs {
 
 	private:
 
+        /// Sets the whole component signature of an entity, keeping the enabled entities up to date.
+        /// \param t_entityId The ID of the entity.
+        /// \param t_signature The new component signature, the last bit is set if the entity is enabled.
+        void setComponentSignature(ecs_id t_entityId, std::bitset<MAX_NUM_COMPONENTS + 1> t_signature);
+
+        /// The frame arenas the lists of entities handed to the systems are allocated from.
+        ae_memory::AeFrameArenas& m_frameArenas;
+
 		/// Component ID stack and a counter used for the stack
         ae::PreAllocatedStack<ecs_id,MAX_NUM_COMPONENTS> m_componentIdStack{};
 
@@ -151,16 +201,22 @@ namespace ae_ecs {
 		/// Vector storing the components used for each entity, last bit is to indicate that the entity is fully
         /// initialized and ready to go live. After initialization adding or removing a component forces
         /// initialization data to be included.
-		std::bitset<MAX_NUM_COMPONENTS + 1> m_entityComponentSignatures[MAX_NUM_ENTITIES] = {0};
+		std::vector<std::bitset<MAX_NUM_COMPONENTS + 1>> m_entityComponentSignatures;
+
+        /// The entities with the last bit of their component signature set, so the entities of a system can be found
+        /// without checking the signature of every entity that could exist.
+        ae::HierarchicalBitset m_enabledEntities;
 
         /// Unordered map storing the components required for each active system.
         std::unordered_map<ecs_id,std::bitset<MAX_NUM_COMPONENTS + 1>> m_systemComponentSignatures;
 
-        /// Unordered map storing the entity component update status.
-        std::unordered_map<ecs_id,std::vector<ecs_id>> m_systemEntityUpdateSignatures;
+        /// Unordered map storing the entity component update status, a set bit for each entity updated since the system
+        /// last ran.
+        std::unordered_map<ecs_id,ae::HierarchicalBitset> m_systemEntityUpdateSignatures;
 
-        /// Unordered map storing the entity destruction status.
-        std::unordered_map<ecs_id,std::vector<ecs_id>> m_systemEntityDestroyedSignatures;
+        /// Unordered map storing the entity destruction status, a set bit for each entity destroyed since the system
+        /// last ran.
+        std::unordered_map<ecs_id,ae::HierarchicalBitset> m_systemEntityDestroyedSignatures;
 
 	protected:
 
@@ -7,27 +7,49 @@
 #include "ae_component_manager.hpp"
 #include "ae_entity_manager.hpp"
 #include "ae_system_manager.hpp"
+#include "ae_ecs_stats.hpp"
 
 #include "ae_allocator_base.hpp"
 #include "ae_de_stack_allocator.hpp"
+#include "ae_frame_arenas.hpp"
+
+#include <memory>
 
 namespace ae_ecs {
 
+    class AeEcsFork;
+
     class AeECS {
         template<class T> friend class AeSystem;
         friend class AeSystemBase;
         template<class T> friend class AeEntity;
         template<class T> friend class AeComponent;
         friend class AeComponentBase;
+        friend class AeEcsSnapshot;
+        friend class AeEcsFork;
 
     public:
-        AeECS(ae_memory::AeDeStackAllocator& t_deStackAllocator,ae_memory::AeAllocatorBase& t_freeListAllocator) :
+        /// Creates the ECS.
+        /// \param t_deStackAllocator The allocator used for component data stored for every possible entity.
+        /// \param t_freeListAllocator The allocator used for other component data.
+        /// \param t_frameArenas The frame arenas the lists of entities handed to the systems are allocated from.
+        /// \param t_maxNumEntities The maximum number of entities that can exist, normally from the engine limits.
+        AeECS(ae_memory::AeDeStackAllocator& t_deStackAllocator,
+              ae_memory::AeAllocatorBase& t_freeListAllocator,
+              ae_memory::AeFrameArenas& t_frameArenas,
+              std::size_t t_maxNumEntities = DEFAULT_MAX_NUM_ENTITIES) :
         m_deStackAllocator{t_deStackAllocator},
-        m_freeListAllocator{t_freeListAllocator}{};
+        m_freeListAllocator{t_freeListAllocator},
+        m_frameArenas{t_frameArenas},
+        m_ecsComponentManager{t_maxNumEntities, t_frameArenas}{};
 
         ~AeECS()= default;
 
+        /// Runs the enabled systems. The ECS begins the next frame arena first, so the entity lists handed to the
+        /// systems last run are freed every run whether or not a renderer is driving the frames.
         void runSystems(){
+            m_frameArenas.beginFrame(m_frameArenaIndex);
+            m_frameArenaIndex = (m_frameArenaIndex + 1) % m_frameArenas.getNumFrames();
             m_ecsSystemManager.runSystems();
         }
 
@@ -39,12 +61,54 @@ namespace ae_ecs {
             m_ecsEntityManager.destroyAllEntities();
         }
 
+        /// Gets the frame arenas, a frame's arena is begun each time the systems are run.
+        /// \return The frame arenas.
+        ae_memory::AeFrameArenas& getFrameArenas() {
+            return m_frameArenas;
+        };
+
+        /// Gets the maximum number of entities that can exist.
+        /// \return The maximum number of entities.
+        [[nodiscard]] std::size_t getMaxNumEntities() const {
+            return m_ecsComponentManager.getMaxNumEntities();
+        };
+
+        /// Renumbers living entities into a dense prefix of the entity ID range so entity indexed storage is iterated
+        /// with good locality. The component data, the system entity lists, and systems storing entity IDs are all
+        /// updated. Can be run at once, such as on a load screen, or spread over frames by limiting the moves.
+        /// Anything outside the ECS holding entity IDs must be updated using the returned moves.
+        /// \param t_maxMoves The maximum number of entities to renumber.
+        /// \return The entities that were renumbered.
+        std::vector<EntityIdMove> compactEntityIds(std::size_t t_maxMoves = std::numeric_limits<std::size_t>::max()){
+            std::vector<EntityIdMove> entityIdMoves = m_ecsEntityManager.compactEntityIds(
+                    t_maxMoves, m_ecsComponentManager.getPendingDestroyedEntities());
+            if(!entityIdMoves.empty()){
+                m_ecsComponentManager.remapEntityIds(entityIdMoves);
+                m_ecsSystemManager.remapEntityIds(entityIdMoves);
+            };
+            return entityIdMoves;
+        };
+
+        /// Collects the memory usage of the components, the work waiting for and done by the systems, and how full the
+        /// entity ID pool is. Intended for tuning the ECS limits and allocators, not for use every frame.
+        /// \return The statistics of the ECS.
+        AeEcsStats getStats();
+
+        /// Creates a fork of the entities and the component data of this ECS. Only components using the copy on write
+        /// page storage method are included in the fork, their pages are shared until written to.
+        /// \return The fork of the ECS.
+        std::unique_ptr<AeEcsFork> fork();
+
     private:
 
         ae_memory::AeDeStackAllocator& m_deStackAllocator;
         ae_memory::AeAllocatorBase& m_freeListAllocator;
+        ae_memory::AeFrameArenas& m_frameArenas;
+
+        /// The frame arena begun the next time the systems are run, the arena of the previous run stays intact.
+        std::size_t m_frameArenaIndex = 0;
 
-        AeComponentManager m_ecsComponentManager{};
+        AeComponentManager m_ecsComponentManager;
         AeSystemManager m_ecsSystemManager{m_ecsComponentManager};
         AeEntityManager m_ecsEntityManager{m_ecsComponentManager};
 
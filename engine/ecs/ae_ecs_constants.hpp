@@ -4,13 +4,29 @@
 
 #pragma once
 
+#include "ae_frame_arenas.hpp"
+
 #include <cstdint>
 #include <limits>
 
 using ecs_id = std::size_t;
 using ecs_systemInterval = std::size_t;
 
+/// A list of entities handed to a system for the current frame. It is allocated from the current frame's arena so it
+/// is only valid until the frame's arena is reset.
+using ecs_entityList = ae_memory::FrameVector<ecs_id>;
+
 static const ecs_id MAX_NUM_COMPONENTS = 32;
-static const ecs_id MAX_NUM_ENTITIES = 16000;
-//static const ecs_id MAX_NUM_ENTITIES = 65536;
-static const ecs_id MAX_NUM_SYSTEMS = 32;
\ No newline at end of file
+/// The maximum number of entities used when the ECS is not given one, normally the maximum comes from the engine
+/// limits.
+static const ecs_id DEFAULT_MAX_NUM_ENTITIES = 16000;
+static const ecs_id MAX_NUM_SYSTEMS = 32;
+
+/// Records an entity being renumbered when the entity IDs are compacted.
+struct EntityIdMove {
+    /// The ID the entity had before being moved.
+    ecs_id m_oldId;
+
+    /// The ID the entity has after being moved.
+    ecs_id m_newId;
+};
\ No newline at end of file
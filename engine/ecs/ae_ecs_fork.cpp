@@ -0,0 +1,87 @@
+/// \file ae_ecs_fork.cpp
+/// \brief The script implementing the ECS fork class.
+/// The ECS fork class is implemented.
+#include "ae_ecs_fork.hpp"
+#include "ae_ecs.hpp"
+#include "ae_component_base.hpp"
+
+namespace ae_ecs {
+
+    // Copy the entity signatures and fork the component data of every component that uses copy on write pages.
+    AeEcsFork::AeEcsFork(AeECS& t_ecs) {
+        AeComponentManager& componentManager = t_ecs.m_ecsComponentManager;
+
+        m_entityComponentSignatures = componentManager.m_entityComponentSignatures;
+
+        for (auto& component: componentManager.m_components) {
+            std::unique_ptr<AeForkedComponentDataBase> componentData = component.second->forkComponentData();
+            if (componentData != nullptr) {
+                m_componentData[component.first] = std::move(componentData);
+            };
+        };
+    };
+
+
+
+    // Copy the entity signatures and fork the component data of this fork.
+    std::unique_ptr<AeEcsFork> AeEcsFork::fork() {
+        std::unique_ptr<AeEcsFork> newFork{new AeEcsFork()};
+        newFork->m_entityComponentSignatures = m_entityComponentSignatures;
+
+        for (auto& componentData: m_componentData) {
+            newFork->m_componentData[componentData.first] = componentData.second->fork();
+        };
+
+        return newFork;
+    };
+
+
+
+    // Compare the entity signatures to the signature created from the specified components.
+    std::vector<ecs_id> AeEcsFork::getEnabledEntitiesWithComponents(const std::vector<ecs_id>& t_componentIds) const {
+        std::bitset<MAX_NUM_COMPONENTS + 1> requiredSignature = {0};
+        requiredSignature.set(MAX_NUM_COMPONENTS);
+        for (auto componentId: t_componentIds) {
+            requiredSignature.set(componentId);
+        };
+
+        std::vector<ecs_id> matchingEntities;
+        for (ecs_id entityId = 0; entityId < m_entityComponentSignatures.size(); entityId++) {
+            if ((m_entityComponentSignatures[entityId] & requiredSignature) == requiredSignature) {
+                matchingEntities.push_back(entityId);
+            };
+        };
+
+        return matchingEntities;
+    };
+
+
+
+    // Sum the shared pages of all the forked components.
+    std::size_t AeEcsFork::getNumSharedPages() const {
+        std::size_t numSharedPages = 0;
+        for (auto& componentData: m_componentData) {
+            numSharedPages += componentData.second->getNumSharedPages();
+        };
+        return numSharedPages;
+    };
+
+
+
+    // Sum the pages of all the forked components.
+    std::size_t AeEcsFork::getNumPages() const {
+        std::size_t numPages = 0;
+        for (auto& componentData: m_componentData) {
+            numPages += componentData.second->getNumPages();
+        };
+        return numPages;
+    };
+
+
+
+    // Create a fork of the world.
+    std::unique_ptr<AeEcsFork> AeECS::fork() {
+        return std::make_unique<AeEcsFork>(*this);
+    };
+
+}
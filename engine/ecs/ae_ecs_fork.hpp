@@ -0,0 +1,133 @@
+/// \file ae_ecs_fork.hpp
+/// \brief The script defining the ECS fork class.
+/// A fork of the entities and component data of an ECS is defined. Forks are used to run speculative simulations
+/// without modifying the world they were forked from.
+#pragma once
+
+#include "ae_ecs_constants.hpp"
+#include "cow_paged_array.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace ae_ecs {
+
+    class AeECS;
+
+    /// The data of a single component within a fork, allows the fork to copy it without knowing its type.
+    class AeForkedComponentDataBase {
+    public:
+        virtual ~AeForkedComponentDataBase() = default;
+
+        /// Creates a copy of the component data that shares its pages with this component data.
+        /// \return The forked component data.
+        virtual std::unique_ptr<AeForkedComponentDataBase> fork() = 0;
+
+        /// Gets the number of pages that are, or may still be, shared with another fork.
+        /// \return The number of shared pages.
+        virtual std::size_t getNumSharedPages() const = 0;
+
+        /// Gets the number of pages used to store the component data.
+        /// \return The number of pages.
+        virtual std::size_t getNumPages() const = 0;
+    };
+
+
+
+    /// The data of a single component within a fork.
+    /// \tparam T The type of the component data.
+    template<typename T>
+    class AeForkedComponentData : public AeForkedComponentDataBase {
+    public:
+        /// Creates the forked component data from already forked pages.
+        /// \param t_pages The pages of the component data.
+        explicit AeForkedComponentData(std::unique_ptr<ae::CowPagedArray<T>> t_pages) : m_pages{std::move(t_pages)} {};
+
+        /// Creates a copy of the component data that shares its pages with this component data.
+        std::unique_ptr<AeForkedComponentDataBase> fork() override {
+            return std::make_unique<AeForkedComponentData<T>>(m_pages->fork());
+        };
+
+        /// Gets the number of pages that are, or may still be, shared with another fork.
+        std::size_t getNumSharedPages() const override { return m_pages->getNumSharedPages(); };
+
+        /// Gets the number of pages used to store the component data.
+        std::size_t getNumPages() const override { return m_pages->getNumPages(); };
+
+        /// The pages of the component data.
+        std::unique_ptr<ae::CowPagedArray<T>> m_pages;
+    };
+
+
+
+    /// A copy of the entity signatures and the component data of an ECS. Only components using the copy on write page
+    /// storage method are forked, the pages are shared with the world the fork was made from until either one writes
+    /// to them. Entities can not be created or destroyed within a fork, but they can be enabled or disabled. Each fork
+    /// is expected to be used by a single thread. Forking marks the pages of the world or fork being forked as shared,
+    /// so it must not be used by another thread while it is being forked.
+    class AeEcsFork {
+        template<class T> friend class AeComponent;
+
+    public:
+
+        /// Creates a fork of the current state of an ECS.
+        /// \param t_ecs The ECS to fork.
+        explicit AeEcsFork(AeECS& t_ecs);
+
+        ~AeEcsFork() = default;
+
+        /// Do not allow this class to be copied (2 lines below), use fork to create a copy.
+        AeEcsFork(const AeEcsFork&) = delete;
+        AeEcsFork& operator=(const AeEcsFork&) = delete;
+
+        /// Creates a fork of this fork, used to branch a speculative simulation further.
+        /// \return The new fork.
+        [[nodiscard]] std::unique_ptr<AeEcsFork> fork();
+
+        /// Gets the component signature of an entity within the fork.
+        /// \param t_entityId The ID of the entity.
+        /// \return The component signature, the last bit indicates if the entity is enabled.
+        [[nodiscard]] std::bitset<MAX_NUM_COMPONENTS + 1> getComponentSignature(ecs_id t_entityId) const {
+            return m_entityComponentSignatures[t_entityId];
+        };
+
+        /// Enables an entity within the fork.
+        /// \param t_entityId The ID of the entity.
+        void enableEntity(ecs_id t_entityId) { m_entityComponentSignatures[t_entityId].set(MAX_NUM_COMPONENTS); };
+
+        /// Disables an entity within the fork.
+        /// \param t_entityId The ID of the entity.
+        void disableEntity(ecs_id t_entityId) { m_entityComponentSignatures[t_entityId].reset(MAX_NUM_COMPONENTS); };
+
+        /// Gets the enabled entities within the fork that use all the specified components.
+        /// \param t_componentIds The IDs of the components the entities must use.
+        /// \return The IDs of the matching entities.
+        [[nodiscard]] std::vector<ecs_id> getEnabledEntitiesWithComponents(const std::vector<ecs_id>& t_componentIds) const;
+
+        /// Gets the number of component data pages that are, or may still be, shared with another fork or the world.
+        /// \return The number of shared pages.
+        [[nodiscard]] std::size_t getNumSharedPages() const;
+
+        /// Gets the number of component data pages that can be used by the fork.
+        /// \return The number of pages.
+        [[nodiscard]] std::size_t getNumPages() const;
+
+    private:
+
+        /// Creates an empty fork, used when forking a fork.
+        AeEcsFork() = default;
+
+        /// The component signatures of the entities at the time of the fork.
+        std::vector<std::bitset<MAX_NUM_COMPONENTS + 1>> m_entityComponentSignatures;
+
+        /// The forked component data organized by component ID.
+        std::unordered_map<ecs_id, std::unique_ptr<AeForkedComponentDataBase>> m_componentData;
+
+    protected:
+
+    };
+
+}
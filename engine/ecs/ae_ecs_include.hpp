@@ -6,3 +6,4 @@
 #include "ae_entity.hpp"
 #include "ae_component.hpp"
 #include "ae_system.hpp"
+#include "ae_ecs_fork.hpp"
@@ -0,0 +1,437 @@
+/// \file ae_ecs_snapshot.cpp
+/// \brief The script implementing the ECS snapshot classes.
+/// The ECS snapshot classes are implemented.
+#include "ae_ecs_snapshot.hpp"
+#include "ae_ecs.hpp"
+#include "ae_component_base.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ae_ecs {
+
+    static_assert(MAX_NUM_COMPONENTS + 1 <= 64, "Entity signatures are stored in snapshots as 64 bit values.");
+
+    namespace {
+
+        /// Maps a snapshot file into memory for reading, falls back to reading the file into a buffer where memory
+        /// mapping is not available. The file is unmapped when this object is destroyed.
+        class MappedSnapshotFile {
+        public:
+            explicit MappedSnapshotFile(const std::string& t_filepath) {
+#if defined(_WIN32)
+                std::ifstream file{t_filepath, std::ios::binary | std::ios::ate};
+                if (!file.is_open()) {
+                    throw std::runtime_error("Failed to open snapshot file: " + t_filepath);
+                };
+                m_buffer.resize(static_cast<std::size_t>(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+                m_data = m_buffer.data();
+                m_size = m_buffer.size();
+#else
+                int fileDescriptor = open(t_filepath.c_str(), O_RDONLY);
+                if (fileDescriptor < 0) {
+                    throw std::runtime_error("Failed to open snapshot file: " + t_filepath);
+                };
+
+                struct stat fileStats{};
+                if (fstat(fileDescriptor, &fileStats) != 0 || fileStats.st_size <= 0) {
+                    close(fileDescriptor);
+                    throw std::runtime_error("Failed to get the size of snapshot file: " + t_filepath);
+                };
+                m_size = static_cast<std::size_t>(fileStats.st_size);
+
+                void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+                close(fileDescriptor);
+                if (mapping == MAP_FAILED) {
+                    throw std::runtime_error("Failed to memory map snapshot file: " + t_filepath);
+                };
+
+                // The snapshot is read front to back exactly once.
+                madvise(mapping, m_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const std::uint8_t*>(mapping);
+#endif
+            };
+
+            ~MappedSnapshotFile() {
+#if !defined(_WIN32)
+                munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+            };
+
+            /// Do not allow this class to be copied (2 lines below)
+            MappedSnapshotFile(const MappedSnapshotFile&) = delete;
+            MappedSnapshotFile& operator=(const MappedSnapshotFile&) = delete;
+
+            [[nodiscard]] const std::uint8_t* getData() const { return m_data; };
+            [[nodiscard]] std::size_t getSize() const { return m_size; };
+
+        private:
+            const std::uint8_t* m_data = nullptr;
+            std::size_t m_size = 0;
+#if defined(_WIN32)
+            std::vector<std::uint8_t> m_buffer;
+#endif
+        };
+    }
+
+
+
+    // Append the bytes to the end of the buffer.
+    void AeSnapshotWriter::writeBytes(const void* t_data, std::size_t t_size) {
+        const auto* bytes = static_cast<const std::uint8_t*>(t_data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + t_size);
+    };
+
+
+
+    // Replace bytes that have already been written.
+    void AeSnapshotWriter::overwriteBytes(std::size_t t_offset, const void* t_data, std::size_t t_size) {
+        if (t_offset + t_size > m_buffer.size()) {
+            throw std::runtime_error("Attempting to overwrite snapshot data that has not been written yet!");
+        };
+        std::memcpy(m_buffer.data() + t_offset, t_data, t_size);
+    };
+
+
+
+    // Write the length of the string followed by its characters.
+    void AeSnapshotWriter::writeString(const std::string& t_string) {
+        write<std::uint64_t>(t_string.size());
+        writeBytes(t_string.data(), t_string.size());
+    };
+
+
+
+    // Ask the resolver for the asset path and write it.
+    void AeSnapshotWriter::writeAsset(std::uint32_t t_assetType, std::uint32_t t_assetHandle) {
+        if (t_assetHandle == 0) {
+            writeString("");
+            return;
+        };
+
+        if (m_assetResolver == nullptr) {
+            throw std::runtime_error("A snapshot asset resolver is required to save component data referencing assets!");
+        };
+        writeString(m_assetResolver->getAssetPath(t_assetType, t_assetHandle));
+    };
+
+
+
+    // Ask the resolver for the sampler name and write it.
+    void AeSnapshotWriter::writeSampler(const void* t_sampler) {
+        if (t_sampler == nullptr) {
+            writeString("");
+            return;
+        };
+
+        if (m_assetResolver == nullptr) {
+            throw std::runtime_error("A snapshot asset resolver is required to save component data referencing "
+                                     "samplers!");
+        };
+        writeString(m_assetResolver->getSamplerName(t_sampler));
+    };
+
+
+
+    // Copy bytes from the current position and advance past them.
+    void AeSnapshotReader::readBytes(void* t_destination, std::size_t t_size) {
+        std::memcpy(t_destination, skipBytes(t_size), t_size);
+    };
+
+
+
+    // Advance past the bytes ensuring that the read does not go past the end of the snapshot.
+    const std::uint8_t* AeSnapshotReader::skipBytes(std::size_t t_size) {
+        if (t_size > m_size - m_position) {
+            throw std::runtime_error("Attempting to read past the end of the snapshot! The snapshot is truncated or "
+                                     "corrupt.");
+        };
+        const std::uint8_t* start = m_data + m_position;
+        m_position += t_size;
+        return start;
+    };
+
+
+
+    // Read the length of the string followed by its characters.
+    std::string AeSnapshotReader::readString() {
+        auto length = read<std::uint64_t>();
+        const auto* characters = reinterpret_cast<const char*>(skipBytes(length));
+        return {characters, characters + length};
+    };
+
+
+
+    // Read the asset path and have the resolver load the asset.
+    std::uint32_t AeSnapshotReader::readAssetHandle(std::uint32_t t_assetType) {
+        std::string assetPath = readString();
+        if (assetPath.empty()) {
+            return 0;
+        };
+
+        if (m_assetResolver == nullptr) {
+            throw std::runtime_error("A snapshot asset resolver is required to load component data referencing assets!");
+        };
+        return m_assetResolver->loadAsset(t_assetType, assetPath);
+    };
+
+
+
+    // Read the sampler name and have the resolver get the sampler.
+    void* AeSnapshotReader::readSampler() {
+        std::string samplerName = readString();
+        if (samplerName.empty()) {
+            return nullptr;
+        };
+
+        if (m_assetResolver == nullptr) {
+            throw std::runtime_error("A snapshot asset resolver is required to load component data referencing "
+                                     "samplers!");
+        };
+        return m_assetResolver->getSampler(samplerName);
+    };
+
+
+
+    // Move the read position ensuring it stays within the snapshot.
+    void AeSnapshotReader::setPosition(std::size_t t_position) {
+        if (t_position > m_size) {
+            throw std::runtime_error("Attempting to move past the end of the snapshot! The snapshot is truncated or "
+                                     "corrupt.");
+        };
+        m_position = t_position;
+    };
+
+
+
+    // Write the header, living entities and their signatures, and then let each component write its data.
+    void AeEcsSnapshot::saveSnapshot(AeECS& t_ecs,
+                                     const std::string& t_filepath,
+                                     AeSnapshotAssetResolver* t_assetResolver) {
+        AeComponentManager& componentManager = t_ecs.m_ecsComponentManager;
+        AeEntityManager& entityManager = t_ecs.m_ecsEntityManager;
+
+        AeSnapshotWriter writer{t_assetResolver};
+
+        // Find the living entities.
+        std::vector<ecs_id> livingEntities;
+        for (ecs_id entityId = 0; entityId < t_ecs.getMaxNumEntities(); entityId++) {
+            if (entityManager.m_livingEntities[entityId]) {
+                livingEntities.push_back(entityId);
+            };
+        };
+
+        // Write the components in order of their ID so identical worlds produce identical snapshots.
+        std::vector<ecs_id> componentIds;
+        componentIds.reserve(componentManager.m_components.size());
+        for (auto& component: componentManager.m_components) {
+            componentIds.push_back(component.first);
+        };
+        std::sort(componentIds.begin(), componentIds.end());
+
+        EcsSnapshotHeader header{};
+        std::memcpy(header.m_magic, ECS_SNAPSHOT_MAGIC, sizeof(header.m_magic));
+        header.m_version = ECS_SNAPSHOT_VERSION;
+        header.m_maxNumComponents = MAX_NUM_COMPONENTS;
+        header.m_maxNumEntities = t_ecs.getMaxNumEntities();
+        header.m_numEntities = livingEntities.size();
+        header.m_numComponents = componentIds.size();
+        writer.write(header);
+
+        // Write the living entities along with their signatures, which include the enabled bit.
+        for (auto entityId: livingEntities) {
+            EcsSnapshotEntity snapshotEntity{entityId,
+                                             componentManager.m_entityComponentSignatures[entityId].to_ullong()};
+            writer.write(snapshotEntity);
+        };
+
+        // Let each component write its data for the living entities that use it.
+        std::vector<ecs_id> componentEntities;
+        componentEntities.reserve(livingEntities.size());
+        for (auto componentId: componentIds) {
+            componentEntities.clear();
+            for (auto entityId: livingEntities) {
+                if (componentManager.m_entityComponentSignatures[entityId].test(componentId)) {
+                    componentEntities.push_back(entityId);
+                };
+            };
+            componentManager.m_components[componentId]->saveSnapshotData(writer, componentEntities);
+        };
+
+        // Write the snapshot to the file with a single write.
+        std::FILE* file = std::fopen(t_filepath.c_str(), "wb");
+        if (file == nullptr) {
+            throw std::runtime_error("Failed to open snapshot file for writing: " + t_filepath);
+        };
+        std::size_t bytesWritten = std::fwrite(writer.getBuffer().data(), 1, writer.getSize(), file);
+        std::fclose(file);
+
+        if (bytesWritten != writer.getSize()) {
+            throw std::runtime_error("Failed to write the complete snapshot file: " + t_filepath);
+        };
+    };
+
+
+
+    // Map the file into memory and restore the ECS from it.
+    void AeEcsSnapshot::loadSnapshot(AeECS& t_ecs,
+                                     const std::string& t_filepath,
+                                     AeSnapshotAssetResolver* t_assetResolver) {
+        MappedSnapshotFile snapshotFile{t_filepath};
+        AeSnapshotReader reader{snapshotFile.getData(), snapshotFile.getSize(), t_assetResolver};
+        restoreSnapshot(t_ecs, reader);
+    };
+
+
+
+    // Validate the header and everything after it, and only then replace the living entities with the ones in the
+    // snapshot and let each component restore its data.
+    void AeEcsSnapshot::restoreSnapshot(AeECS& t_ecs, AeSnapshotReader& t_reader) {
+        AeComponentManager& componentManager = t_ecs.m_ecsComponentManager;
+        AeEntityManager& entityManager = t_ecs.m_ecsEntityManager;
+
+        auto header = t_reader.read<EcsSnapshotHeader>();
+        if (std::memcmp(header.m_magic, ECS_SNAPSHOT_MAGIC, sizeof(header.m_magic)) != 0) {
+            throw std::runtime_error("The file is not an ECS snapshot!");
+        };
+        if (header.m_version != ECS_SNAPSHOT_VERSION) {
+            throw std::runtime_error("The ECS snapshot version " + std::to_string(header.m_version) +
+                                     " is not supported!");
+        };
+        if (header.m_maxNumComponents != MAX_NUM_COMPONENTS || header.m_maxNumEntities != t_ecs.getMaxNumEntities()) {
+            throw std::runtime_error("The ECS snapshot was saved with different ECS limits!");
+        };
+
+        std::size_t entitiesOffset = t_reader.getPosition();
+        checkSnapshot(t_ecs, t_reader, header);
+        t_reader.setPosition(entitiesOffset);
+
+        // Destroy the current entities so the systems are informed they no longer exist.
+        entityManager.destroyAllEntities();
+
+        // Restore the living entities and their signatures.
+        std::vector<ecs_id> livingEntities;
+        livingEntities.reserve(header.m_numEntities);
+        for (std::uint64_t i = 0; i < header.m_numEntities; i++) {
+            auto snapshotEntity = t_reader.read<EcsSnapshotEntity>();
+            if (snapshotEntity.m_entityId >= t_ecs.getMaxNumEntities()) {
+                throw std::runtime_error("The ECS snapshot contains an invalid entity ID!");
+            };
+            livingEntities.push_back(snapshotEntity.m_entityId);
+            componentManager.setComponentSignature(snapshotEntity.m_entityId,
+                                                   std::bitset<MAX_NUM_COMPONENTS + 1>{snapshotEntity.m_signature});
+        };
+        entityManager.restoreEntities(livingEntities);
+
+        // Restore the component data.
+        for (std::uint64_t i = 0; i < header.m_numComponents; i++) {
+            auto componentHeader = t_reader.read<EcsSnapshotComponentHeader>();
+            std::size_t payloadOffset = t_reader.getPosition();
+
+            auto componentIterator = componentManager.m_components.find(componentHeader.m_componentId);
+            if (componentIterator == componentManager.m_components.end()) {
+                throw std::runtime_error("The ECS snapshot contains data for a component that does not exist!");
+            };
+
+            if (componentHeader.m_payloadLayout == ecsSnapshotPayloadLayout_notPersisted) {
+                // The component data could not be saved so the entities can not keep the component.
+                for (auto entityId: livingEntities) {
+                    std::bitset<MAX_NUM_COMPONENTS + 1> signature = componentManager.getComponentSignature(entityId);
+                    signature.reset(componentHeader.m_componentId);
+                    componentManager.setComponentSignature(entityId, signature);
+                };
+            } else {
+                componentIterator->second->loadSnapshotData(t_reader, componentHeader);
+            };
+
+            t_reader.setPosition(payloadOffset + componentHeader.m_payloadSize);
+        };
+
+        // Let the systems know about all the restored entities.
+        componentManager.allEntitiesComponentsUpdated();
+    };
+
+
+
+    // Every entity ID, component header and entity record is checked, the data inside a record is left to the
+    // component that reads it.
+    void AeEcsSnapshot::checkSnapshot(AeECS& t_ecs, AeSnapshotReader& t_reader, const EcsSnapshotHeader& t_header) {
+        AeComponentManager& componentManager = t_ecs.m_ecsComponentManager;
+
+        std::vector<bool> isEntityLiving(t_ecs.getMaxNumEntities(), false);
+        std::vector<std::uint64_t> entitySignatures(t_ecs.getMaxNumEntities(), 0);
+        for (std::uint64_t i = 0; i < t_header.m_numEntities; i++) {
+            auto snapshotEntity = t_reader.read<EcsSnapshotEntity>();
+            if (snapshotEntity.m_entityId >= t_ecs.getMaxNumEntities() || isEntityLiving[snapshotEntity.m_entityId]) {
+                throw std::runtime_error("The ECS snapshot contains an invalid entity ID!");
+            };
+            isEntityLiving[snapshotEntity.m_entityId] = true;
+            entitySignatures[snapshotEntity.m_entityId] = snapshotEntity.m_signature;
+        };
+
+        for (std::uint64_t i = 0; i < t_header.m_numComponents; i++) {
+            auto componentHeader = t_reader.read<EcsSnapshotComponentHeader>();
+            std::size_t payloadOffset = t_reader.getPosition();
+            if (componentHeader.m_payloadSize > t_reader.getSize() - payloadOffset) {
+                throw std::runtime_error("The ECS snapshot component data runs past the end of the snapshot! The "
+                                         "snapshot is truncated or corrupt.");
+            };
+            std::size_t payloadEnd = payloadOffset + componentHeader.m_payloadSize;
+
+            auto componentIterator = componentManager.m_components.find(componentHeader.m_componentId);
+            if (componentIterator == componentManager.m_components.end()) {
+                throw std::runtime_error("The ECS snapshot contains data for a component that does not exist!");
+            };
+            componentIterator->second->checkSnapshotHeader(componentHeader);
+
+            if (componentHeader.m_payloadLayout == ecsSnapshotPayloadLayout_entityRecords) {
+                auto numRecords = t_reader.read<std::uint64_t>();
+                for (std::uint64_t j = 0; j < numRecords; j++) {
+                    auto entityId = t_reader.read<std::uint64_t>();
+                    auto recordSize = t_reader.read<std::uint64_t>();
+                    if (entityId >= t_ecs.getMaxNumEntities() || !isEntityLiving[entityId] ||
+                        ((entitySignatures[entityId] >> componentHeader.m_componentId) & 1) == 0) {
+                        throw std::runtime_error("The ECS snapshot contains component data for an entity that is not "
+                                                 "living or does not use the component!");
+                    };
+                    if (t_reader.getPosition() > payloadEnd || recordSize > payloadEnd - t_reader.getPosition()) {
+                        throw std::runtime_error("The ECS snapshot component record runs past the end of the "
+                                                 "component data! The snapshot is corrupt.");
+                    };
+                    t_reader.skipBytes(recordSize);
+                };
+                if (t_reader.getPosition() > payloadEnd) {
+                    throw std::runtime_error("The ECS snapshot component records run past the end of the component "
+                                             "data! The snapshot is corrupt.");
+                };
+            };
+
+            t_reader.setPosition(payloadEnd);
+        };
+    };
+
+
+
+    // FNV-1a hash of the type name.
+    std::uint64_t AeEcsSnapshot::hashTypeName(const char* t_typeName) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const char* character = t_typeName; *character != '\0'; character++) {
+            hash ^= static_cast<std::uint8_t>(*character);
+            hash *= 1099511628211ull;
+        };
+        return hash;
+    };
+
+}
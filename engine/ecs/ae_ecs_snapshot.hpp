@@ -0,0 +1,306 @@
+/// \file ae_ecs_snapshot.hpp
+/// \brief The script defining the ECS snapshot classes.
+/// The binary snapshot format of the ECS, the readers and writers used by components to serialize their data, and the
+/// interface used to translate asset references into something that can be stored on disk are defined.
+#pragma once
+
+#include "ae_ecs_constants.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ae_ecs {
+
+    class AeECS;
+
+    /// The version of the snapshot format. Must be incremented whenever the layout written by AeEcsSnapshot changes.
+    static const std::uint32_t ECS_SNAPSHOT_VERSION = 1;
+
+    /// The identifier at the start of every snapshot file.
+    static const char ECS_SNAPSHOT_MAGIC[8] = {'A', 'E', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+    /// The header at the start of a snapshot file.
+    struct EcsSnapshotHeader {
+        char m_magic[8];
+        std::uint32_t m_version;
+        std::uint32_t m_maxNumComponents;
+        std::uint64_t m_maxNumEntities;
+        std::uint64_t m_numEntities;
+        std::uint64_t m_numComponents;
+    };
+
+    /// A living entity stored in a snapshot. The signature includes the enabled bit.
+    struct EcsSnapshotEntity {
+        std::uint64_t m_entityId;
+        std::uint64_t m_signature;
+    };
+
+    /// The header written before the data of each component in a snapshot.
+    struct EcsSnapshotComponentHeader {
+        /// The ID of the component the data belongs to.
+        std::uint64_t m_componentId;
+
+        /// A hash of the component data type used to ensure the data is restored into the same type of component.
+        std::uint64_t m_typeHash;
+
+        /// The size of a single element of the component data.
+        std::uint64_t m_elementSize;
+
+        /// The storage method of the component when the snapshot was taken.
+        std::uint32_t m_storageMethod;
+
+        /// The way the component data is laid out in the payload.
+        std::uint32_t m_payloadLayout;
+
+        /// The number of bytes of component data following this header.
+        std::uint64_t m_payloadSize;
+    };
+
+    /// The possible ways that the data of a component is laid out within a snapshot.
+    enum EcsSnapshotPayloadLayout : std::uint32_t {
+        /// The entire component data array is copied as is.
+        ecsSnapshotPayloadLayout_rawArray = 0,
+        /// The data is stored as a count followed by records of entity ID, record size, and record data.
+        ecsSnapshotPayloadLayout_entityRecords,
+        /// The component data could not be persisted, entities lose the component when the snapshot is loaded.
+        ecsSnapshotPayloadLayout_notPersisted
+    };
+
+
+
+    /// Translates the assets referenced by component data into paths that can be stored in a snapshot and loads them
+    /// back when the snapshot is restored. Implemented by whatever owns the assets, usually the resource manager.
+    /// Components reference assets by 32 bit handle values defined by the resolver, with 0 meaning no asset.
+    class AeSnapshotAssetResolver {
+    public:
+        virtual ~AeSnapshotAssetResolver() = default;
+
+        /// Gets the path that can be used to load the asset again.
+        /// \param t_assetType The type of the asset, defined by the resolver.
+        /// \param t_assetHandle The value of the handle to the asset being referenced.
+        /// \return The path of the asset.
+        virtual std::string getAssetPath(std::uint32_t t_assetType, std::uint32_t t_assetHandle) = 0;
+
+        /// Loads, or gets the already loaded, asset at the specified path.
+        /// \param t_assetType The type of the asset, defined by the resolver.
+        /// \param t_assetPath The path of the asset.
+        /// \return The value of the handle to the loaded asset.
+        virtual std::uint32_t loadAsset(std::uint32_t t_assetType, const std::string& t_assetPath) = 0;
+
+        /// Gets a name that identifies a sampler.
+        /// \param t_sampler The sampler handle.
+        /// \return The name of the sampler.
+        virtual std::string getSamplerName(const void* t_sampler) = 0;
+
+        /// Gets the sampler handle from the name of the sampler.
+        /// \param t_samplerName The name of the sampler.
+        /// \return The sampler handle.
+        virtual void* getSampler(const std::string& t_samplerName) = 0;
+    };
+
+
+
+    /// Writes the data of a snapshot into a contiguous buffer.
+    class AeSnapshotWriter {
+    public:
+        /// Creates a snapshot writer.
+        /// \param t_assetResolver Translates asset references into paths. May be nullptr if no assets are referenced.
+        explicit AeSnapshotWriter(AeSnapshotAssetResolver* t_assetResolver) : m_assetResolver{t_assetResolver} {};
+
+        /// Do not allow this class to be copied (2 lines below)
+        AeSnapshotWriter(const AeSnapshotWriter&) = delete;
+        AeSnapshotWriter& operator=(const AeSnapshotWriter&) = delete;
+
+        /// Appends bytes to the snapshot.
+        /// \param t_data The data to be written.
+        /// \param t_size The number of bytes to be written.
+        void writeBytes(const void* t_data, std::size_t t_size);
+
+        /// Overwrites bytes that have already been written, used to fill in sizes once they are known.
+        /// \param t_offset The offset into the snapshot to be overwritten.
+        /// \param t_data The data to be written.
+        /// \param t_size The number of bytes to be written.
+        void overwriteBytes(std::size_t t_offset, const void* t_data, std::size_t t_size);
+
+        /// Appends a trivially copyable value to the snapshot.
+        /// \tparam T The type of the value.
+        /// \param t_value The value to be written.
+        template<typename T>
+        void write(const T& t_value) {
+            static_assert(std::is_trivially_copyable<T>::value,"Only trivially copyable values can be written directly.");
+            writeBytes(&t_value, sizeof(T));
+        };
+
+        /// Appends a length prefixed string to the snapshot.
+        /// \param t_string The string to be written.
+        void writeString(const std::string& t_string);
+
+        /// Appends the path of an asset to the snapshot. A null handle is stored as an empty path.
+        /// \param t_assetType The type of the asset, defined by the resolver.
+        /// \param t_assetHandle The value of the handle to the asset to be referenced.
+        void writeAsset(std::uint32_t t_assetType, std::uint32_t t_assetHandle);
+
+        /// Appends the name of a sampler to the snapshot. A nullptr sampler is stored as an empty name.
+        /// \param t_sampler The sampler to be referenced.
+        void writeSampler(const void* t_sampler);
+
+        /// Gets the number of bytes written so far.
+        /// \return The size of the snapshot in bytes.
+        [[nodiscard]] std::size_t getSize() const { return m_buffer.size(); };
+
+        /// Gets the snapshot data.
+        /// \return The buffer the snapshot has been written to.
+        [[nodiscard]] const std::vector<std::uint8_t>& getBuffer() const { return m_buffer; };
+
+    private:
+
+        /// The buffer the snapshot is written into.
+        std::vector<std::uint8_t> m_buffer;
+
+        /// Translates asset references into paths.
+        AeSnapshotAssetResolver* m_assetResolver;
+
+    protected:
+
+    };
+
+
+
+    /// Reads the data of a snapshot from a contiguous buffer, usually a memory mapped file.
+    class AeSnapshotReader {
+    public:
+        /// Creates a snapshot reader.
+        /// \param t_data The start of the snapshot data.
+        /// \param t_size The size of the snapshot data in bytes.
+        /// \param t_assetResolver Loads the assets referenced by the snapshot. May be nullptr if no assets are
+        /// referenced.
+        AeSnapshotReader(const std::uint8_t* t_data, std::size_t t_size, AeSnapshotAssetResolver* t_assetResolver) :
+                m_data{t_data},
+                m_size{t_size},
+                m_assetResolver{t_assetResolver} {};
+
+        /// Do not allow this class to be copied (2 lines below)
+        AeSnapshotReader(const AeSnapshotReader&) = delete;
+        AeSnapshotReader& operator=(const AeSnapshotReader&) = delete;
+
+        /// Copies bytes out of the snapshot.
+        /// \param t_destination Where the bytes are to be copied to.
+        /// \param t_size The number of bytes to be copied.
+        void readBytes(void* t_destination, std::size_t t_size);
+
+        /// Skips over bytes in the snapshot without copying them.
+        /// \param t_size The number of bytes to skip.
+        /// \return A pointer to the start of the bytes skipped.
+        const std::uint8_t* skipBytes(std::size_t t_size);
+
+        /// Reads a trivially copyable value from the snapshot.
+        /// \tparam T The type of the value.
+        /// \return The value read.
+        template<typename T>
+        T read() {
+            static_assert(std::is_trivially_copyable<T>::value,"Only trivially copyable values can be read directly.");
+            T value;
+            readBytes(&value, sizeof(T));
+            return value;
+        };
+
+        /// Reads a length prefixed string from the snapshot.
+        /// \return The string read.
+        std::string readString();
+
+        /// Reads an asset path from the snapshot and loads the asset it refers to.
+        /// \tparam THandle The type of the handle to the asset, which must be creatable with THandle::fromValue.
+        /// \param t_assetType The type of the asset, defined by the resolver.
+        /// \return The handle to the loaded asset, a null handle if no asset was referenced.
+        template<typename THandle>
+        THandle readAsset(std::uint32_t t_assetType) {
+            return THandle::fromValue(readAssetHandle(t_assetType));
+        };
+
+        /// Reads a sampler name from the snapshot and gets the sampler it refers to.
+        /// \return The sampler, nullptr if no sampler was referenced.
+        void* readSampler();
+
+        /// Gets the current read position in the snapshot.
+        /// \return The read position in bytes.
+        [[nodiscard]] std::size_t getPosition() const { return m_position; };
+
+        /// Gets the size of the snapshot.
+        /// \return The size of the snapshot in bytes.
+        [[nodiscard]] std::size_t getSize() const { return m_size; };
+
+        /// Sets the read position in the snapshot.
+        /// \param t_position The new read position in bytes.
+        void setPosition(std::size_t t_position);
+
+    private:
+
+        /// Reads an asset path and loads the asset without regard to the type of its handle.
+        std::uint32_t readAssetHandle(std::uint32_t t_assetType);
+
+        /// The start of the snapshot data.
+        const std::uint8_t* m_data;
+
+        /// The size of the snapshot data in bytes.
+        std::size_t m_size;
+
+        /// The current read position.
+        std::size_t m_position = 0;
+
+        /// Loads the assets referenced by the snapshot.
+        AeSnapshotAssetResolver* m_assetResolver;
+
+    protected:
+
+    };
+
+
+
+    /// Saves and restores the entities and component data of an ECS.
+    class AeEcsSnapshot {
+    public:
+
+        /// Writes the living entities, their signatures, and the data of every component to a file.
+        /// \param t_ecs The ECS to be saved.
+        /// \param t_filepath The file the snapshot will be written to.
+        /// \param t_assetResolver Translates asset references into paths. May be nullptr if no assets are referenced.
+        static void saveSnapshot(AeECS& t_ecs,
+                                 const std::string& t_filepath,
+                                 AeSnapshotAssetResolver* t_assetResolver = nullptr);
+
+        /// Destroys all the entities of the ECS and replaces them with the entities in a snapshot file. Every restored
+        /// entity is flagged as updated for the systems it is compatible with.
+        /// \param t_ecs The ECS to be restored.
+        /// \param t_filepath The file the snapshot will be read from.
+        /// \param t_assetResolver Loads the assets referenced by the snapshot. May be nullptr if no assets are
+        /// referenced.
+        static void loadSnapshot(AeECS& t_ecs,
+                                 const std::string& t_filepath,
+                                 AeSnapshotAssetResolver* t_assetResolver = nullptr);
+
+        /// Creates a hash for a component type so snapshots are only restored into the component they were taken from.
+        /// \param t_typeName The name of the type.
+        /// \return The hash of the type name.
+        static std::uint64_t hashTypeName(const char* t_typeName);
+
+    private:
+
+        /// Restores the ECS from snapshot data that has already been loaded into memory.
+        static void restoreSnapshot(AeECS& t_ecs, AeSnapshotReader& t_reader);
+
+        /// Reads the living entities and the component data of a snapshot without restoring any of it, throwing if any
+        /// of it can not be restored into the ECS.
+        /// \param t_ecs The ECS the snapshot is to be restored into.
+        /// \param t_reader The reader positioned just after the snapshot header.
+        /// \param t_header The snapshot header.
+        static void checkSnapshot(AeECS& t_ecs, AeSnapshotReader& t_reader, const EcsSnapshotHeader& t_header);
+
+    protected:
+
+    };
+
+}
@@ -0,0 +1,154 @@
+/// \file ae_ecs_stats.cpp
+/// \brief The script implementing the ECS statistics.
+/// The collection of the ECS statistics and their conversion to JSON are implemented.
+#include "ae_ecs_stats.hpp"
+#include "ae_ecs.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace ae_ecs {
+
+    namespace {
+
+        /// Escapes the characters of a string that are not allowed within a JSON string. Control characters without a
+        /// short escape are written as \u00XX.
+        std::string escapeJsonString(const std::string& t_string) {
+            static const char hexDigits[] = "0123456789abcdef";
+            std::string escapedString;
+            escapedString.reserve(t_string.size());
+            for (char character: t_string) {
+                switch (character) {
+                    case '"': escapedString += "\\\""; break;
+                    case '\\': escapedString += "\\\\"; break;
+                    case '\n': escapedString += "\\n"; break;
+                    case '\t': escapedString += "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(character) < 0x20) {
+                            escapedString += "\\u00";
+                            escapedString += hexDigits[static_cast<unsigned char>(character) >> 4];
+                            escapedString += hexDigits[static_cast<unsigned char>(character) & 0xF];
+                        } else {
+                            escapedString += character;
+                        };
+                        break;
+                };
+            };
+            return escapedString;
+        };
+    }
+
+
+
+    // Write each statistic as a JSON member, components and systems as arrays of objects.
+    std::string AeEcsStats::toJson() const {
+        std::ostringstream json;
+
+        json << "{\n";
+        json << "  \"entities\": {\n";
+        json << "    \"max\": " << m_maxNumEntities << ",\n";
+        json << "    \"living\": " << m_numLivingEntities << ",\n";
+        json << "    \"enabled\": " << m_numEnabledEntities << ",\n";
+        json << "    \"available\": " << m_maxNumEntities - m_numLivingEntities << ",\n";
+        json << "    \"idHighWaterMark\": " << m_entityIdHighWaterMark << "\n";
+        json << "  },\n";
+
+        json << "  \"components\": {\n";
+        json << "    \"max\": " << m_maxNumComponents << ",\n";
+        json << "    \"count\": " << m_components.size() << ",\n";
+        json << "    \"list\": [";
+        for (std::size_t i = 0; i < m_components.size(); i++) {
+            const AeComponentStats& component = m_components[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "      {\"id\": " << component.m_componentId
+                 << ", \"dataType\": \"" << escapeJsonString(component.m_dataTypeName) << "\""
+                 << ", \"storageMethod\": \"" << component.m_storageMethod << "\""
+                 << ", \"elementSize\": " << component.m_elementSize
+                 << ", \"bytesReserved\": " << component.m_bytesReserved
+                 << ", \"bytesUsed\": " << component.m_bytesUsed
+                 << ", \"entityCount\": " << component.m_entityCount << "}";
+        };
+        json << "\n    ]\n";
+        json << "  },\n";
+
+        json << "  \"systems\": {\n";
+        json << "    \"max\": " << m_maxNumSystems << ",\n";
+        json << "    \"count\": " << m_systems.size() << ",\n";
+        json << "    \"list\": [";
+        for (std::size_t i = 0; i < m_systems.size(); i++) {
+            const AeSystemStats& system = m_systems[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "      {\"id\": " << system.m_systemId
+                 << ", \"systemType\": \"" << escapeJsonString(system.m_systemTypeName) << "\""
+                 << ", \"isChildSystem\": " << (system.m_isChildSystem ? "true" : "false")
+                 << ", \"executionInterval\": " << system.m_executionInterval
+                 << ", \"matchingEntityCount\": " << system.m_matchingEntityCount
+                 << ", \"updatedEntityCount\": " << system.m_updatedEntityCount
+                 << ", \"destroyedEntityCount\": " << system.m_destroyedEntityCount
+                 << ", \"lastExecutionTimeMs\": " << system.m_lastExecutionTimeMs << "}";
+        };
+        json << "\n    ]\n";
+        json << "  }\n";
+        json << "}\n";
+
+        return json.str();
+    };
+
+
+
+    // Write the JSON document to the file.
+    void AeEcsStats::writeJson(const std::string& t_filepath) const {
+        std::ofstream file{t_filepath};
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open ECS statistics file for writing: " + t_filepath);
+        };
+        file << toJson();
+    };
+
+
+
+    // Demangle the name with the compiler ABI when it is available.
+    std::string AeEcsStats::demangleTypeName(const char* t_typeIdName) {
+#if defined(__GNUG__)
+        int status = 0;
+        char* demangledName = abi::__cxa_demangle(t_typeIdName, nullptr, nullptr, &status);
+        if (status == 0 && demangledName != nullptr) {
+            std::string typeName{demangledName};
+            std::free(demangledName);
+            return typeName;
+        };
+#endif
+        return t_typeIdName;
+    };
+
+
+
+    // Gather the entity counts and ask the component and system managers for their statistics.
+    AeEcsStats AeECS::getStats() {
+        AeEcsStats stats{};
+        stats.m_maxNumEntities = getMaxNumEntities();
+
+        bool* livingEntities = m_ecsEntityManager.getEnabledEntities();
+        for (ecs_id entityId = 0; entityId < stats.m_maxNumEntities; entityId++) {
+            if (livingEntities[entityId]) {
+                stats.m_numLivingEntities++;
+                stats.m_entityIdHighWaterMark = entityId + 1;
+                if (m_ecsComponentManager.getComponentSignature(entityId).test(MAX_NUM_COMPONENTS)) {
+                    stats.m_numEnabledEntities++;
+                };
+            };
+        };
+
+        stats.m_components = m_ecsComponentManager.getComponentStats();
+        stats.m_systems = m_ecsSystemManager.getSystemStats();
+
+        return stats;
+    };
+
+}
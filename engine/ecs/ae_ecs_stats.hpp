@@ -0,0 +1,109 @@
+/// \file ae_ecs_stats.hpp
+/// \brief The script defining the ECS statistics structures.
+/// The structures reporting the memory used by components, the work done by systems, and how full the ID pools of
+/// the ECS are defined. Used to size the ECS limits and allocators for production scenes.
+#pragma once
+
+#include "ae_ecs_constants.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ae_ecs {
+
+    /// Statistics of a single component.
+    struct AeComponentStats {
+        /// The ID of the component.
+        ecs_id m_componentId = 0;
+
+        /// The name of the type of data the component stores.
+        std::string m_dataTypeName;
+
+        /// The name of the storage method the component uses.
+        std::string m_storageMethod;
+
+        /// The size of the data stored for a single entity.
+        std::size_t m_elementSize = 0;
+
+        /// The number of bytes the component has reserved for its data. For map storage this is an estimate that
+        /// includes the buckets and node overhead.
+        std::size_t m_bytesReserved = 0;
+
+        /// The number of bytes used by the entities that use the component.
+        std::size_t m_bytesUsed = 0;
+
+        /// The number of entities that use the component.
+        std::size_t m_entityCount = 0;
+    };
+
+    /// Statistics of a single system.
+    struct AeSystemStats {
+        /// The ID of the system.
+        ecs_id m_systemId = 0;
+
+        /// The name of the type of the system.
+        std::string m_systemTypeName;
+
+        /// True if the system is executed by a parent system instead of the system manager.
+        bool m_isChildSystem = false;
+
+        /// The number of ticks the system waits between executions.
+        ecs_systemInterval m_executionInterval = 0;
+
+        /// The number of enabled entities compatible with the system.
+        std::size_t m_matchingEntityCount = 0;
+
+        /// The number of entities waiting in the system's updated list.
+        std::size_t m_updatedEntityCount = 0;
+
+        /// The number of entities waiting in the system's destroyed list.
+        std::size_t m_destroyedEntityCount = 0;
+
+        /// The time the last execution of the system took, including setup and cleanup, in milliseconds. Child systems
+        /// are timed as part of their parent and report 0.
+        double m_lastExecutionTimeMs = 0.0;
+    };
+
+    /// Statistics of an ECS.
+    struct AeEcsStats {
+        /// The maximum number of entities that can exist.
+        std::size_t m_maxNumEntities = 0;
+
+        /// The number of entities that currently exist.
+        std::size_t m_numLivingEntities = 0;
+
+        /// The number of entities that currently exist and are enabled.
+        std::size_t m_numEnabledEntities = 0;
+
+        /// The highest entity ID currently in use plus one, compare to the number of living entities to see how
+        /// fragmented the entity IDs are.
+        std::size_t m_entityIdHighWaterMark = 0;
+
+        /// The maximum number of components that can exist.
+        std::size_t m_maxNumComponents = MAX_NUM_COMPONENTS;
+
+        /// The maximum number of systems that can exist.
+        std::size_t m_maxNumSystems = MAX_NUM_SYSTEMS;
+
+        /// The statistics of each component.
+        std::vector<AeComponentStats> m_components;
+
+        /// The statistics of each enabled system.
+        std::vector<AeSystemStats> m_systems;
+
+        /// Converts the statistics to a JSON document.
+        /// \return The statistics as JSON.
+        [[nodiscard]] std::string toJson() const;
+
+        /// Writes the statistics to a file as a JSON document.
+        /// \param t_filepath The file the statistics will be written to.
+        void writeJson(const std::string& t_filepath) const;
+
+        /// Gets a readable name for a type from the name provided by typeid.
+        /// \param t_typeIdName The name provided by typeid.
+        /// \return The demangled name when available, otherwise the name provided.
+        static std::string demangleTypeName(const char* t_typeIdName);
+    };
+
+}
@@ -8,8 +8,10 @@
 namespace ae_ecs {
 
     // Create the component manager and initialize the entity ID stack.
-    AeEntityManager::AeEntityManager(AeComponentManager& t_componentManager) : m_componentManager{t_componentManager} {
-        m_livingEntities = new bool[MAX_NUM_ENTITIES]();
+    AeEntityManager::AeEntityManager(AeComponentManager& t_componentManager) :
+        m_entityIds{t_componentManager.getMaxNumEntities()},
+        m_componentManager{t_componentManager} {
+        m_livingEntities = new bool[m_entityIds.size()]();
     };
 
 
@@ -22,21 +24,21 @@ namespace ae_ecs {
 
 
 
-    // Release the entity ID by incrementing the top of stack pointer and putting the entity ID being released
-    // at that location.
+    // Release the entity ID back to the ID allocator. The entity stops living before its ID can be given to another.
     void AeEntityManager::unRegisterEntity(ecs_id t_entityId) {
-        m_entityIdStack.push(t_entityId);
         m_livingEntities[t_entityId] = false;
+        m_entityIds.free(t_entityId);
     };
 
 
 
-    // Allocate an entity ID by popping the entity ID off the stack, indicated by the top of stack pointer, then
-    // decrementing the top of stack pointer to point to the next available entity ID.
+    // Allocate the lowest entity ID that is not in use, or one close to it while other threads also register entities.
     ecs_id AeEntityManager::registerEntity() {
-        // Get the new entity ID being allocated from the top of the stack and add the popped entity ID to the living
-        // entities array then decrement the stack counter.
-        ecs_id allocatedId = m_entityIdStack.pop();
+        ecs_id allocatedId = m_entityIds.allocate();
+        if(allocatedId == m_entityIds.npos){
+            throw std::runtime_error("No more entity IDs to give out! The maximum number of entities already exist.");
+        };
+
         m_livingEntities[allocatedId] = true;
         return allocatedId;
     };
@@ -63,9 +65,9 @@ namespace ae_ecs {
         unRegisterEntity(t_entityId);
     };
 
-    //
+    // Destroy every living entity.
     void AeEntityManager::destroyAllEntities(){
-        for(ecs_id entityId=0; entityId<MAX_NUM_ENTITIES;entityId++){
+        for(ecs_id entityId=0; entityId<m_entityIds.size();entityId++){
             if(m_livingEntities[entityId]){
                 destroyEntity(entityId);
             };
@@ -74,6 +76,70 @@ namespace ae_ecs {
 
 
 
+    // Mark the entities as living and take their IDs from the ID allocator.
+    void AeEntityManager::restoreEntities(const std::vector<ecs_id>& t_entityIds){
+        for(ecs_id entityId=0; entityId<m_entityIds.size();entityId++){
+            if(m_livingEntities[entityId]){
+                throw std::runtime_error("Entities can only be restored when no other entities are living!");
+            };
+        };
+
+        // IDs sitting in the thread caches of the allocator count as taken, so they are returned first.
+        m_entityIds.flushThreadCaches();
+        for(auto entityId : t_entityIds){
+            if(entityId >= m_entityIds.size()){
+                throw std::runtime_error("Attempting to restore an entity ID larger than the maximum number of entities!");
+            };
+            m_livingEntities[entityId] = true;
+            m_entityIds.claim(entityId);
+        };
+    };
+
+
+
+    // Repeatedly move the entity with the highest ID into the lowest free ID.
+    std::vector<EntityIdMove> AeEntityManager::compactEntityIds(std::size_t t_maxMoves,
+                                                                const std::vector<ecs_id>& t_pendingEntityIds){
+        // IDs that systems still have to clean up can not be given to another entity yet.
+        ae::HierarchicalBitset allocatedEntityIds = m_entityIds.getAllocatedIds();
+        ae::HierarchicalBitset unavailableEntityIds = allocatedEntityIds;
+        for(auto entityId : t_pendingEntityIds){
+            unavailableEntityIds.set(entityId);
+        };
+
+        std::vector<EntityIdMove> entityIdMoves;
+        while(entityIdMoves.size() < t_maxMoves){
+            ecs_id highestEntityId = allocatedEntityIds.findLastSet();
+            ecs_id lowestFreeEntityId = unavailableEntityIds.findFirstZero();
+
+            // Done once there are no free IDs below the highest living entity.
+            if(highestEntityId == allocatedEntityIds.npos || lowestFreeEntityId >= highestEntityId){
+                break;
+            };
+
+            allocatedEntityIds.reset(highestEntityId);
+            allocatedEntityIds.set(lowestFreeEntityId);
+            unavailableEntityIds.set(lowestFreeEntityId);
+            m_livingEntities[highestEntityId] = false;
+            m_livingEntities[lowestFreeEntityId] = true;
+            m_entityIds.claim(lowestFreeEntityId);
+            m_entityIds.freeToBitset(highestEntityId);
+
+            entityIdMoves.push_back({highestEntityId, lowestFreeEntityId});
+        };
+
+        return entityIdMoves;
+    };
+
+
+
+    // The IDs that are not allocated are available.
+    ecs_id AeEntityManager::getNumEntitiesAvailable(){
+        return m_entityIds.size() - m_entityIds.getNumAllocated();
+    };
+
+
+
     // Returns the variable that tracks the number of living entities.
     bool* AeEntityManager::getEnabledEntities() { return m_livingEntities; };
 }
\ No newline at end of file
@@ -5,16 +5,21 @@
 
 #include "ae_ecs_constants.hpp"
 #include "ae_component_manager.hpp"
-#include "pre_allocated_stack.hpp"
+#include "concurrent_id_allocator.hpp"
+#include "hierarchical_bitset.hpp"
 
 #include <cstdint>
 #include <stack>
+#include <vector>
 
 namespace ae_ecs {
 
-    /// A class that is used to register and track entities.
-    //TODO make maximum number of allowed entities could be based off hardware and user settings
+    /// A class that is used to register and track entities. The number of entity IDs available is the maximum number
+    /// of entities of the component manager, which comes from the engine limits. Entity IDs are given out and taken
+    /// back through a lock free ID allocator, so worker threads such as chunk loaders or particle emitters can register
+    /// and unregister entities at the same time as each other without a global lock.
 	class AeEntityManager {
+        friend class AeEcsSnapshot;
 
 		/// Entity type ID counter variable
 		static inline ecs_id entityTypeIdCount = 0;
@@ -28,11 +33,13 @@ namespace ae_ecs {
         /// Destroy the entity manager.
 		~AeEntityManager();
 
-        /// Retract the ID from an entity and put it back on top of the stack.
+        /// Retract the ID from an entity so it can be given out again. Safe to call from several threads at once.
         /// \param t_entityId The entity ID to be released.
 		void unRegisterEntity(ecs_id t_entityId);
 
-        /// Assign an entity ID by taking the next available off the stack.
+        /// Assign the lowest entity ID that is not currently in use, or while other threads register and unregister
+        /// entities at the same time, one close to it. Handing out low IDs keeps the living entities packed together
+        /// so entity indexed storage is iterated with good locality. Safe to call from several threads at once.
         /// \return A entity ID.
 		ecs_id registerEntity();
 
@@ -47,8 +54,7 @@ namespace ae_ecs {
         /// Destroys an entity and ensures to clean everything up
         void destroyEntity(ecs_id t_entityId);
 
-        /// Gets the number of entities that have not been allocated from the stack and are therefore available for
-        /// use.
+        /// Gets the number of entity IDs that have not been allocated and are therefore available for use.
         /// \return Number of entities still available to be used.
 		ecs_id getNumEntitiesAvailable();
 
@@ -70,10 +76,24 @@ namespace ae_ecs {
         /// Destroys all the entities tracked by this entity manager.
         void destroyAllEntities();
 
+        /// Marks the specified entity IDs as living and takes them from the entity ID allocator. Used when restoring a
+        /// snapshot, all entities must have been destroyed beforehand and no other thread may be registering entities.
+        /// \param t_entityIds The IDs of the entities to be restored.
+        void restoreEntities(const std::vector<ecs_id>& t_entityIds);
+
+        /// Renumbers living entities into the lowest free IDs, moving the entity with the highest ID first, until the
+        /// living entities occupy a dense prefix of the ID range or the maximum number of moves has been made. IDs that
+        /// are still waiting to be cleaned up by a system are not reused. No other thread may be registering or
+        /// unregistering entities.
+        /// \param t_maxMoves The maximum number of entities to renumber, allows compaction to be spread out.
+        /// \param t_pendingEntityIds The IDs that systems have not finished cleaning up yet.
+        /// \return The entities that were renumbered.
+        std::vector<EntityIdMove> compactEntityIds(std::size_t t_maxMoves, const std::vector<ecs_id>& t_pendingEntityIds);
+
 	private:
 
-        /// The entity ID stack.
-        ae::PreAllocatedStack<ecs_id,MAX_NUM_ENTITIES> m_entityIdStack{};
+        /// Gives out the entity IDs and tracks which are currently allocated.
+        ae::ConcurrentIdAllocator m_entityIds;
 
 		/// Tracks which entities are currently "still alive"
 		bool* m_livingEntities;
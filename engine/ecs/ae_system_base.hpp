@@ -10,6 +10,7 @@
 #include <cstdint>
 #include <vector>
 #include <array>
+#include <map>
 
 
 namespace ae_ecs {
@@ -83,6 +84,26 @@ namespace ae_ecs {
         /// this function.
         virtual void cleanupSystem(){};
 
+        /// Informs the system that entities have been renumbered when the entity IDs were compacted. Systems that store
+        /// entity IDs outside the ECS must override this and update them.
+        /// \param t_entityIdMoves The entities that have been renumbered.
+        virtual void remapEntityIds([[maybe_unused]] const std::vector<EntityIdMove>& t_entityIdMoves){};
+
+        /// Renames the keys of a map keyed by entity ID for the entities that have been renumbered.
+        /// \tparam V The type of the values of the map.
+        /// \param t_entityMap The map to be updated.
+        /// \param t_entityIdMoves The entities that have been renumbered.
+        template<typename V>
+        static void remapEntityIdKeys(std::map<ecs_id, V>& t_entityMap, const std::vector<EntityIdMove>& t_entityIdMoves){
+            for (auto& entityIdMove: t_entityIdMoves) {
+                auto entityNode = t_entityMap.extract(entityIdMove.m_oldId);
+                if (!entityNode.empty()) {
+                    entityNode.key() = entityIdMove.m_newId;
+                    t_entityMap.insert(std::move(entityNode));
+                };
+            };
+        };
+
     private:
 
 
@@ -96,6 +117,9 @@ namespace ae_ecs {
         /// Counter that keeps track of how many cycles have past since it was last run.
         ecs_systemInterval m_cyclesSinceExecution = 0;
 
+        /// The time the last execution of the system took, including setup and cleanup, in milliseconds.
+        double m_lastExecutionTimeMs = 0.0;
+
         /// Flag that indicates that the system should not be executed by the system manager and will be handled by a
         /// parent system.
         bool isChildSystem = false;
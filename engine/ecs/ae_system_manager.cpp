@@ -2,6 +2,8 @@
 /// \brief The script implementing the system manager class.
 /// The system manager class is implemented.
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include "ae_system_manager.hpp"
 #include "ae_system_base.hpp"
 
@@ -114,15 +116,15 @@ namespace ae_ecs {
         m_systemIdStack.push(t_system->m_systemId);
     };
 
-    std::vector<ecs_id> AeSystemManager::getEnabledSystemsEntities(ecs_id t_systemId){
+    ecs_entityList AeSystemManager::getEnabledSystemsEntities(ecs_id t_systemId){
         return m_componentManager.getEnabledSystemsEntities(t_systemId);
     };
 
-    std::vector<ecs_id> AeSystemManager::getUpdatedSystemEntities(ecs_id t_systemId){
+    ecs_entityList AeSystemManager::getUpdatedSystemEntities(ecs_id t_systemId){
         return m_componentManager.getUpdatedSystemEntities(t_systemId);
     };
 
-    std::vector<ecs_id> AeSystemManager::getDestroyedSystemEntities(ecs_id t_systemId){
+    ecs_entityList AeSystemManager::getDestroyedSystemEntities(ecs_id t_systemId){
         return m_componentManager.getDestroyedSystemEntities(t_systemId);
     };
 
@@ -228,9 +230,12 @@ namespace ae_ecs {
             if(!m_System->isChildSystem) {
                 // Check to see if this system is ready to be run again.
                 if (m_System->m_cyclesSinceExecution >= m_System->m_executionInterval) {
+                    auto executionStartTime = std::chrono::steady_clock::now();
                     m_System->setupSystem();
                     m_System->executeSystem();
                     m_System->cleanupSystem();
+                    m_System->m_lastExecutionTimeMs = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - executionStartTime).count();
                     m_System->m_cyclesSinceExecution = 0;
                 } else {
                     m_System->m_cyclesSinceExecution++;
@@ -240,9 +245,46 @@ namespace ae_ecs {
     };
 
 
+    // Combine the timing stored in each system with the entity counts held by the component manager. The counts are
+    // taken without building the entity lists, which would fill the frame arena the systems already ran out of.
+    std::vector<AeSystemStats> AeSystemManager::getSystemStats(){
+        std::vector<AeSystemStats> systemStats;
+        systemStats.reserve(m_enabledSystems.size());
+
+        for(const auto& [systemId , system] : m_enabledSystems ) {
+            AeSystemStats stats{};
+            stats.m_systemId = systemId;
+            stats.m_systemTypeName = AeEcsStats::demangleTypeName(typeid(*system).name());
+            stats.m_isChildSystem = system->isChildSystem;
+            stats.m_executionInterval = system->m_executionInterval;
+            stats.m_matchingEntityCount = m_componentManager.getNumEnabledSystemEntities(systemId);
+            stats.m_updatedEntityCount = m_componentManager.getNumUpdatedSystemEntities(systemId);
+            stats.m_destroyedEntityCount = m_componentManager.getNumDestroyedSystemEntities(systemId);
+            stats.m_lastExecutionTimeMs = system->m_lastExecutionTimeMs;
+            systemStats.push_back(stats);
+        };
+
+        std::sort(systemStats.begin(), systemStats.end(),
+                  [](const AeSystemStats& t_a, const AeSystemStats& t_b){
+                      return t_a.m_systemId < t_b.m_systemId;
+                  });
+        return systemStats;
+    };
+
+
+
+    // Let every enabled system update the entity IDs it stores.
+    void AeSystemManager::remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves){
+        for(const auto& [systemId , system] : m_enabledSystems ) {
+            system->remapEntityIds(t_entityIdMoves);
+        };
+    };
+
+
+
     // Call the component manager's function to get the entities that contain the desired required and optional components.
-    std::vector<ecs_id> AeSystemManager::getEntitiesWithSpecifiedComponents(std::vector<ecs_id>& t_entityIds,
-                                                                            std::vector<ecs_id>& t_optionalComponentIds){
+    ecs_entityList AeSystemManager::getEntitiesWithSpecifiedComponents(const ecs_entityList& t_entityIds,
+                                                                       std::vector<ecs_id>& t_optionalComponentIds){
         return m_componentManager.getEntitiesWithSpecifiedComponents(t_entityIds,t_optionalComponentIds);
     };
 }
\ No newline at end of file
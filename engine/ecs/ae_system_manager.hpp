@@ -5,6 +5,7 @@
 
 #include "ae_ecs_constants.hpp"
 #include "ae_component_manager.hpp"
+#include "ae_ecs_stats.hpp"
 #include "pre_allocated_stack.hpp"
 
 #include <cstdint>
@@ -72,22 +73,22 @@ namespace ae_ecs {
 
         /// Get the entities that a system may act upon from the component manager.
         /// \param
-        std::vector<ecs_id> getEnabledSystemsEntities(ecs_id t_systemId);
+        ecs_entityList getEnabledSystemsEntities(ecs_id t_systemId);
 
         /// Returns a list of enabled, compatible, entities that the system is to utilize that have had data been updated since the
         /// last system run loop.
         /// \param t_systemId The ID of the system to be removed.
-        std::vector<ecs_id> getUpdatedSystemEntities(ecs_id t_systemId);
+        ecs_entityList getUpdatedSystemEntities(ecs_id t_systemId);
 
         /// Returns a list of entities that have been destroyed since the system last ran.
         /// \param t_systemId The ID of the system to be removed.
-        std::vector<ecs_id> getDestroyedSystemEntities(ecs_id t_systemId);
+        ecs_entityList getDestroyedSystemEntities(ecs_id t_systemId);
 
         /// Returns a list of entity IDs that use one, or more, of the optional components provided.
         /// \param t_entityIds The entities to be check to see if they contain the optional component IDs.
         /// \param t_optionalComponentIds The optional components that the entities must have one or more of to be
         /// included in the returned vector.
-        std::vector<ecs_id> getEntitiesWithSpecifiedComponents(std::vector<ecs_id>& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds);
+        ecs_entityList getEntitiesWithSpecifiedComponents(const ecs_entityList& t_entityIds, std::vector<ecs_id>& t_optionalComponentIds);
 
         /// Orders the currently enabled systems to ensure they are executed in the proper order.
         void orderSystems();
@@ -95,6 +96,14 @@ namespace ae_ecs {
         /// Runs the systems that are managed by this system manager
         void runSystems();
 
+        /// Collects the statistics of every enabled system, including child systems.
+        /// \return The statistics of the systems ordered by system ID.
+        std::vector<AeSystemStats> getSystemStats();
+
+        /// Informs the enabled systems, including child systems, that entities have been renumbered.
+        /// \param t_entityIdMoves The entities that have been renumbered.
+        void remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves);
+
     private:
 
         /// System ID stack and a counter used for the stack
@@ -8,12 +8,14 @@
 #include "ae_engine_constants.hpp"
 #include "ae_image.hpp"
 #include "pre_allocated_stack.hpp"
+#include "dense_slot_table.hpp"
 
 // libraries
 
 //std
 #include <map>
 #include <memory>
+#include <vector>
 
 
 namespace ae {
@@ -74,11 +76,11 @@ namespace ae {
         /// updated and/or entities that have been removed or had this material layer removed.
         /// \param t_entity3DSSBOData The model matrix and texture indices data for an entity that is in the 3D-SSBO
         /// that will be accessed by the material layer shaders when rendering.
-        /// \param t_entity3DSSBOMap The map of where entities data are within the 3D-SSBO.
+        /// \param t_entity3DSSBOTable Where the entities data are within the 3D-SSBO.
         /// \param t_imageBuffer The buffer that stores the images and their samplers that will be accessed by the
         /// material layer shaders when rendering.
-        /// \param t_imageBufferMap The map of images and their samplers and which entities use them with which
-        /// materials.
+        /// \param t_imageBufferMap The images and their samplers and which entities use them with which materials,
+        /// indexed by the index of the image handle.
         /// \param t_imageBufferStack The stack of available positions within the imageBufferMap where new images
         /// can be placed. When no entities utilize a specific image the image's position within the imageBufferMap
         /// is placed at the top of this stack.
@@ -86,9 +88,9 @@ namespace ae {
         /// that the drawIndexedIndirectCommands required for this material layer will start. This position will be
         /// required when executing the drawIndexedIndirect commands for this material.
         virtual const std::vector<VkDrawIndexedIndirectCommand>& updateMaterialLayerEntities(std::vector<Entity3DSSBOData>& t_entity3DSSBOData,
-                                                                                             std::map<ecs_id, uint32_t>& t_entity3DSSBOMap,
+                                                                                             const DenseSlotTable& t_entity3DSSBOTable,
                                                                                              VkDescriptorImageInfo t_imageBuffer[MAX_TEXTURES],
-                                                                                             std::map<std::shared_ptr<AeImage>,ImageBufferInfo>& t_imageBufferMap,
+                                                                                             std::vector<ImageBufferInfo>& t_imageBufferMap,
                                                                                              PreAllocatedStack<uint64_t,MAX_TEXTURES>& t_imageBufferStack,
                                                                                              uint64_t t_drawIndexedIndirectCommandBufferIndex)=0;
 
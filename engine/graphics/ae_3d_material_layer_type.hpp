@@ -9,6 +9,7 @@
 #include "ae_3d_material_layer_base.hpp"
 #include "game_components.hpp"
 #include "pre_allocated_stack.hpp"
+#include "ae_resource_manager.hpp"
 
 // libraries
 
@@ -22,8 +23,8 @@ namespace ae {
 
     /// Specifies a texture and the sampler that should be used with it.
     struct TextureSamplerPair{
-        /// The texture being sampled.
-        std::shared_ptr<AeImage> m_texture = nullptr;
+        /// The handle to the texture being sampled, loaded through the resource manager.
+        AeImageHandle m_texture{};
 
         /// The sampler which defines how to sample the texture.
         VkSampler m_sampler= nullptr;
@@ -94,6 +95,55 @@ namespace ae {
             /// The destructor of the MaterialLayerComponent class. The MaterialComponent destructor
             /// uses the AeComponent constructor with no additions.
             ~Ae3DMaterialLayerComponent() = default;
+
+        protected:
+
+            /// The material layer textures are stored in snapshots using the paths of the textures.
+            /// \return True.
+            bool isSnapshotPersistent() const override { return true; };
+
+            /// Writes the texture paths and sampler names for each shader stage.
+            /// \param t_data The material layer textures of the entity.
+            /// \param t_writer The writer the snapshot is being written with.
+            void saveEntitySnapshot(const T& t_data, ae_ecs::AeSnapshotWriter& t_writer) override {
+                saveTextureSamplerPairs(t_data.m_vertexTextures, numVertTexts, t_writer);
+                saveTextureSamplerPairs(t_data.m_fragmentTextures, numFragTexts, t_writer);
+                saveTextureSamplerPairs(t_data.m_tessellationTextures, numTessTexts, t_writer);
+                saveTextureSamplerPairs(t_data.m_geometryTextures, numGeometryTexts, t_writer);
+            };
+
+            /// Reads the textures and samplers for each shader stage, loading the textures through the resource
+            /// manager.
+            /// \param t_data The material layer textures of the entity.
+            /// \param t_reader The reader the snapshot is being read with.
+            void loadEntitySnapshot(T& t_data, ae_ecs::AeSnapshotReader& t_reader) override {
+                loadTextureSamplerPairs(t_data.m_vertexTextures, numVertTexts, t_reader);
+                loadTextureSamplerPairs(t_data.m_fragmentTextures, numFragTexts, t_reader);
+                loadTextureSamplerPairs(t_data.m_tessellationTextures, numTessTexts, t_reader);
+                loadTextureSamplerPairs(t_data.m_geometryTextures, numGeometryTexts, t_reader);
+            };
+
+        private:
+
+            /// Writes the texture paths and sampler names of a shader stage.
+            static void saveTextureSamplerPairs(const TextureSamplerPair t_pairs[],
+                                                uint32_t t_numPairs,
+                                                ae_ecs::AeSnapshotWriter& t_writer){
+                for(uint32_t i = 0; i < t_numPairs; i++){
+                    t_writer.writeAsset(resourceSnapshotAssetType_image, t_pairs[i].m_texture.getValue());
+                    t_writer.writeSampler(t_pairs[i].m_sampler);
+                }
+            };
+
+            /// Reads the textures and samplers of a shader stage.
+            static void loadTextureSamplerPairs(TextureSamplerPair t_pairs[],
+                                                uint32_t t_numPairs,
+                                                ae_ecs::AeSnapshotReader& t_reader){
+                for(uint32_t i = 0; i < t_numPairs; i++){
+                    t_pairs[i].m_texture = t_reader.readAsset<AeImageHandle>(resourceSnapshotAssetType_image);
+                    t_pairs[i].m_sampler = static_cast<VkSampler>(t_reader.readSampler());
+                }
+            };
         };
 
 
@@ -113,11 +163,14 @@ namespace ae {
             /// \param t_game_components The game components that may be utilized by this system.
             /// \param t_materialComponent The material component for the material layer this system is associated with.
             /// \param t_materialLayer The material layer this system is associated with.
+            /// \param t_aeResourceManager The resource manager the models and textures of the entities are loaded by.
             Ae3DMaterialLayerSystem(ae_ecs::AeECS& t_ecs,
                                     GameComponents& t_game_components,
                                     Ae3DMaterialLayerComponent& t_materialComponent,
-                                    Ae3DMaterialLayerType<numVertTexts,numFragTexts,numTessTexts,numGeometryTexts>& t_materialLayer) :
+                                    Ae3DMaterialLayerType<numVertTexts,numFragTexts,numTessTexts,numGeometryTexts>& t_materialLayer,
+                                    AeResourceManager& t_aeResourceManager) :
                            ae_ecs::AeSystem<Ae3DMaterialLayerSystem>(t_ecs),
+                                   m_aeResourceManager{t_aeResourceManager},
                                    m_modelComponent{t_game_components.modelComponent},
                                    m_materialComponent{t_materialComponent},
                                    m_worldPositionComponent{t_game_components.worldPositionComponent},
@@ -147,11 +200,11 @@ namespace ae {
             /// updated and/or entities that have been removed or had this material layer removed.
             /// \param t_entity3DSSBOData The model matrix and texture indices data for an entity that is in the 3D-SSBO
             /// that will be accessed by the material layer shaders when rendering.
-            /// \param t_entity3DSSBOMap The map of where entities data are within the 3D-SSBO.
+            /// \param t_entity3DSSBOTable Where the entities data are within the 3D-SSBO.
             /// \param t_imageBuffer The buffer that stores the images and their samplers that will be accessed by the
             /// material layer shaders when rendering.
-            /// \param t_imageBufferMap The map of images and their samplers and which entities use them with which
-            /// materials.
+            /// \param t_imageBufferMap The images and their samplers and which entities use them with which materials,
+            /// indexed by the index of the image handle.
             /// \param t_imageBufferStack The stack of available positions within the imageBufferMap where new images
             /// can be placed. When no entities utilize a specific image the image's position within the imageBufferMap
             /// is placed at the top of this stack.
@@ -159,9 +212,9 @@ namespace ae {
             /// that the drawIndexedIndirectCommands required for this material layer will start. This position will be
             /// required when executing the drawIndexedIndirect commands for this material.
             const std::vector<VkDrawIndexedIndirectCommand>& updateMaterialEntities(std::vector<Entity3DSSBOData>& t_entity3DSSBOData,
-                                                                                    std::map<ecs_id, uint32_t>& t_entity3DSSBOMap,
+                                                                                    const DenseSlotTable& t_entity3DSSBOTable,
                                                                                     VkDescriptorImageInfo t_imageBuffer[MAX_TEXTURES],
-                                                                                    std::map<std::shared_ptr<AeImage>,ImageBufferInfo>& t_imageBufferMap,
+                                                                                    std::vector<ImageBufferInfo>& t_imageBufferMap,
                                                                                     PreAllocatedStack<uint64_t,MAX_TEXTURES>& t_imageBufferStack,
                                                                                     uint64_t t_drawIndexedIndirectCommandBufferIndex) {
 
@@ -173,23 +226,23 @@ namespace ae {
                 // vector.
                 m_remakeCommandVector = false;
 
+                // If entities have been moved within the 3D-SSBO the commands need to be remade to draw them from
+                // their new positions.
+                if(t_entity3DSSBOTable.getNumSlotMoves() != m_numSSBOSlotMoves){
+                    m_numSSBOSlotMoves = t_entity3DSSBOTable.getNumSlotMoves();
+                    m_remakeCommandVector = true;
+                }
+
                 // Delete the destroyed entities from the list first.
-                std::vector<ecs_id> destroyedEntityIds = this->m_systemManager.getDestroyedSystemEntities(this->m_systemId);
+                ecs_entityList destroyedEntityIds = this->m_systemManager.getDestroyedSystemEntities(this->m_systemId);
                 for(ecs_id entityId: destroyedEntityIds){
                     // An update occurred to an entity, remake the command array for this material.
                     m_remakeCommandVector = true;
 
-                    // Find where the entity is in the model map and remove it.
-                    for(auto model_it=m_uniqueModelMap.begin(),next_model_it = model_it;
-                        model_it != m_uniqueModelMap.cend();
-                        model_it=next_model_it){
-
-                        ++next_model_it;
-                        if(model_it->second.erase(entityId) > 0){
-                            // Check to see if the model should also be removed from the model map.
-                            if(model_it->second.empty()){
-                                m_uniqueModelMap.erase(model_it);
-                            }
+                    // Find which model the entity is drawn with and remove it. A model no longer used by any entity is
+                    // left empty and skipped when drawing.
+                    for(auto& uniqueModel : m_uniqueModels){
+                        if(uniqueModel.m_entityCommands.erase(entityId) > 0){
                             break;
                         }
                     }
@@ -201,46 +254,36 @@ namespace ae {
                     // entity/material combinations that use an it. Then all that needs to be done when an entity
                     // updates their material component is that the counter for that image is decremented.
 
-                    // Check each image in the map to ensure that the entity is removed from it.
-                    for(auto uniqueImage_it=t_imageBufferMap.begin(),next_uniqueImage_it = uniqueImage_it;
-                        uniqueImage_it != t_imageBufferMap.cend();
-                        uniqueImage_it=next_uniqueImage_it){
-
-                        ++next_uniqueImage_it;
+                    // Check each image in the image buffer to ensure that the entity is removed from it.
+                    for(auto& uniqueImage : t_imageBufferMap){
 
                         // Check to see if the image has the entity in the map.
-                        auto entityPosition = uniqueImage_it->second.m_entityMaterialMap.find(entityId);
-                        if(entityPosition != uniqueImage_it->second.m_entityMaterialMap.end()){
+                        auto entityPosition = uniqueImage.m_entityMaterialMap.find(entityId);
+                        if(entityPosition != uniqueImage.m_entityMaterialMap.end()){
 
-                            // Check to see if the entity is using the image with this material.
-                            auto materialLayerPosition = entityPosition->second.find(this->m_material.getMaterialLayerId());
-                            if(materialLayerPosition != entityPosition->second.end()){
-
-                                // Remove the material from the entity list tracing which materials for an entity use
-                                // the current image.
-                                entityPosition->second.erase(materialLayerPosition);
-                            }
+                            // Remove the material from the entity list tracing which materials for an entity use
+                            // the current image.
+                            entityPosition->second.reset(this->m_material.getMaterialLayerId());
 
                             // If the entity no longer has any materials which use the image remove the entity from the
                             // image's list of entities that use it.
-                            if(entityPosition->second.empty()){
-                                uniqueImage_it->second.m_entityMaterialMap.erase(entityPosition);
+                            if(entityPosition->second.none()){
+                                uniqueImage.m_entityMaterialMap.erase(entityPosition);
                             }
 
                             // If the image no longer has any entities that are using it then remove the image from the
-                            // buffer. This is currently done by giving back the image buffer index back to the stack so
-                            // a new unique image can take its position in the buffer. Then the image is erased from the
-                            // buffer map.
-                            if(uniqueImage_it->second.m_entityMaterialMap.empty()){
-                                t_imageBufferStack.push(uniqueImage_it->second.m_imageBufferIndex);
-                                t_imageBufferMap.erase(uniqueImage_it);
+                            // buffer. This is done by giving back the image buffer index back to the stack so a new
+                            // unique image can take its position in the buffer, the emptied entity material map marks
+                            // the image as no longer being in the buffer.
+                            if(uniqueImage.m_entityMaterialMap.empty()){
+                                t_imageBufferStack.push(uniqueImage.m_imageBufferIndex);
                             }
                         }
                     }
                 }
 
                 // Get the entities that have been updated that use this system.
-                std::vector<ecs_id> updatedEntityIds = this->m_systemManager.getUpdatedSystemEntities(this->m_systemId);
+                ecs_entityList updatedEntityIds = this->m_systemManager.getUpdatedSystemEntities(this->m_systemId);
 
                 // For the entities that have updated ensure they exist in the list and their drawIndirect command is
                 // updated with the new information.
@@ -249,32 +292,42 @@ namespace ae {
                     // An update occurred to an entity, remake the command array for this material.
                     m_remakeCommandVector = true;
 
-                    // Get the model for the entity that was updated.
-                    auto entityModel = m_modelComponent.getReadOnlyDataReference(entityId);
+                    // Get the model for the entity that was updated, the resource manager throws if the handle is stale.
+                    const auto& entityModel = m_modelComponent.getReadOnlyDataReference(entityId);
+                    Ae3DModel& model = m_aeResourceManager.get3DModel(entityModel.m_model);
+
+                    // Get where the entity's data is in the 3D-SSBO, it is placed there by the model 3D buffer system.
+                    uint32_t entitySSBOIndex = t_entity3DSSBOTable.getSlot(entityId);
+                    if(entitySSBOIndex == DenseSlotTable::INVALID_SLOT){
+                        throw std::runtime_error("An entity drawn with a material layer has no data in the 3D-SSBO!");
+                    }
 
                     // Create a command for the updated component.
                     VkDrawIndexedIndirectCommand entityCommand;
                     entityCommand.firstIndex = 0;
-                    entityCommand.indexCount = entityModel.m_model->getIndexCount();
+                    entityCommand.indexCount = model.getIndexCount();
                     entityCommand.instanceCount = 1;
-                    entityCommand.firstInstance = t_entity3DSSBOMap[entityId];
+                    entityCommand.firstInstance = entitySSBOIndex;
                     entityCommand.vertexOffset = 0;
 
-                    // Check if entity's model is already in the unique model map.
-                    auto modelInsertionResult = m_uniqueModelMap.insert( std::make_pair(entityModel.m_model, std::map<ecs_id,VkDrawIndexedIndirectCommand>()));
-                    if (modelInsertionResult.second) {
+                    // The entities drawn with a model are stored at the index of the model's handle.
+                    uint32_t modelIndex = entityModel.m_model.getIndex();
+                    if(modelIndex >= m_uniqueModels.size()){
+                        m_uniqueModels.resize(modelIndex + 1);
+                    }
+                    UniqueModel& uniqueModel = m_uniqueModels[modelIndex];
+
+                    // If the model's slot still has entities from a different generation of the slot, those entities
+                    // reference a model that has been unloaded.
+                    if(uniqueModel.m_entityCommands.empty()){
+                        uniqueModel.m_model = entityModel.m_model;
+                    } else if(uniqueModel.m_model != entityModel.m_model){
+                        throw std::runtime_error("Entities drawn with a material layer still reference a 3D model "
+                                                 "that has been unloaded!");
+                    }
 
-                        // The model was not already in the map and was added. Now add the entity ID and model matrix
-                        // index relation.
-                        modelInsertionResult.first->second.insert(std::make_pair(entityId,entityCommand));
-                    } else {
-
-                        // The model was in the map already. Now see if the entity-model relation is already in the map.
-                        auto entityInsertionResult = modelInsertionResult.first->second.insert(std::make_pair(entityId,entityCommand));
-                        if(!entityInsertionResult.second){
-                            entityInsertionResult.first->second = entityCommand;
-                        }
-                    };
+                    // Add the entity's command, or replace it if the entity was already drawn with the model.
+                    uniqueModel.m_entityCommands[entityId] = entityCommand;
 
                     // Get the material properties for the entity.
                     auto entityMaterialProperties = m_materialComponent.getReadOnlyDataReference(entityId);
@@ -285,7 +338,7 @@ namespace ae {
                     uint32_t textureIndex = 0;
 
                     // Update the entities vertex textures.
-                    handleShaderImages(t_entity3DSSBOMap[entityId],
+                    handleShaderImages(entitySSBOIndex,
                                        textureIndex,
                                        entityId,
                                        entityMaterialProperties.m_vertexTextures,
@@ -296,7 +349,7 @@ namespace ae {
                                        t_imageBufferStack);
 
                     // Update the entities fragment textures.
-                    handleShaderImages(t_entity3DSSBOMap[entityId],
+                    handleShaderImages(entitySSBOIndex,
                                        textureIndex,
                                        entityId,
                                        entityMaterialProperties.m_fragmentTextures,
@@ -307,7 +360,7 @@ namespace ae {
                                        t_imageBufferStack);
 
                     // Update the entities Tesselation textures.
-                    handleShaderImages(t_entity3DSSBOMap[entityId],
+                    handleShaderImages(entitySSBOIndex,
                                        textureIndex,
                                        entityId,
                                        entityMaterialProperties.m_tessellationTextures,
@@ -318,7 +371,7 @@ namespace ae {
                                        t_imageBufferStack);
 
                     // Update the entities Geometry textures.
-                    handleShaderImages(t_entity3DSSBOMap[entityId],
+                    handleShaderImages(entitySSBOIndex,
                                        textureIndex,
                                        entityId,
                                        entityMaterialProperties.m_geometryTextures,
@@ -342,8 +395,10 @@ namespace ae {
                     m_materialDrawIndexedCommands.clear();
 
                     // Loop through each of the models, and entities that use the model, to reform the command vector.
-                    for(const auto& model : m_uniqueModelMap){
-                        for(const auto& entityCommands : model.second){
+                    // The entity's position in the 3D-SSBO is looked up again since it may have moved.
+                    for(auto& uniqueModel : m_uniqueModels){
+                        for(auto& entityCommands : uniqueModel.m_entityCommands){
+                            entityCommands.second.firstInstance = t_entity3DSSBOTable.getSlot(entityCommands.first);
                             m_materialDrawIndexedCommands.push_back(entityCommands.second);
                         }
                     }
@@ -370,8 +425,8 @@ namespace ae {
             /// recorded for the shader to access the correct shader during rendering.
             /// \param t_imageBuffer The image buffer where the textures for the entity must be stored to be accessible
             /// by the shaders.
-            /// \param t_imageBufferMap The map of which entities, and which of their materials, utilize which images in
-            /// the image buffer.
+            /// \param t_imageBufferMap Which entities, and which of their materials, utilize which images in the image
+            /// buffer, indexed by the index of the image handle.
             /// \param t_imageBufferStack The stack of available positions in the imageBuffer where new images may be
             /// placed and where indices for images that were removed from the imageBuffer need to be placed on top of
             /// for reuse.
@@ -382,7 +437,7 @@ namespace ae {
                                     uint32_t t_numShaderTextures,
                                     std::vector<Entity3DSSBOData>& t_entity3DSSBOData,
                                     VkDescriptorImageInfo t_imageBuffer[MAX_TEXTURES],
-                                    std::map<std::shared_ptr<AeImage>,ImageBufferInfo>& t_imageBufferMap,
+                                    std::vector<ImageBufferInfo>& t_imageBufferMap,
                                     PreAllocatedStack<uint64_t,MAX_TEXTURES>& t_imageBufferStack){
 
                 // TODO This could be optimized, right now all the texture relations, and the images themselves if
@@ -397,57 +452,50 @@ namespace ae {
 
                     // Check if the object has a texture. If not set it such that the model is rendered using only its
                     // vertex colors.
-                    if(t_shaderTextures[i].m_texture == nullptr){
+                    if(t_shaderTextures[i].m_texture.isNull()){
                         t_entity3DSSBOData[t_entitySSBOIndex].textureIndex[m_material.getMaterialLayerId()][t_entityTextureIndex] = MAX_TEXTURES + 1;
                         t_entityTextureIndex++;
                         continue;
                     }
 
-                    // Search the image buffer map to see if the image has already been added to it.
-                    auto imageSearchIterator = t_imageBufferMap.find(t_shaderTextures[i].m_texture);
+                    // A stale handle's index may have been reused by another image, so it must not be looked up.
+                    if(!m_aeResourceManager.isImageLoaded(t_shaderTextures[i].m_texture)){
+                        throw std::runtime_error("An entity's material layer texture references an image that is no "
+                                                 "longer loaded!");
+                    }
 
-                    if(imageSearchIterator==t_imageBufferMap.end()){
+                    // Check the image buffer map to see if the image has already been added to it.
+                    uint32_t imageIndex = t_shaderTextures[i].m_texture.getIndex();
+                    if(imageIndex >= t_imageBufferMap.size()){
+                        t_imageBufferMap.resize(imageIndex + 1);
+                    }
+                    ImageBufferInfo& imageBufferInfo = t_imageBufferMap[imageIndex];
+
+                    if(imageBufferInfo.m_entityMaterialMap.empty()){
                         // If the image was not already in the map it is time to add it. First get an available image
                         // buffer index to add the image into the buffer.
                         auto newImageIndex = t_imageBufferStack.pop();
 
                         // Add the image to the image buffer.
                         t_imageBuffer[newImageIndex].sampler = t_shaderTextures[i].m_sampler;
-                        t_imageBuffer[newImageIndex].imageView = t_shaderTextures[i].m_texture->getImageView();
+                        t_imageBuffer[newImageIndex].imageView = m_aeResourceManager.getImage(t_shaderTextures[i].m_texture).getImageView();
                         t_imageBuffer[newImageIndex].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
                         // Add the image and the entity/material relation into the map.
                         // TODO need to make this also account for the sampler used for the texture.....
-                        t_imageBufferMap.insert({t_shaderTextures[i].m_texture,
-                                                 ImageBufferInfo(newImageIndex,t_entityId,
-                                                                 m_material.getMaterialLayerId())});
+                        imageBufferInfo = ImageBufferInfo(newImageIndex, t_entityId, m_material.getMaterialLayerId());
 
                         // Set the texture information in the entities SSBO object.
                         t_entity3DSSBOData[t_entitySSBOIndex].textureIndex[m_material.getMaterialLayerId()][t_entityTextureIndex] = newImageIndex;
 
                     } else{
 
-                        // If the image was already in the map attempt to insert the relation between that image and
-                        // this entity-material combination.
-                        auto entityImageSearchIterator= imageSearchIterator->second.
-                                m_entityMaterialMap.
-                                insert(std::pair<ecs_id,
-                                       std::unordered_set<material_id>>(t_entityId,
-                                                                        m_material.
-                                                                                getMaterialLayerId()));
-
-                        // Check to see if the insertion was successful.
-                        if(!entityImageSearchIterator.second){
-
-                            // If the insertion was not successful check to see if the material ID is already in the
-                            // list if not add it.
-                            if (entityImageSearchIterator.first->second.find(m_material.getMaterialLayerId()) == entityImageSearchIterator.first->second.end()){
-                                entityImageSearchIterator.first->second.insert(m_material.getMaterialLayerId());
-                            };
-                        };
+                        // If the image was already in the map record the relation between that image and this
+                        // entity-material combination, the entity is added to the map if it was not already in it.
+                        imageBufferInfo.m_entityMaterialMap[t_entityId].set(m_material.getMaterialLayerId());
 
                         // Since the image was already in the image buffer, update the entities SSBO index data accordingly.
-                        t_entity3DSSBOData[t_entitySSBOIndex].textureIndex[m_material.getMaterialLayerId()][t_entityTextureIndex] = imageSearchIterator->second.m_imageBufferIndex;
+                        t_entity3DSSBOData[t_entitySSBOIndex].textureIndex[m_material.getMaterialLayerId()][t_entityTextureIndex] = imageBufferInfo.m_imageBufferIndex;
                     };
                 };
             };
@@ -487,19 +535,20 @@ namespace ae {
                 VkDeviceSize indirect_offset;
 
                 // Loop through each of the unique models
-                for(const auto& model : m_uniqueModelMap){
+                for(const auto& uniqueModel : m_uniqueModels){
+                    if(uniqueModel.m_entityCommands.empty()) continue;
 
                     // Bind the model to the pipeline.
-                    model.first->bind(t_commandBuffer);
+                    m_aeResourceManager.get3DModel(uniqueModel.m_model).bind(t_commandBuffer);
 
                     // Calculate the offset value.
                     indirect_offset = indirectBufferIndex * sizeof(VkDrawIndexedIndirectCommand);
 
                     // Draw all instances of the model with this material.
-                    vkCmdDrawIndexedIndirect(t_commandBuffer, t_drawIndexedIndirectBuffer, indirect_offset, model.second.size(), DRAW_INDEXED_INDIRECT_COMMAND_SIZE);
+                    vkCmdDrawIndexedIndirect(t_commandBuffer, t_drawIndexedIndirectBuffer, indirect_offset, uniqueModel.m_entityCommands.size(), DRAW_INDEXED_INDIRECT_COMMAND_SIZE);
 
                     // Increment the offset by the number of entities drawn that had the current model.
-                    indirectBufferIndex += model.second.size();
+                    indirectBufferIndex += uniqueModel.m_entityCommands.size();
                 }
             };
 
@@ -510,7 +559,30 @@ namespace ae {
                 this->m_systemManager.clearSystemEntityDestroyedSignatures(this->m_systemId);
             };
 
+
+
+            /// Updates the entity IDs the draw commands are tracked by when entities are renumbered. The commands
+            /// themselves still reference the same 3D SSBO locations so they do not need to be remade.
+            /// \param t_entityIdMoves The entities that have been renumbered.
+            void remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves) override {
+                for(auto& uniqueModel : m_uniqueModels){
+                    this->remapEntityIdKeys(uniqueModel.m_entityCommands, t_entityIdMoves);
+                }
+            };
+
         private:
+            /// The entities drawn with a model and the handle of the model.
+            struct UniqueModel {
+                /// The handle of the model, only meaningful while entities are drawn with it.
+                Ae3DModelHandle m_model{};
+
+                /// The draw command of each entity drawn with the model.
+                std::map<ecs_id,VkDrawIndexedIndirectCommand> m_entityCommands;
+            };
+
+            /// The resource manager the models and textures of the entities are loaded by.
+            AeResourceManager& m_aeResourceManager;
+
             /// A reference to the model component this system is associated with.
             ModelComponent& m_modelComponent;
 
@@ -523,8 +595,8 @@ namespace ae {
             /// A reference to the material that this system supports.
             Ae3DMaterialLayerType<numVertTexts,numFragTexts,numTessTexts,numGeometryTexts>& m_material;
 
-            /// A vector to track unique models, and a list of which entities use them.
-            std::map<std::shared_ptr<Ae3DModel>,std::map<ecs_id,VkDrawIndexedIndirectCommand>> m_uniqueModelMap;
+            /// The unique models, and which entities use them, indexed by the index of the model handle.
+            std::vector<UniqueModel> m_uniqueModels;
 
             /// Compiles the commands to be called by draw indexed indirect command for each frame.
             std::vector<VkDrawIndexedIndirectCommand> m_materialDrawIndexedCommands;
@@ -535,6 +607,9 @@ namespace ae {
             /// A flag to indicate if the draw indexed indirect command vector needs to be recreated for the material
             /// layer.
             bool m_remakeCommandVector = false;
+
+            /// The number of times entities had been moved within the 3D-SSBO when the commands were last made.
+            uint64_t m_numSSBOSlotMoves = 0;
         };
 
 
@@ -552,14 +627,17 @@ namespace ae {
         /// specify the dynamic stages of it's graphics pipeline.
         /// \param t_descriptorSetLayouts The layouts of the descriptor sets that will be required by the shaders of the
         /// material layer being created.
+        /// \param t_aeResourceManager The resource manager the models and textures of the entities are loaded by.
         explicit Ae3DMaterialLayerType(AeDevice &t_aeDevice,
                                        GameComponents& t_game_components,
                                        VkRenderPass t_renderPass,
                                        ae_ecs::AeECS& t_ecs,
                                        MaterialShaderFiles& t_materialLayerShaderFiles,
-                                       std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts) :
+                                       std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts,
+                                       AeResourceManager& t_aeResourceManager) :
                 m_ecs{t_ecs},
                 m_gameComponents{t_game_components},
+                m_aeResourceManager{t_aeResourceManager},
                 Ae3DMaterialLayerBase(t_aeDevice,
                                       t_renderPass,
                                       t_materialLayerShaderFiles,
@@ -606,11 +684,11 @@ namespace ae {
         /// updated and/or entities that have been removed or had this material layer removed.
         /// \param t_entity3DSSBOData The model matrix and texture indices data for an entity that is in the 3D-SSBO
         /// that will be accessed by the material layer shaders when rendering.
-        /// \param t_entity3DSSBOMap The map of where entities data are within the 3D-SSBO.
+        /// \param t_entity3DSSBOTable Where the entities data are within the 3D-SSBO.
         /// \param t_imageBuffer The buffer that stores the images and their samplers that will be accessed by the
         /// material layer shaders when rendering.
-        /// \param t_imageBufferMap The map of images and their samplers and which entities use them with which
-        /// materials.
+        /// \param t_imageBufferMap The images and their samplers and which entities use them with which materials,
+        /// indexed by the index of the image handle.
         /// \param t_imageBufferStack The stack of available positions within the imageBufferMap where new images
         /// can be placed. When no entities utilize a specific image the image's position within the imageBufferMap
         /// is placed at the top of this stack.
@@ -618,16 +696,16 @@ namespace ae {
         /// that the drawIndexedIndirectCommands required for this material layer will start. This position will be
         /// required when executing the drawIndexedIndirect commands for this material.
         const std::vector<VkDrawIndexedIndirectCommand>& updateMaterialLayerEntities(std::vector<Entity3DSSBOData>& t_entity3DSSBOData,
-                                                                                     std::map<ecs_id, uint32_t>& t_entity3DSSBOMap,
+                                                                                     const DenseSlotTable& t_entity3DSSBOTable,
                                                                                      VkDescriptorImageInfo t_imageBuffer[MAX_TEXTURES],
-                                                                                     std::map<std::shared_ptr<AeImage>,ImageBufferInfo>& t_imageBufferMap,
+                                                                                     std::vector<ImageBufferInfo>& t_imageBufferMap,
                                                                                      PreAllocatedStack<uint64_t,MAX_TEXTURES>& t_imageBufferStack,
                                                                                      uint64_t t_drawIndexedIndirectCommandBufferIndex) override {
 
             // Call the material system's updateMaterialLayerEntities function. The system tracks which compatible
             // entities have been updated/destroyed and need to be acted upon.
             return m_materialSystem.updateMaterialEntities(t_entity3DSSBOData,
-                                                           t_entity3DSSBOMap,
+                                                           t_entity3DSSBOTable,
                                                            t_imageBuffer,
                                                            t_imageBufferMap,
                                                            t_imageBufferStack,
@@ -649,6 +727,9 @@ namespace ae {
         /// The game components the system uses.
         GameComponents& m_gameComponents;
 
+        /// The resource manager the models and textures of the entities are loaded by.
+        AeResourceManager& m_aeResourceManager;
+
     public:
         /// Create a component for the material to track entities that use the material and specify
         /// textures/properties specific to that entity.
@@ -658,7 +739,7 @@ namespace ae {
 
         /// Create a system to deal with organizing the models and entity information the material is responsible for
         /// rendering.
-        Ae3DMaterialLayerSystem m_materialSystem{m_ecs, m_gameComponents, m_materialComponent, *this};
+        Ae3DMaterialLayerSystem m_materialSystem{m_ecs, m_gameComponents, m_materialComponent, *this, m_aeResourceManager};
 
 
     protected:
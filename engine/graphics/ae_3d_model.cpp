@@ -1,5 +1,6 @@
 #include "ae_3d_model.hpp"
 #include "ae_utils.hpp"
+#include "flat_hash_map.hpp"
 
 // libs
 #define TINYOBJLOADER_IMPLEMENTATION
@@ -11,11 +12,10 @@
 // std
 #include <cassert>
 #include <cstring>
-#include <unordered_map>
 
 namespace std {
-    // Define a hash operator for the Vertex structure to allow for a Vertex structure to be used as the key in an
-    // unordered map. This is used to determine if the vertex is unique or a repeat used to make another triangle.
+    // Define a hash operator for the Vertex structure to allow for a Vertex structure to be used as the key in a hash
+    // map. This is used to determine if the vertex is unique or a repeat used to make another triangle.
 	template <>
 	struct hash<ae::Ae3DModel::Vertex> {
 		size_t operator()(ae::Ae3DModel::Vertex const& vertex) const {
@@ -256,10 +256,10 @@ namespace ae {
 		vertices.clear();
 		indices.clear();
 
-        // Create an unordered map that uses the Vertex struct as it's key to allow its hash to be used to identify if
+        // Create a hash map that uses the Vertex struct as it's key to allow its hash to be used to identify if
         // the current vertex is unique or already exists in the map. This allows the index of non-unique vertices to
         // point to the already existing vertex data instead of replicating the data.s
-		std::unordered_map<Vertex, uint32_t> uniqueVertices{};
+		ae::flat_hash_map<Vertex, uint32_t> uniqueVertices{};
 
         // Loop through all the vertex data imported by the tinyObject loader.
 		for (const auto &shape : shapes) {
@@ -302,10 +302,11 @@ namespace ae {
 					};
 				}
 
-                // Use the hashing function of the unordered map to identify if the vertex is unique.
-				if (uniqueVertices.count(vertex) == 0) {
-                    // Add the unique vertex to the unique vertices unordered map.
-					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+                // Use the hashing function of the map to identify if the vertex is unique, adding it to the unique
+                // vertices map with the index it will have if it is. This takes a single lookup of the vertex.
+				auto [uniqueVertex, isUnique] = uniqueVertices.try_emplace(vertex,
+                                                                           static_cast<uint32_t>(vertices.size()));
+				if (isUnique) {
                     // Add the vertex data to the builder's vertices data that will be used to make the model's vertex
                     // buffer later.
 					vertices.push_back(vertex);
@@ -313,7 +314,7 @@ namespace ae {
 
                 // Specify the index for the vertex data that was created from the imported object file data. The hash
                 // of the vertex struct will ensure matching vertex data will get the same index.s
-				indices.push_back(uniqueVertices[vertex]);
+				indices.push_back(uniqueVertex->second);
 			}
 		}
 	}
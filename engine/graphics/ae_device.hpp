@@ -101,6 +101,10 @@ namespace ae {
         /// \return The compute queue of the device.
         VkQueue computeQueue() { return m_computeQueue; }
 
+		/// Get the physical device, the GPU, the device interfaces with.
+		/// \return The physical device.
+		VkPhysicalDevice getPhysicalDevice() { return m_physicalDevice; }
+
 		/// Fetches the swap chain features supported by the device
 		/// \return A structure containing the device's swap chain capabilities.
 		SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(m_physicalDevice); }
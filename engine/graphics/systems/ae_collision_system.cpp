@@ -111,11 +111,12 @@ namespace ae {
         m_aeComputePipeline->bind(t_commandBuffer);
     };
 
-    void AeCollisionSystem::recordComputeCommandBuffer(VkCommandBuffer& t_commandBuffer, std::vector<VkDescriptorSet>& t_descriptorSets){
+    void AeCollisionSystem::recordComputeCommandBuffer(VkCommandBuffer& t_commandBuffer,
+                                                       std::vector<VkDescriptorSet>& t_descriptorSets,
+                                                       uint32_t t_numEntities){
 
-        // Get the entities that use the components this system depends on.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
-        uint32_t numModels = validEntityIds.size();
+        // The entities are packed at the start of the 3D SSBO so only that many need to be computed.
+        uint32_t numModels = t_numEntities;
 
         bindComputePipeline(t_commandBuffer);
 
@@ -147,7 +148,8 @@ namespace ae {
     };
 
     void AeCollisionSystem::drawAABBs(VkCommandBuffer &t_commandBuffer,
-                                      std::vector<VkDescriptorSet>& t_descriptorSets){
+                                      std::vector<VkDescriptorSet>& t_descriptorSets,
+                                      uint32_t t_numEntities){
 
         // Tell the pipeline what the current command buffer being worked on is.
         m_aabbPipeline->bind(t_commandBuffer);
@@ -163,17 +165,14 @@ namespace ae {
                                 nullptr);
 
 
-        // Get the number of entities
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
-        uint32_t numModels = validEntityIds.size();
-
         // Draw he AABB for each entity.
-        vkCmdDraw(t_commandBuffer, 24, numModels, 0, 0);
+        vkCmdDraw(t_commandBuffer, 24, t_numEntities, 0, 0);
 
     }
 
     void AeCollisionSystem::drawOBBs(VkCommandBuffer &t_commandBuffer,
-                                     std::vector<VkDescriptorSet>& t_descriptorSets){
+                                     std::vector<VkDescriptorSet>& t_descriptorSets,
+                                     uint32_t t_numEntities){
 
         // Tell the pipeline what the current command buffer being worked on is.
         m_obbPipeline->bind(t_commandBuffer);
@@ -189,12 +188,8 @@ namespace ae {
                                 nullptr);
 
 
-        // Get the number of entities
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
-        uint32_t numModels = validEntityIds.size();
-
         // Draw he AABB for each entity.
-        vkCmdDraw(t_commandBuffer, 24, numModels, 0, 0);
+        vkCmdDraw(t_commandBuffer, 24, t_numEntities, 0, 0);
 
     }
 
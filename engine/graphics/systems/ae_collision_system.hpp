@@ -35,13 +35,23 @@ namespace ae {
 
         void bindComputePipeline(VkCommandBuffer& t_commandBuffer);
 
+        /// Draws the AABB of each entity in the 3D SSBO.
+        /// \param t_numEntities The number of entities packed at the start of the 3D SSBO.
         void drawAABBs(VkCommandBuffer &t_commandBuffer,
-                       std::vector<VkDescriptorSet>& t_descriptorSets);
+                       std::vector<VkDescriptorSet>& t_descriptorSets,
+                       uint32_t t_numEntities);
 
+        /// Draws the OBB of each entity in the 3D SSBO.
+        /// \param t_numEntities The number of entities packed at the start of the 3D SSBO.
         void drawOBBs(VkCommandBuffer &t_commandBuffer,
-                      std::vector<VkDescriptorSet>& t_descriptorSets);
-
-        void recordComputeCommandBuffer(VkCommandBuffer& t_commandBuffer, std::vector<VkDescriptorSet>& t_descriptorSets);
+                      std::vector<VkDescriptorSet>& t_descriptorSets,
+                      uint32_t t_numEntities);
+
+        /// Records the compute that calculates the AABB of each entity in the 3D SSBO.
+        /// \param t_numEntities The number of entities packed at the start of the 3D SSBO.
+        void recordComputeCommandBuffer(VkCommandBuffer& t_commandBuffer,
+                                        std::vector<VkDescriptorSet>& t_descriptorSets,
+                                        uint32_t t_numEntities);
 
         /// Setup the PointLightRenderSystem, this is handled by the RendererSystem.
         void setupSystem() override {
@@ -16,7 +16,8 @@ namespace ae {
                                                      AeRenderer& t_renderer,
                                                      AeDevice& t_aeDevice,
                                                      AeSamplers& t_aeSamplers,
-                                                     AeResourceManager& t_aeResourceManager) :
+                                                     AeResourceManager& t_aeResourceManager,
+                                                     const AeEngineLimits& t_engineLimits) :
                                                      m_updateUboSystem{t_updateUboSystem},
                                                      m_timingSystem{t_timingSystem},
                                                      m_renderer{t_renderer},
@@ -24,6 +25,11 @@ namespace ae {
                                                      m_aeSamplers{t_aeSamplers},
                                                      m_gameComponents{t_game_components},
                                                      m_aeResourceManager{t_aeResourceManager},
+                                                     m_engineLimits{t_engineLimits},
+                                                     m_object3DPushData(t_engineLimits.m_maxObjects),
+                                                     m_object2DPushData(t_engineLimits.m_maxObjects),
+                                                     m_object3DBufferData(t_engineLimits.m_maxObjects),
+                                                     m_object3DBufferSlotTable{t_ecs.getMaxNumEntities(), t_engineLimits.m_maxObjects},
                                                      ae_ecs::AeSystem<RendererStartPassSystem>(t_ecs)  {
 
         // Register component dependencies
@@ -181,7 +187,7 @@ namespace ae {
             m_object3DBuffers.push_back(std::make_unique<AeBuffer>(
                     m_aeDevice,
                     sizeof(SimplePushConstantData),
-                    MAX_OBJECTS,
+                    m_engineLimits.m_maxObjects,
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
@@ -223,7 +229,7 @@ namespace ae {
             m_object2DBuffers.push_back(std::make_unique<AeBuffer>(
                     m_aeDevice,
                     sizeof(UiPushConstantData),
-                    MAX_OBJECTS,
+                    m_engineLimits.m_maxObjects,
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
@@ -260,7 +266,7 @@ namespace ae {
             m_drawIndirectBuffers.push_back(std::make_unique<AeBuffer>(
                     m_aeDevice,
                     sizeof(VkDrawIndexedIndirectCommand),
-                    MAX_OBJECTS * MAX_3D_MATERIALS,
+                    m_engineLimits.m_maxObjects * MAX_3D_MATERIALS,
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
@@ -298,7 +304,7 @@ namespace ae {
             m_object3DBuffersIndirect.push_back(std::make_unique<AeBuffer>(
                     m_aeDevice,
                     sizeof(Entity3DSSBOData),
-                    MAX_OBJECTS,
+                    m_engineLimits.m_maxObjects,
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
@@ -343,7 +349,7 @@ namespace ae {
             m_collisionBuffers.push_back(std::make_unique<AeBuffer>(
                     m_aeDevice,
                     sizeof(VkAabbPositionsKHR),
-                    MAX_MODELS,
+                    m_engineLimits.m_maxModels,
                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
@@ -431,14 +437,15 @@ namespace ae {
 
 
         // Creates a buffer of entity model matrix and texture data for entities with 3D models that have a material.
-        m_model3DBufferSystem = new AeModel3DBufferSystem(t_ecs,t_game_components);
+        m_model3DBufferSystem = new AeModel3DBufferSystem(t_ecs,t_game_components,m_aeResourceManager);
 
         // Defines the materials available for entities to use.
         m_gameMaterials = new GameMaterials(m_aeDevice,
                                             t_game_components,
                                             m_renderer.getSwapChainRenderPass(),
                                             t_ecs,
-                                            descriptorSetLayouts);
+                                            descriptorSetLayouts,
+                                            m_aeResourceManager);
 
         // Create a list of the available material component IDs for quick reference when making/updating the model
         // matrix data.
@@ -450,6 +457,7 @@ namespace ae {
 
 //        m_simpleRenderSystem = new SimpleRenderSystem(t_ecs,
 //                                                      t_game_components,
+//                                                      m_aeResourceManager,
 //                                                      m_aeDevice,
 //                                                      m_renderer.getSwapChainRenderPass(),
 //                                                      descriptorSetLayoutsOLD);
@@ -542,8 +550,7 @@ namespace ae {
             // image buffer indices for an entities textures.
             m_model3DBufferSystem->executeSystem(m_materialComponentIds,
                                                  m_object3DBufferData,
-                                                 m_object3DBufferEntityMap,
-                                                 m_object3DBufferDataIndexStack);
+                                                 m_object3DBufferSlotTable);
 
             // After the indexes have been updated for textures entities utilize, call each of the material's system to
             // organize the model objects for each of the materials to use draw indirect.
@@ -554,7 +561,7 @@ namespace ae {
                 //  creation.
                 const std::vector<VkDrawIndexedIndirectCommand>& materialCommands =
                         material->updateMaterialLayerEntities(m_object3DBufferData,
-                                                              m_object3DBufferEntityMap,
+                                                              m_object3DBufferSlotTable,
                                                               m_imageBufferData,
                                                               m_imageBufferEntityMaterialMap,
                                                               m_imageBufferDataIndexStack,
@@ -570,8 +577,11 @@ namespace ae {
             m_textureDescriptorWriter->writeImage(0, m_imageBufferData);
             m_textureDescriptorWriter->overwrite(m_textureDescriptorSets[m_frameIndex]);
 
-            // Write the object buffer data to the descriptor set.
-            m_object3DBuffersIndirect[m_frameIndex]->writeToBuffer(m_object3DBufferData.data());
+            // Write the object buffer data to the descriptor set, only the entities packed at the start of the buffer
+            // are used.
+            uint32_t numObjects3D = static_cast<uint32_t>(m_object3DBufferSlotTable.size());
+            m_object3DBuffersIndirect[m_frameIndex]->writeToBuffer(m_object3DBufferData.data(),
+                                                                   numObjects3D * sizeof(Entity3DSSBOData));
             m_object3DBuffersIndirect[m_frameIndex]->flush();
 
             // Update model OBB data before running computer
@@ -580,7 +590,9 @@ namespace ae {
             // Run compute
             m_computeCommandBuffer = m_renderer.getCurrentComputeCommandBuffer();
             //m_particleSystem->recordComputeCommandBuffer(m_computeCommandBuffer,m_particleFrameDescriptorSets[m_frameIndex]);
-            m_collisionSystem->recordComputeCommandBuffer(m_computeCommandBuffer,m_collisionFrameDescriptorSets[m_frameIndex]);
+            m_collisionSystem->recordComputeCommandBuffer(m_computeCommandBuffer,
+                                                          m_collisionFrameDescriptorSets[m_frameIndex],
+                                                          numObjects3D);
 
             if (vkEndCommandBuffer(m_computeCommandBuffer) != VK_SUCCESS) {
                 throw std::runtime_error("failed to record compute command buffer!");
@@ -590,8 +602,8 @@ namespace ae {
             m_renderer.beginSwapChainRenderPass(m_graphicsCommandBuffer);
 
             // Draw the AABBs and OBBs for collision debugging.
-            m_collisionSystem->drawAABBs(m_graphicsCommandBuffer,m_obbAabbFrameDescriptorSets[m_frameIndex]);
-            m_collisionSystem->drawOBBs(m_graphicsCommandBuffer,m_obbAabbFrameDescriptorSets[m_frameIndex]);
+            m_collisionSystem->drawAABBs(m_graphicsCommandBuffer,m_obbAabbFrameDescriptorSets[m_frameIndex],numObjects3D);
+            m_collisionSystem->drawOBBs(m_graphicsCommandBuffer,m_obbAabbFrameDescriptorSets[m_frameIndex],numObjects3D);
 
 
             // Loop through each material and have them draw their entities.
@@ -644,13 +656,26 @@ namespace ae {
 
 
 
+    // The entity data stays in the same SSBO and image buffer locations, only the entity IDs mapped to them change.
+    void RendererStartPassSystem::remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves){
+        for(auto& entityIdMove : t_entityIdMoves){
+            m_object3DBufferSlotTable.remapKey(entityIdMove.m_oldId, entityIdMove.m_newId);
+        }
+
+        for(auto& imageBufferInfo : m_imageBufferEntityMaterialMap){
+            remapEntityIdKeys(imageBufferInfo.m_entityMaterialMap, t_entityIdMoves);
+        }
+    };
+
+
+
     // Update the texture descriptor set for the current frame being rendered.
     void RendererStartPassSystem::updateDescriptorSets(){
 
         // Get entities that might have textures from their respective render systems.
-        std::vector<ecs_id> validEntityIds_simpleRenderSystem = m_systemManager.getEnabledSystemsEntities(
+        ecs_entityList validEntityIds_simpleRenderSystem = m_systemManager.getEnabledSystemsEntities(
                 m_simpleRenderSystem->getSystemId());
-        std::vector<ecs_id> validEntityIds_uiRenderSystem = m_systemManager.getEnabledSystemsEntities(
+        ecs_entityList validEntityIds_uiRenderSystem = m_systemManager.getEnabledSystemsEntities(
                 m_uiRenderSystem->getSystemId());
 
         //==============================================================================================================
@@ -658,14 +683,14 @@ namespace ae {
 #ifdef MY_DEBUG
         std::string headerString = "Entities that have updated:\n";
         std::cout << headerString;
-        std::vector<ecs_id> updatedEntityIds_simpleRenderSystem = m_systemManager.getUpdatedSystemEntities(m_simpleRenderSystem->getSystemId());
+        ecs_entityList updatedEntityIds_simpleRenderSystem = m_systemManager.getUpdatedSystemEntities(m_simpleRenderSystem->getSystemId());
         for (auto entityIds : updatedEntityIds_simpleRenderSystem){
             std::string readBackString = std::to_string(entityIds) + "\n";
             std::cout << readBackString;
         };
 
         headerString = "Entities that have been destroyed:\n";
-        std::vector<ecs_id> destroyedEntityIds_simpleRenderSystem = m_systemManager.getDestroyedSystemEntities(m_simpleRenderSystem->getSystemId());
+        ecs_entityList destroyedEntityIds_simpleRenderSystem = m_systemManager.getDestroyedSystemEntities(m_simpleRenderSystem->getSystemId());
         for (auto entityIds : destroyedEntityIds_simpleRenderSystem){
             std::string readBackString = std::to_string(entityIds) + "\n";
             std::cout << readBackString;
@@ -675,17 +700,17 @@ namespace ae {
         //==============================================================================================================
 
         // Declare a vector to store all the unique images that we find.
-        std::vector<std::shared_ptr<AeImage>> uniqueImages{};
+        std::vector<AeImage*> uniqueImages{};
 
         // Loop through all the simple render system entities and check to make sure all their textures are included in
         // texture the array and their indexes into that array are set correctly for this frame.
         int j = 0;
-        SimplePushConstantData data[MAX_OBJECTS];
+        std::vector<SimplePushConstantData>& data = m_object3DPushData;
         for(auto entityId:validEntityIds_simpleRenderSystem){
             ModelComponentStruct& entityModelData = m_gameComponents.modelComponent.getWriteableDataReference(entityId);
             glm::vec3 entityWorldPosition = m_gameComponents.worldPositionComponent.getWorldPositionVec3(entityId);
 
-            if (entityModelData.m_model == nullptr) continue;
+            if (entityModelData.m_model.isNull()) continue;
 
             // Set the model matrix data to be pushed to the object buffer.
             data[j] = SimpleRenderSystem::calculatePushConstantData(entityWorldPosition,
@@ -694,17 +719,18 @@ namespace ae {
 
             // Check if the object has a texture. If not set it such that the model is rendered using only its vertex
             // colors.
-            if(entityModelData.m_texture == nullptr){
+            if(entityModelData.m_texture.isNull()){
                 data[j].textureIndex = MAX_TEXTURES + 1;
                 j++;
                 continue;
             }
+            AeImage* entityTexture = &m_aeResourceManager.getImage(entityModelData.m_texture);
 
             // Check to see if the texture is already part of the texture array.
             bool imageIsUnique = true;
             for(int i = 0; uniqueImages.size()>i; i++){
                 // If the texture is already part of the array set the data for the object to that texture array index.
-                if(entityModelData.m_texture == uniqueImages[i]){
+                if(entityTexture == uniqueImages[i]){
                     imageIsUnique = false;
                     data[j].textureIndex = i;
                     j++;
@@ -715,14 +741,14 @@ namespace ae {
             // If the image was found to be unique then add it to the texture array and set the object data texture
             // index accordingly.
             if(imageIsUnique){
-                entityModelData.m_texture->setTextureDescriptorIndex(m_frameIndex, uniqueImages.size());
+                entityTexture->setTextureDescriptorIndex(m_frameIndex, uniqueImages.size());
                 data[j].textureIndex = uniqueImages.size();
                 j++;
-                uniqueImages.push_back(entityModelData.m_texture);
+                uniqueImages.push_back(entityTexture);
             };
         };
 
-        m_object3DBuffers[m_frameIndex]->writeToBuffer(&data);
+        m_object3DBuffers[m_frameIndex]->writeToBuffer(data.data());
         m_object3DBuffers[m_frameIndex]->flush();
 
 
@@ -730,7 +756,7 @@ namespace ae {
         // Loop through all the ui render system entities and check to make sure all their textures are included in
         // texture the array and their indexes into that array are set correctly for this frame.
         j = 0;
-        UiPushConstantData data2d[MAX_OBJECTS];
+        std::vector<UiPushConstantData>& data2d = m_object2DPushData;
         for(auto entityId:validEntityIds_uiRenderSystem){
             auto entityModelData = m_gameComponents.model2DComponent.getWriteableDataReference(entityId);
 
@@ -738,15 +764,16 @@ namespace ae {
                                                entityModelData.rotation,
                                                entityModelData.scale);
 
-            if(entityModelData.m_texture == nullptr){
+            if(entityModelData.m_texture.isNull()){
                 data2d[j].textureIndex = MAX_TEXTURES + 1;
                 j++;
                 continue;
             }
+            AeImage* entityTexture = &m_aeResourceManager.getImage(entityModelData.m_texture);
 
             bool imageIsUnique = true;
             for(int i = 0; uniqueImages.size()>i; i++){
-                if(entityModelData.m_texture == uniqueImages[i]){
+                if(entityTexture == uniqueImages[i]){
                     imageIsUnique = false;
                     data2d[j].textureIndex = i;
                     j++;
@@ -754,14 +781,14 @@ namespace ae {
                 };
             };
             if(imageIsUnique){
-                entityModelData.m_texture->setTextureDescriptorIndex(m_frameIndex, uniqueImages.size());
+                entityTexture->setTextureDescriptorIndex(m_frameIndex, uniqueImages.size());
                 data2d[j].textureIndex = uniqueImages.size();
                 j++;
-                uniqueImages.push_back(entityModelData.m_texture);
+                uniqueImages.push_back(entityTexture);
             };
         };
 
-        m_object2DBuffers[m_frameIndex]->writeToBuffer(&data2d);
+        m_object2DBuffers[m_frameIndex]->writeToBuffer(data2d.data());
         m_object2DBuffers[m_frameIndex]->flush();
 
 
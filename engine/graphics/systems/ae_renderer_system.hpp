@@ -6,6 +6,7 @@
 
 #include "ae_ecs_include.hpp"
 #include "ae_engine_constants.hpp"
+#include "ae_engine_config.hpp"
 
 #include "game_components.hpp"
 #include "update_ubo_system.hpp"
@@ -30,6 +31,7 @@
 #include "ae_collision_system.hpp"
 
 #include "pre_allocated_stack.hpp"
+#include "dense_slot_table.hpp"
 
 namespace ae {
 
@@ -47,6 +49,7 @@ namespace ae {
         /// \param t_renderer The Ae_Renderer that this system will interact with to initiate the render pass.
         /// \param t_globalDescriptorSets The global descriptor sets for this class to utilize.
         /// \param t_uboBuffers The ubo buffers this class utilizes.
+        /// \param t_engineLimits The engine limits the object buffers are sized with.
         RendererStartPassSystem(ae_ecs::AeECS& t_ecs,
                                 GameComponents& t_game_components,
                                 UpdateUboSystem& t_updateUboSystem,
@@ -54,7 +57,8 @@ namespace ae {
                                 AeRenderer& t_renderer,
                                 AeDevice& t_aeDevice,
                                 AeSamplers& t_aeSamplers,
-                                AeResourceManager& t_aeResourceManager);
+                                AeResourceManager& t_aeResourceManager,
+                                const AeEngineLimits& t_engineLimits);
 
         /// Destructor of the RendererStartPassSystem
         ~RendererStartPassSystem();
@@ -68,6 +72,10 @@ namespace ae {
         /// Clean up the RendererStartPassSystem, this is handled by the ECS.
         void cleanupSystem() override;
 
+        /// Updates the entity IDs used to track entity data in the 3D SSBO and the image buffer when entities are
+        /// renumbered, this is handled by the ECS.
+        void remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves) override;
+
         /// Returns a reference to the materials available while using this renderer
         GameMaterials& getGameMaterials(){return *m_gameMaterials;}
 
@@ -96,6 +104,9 @@ namespace ae {
         /// Reference to the resource manager for the game.
         AeResourceManager& m_aeResourceManager;
 
+        /// The engine limits the object buffers are sized with.
+        AeEngineLimits m_engineLimits;
+
         /// The frame index for the current render pass.
         int m_frameIndex;
 
@@ -138,7 +149,7 @@ namespace ae {
         AeDescriptorWriter* m_textureDescriptorWriter;
 
         /// The default image for use with the render system.
-        std::shared_ptr<AeImage> m_defaultImage;
+        std::unique_ptr<AeImage> m_defaultImage;
 
         /// Stores images for each frame that are used during rendering.
         VkDescriptorImageInfo m_imageBufferData[MAX_TEXTURES];
@@ -146,8 +157,8 @@ namespace ae {
         /// A stack to track the available texture buffer data indexes.
         PreAllocatedStack<uint64_t,MAX_TEXTURES> m_imageBufferDataIndexStack{};
 
-        /// Stores the image buffer and entity relation for a specific image.
-        std::map<std::shared_ptr<AeImage>,ImageBufferInfo> m_imageBufferEntityMaterialMap{};
+        /// Stores the image buffer and entity relation for each image, indexed by the index of the image handle.
+        std::vector<ImageBufferInfo> m_imageBufferEntityMaterialMap{};
 
         //==============================================================================================================
         // Particles: Compute+Render
@@ -198,6 +209,8 @@ namespace ae {
         /// The object buffers for each frame
         std::vector<std::unique_ptr<AeBuffer>> m_object3DBuffers;
 
+        /// Stores the model matrix and texture data for the 3D object buffer of the frame being rendered.
+        std::vector<SimplePushConstantData> m_object3DPushData;
 
         /// The object descriptor sets used for storing the model matrices and texture indexes.
         std::vector<VkDescriptorSet> m_object3DDescriptorSetsIndirect;
@@ -206,13 +219,11 @@ namespace ae {
         std::vector<std::unique_ptr<AeBuffer>> m_object3DBuffersIndirect;
 
         /// Stores all the entity specific data for 3D models required for rendering a specific frame.
-        std::vector<Entity3DSSBOData> m_object3DBufferData = std::vector<Entity3DSSBOData>(MAX_OBJECTS, Entity3DSSBOData());
+        std::vector<Entity3DSSBOData> m_object3DBufferData;
 
-        /// Maps entities to their model matrix/texture data in the 3D SSBO.
-        std::map<ecs_id, uint32_t> m_object3DBufferEntityMap= std::map<ecs_id, uint32_t>{};
-
-        /// A stack to track the available data positions in the SSBO.
-        PreAllocatedStack<uint64_t,MAX_OBJECTS> m_object3DBufferDataIndexStack{};
+        /// Maps entities to their model matrix/texture data in the 3D SSBO, the entities are kept packed at the start
+        /// of the SSBO so only the data of the entities in the table has to be uploaded.
+        DenseSlotTable m_object3DBufferSlotTable;
 
 
         //==============================================================================================================
@@ -224,6 +235,9 @@ namespace ae {
         /// The object buffers for each frame
         std::vector<std::unique_ptr<AeBuffer>> m_object2DBuffers;
 
+        /// Stores the transform and texture data for the 2D object buffer of the frame being rendered.
+        std::vector<UiPushConstantData> m_object2DPushData;
+
 
         //==============================================================================================================
         // Draw Indirect buffer
@@ -5,15 +5,17 @@
 #include "ae_model_3d_buffer_system.hpp"
 
 // Standard Libraries
-#include <map>
+#include <vector>
 
 namespace ae {
 
     // Constructor implementation
     AeModel3DBufferSystem::AeModel3DBufferSystem(ae_ecs::AeECS &t_ecs,
-                                                 GameComponents &t_game_components)
+                                                 GameComponents &t_game_components,
+                                                 AeResourceManager& t_aeResourceManager)
             : m_worldPositionComponent{t_game_components.worldPositionComponent},
               m_modelComponent{t_game_components.modelComponent},
+              m_aeResourceManager{t_aeResourceManager},
               ae_ecs::AeSystem<AeModel3DBufferSystem>(t_ecs) {
 
         // Register component dependencies
@@ -38,34 +40,30 @@ namespace ae {
     // Manages the model matrix data for the 3D SSBO.
     void AeModel3DBufferSystem::executeSystem(std::vector<ecs_id>&  t_materialComponentIds,
                                               std::vector<Entity3DSSBOData>& t_object3DBufferData,
-                                              std::map<ecs_id, uint32_t>& t_object3DBufferEntityMap,
-                                              PreAllocatedStack<uint64_t,MAX_OBJECTS>& t_object3DBufferDataIndexStack) {
+                                              DenseSlotTable& t_object3DBufferSlotTable) {
 
         // Deal with any entities that were deleted between the last time this system ran and now.
-        std::vector<ecs_id> destroyedEntities = m_systemManager.getDestroyedSystemEntities(m_systemId);
+        ecs_entityList destroyedEntities = m_systemManager.getDestroyedSystemEntities(m_systemId);
 
         // Loop through all the destroyed entities that were compatible with this system.
         for(auto entityId:destroyedEntities){
 
-            // Check to make sure the entity was actually already mapped in the system. If it was then free the buffer
-            // index it was using then remove it from the map.
-            if(t_object3DBufferEntityMap.find(entityId) != t_object3DBufferEntityMap.end()){
-                // Entity was in the map, free its index in the SSBO.
-                t_object3DBufferDataIndexStack.push(t_object3DBufferEntityMap[entityId]);
-
-                // Now that the index has been returned it can be removed from the map.
-                t_object3DBufferEntityMap.erase(entityId);
+            // Free the entity's position in the SSBO if it had one. The entity in the last position is moved into the
+            // freed position so the entities stay packed at the start of the SSBO, its data has to move with it.
+            DenseSlotMove slotMove = t_object3DBufferSlotTable.erase(entityId);
+            if(slotMove.m_fromSlot != slotMove.m_toSlot){
+                t_object3DBufferData[slotMove.m_toSlot] = t_object3DBufferData[slotMove.m_fromSlot];
             };
         };
 
 
 
         // Get the entities with the required components that have updated since the last time this system was run.
-        std::vector<ecs_id> updatedEntities = m_systemManager.getUpdatedSystemEntities(m_systemId);
+        ecs_entityList updatedEntities = m_systemManager.getUpdatedSystemEntities(m_systemId);
 
         // Only are interested in entities that use materials since they are the only entities that will actually be
         // able to be rendered.
-        std::vector<ecs_id> renderableUpdatedEntities = m_systemManager.getEntitiesWithSpecifiedComponents(updatedEntities,
+        ecs_entityList renderableUpdatedEntities = m_systemManager.getEntitiesWithSpecifiedComponents(updatedEntities,
                                                                                                            t_materialComponentIds);
 
         // Loop through all the 3D entities that can be rendered.
@@ -77,36 +75,21 @@ namespace ae {
 
             // Ensure that the entity actually has a model to render. If it has a material attached to it a model should
             // have been attached as well.
-            if (entityModelData.m_model == nullptr){
+            if (entityModelData.m_model.isNull()){
                 // Must be a point light.
                 continue;
             }
+            ssbo_idx modelObbIndex = m_aeResourceManager.get3DModel(entityModelData.m_model).getIdxObbSsbo();
 
-            // If the entity has not already been assigned a buffer position get one to assign to it.
-            auto entitySSBOIndex = t_object3DBufferDataIndexStack.pop();
-
-            // Attempt to put the entity into the map.
-            auto entityObjectBufferIterator = t_object3DBufferEntityMap.insert(std::make_pair(entityId, entitySSBOIndex));
-
-            // If the insert was successful then the entity has been mapped to the assigned buffer position and the data
-            // at that buffer position can be updated.
-            if(entityObjectBufferIterator.second){
-                t_object3DBufferData[entitySSBOIndex] = calculateModelMatrixData(entityWorldPosition,
-                                                                                 entityModelData.rotation,
-                                                                                 entityModelData.scale);
-                t_object3DBufferData[entitySSBOIndex].modelObbIndex = entityModelData.m_model->getIdxObbSsbo();
-            } else {
-                // If the insert failed then the entity must already be assigned a position in the buffer so the newly
-                // assigned position can be given back. This may seem silly but when there are many entities it is
-                // faster to do this than to attempt a find and if it fails to then do an insert.
-                t_object3DBufferDataIndexStack.push(entitySSBOIndex);
-
-                // Update the entities model matrix data.
-                t_object3DBufferData[entityObjectBufferIterator.first->second] = calculateModelMatrixData(entityWorldPosition,
-                                                                                                          entityModelData.rotation,
-                                                                                                          entityModelData.scale);
-                t_object3DBufferData[entityObjectBufferIterator.first->second].modelObbIndex = entityModelData.m_model->getIdxObbSsbo();
-            };
+            // Get the entity's position in the buffer, an entity that does not have one yet is given the position
+            // after the last entity in the buffer.
+            uint32_t entitySSBOIndex = t_object3DBufferSlotTable.insert(entityId).first;
+
+            // Update the entities model matrix data.
+            t_object3DBufferData[entitySSBOIndex] = calculateModelMatrixData(entityWorldPosition,
+                                                                             entityModelData.rotation,
+                                                                             entityModelData.scale);
+            t_object3DBufferData[entitySSBOIndex].modelObbIndex = modelObbIndex;
         };
 
         // Clear the updated entities signatures so if nothing changes they are not updated again.
@@ -8,10 +8,10 @@
 #include "ae_engine_constants.hpp"
 
 #include "game_components.hpp"
-#include "pre_allocated_stack.hpp"
+#include "dense_slot_table.hpp"
 
 
-#include <map>
+#include <vector>
 
 
 namespace ae {
@@ -22,8 +22,10 @@ namespace ae {
     public:
         /// Constructor of the SimpleRenderSystem
         /// \param t_game_components The game components available that this system may require.
+        /// \param t_aeResourceManager The resource manager the models of the entities are loaded by.
         AeModel3DBufferSystem(ae_ecs::AeECS& t_ecs,
-                              GameComponents& t_game_components);
+                              GameComponents& t_game_components,
+                              AeResourceManager& t_aeResourceManager);
 
         /// Destructor of the SimpleRenderSystem
         ~AeModel3DBufferSystem();
@@ -36,10 +38,13 @@ namespace ae {
         };
 
         /// Execute the SimpleRenderSystem, this is handled by the RendererSystem.
+        /// \param t_materialComponentIds The IDs of the material layer components, only entities with one are rendered.
+        /// \param t_object3DBufferData The model matrix data of the entities, in the same order as the 3D SSBO.
+        /// \param t_object3DBufferSlotTable The positions of the entities in the 3D SSBO. Destroyed entities are
+        /// swapped out with the entity in the last position so the entities in the SSBO stay packed at its start.
         void executeSystem(std::vector<ecs_id>&  t_materialComponentIds,
                            std::vector<Entity3DSSBOData>& t_object3DBufferData,
-                           std::map<ecs_id, uint32_t>& t_object3DBufferEntityMap,
-                           PreAllocatedStack<uint64_t,MAX_OBJECTS>& t_object3DBufferDataIndexStack);
+                           DenseSlotTable& t_object3DBufferSlotTable);
 
         /// DO NOT CALL! This is not used by this system.
         void executeSystem() override {
@@ -59,6 +64,9 @@ namespace ae {
         /// The ModelComponent this system accesses to render the entity in the game world.
         ModelComponent& m_modelComponent;
 
+        /// The resource manager the models of the entities are loaded by.
+        AeResourceManager& m_aeResourceManager;
+
         // Prerequisite systems for the SimpleRenderSystem.
         // This requires any world position updating system to run before this system runs.
 
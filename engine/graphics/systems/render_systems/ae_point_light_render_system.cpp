@@ -65,7 +65,7 @@ namespace ae {
     void PointLightRenderSystem::executeSystem(VkCommandBuffer& t_commandBuffer, VkDescriptorSet t_globalDescriptorSet){
 
         // Get the entities that use the components this system depends on.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
         // Declaring a map to sort the point lights by their distance to the camera.
         std::map<float, ecs_id> sorted_point_lights;
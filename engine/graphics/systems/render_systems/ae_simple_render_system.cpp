@@ -12,11 +12,13 @@ namespace ae {
     // Constructor implementation
     SimpleRenderSystem::SimpleRenderSystem(ae_ecs::AeECS& t_ecs,
                                            GameComponents &t_game_components,
+                                           AeResourceManager& t_aeResourceManager,
                                            AeDevice &t_aeDevice,
                                            VkRenderPass t_renderPass,
                                            std::vector<VkDescriptorSetLayout> t_descriptorSetLayouts)
             : m_worldPositionComponent{t_game_components.worldPositionComponent},
               m_modelComponent{t_game_components.modelComponent},
+              m_aeResourceManager{t_aeResourceManager},
               m_aeDevice{t_aeDevice},
               ae_ecs::AeSystem<SimpleRenderSystem>(t_ecs) {
 
@@ -71,7 +73,7 @@ namespace ae {
 
 
         // Get the entities that use the components this system depends on.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
 
         // Loop through the entities if they have models render them.
@@ -80,13 +82,14 @@ namespace ae {
 
             // Make sure the entity actually has a model to render.
             const ModelComponentStruct& entityModelData = m_modelComponent.getReadOnlyDataReference(entityId);
-            if (entityModelData.m_model == nullptr) continue;
+            if (entityModelData.m_model.isNull()) continue;
+            Ae3DModel& entityModel = m_aeResourceManager.get3DModel(entityModelData.m_model);
 
             // Bind the model buffer(s) to the command buffer.
-            entityModelData.m_model->bind(t_commandBuffer);
+            entityModel.bind(t_commandBuffer);
 
             // Draw the model.
-            entityModelData.m_model->draw(t_commandBuffer, j);
+            entityModel.draw(t_commandBuffer, j);
             j++;
         };
     };
@@ -42,8 +42,10 @@ namespace ae {
     public:
         /// Constructor of the SimpleRenderSystem
         /// \param t_game_components The game components available that this system may require.
+        /// \param t_aeResourceManager The resource manager the models of the entities are loaded by.
         SimpleRenderSystem(ae_ecs::AeECS& t_ecs,
                            GameComponents& t_game_components,
+                           AeResourceManager& t_aeResourceManager,
                            AeDevice& t_aeDevice,
                            VkRenderPass t_renderPass,
                            std::vector<VkDescriptorSetLayout> t_descriptorSetLayouts);
@@ -83,6 +85,9 @@ namespace ae {
         /// The ModelComponent this system accesses to render the entity in the game world.
         ModelComponent& m_modelComponent;
 
+        /// The resource manager the models of the entities are loaded by.
+        AeResourceManager& m_aeResourceManager;
+
 
         // Prerequisite systems for the SimpleRenderSystem.
         // This requires any world position updating system to run before this system runs.
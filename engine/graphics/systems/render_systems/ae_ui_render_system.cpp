@@ -78,7 +78,7 @@ namespace ae {
 
 
         // Get the entities that use the components this system depends on.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
 
         // Loop through the entities if they have models render them.
@@ -0,0 +1,554 @@
+/// \file ae_job_system.cpp
+/// The AeJobSystem class is implemented.
+#include "ae_job_system.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ae_jobs {
+
+    namespace {
+
+        /// The bit of a job's state set once the job has finished.
+        constexpr uint64_t FINISHED_BIT = uint64_t{1} << 31;
+
+        /// The bits of a job's state holding the ID of the first link of the list of jobs waiting on it.
+        constexpr uint64_t LINK_MASK = FINISHED_BIT - 1;
+
+        /// The number of times an idle worker looks for work again before falling asleep.
+        constexpr int NUM_IDLE_SPINS = 64;
+
+        /// Packs the generation, finished bit and first link of a job's state.
+        uint64_t makeJobState(uint32_t t_generation, bool t_isFinished, uint32_t t_linkId) {
+            return (uint64_t{t_generation} << 32) | (t_isFinished ? FINISHED_BIT : 0) | t_linkId;
+        };
+
+        /// Gets the generation of a job's state.
+        uint32_t getJobGeneration(uint64_t t_state) { return static_cast<uint32_t>(t_state >> 32); };
+
+        /// Gets the time in nanoseconds since some fixed point, for measuring how long workers are idle.
+        uint64_t getTimeNs() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        };
+
+        /// Pins a thread to a core. Pinning is only a hint to keep a worker's jobs in its core's caches, so it is
+        /// skipped where it is not supported and failures are ignored.
+        void pinThreadToCore(std::thread& t_thread, std::size_t t_core) {
+#if defined(_WIN32)
+            SetThreadAffinityMask(t_thread.native_handle(), DWORD_PTR{1} << (t_core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(t_core % CPU_SETSIZE, &cpuSet);
+            pthread_setaffinity_np(t_thread.native_handle(), sizeof(cpu_set_t), &cpuSet);
+#else
+            (void)t_thread;
+            (void)t_core;
+#endif
+        };
+    }
+
+
+
+    // Create the job slots and queues, then start the workers.
+    AeJobSystem::AeJobSystem(std::size_t t_numWorkers,
+                             std::size_t t_maxJobs,
+                             bool t_pinWorkers,
+                             ae_memory::AeAllocatorBase* t_allocator) :
+            m_jobs{std::make_unique<Job[]>(t_maxJobs)},
+            m_maxJobs{t_maxJobs},
+            m_freeJobs{t_maxJobs, t_allocator},
+            m_sharedQueue{t_maxJobs, t_allocator} {
+        // Every link of every job needs an ID that fits in the state of a job.
+        if (t_maxJobs == 0 || t_maxJobs * MAX_DEPENDENCIES >= LINK_MASK) {
+            throw std::runtime_error("The job system can hold between 1 and " + std::to_string(LINK_MASK / MAX_DEPENDENCIES)
+                                     + " jobs at once!");
+        };
+
+        for (std::size_t jobIndex = 0; jobIndex < m_maxJobs; jobIndex++) {
+            m_jobs[jobIndex].m_state.store(makeJobState(0, true, 0), std::memory_order_relaxed);
+            m_freeJobs.tryPush(static_cast<uint32_t>(jobIndex));
+        };
+
+        for (std::size_t workerIndex = 0; workerIndex < t_numWorkers; workerIndex++) {
+            m_workers.push_back(std::make_unique<Worker>(*this, workerIndex, t_allocator));
+        };
+
+        // Every worker exists before any starts so they can all be stolen from.
+        std::size_t numCores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        for (std::size_t workerIndex = 0; workerIndex < t_numWorkers; workerIndex++) {
+            m_threads.emplace_back([this, workerIndex]() { workerLoop(*m_workers[workerIndex]); });
+            if (t_pinWorkers) {
+                pinThreadToCore(m_threads.back(), (workerIndex + 1) % numCores);
+            };
+        };
+    };
+
+
+
+    // Run the remaining jobs, then wake every worker so it sees it should stop.
+    AeJobSystem::~AeJobSystem() {
+        while (m_freeJobs.sizeApprox() < m_maxJobs) {
+            if (!helpRunJob()) {
+                std::this_thread::yield();
+            };
+        };
+
+        m_isStopping.store(true);
+        {
+            std::lock_guard<std::mutex> lock{m_sleepMutex};
+        };
+        m_workAvailable.notify_all();
+        for (auto& thread: m_threads) {
+            thread.join();
+        };
+    };
+
+
+
+    // Fill a free slot with the task, link it to its dependencies and queue it once they have all finished.
+    AeJobHandle AeJobSystem::schedule(std::function<void()> t_task, std::initializer_list<AeJobHandle> t_dependencies) {
+        if (t_dependencies.size() > MAX_DEPENDENCIES) {
+            throw std::runtime_error("A job can depend on at most " + std::to_string(MAX_DEPENDENCIES)
+                                     + " jobs, make a job that depends on some of them and depend on it instead!");
+        };
+
+        uint32_t jobIndex = acquireJob();
+        Job& job = m_jobs[jobIndex];
+        AeJobHandle handle{jobIndex, getJobGeneration(job.m_state.load(std::memory_order_relaxed))};
+        job.m_task = std::move(t_task);
+        job.m_parent = m_currentLoopIndex;
+        job.m_numUnfinished.store(1, std::memory_order_relaxed);
+
+        // The job holds an extra dependency on itself while it is linked so it can not be queued part way through.
+        job.m_numPendingDependencies.store(1, std::memory_order_relaxed);
+        std::size_t linkIndex = 0;
+        for (AeJobHandle dependency: t_dependencies) {
+            if (!dependency.isValid()) {
+                continue;
+            };
+            job.m_numPendingDependencies.fetch_add(1, std::memory_order_relaxed);
+            if (addDependent(dependency, jobIndex, linkIndex)) {
+                linkIndex++;
+            } else {
+                job.m_numPendingDependencies.fetch_sub(1, std::memory_order_relaxed);
+            };
+        };
+
+        releaseDependency(jobIndex);
+        return handle;
+    };
+
+
+
+    // Schedule a job that, once its dependencies have finished, schedules a job for each batch as its children.
+    AeJobHandle AeJobSystem::scheduleParallelFor(std::size_t t_count,
+                                                 std::size_t t_batchSize,
+                                                 std::function<void(std::size_t, std::size_t)> t_task,
+                                                 std::initializer_list<AeJobHandle> t_dependencies) {
+        // A few batches per thread lets the threads that finish early steal from those that do not.
+        if (t_batchSize == 0) {
+            std::size_t numBatches = getNumThreads() * 4;
+            t_batchSize = std::max<std::size_t>((t_count + numBatches - 1) / numBatches, 1);
+        };
+
+        return schedule([this, t_count, t_batchSize, task = std::move(t_task)]() {
+            // The batches only capture the loop job and their index, so their tasks fit in a std::function without
+            // allocating. The loop job's task, and so the task of the loop, lives until every batch has finished.
+            std::size_t numBatches = (t_count + t_batchSize - 1) / t_batchSize;
+            const auto* loopTask = &task;
+            uint32_t loopIndex = m_currentJobIndex;
+            uint32_t outerLoopIndex = m_currentLoopIndex;
+            m_currentLoopIndex = loopIndex;
+            for (std::size_t batchIndex = 1; batchIndex < numBatches; batchIndex++) {
+                m_jobs[loopIndex].m_numUnfinished.fetch_add(1, std::memory_order_relaxed);
+                schedule([loopTask, batchIndex, t_count, t_batchSize]() {
+                    std::size_t begin = batchIndex * t_batchSize;
+                    (*loopTask)(begin, std::min(begin + t_batchSize, t_count));
+                });
+            };
+            m_currentLoopIndex = outerLoopIndex;
+
+            // The first batch is run straight away by the thread that split the loop.
+            if (t_count > 0) {
+                task(0, std::min(t_batchSize, t_count));
+            };
+        }, t_dependencies);
+    };
+
+
+
+    // Schedule the loop and help run it.
+    void AeJobSystem::parallelFor(std::size_t t_count,
+                                  std::size_t t_batchSize,
+                                  const std::function<void(std::size_t, std::size_t)>& t_task) {
+        if (t_count == 0) {
+            return;
+        };
+        wait(scheduleParallelFor(t_count, t_batchSize, [&t_task](std::size_t t_begin, std::size_t t_end) {
+            t_task(t_begin, t_end);
+        }));
+    };
+
+
+
+    // Run a batch of a single index for each task.
+    void AeJobSystem::parallelFor(std::size_t t_numTasks, const std::function<void(std::size_t)>& t_task) {
+        parallelFor(t_numTasks, 1, [&t_task](std::size_t t_begin, std::size_t t_end) {
+            for (std::size_t i = t_begin; i < t_end; i++) {
+                t_task(i);
+            };
+        });
+    };
+
+
+
+    // Run other jobs until the job has finished, counting the time no job could be found as idle.
+    void AeJobSystem::wait(AeJobHandle t_job) {
+        Worker* worker = getCurrentWorker();
+        while (!isFinished(t_job)) {
+            if (helpRunJob()) {
+                continue;
+            };
+            uint64_t idleStart = getTimeNs();
+            std::this_thread::yield();
+            (worker ? worker->m_idleNs : m_helperIdleNs).fetch_add(getTimeNs() - idleStart,
+                                                                    std::memory_order_relaxed);
+        };
+        rethrowJobException();
+    };
+
+
+
+    // A job has finished once its slot has been reused or it has been marked as finished.
+    bool AeJobSystem::isFinished(AeJobHandle t_job) const {
+        if (!t_job.isValid()) {
+            return true;
+        };
+        uint64_t state = m_jobs[t_job.m_index].m_state.load(std::memory_order_acquire);
+        return getJobGeneration(state) != t_job.m_generation || (state & FINISHED_BIT) != 0;
+    };
+
+
+
+    // Copy each worker's counters.
+    std::vector<AeJobStatistics> AeJobSystem::getWorkerStatistics() const {
+        std::vector<AeJobStatistics> statistics;
+        for (const auto& worker: m_workers) {
+            statistics.push_back({worker->m_numJobsRun.load(std::memory_order_relaxed),
+                                  worker->m_numStealAttempts.load(std::memory_order_relaxed),
+                                  worker->m_numSteals.load(std::memory_order_relaxed),
+                                  worker->m_idleNs.load(std::memory_order_relaxed)});
+        };
+        return statistics;
+    };
+
+
+
+    // Copy the counters shared by the threads that are not workers.
+    AeJobStatistics AeJobSystem::getHelperStatistics() const {
+        return {m_helperNumJobsRun.load(std::memory_order_relaxed),
+                m_helperNumStealAttempts.load(std::memory_order_relaxed),
+                m_helperNumSteals.load(std::memory_order_relaxed),
+                m_helperIdleNs.load(std::memory_order_relaxed)};
+    };
+
+
+
+    // Zero every counter.
+    void AeJobSystem::resetStatistics() {
+        for (auto& worker: m_workers) {
+            worker->m_numJobsRun.store(0, std::memory_order_relaxed);
+            worker->m_numStealAttempts.store(0, std::memory_order_relaxed);
+            worker->m_numSteals.store(0, std::memory_order_relaxed);
+            worker->m_idleNs.store(0, std::memory_order_relaxed);
+        };
+        m_helperNumJobsRun.store(0, std::memory_order_relaxed);
+        m_helperNumStealAttempts.store(0, std::memory_order_relaxed);
+        m_helperNumSteals.store(0, std::memory_order_relaxed);
+        m_helperIdleNs.store(0, std::memory_order_relaxed);
+    };
+
+
+
+    // Leave a core for the main thread.
+    std::size_t AeJobSystem::defaultNumWorkers() {
+        return std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+    };
+
+
+
+    // Run jobs until the job system is destroyed, spinning for a while when there are none before falling asleep.
+    void AeJobSystem::workerLoop(Worker& t_worker) {
+        m_currentWorker = &t_worker;
+        while (true) {
+            uint32_t jobIndex = 0;
+            if (findJob(&t_worker, jobIndex)) {
+                runJob(jobIndex);
+                t_worker.m_numJobsRun.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            };
+
+            uint64_t idleStart = getTimeNs();
+            bool isFound = false;
+            for (int spin = 0; spin < NUM_IDLE_SPINS && !isFound; spin++) {
+                std::this_thread::yield();
+                isFound = findJob(&t_worker, jobIndex);
+            };
+
+            // The worker announces it is going to sleep before looking one last time. Anything queued after that look
+            // moves the epoch on, and whoever queued it sees the sleeping worker and wakes it.
+            if (!isFound && !m_isStopping.load()) {
+                uint64_t workEpoch = m_workEpoch.load();
+                m_numSleepingWorkers.fetch_add(1);
+                isFound = findJob(&t_worker, jobIndex);
+                if (!isFound) {
+                    std::unique_lock<std::mutex> lock{m_sleepMutex};
+                    m_workAvailable.wait(lock, [&]() {
+                        return m_workEpoch.load() != workEpoch || m_isStopping.load();
+                    });
+                };
+                m_numSleepingWorkers.fetch_sub(1);
+            };
+            t_worker.m_idleNs.fetch_add(getTimeNs() - idleStart, std::memory_order_relaxed);
+
+            if (isFound) {
+                runJob(jobIndex);
+                t_worker.m_numJobsRun.fetch_add(1, std::memory_order_relaxed);
+            } else if (m_isStopping.load()) {
+                break;
+            };
+        };
+        m_currentWorker = nullptr;
+    };
+
+
+
+    // Take a free slot and move it on to a new generation, so handles to the job that used it before see it finished.
+    uint32_t AeJobSystem::acquireJob() {
+        uint32_t jobIndex = 0;
+        while (!m_freeJobs.tryPop(jobIndex)) {
+            if (!helpRunJob()) {
+                std::this_thread::yield();
+            };
+        };
+
+        Job& job = m_jobs[jobIndex];
+        uint32_t generation = getJobGeneration(job.m_state.load(std::memory_order_relaxed)) + 1;
+        job.m_state.store(makeJobState(generation, false, 0), std::memory_order_release);
+        return jobIndex;
+    };
+
+
+
+    // Queue the job once the last job it waits on has finished.
+    void AeJobSystem::releaseDependency(uint32_t t_jobIndex) {
+        if (m_jobs[t_jobIndex].m_numPendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            enqueueJob(t_jobIndex);
+        };
+    };
+
+
+
+    // Finish the job once its task and every batch of it have finished.
+    void AeJobSystem::completeJob(uint32_t t_jobIndex) {
+        if (m_jobs[t_jobIndex].m_numUnfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finishJob(t_jobIndex);
+        };
+    };
+
+
+
+    // Close the list of jobs waiting on the job, release each of them and free the slot.
+    void AeJobSystem::finishJob(uint32_t t_jobIndex) {
+        Job& job = m_jobs[t_jobIndex];
+        job.m_task = nullptr;
+        uint32_t parent = job.m_parent;
+
+        uint64_t state = job.m_state.load(std::memory_order_relaxed);
+        state = job.m_state.exchange(makeJobState(getJobGeneration(state), true, 0), std::memory_order_acq_rel);
+
+        // A released job may run and reuse its links straight away, so the next link is read before releasing.
+        auto linkId = static_cast<uint32_t>(state & LINK_MASK);
+        while (linkId != 0) {
+            const DependencyLink& link = m_jobs[(linkId - 1) / MAX_DEPENDENCIES].m_links[(linkId - 1) % MAX_DEPENDENCIES];
+            uint32_t nextLinkId = link.m_next;
+            releaseDependency(link.m_dependent);
+            linkId = nextLinkId;
+        };
+
+        m_freeJobs.tryPush(t_jobIndex);
+        if (parent != AeJobHandle::INVALID_INDEX) {
+            completeJob(parent);
+        };
+    };
+
+
+
+    // Workers keep their own jobs, so the jobs they make next run on the same core.
+    void AeJobSystem::enqueueJob(uint32_t t_jobIndex) {
+        Worker* worker = getCurrentWorker();
+        if (worker) {
+            worker->m_deque.push(t_jobIndex);
+        } else {
+            // The shared queue holds as many jobs as there are slots, so it is never full for long.
+            while (!m_sharedQueue.tryPush(t_jobIndex)) {
+                std::this_thread::yield();
+            };
+        };
+        notifyWorkers();
+    };
+
+
+
+    // Run the task, keeping the first exception for the next wait, and remember which job is running for the loops
+    // the task may split into batches.
+    void AeJobSystem::runJob(uint32_t t_jobIndex) {
+        uint32_t outerJobIndex = m_currentJobIndex;
+        uint32_t outerLoopIndex = m_currentLoopIndex;
+        m_currentJobIndex = t_jobIndex;
+        m_currentLoopIndex = AeJobHandle::INVALID_INDEX;
+        try {
+            if (m_jobs[t_jobIndex].m_task) {
+                m_jobs[t_jobIndex].m_task();
+            };
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{m_exceptionMutex};
+            if (!m_jobException) {
+                m_jobException = std::current_exception();
+            };
+        };
+        m_currentJobIndex = outerJobIndex;
+        m_currentLoopIndex = outerLoopIndex;
+        completeJob(t_jobIndex);
+    };
+
+
+
+    // Look in the worker's own deque, then the shared queue, then steal starting from a random worker.
+    bool AeJobSystem::findJob(Worker* t_worker, uint32_t& t_jobIndex) {
+        if (t_worker && t_worker->m_deque.pop(t_jobIndex)) {
+            return true;
+        };
+        if (m_sharedQueue.tryPop(t_jobIndex)) {
+            return true;
+        };
+
+        std::size_t numWorkers = m_workers.size();
+        if (numWorkers == 0) {
+            return false;
+        };
+
+        static thread_local uint64_t helperRandomState = 0x2545F4914F6CDD1Dull;
+        uint64_t& randomState = t_worker ? t_worker->m_randomState : helperRandomState;
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 7;
+        randomState ^= randomState << 17;
+
+        std::size_t start = static_cast<std::size_t>(randomState % numWorkers);
+        for (std::size_t i = 0; i < numWorkers; i++) {
+            std::size_t victim = (start + i) % numWorkers;
+            if (t_worker && victim == t_worker->m_index) {
+                continue;
+            };
+            (t_worker ? t_worker->m_numStealAttempts : m_helperNumStealAttempts).fetch_add(1,
+                                                                                           std::memory_order_relaxed);
+            if (m_workers[victim]->m_deque.steal(t_jobIndex)) {
+                (t_worker ? t_worker->m_numSteals : m_helperNumSteals).fetch_add(1, std::memory_order_relaxed);
+                return true;
+            };
+        };
+        return false;
+    };
+
+
+
+    // Run one job found the same way a worker would find one.
+    bool AeJobSystem::helpRunJob() {
+        Worker* worker = getCurrentWorker();
+        uint32_t jobIndex = 0;
+        if (!findJob(worker, jobIndex)) {
+            return false;
+        };
+        runJob(jobIndex);
+        (worker ? worker->m_numJobsRun : m_helperNumJobsRun).fetch_add(1, std::memory_order_relaxed);
+        return true;
+    };
+
+
+
+    // Push the link onto the front of the dependency's list, as long as the dependency is the same job and has not
+    // finished. Comparing the whole state means a finished or reused slot is never linked to.
+    bool AeJobSystem::addDependent(AeJobHandle t_dependency, uint32_t t_dependentIndex, std::size_t t_linkIndex) {
+        if (t_dependency.m_index >= m_maxJobs) {
+            throw std::runtime_error("Attempting to depend on a job handle that is not from this job system!");
+        };
+
+        Job& dependency = m_jobs[t_dependency.m_index];
+        DependencyLink& link = m_jobs[t_dependentIndex].m_links[t_linkIndex];
+        link.m_dependent = t_dependentIndex;
+        auto linkId = static_cast<uint32_t>(t_dependentIndex * MAX_DEPENDENCIES + t_linkIndex + 1);
+
+        uint64_t state = dependency.m_state.load(std::memory_order_acquire);
+        do {
+            if (getJobGeneration(state) != t_dependency.m_generation || (state & FINISHED_BIT) != 0) {
+                return false;
+            };
+            link.m_next = static_cast<uint32_t>(state & LINK_MASK);
+        } while (!dependency.m_state.compare_exchange_weak(state, (state & ~LINK_MASK) | linkId,
+                                                           std::memory_order_release, std::memory_order_acquire));
+        return true;
+    };
+
+
+
+    // Move the epoch on and wake a worker if any are asleep. Taking the lock makes sure a worker that has just checked
+    // the epoch is waiting before it is notified.
+    void AeJobSystem::notifyWorkers() {
+        m_workEpoch.fetch_add(1);
+        if (m_numSleepingWorkers.load() > 0) {
+            {
+                std::lock_guard<std::mutex> lock{m_sleepMutex};
+            };
+            m_workAvailable.notify_one();
+        };
+    };
+
+
+
+    // Rethrow and forget the first exception a job threw.
+    void AeJobSystem::rethrowJobException() {
+        std::exception_ptr jobException;
+        {
+            std::lock_guard<std::mutex> lock{m_exceptionMutex};
+            std::swap(jobException, m_jobException);
+        };
+        if (jobException) {
+            std::rethrow_exception(jobException);
+        };
+    };
+
+
+
+    // The current worker only counts if it belongs to this job system.
+    AeJobSystem::Worker* AeJobSystem::getCurrentWorker() const {
+        return m_currentWorker && &m_currentWorker->m_jobSystem == this ? m_currentWorker : nullptr;
+    };
+
+} // namespace ae_jobs
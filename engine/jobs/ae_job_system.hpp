@@ -0,0 +1,330 @@
+/// \file ae_job_system.hpp
+/// The AeJobSystem class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "allocator_buffer.hpp"
+#include "mpmc_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+// libraries
+
+//std
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ae_jobs {
+
+    /// Refers to a job that has been scheduled. A handle stays valid after its job has finished and the job's slot has
+    /// been reused, it then simply reports the job as finished.
+    struct AeJobHandle {
+        /// The value of the index of a handle that refers to no job.
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        /// The slot of the job.
+        uint32_t m_index = INVALID_INDEX;
+
+        /// The generation of the slot when the job was scheduled.
+        uint32_t m_generation = 0;
+
+        /// Checks if the handle refers to a job.
+        [[nodiscard]] bool isValid() const { return m_index != INVALID_INDEX; };
+    };
+
+    /// How a thread of the job system has spent its time since the statistics were last reset.
+    struct AeJobStatistics {
+        /// The number of jobs the thread ran.
+        uint64_t m_numJobsRun = 0;
+
+        /// The number of times the thread tried to steal a job from another worker.
+        uint64_t m_numStealAttempts = 0;
+
+        /// The number of jobs the thread stole from another worker.
+        uint64_t m_numSteals = 0;
+
+        /// The time the thread spent looking for work without finding any, or asleep, in nanoseconds.
+        uint64_t m_idleNs = 0;
+    };
+
+    /// The threading backbone of the engine. A fixed set of worker threads, each pinned to its own core, run jobs: a
+    /// task that may wait on other jobs to finish first. Each worker keeps the jobs it makes in a work stealing deque,
+    /// running the newest first while idle workers steal the oldest. Jobs made by other threads, such as the main
+    /// thread, go into a shared queue every worker takes from. A thread that waits on a job runs other jobs in the
+    /// meantime rather than blocking, so the main thread does its share of the work. Jobs live in a fixed number of
+    /// slots that are reused once a job has finished, scheduling takes no locks and allocates nothing unless the task
+    /// captures more than fits in a std::function.
+    class AeJobSystem {
+    public:
+
+        /// The most jobs a job can wait on, wait on a job that waits on the others for more.
+        static constexpr std::size_t MAX_DEPENDENCIES = 8;
+
+        /// The number of jobs that can be scheduled and not yet finished at once by default.
+        static constexpr std::size_t DEFAULT_MAX_JOBS = 4096;
+
+        /// Creates the job system and starts its workers.
+        /// \param t_numWorkers The number of worker threads. By default one fewer than the hardware threads, leaving a
+        /// core for the main thread which helps while it waits.
+        /// \param t_maxJobs The number of jobs that can be scheduled and not yet finished at once.
+        /// \param t_pinWorkers If each worker is pinned to its own core, starting from the second core.
+        /// \param t_allocator The allocator the job queues are borrowed from, nullptr for the heap. It is used by the
+        /// workers whenever their deques grow, so must be thread safe.
+        explicit AeJobSystem(std::size_t t_numWorkers = defaultNumWorkers(),
+                             std::size_t t_maxJobs = DEFAULT_MAX_JOBS,
+                             bool t_pinWorkers = true,
+                             ae_memory::AeAllocatorBase* t_allocator = nullptr);
+
+        /// Waits for every scheduled job to finish, then stops and joins the workers.
+        ~AeJobSystem();
+
+        /// Do not allow this class to be copied (2 lines below)
+        AeJobSystem(const AeJobSystem&) = delete;
+        AeJobSystem& operator=(const AeJobSystem&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeJobSystem(AeJobSystem&&) = delete;
+        AeJobSystem& operator=(AeJobSystem&&) = delete;
+
+        /// Schedules a task to run on a worker once every job it depends on has finished. Safe to call from any
+        /// thread, including from inside a job.
+        /// \param t_task The task.
+        /// \param t_dependencies The jobs that must finish before the task runs, invalid handles are ignored.
+        /// \return The handle of the job.
+        AeJobHandle schedule(std::function<void()> t_task, std::initializer_list<AeJobHandle> t_dependencies = {});
+
+        /// Schedules a loop over a range of indices split into batches that run as separate jobs, once every job it
+        /// depends on has finished.
+        /// \param t_count The number of indices, the loop runs over 0 to t_count - 1.
+        /// \param t_batchSize The number of indices each job runs, 0 to split the range into a few batches for
+        /// each thread.
+        /// \param t_task The task, given the first and one past the last index of a batch. It is called from several
+        /// threads at once.
+        /// \param t_dependencies The jobs that must finish before the loop starts.
+        /// \return The handle of a job that finishes once every batch has finished.
+        AeJobHandle scheduleParallelFor(std::size_t t_count,
+                                        std::size_t t_batchSize,
+                                        std::function<void(std::size_t, std::size_t)> t_task,
+                                        std::initializer_list<AeJobHandle> t_dependencies = {});
+
+        /// Runs a loop over a range of indices split into batches and returns once every batch has finished, the
+        /// calling thread runs batches as well.
+        /// \param t_count The number of indices, the loop runs over 0 to t_count - 1.
+        /// \param t_batchSize The number of indices each job runs, 0 to split the range into a few batches for
+        /// each thread.
+        /// \param t_task The task, given the first and one past the last index of a batch.
+        /// \throws The first exception thrown by a job since the last wait.
+        void parallelFor(std::size_t t_count,
+                         std::size_t t_batchSize,
+                         const std::function<void(std::size_t, std::size_t)>& t_task);
+
+        /// Runs a task once for each index from 0 to t_numTasks and returns once every task has finished, the same as
+        /// AeThreadPool::parallelFor so the job system can run the library's parallel algorithms.
+        /// \param t_numTasks The number of tasks.
+        /// \param t_task The task, given the index of the task to run.
+        /// \throws The first exception thrown by a job since the last wait.
+        void parallelFor(std::size_t t_numTasks, const std::function<void(std::size_t)>& t_task);
+
+        /// Waits for a job to finish, running other jobs in the meantime.
+        /// \param t_job The job.
+        /// \throws The first exception thrown by a job since the last wait.
+        void wait(AeJobHandle t_job);
+
+        /// Checks if a job has finished.
+        /// \param t_job The job.
+        /// \return True if the job has finished, or the handle is invalid.
+        [[nodiscard]] bool isFinished(AeJobHandle t_job) const;
+
+        /// Gets the number of threads that run jobs, the workers and the thread waiting on them.
+        [[nodiscard]] std::size_t getNumThreads() const { return m_workers.size() + 1; };
+
+        /// Gets the number of worker threads.
+        [[nodiscard]] std::size_t getNumWorkers() const { return m_workers.size(); };
+
+        /// Gets the statistics of each worker.
+        [[nodiscard]] std::vector<AeJobStatistics> getWorkerStatistics() const;
+
+        /// Gets the statistics of the threads that are not workers, summed, from the jobs they ran while waiting.
+        [[nodiscard]] AeJobStatistics getHelperStatistics() const;
+
+        /// Sets every statistic back to zero.
+        void resetStatistics();
+
+        /// Gets the default number of worker threads, one fewer than the hardware threads but at least one.
+        static std::size_t defaultNumWorkers();
+
+    private:
+
+        /// A link in the list of jobs waiting on a job, kept in the waiting job.
+        struct DependencyLink {
+            /// The job that is waiting.
+            uint32_t m_dependent = 0;
+
+            /// The ID of the next link in the list, 0 for none.
+            uint32_t m_next = 0;
+        };
+
+        /// A slot of a job. The state packs the slot's generation in the upper 32 bits, a bit set once the job has
+        /// finished, and the ID of the first link of the list of jobs waiting on it in the lower 31 bits. Keeping them
+        /// in one word lets a job be added to the list, finished and reused without a lock or a race between them.
+        struct alignas(ae::CACHE_LINE_SIZE) Job {
+            /// The generation, finished bit and first dependent of the job.
+            std::atomic<uint64_t> m_state{0};
+
+            /// The number of unfinished jobs this job waits on, plus one while it is being scheduled.
+            std::atomic<uint32_t> m_numPendingDependencies{0};
+
+            /// The number of unfinished batches of a loop, plus one for the job's own task.
+            std::atomic<uint32_t> m_numUnfinished{0};
+
+            /// The job whose number of unfinished batches this job is part of, INVALID_INDEX for none.
+            uint32_t m_parent = AeJobHandle::INVALID_INDEX;
+
+            /// The task.
+            std::function<void()> m_task;
+
+            /// The links this job is added to the lists of the jobs it waits on with.
+            DependencyLink m_links[MAX_DEPENDENCIES];
+        };
+
+        /// The queue and statistics of a worker, on cache lines of their own.
+        struct alignas(ae::CACHE_LINE_SIZE) Worker {
+            Worker(AeJobSystem& t_jobSystem, std::size_t t_index, ae_memory::AeAllocatorBase* t_allocator) :
+                    m_jobSystem{t_jobSystem},
+                    m_index{t_index},
+                    m_deque{256, t_allocator},
+                    m_randomState{0x9E3779B97F4A7C15ull * (t_index + 1)} {};
+
+            /// The job system the worker belongs to.
+            AeJobSystem& m_jobSystem;
+
+            /// The index of the worker.
+            std::size_t m_index;
+
+            /// The jobs made by the worker, stolen by the others.
+            ae::WorkStealingDeque<uint32_t> m_deque;
+
+            /// The state of the generator that picks which workers to steal from.
+            uint64_t m_randomState;
+
+            /// The statistics of the worker.
+            std::atomic<uint64_t> m_numJobsRun{0};
+            std::atomic<uint64_t> m_numStealAttempts{0};
+            std::atomic<uint64_t> m_numSteals{0};
+            std::atomic<uint64_t> m_idleNs{0};
+        };
+
+        /// The loop each worker runs until the job system is destroyed.
+        void workerLoop(Worker& t_worker);
+
+        /// Takes a free job slot, running jobs while none are free.
+        /// \return The index of the slot.
+        uint32_t acquireJob();
+
+        /// Gives a job one fewer job to wait on, queueing it once it waits on none.
+        void releaseDependency(uint32_t t_jobIndex);
+
+        /// Gives a job one fewer unfinished batch, or its own task, finishing it once none are left.
+        void completeJob(uint32_t t_jobIndex);
+
+        /// Marks a job as finished, releases the jobs waiting on it and frees its slot.
+        void finishJob(uint32_t t_jobIndex);
+
+        /// Queues a job to run, on the calling worker's deque or on the shared queue.
+        void enqueueJob(uint32_t t_jobIndex);
+
+        /// Runs a job and completes it.
+        void runJob(uint32_t t_jobIndex);
+
+        /// Finds a job for the calling thread to run: from its own deque if it is a worker, then the shared queue,
+        /// then by stealing from the other workers.
+        /// \param t_worker The calling worker, nullptr if the calling thread is not a worker.
+        /// \param t_jobIndex Set to the job found.
+        /// \return True if a job was found.
+        bool findJob(Worker* t_worker, uint32_t& t_jobIndex);
+
+        /// Runs a single job if one can be found, used by threads waiting on a job.
+        /// \return True if a job was run.
+        bool helpRunJob();
+
+        /// Adds a job to the list of jobs waiting on another.
+        /// \return False if the other job has already finished, so there is nothing to wait on.
+        bool addDependent(AeJobHandle t_dependency, uint32_t t_dependentIndex, std::size_t t_linkIndex);
+
+        /// Wakes a sleeping worker after a job has been queued.
+        void notifyWorkers();
+
+        /// Rethrows the first exception thrown by a job since the last time it was rethrown.
+        void rethrowJobException();
+
+        /// Gets the worker of this job system the calling thread is, nullptr if it is not one.
+        Worker* getCurrentWorker() const;
+
+        /// The job slots.
+        std::unique_ptr<Job[]> m_jobs;
+
+        /// The number of job slots.
+        std::size_t m_maxJobs;
+
+        /// The indices of the free job slots.
+        ae::MpmcQueue<uint32_t> m_freeJobs;
+
+        /// The jobs queued by threads that are not workers.
+        ae::MpmcQueue<uint32_t> m_sharedQueue;
+
+        /// The queues and statistics of the workers.
+        std::vector<std::unique_ptr<Worker>> m_workers;
+
+        /// The worker threads.
+        std::vector<std::thread> m_threads;
+
+        /// The statistics of the threads that are not workers.
+        std::atomic<uint64_t> m_helperNumJobsRun{0};
+        std::atomic<uint64_t> m_helperNumStealAttempts{0};
+        std::atomic<uint64_t> m_helperNumSteals{0};
+        std::atomic<uint64_t> m_helperIdleNs{0};
+
+        /// Counts the jobs queued, so a worker going to sleep can tell if a job was queued since it last looked.
+        alignas(ae::CACHE_LINE_SIZE) std::atomic<uint64_t> m_workEpoch{0};
+
+        /// The number of workers asleep or about to fall asleep.
+        std::atomic<uint32_t> m_numSleepingWorkers{0};
+
+        /// Guards the sleeping of the workers.
+        std::mutex m_sleepMutex;
+
+        /// Wakes the workers when a job is queued.
+        std::condition_variable m_workAvailable;
+
+        /// Set when the workers should stop.
+        std::atomic<bool> m_isStopping{false};
+
+        /// The first exception thrown by a job since it was last rethrown.
+        std::exception_ptr m_jobException;
+
+        /// Guards the job exception.
+        std::mutex m_exceptionMutex;
+
+        /// The worker the current thread is, nullptr if it is not a worker of any job system.
+        inline static thread_local Worker* m_currentWorker = nullptr;
+
+        /// The job the current thread is running, INVALID_INDEX for none.
+        inline static thread_local uint32_t m_currentJobIndex = AeJobHandle::INVALID_INDEX;
+
+        /// The loop job the current thread is splitting into batches, which the jobs it schedules are batches of.
+        inline static thread_local uint32_t m_currentLoopIndex = AeJobHandle::INVALID_INDEX;
+
+    protected:
+
+    };
+
+} // namespace ae_jobs
@@ -0,0 +1,82 @@
+/// \file allocator_buffer.hpp
+/// The AllocatorBuffer class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+namespace ae {
+
+    /// The size of a cache line. Data written by different threads is kept this far apart so that writing it does not
+    /// invalidate the cache line the other thread is reading.
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    /// Uninitialised memory borrowed from an engine allocator, or from the heap without one, for the lifetime of the
+    /// buffer. The library's containers keep their elements in one so the engine decides where their memory comes from.
+    class AllocatorBuffer {
+    public:
+
+        /// Borrows the memory.
+        /// \param t_allocator The allocator the memory is borrowed from, nullptr for the heap.
+        /// \param t_size The size of the memory in bytes, no memory is borrowed for a size of 0.
+        /// \param t_alignment The alignment of the memory in bytes, a power of two.
+        AllocatorBuffer(ae_memory::AeAllocatorBase* t_allocator, std::size_t t_size, std::size_t t_alignment) :
+                m_allocator{t_allocator},
+                m_alignment{std::max(t_alignment, ae_memory::MEMORY_ALIGNMENT)} {
+            if (t_size == 0) {
+                return;
+            };
+            if (m_allocator) {
+                m_memory = m_allocator->allocate(t_size, m_alignment);
+            } else {
+                m_memory = ::operator new(t_size, std::align_val_t{m_alignment});
+            };
+        };
+
+        /// Gives the memory back to where it was borrowed from.
+        ~AllocatorBuffer() {
+            if (!m_memory) {
+                return;
+            };
+            if (m_allocator) {
+                m_allocator->deallocate(m_memory);
+            } else {
+                ::operator delete(m_memory, std::align_val_t{m_alignment});
+            };
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        AllocatorBuffer(const AllocatorBuffer&) = delete;
+        AllocatorBuffer& operator=(const AllocatorBuffer&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AllocatorBuffer(AllocatorBuffer&&) = delete;
+        AllocatorBuffer& operator=(AllocatorBuffer&&) = delete;
+
+        /// Gets the memory as an array of a type, nullptr if no memory was borrowed.
+        template<typename T>
+        T* get() const { return static_cast<T*>(m_memory); };
+
+    private:
+
+        /// The allocator the memory was borrowed from, nullptr for the heap.
+        ae_memory::AeAllocatorBase* m_allocator;
+
+        /// The alignment the memory was borrowed with.
+        std::size_t m_alignment;
+
+        /// The memory.
+        void* m_memory = nullptr;
+
+    protected:
+
+    };
+
+} // namespace ae
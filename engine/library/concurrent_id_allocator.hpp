@@ -0,0 +1,381 @@
+/// \file concurrent_id_allocator.hpp
+/// The ConcurrentIdAllocator class is defined.
+#pragma once
+
+// dependencies
+#include "hierarchical_bitset.hpp"
+
+// libraries
+
+//std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace ae {
+
+    /// Hands out IDs from a fixed range to any number of threads at once without taking a lock. The free IDs are kept
+    /// in a bitset of atomic words, where a set bit is an ID that is taken. Each thread keeps a small cache of IDs it
+    /// claimed from one half of a word in a single compare and swap, so most allocations and frees only touch the
+    /// thread's own cache line. The cache of a thread is a single atomic word holding which half word it covers and a
+    /// bit for each cached ID, so when the bitset runs dry the IDs stranded in other threads' caches, such as those of
+    /// threads that have exited, are taken rather than lost. A cache only holds IDs below every free ID in the bitset:
+    /// an ID freed in the cache's half word goes into the cache, one freed below it replaces the cache, whose IDs go
+    /// back to the bitset, and one freed above it goes to the bitset. So a single thread is always handed the lowest
+    /// free ID, and threads allocating and freeing at once are handed IDs close to the lowest, which keeps the IDs in
+    /// use close together.
+    class ConcurrentIdAllocator{
+    public:
+
+        /// Value returned by allocate when every ID is taken.
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        /// The number of thread caches, threads beyond this share caches with the threads before them.
+        static constexpr std::size_t NUM_THREAD_CACHES = 64;
+
+        /// The most IDs a thread cache can hold, the IDs of one half of a bitset word.
+        static constexpr std::size_t THREAD_CACHE_SIZE = 32;
+
+        /// Creates the allocator with every ID free.
+        /// \param t_numIds The number of IDs, the IDs are 0 to t_numIds - 1.
+        explicit ConcurrentIdAllocator(std::size_t t_numIds) :
+                m_numIds{t_numIds},
+                m_numWords{(t_numIds + 63) / 64},
+                m_words{std::make_unique<std::atomic<uint64_t>[]>(m_numWords)},
+                m_threadCaches{std::make_unique<ThreadCache[]>(NUM_THREAD_CACHES)} {
+            if (t_numIds / THREAD_CACHE_SIZE >= NO_HALF_WORD) {
+                throw std::runtime_error("Attempting to create an ID allocator with " + std::to_string(t_numIds)
+                                         + " IDs, more than the thread caches can index!");
+            };
+            for (std::size_t wordIndex = 0; wordIndex < m_numWords; wordIndex++) {
+                m_words[wordIndex].store(0, std::memory_order_relaxed);
+            };
+
+            // The bits past the last ID are permanently taken so they are never handed out.
+            if (t_numIds % 64 != 0) {
+                m_words[m_numWords - 1].store(~uint64_t{0} << (t_numIds % 64), std::memory_order_relaxed);
+            };
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        ConcurrentIdAllocator(const ConcurrentIdAllocator&) = delete;
+        ConcurrentIdAllocator& operator=(const ConcurrentIdAllocator&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        ConcurrentIdAllocator(ConcurrentIdAllocator&&) = delete;
+        ConcurrentIdAllocator& operator=(ConcurrentIdAllocator&&) = delete;
+
+        /// Takes a free ID, safe to call from any number of threads at once.
+        /// \return The ID, npos if every ID is taken.
+        std::size_t allocate(){
+            std::atomic<uint64_t>& threadCache = getThreadCache();
+
+            // Pop the lowest ID of the thread's cache.
+            uint64_t cache = threadCache.load(std::memory_order_relaxed);
+            while (cacheMask(cache) != 0) {
+                uint64_t lowestBit = cache & (~cache + 1);
+                if (threadCache.compare_exchange_weak(cache, cache & ~lowestBit, std::memory_order_acquire,
+                                                      std::memory_order_relaxed)) {
+                    m_numAllocated.fetch_add(1, std::memory_order_relaxed);
+                    return cacheBase(cache) + __builtin_ctzll(lowestBit);
+                };
+            };
+
+            // Refill the cache from the bitset, or failing that from the caches of other threads.
+            if (!claimFromBitset(cache) && !claimFromThreadCaches(cache)) {
+                return npos;
+            };
+
+            uint64_t mask = cacheMask(cache);
+            std::size_t id = cacheBase(cache) + __builtin_ctzll(mask);
+            storeInThreadCache(threadCache, cache & ~(mask & (~mask + 1)));
+            m_numAllocated.fetch_add(1, std::memory_order_relaxed);
+            return id;
+        };
+
+        /// Gives back an ID so it can be handed out again, safe to call from any number of threads at once. The ID
+        /// goes into the thread's cache when it is in or below the cache's half word, otherwise back into the bitset.
+        /// \param t_id The ID, it must have been handed out by allocate or claim and not given back since.
+        void free(std::size_t t_id){
+            checkCanFree(t_id);
+
+            std::atomic<uint64_t>& threadCache = getThreadCache();
+            uint64_t halfWordIndex = t_id / THREAD_CACHE_SIZE;
+            uint64_t bit = uint64_t{1} << (t_id % THREAD_CACHE_SIZE);
+
+            // An ID below the cache's half word replaces the cache, so the cache never holds IDs above a free ID in
+            // the bitset. A cache that covers no half word leaves the ID to the bitset.
+            uint64_t cache = threadCache.load(std::memory_order_relaxed);
+            while (cacheHalfWordIndex(cache) != NO_HALF_WORD && cacheHalfWordIndex(cache) >= halfWordIndex) {
+                bool isInCacheHalfWord = cacheHalfWordIndex(cache) == halfWordIndex;
+                if (isInCacheHalfWord && (cache & bit) != 0) {
+                    throw std::runtime_error("Attempting to free the ID " + std::to_string(t_id)
+                                             + " which is already free!");
+                };
+                uint64_t newCache = isInCacheHalfWord ? cache | bit : (halfWordIndex << 32) | bit;
+                if (threadCache.compare_exchange_weak(cache, newCache, std::memory_order_acq_rel,
+                                                      std::memory_order_relaxed)) {
+                    if (!isInCacheHalfWord && cacheMask(cache) != 0) {
+                        releaseToBitset(cache);
+                    };
+                    m_numAllocated.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                };
+            };
+
+            releaseIdToBitset(t_id);
+        };
+
+        /// Gives back an ID straight to the bitset, for work like compacting IDs that frees IDs in bulk after
+        /// flushing the thread caches. Safe to call from any number of threads at once. The calling thread's cache is
+        /// emptied when it covers the ID's half word or one above it, so the ID is still handed out in order.
+        /// \param t_id The ID, it must have been handed out by allocate or claim and not given back since.
+        void freeToBitset(std::size_t t_id){
+            checkCanFree(t_id);
+
+            std::atomic<uint64_t>& threadCache = getThreadCache();
+            uint64_t cache = threadCache.load(std::memory_order_relaxed);
+            if (cacheHalfWordIndex(cache) != NO_HALF_WORD && cacheHalfWordIndex(cache) >= t_id / THREAD_CACHE_SIZE &&
+                takeThreadCache(threadCache, cache)) {
+                releaseToBitset(cache);
+            };
+
+            releaseIdToBitset(t_id);
+        };
+
+        /// Takes a specific ID, safe to call from any number of threads at once. IDs sitting in a thread cache count
+        /// as taken, so flush the caches first when every free ID must be claimable.
+        /// \param t_id The ID.
+        /// \return True if the ID was free and is now taken.
+        bool claim(std::size_t t_id){
+            if (t_id >= m_numIds) {
+                return false;
+            };
+
+            uint64_t wordBit = uint64_t{1} << (t_id % 64);
+            if ((m_words[t_id / 64].fetch_or(wordBit, std::memory_order_acquire) & wordBit) != 0) {
+                return false;
+            };
+            m_numAllocated.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        };
+
+        /// Moves the IDs in every thread cache back into the bitset. Safe to call while other threads allocate, but
+        /// only leaves every cache empty when no other thread is allocating or freeing.
+        void flushThreadCaches(){
+            for (std::size_t cacheIndex = 0; cacheIndex < NUM_THREAD_CACHES; cacheIndex++) {
+                uint64_t cache = 0;
+                if (takeThreadCache(m_threadCaches[cacheIndex].m_cache, cache)) {
+                    releaseToBitset(cache);
+                };
+            };
+        };
+
+        /// Checks if an ID has been handed out. Only exact when no other thread is allocating or freeing and the
+        /// thread caches have been flushed.
+        /// \param t_id The ID.
+        /// \return True if the ID is taken.
+        [[nodiscard]] bool isAllocated(std::size_t t_id) const {
+            return (m_words[t_id / 64].load(std::memory_order_acquire) >> (t_id % 64)) & uint64_t{1};
+        };
+
+        /// Flushes the thread caches and copies which IDs are taken into a bitset, for work like compacting IDs that
+        /// needs to search them. No other thread may be allocating or freeing.
+        /// \return A bitset with a set bit for each ID that has been handed out.
+        HierarchicalBitset getAllocatedIds(){
+            flushThreadCaches();
+
+            HierarchicalBitset allocatedIds{m_numIds};
+            for (std::size_t wordIndex = 0; wordIndex < m_numWords; wordIndex++) {
+                uint64_t word = m_words[wordIndex].load(std::memory_order_acquire);
+                if (wordIndex == m_numWords - 1 && m_numIds % 64 != 0) {
+                    word &= ~(~uint64_t{0} << (m_numIds % 64));
+                };
+                allocatedIds.setWord(wordIndex, word);
+            };
+            return allocatedIds;
+        };
+
+        /// Gets the number of IDs handed out and not yet given back.
+        [[nodiscard]] std::size_t getNumAllocated() const { return m_numAllocated.load(std::memory_order_relaxed); };
+
+        /// Gets the number of IDs.
+        [[nodiscard]] std::size_t size() const { return m_numIds; };
+
+    private:
+
+        /// The half word index of a cache that covers no half word, as every cache does until it is first filled and
+        /// after it is taken.
+        static constexpr uint64_t NO_HALF_WORD = 0xFFFFFFFFu;
+
+        /// A cache holding no IDs and covering no half word.
+        static constexpr uint64_t EMPTY_CACHE = NO_HALF_WORD << 32;
+
+        /// A thread's cache on a cache line of its own, the upper 32 bits are the index of the half word the cache
+        /// covers and the lower 32 bits mark the IDs of that half word in the cache.
+        struct alignas(64) ThreadCache {
+            std::atomic<uint64_t> m_cache{EMPTY_CACHE};
+        };
+
+        /// Gets the bits marking the IDs in a cache.
+        static uint64_t cacheMask(uint64_t t_cache) { return t_cache & 0xFFFFFFFFu; };
+
+        /// Gets the index of the half word a cache covers.
+        static uint64_t cacheHalfWordIndex(uint64_t t_cache) { return t_cache >> 32; };
+
+        /// Gets the ID of the first bit of a cache.
+        static std::size_t cacheBase(uint64_t t_cache) { return static_cast<std::size_t>(t_cache >> 32) * 32; };
+
+        /// Gets the cache of the calling thread. Threads are given caches in the order they first allocate or free.
+        std::atomic<uint64_t>& getThreadCache(){
+            static std::atomic<std::size_t> nextThreadIndex{0};
+            thread_local const std::size_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+            return m_threadCaches[threadIndex % NUM_THREAD_CACHES].m_cache;
+        };
+
+        /// Claims every free ID of the first half word with one, starting at the lowest word that may have free IDs.
+        /// \param t_cache Set to the claimed IDs in the layout of a cache.
+        /// \return True if any IDs were claimed.
+        bool claimFromBitset(uint64_t& t_cache){
+            std::size_t searchStart = m_searchStart.load(std::memory_order_relaxed);
+            if (searchStart >= m_numWords) {
+                searchStart = 0;
+            };
+
+            // The search wraps around so the IDs below a stale search start are still found.
+            for (std::size_t n = 0; n < m_numWords; n++) {
+                std::size_t wordIndex = searchStart + n < m_numWords ? searchStart + n : searchStart + n - m_numWords;
+                uint64_t word = m_words[wordIndex].load(std::memory_order_relaxed);
+                while (word != ~uint64_t{0}) {
+                    uint64_t half = (~word & 0xFFFFFFFFu) != 0 ? 0 : 1;
+                    uint64_t freeBits = (~word >> (half * 32)) & 0xFFFFFFFFu;
+                    uint64_t newWord = word | (freeBits << (half * 32));
+                    if (m_words[wordIndex].compare_exchange_weak(word, newWord, std::memory_order_acquire,
+                                                                 std::memory_order_relaxed)) {
+                        if (newWord == ~uint64_t{0}) {
+                            raiseSearchStart(wordIndex);
+                        };
+                        t_cache = ((wordIndex * 2 + half) << 32) | freeBits;
+                        return true;
+                    };
+                };
+                raiseSearchStart(wordIndex);
+            };
+            return false;
+        };
+
+        /// Takes the whole cache of the first other thread holding any IDs.
+        /// \param t_cache Set to the taken cache.
+        /// \return True if a cache with IDs was found.
+        bool claimFromThreadCaches(uint64_t& t_cache){
+            for (std::size_t cacheIndex = 0; cacheIndex < NUM_THREAD_CACHES; cacheIndex++) {
+                if (takeThreadCache(m_threadCaches[cacheIndex].m_cache, t_cache)) {
+                    return true;
+                };
+            };
+            return false;
+        };
+
+        /// Empties a cache and leaves it covering no half word, so IDs freed into it go to the bitset until it is
+        /// filled again.
+        /// \param t_threadCache The cache.
+        /// \param t_cache Set to what the cache held.
+        /// \return True if the cache held any IDs.
+        static bool takeThreadCache(std::atomic<uint64_t>& t_threadCache, uint64_t& t_cache){
+            t_cache = t_threadCache.exchange(EMPTY_CACHE, std::memory_order_acquire);
+            return cacheMask(t_cache) != 0;
+        };
+
+        /// Puts IDs into an empty cache, or back into the bitset if another thread sharing the cache filled it first.
+        /// \param t_threadCache The cache.
+        /// \param t_cache The IDs in the layout of a cache.
+        void storeInThreadCache(std::atomic<uint64_t>& t_threadCache, uint64_t t_cache){
+            if (cacheMask(t_cache) == 0) {
+                return;
+            };
+
+            uint64_t cache = t_threadCache.load(std::memory_order_relaxed);
+            while (cacheMask(cache) == 0) {
+                if (t_threadCache.compare_exchange_weak(cache, t_cache, std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+                    return;
+                };
+            };
+            releaseToBitset(t_cache);
+        };
+
+        /// Checks an ID is in range and taken in the bitset, a cached ID is caught by the caller.
+        /// \param t_id The ID being freed.
+        void checkCanFree(std::size_t t_id) const {
+            if (t_id >= m_numIds) {
+                throw std::runtime_error("Attempting to free the ID " + std::to_string(t_id)
+                                         + " which is outside the range of the ID allocator!");
+            };
+            if ((m_words[t_id / 64].load(std::memory_order_relaxed) & (uint64_t{1} << (t_id % 64))) == 0) {
+                throw std::runtime_error("Attempting to free the ID " + std::to_string(t_id)
+                                         + " which is already free!");
+            };
+        };
+
+        /// Marks one handed out ID as free in the bitset.
+        /// \param t_id The ID.
+        void releaseIdToBitset(std::size_t t_id){
+            uint64_t wordBit = uint64_t{1} << (t_id % 64);
+            if ((m_words[t_id / 64].fetch_and(~wordBit, std::memory_order_release) & wordBit) == 0) {
+                throw std::runtime_error("Attempting to free the ID " + std::to_string(t_id)
+                                         + " which is already free!");
+            };
+            lowerSearchStart(t_id / 64);
+            m_numAllocated.fetch_sub(1, std::memory_order_relaxed);
+        };
+
+        /// Marks the IDs of a cache as free in the bitset.
+        /// \param t_cache The IDs in the layout of a cache.
+        void releaseToBitset(uint64_t t_cache){
+            std::size_t halfWordIndex = static_cast<std::size_t>(t_cache >> 32);
+            std::size_t wordIndex = halfWordIndex / 2;
+            m_words[wordIndex].fetch_and(~(cacheMask(t_cache) << ((halfWordIndex % 2) * 32)),
+                                         std::memory_order_release);
+            lowerSearchStart(wordIndex);
+        };
+
+        /// Moves the search start past a word that was found full, unless another thread already moved it.
+        /// \param t_wordIndex The full word.
+        void raiseSearchStart(std::size_t t_wordIndex){
+            std::size_t expected = t_wordIndex;
+            m_searchStart.compare_exchange_strong(expected, t_wordIndex + 1, std::memory_order_relaxed);
+        };
+
+        /// Moves the search start back to a word that has free IDs again.
+        /// \param t_wordIndex The word with free IDs.
+        void lowerSearchStart(std::size_t t_wordIndex){
+            std::size_t searchStart = m_searchStart.load(std::memory_order_relaxed);
+            while (t_wordIndex < searchStart &&
+                   !m_searchStart.compare_exchange_weak(searchStart, t_wordIndex, std::memory_order_relaxed)) {};
+        };
+
+        /// The number of IDs.
+        std::size_t m_numIds;
+
+        /// The number of words in the bitset.
+        std::size_t m_numWords;
+
+        /// A bit per ID that is set when the ID is handed out or sits in a thread cache.
+        std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+
+        /// The thread caches.
+        std::unique_ptr<ThreadCache[]> m_threadCaches;
+
+        /// The lowest word that may have free IDs, only a hint of where to start searching.
+        alignas(64) std::atomic<std::size_t> m_searchStart{0};
+
+        /// The number of IDs handed out and not given back.
+        alignas(64) std::atomic<std::size_t> m_numAllocated{0};
+
+    protected:
+
+    };
+
+} // namespace ae
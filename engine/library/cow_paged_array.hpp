@@ -0,0 +1,135 @@
+/// \file cow_paged_array.hpp
+/// The CowPagedArray class is defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ae {
+
+    /// A fixed size array split into pages that can be shared between forks of the array. Forking only copies the
+    /// page table, a page is copied the first time it is written to while it is shared. Each array's page table records
+    /// which pages the array owns, the pages it copied itself since it was created or last forked, and only those are
+    /// written in place. The reference count of a page is not used to decide this, since a count read by one thread
+    /// does not tell it when another thread sharing the page last read it. Different forks may be used from different
+    /// threads, however an array must not be written to or forked by another thread while it is being forked.
+    /// \tparam T The type of the elements stored in the array.
+    /// \tparam elementsPerPage The number of elements stored in each page.
+    template <typename T, std::size_t elementsPerPage = 256>
+    class CowPagedArray{
+    public:
+
+        /// Creates the array with all the pages sharing a single page of default elements, so no memory is used for
+        /// the pages until they are written to.
+        /// \param t_numElements The number of elements in the array.
+        explicit CowPagedArray(std::size_t t_numElements) :
+                m_numElements{t_numElements} {
+            PageEntry defaultPage{std::make_shared<Page>(), false};
+            m_pages.assign((t_numElements + elementsPerPage - 1) / elementsPerPage, defaultPage);
+        };
+
+        ~CowPagedArray() = default;
+
+        /// Do not allow this class to be copied (2 lines below), use fork to create a copy that shares its pages.
+        CowPagedArray(const CowPagedArray&) = delete;
+        CowPagedArray& operator=(const CowPagedArray&) = delete;
+
+        /// Creates a copy of the array that shares all its pages with this array. Neither array owns the pages
+        /// afterwards, so each copies a page before writing to it.
+        /// \return The forked array.
+        std::unique_ptr<CowPagedArray> fork() {
+            for (auto& pageEntry: m_pages) {
+                pageEntry.m_isOwned = false;
+            };
+            return std::unique_ptr<CowPagedArray>(new CowPagedArray(m_numElements, m_pages));
+        };
+
+        /// Gets an element for reading. Never copies a page.
+        /// \param t_index The index of the element.
+        /// \return The element.
+        const T& read(std::size_t t_index) const {
+            return m_pages[t_index / elementsPerPage].m_page->m_elements[t_index % elementsPerPage];
+        };
+
+        /// Gets an element for writing. Copies the page containing the element first if the array does not own it.
+        /// \param t_index The index of the element.
+        /// \return The element.
+        T& write(std::size_t t_index) {
+            PageEntry& pageEntry = m_pages[t_index / elementsPerPage];
+            if (!pageEntry.m_isOwned) {
+                pageEntry.m_page = std::make_shared<Page>(*pageEntry.m_page);
+                pageEntry.m_isOwned = true;
+            };
+            return pageEntry.m_page->m_elements[t_index % elementsPerPage];
+        };
+
+        /// Gets the number of elements in the array.
+        /// \return The number of elements.
+        [[nodiscard]] std::size_t size() const { return m_numElements; };
+
+        /// Gets the number of pages used by the array.
+        /// \return The number of pages.
+        [[nodiscard]] std::size_t getNumPages() const { return m_pages.size(); };
+
+        /// Gets the number of pages the array does not own. They are, or may still be, shared with another array and
+        /// are copied the first time they are written to.
+        /// \return The number of shared pages.
+        [[nodiscard]] std::size_t getNumSharedPages() const {
+            return static_cast<std::size_t>(std::count_if(m_pages.begin(), m_pages.end(),
+                                                          [](const PageEntry& t_pageEntry) { return !t_pageEntry.m_isOwned; }));
+        };
+
+        /// Gets the number of different pages referenced by the page table, which is the number of pages this array
+        /// is keeping allocated.
+        /// \return The number of distinct pages.
+        [[nodiscard]] std::size_t getNumDistinctPages() const {
+            std::vector<const Page*> distinctPages;
+            distinctPages.reserve(m_pages.size());
+            for (auto& pageEntry: m_pages) {
+                distinctPages.push_back(pageEntry.m_page.get());
+            };
+            std::sort(distinctPages.begin(), distinctPages.end());
+            return std::unique(distinctPages.begin(), distinctPages.end()) - distinctPages.begin();
+        };
+
+        /// The number of bytes in a single page.
+        static const std::size_t m_pageSizeBytes = sizeof(T) * elementsPerPage;
+
+    private:
+
+        /// A page of elements.
+        struct Page{
+            T m_elements[elementsPerPage]{};
+        };
+
+        /// An entry of the page table. A page the array owns is referenced by no other array, so it can be written in
+        /// place.
+        struct PageEntry{
+            std::shared_ptr<Page> m_page;
+            bool m_isOwned;
+        };
+
+        /// Creates an array sharing the specified pages, which neither array owns.
+        CowPagedArray(std::size_t t_numElements, const std::vector<PageEntry>& t_pages) :
+                m_numElements{t_numElements},
+                m_pages{t_pages} {};
+
+        /// The number of elements in the array.
+        std::size_t m_numElements;
+
+        /// The page table.
+        std::vector<PageEntry> m_pages;
+
+    protected:
+
+    };
+
+} // namespace ae
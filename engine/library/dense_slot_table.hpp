@@ -0,0 +1,152 @@
+/// \file dense_slot_table.hpp
+/// The DenseSlotTable class is defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ae {
+
+    /// Records the slot whose contents have to be moved into the slot freed by an erase. When nothing has to be
+    /// moved the two slots are the same.
+    struct DenseSlotMove {
+        /// The slot the contents are moved out of, the last slot in use before the erase.
+        uint32_t m_fromSlot;
+
+        /// The slot the contents are moved into, the slot of the key that was erased.
+        uint32_t m_toSlot;
+    };
+
+    /// Maps keys, such as entity IDs, to the slots of a buffer while keeping the slots in use packed at the start of
+    /// the buffer. A key is given the slot after the last slot in use, and erasing a key moves the key in the last slot
+    /// into the freed slot. Both directions are kept in arrays so finding the slot of a key, or the key of a slot, is a
+    /// single lookup, and only the first size() slots of the buffer ever have to be uploaded or iterated over.
+    class DenseSlotTable {
+    public:
+
+        /// The slot of a key that is not in the table.
+        static constexpr uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+        /// Creates an empty table.
+        /// \param t_maxNumKeys Keys must be less than this value.
+        /// \param t_maxNumSlots The number of slots in the buffer the table assigns.
+        DenseSlotTable(std::size_t t_maxNumKeys, std::size_t t_maxNumSlots) :
+                m_keySlots(t_maxNumKeys, INVALID_SLOT),
+                m_slotKeys(t_maxNumSlots) {
+            if (t_maxNumSlots >= INVALID_SLOT) {
+                throw std::runtime_error("A dense slot table can not have more slots than fit in a 32 bit index!");
+            };
+        };
+
+        /// Gives a key the next free slot if it does not already have one.
+        /// \param t_key The key to insert.
+        /// \return The slot of the key, and true if the key was not already in the table.
+        std::pair<uint32_t, bool> insert(std::size_t t_key) {
+            uint32_t& keySlot = m_keySlots.at(t_key);
+            if (keySlot != INVALID_SLOT) {
+                return {keySlot, false};
+            };
+            if (m_size == m_slotKeys.size()) {
+                throw std::runtime_error("Dense slot table overflow! There are more objects than there are slots in "
+                                         "the buffer!");
+            };
+
+            keySlot = m_size;
+            m_slotKeys[m_size] = t_key;
+            m_size++;
+            return {keySlot, true};
+        };
+
+        /// Frees the slot of a key. The key in the last slot is moved into the freed slot so the slots in use stay
+        /// packed, the contents of the buffer must be moved the same way.
+        /// \param t_key The key to erase.
+        /// \return The slots the buffer contents have to be moved between. If the key was not in the table both are
+        /// INVALID_SLOT.
+        DenseSlotMove erase(std::size_t t_key) {
+            if (t_key >= m_keySlots.size() || m_keySlots[t_key] == INVALID_SLOT) {
+                return {INVALID_SLOT, INVALID_SLOT};
+            };
+
+            uint32_t freedSlot = m_keySlots[t_key];
+            uint32_t lastSlot = m_size - 1;
+            m_keySlots[t_key] = INVALID_SLOT;
+            m_size--;
+
+            if (freedSlot != lastSlot) {
+                std::size_t lastKey = m_slotKeys[lastSlot];
+                m_slotKeys[freedSlot] = lastKey;
+                m_keySlots[lastKey] = freedSlot;
+                m_numSlotMoves++;
+            };
+
+            return {lastSlot, freedSlot};
+        };
+
+        /// Moves the slot of a key to a different key, used when entities are renumbered.
+        /// \param t_oldKey The key that currently has the slot.
+        /// \param t_newKey The key to give the slot to, it must not already have a slot.
+        void remapKey(std::size_t t_oldKey, std::size_t t_newKey) {
+            uint32_t slot = getSlot(t_oldKey);
+            if (slot == INVALID_SLOT) {
+                return;
+            };
+            if (m_keySlots.at(t_newKey) != INVALID_SLOT) {
+                throw std::runtime_error("A key can not be remapped onto a key that already has a slot!");
+            };
+
+            m_keySlots[t_oldKey] = INVALID_SLOT;
+            m_keySlots[t_newKey] = slot;
+            m_slotKeys[slot] = t_newKey;
+        };
+
+        /// Gets the slot of a key.
+        /// \param t_key The key to find.
+        /// \return The slot of the key, or INVALID_SLOT if the key is not in the table.
+        [[nodiscard]] uint32_t getSlot(std::size_t t_key) const {
+            return t_key < m_keySlots.size() ? m_keySlots[t_key] : INVALID_SLOT;
+        };
+
+        /// Gets the key that has a slot.
+        /// \param t_slot A slot less than size().
+        [[nodiscard]] std::size_t getKey(uint32_t t_slot) const { return m_slotKeys[t_slot]; };
+
+        /// Checks if a key has a slot.
+        [[nodiscard]] bool contains(std::size_t t_key) const { return getSlot(t_key) != INVALID_SLOT; };
+
+        /// Gets the number of slots in use, they are the slots from 0 to size() - 1.
+        [[nodiscard]] std::size_t size() const { return m_size; };
+
+        /// Gets the number of slots in the buffer the table assigns.
+        [[nodiscard]] std::size_t capacity() const { return m_slotKeys.size(); };
+
+        /// Gets the number of times a key has been moved to a different slot by an erase. Anything that stores the
+        /// slots of keys has to look them up again when this changes.
+        [[nodiscard]] uint64_t getNumSlotMoves() const { return m_numSlotMoves; };
+
+    private:
+        /// The slot of each key, INVALID_SLOT for keys not in the table.
+        std::vector<uint32_t> m_keySlots;
+
+        /// The key of each slot, only the first m_size are meaningful.
+        std::vector<std::size_t> m_slotKeys;
+
+        /// The number of slots in use.
+        uint32_t m_size = 0;
+
+        /// The number of times a key has been moved to a different slot.
+        uint64_t m_numSlotMoves = 0;
+
+    protected:
+
+    };
+
+} // namespace ae
@@ -0,0 +1,908 @@
+/// \file flat_hash_map.hpp
+/// The flat_hash_map class is defined.
+#pragma once
+
+// dependencies
+#include "simd_support.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ae {
+
+    namespace flat_hash_map_detail {
+
+        /// The control byte of a slot that has never held an element since the map last grew.
+        constexpr int8_t CTRL_EMPTY = -128;
+
+        /// The control byte of a slot whose element was erased. Lookups probe past it as if it were full.
+        constexpr int8_t CTRL_DELETED = -2;
+
+        /// Mixes the bits of a hash, so that both the upper bits giving the first slot and the lower 7 bits kept in the
+        /// control byte are spread out. std::hash of an integer is often the integer itself, which would otherwise put
+        /// consecutive IDs in consecutive slots with almost the same control bytes.
+        inline std::size_t mixHash(std::size_t t_hash) {
+            uint64_t hash = static_cast<uint64_t>(t_hash);
+            hash ^= hash >> 32;
+            hash *= 0x9E3779B97F4A7C15ull;
+            hash ^= hash >> 29;
+            return static_cast<std::size_t>(hash);
+        };
+
+        /// The slots of a group that match a search, iterated from the lowest slot. Each slot is SHIFT bits wide, its
+        /// highest bit set when the slot matches.
+        template<typename TMask, std::size_t WIDTH, std::size_t SHIFT>
+        class BitMask {
+        public:
+
+            explicit BitMask(TMask t_mask) : m_mask{t_mask} {};
+
+            /// Checks if any slot matches.
+            explicit operator bool() const { return m_mask != 0; };
+
+            /// Gets the lowest slot that matches, there must be one.
+            [[nodiscard]] std::size_t lowest() const { return static_cast<std::size_t>(__builtin_ctzll(m_mask)) >> SHIFT; };
+
+            /// Moves on to the next slot that matches.
+            void removeLowest() { m_mask &= m_mask - 1; };
+
+            /// Gets the number of slots below the lowest that matches.
+            [[nodiscard]] std::size_t trailingZeros() const { return m_mask == 0 ? WIDTH : lowest(); };
+
+            /// Gets the number of slots above the highest that matches.
+            [[nodiscard]] std::size_t leadingZeros() const {
+                if (m_mask == 0) {
+                    return WIDTH;
+                };
+                return (static_cast<std::size_t>(__builtin_clzll(m_mask)) - (64 - (WIDTH << SHIFT))) >> SHIFT;
+            };
+
+        private:
+
+            TMask m_mask;
+
+        protected:
+
+        };
+
+#if defined(AE_SIMD_SSE2)
+        /// The control bytes of 16 consecutive slots, compared all at once with SSE2.
+        class Group {
+        public:
+
+            /// The number of slots in a group.
+            static constexpr std::size_t WIDTH = 16;
+
+            using Mask = BitMask<uint32_t, WIDTH, 0>;
+
+            explicit Group(const int8_t* t_ctrl) :
+                    m_ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(t_ctrl))} {};
+
+            /// Finds the full slots with a tag.
+            [[nodiscard]] Mask match(int8_t t_tag) const {
+                return Mask{static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(t_tag), m_ctrl)))};
+            };
+
+            /// Finds the empty slots.
+            [[nodiscard]] Mask matchEmpty() const { return match(CTRL_EMPTY); };
+
+            /// Finds the empty and deleted slots, the only control bytes with the sign bit set.
+            [[nodiscard]] Mask matchEmptyOrDeleted() const {
+                return Mask{static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl))};
+            };
+
+            /// Counts the empty and deleted slots at the start of the group, before its first full slot.
+            [[nodiscard]] std::size_t countLeadingEmptyOrDeleted() const {
+                return static_cast<std::size_t>(__builtin_ctz(~static_cast<uint32_t>(_mm_movemask_epi8(m_ctrl))));
+            };
+
+        private:
+
+            __m128i m_ctrl;
+
+        protected:
+
+        };
+#else
+        /// The control bytes of 8 consecutive slots, compared all at once in a 64 bit integer.
+        class Group {
+        public:
+
+            /// The number of slots in a group.
+            static constexpr std::size_t WIDTH = 8;
+
+            using Mask = BitMask<uint64_t, WIDTH, 3>;
+
+            explicit Group(const int8_t* t_ctrl) {
+                std::memcpy(&m_ctrl, t_ctrl, sizeof(m_ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                m_ctrl = __builtin_bswap64(m_ctrl);
+#endif
+            };
+
+            /// Finds the full slots with a tag. A slot just above a match may also be reported when its tag differs in
+            /// only the lowest bit, which is harmless as the keys of the slots found are compared anyway.
+            [[nodiscard]] Mask match(int8_t t_tag) const {
+                uint64_t difference = m_ctrl ^ (LSBS * static_cast<uint8_t>(t_tag));
+                return Mask{(difference - LSBS) & ~difference & MSBS};
+            };
+
+            /// Finds the empty slots, whose control bytes are the only ones with the sign bit set and bit 1 clear.
+            [[nodiscard]] Mask matchEmpty() const { return Mask{m_ctrl & ~(m_ctrl << 6) & MSBS}; };
+
+            /// Finds the empty and deleted slots, the only control bytes with the sign bit set.
+            [[nodiscard]] Mask matchEmptyOrDeleted() const { return Mask{m_ctrl & MSBS}; };
+
+            /// Counts the empty and deleted slots at the start of the group, before its first full slot.
+            [[nodiscard]] std::size_t countLeadingEmptyOrDeleted() const {
+                uint64_t fullSlots = ~m_ctrl & MSBS;
+                return fullSlots == 0 ? WIDTH : static_cast<std::size_t>(__builtin_ctzll(fullSlots)) >> 3;
+            };
+
+        private:
+
+            static constexpr uint64_t LSBS = 0x0101010101010101ull;
+            static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+            uint64_t m_ctrl;
+
+        protected:
+
+        };
+#endif
+
+        /// The groups a hash probes, each a group further on than the last went. As the number of groups is a power of
+        /// two this visits every group once before repeating.
+        class ProbeSequence {
+        public:
+
+            ProbeSequence(std::size_t t_hash, std::size_t t_mask) : m_mask{t_mask}, m_offset{t_hash & t_mask} {};
+
+            /// Gets the slot of the current group's first slot, or of one of its others.
+            [[nodiscard]] std::size_t offset(std::size_t t_slot = 0) const { return (m_offset + t_slot) & m_mask; };
+
+            /// Moves on to the next group.
+            void next() {
+                m_step += Group::WIDTH;
+                m_offset = (m_offset + m_step) & m_mask;
+            };
+
+        private:
+
+            std::size_t m_mask;
+            std::size_t m_offset;
+            std::size_t m_step = 0;
+
+        protected:
+
+        };
+
+        /// Checks if a hash or equality takes keys of other types, such as a std::string_view for a std::string key.
+        template<typename T, typename = void>
+        struct IsTransparent : std::false_type {};
+
+        template<typename T>
+        struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+        /// The type of key taken by lookups, any type when the hash and equality are transparent.
+        template<bool IS_TRANSPARENT>
+        struct KeyArg {
+            template<typename TLookupKey, typename TKey>
+            using type = TKey;
+        };
+
+        template<>
+        struct KeyArg<true> {
+            template<typename TLookupKey, typename TKey>
+            using type = TLookupKey;
+        };
+
+    } // namespace flat_hash_map_detail
+
+    /// A hash of strings that hashes std::string, std::string_view and C strings alike. A map keyed by std::string with
+    /// this hash and std::equal_to<> is looked up by string views and string literals without making a std::string.
+    struct string_hash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view t_string) const noexcept {
+            return std::hash<std::string_view>{}(t_string);
+        };
+    };
+
+    /// An open addressing hash map, laid out like Abseil's Swiss tables. The elements are stored in one flat array of
+    /// slots rather than a node each, with a control byte for each slot that is empty, deleted, or holds 7 bits of the
+    /// element's hash. A lookup compares a whole group of control bytes at once, with SSE2 where available, and only
+    /// touches the slots whose bits match, so most lookups cost a single cache miss in the control bytes and a single
+    /// one in the slots. The map grows once 7/8 of its slots are used.
+    ///
+    /// The interface follows std::unordered_map, with these differences:
+    /// - Inserting may move every element, which invalidates every iterator and reference, unlike std::unordered_map
+    ///   where references stay valid. Erasing only invalidates iterators and references to the erased element.
+    /// - There are no buckets, and reserve() is the only way to size the map ahead.
+    /// - When both the hash and the equality are transparent, as with ae::string_hash and std::equal_to<>, find,
+    ///   contains, count, at and erase take any key type the two accept.
+    /// \tparam Key The type of key.
+    /// \tparam T The type of value.
+    /// \tparam Hash The hash of the keys.
+    /// \tparam KeyEqual The equality of the keys.
+    /// \tparam Allocator The allocator of the slots and control bytes, which are allocated together in one block. An
+    /// ae_memory::AeAllocatorStlAdaptor borrows them from an engine allocator.
+    template<typename Key,
+             typename T,
+             typename Hash = std::hash<Key>,
+             typename KeyEqual = std::equal_to<Key>,
+             typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class flat_hash_map {
+        using Group = flat_hash_map_detail::Group;
+        using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::pair<const Key, T>>;
+        using SlotAllocatorTraits = std::allocator_traits<SlotAllocator>;
+
+        static constexpr bool IS_TRANSPARENT = flat_hash_map_detail::IsTransparent<Hash>::value &&
+                                               flat_hash_map_detail::IsTransparent<KeyEqual>::value;
+
+        template<typename TLookupKey>
+        using KeyArg = typename flat_hash_map_detail::KeyArg<IS_TRANSPARENT>::template type<TLookupKey, Key>;
+
+        template<bool IS_CONST>
+        class Iterator;
+
+    public:
+
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<const Key, T>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = typename SlotAllocatorTraits::pointer;
+        using const_pointer = typename SlotAllocatorTraits::const_pointer;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        /// Creates an empty map, which allocates nothing until the first element is inserted.
+        flat_hash_map() : flat_hash_map(0) {};
+
+        /// Creates an empty map with room for a number of elements.
+        /// \param t_capacity The number of elements the map holds before it first grows.
+        explicit flat_hash_map(size_type t_capacity,
+                               const Hash& t_hash = Hash(),
+                               const KeyEqual& t_keyEqual = KeyEqual(),
+                               const Allocator& t_allocator = Allocator()) :
+                m_hash{t_hash},
+                m_keyEqual{t_keyEqual},
+                m_allocator{t_allocator} {
+            reserve(t_capacity);
+        };
+
+        /// Creates an empty map whose slots are borrowed from an allocator.
+        explicit flat_hash_map(const Allocator& t_allocator) : flat_hash_map(0, Hash(), KeyEqual(), t_allocator) {};
+
+        /// Creates a map holding a list of elements, the first of any elements with equal keys is kept.
+        flat_hash_map(std::initializer_list<value_type> t_elements,
+                      size_type t_capacity = 0,
+                      const Hash& t_hash = Hash(),
+                      const KeyEqual& t_keyEqual = KeyEqual(),
+                      const Allocator& t_allocator = Allocator()) :
+                flat_hash_map(std::max(t_capacity, t_elements.size()), t_hash, t_keyEqual, t_allocator) {
+            insert(t_elements.begin(), t_elements.end());
+        };
+
+        flat_hash_map(const flat_hash_map& t_other) :
+                m_hash{t_other.m_hash},
+                m_keyEqual{t_other.m_keyEqual},
+                m_allocator{SlotAllocatorTraits::select_on_container_copy_construction(t_other.m_allocator)} {
+            copyElementsFrom(t_other);
+        };
+
+        flat_hash_map(flat_hash_map&& t_other) noexcept :
+                m_ctrl{std::exchange(t_other.m_ctrl, nullptr)},
+                m_slots{std::exchange(t_other.m_slots, nullptr)},
+                m_size{std::exchange(t_other.m_size, 0)},
+                m_capacity{std::exchange(t_other.m_capacity, 0)},
+                m_growthLeft{std::exchange(t_other.m_growthLeft, 0)},
+                m_hash{std::move(t_other.m_hash)},
+                m_keyEqual{std::move(t_other.m_keyEqual)},
+                m_allocator{std::move(t_other.m_allocator)} {};
+
+        flat_hash_map& operator=(const flat_hash_map& t_other) {
+            if (this == &t_other) {
+                return *this;
+            };
+            clear();
+            if constexpr (SlotAllocatorTraits::propagate_on_container_copy_assignment::value) {
+                if (m_allocator != t_other.m_allocator) {
+                    deallocateSlots();
+                };
+                m_allocator = t_other.m_allocator;
+            };
+            m_hash = t_other.m_hash;
+            m_keyEqual = t_other.m_keyEqual;
+            copyElementsFrom(t_other);
+            return *this;
+        };
+
+        flat_hash_map& operator=(flat_hash_map&& t_other) noexcept(
+                SlotAllocatorTraits::propagate_on_container_move_assignment::value ||
+                SlotAllocatorTraits::is_always_equal::value) {
+            if (this == &t_other) {
+                return *this;
+            };
+            if constexpr (SlotAllocatorTraits::propagate_on_container_move_assignment::value ||
+                          SlotAllocatorTraits::is_always_equal::value) {
+                destroyElements();
+                deallocateSlots();
+                if constexpr (SlotAllocatorTraits::propagate_on_container_move_assignment::value) {
+                    m_allocator = std::move(t_other.m_allocator);
+                };
+                takeSlotsFrom(t_other);
+            } else if (m_allocator == t_other.m_allocator) {
+                destroyElements();
+                deallocateSlots();
+                takeSlotsFrom(t_other);
+            } else {
+                // The slots can not be taken when they have to be given back to the other allocator.
+                clear();
+                m_hash = t_other.m_hash;
+                m_keyEqual = t_other.m_keyEqual;
+                reserve(t_other.size());
+                for (auto& element: t_other) {
+                    emplaceUnique(std::move(const_cast<Key&>(element.first)), std::move(element.second));
+                };
+                t_other.clear();
+            };
+            return *this;
+        };
+
+        ~flat_hash_map() {
+            destroyElements();
+            deallocateSlots();
+        };
+
+        [[nodiscard]] iterator begin() { return iteratorAt(0); };
+        [[nodiscard]] const_iterator begin() const { return iteratorAt(0); };
+        [[nodiscard]] const_iterator cbegin() const { return begin(); };
+        [[nodiscard]] iterator end() { return iterator{m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity}; };
+        [[nodiscard]] const_iterator end() const {
+            return const_iterator{m_ctrl + m_capacity, m_ctrl + m_capacity, m_slots + m_capacity};
+        };
+        [[nodiscard]] const_iterator cend() const { return end(); };
+
+        [[nodiscard]] bool empty() const { return m_size == 0; };
+        [[nodiscard]] size_type size() const { return m_size; };
+        [[nodiscard]] size_type max_size() const { return SlotAllocatorTraits::max_size(m_allocator) / 2; };
+
+        /// Gets the number of slots, the map grows when 7/8 of them are full or deleted.
+        [[nodiscard]] size_type capacity() const { return m_capacity; };
+
+        /// Gets the fraction of the slots that are full.
+        [[nodiscard]] float load_factor() const {
+            return m_capacity == 0 ? 0.0f : static_cast<float>(m_size) / static_cast<float>(m_capacity);
+        };
+
+        /// Gets the fraction of the slots that are used before the map grows.
+        [[nodiscard]] float max_load_factor() const { return 7.0f / 8.0f; };
+
+        /// Erases every element, keeping the slots for the elements inserted next.
+        void clear() {
+            destroyElements();
+            if (m_capacity != 0) {
+                std::memset(m_ctrl, flat_hash_map_detail::CTRL_EMPTY, m_capacity + Group::WIDTH);
+                m_growthLeft = capacityToGrowth(m_capacity);
+            };
+        };
+
+        /// Makes room for a number of elements, so that inserting up to that many does not make the map grow.
+        void reserve(size_type t_numElements) {
+            if (t_numElements > m_size + m_growthLeft) {
+                resize(growthToCapacity(t_numElements));
+            };
+        };
+
+        /// Inserts an element if there is no element with its key.
+        /// \return The element with the key, and true if it was inserted.
+        std::pair<iterator, bool> insert(const value_type& t_element) { return emplaceUnique(t_element.first, t_element); };
+        std::pair<iterator, bool> insert(value_type&& t_element) {
+            return emplaceUnique(t_element.first, std::move(t_element));
+        };
+
+        template<typename P, typename = std::enable_if_t<std::is_constructible_v<value_type, P&&>>>
+        std::pair<iterator, bool> insert(P&& t_element) { return emplace(std::forward<P>(t_element)); };
+
+        /// Inserts each element whose key is not yet in the map.
+        template<typename InputIt>
+        void insert(InputIt t_first, InputIt t_last) {
+            for (; t_first != t_last; ++t_first) {
+                emplace(*t_first);
+            };
+        };
+
+        void insert(std::initializer_list<value_type> t_elements) { insert(t_elements.begin(), t_elements.end()); };
+
+        /// Inserts an element or assigns to the value of the element with the key.
+        /// \return The element with the key, and true if it was inserted.
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(const key_type& t_key, M&& t_value) {
+            auto result = try_emplace(t_key, std::forward<M>(t_value));
+            if (!result.second) {
+                result.first->second = std::forward<M>(t_value);
+            };
+            return result;
+        };
+
+        template<typename M>
+        std::pair<iterator, bool> insert_or_assign(key_type&& t_key, M&& t_value) {
+            auto result = try_emplace(std::move(t_key), std::forward<M>(t_value));
+            if (!result.second) {
+                result.first->second = std::forward<M>(t_value);
+            };
+            return result;
+        };
+
+        /// Constructs an element from arguments and inserts it if there is no element with its key. The element is
+        /// made before looking for its key, try_emplace avoids making it when the key is already in the map.
+        /// \return The element with the key, and true if it was inserted.
+        template<typename... Args>
+        std::pair<iterator, bool> emplace(Args&&... t_args) {
+            value_type element(std::forward<Args>(t_args)...);
+            return emplaceUnique(element.first, std::move(element));
+        };
+
+        /// Constructs an element from a key and the arguments of its value, only if there is no element with the key.
+        /// \return The element with the key, and true if it was inserted.
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& t_key, Args&&... t_args) {
+            return emplaceUnique(t_key, std::piecewise_construct, std::forward_as_tuple(t_key),
+                                 std::forward_as_tuple(std::forward<Args>(t_args)...));
+        };
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(key_type&& t_key, Args&&... t_args) {
+            return emplaceUnique(t_key, std::piecewise_construct, std::forward_as_tuple(std::move(t_key)),
+                                 std::forward_as_tuple(std::forward<Args>(t_args)...));
+        };
+
+        /// Gets the value of the element with a key, inserting a default constructed value if there is none.
+        T& operator[](const key_type& t_key) { return try_emplace(t_key).first->second; };
+        T& operator[](key_type&& t_key) { return try_emplace(std::move(t_key)).first->second; };
+
+        /// Gets the value of the element with a key.
+        /// \throws std::out_of_range if there is no element with the key.
+        template<typename K = key_type>
+        T& at(const KeyArg<K>& t_key) {
+            auto element = find(t_key);
+            if (element == end()) {
+                throw std::out_of_range("There is no element with this key in the ae::flat_hash_map!");
+            };
+            return element->second;
+        };
+
+        template<typename K = key_type>
+        const T& at(const KeyArg<K>& t_key) const {
+            auto element = find(t_key);
+            if (element == end()) {
+                throw std::out_of_range("There is no element with this key in the ae::flat_hash_map!");
+            };
+            return element->second;
+        };
+
+        /// Finds the element with a key.
+        /// \return The element, or end() if there is none.
+        template<typename K = key_type>
+        [[nodiscard]] iterator find(const KeyArg<K>& t_key) {
+            size_type index = findIndex(t_key);
+            return index == m_capacity ? end() : iteratorAt(index);
+        };
+
+        template<typename K = key_type>
+        [[nodiscard]] const_iterator find(const KeyArg<K>& t_key) const {
+            size_type index = findIndex(t_key);
+            return index == m_capacity ? end() : iteratorAt(index);
+        };
+
+        /// Checks if there is an element with a key.
+        template<typename K = key_type>
+        [[nodiscard]] bool contains(const KeyArg<K>& t_key) const { return findIndex(t_key) != m_capacity; };
+
+        /// Gets the number of elements with a key, 0 or 1.
+        template<typename K = key_type>
+        [[nodiscard]] size_type count(const KeyArg<K>& t_key) const { return contains(t_key) ? 1 : 0; };
+
+        /// Erases an element.
+        /// \return The element after the erased element.
+        iterator erase(const_iterator t_position) {
+            auto index = static_cast<size_type>(t_position.m_ctrl - m_ctrl);
+            eraseAt(index);
+            return iteratorAt(index + 1);
+        };
+
+        iterator erase(iterator t_position) { return erase(const_iterator{t_position}); };
+
+        /// Erases the element with a key.
+        /// \return The number of elements erased, 0 or 1.
+        template<typename K = key_type>
+        size_type erase(const KeyArg<K>& t_key) {
+            size_type index = findIndex(t_key);
+            if (index == m_capacity) {
+                return 0;
+            };
+            eraseAt(index);
+            return 1;
+        };
+
+        void swap(flat_hash_map& t_other) noexcept {
+            using std::swap;
+            swap(m_ctrl, t_other.m_ctrl);
+            swap(m_slots, t_other.m_slots);
+            swap(m_size, t_other.m_size);
+            swap(m_capacity, t_other.m_capacity);
+            swap(m_growthLeft, t_other.m_growthLeft);
+            swap(m_hash, t_other.m_hash);
+            swap(m_keyEqual, t_other.m_keyEqual);
+            if constexpr (SlotAllocatorTraits::propagate_on_container_swap::value) {
+                swap(m_allocator, t_other.m_allocator);
+            };
+        };
+
+        [[nodiscard]] allocator_type get_allocator() const { return allocator_type(m_allocator); };
+        [[nodiscard]] hasher hash_function() const { return m_hash; };
+        [[nodiscard]] key_equal key_eq() const { return m_keyEqual; };
+
+    private:
+
+        /// An iterator over the full slots, in the order of the slots.
+        template<bool IS_CONST>
+        class Iterator {
+        public:
+
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = typename flat_hash_map::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<IS_CONST, const value_type*, value_type*>;
+            using reference = std::conditional_t<IS_CONST, const value_type&, value_type&>;
+
+            Iterator() = default;
+
+            /// A const iterator can be made from an iterator.
+            template<bool IS_OTHER_CONST, typename = std::enable_if_t<IS_CONST && !IS_OTHER_CONST>>
+            Iterator(const Iterator<IS_OTHER_CONST>& t_other) :
+                    m_ctrl{t_other.m_ctrl},
+                    m_ctrlEnd{t_other.m_ctrlEnd},
+                    m_slot{t_other.m_slot} {};
+
+            reference operator*() const { return *m_slot; };
+            pointer operator->() const { return m_slot; };
+
+            Iterator& operator++() {
+                ++m_ctrl;
+                ++m_slot;
+                skipEmptySlots();
+                return *this;
+            };
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            };
+
+            friend bool operator==(const Iterator& t_lhs, const Iterator& t_rhs) { return t_lhs.m_ctrl == t_rhs.m_ctrl; };
+            friend bool operator!=(const Iterator& t_lhs, const Iterator& t_rhs) { return t_lhs.m_ctrl != t_rhs.m_ctrl; };
+
+        private:
+
+            friend class flat_hash_map;
+
+            template<bool IS_OTHER_CONST>
+            friend class Iterator;
+
+            Iterator(const int8_t* t_ctrl, const int8_t* t_ctrlEnd, pointer t_slot) :
+                    m_ctrl{t_ctrl},
+                    m_ctrlEnd{t_ctrlEnd},
+                    m_slot{t_slot} {};
+
+            /// Moves on to the next full slot, or the end, a group at a time. A group read near the end takes in the
+            /// copies of the first group's control bytes, so it may skip past the end and is brought back.
+            void skipEmptySlots() {
+                while (m_ctrl < m_ctrlEnd && *m_ctrl < 0) {
+                    std::size_t numSkipped = Group{m_ctrl}.countLeadingEmptyOrDeleted();
+                    m_ctrl += numSkipped;
+                    m_slot += numSkipped;
+                };
+                if (m_ctrl > m_ctrlEnd) {
+                    m_slot -= m_ctrl - m_ctrlEnd;
+                    m_ctrl = m_ctrlEnd;
+                };
+            };
+
+            const int8_t* m_ctrl = nullptr;
+            const int8_t* m_ctrlEnd = nullptr;
+            pointer m_slot = nullptr;
+
+        protected:
+
+        };
+
+        /// Gets an iterator to the first full slot from a slot onwards.
+        iterator iteratorAt(size_type t_index) {
+            iterator position{m_ctrl + t_index, m_ctrl + m_capacity, m_slots + t_index};
+            position.skipEmptySlots();
+            return position;
+        };
+
+        const_iterator iteratorAt(size_type t_index) const {
+            const_iterator position{m_ctrl + t_index, m_ctrl + m_capacity, m_slots + t_index};
+            position.skipEmptySlots();
+            return position;
+        };
+
+        /// Gets the number of elements a number of slots holds before the map grows, 7/8 of them.
+        static size_type capacityToGrowth(size_type t_capacity) { return t_capacity - t_capacity / 8; };
+
+        /// Gets the fewest slots that hold a number of elements, a power of two of at least a group.
+        static size_type growthToCapacity(size_type t_numElements) {
+            size_type capacity = Group::WIDTH;
+            while (capacityToGrowth(capacity) < t_numElements) {
+                capacity *= 2;
+            };
+            return capacity;
+        };
+
+        /// Gets the number of slots allocated for the slots and control bytes together. The control bytes follow the
+        /// slots, a byte for each slot and a copy of the first group's bytes so a group can be read past the end.
+        static size_type numSlotsAllocated(size_type t_capacity) {
+            return t_capacity + (t_capacity + Group::WIDTH + sizeof(value_type) - 1) / sizeof(value_type);
+        };
+
+        /// Gets the hash of a key that picks its slots, the lower 7 bits are the key's tag.
+        template<typename K>
+        size_type hashOf(const K& t_key) const { return flat_hash_map_detail::mixHash(m_hash(t_key)); };
+
+        /// Gets the tag kept in the control byte of the slot of a key.
+        static int8_t tagOf(size_type t_hash) { return static_cast<int8_t>(t_hash & 0x7F); };
+
+        /// Sets the control byte of a slot, and its copy if it is in the first group.
+        void setCtrl(size_type t_index, int8_t t_ctrl) {
+            m_ctrl[t_index] = t_ctrl;
+            if (t_index < Group::WIDTH) {
+                m_ctrl[m_capacity + t_index] = t_ctrl;
+            };
+        };
+
+        /// Finds the slot of the element with a key.
+        /// \return The index of the slot, the capacity if there is no element with the key.
+        template<typename K>
+        size_type findIndex(const K& t_key) const {
+            if (m_size == 0) {
+                return m_capacity;
+            };
+            size_type hash = hashOf(t_key);
+            int8_t tag = tagOf(hash);
+            flat_hash_map_detail::ProbeSequence sequence{hash >> 7, m_capacity - 1};
+            while (true) {
+                Group group{m_ctrl + sequence.offset()};
+                for (auto match = group.match(tag); match; match.removeLowest()) {
+                    size_type index = sequence.offset(match.lowest());
+                    if (m_keyEqual(m_slots[index].first, t_key)) {
+                        return index;
+                    };
+                };
+                if (group.matchEmpty()) {
+                    return m_capacity;
+                };
+                sequence.next();
+            };
+        };
+
+        /// Finds the first empty or deleted slot a hash probes.
+        size_type findFirstNonFull(size_type t_hash) const {
+            flat_hash_map_detail::ProbeSequence sequence{t_hash >> 7, m_capacity - 1};
+            while (true) {
+                auto match = Group{m_ctrl + sequence.offset()}.matchEmptyOrDeleted();
+                if (match) {
+                    return sequence.offset(match.lowest());
+                };
+                sequence.next();
+            };
+        };
+
+        /// Constructs an element in the slot of a key if there is no element with the key, growing the map when it
+        /// is full.
+        /// \param t_key The key, which must stay valid until the element has been made.
+        /// \param t_args The arguments the element is made from.
+        /// \return The element with the key, and true if it was inserted.
+        template<typename... Args>
+        std::pair<iterator, bool> emplaceUnique(const key_type& t_key, Args&&... t_args) {
+            size_type index = findIndex(t_key);
+            if (index != m_capacity) {
+                return {iteratorAt(index), false};
+            };
+
+            size_type hash = hashOf(t_key);
+            index = m_capacity == 0 ? 0 : findFirstNonFull(hash);
+            if (m_growthLeft == 0 && (m_capacity == 0 || m_ctrl[index] != flat_hash_map_detail::CTRL_DELETED)) {
+                growForInsert();
+                index = findFirstNonFull(hash);
+            };
+
+            SlotAllocatorTraits::construct(m_allocator, m_slots + index, std::forward<Args>(t_args)...);
+            if (m_ctrl[index] == flat_hash_map_detail::CTRL_EMPTY) {
+                m_growthLeft--;
+            };
+            setCtrl(index, tagOf(hash));
+            m_size++;
+            return {iteratorAt(index), true};
+        };
+
+        /// Makes room for one more element. When most of the used slots are deleted ones, the map is rebuilt at the
+        /// same size to clear them rather than doubled.
+        void growForInsert() {
+            if (m_capacity != 0 && m_size * 32 <= m_capacity * 25) {
+                resize(m_capacity);
+            } else {
+                resize(m_capacity == 0 ? Group::WIDTH : m_capacity * 2);
+            };
+        };
+
+        /// Moves every element into a new set of slots.
+        void resize(size_type t_capacity) {
+            int8_t* oldCtrl = m_ctrl;
+            value_type* oldSlots = m_slots;
+            size_type oldCapacity = m_capacity;
+
+            m_slots = SlotAllocatorTraits::allocate(m_allocator, numSlotsAllocated(t_capacity));
+            m_ctrl = reinterpret_cast<int8_t*>(m_slots + t_capacity);
+            m_capacity = t_capacity;
+            std::memset(m_ctrl, flat_hash_map_detail::CTRL_EMPTY, m_capacity + Group::WIDTH);
+            m_growthLeft = capacityToGrowth(m_capacity) - m_size;
+
+            // The old key is about to be destroyed, so it is moved from although it is const, like the node handles of
+            // the standard maps do.
+            for (size_type oldIndex = 0; oldIndex < oldCapacity; oldIndex++) {
+                if (oldCtrl[oldIndex] < 0) {
+                    continue;
+                };
+                value_type& element = oldSlots[oldIndex];
+                size_type hash = hashOf(element.first);
+                size_type index = findFirstNonFull(hash);
+                SlotAllocatorTraits::construct(m_allocator, m_slots + index, std::piecewise_construct,
+                                               std::forward_as_tuple(std::move(const_cast<Key&>(element.first))),
+                                               std::forward_as_tuple(std::move(element.second)));
+                SlotAllocatorTraits::destroy(m_allocator, &element);
+                setCtrl(index, tagOf(hash));
+            };
+
+            if (oldCapacity != 0) {
+                SlotAllocatorTraits::deallocate(m_allocator, oldSlots, numSlotsAllocated(oldCapacity));
+            };
+        };
+
+        /// Destroys the element in a slot. The slot is marked empty again if no lookup can have probed past it, which
+        /// is when it is not inside a whole group of full or deleted slots, otherwise it is marked deleted.
+        void eraseAt(size_type t_index) {
+            SlotAllocatorTraits::destroy(m_allocator, m_slots + t_index);
+            m_size--;
+
+            size_type indexBefore = (t_index - Group::WIDTH) & (m_capacity - 1);
+            auto emptyAfter = Group{m_ctrl + t_index}.matchEmpty();
+            auto emptyBefore = Group{m_ctrl + indexBefore}.matchEmpty();
+            bool isProbedPast = !emptyBefore || !emptyAfter ||
+                                emptyAfter.trailingZeros() + emptyBefore.leadingZeros() >= Group::WIDTH;
+            if (isProbedPast) {
+                setCtrl(t_index, flat_hash_map_detail::CTRL_DELETED);
+            } else {
+                setCtrl(t_index, flat_hash_map_detail::CTRL_EMPTY);
+                m_growthLeft++;
+            };
+        };
+
+        /// Destroys every element, leaving the control bytes as they were.
+        void destroyElements() {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (size_type index = 0; index < m_capacity; index++) {
+                    if (m_ctrl[index] >= 0) {
+                        SlotAllocatorTraits::destroy(m_allocator, m_slots + index);
+                    };
+                };
+            };
+            m_size = 0;
+        };
+
+        /// Gives the slots back to the allocator, the elements must already be destroyed.
+        void deallocateSlots() {
+            if (m_capacity != 0) {
+                SlotAllocatorTraits::deallocate(m_allocator, m_slots, numSlotsAllocated(m_capacity));
+            };
+            m_ctrl = nullptr;
+            m_slots = nullptr;
+            m_capacity = 0;
+            m_growthLeft = 0;
+        };
+
+        /// Takes the slots of another map, whose elements have been destroyed, leaving the other map empty.
+        void takeSlotsFrom(flat_hash_map& t_other) {
+            m_ctrl = std::exchange(t_other.m_ctrl, nullptr);
+            m_slots = std::exchange(t_other.m_slots, nullptr);
+            m_size = std::exchange(t_other.m_size, 0);
+            m_capacity = std::exchange(t_other.m_capacity, 0);
+            m_growthLeft = std::exchange(t_other.m_growthLeft, 0);
+            m_hash = std::move(t_other.m_hash);
+            m_keyEqual = std::move(t_other.m_keyEqual);
+        };
+
+        /// Copies the elements of another map into this empty map. Its keys are known to be unique, so they are put
+        /// straight into their slots without looking for them first.
+        void copyElementsFrom(const flat_hash_map& t_other) {
+            reserve(t_other.size());
+            for (size_type otherIndex = 0; otherIndex < t_other.m_capacity; otherIndex++) {
+                if (t_other.m_ctrl[otherIndex] < 0) {
+                    continue;
+                };
+                const value_type& element = t_other.m_slots[otherIndex];
+                size_type hash = hashOf(element.first);
+                size_type index = findFirstNonFull(hash);
+                SlotAllocatorTraits::construct(m_allocator, m_slots + index, element);
+                setCtrl(index, tagOf(hash));
+                m_size++;
+                m_growthLeft--;
+            };
+        };
+
+        /// The control byte of each slot, then a copy of the control bytes of the first group.
+        int8_t* m_ctrl = nullptr;
+
+        /// The slots, uninitialised unless their control byte says they are full.
+        value_type* m_slots = nullptr;
+
+        /// The number of elements.
+        size_type m_size = 0;
+
+        /// The number of slots, 0 or a power of two of at least a group.
+        size_type m_capacity = 0;
+
+        /// The number of empty slots that can be filled before the map grows.
+        size_type m_growthLeft = 0;
+
+        Hash m_hash;
+
+        KeyEqual m_keyEqual;
+
+        SlotAllocator m_allocator;
+
+    protected:
+
+    };
+
+    template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+    void swap(flat_hash_map<Key, T, Hash, KeyEqual, Allocator>& t_lhs,
+              flat_hash_map<Key, T, Hash, KeyEqual, Allocator>& t_rhs) noexcept {
+        t_lhs.swap(t_rhs);
+    };
+
+    namespace pmr {
+        /// The flat hash map allocating from a memory resource, its type does not depend on the allocator behind the
+        /// memory resource.
+        template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+        using flat_hash_map = ae::flat_hash_map<Key, T, Hash, KeyEqual,
+                                                std::pmr::polymorphic_allocator<std::pair<const Key, T>>>;
+    } // namespace pmr
+
+} // namespace ae
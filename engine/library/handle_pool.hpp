@@ -0,0 +1,274 @@
+/// \file handle_pool.hpp
+/// The AeHandle and HandlePool classes are defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ae {
+
+    /// A 32 bit reference to an object in a HandlePool. The low bits are the index of the object's slot in the pool and
+    /// the high bits are the generation of the slot when the object was added. A slot's generation is incremented each
+    /// time its object is removed, so a handle to a removed object can be detected instead of referencing whatever
+    /// object reuses the slot. Generations start at 1, which leaves a value of 0 free to be the null handle.
+    /// \tparam T The type of object referenced, only used to keep handles to different types of objects apart.
+    template<typename T>
+    class AeHandle {
+    public:
+
+        /// The number of bits used for the index of the slot.
+        static constexpr uint32_t INDEX_BITS = 20;
+
+        /// The number of bits used for the generation of the slot.
+        static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+
+        /// The mask of the index bits.
+        static constexpr uint32_t INDEX_MASK = (uint32_t{1} << INDEX_BITS) - 1;
+
+        /// The largest generation a slot can reach before its generation wraps back to 1.
+        static constexpr uint32_t MAX_GENERATION = (uint32_t{1} << GENERATION_BITS) - 1;
+
+        /// Creates a null handle.
+        constexpr AeHandle() = default;
+
+        /// Creates a handle from the index and generation of a slot.
+        /// \param t_index The index of the slot.
+        /// \param t_generation The generation of the slot, from 1 to MAX_GENERATION.
+        constexpr AeHandle(uint32_t t_index, uint32_t t_generation) :
+                m_value{(t_generation << INDEX_BITS) | (t_index & INDEX_MASK)} {};
+
+        /// Recreates a handle from its value, such as one stored in a snapshot.
+        /// \param t_value The value of the handle.
+        /// \return The handle.
+        static constexpr AeHandle fromValue(uint32_t t_value) {
+            AeHandle handle{};
+            handle.m_value = t_value;
+            return handle;
+        };
+
+        /// Gets the value of the handle, 0 for the null handle.
+        [[nodiscard]] constexpr uint32_t getValue() const { return m_value; };
+
+        /// Gets the index of the slot the handle references.
+        [[nodiscard]] constexpr uint32_t getIndex() const { return m_value & INDEX_MASK; };
+
+        /// Gets the generation of the slot when the handle was created.
+        [[nodiscard]] constexpr uint32_t getGeneration() const { return m_value >> INDEX_BITS; };
+
+        /// Checks if the handle references nothing.
+        [[nodiscard]] constexpr bool isNull() const { return m_value == 0; };
+
+        constexpr bool operator==(const AeHandle& t_other) const { return m_value == t_other.m_value; };
+        constexpr bool operator!=(const AeHandle& t_other) const { return m_value != t_other.m_value; };
+
+    private:
+
+        /// The generation and index of the slot referenced.
+        uint32_t m_value = 0;
+
+    protected:
+
+    };
+
+
+
+    /// Stores objects densely, in a vector that can be iterated without gaps, and hands out AeHandles to them. Handles
+    /// reference a slot which records where its object is in the dense storage and the slot's generation, so finding and
+    /// validating a handle's object is two array lookups. Removing an object moves the last object into its place, so
+    /// pointers and references to objects are only stable until the next removal; hold handles instead.
+    /// \tparam T The type of object stored.
+    /// \tparam THandleType The type the handles reference, the stored type by default. It allows a pool of owning
+    /// pointers to hand out handles to the objects pointed to.
+    template<typename T, typename THandleType = T>
+    class HandlePool {
+    public:
+
+        /// The type of handle the pool hands out.
+        using Handle = AeHandle<THandleType>;
+
+        /// The most objects a pool can hold, limited by the number of index bits in a handle.
+        static constexpr std::size_t MAX_OBJECTS = std::size_t{Handle::INDEX_MASK} + 1;
+
+        /// Creates an empty pool.
+        HandlePool() = default;
+
+        /// Creates an empty pool with memory reserved for a number of objects.
+        /// \param t_capacity The number of objects to reserve memory for.
+        explicit HandlePool(std::size_t t_capacity) {
+            m_objects.reserve(t_capacity);
+            m_objectSlots.reserve(t_capacity);
+            m_slots.reserve(t_capacity);
+        };
+
+        ~HandlePool() = default;
+
+        /// Do not allow this class to be copied (2 lines below)
+        HandlePool(const HandlePool&) = delete;
+        HandlePool& operator=(const HandlePool&) = delete;
+
+        /// Allow this class to be moved (2 lines below)
+        HandlePool(HandlePool&&) noexcept = default;
+        HandlePool& operator=(HandlePool&&) noexcept = default;
+
+        /// Adds an object to the pool.
+        /// \param t_object The object.
+        /// \return The handle to the object.
+        Handle insert(T t_object) {
+            return emplace(std::move(t_object));
+        };
+
+        /// Constructs an object in the pool.
+        /// \param t_args The arguments the object is constructed with.
+        /// \return The handle to the object.
+        template<typename... Args>
+        Handle emplace(Args&&... t_args) {
+            uint32_t slotIndex;
+            if (!m_freeSlots.empty()) {
+                slotIndex = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else {
+                if (m_slots.size() >= MAX_OBJECTS) {
+                    throw std::runtime_error("The handle pool is full, a handle can only index "
+                                             + std::to_string(MAX_OBJECTS) + " slots!");
+                };
+                slotIndex = static_cast<uint32_t>(m_slots.size());
+                m_slots.push_back({INVALID_INDEX, 1});
+            };
+
+            m_objects.emplace_back(std::forward<Args>(t_args)...);
+            m_objectSlots.push_back(slotIndex);
+            m_slots[slotIndex].m_objectIndex = static_cast<uint32_t>(m_objects.size() - 1);
+            return Handle{slotIndex, m_slots[slotIndex].m_generation};
+        };
+
+        /// Removes an object from the pool, handles to it are no longer valid. The last object in the dense storage is
+        /// moved into its place.
+        /// \param t_handle The handle to the object.
+        void remove(Handle t_handle) {
+            if (!isValid(t_handle)) {
+                throw std::runtime_error("Attempting to remove an object from a handle pool with a stale or null "
+                                         "handle!");
+            };
+
+            Slot& slot = m_slots[t_handle.getIndex()];
+            uint32_t objectIndex = slot.m_objectIndex;
+            uint32_t lastObjectIndex = static_cast<uint32_t>(m_objects.size() - 1);
+            if (objectIndex != lastObjectIndex) {
+                m_objects[objectIndex] = std::move(m_objects[lastObjectIndex]);
+                m_objectSlots[objectIndex] = m_objectSlots[lastObjectIndex];
+                m_slots[m_objectSlots[objectIndex]].m_objectIndex = objectIndex;
+            };
+            m_objects.pop_back();
+            m_objectSlots.pop_back();
+
+            // A generation of 0 would allow the null handle to be valid, so it is skipped when the generation wraps.
+            slot.m_objectIndex = INVALID_INDEX;
+            slot.m_generation = slot.m_generation == Handle::MAX_GENERATION ? 1 : slot.m_generation + 1;
+            m_freeSlots.push_back(t_handle.getIndex());
+        };
+
+        /// Checks if a handle references an object in the pool.
+        /// \param t_handle The handle.
+        /// \return False if the handle is null or its object has been removed.
+        [[nodiscard]] bool isValid(Handle t_handle) const {
+            uint32_t slotIndex = t_handle.getIndex();
+            return slotIndex < m_slots.size() &&
+                   m_slots[slotIndex].m_generation == t_handle.getGeneration() &&
+                   m_slots[slotIndex].m_objectIndex != INVALID_INDEX;
+        };
+
+        /// Gets the object a handle references.
+        /// \param t_handle The handle.
+        /// \return The object.
+        T& get(Handle t_handle) {
+            if (!isValid(t_handle)) {
+                throw std::runtime_error("Attempting to get an object from a handle pool with a stale or null handle!");
+            };
+            return m_objects[m_slots[t_handle.getIndex()].m_objectIndex];
+        };
+
+        /// Gets the object a handle references.
+        /// \param t_handle The handle.
+        /// \return The object.
+        const T& get(Handle t_handle) const {
+            if (!isValid(t_handle)) {
+                throw std::runtime_error("Attempting to get an object from a handle pool with a stale or null handle!");
+            };
+            return m_objects[m_slots[t_handle.getIndex()].m_objectIndex];
+        };
+
+        /// Gets the object a handle references, if it still exists.
+        /// \param t_handle The handle.
+        /// \return The object, nullptr if the handle is null or its object has been removed.
+        T* tryGet(Handle t_handle) {
+            return isValid(t_handle) ? &m_objects[m_slots[t_handle.getIndex()].m_objectIndex] : nullptr;
+        };
+
+        /// Gets the handle to an object from its position in the dense storage.
+        /// \param t_objectIndex The position of the object, less than size().
+        /// \return The handle to the object.
+        [[nodiscard]] Handle getHandle(std::size_t t_objectIndex) const {
+            uint32_t slotIndex = m_objectSlots[t_objectIndex];
+            return Handle{slotIndex, m_slots[slotIndex].m_generation};
+        };
+
+        /// Gets the number of objects in the pool.
+        [[nodiscard]] std::size_t size() const { return m_objects.size(); };
+
+        /// Checks if the pool has no objects.
+        [[nodiscard]] bool empty() const { return m_objects.empty(); };
+
+        /// Gets the number of slots the pool has created. Every handle the pool has handed out has an index below this,
+        /// so it can size arrays indexed by handle index.
+        [[nodiscard]] std::size_t getNumSlots() const { return m_slots.size(); };
+
+        /// Removes every object, handles to them are no longer valid.
+        void clear() {
+            while (!m_objects.empty()) {
+                remove(getHandle(m_objects.size() - 1));
+            };
+        };
+
+        /// Iterators over the dense storage of the objects.
+        typename std::vector<T>::iterator begin() { return m_objects.begin(); };
+        typename std::vector<T>::iterator end() { return m_objects.end(); };
+        typename std::vector<T>::const_iterator begin() const { return m_objects.begin(); };
+        typename std::vector<T>::const_iterator end() const { return m_objects.end(); };
+
+    private:
+
+        /// The object index of a slot without an object.
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        /// Where a slot's object is in the dense storage and the generation handles to it must have.
+        struct Slot {
+            uint32_t m_objectIndex;
+            uint32_t m_generation;
+        };
+
+        /// The objects, without gaps.
+        std::vector<T> m_objects;
+
+        /// The slot of each object, used to update a slot when its object is moved by a removal.
+        std::vector<uint32_t> m_objectSlots;
+
+        /// The slots handles index.
+        std::vector<Slot> m_slots;
+
+        /// The slots without objects, reused before new slots are created.
+        std::vector<uint32_t> m_freeSlots;
+
+    protected:
+
+    };
+
+} // namespace ae
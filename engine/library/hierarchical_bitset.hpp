@@ -0,0 +1,455 @@
+/// \file hierarchical_bitset.hpp
+/// The HierarchicalBitset class is defined.
+#pragma once
+
+// dependencies
+#include "simd_support.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace ae {
+
+    /// A bitset, sized when it is created, for sets of IDs such as entity IDs. Above the 64 bit words of the bitset are
+    /// levels of summary words, each summary bit covering one word of the level below, until a level fits in a single
+    /// word. One hierarchy of summaries records which words are not empty and another which words are full. Setting
+    /// and resetting a bit only climbs the levels while a word changes between empty, or full, and not, and finding
+    /// the first or next set bit, the last set bit or the first unset bit takes one word per level. Iterating over the
+    /// set bits skips every empty word, and unions and intersections skip the empty parts of the bitsets and combine
+    /// the rest with SIMD instructions when they are available.
+    class HierarchicalBitset{
+    public:
+
+        /// Value returned by searches when no matching bit exists.
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        /// Iterates over the indices of the set bits in increasing order. The bitset may have bits reset behind the
+        /// iterator while iterating.
+        class ConstIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::size_t*;
+            using reference = std::size_t;
+
+            ConstIterator() = default;
+
+            /// \param t_bitset The bitset iterated over.
+            /// \param t_index The index of a set bit, or npos for the end.
+            ConstIterator(const HierarchicalBitset* t_bitset, std::size_t t_index) :
+                    m_bitset{t_bitset}, m_index{t_index} {};
+
+            std::size_t operator*() const { return m_index; };
+
+            ConstIterator& operator++(){
+                m_index = m_bitset->findNextSet(m_index + 1);
+                return *this;
+            };
+
+            ConstIterator operator++(int){
+                ConstIterator previous = *this;
+                ++*this;
+                return previous;
+            };
+
+            bool operator==(const ConstIterator& t_other) const { return m_index == t_other.m_index; };
+            bool operator!=(const ConstIterator& t_other) const { return m_index != t_other.m_index; };
+
+        private:
+            /// The bitset iterated over.
+            const HierarchicalBitset* m_bitset = nullptr;
+
+            /// The index of the current set bit.
+            std::size_t m_index = npos;
+
+        protected:
+
+        };
+
+        /// Creates the bitset with all the bits reset.
+        /// \param t_numBits The number of bits in the bitset.
+        explicit HierarchicalBitset(std::size_t t_numBits) :
+                m_numBits{t_numBits},
+                m_words(std::max<std::size_t>((t_numBits + 63) / 64, 1), 0) {
+            std::size_t numSummaryWords = m_words.size();
+            do {
+                numSummaryWords = (numSummaryWords + 63) / 64;
+                m_nonEmptyLevels.emplace_back(numSummaryWords, 0);
+                m_fullLevels.emplace_back(numSummaryWords, 0);
+            } while (numSummaryWords > 1);
+        };
+
+        /// Sets a bit.
+        /// \param t_index The index of the bit.
+        void set(std::size_t t_index){
+            std::size_t wordIndex = t_index / 64;
+            uint64_t oldWord = m_words[wordIndex];
+            m_words[wordIndex] = oldWord | (uint64_t{1} << (t_index % 64));
+            updateSummaries(wordIndex, oldWord);
+        };
+
+        /// Resets a bit.
+        /// \param t_index The index of the bit.
+        void reset(std::size_t t_index){
+            std::size_t wordIndex = t_index / 64;
+            uint64_t oldWord = m_words[wordIndex];
+            m_words[wordIndex] = oldWord & ~(uint64_t{1} << (t_index % 64));
+            updateSummaries(wordIndex, oldWord);
+        };
+
+        /// Overwrites a whole word of 64 bits at once, bits past the end of the bitset must be zero.
+        /// \param t_wordIndex The index of the word, the word holds bits t_wordIndex * 64 to t_wordIndex * 64 + 63.
+        /// \param t_word The new bits of the word.
+        void setWord(std::size_t t_wordIndex, uint64_t t_word){
+            uint64_t oldWord = m_words[t_wordIndex];
+            m_words[t_wordIndex] = t_word;
+            updateSummaries(t_wordIndex, oldWord);
+        };
+
+        /// Resets all the bits. Only the words that are not empty are written, so clearing a sparse bitset is cheap.
+        void clear(){
+            const std::vector<uint64_t>& nonEmptyWords = m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < nonEmptyWords.size(); summaryIndex++) {
+                for (uint64_t summaryWord = nonEmptyWords[summaryIndex]; summaryWord != 0; summaryWord &= summaryWord - 1) {
+                    m_words[summaryIndex * 64 + __builtin_ctzll(summaryWord)] = 0;
+                };
+            };
+            for (std::size_t level = 0; level < m_nonEmptyLevels.size(); level++) {
+                std::fill(m_nonEmptyLevels[level].begin(), m_nonEmptyLevels[level].end(), 0);
+                std::fill(m_fullLevels[level].begin(), m_fullLevels[level].end(), 0);
+            };
+        };
+
+        /// Checks if a bit is set.
+        /// \param t_index The index of the bit.
+        /// \return True if the bit is set.
+        [[nodiscard]] bool test(std::size_t t_index) const {
+            return (m_words[t_index / 64] >> (t_index % 64)) & uint64_t{1};
+        };
+
+        /// Gets a whole word of 64 bits at once.
+        /// \param t_wordIndex The index of the word, the word holds bits t_wordIndex * 64 to t_wordIndex * 64 + 63.
+        /// \return The bits of the word.
+        [[nodiscard]] uint64_t getWord(std::size_t t_wordIndex) const { return m_words[t_wordIndex]; };
+
+        /// Gets the number of bits in the bitset.
+        /// \return The number of bits.
+        [[nodiscard]] std::size_t size() const { return m_numBits; };
+
+        /// Checks if any bit is set.
+        [[nodiscard]] bool any() const { return m_nonEmptyLevels.back()[0] != 0; };
+
+        /// Checks if no bit is set.
+        [[nodiscard]] bool none() const { return !any(); };
+
+        /// Finds the lowest bit that is set.
+        /// \return The index of the lowest set bit, npos if no bits are set.
+        [[nodiscard]] std::size_t findFirstSet() const {
+            std::size_t index = 0;
+            for (std::size_t level = m_nonEmptyLevels.size(); level-- > 0;) {
+                uint64_t nonEmptyWords = m_nonEmptyLevels[level][index];
+                if (nonEmptyWords == 0) {
+                    return npos;
+                };
+                index = index * 64 + __builtin_ctzll(nonEmptyWords);
+            };
+            return index * 64 + __builtin_ctzll(m_words[index]);
+        };
+
+        /// Finds the lowest set bit at or after an index. Climbs the levels only until a summary word shows a set bit
+        /// further on, then descends to it.
+        /// \param t_index The index to start searching from.
+        /// \return The index of the set bit, npos if no bits from t_index onwards are set.
+        [[nodiscard]] std::size_t findNextSet(std::size_t t_index) const {
+            if (t_index >= m_numBits) {
+                return npos;
+            };
+
+            // At level 0 the position is the index of a bit, above it the index of a word of the level below.
+            std::size_t position = t_index;
+            for (std::size_t level = 0; level <= m_nonEmptyLevels.size(); level++) {
+                const std::vector<uint64_t>& levelWords = getLevel(level);
+                std::size_t wordIndex = position / 64;
+                if (wordIndex >= levelWords.size()) {
+                    return npos;
+                };
+
+                uint64_t laterBits = levelWords[wordIndex] & (~uint64_t{0} << (position % 64));
+                if (laterBits != 0) {
+                    position = wordIndex * 64 + __builtin_ctzll(laterBits);
+                    for (std::size_t lowerLevel = level; lowerLevel-- > 0;) {
+                        position = position * 64 + __builtin_ctzll(getLevel(lowerLevel)[position]);
+                    };
+                    return position;
+                };
+                position = wordIndex + 1;
+            };
+            return npos;
+        };
+
+        /// Finds the lowest bit that is not set.
+        /// \return The index of the lowest unset bit, npos if all bits are set.
+        [[nodiscard]] std::size_t findFirstZero() const {
+            // Words past the end of a level are never marked as full, so reaching one means every word is full.
+            std::size_t index = 0;
+            for (std::size_t level = m_fullLevels.size(); level-- > 0;) {
+                if (index >= m_fullLevels[level].size()) {
+                    return npos;
+                };
+                index = index * 64 + __builtin_ctzll(~m_fullLevels[level][index]);
+            };
+            if (index >= m_words.size()) {
+                return npos;
+            };
+            std::size_t bitIndex = index * 64 + __builtin_ctzll(~m_words[index]);
+            return bitIndex < m_numBits ? bitIndex : npos;
+        };
+
+        /// Finds the highest bit that is set.
+        /// \return The index of the highest set bit, npos if no bits are set.
+        [[nodiscard]] std::size_t findLastSet() const {
+            std::size_t index = 0;
+            for (std::size_t level = m_nonEmptyLevels.size(); level-- > 0;) {
+                uint64_t nonEmptyWords = m_nonEmptyLevels[level][index];
+                if (nonEmptyWords == 0) {
+                    return npos;
+                };
+                index = index * 64 + 63 - __builtin_clzll(nonEmptyWords);
+            };
+            return index * 64 + 63 - __builtin_clzll(m_words[index]);
+        };
+
+        /// Counts the number of bits that are set.
+        /// \return The number of set bits.
+        [[nodiscard]] std::size_t count() const {
+            std::size_t numSet = 0;
+            const std::vector<uint64_t>& nonEmptyWords = m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < nonEmptyWords.size(); summaryIndex++) {
+                for (uint64_t summaryWord = nonEmptyWords[summaryIndex]; summaryWord != 0; summaryWord &= summaryWord - 1) {
+                    numSet += __builtin_popcountll(m_words[summaryIndex * 64 + __builtin_ctzll(summaryWord)]);
+                };
+            };
+            return numSet;
+        };
+
+        /// Counts the number of bits that are set in both this and another bitset of the same size, without building
+        /// their intersection.
+        /// \param t_other The other bitset.
+        /// \return The number of bits set in both.
+        [[nodiscard]] std::size_t countCommon(const HierarchicalBitset& t_other) const {
+            checkSameSize(t_other);
+            std::size_t numSet = 0;
+            const std::vector<uint64_t>& nonEmptyWords = m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < nonEmptyWords.size(); summaryIndex++) {
+                for (uint64_t summaryWord = nonEmptyWords[summaryIndex]; summaryWord != 0; summaryWord &= summaryWord - 1) {
+                    std::size_t wordIndex = summaryIndex * 64 + __builtin_ctzll(summaryWord);
+                    numSet += __builtin_popcountll(m_words[wordIndex] & t_other.m_words[wordIndex]);
+                };
+            };
+            return numSet;
+        };
+
+        /// Calls a function with the index of each set bit, in increasing order. Faster than the iterators as the
+        /// words are visited straight from the first summary level. The bitset must not be modified by the function.
+        /// \param t_function The function, called with the index of the bit.
+        template<typename TFunction>
+        void forEachSet(TFunction&& t_function) const {
+            const std::vector<uint64_t>& nonEmptyWords = m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < nonEmptyWords.size(); summaryIndex++) {
+                for (uint64_t summaryWord = nonEmptyWords[summaryIndex]; summaryWord != 0; summaryWord &= summaryWord - 1) {
+                    std::size_t wordIndex = summaryIndex * 64 + __builtin_ctzll(summaryWord);
+                    for (uint64_t word = m_words[wordIndex]; word != 0; word &= word - 1) {
+                        t_function(wordIndex * 64 + __builtin_ctzll(word));
+                    };
+                };
+            };
+        };
+
+        /// Iterates over the indices of the set bits.
+        [[nodiscard]] ConstIterator begin() const { return {this, findFirstSet()}; };
+
+        /// The end of the iteration over the set bits.
+        [[nodiscard]] ConstIterator end() const { return {this, npos}; };
+
+        /// Sets every bit that is set in another bitset. Only the parts of the other bitset with set bits are visited.
+        /// \param t_other A bitset of the same size.
+        /// \return This bitset.
+        HierarchicalBitset& operator|=(const HierarchicalBitset& t_other){
+            checkSameSize(t_other);
+            const std::vector<uint64_t>& otherNonEmptyWords = t_other.m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < otherNonEmptyWords.size(); summaryIndex++) {
+                if (otherNonEmptyWords[summaryIndex] != 0) {
+                    std::size_t firstWord = summaryIndex * 64;
+                    combineWords<true>(&m_words[firstWord], &t_other.m_words[firstWord], getNumSummarizedWords(summaryIndex));
+                    rebuildSummaryWord(summaryIndex);
+                };
+            };
+            return *this;
+        };
+
+        /// Resets every bit that is not set in another bitset. Only the parts of this bitset with set bits are visited.
+        /// \param t_other A bitset of the same size.
+        /// \return This bitset.
+        HierarchicalBitset& operator&=(const HierarchicalBitset& t_other){
+            checkSameSize(t_other);
+            const std::vector<uint64_t>& otherNonEmptyWords = t_other.m_nonEmptyLevels[0];
+            for (std::size_t summaryIndex = 0; summaryIndex < otherNonEmptyWords.size(); summaryIndex++) {
+                if (m_nonEmptyLevels[0][summaryIndex] != 0) {
+                    std::size_t firstWord = summaryIndex * 64;
+                    std::size_t numWords = getNumSummarizedWords(summaryIndex);
+                    if (otherNonEmptyWords[summaryIndex] == 0) {
+                        std::fill(m_words.begin() + firstWord, m_words.begin() + firstWord + numWords, 0);
+                    } else {
+                        combineWords<false>(&m_words[firstWord], &t_other.m_words[firstWord], numWords);
+                    };
+                    rebuildSummaryWord(summaryIndex);
+                };
+            };
+            return *this;
+        };
+
+    private:
+
+        /// Gets the words of a level, level 0 is the bits themselves and the levels above it the not empty summaries.
+        /// \param t_level The level.
+        /// \return The words of the level.
+        [[nodiscard]] const std::vector<uint64_t>& getLevel(std::size_t t_level) const {
+            return t_level == 0 ? m_words : m_nonEmptyLevels[t_level - 1];
+        };
+
+        /// Gets the number of words covered by a word of the first summary level, only the last can cover fewer than 64.
+        /// \param t_summaryIndex The index of the summary word.
+        [[nodiscard]] std::size_t getNumSummarizedWords(std::size_t t_summaryIndex) const {
+            return std::min<std::size_t>(64, m_words.size() - t_summaryIndex * 64);
+        };
+
+        /// Throws if another bitset is not the same size as this one.
+        /// \param t_other The other bitset.
+        void checkSameSize(const HierarchicalBitset& t_other) const {
+            if (t_other.m_numBits != m_numBits) {
+                throw std::runtime_error("Bitsets of different sizes can not be combined!");
+            };
+        };
+
+        /// Updates the summaries of a word after it has been modified.
+        /// \param t_wordIndex The index of the word that was modified.
+        /// \param t_oldWord The word before it was modified.
+        void updateSummaries(std::size_t t_wordIndex, uint64_t t_oldWord){
+            uint64_t newWord = m_words[t_wordIndex];
+            propagateSummary(m_nonEmptyLevels, 0, t_wordIndex, t_oldWord != 0, newWord != 0, false);
+            propagateSummary(m_fullLevels, 0, t_wordIndex, t_oldWord == ~uint64_t{0}, newWord == ~uint64_t{0}, true);
+        };
+
+        /// Recalculates a word of the first summary levels from the words it covers, after they have been modified in
+        /// bulk, then updates the levels above it.
+        /// \param t_summaryIndex The index of the summary word.
+        void rebuildSummaryWord(std::size_t t_summaryIndex){
+            uint64_t nonEmptyWords = 0;
+            uint64_t fullWords = 0;
+            std::size_t firstWord = t_summaryIndex * 64;
+            for (std::size_t i = 0; i < getNumSummarizedWords(t_summaryIndex); i++) {
+                uint64_t word = m_words[firstWord + i];
+                nonEmptyWords |= uint64_t{word != 0} << i;
+                fullWords |= uint64_t{word == ~uint64_t{0}} << i;
+            };
+
+            uint64_t oldNonEmptyWords = m_nonEmptyLevels[0][t_summaryIndex];
+            m_nonEmptyLevels[0][t_summaryIndex] = nonEmptyWords;
+            propagateSummary(m_nonEmptyLevels, 1, t_summaryIndex, oldNonEmptyWords != 0, nonEmptyWords != 0, false);
+
+            uint64_t oldFullWords = m_fullLevels[0][t_summaryIndex];
+            m_fullLevels[0][t_summaryIndex] = fullWords;
+            propagateSummary(m_fullLevels, 1, t_summaryIndex, oldFullWords == ~uint64_t{0}, fullWords == ~uint64_t{0},
+                             true);
+        };
+
+        /// Sets or resets the summary bit of a word whose state changed, continuing up the levels for as long as the
+        /// summary word's own state changes as well.
+        /// \param t_levels The summary levels.
+        /// \param t_level The level of the summary bit.
+        /// \param t_index The index of the word in the level below, the same as the index of its summary bit.
+        /// \param t_wasSet True if the word was empty, or full, before it changed.
+        /// \param t_isSet True if the word is empty, or full, now.
+        /// \param t_isFullSummary True for the levels recording full words, false for those recording non-empty words.
+        static void propagateSummary(std::vector<std::vector<uint64_t>>& t_levels, std::size_t t_level,
+                                     std::size_t t_index, bool t_wasSet, bool t_isSet, bool t_isFullSummary){
+            for (std::size_t level = t_level; level < t_levels.size() && t_wasSet != t_isSet; level++) {
+                uint64_t& summaryWord = t_levels[level][t_index / 64];
+                uint64_t oldSummaryWord = summaryWord;
+                uint64_t summaryBit = uint64_t{1} << (t_index % 64);
+                summaryWord = t_isSet ? (summaryWord | summaryBit) : (summaryWord & ~summaryBit);
+
+                t_wasSet = t_isFullSummary ? oldSummaryWord == ~uint64_t{0} : oldSummaryWord != 0;
+                t_isSet = t_isFullSummary ? summaryWord == ~uint64_t{0} : summaryWord != 0;
+                t_index /= 64;
+            };
+        };
+
+        /// Combines words with the words of another bitset, as many at a time as fit in a SIMD register.
+        /// \tparam isUnion True to or the words together, false to and them.
+        /// \param t_words The words written to.
+        /// \param t_otherWords The words of the other bitset.
+        /// \param t_numWords The number of words.
+        template<bool isUnion>
+        static void combineWords(uint64_t* t_words, const uint64_t* t_otherWords, std::size_t t_numWords){
+            std::size_t i = 0;
+#if defined(AE_SIMD_AVX2)
+            for (; i + 4 <= t_numWords; i += 4) {
+                __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_words + i));
+                __m256i otherWords = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_otherWords + i));
+                if constexpr (isUnion) {
+                    words = _mm256_or_si256(words, otherWords);
+                } else {
+                    words = _mm256_and_si256(words, otherWords);
+                };
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(t_words + i), words);
+            };
+#endif
+#if defined(AE_SIMD_SSE2)
+            for (; i + 2 <= t_numWords; i += 2) {
+                __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_words + i));
+                __m128i otherWords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t_otherWords + i));
+                if constexpr (isUnion) {
+                    words = _mm_or_si128(words, otherWords);
+                } else {
+                    words = _mm_and_si128(words, otherWords);
+                };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(t_words + i), words);
+            };
+#endif
+            for (; i < t_numWords; i++) {
+                if constexpr (isUnion) {
+                    t_words[i] |= t_otherWords[i];
+                } else {
+                    t_words[i] &= t_otherWords[i];
+                };
+            };
+        };
+
+        /// The number of bits in the bitset.
+        std::size_t m_numBits;
+
+        /// The bits, there is always at least one word.
+        std::vector<uint64_t> m_words;
+
+        /// The levels of summaries with a bit per word of the level below that is set when the word is not empty. The
+        /// last level is a single word.
+        std::vector<std::vector<uint64_t>> m_nonEmptyLevels;
+
+        /// The levels of summaries with a bit per word of the level below that is set when every bit of the word is
+        /// set. The last level is a single word.
+        std::vector<std::vector<uint64_t>> m_fullLevels;
+
+    protected:
+
+    };
+
+} // namespace ae
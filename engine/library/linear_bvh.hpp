@@ -0,0 +1,655 @@
+/// \file linear_bvh.hpp
+/// The Morton code functions and the LinearBvh class are defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "radix_sort.hpp"
+#include "simd_geometry.hpp"
+#include "thread_pool.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace ae {
+
+    /// The precisions of Morton code a LinearBvh can sort its primitives by.
+    enum MortonCodeBits {
+        /// 10 bits for each axis in a 32 bit code, enough to tell apart primitives 1/1024th of the scene apart.
+        mortonCodeBits_30,
+        /// 21 bits for each axis in a 64 bit code, for large scenes where many primitives would share a 30 bit code.
+        mortonCodeBits_63
+    };
+
+    namespace morton_detail {
+
+        /// Quantises a coordinate in [0, 1] to an integer in [0, t_maxValue], NaNs and values below 0 give 0.
+        template<typename TInteger>
+        TInteger quantise(float t_value, TInteger t_maxValue){
+            float scaled = t_value * (static_cast<float>(t_maxValue) + 1.0f);
+            if (!(scaled > 0.0f)) {
+                return 0;
+            };
+            return scaled >= static_cast<float>(t_maxValue) ? t_maxValue : static_cast<TInteger>(scaled);
+        };
+    }
+
+    /// Spreads the lowest 10 bits of a value out so that two zero bits follow each of them.
+    /// \param t_value The value.
+    /// \return The bits of the value at every third bit from bit 0 to bit 27.
+    inline uint32_t expandMortonBits10(uint32_t t_value){
+        t_value &= 0x000003ffu;
+        t_value = (t_value | (t_value << 16)) & 0x030000ffu;
+        t_value = (t_value | (t_value << 8)) & 0x0300f00fu;
+        t_value = (t_value | (t_value << 4)) & 0x030c30c3u;
+        t_value = (t_value | (t_value << 2)) & 0x09249249u;
+        return t_value;
+    };
+
+    /// Spreads the lowest 21 bits of a value out so that two zero bits follow each of them.
+    /// \param t_value The value.
+    /// \return The bits of the value at every third bit from bit 0 to bit 60.
+    inline uint64_t expandMortonBits21(uint64_t t_value){
+        t_value &= 0x00000000001fffffull;
+        t_value = (t_value | (t_value << 32)) & 0x001f00000000ffffull;
+        t_value = (t_value | (t_value << 16)) & 0x001f0000ff0000ffull;
+        t_value = (t_value | (t_value << 8)) & 0x100f00f00f00f00full;
+        t_value = (t_value | (t_value << 4)) & 0x10c30c30c30c30c3ull;
+        t_value = (t_value | (t_value << 2)) & 0x1249249249249249ull;
+        return t_value;
+    };
+
+    /// Calculates the 30 bit Morton code of a point, interleaving 10 bits of each coordinate with x the most significant,
+    /// so points close together in space tend to be close together when sorted by their codes.
+    /// \param t_x The x coordinate, scaled to [0, 1] over the scene, values outside are clamped.
+    /// \param t_y The y coordinate, scaled to [0, 1] over the scene.
+    /// \param t_z The z coordinate, scaled to [0, 1] over the scene.
+    /// \return The code.
+    inline uint32_t mortonCode30(float t_x, float t_y, float t_z){
+        return (expandMortonBits10(morton_detail::quantise<uint32_t>(t_x, 1023)) << 2) |
+               (expandMortonBits10(morton_detail::quantise<uint32_t>(t_y, 1023)) << 1) |
+               expandMortonBits10(morton_detail::quantise<uint32_t>(t_z, 1023));
+    };
+
+    /// Calculates the 63 bit Morton code of a point, interleaving 21 bits of each coordinate with x the most significant.
+    /// \param t_x The x coordinate, scaled to [0, 1] over the scene, values outside are clamped.
+    /// \param t_y The y coordinate, scaled to [0, 1] over the scene.
+    /// \param t_z The z coordinate, scaled to [0, 1] over the scene.
+    /// \return The code.
+    inline uint64_t mortonCode63(float t_x, float t_y, float t_z){
+        return (expandMortonBits21(morton_detail::quantise<uint64_t>(t_x, 0x1fffff)) << 2) |
+               (expandMortonBits21(morton_detail::quantise<uint64_t>(t_y, 0x1fffff)) << 1) |
+               expandMortonBits21(morton_detail::quantise<uint64_t>(t_z, 0x1fffff));
+    };
+
+    /// A node of a LinearBvh, two to a cache line.
+    struct BvhNode {
+        /// The minimum corner of the node's bounds.
+        std::array<float, 3> m_min{};
+
+        /// The maximum corner of the node's bounds.
+        std::array<float, 3> m_max{};
+
+        /// The left child of an internal node, or the primitive of a leaf.
+        uint32_t m_left = 0;
+
+        /// The right child of an internal node, LinearBvh::INVALID_NODE for a leaf.
+        uint32_t m_right = 0;
+    };
+
+    /// A bounding volume hierarchy over AABBs for culling, ray casts and broadphase collision, built in linear time the
+    /// way Karras' "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d Trees" does. The primitives are
+    /// sorted by the Morton codes of their centres with the engine's radix sort, and each internal node then finds its
+    /// own range of primitives and split from the sorted codes alone, so every node can be built at once on separate
+    /// threads. Primitives sharing a code are split by their position in the sorted order.
+    ///
+    /// The nodes are kept in one array, the n - 1 internal nodes first, with the root at 0, then the n leaves in sorted
+    /// order. When primitives move their leaves can be refit, recalculating the bounds of every node without rebuilding
+    /// the tree, which stays correct but grows looser the further the primitives move from where they were built.
+    /// Queries visit the primitives they find in no particular order.
+    class LinearBvh{
+    public:
+
+        /// The index of no node, also the parent of the root.
+        static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+        /// The deepest a tree can be. Every level below the root splits on a longer common prefix of the codes, or of
+        /// the 32 bit positions of primitives sharing a code, so a tree is never deeper than 64 + 32 levels.
+        static constexpr std::size_t MAX_DEPTH = 128;
+
+        /// Creates an empty BVH.
+        /// \param t_allocator The allocator the radix sort's scratch memory is borrowed from while building. The heap
+        /// is used when nullptr.
+        explicit LinearBvh(ae_memory::AeAllocatorBase* t_allocator = nullptr) : m_allocator{t_allocator} {};
+
+        /// Builds the tree over a set of AABBs on the calling thread.
+        /// \param t_aabbs The AABBs, a primitive's index is its index in them.
+        /// \param t_mortonCodeBits The precision of the Morton codes the primitives are sorted by.
+        void build(const AabbSoa& t_aabbs, MortonCodeBits t_mortonCodeBits = mortonCodeBits_30){
+            buildTree(static_cast<AeThreadPool*>(nullptr), t_aabbs, t_mortonCodeBits);
+        };
+
+        /// Builds the tree over a set of AABBs, splitting each step across the threads of a pool. Gives the same tree
+        /// as build.
+        /// \tparam TThreadPool The type of thread pool, AeThreadPool or anything with the same getNumThreads() and
+        /// parallelFor(numTasks, task), such as the engine's job system.
+        /// \param t_threadPool The threads to build with.
+        /// \param t_aabbs The AABBs, a primitive's index is its index in them.
+        /// \param t_mortonCodeBits The precision of the Morton codes the primitives are sorted by.
+        template<typename TThreadPool>
+        void parallelBuild(TThreadPool& t_threadPool, const AabbSoa& t_aabbs,
+                           MortonCodeBits t_mortonCodeBits = mortonCodeBits_30){
+            buildTree(&t_threadPool, t_aabbs, t_mortonCodeBits);
+        };
+
+        /// Recalculates the bounds of every node from moved AABBs, keeping the tree as it was built.
+        /// \param t_aabbs The AABBs, the same number as the tree was built with.
+        void refit(const AabbSoa& t_aabbs){
+            refitTree(static_cast<AeThreadPool*>(nullptr), t_aabbs);
+        };
+
+        /// Recalculates the bounds of every node from moved AABBs, splitting the work across the threads of a pool.
+        /// \tparam TThreadPool The type of thread pool, such as AeThreadPool or the engine's job system.
+        /// \param t_threadPool The threads to refit with.
+        /// \param t_aabbs The AABBs, the same number as the tree was built with.
+        template<typename TThreadPool>
+        void parallelRefit(TThreadPool& t_threadPool, const AabbSoa& t_aabbs){
+            refitTree(&t_threadPool, t_aabbs);
+        };
+
+        /// Finds the primitives whose AABBs are at least partly inside a frustum, the same primitives cullAabbs keeps.
+        /// Planes a node is entirely in front of are not tested again below it.
+        /// \param t_frustum The frustum.
+        /// \param t_onPrimitive Called with the index of each primitive found.
+        template<typename TFunction>
+        void queryFrustum(const Frustum& t_frustum, TFunction&& t_onPrimitive) const {
+            if (m_nodes.empty()) {
+                return;
+            };
+            constexpr uint32_t allPlanes = (1u << 6) - 1;
+            std::array<std::pair<uint32_t, uint32_t>, MAX_DEPTH> stack;
+            std::size_t stackSize = 0;
+            stack[stackSize++] = {0, allPlanes};
+            while (stackSize > 0) {
+                auto [nodeIndex, planes] = stack[--stackSize];
+                const BvhNode& node = m_nodes[nodeIndex];
+                bool isOutside = false;
+                for (uint32_t plane = 0; plane < 6 && !isOutside; plane++) {
+                    if ((planes & (1u << plane)) == 0) {
+                        continue;
+                    };
+                    const Plane& frustumPlane = t_frustum.m_planes[plane];
+                    float furthest = frustumPlane.m_distance;
+                    float nearest = frustumPlane.m_distance;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        bool isFacingMax = frustumPlane.m_normal[axis] >= 0.0f;
+                        furthest += frustumPlane.m_normal[axis] * (isFacingMax ? node.m_max[axis] : node.m_min[axis]);
+                        nearest += frustumPlane.m_normal[axis] * (isFacingMax ? node.m_min[axis] : node.m_max[axis]);
+                    };
+                    isOutside = !(furthest >= 0.0f);
+                    if (nearest >= 0.0f) {
+                        planes &= ~(1u << plane);
+                    };
+                };
+                if (isOutside) {
+                    continue;
+                };
+                if (node.m_right == INVALID_NODE) {
+                    t_onPrimitive(node.m_left);
+                } else {
+                    stack[stackSize++] = {node.m_right, planes};
+                    stack[stackSize++] = {node.m_left, planes};
+                };
+            };
+        };
+
+        /// Finds the primitives whose AABBs overlap or touch an AABB.
+        /// \param t_min The minimum corner of the AABB.
+        /// \param t_max The maximum corner of the AABB.
+        /// \param t_onPrimitive Called with the index of each primitive found.
+        template<typename TFunction>
+        void queryAabb(const std::array<float, 3>& t_min, const std::array<float, 3>& t_max,
+                       TFunction&& t_onPrimitive) const {
+            queryLeaves(t_min, t_max, [&](uint32_t t_leaf) { t_onPrimitive(m_nodes[t_leaf].m_left); });
+        };
+
+        /// Finds the primitives whose AABBs a sphere overlaps or touches, the same primitives overlapSphereAabbs finds.
+        /// \param t_center The centre of the sphere.
+        /// \param t_radius The radius of the sphere.
+        /// \param t_onPrimitive Called with the index of each primitive found.
+        template<typename TFunction>
+        void querySphere(const std::array<float, 3>& t_center, float t_radius, TFunction&& t_onPrimitive) const {
+            const float squaredRadius = t_radius * t_radius;
+            forEachLeaf([&](const BvhNode& t_node) {
+                float squaredDistance = 0.0f;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    float atLeastMin = t_center[axis] > t_node.m_min[axis] ? t_center[axis] : t_node.m_min[axis];
+                    float closest = atLeastMin < t_node.m_max[axis] ? atLeastMin : t_node.m_max[axis];
+                    float offset = t_center[axis] - closest;
+                    squaredDistance = squaredDistance + offset * offset;
+                };
+                return squaredDistance <= squaredRadius;
+            }, [&](uint32_t t_leaf) { t_onPrimitive(m_nodes[t_leaf].m_left); });
+        };
+
+        /// Finds the primitive a ray hits first, visiting the nearer child of each node first and skipping nodes
+        /// further away than the closest hit so far. The distances are calculated the same way as raycastAabbs.
+        /// \param t_ray The ray.
+        /// \param t_maxDistance How far along the ray to look, in multiples of the ray's direction.
+        /// \param t_hitDistance Set to the distance along the ray the primitive's AABB is entered, if not nullptr.
+        /// \return The index of the primitive, or NO_HIT.
+        std::size_t raycast(const Ray& t_ray, float t_maxDistance, float* t_hitDistance = nullptr) const {
+            const float miss = std::numeric_limits<float>::infinity();
+            std::size_t closestHit = NO_HIT;
+            float closestDistance = miss;
+            if (!m_nodes.empty()) {
+                std::array<float, 3> inverseDirection{};
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    inverseDirection[axis] = 1.0f / t_ray.m_direction[axis];
+                };
+                auto getEntry = [&](const BvhNode& t_node) {
+                    float entry = 0.0f;
+                    float exit = t_maxDistance;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        float minDistance = (t_node.m_min[axis] - t_ray.m_origin[axis]) * inverseDirection[axis];
+                        float maxDistance = (t_node.m_max[axis] - t_ray.m_origin[axis]) * inverseDirection[axis];
+                        float nearer = minDistance < maxDistance ? minDistance : maxDistance;
+                        float further = minDistance > maxDistance ? minDistance : maxDistance;
+                        entry = nearer > entry ? nearer : entry;
+                        exit = further < exit ? further : exit;
+                    };
+                    return entry <= exit ? entry : miss;
+                };
+
+                std::array<std::pair<uint32_t, float>, MAX_DEPTH> stack;
+                std::size_t stackSize = 0;
+                float rootEntry = getEntry(m_nodes[0]);
+                if (rootEntry != miss) {
+                    stack[stackSize++] = {0, rootEntry};
+                };
+                while (stackSize > 0) {
+                    auto [nodeIndex, entry] = stack[--stackSize];
+                    if (entry > closestDistance) {
+                        continue;
+                    };
+                    const BvhNode& node = m_nodes[nodeIndex];
+                    if (node.m_right == INVALID_NODE) {
+                        if (entry < closestDistance || (entry == closestDistance && node.m_left < closestHit)) {
+                            closestDistance = entry;
+                            closestHit = node.m_left;
+                        };
+                        continue;
+                    };
+                    float leftEntry = getEntry(m_nodes[node.m_left]);
+                    float rightEntry = getEntry(m_nodes[node.m_right]);
+                    std::pair<uint32_t, float> nearer{node.m_left, leftEntry};
+                    std::pair<uint32_t, float> further{node.m_right, rightEntry};
+                    if (rightEntry < leftEntry) {
+                        std::swap(nearer, further);
+                    };
+                    if (further.second != miss) {
+                        stack[stackSize++] = further;
+                    };
+                    if (nearer.second != miss) {
+                        stack[stackSize++] = nearer;
+                    };
+                };
+            };
+            if (t_hitDistance) {
+                *t_hitDistance = closestDistance;
+            };
+            return closestHit;
+        };
+
+        /// Finds every pair of primitives whose AABBs overlap or touch, for the broadphase of collision detection.
+        /// Each pair is found once.
+        /// \param t_onPair Called with the indices of the two primitives of each pair.
+        template<typename TFunction>
+        void findOverlappingPairs(TFunction&& t_onPair) const {
+            findPairs(static_cast<AeThreadPool*>(nullptr), t_onPair);
+        };
+
+        /// Finds every pair of primitives whose AABBs overlap or touch, splitting the leaves across the threads of a
+        /// pool.
+        /// \tparam TThreadPool The type of thread pool, such as AeThreadPool or the engine's job system.
+        /// \param t_threadPool The threads to search with.
+        /// \param t_onPair Called with the indices of the two primitives of each pair, from several threads at once.
+        template<typename TThreadPool, typename TFunction>
+        void parallelFindOverlappingPairs(TThreadPool& t_threadPool, TFunction&& t_onPair) const {
+            findPairs(&t_threadPool, t_onPair);
+        };
+
+        /// Gets the nodes, the internal nodes then the leaves, the root at 0.
+        [[nodiscard]] const std::vector<BvhNode>& getNodes() const { return m_nodes; };
+
+        /// Gets the parent of each node, INVALID_NODE for the root.
+        [[nodiscard]] const std::vector<uint32_t>& getParents() const { return m_parents; };
+
+        /// Gets the sorted Morton code of each leaf.
+        [[nodiscard]] const std::vector<uint64_t>& getMortonCodes() const { return m_mortonCodes; };
+
+        /// Gets the number of primitives the tree was built over.
+        [[nodiscard]] std::size_t getNumPrimitives() const { return m_mortonCodes.size(); };
+
+        /// Checks if a node is a leaf.
+        /// \param t_nodeIndex The index of the node.
+        [[nodiscard]] bool isLeaf(uint32_t t_nodeIndex) const { return m_nodes[t_nodeIndex].m_right == INVALID_NODE; };
+
+    private:
+
+        /// The fewest primitives each thread of a parallel step is given, smaller trees are given fewer threads.
+        static constexpr std::size_t MIN_PRIMITIVES_PER_THREAD = 8192;
+
+        /// Gets the number of ranges a step over primitives is split into.
+        /// \param t_threadPool The threads, nullptr for the calling thread alone.
+        /// \param t_count The number of primitives.
+        template<typename TThreadPool>
+        static std::size_t getNumRanges(TThreadPool* t_threadPool, std::size_t t_count){
+            return t_threadPool ? std::clamp<std::size_t>(t_count / MIN_PRIMITIVES_PER_THREAD, 1,
+                                                          t_threadPool->getNumThreads()) : 1;
+        };
+
+        /// Runs a task over a range of indices split into ranges, each on its own thread.
+        /// \param t_threadPool The threads, nullptr for the calling thread alone.
+        /// \param t_count The number of indices.
+        /// \param t_numRanges The number of ranges.
+        /// \param t_task Called with the index of the range, its first index and one past its last index.
+        template<typename TThreadPool, typename TTask>
+        static void forEachRange(TThreadPool* t_threadPool, std::size_t t_count, std::size_t t_numRanges, TTask&& t_task){
+            auto runRange = [&](std::size_t t_range) {
+                t_task(t_range, t_count * t_range / t_numRanges, t_count * (t_range + 1) / t_numRanges);
+            };
+            if (t_numRanges == 1 || t_threadPool == nullptr) {
+                runRange(0);
+            } else {
+                t_threadPool->parallelFor(t_numRanges, runRange);
+            };
+        };
+
+        /// Builds the tree, on the threads of a pool or on the calling thread when it is nullptr.
+        template<typename TThreadPool>
+        void buildTree(TThreadPool* t_threadPool, const AabbSoa& t_aabbs, MortonCodeBits t_mortonCodeBits){
+            const std::size_t numPrimitives = t_aabbs.size();
+            if (numPrimitives >= INVALID_NODE / 2) {
+                throw std::runtime_error("A linear BVH can not be built over more than 2^31 primitives!");
+            };
+            m_mortonCodes.resize(numPrimitives);
+            m_sortedPrimitives.resize(numPrimitives);
+            if (numPrimitives == 0) {
+                m_nodes.clear();
+                m_parents.clear();
+                return;
+            };
+            m_nodes.resize(2 * numPrimitives - 1);
+            m_parents.resize(2 * numPrimitives - 1);
+            const std::size_t numRanges = getNumRanges(t_threadPool, numPrimitives);
+
+            // The bounds of the centres of the AABBs, which the Morton codes are scaled to.
+            std::vector<std::array<float, 6>> rangeBounds(numRanges);
+            forEachRange(t_threadPool, numPrimitives, numRanges, [&](std::size_t t_range, std::size_t t_begin, std::size_t t_end) {
+                std::array<float, 6> bounds{};
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    bounds[axis] = std::numeric_limits<float>::infinity();
+                    bounds[axis + 3] = -std::numeric_limits<float>::infinity();
+                    for (std::size_t primitive = t_begin; primitive < t_end; primitive++) {
+                        float center = getCenter(t_aabbs, axis, primitive);
+                        bounds[axis] = std::min(bounds[axis], center);
+                        bounds[axis + 3] = std::max(bounds[axis + 3], center);
+                    };
+                };
+                rangeBounds[t_range] = bounds;
+            });
+            std::array<float, 3> sceneMin = {rangeBounds[0][0], rangeBounds[0][1], rangeBounds[0][2]};
+            std::array<float, 3> inverseExtent{};
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float sceneMax = rangeBounds[0][axis + 3];
+                for (const auto& bounds: rangeBounds) {
+                    sceneMin[axis] = std::min(sceneMin[axis], bounds[axis]);
+                    sceneMax = std::max(sceneMax, bounds[axis + 3]);
+                };
+                inverseExtent[axis] = sceneMax > sceneMin[axis] ? 1.0f / (sceneMax - sceneMin[axis]) : 0.0f;
+            };
+
+            forEachRange(t_threadPool, numPrimitives, numRanges, [&](std::size_t, std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t primitive = t_begin; primitive < t_end; primitive++) {
+                    std::array<float, 3> position{};
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        position[axis] = (getCenter(t_aabbs, axis, primitive) - sceneMin[axis]) * inverseExtent[axis];
+                    };
+                    m_mortonCodes[primitive] = t_mortonCodeBits == mortonCodeBits_63 ?
+                                               mortonCode63(position[0], position[1], position[2]) :
+                                               mortonCode30(position[0], position[1], position[2]);
+                    m_sortedPrimitives[primitive] = static_cast<uint32_t>(primitive);
+                };
+            });
+
+            // The radix sort skips the passes over the upper bytes that every 30 bit code leaves at zero.
+            if (t_threadPool) {
+                parallelRadixSort(*t_threadPool, m_mortonCodes.data(), m_sortedPrimitives.data(), numPrimitives,
+                                  m_allocator);
+            } else {
+                radixSort(m_mortonCodes.data(), m_sortedPrimitives.data(), numPrimitives, m_allocator);
+            };
+
+            const uint32_t firstLeaf = static_cast<uint32_t>(numPrimitives - 1);
+            m_parents[0] = INVALID_NODE;
+            forEachRange(t_threadPool, numPrimitives, numRanges, [&](std::size_t, std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t leaf = t_begin; leaf < t_end; leaf++) {
+                    BvhNode& node = m_nodes[firstLeaf + leaf];
+                    node.m_left = m_sortedPrimitives[leaf];
+                    node.m_right = INVALID_NODE;
+                    setLeafBounds(node, t_aabbs);
+                };
+                for (std::size_t internal = t_begin; internal < std::min(t_end, numPrimitives - 1); internal++) {
+                    buildInternalNode(static_cast<int64_t>(internal), firstLeaf);
+                };
+            });
+
+            m_numUnfinishedChildren = std::vector<std::atomic<uint32_t>>(numPrimitives - 1);
+            updateInternalBounds(t_threadPool, numRanges);
+        };
+
+        /// Refits the tree, on the threads of a pool or on the calling thread when it is nullptr.
+        template<typename TThreadPool>
+        void refitTree(TThreadPool* t_threadPool, const AabbSoa& t_aabbs){
+            const std::size_t numPrimitives = getNumPrimitives();
+            if (t_aabbs.size() != numPrimitives) {
+                throw std::runtime_error("A linear BVH can only be refit with as many AABBs as it was built with!");
+            };
+            if (numPrimitives == 0) {
+                return;
+            };
+            const std::size_t numRanges = getNumRanges(t_threadPool, numPrimitives);
+            forEachRange(t_threadPool, numPrimitives, numRanges, [&](std::size_t, std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t leaf = t_begin; leaf < t_end; leaf++) {
+                    setLeafBounds(m_nodes[numPrimitives - 1 + leaf], t_aabbs);
+                };
+            });
+            updateInternalBounds(t_threadPool, numRanges);
+        };
+
+        /// Gets the centre of an AABB along an axis.
+        static float getCenter(const AabbSoa& t_aabbs, std::size_t t_axis, std::size_t t_index){
+            return (t_aabbs.m_min[t_axis][t_index] + t_aabbs.m_max[t_axis][t_index]) * 0.5f;
+        };
+
+        /// Sets the bounds of a leaf to the AABB of its primitive.
+        static void setLeafBounds(BvhNode& t_leaf, const AabbSoa& t_aabbs){
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                t_leaf.m_min[axis] = t_aabbs.m_min[axis][t_leaf.m_left];
+                t_leaf.m_max[axis] = t_aabbs.m_max[axis][t_leaf.m_left];
+            };
+        };
+
+        /// Gets the length of the common prefix of two leaves' codes, extended by their positions when the codes are
+        /// the same so that every leaf is distinct.
+        /// \param t_first The position of a leaf in the sorted order.
+        /// \param t_second The position of another leaf, -1 when it is outside the leaves.
+        int commonPrefix(int64_t t_first, int64_t t_second) const {
+            if (t_second < 0 || t_second >= static_cast<int64_t>(m_mortonCodes.size())) {
+                return -1;
+            };
+            uint64_t first = m_mortonCodes[t_first];
+            uint64_t second = m_mortonCodes[t_second];
+            if (first == second) {
+                return 64 + __builtin_clzll(static_cast<uint64_t>(t_first ^ t_second));
+            };
+            return __builtin_clzll(first ^ second);
+        };
+
+        /// Builds an internal node, finding the range of leaves it covers from the codes either side of its position
+        /// and then where the range splits between its children.
+        /// \param t_index The index of the internal node.
+        /// \param t_firstLeaf The index of the first leaf node.
+        void buildInternalNode(int64_t t_index, uint32_t t_firstLeaf){
+            // The range extends the way the neighbouring code shares the longer prefix.
+            const int64_t direction = commonPrefix(t_index, t_index + 1) > commonPrefix(t_index, t_index - 1) ? 1 : -1;
+            const int minPrefix = commonPrefix(t_index, t_index - direction);
+            int64_t maxLength = 2;
+            while (commonPrefix(t_index, t_index + maxLength * direction) > minPrefix) {
+                maxLength *= 2;
+            };
+            int64_t length = 0;
+            for (int64_t step = maxLength / 2; step >= 1; step /= 2) {
+                if (commonPrefix(t_index, t_index + (length + step) * direction) > minPrefix) {
+                    length += step;
+                };
+            };
+            const int64_t end = t_index + length * direction;
+
+            // The split is after the last leaf sharing more than the whole range's prefix with the first.
+            const int nodePrefix = commonPrefix(t_index, end);
+            int64_t split = 0;
+            int64_t step = length;
+            do {
+                step = (step + 1) / 2;
+                if (commonPrefix(t_index, t_index + (split + step) * direction) > nodePrefix) {
+                    split += step;
+                };
+            } while (step > 1);
+            const int64_t splitPosition = t_index + split * direction + std::min<int64_t>(direction, 0);
+
+            BvhNode& node = m_nodes[t_index];
+            node.m_left = static_cast<uint32_t>(std::min(t_index, end) == splitPosition ?
+                                                t_firstLeaf + splitPosition : splitPosition);
+            node.m_right = static_cast<uint32_t>(std::max(t_index, end) == splitPosition + 1 ?
+                                                 t_firstLeaf + splitPosition + 1 : splitPosition + 1);
+            m_parents[node.m_left] = static_cast<uint32_t>(t_index);
+            m_parents[node.m_right] = static_cast<uint32_t>(t_index);
+        };
+
+        /// Calculates the bounds of the internal nodes from the leaves up. Each leaf climbs towards the root and the
+        /// second child to reach a node calculates its bounds and carries on, so each node is calculated once its
+        /// children have been, whichever threads they were calculated on.
+        template<typename TThreadPool>
+        void updateInternalBounds(TThreadPool* t_threadPool, std::size_t t_numRanges){
+            const std::size_t numPrimitives = getNumPrimitives();
+            for (auto& numUnfinishedChildren: m_numUnfinishedChildren) {
+                numUnfinishedChildren.store(2, std::memory_order_relaxed);
+            };
+            forEachRange(t_threadPool, numPrimitives, t_numRanges, [&](std::size_t, std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t leaf = t_begin; leaf < t_end; leaf++) {
+                    uint32_t parent = m_parents[numPrimitives - 1 + leaf];
+                    while (parent != INVALID_NODE &&
+                           m_numUnfinishedChildren[parent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        BvhNode& node = m_nodes[parent];
+                        const BvhNode& left = m_nodes[node.m_left];
+                        const BvhNode& right = m_nodes[node.m_right];
+                        for (std::size_t axis = 0; axis < 3; axis++) {
+                            node.m_min[axis] = std::min(left.m_min[axis], right.m_min[axis]);
+                            node.m_max[axis] = std::max(left.m_max[axis], right.m_max[axis]);
+                        };
+                        parent = m_parents[parent];
+                    };
+                };
+            });
+        };
+
+        /// Visits the leaves of the nodes that pass a test, skipping the nodes below a node that fails it.
+        /// \param t_isOverlapping The test, given a node.
+        /// \param t_onLeaf Called with the index of each leaf that passes.
+        template<typename TTest, typename TFunction>
+        void forEachLeaf(TTest&& t_isOverlapping, TFunction&& t_onLeaf) const {
+            if (m_nodes.empty()) {
+                return;
+            };
+            std::array<uint32_t, MAX_DEPTH> stack;
+            std::size_t stackSize = 0;
+            stack[stackSize++] = 0;
+            while (stackSize > 0) {
+                uint32_t nodeIndex = stack[--stackSize];
+                const BvhNode& node = m_nodes[nodeIndex];
+                if (!t_isOverlapping(node)) {
+                    continue;
+                };
+                if (node.m_right == INVALID_NODE) {
+                    t_onLeaf(nodeIndex);
+                } else {
+                    stack[stackSize++] = node.m_right;
+                    stack[stackSize++] = node.m_left;
+                };
+            };
+        };
+
+        /// Finds the overlapping pairs, each leaf looking for the leaves after it that it overlaps.
+        template<typename TThreadPool, typename TFunction>
+        void findPairs(TThreadPool* t_threadPool, TFunction& t_onPair) const {
+            const std::size_t numPrimitives = getNumPrimitives();
+            const uint32_t firstLeaf = static_cast<uint32_t>(numPrimitives == 0 ? 0 : numPrimitives - 1);
+            forEachRange(t_threadPool, numPrimitives, getNumRanges(t_threadPool, numPrimitives),
+                         [&](std::size_t, std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t leaf = t_begin; leaf < t_end; leaf++) {
+                    const uint32_t leafIndex = firstLeaf + static_cast<uint32_t>(leaf);
+                    const BvhNode& leafNode = m_nodes[leafIndex];
+                    queryLeaves(leafNode.m_min, leafNode.m_max, [&](uint32_t t_otherLeaf) {
+                        if (t_otherLeaf > leafIndex) {
+                            t_onPair(leafNode.m_left, m_nodes[t_otherLeaf].m_left);
+                        };
+                    });
+                };
+            });
+        };
+
+        /// Visits the leaves whose bounds overlap or touch an AABB.
+        template<typename TFunction>
+        void queryLeaves(const std::array<float, 3>& t_min, const std::array<float, 3>& t_max, TFunction&& t_onLeaf) const {
+            forEachLeaf([&](const BvhNode& t_node) {
+                return t_node.m_min[0] <= t_max[0] && t_node.m_max[0] >= t_min[0] &&
+                       t_node.m_min[1] <= t_max[1] && t_node.m_max[1] >= t_min[1] &&
+                       t_node.m_min[2] <= t_max[2] && t_node.m_max[2] >= t_min[2];
+            }, t_onLeaf);
+        };
+
+        /// The allocator the radix sort's scratch memory is borrowed from.
+        ae_memory::AeAllocatorBase* m_allocator;
+
+        /// The internal nodes then the leaves.
+        std::vector<BvhNode> m_nodes;
+
+        /// The parent of each node.
+        std::vector<uint32_t> m_parents;
+
+        /// The Morton code of each leaf, sorted.
+        std::vector<uint64_t> m_mortonCodes;
+
+        /// The primitive of each leaf, sorted with the codes.
+        std::vector<uint32_t> m_sortedPrimitives;
+
+        /// The number of children of each internal node whose bounds are still to be calculated during an update.
+        std::vector<std::atomic<uint32_t>> m_numUnfinishedChildren;
+
+    protected:
+
+    };
+
+} // namespace ae
@@ -0,0 +1,187 @@
+/// \file mpmc_queue.hpp
+/// The MpmcQueue class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "allocator_buffer.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace ae {
+
+    /// A bounded queue any number of threads can push to and pop from at once without locks, after Dmitry Vyukov's
+    /// bounded MPMC queue. Every slot has a sequence number saying whose turn it is. A producer may fill a slot when its
+    /// sequence equals the producer's position, and a consumer may empty it when its sequence is one past the position.
+    /// So a push or pop is a single compare and swap of the enqueue or dequeue position, each on its own cache line,
+    /// and the slot is then used without being contended. An element is only visible to consumers once it is fully
+    /// constructed, and a slot is only refilled once its element has been moved out.
+    /// \tparam T The type of element.
+    template<typename T>
+    class MpmcQueue {
+    public:
+
+        /// Creates the queue, its slots are borrowed from an allocator.
+        /// \param t_capacity The most elements the queue holds, rounded up to a power of two of at least 2.
+        /// \param t_allocator The allocator the slots are borrowed from, nullptr for the heap.
+        explicit MpmcQueue(std::size_t t_capacity, ae_memory::AeAllocatorBase* t_allocator = nullptr) :
+                m_capacity{roundUpToPowerOfTwo(t_capacity)},
+                m_slots{t_allocator, sizeof(Slot) * m_capacity, std::max(alignof(Slot), CACHE_LINE_SIZE)} {
+            Slot* slots = m_slots.get<Slot>();
+            for (std::size_t index = 0; index < m_capacity; index++) {
+                new(&slots[index]) Slot{};
+                slots[index].m_sequence.store(index, std::memory_order_relaxed);
+            };
+        };
+
+        /// Destroys the elements still in the queue.
+        ~MpmcQueue() {
+            Slot* slots = m_slots.get<Slot>();
+            std::size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_acquire);
+            for (std::size_t position = m_dequeuePosition.load(std::memory_order_acquire);
+                 position != enqueuePosition; position++) {
+                slots[position & (m_capacity - 1)].getValue()->~T();
+            };
+            for (std::size_t index = 0; index < m_capacity; index++) {
+                slots[index].~Slot();
+            };
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        MpmcQueue(MpmcQueue&&) = delete;
+        MpmcQueue& operator=(MpmcQueue&&) = delete;
+
+        /// Constructs an element at the back of the queue.
+        /// \param t_args The arguments of the element's constructor.
+        /// \return False if the queue is full.
+        template<typename... TArgs>
+        bool tryEmplace(TArgs&&... t_args) {
+            Slot* slot = nullptr;
+            std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                slot = &m_slots.get<Slot>()[position & (m_capacity - 1)];
+                std::size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+                if (difference == 0) {
+                    if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    };
+                } else if (difference < 0) {
+                    // The slot still holds the element of the previous lap, so the queue is full.
+                    return false;
+                } else {
+                    position = m_enqueuePosition.load(std::memory_order_relaxed);
+                };
+            };
+
+            new(slot->m_storage) T(std::forward<TArgs>(t_args)...);
+            slot->m_sequence.store(position + 1, std::memory_order_release);
+            return true;
+        };
+
+        /// Copies an element to the back of the queue.
+        /// \param t_value The element.
+        /// \return False if the queue is full.
+        bool tryPush(const T& t_value) { return tryEmplace(t_value); };
+
+        /// Moves an element to the back of the queue.
+        /// \param t_value The element.
+        /// \return False if the queue is full, the element is not moved from.
+        bool tryPush(T&& t_value) { return tryEmplace(std::move(t_value)); };
+
+        /// Moves the element at the front of the queue out.
+        /// \param t_value Set to the element.
+        /// \return False if the queue is empty.
+        bool tryPop(T& t_value) {
+            Slot* slot = nullptr;
+            std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                slot = &m_slots.get<Slot>()[position & (m_capacity - 1)];
+                std::size_t sequence = slot->m_sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (difference == 0) {
+                    if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    };
+                } else if (difference < 0) {
+                    // The slot has not been filled for this lap yet, so the queue is empty.
+                    return false;
+                } else {
+                    position = m_dequeuePosition.load(std::memory_order_relaxed);
+                };
+            };
+
+            T* value = slot->getValue();
+            t_value = std::move(*value);
+            value->~T();
+            slot->m_sequence.store(position + m_capacity, std::memory_order_release);
+            return true;
+        };
+
+        /// Gets the number of elements in the queue, only exact when no other thread is using the queue.
+        [[nodiscard]] std::size_t sizeApprox() const {
+            std::size_t enqueuePosition = m_enqueuePosition.load(std::memory_order_acquire);
+            std::size_t dequeuePosition = m_dequeuePosition.load(std::memory_order_acquire);
+            return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+        };
+
+        /// Gets the most elements the queue holds.
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; };
+
+    private:
+
+        /// A slot of the queue, an element and whose turn it is to use it.
+        struct Slot {
+            /// The position of the producer that may fill the slot, or one past the position of the consumer that may
+            /// empty it.
+            std::atomic<std::size_t> m_sequence{0};
+
+            /// The memory of the element.
+            alignas(T) unsigned char m_storage[sizeof(T)];
+
+            /// Gets the element in the slot.
+            T* getValue() { return std::launder(reinterpret_cast<T*>(m_storage)); };
+        };
+
+        /// Rounds a capacity up to the power of two that lets slots be found with a mask.
+        static std::size_t roundUpToPowerOfTwo(std::size_t t_capacity) {
+            if (t_capacity == 0) {
+                throw std::runtime_error("A queue must be able to hold at least one element!");
+            };
+            // With a single slot a producer a lap ahead would see the slot's sequence as its turn, so there are two.
+            std::size_t capacity = 2;
+            while (capacity < t_capacity) {
+                capacity <<= 1;
+            };
+            return capacity;
+        };
+
+        /// The most elements the queue holds, a power of two.
+        std::size_t m_capacity;
+
+        /// The slots of the elements.
+        AllocatorBuffer m_slots;
+
+        /// The position of the next element pushed, its slot is this modulo the capacity.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_enqueuePosition{0};
+
+        /// The position of the next element popped, its slot is this modulo the capacity.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_dequeuePosition{0};
+
+    protected:
+
+    };
+
+} // namespace ae
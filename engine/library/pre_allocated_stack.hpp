@@ -12,15 +12,22 @@
 
 namespace ae {
 
+    /// \tparam T The type of the values stored in the stack.
+    /// \tparam stackSize The number of values in the stack when a size is not given to the constructor.
     template <typename T, std::size_t stackSize>
     class PreAllocatedStack{
     public:
 
-        PreAllocatedStack(){
-            m_stackValues = new T[stackSize];
+        PreAllocatedStack() : PreAllocatedStack(stackSize) {};
 
-            for (m_topOfStack = 0; m_topOfStack < stackSize;m_topOfStack++) {
-                m_stackValues[m_topOfStack] = stackSize - 1 - m_topOfStack;
+        /// Creates a stack holding the values from 0 to t_stackSize - 1, with 0 at the top of the stack. Used when the
+        /// size of the stack is only known at runtime.
+        /// \param t_stackSize The number of values in the stack.
+        explicit PreAllocatedStack(std::size_t t_stackSize){
+            m_stackValues = new T[t_stackSize];
+
+            for (m_topOfStack = 0; m_topOfStack < t_stackSize;m_topOfStack++) {
+                m_stackValues[m_topOfStack] = t_stackSize - 1 - m_topOfStack;
             };
             m_topOfStack=m_topOfStack-1;
         };
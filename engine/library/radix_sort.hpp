@@ -1,259 +1,307 @@
 /// \file radix_sort.hpp
-/// The radix_sort function is defined.
+/// The radixSort and parallelRadixSort functions are defined.
 #pragma once
 
 // dependencies
+#include "ae_allocator_base.hpp"
+#include "allocator_buffer.hpp"
+#include "thread_pool.hpp"
 
 // libraries
 
 //std
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
-#include <stdexcept>
-#include <climits>
-#include <random>
-#include <cinttypes>
+#include <cstring>
+#include <type_traits>
 
 namespace ae {
 
-    void lsb_radix_sort(const std::uint32_t *t_arrayRef, std::uint32_t *t_sorted, const std::size_t t_arraySize){
-
-        // This radix sort is assuming the radix is 11 bits of the input value.
-        std::uint32_t radix_bits = 11;
-        std::uint32_t radix_hist = 1<<radix_bits;
-
-        // Create the histograms for each of the 11 bit sections of the input number.
-        std::uint32_t h0[radix_hist * 3];
-
-        std::uint32_t *h1 = h0 + radix_hist;
-        std::uint32_t *h2 = h1 + radix_hist;
-
-        // Ensure the array is cleared.
-        for (int i = 0; i < (radix_hist * 3); i++) {
-            h0[i] = 0;
-        }
-
-        // Counting sort into radix histogram bins
-        for(int i=0;i<t_arraySize;i++){
-            h0[t_arrayRef[i] & 0x7FF]++;
-            h1[(t_arrayRef[i] >> 11) & 0x7FF]++;
-            h2[(t_arrayRef[i] >> 22)]++;
-        }
-
-        // Calculate the cumulative sum across the bins
-        std::uint32_t h0_sum = 0, h1_sum = 0, h2_sum = 0;
-        std::uint32_t temp_sum = 0;
-        for (int i = 0; i < radix_hist; i++) {
-            temp_sum = h0[i] + h0_sum;
-            // I don't like -1 being used here, will lead to an overflow and most likely will cause issues.
-            h0[i] = h0_sum - 1;
-            h0_sum = temp_sum;
-
-            temp_sum = h1[i] + h1_sum;
-            h1[i] = h1_sum - 1;
-            h1_sum = temp_sum;
-
-            temp_sum = h2[i] + h2_sum;
-            h2[i] = h2_sum - 1;
-            h2_sum = temp_sum;
-        }
-
-        // Sort the array based the 11-LS bits.
-        for (int i = 0; i < t_arraySize; i++) {
-
-            std::uint32_t element = t_arrayRef[i];
-            std::uint32_t pos = element & 0x7FF;
-
-            t_sorted[++h0[pos]] = element;
-        }
-
-        std::uint32_t temp_sort[t_arraySize];
-        // Sort the array based the next 11-LS bits.
-        for (int i = 0; i < t_arraySize; i++) {
-            std::uint32_t element = t_sorted[i];
-            std::uint32_t pos = (element >> 11) & 0x7FF;
-
-            temp_sort[++h1[pos]] = element;
-        }
-
-        // Sort the array based the 11-MS bits.
-        for (int i = 0; i < t_arraySize; i++) {
-            std::uint32_t element = temp_sort[i];
-            std::uint32_t pos = element >> 22;
-
-            t_sorted[++h2[pos]] = element;
-        }
-
-    }
-
-    void parallel_lsb_radix_sort(const std::uint32_t *t_arrayRef, std::uint32_t *t_sorted, const std::size_t t_arraySize) {
-
-        // const std::uint32_t t_numCores = 16;
-        // const std::uint32_t radix_bits = 4;
-        // const std::uint32_t radix_num_vals = 1 << radix_bits;
-        // const std::uint32_t num_hists = 8; // Number of radix bits in max value of array members
-
-        std::uint32_t t_numCores = 4;
-        std::uint32_t radix_bits = 3;
-        std::uint32_t radix_num_vals = 1 << radix_bits;
-        std::uint32_t num_hists = 3; // Number of radix bits in max value of array members
-        std::uint32_t hist_mask = (radix_num_vals-1);
-
-        // ensure array can be split into sections
-        if (t_arraySize % t_numCores) {
-            throw std::runtime_error(
-                    "parallel_lsb_radix_sort: Array size is not dividable my number of processors in parallel!");
-        }
-        const std::uint32_t range_size = t_arraySize / t_numCores;
-
-        std::uint32_t hist[t_numCores][num_hists][radix_num_vals];
-        std::uint32_t offset[t_numCores][num_hists][radix_num_vals];
-        for(std::uint32_t cores=0;cores<t_numCores;cores++)
-        {
-            for(std::uint32_t hist_num=0;hist_num<num_hists;hist_num++)
-            {
-                for(std::uint32_t k=0;k<radix_num_vals;k++)
-                {
-                    hist[cores][hist_num][k] = 0;
-                    offset[cores][hist_num][k] = 0;
-                }
-            }
-        }
-
-        // Create an array to hold the values from the previous round of sorting.
-        std::uint32_t intermediate_sorted[t_arraySize];
-        for(std::uint32_t cores=0;cores<t_arraySize;cores++)
-        {
-            intermediate_sorted[cores] = t_arrayRef[cores];
-        }
-
-        // Repeat the algorithm for each of the histograms starting from LSB to MSB.
-        for(std::uint32_t hist_num = 0; hist_num < num_hists; hist_num++){
-
-            std::uint32_t hist_shift = radix_bits * hist_num;
-
-            // Emulate number of cores working on different portions of the dataset
-            for (std::uint32_t cores = 0; cores < t_numCores; cores++) {
-                std::size_t start_idx = range_size * cores;
-                std::size_t end_idx = range_size * (cores + 1);
-
-                // Create histograms for different "LSB" Histograms, this is also done by different cores in parallel
-                for (std::size_t k = start_idx; k < end_idx; k++) {
-                    // Add one to the portion of the histogram corresponding to the array value masked by the radix.
-                    hist[cores][hist_num][(t_arrayRef[k] >> hist_shift) & hist_mask]++;
-                }
-            }
-
-            // Calculate the offset for each of the histogram values.
-            for (std::uint32_t cores = 0; cores < t_numCores; cores++) {
-                for (std::size_t k = 0; k < radix_num_vals; k++) {
-                    offset[cores][hist_num][k] = 0;
-
-                    // Loop through values of all cores and sum all the counts for values less than the current value.
-                    for(std::uint32_t lt_k = 0; lt_k<k; lt_k++){
-                        for(int all_cores = 0; all_cores<t_numCores; all_cores++){
-                            offset[cores][hist_num][k] += hist[all_cores][hist_num][lt_k];
-                        }
-                    }
-
-                    // Loop through all values from cores that took ranges less than the range of the current core
-                    if(cores>0)
-                    {
-                        for(std::uint32_t lt_i = 0; lt_i<cores; lt_i++){
-                            offset[cores][hist_num][k] += hist[lt_i][hist_num][k];
-                        }
-                    }
-                }
-            }
-        }
-
-        // Sort based upon the created histograms
-        for(std::uint32_t hist_num = 0; hist_num < num_hists; hist_num++)
-        {
-            std::uint32_t hist_shift = (radix_bits * hist_num);
-
-            // Emulate number of cores working on different portions of the dataset
-            for (std::uint32_t cores = 0; cores < t_numCores; cores++) {
-                std::size_t start_idx = range_size * cores;
-                std::size_t end_idx = range_size * (cores + 1);
-
-                // Create histograms for different "LSB" Histograms, this is also done by different cores in parallel
-                for (std::uint32_t k = start_idx; k < end_idx; k++) {
-                    // The masked value gets the index into the offset array that represents where the value needs to be
-                    // placed in the final sort.
-                    std::size_t offset_index = (intermediate_sorted[k] >> hist_shift) & hist_mask;
-
-                    // Put the value into its final place in the sort for the current portion of the sort.
-                    t_sorted[offset[cores][hist_num][offset_index]] = intermediate_sorted[k];
-
-                    // Increment the offset for the current value so if there are multiples of a specific value it gets
-                    // placed after the current one in the range.
-                    offset[cores][hist_num][offset_index]++;
-                }
-            }
-
-            //if(hist_num != num_hists-1)
-            //{
-                for(int i=0;i<t_arraySize;i++)
-                {
-                    intermediate_sorted[i] = t_sorted[i];
-                }
-            //}
-
-        }
-        printf("Done Parallel Sorting.\n");
-    }
-
-    void test_radix_sort(){
-        // std::size_t const num_random_values = 16;
-        // std::random_device random_device;
-        // std::mt19937 random_engine(random_device());
-        // //std::uniform_int_distribution<uint32_t> uint32_distribution(0, UINT32_MAX);
-        // std::uniform_int_distribution<uint32_t> uint32_distribution(0, 255);
-        //
-        // std::uint32_t numbers[num_random_values] = {0};
-        //
-        // printf("Random Array Values:\n");
-        // for (size_t i = 0; i < num_random_values; ++i)
-        // {
-        //     numbers[i] = uint32_distribution(random_engine);
-        //     printf("%" PRIu32 "\n", numbers[i]);
-        // }
-
-        std::size_t const num_random_values = 8;
-        std::uint32_t numbers[num_random_values] = {253,75,105,178,45,128,88,200};
-
-        for (size_t i = 0; i < num_random_values; ++i)
-        {
-            printf("%" PRIu32 "\n", numbers[i]);
-        }
-        printf("\n\n");
-
-        std::uint32_t sorted[num_random_values];
-        lsb_radix_sort(numbers,sorted,num_random_values);
-
-        printf("Serial Sorted Array:\n");
-        for(size_t i = 0; i < num_random_values; ++i){
-            printf("%" PRIu32 "\n", sorted[i]);
-        }
-        printf("\n\n");
-
-
-        printf("Numbers:\n");
-        for (size_t i = 0; i < num_random_values; ++i)
-        {
-            printf("%" PRIu32 "\n", numbers[i]);
-        }
-        printf("\n\n");
-
-
-        std::uint32_t parallel_sorted[num_random_values];
-        parallel_lsb_radix_sort(numbers,parallel_sorted,num_random_values);
-
-        printf("Parallel Sorted Array:\n");
-        for(size_t i = 0; i < num_random_values; ++i){
-            printf("%" PRIu32 "\n", parallel_sorted[i]);
-        }
-        printf("\n\n");
-    }
-
-} // namespace ae
\ No newline at end of file
+    /// Maps a key to unsigned bits that sort in the same order as the key, which is what the radix sort sorts by.
+    /// Specialise it to sort other types of key, with a Bits type and a static Bits toBits(TKey) function.
+    /// \tparam TKey The type of key.
+    template<typename TKey>
+    struct AeRadixKeyTraits;
+
+    template<>
+    struct AeRadixKeyTraits<std::uint32_t> {
+        using Bits = std::uint32_t;
+        static Bits toBits(std::uint32_t t_key) { return t_key; };
+    };
+
+    template<>
+    struct AeRadixKeyTraits<std::uint64_t> {
+        using Bits = std::uint64_t;
+        static Bits toBits(std::uint64_t t_key) { return t_key; };
+    };
+
+    /// Floats are flipped so that they sort as unsigned integers. The sign bit is set on positive floats so they sort
+    /// after the negative floats, and every bit of a negative float is inverted so that larger magnitudes sort first.
+    /// This puts -0.0 before 0.0, negative NaNs before everything and positive NaNs after everything.
+    template<>
+    struct AeRadixKeyTraits<float> {
+        using Bits = std::uint32_t;
+        static Bits toBits(float t_key) {
+            Bits bits;
+            std::memcpy(&bits, &t_key, sizeof(bits));
+            Bits mask = (bits >> 31) ? UINT32_MAX : UINT32_C(0x80000000);
+            return bits ^ mask;
+        };
+    };
+
+    namespace radix_sort_detail {
+
+        /// The number of bits of the key sorted by each pass.
+        constexpr std::size_t RADIX_BITS = 8;
+
+        /// The number of buckets of each pass.
+        constexpr std::size_t RADIX_SIZE = std::size_t{1} << RADIX_BITS;
+
+        /// Arrays up to this size are insertion sorted instead.
+        constexpr std::size_t INSERTION_SORT_THRESHOLD = 64;
+
+        /// The fewest elements each thread of a parallel sort is given, smaller arrays are given fewer threads.
+        constexpr std::size_t MIN_ELEMENTS_PER_THREAD = 16384;
+
+        /// The type of payload used when sorting keys alone.
+        struct NoPayload {};
+
+        /// Sorts a small array by moving each element back past the larger elements before it.
+        template<typename TKey, typename TValue, bool HAS_PAYLOAD>
+        void insertionSort(TKey* t_keys, TValue* t_values, std::size_t t_count) {
+            using Traits = AeRadixKeyTraits<TKey>;
+            for (std::size_t i = 1; i < t_count; i++) {
+                TKey key = t_keys[i];
+                auto bits = Traits::toBits(key);
+                std::size_t j = i;
+                if constexpr (HAS_PAYLOAD) {
+                    TValue value = t_values[i];
+                    for (; j > 0 && Traits::toBits(t_keys[j - 1]) > bits; j--) {
+                        t_keys[j] = t_keys[j - 1];
+                        t_values[j] = t_values[j - 1];
+                    };
+                    t_values[j] = value;
+                } else {
+                    for (; j > 0 && Traits::toBits(t_keys[j - 1]) > bits; j--) {
+                        t_keys[j] = t_keys[j - 1];
+                    };
+                };
+                t_keys[j] = key;
+            };
+        };
+
+        /// The least significant digit radix sort shared by the serial and parallel sorts. The array is split into a
+        /// range for each thread. Every thread counts the digits of its range, the counts are summed across the threads
+        /// into where each thread writes each digit, and every thread scatters its range into the other buffer. The
+        /// counts of every digit are taken in the first pass so that passes where every key has the same digit are
+        /// skipped. The threads are those of anything with getNumThreads() and parallelFor(numTasks, task) like
+        /// AeThreadPool, such as the engine's job system.
+        template<typename TKey, typename TValue, bool HAS_PAYLOAD, typename TThreadPool>
+        void radixSort(TKey* t_keys,
+                       TValue* t_values,
+                       std::size_t t_count,
+                       ae_memory::AeAllocatorBase* t_allocator,
+                       TThreadPool* t_threadPool) {
+            using Traits = AeRadixKeyTraits<TKey>;
+            using Bits = typename Traits::Bits;
+            static_assert(std::is_unsigned_v<Bits>, "The bits of a radix sort key must be an unsigned integer.");
+            static_assert(std::is_trivially_copyable_v<TKey>, "Radix sort keys must be trivially copyable.");
+            static_assert(std::is_trivially_copyable_v<TValue>, "Radix sort payloads must be trivially copyable.");
+            constexpr std::size_t numDigits = sizeof(Bits) * 8 / RADIX_BITS;
+
+            if (t_count <= INSERTION_SORT_THRESHOLD) {
+                insertionSort<TKey, TValue, HAS_PAYLOAD>(t_keys, t_values, t_count);
+                return;
+            };
+
+            std::size_t numRanges = 1;
+            if (t_threadPool) {
+                numRanges = std::clamp<std::size_t>(t_count / MIN_ELEMENTS_PER_THREAD, 1,
+                                                    t_threadPool->getNumThreads());
+            };
+            auto forEachRange = [&](auto&& t_task) {
+                if (numRanges == 1) {
+                    t_task(0);
+                } else {
+                    t_threadPool->parallelFor(numRanges, t_task);
+                };
+            };
+            auto rangeBegin = [&](std::size_t t_range) { return t_count * t_range / numRanges; };
+
+            // One buffer holds the second copy of the keys and payloads, then the counts of every digit of every range,
+            // then where each range writes each digit.
+            constexpr std::size_t alignment = std::max({alignof(TKey), alignof(TValue), alignof(std::size_t)});
+            auto alignUp = [](std::size_t t_size) { return (t_size + alignment - 1) / alignment * alignment; };
+            std::size_t keysSize = alignUp(t_count * sizeof(TKey));
+            std::size_t valuesSize = HAS_PAYLOAD ? alignUp(t_count * sizeof(TValue)) : 0;
+            std::size_t countsSize = numRanges * numDigits * RADIX_SIZE * sizeof(std::size_t);
+            std::size_t offsetsSize = numRanges * RADIX_SIZE * sizeof(std::size_t);
+            AllocatorBuffer scratch{t_allocator, keysSize + valuesSize + countsSize + offsetsSize, alignment};
+            auto* scratchBytes = scratch.get<unsigned char>();
+            auto* otherKeys = reinterpret_cast<TKey*>(scratchBytes);
+            auto* otherValues = reinterpret_cast<TValue*>(scratchBytes + keysSize);
+            auto* counts = reinterpret_cast<std::size_t*>(scratchBytes + keysSize + valuesSize);
+            auto* offsets = reinterpret_cast<std::size_t*>(scratchBytes + keysSize + valuesSize + countsSize);
+
+            // Count every digit of each range in one read of the keys.
+            forEachRange([&](std::size_t t_range) {
+                std::size_t* rangeCounts = counts + t_range * numDigits * RADIX_SIZE;
+                std::fill(rangeCounts, rangeCounts + numDigits * RADIX_SIZE, 0);
+                for (std::size_t i = rangeBegin(t_range), end = rangeBegin(t_range + 1); i < end; i++) {
+                    Bits bits = Traits::toBits(t_keys[i]);
+                    for (std::size_t digit = 0; digit < numDigits; digit++) {
+                        rangeCounts[digit * RADIX_SIZE + ((bits >> (digit * RADIX_BITS)) & (RADIX_SIZE - 1))]++;
+                    };
+                };
+            });
+
+            TKey* sourceKeys = t_keys;
+            TValue* sourceValues = t_values;
+            TKey* destinationKeys = otherKeys;
+            TValue* destinationValues = otherValues;
+            bool areCountsCurrent = true;
+            for (std::size_t digit = 0; digit < numDigits; digit++) {
+                std::size_t shift = digit * RADIX_BITS;
+
+                // The total counts of a digit do not depend on the order of the keys, so the first pass's counts tell
+                // whether every key has the same value of this digit.
+                bool isTrivial = false;
+                for (std::size_t bucket = 0; bucket < RADIX_SIZE && !isTrivial; bucket++) {
+                    std::size_t total = 0;
+                    for (std::size_t range = 0; range < numRanges; range++) {
+                        total += counts[(range * numDigits + digit) * RADIX_SIZE + bucket];
+                    };
+                    isTrivial = total == t_count;
+                };
+                if (isTrivial) {
+                    continue;
+                };
+
+                // The counts of each range are only those of the first pass until the keys have been moved.
+                if (!areCountsCurrent) {
+                    forEachRange([&](std::size_t t_range) {
+                        std::size_t* rangeCounts = counts + (t_range * numDigits + digit) * RADIX_SIZE;
+                        std::fill(rangeCounts, rangeCounts + RADIX_SIZE, 0);
+                        for (std::size_t i = rangeBegin(t_range), end = rangeBegin(t_range + 1); i < end; i++) {
+                            rangeCounts[(Traits::toBits(sourceKeys[i]) >> shift) & (RADIX_SIZE - 1)]++;
+                        };
+                    });
+                };
+                areCountsCurrent = false;
+
+                // Each bucket starts after every smaller bucket, and each range writes a bucket after the ranges before
+                // it so that the sort is stable.
+                std::size_t offset = 0;
+                for (std::size_t bucket = 0; bucket < RADIX_SIZE; bucket++) {
+                    for (std::size_t range = 0; range < numRanges; range++) {
+                        offsets[range * RADIX_SIZE + bucket] = offset;
+                        offset += counts[(range * numDigits + digit) * RADIX_SIZE + bucket];
+                    };
+                };
+
+                forEachRange([&](std::size_t t_range) {
+                    std::size_t* rangeOffsets = offsets + t_range * RADIX_SIZE;
+                    for (std::size_t i = rangeBegin(t_range), end = rangeBegin(t_range + 1); i < end; i++) {
+                        std::size_t bucket = (Traits::toBits(sourceKeys[i]) >> shift) & (RADIX_SIZE - 1);
+                        std::size_t position = rangeOffsets[bucket]++;
+                        destinationKeys[position] = sourceKeys[i];
+                        if constexpr (HAS_PAYLOAD) {
+                            destinationValues[position] = sourceValues[i];
+                        };
+                    };
+                });
+
+                std::swap(sourceKeys, destinationKeys);
+                std::swap(sourceValues, destinationValues);
+            };
+
+            // An odd number of passes leaves the sorted keys in the scratch buffer.
+            if (sourceKeys != t_keys) {
+                forEachRange([&](std::size_t t_range) {
+                    std::size_t begin = rangeBegin(t_range);
+                    std::size_t count = rangeBegin(t_range + 1) - begin;
+                    std::memcpy(t_keys + begin, sourceKeys + begin, count * sizeof(TKey));
+                    if constexpr (HAS_PAYLOAD) {
+                        std::memcpy(t_values + begin, sourceValues + begin, count * sizeof(TValue));
+                    };
+                });
+            };
+        };
+
+    } // namespace radix_sort_detail
+
+    /// Sorts an array of keys in ascending order with a least significant digit radix sort, one byte of the key at a
+    /// time. The sort is stable and takes a fixed number of passes over the keys, which makes it faster than comparison
+    /// sorts on large arrays.
+    /// \tparam TKey The type of key, one with AeRadixKeyTraits: std::uint32_t, std::uint64_t or float by default.
+    /// \param t_keys The keys, sorted in place.
+    /// \param t_count The number of keys.
+    /// \param t_allocator The allocator the scratch memory, the size of the keys, is borrowed from. The heap is used
+    /// when nullptr.
+    template<typename TKey>
+    void radixSort(TKey* t_keys, std::size_t t_count, ae_memory::AeAllocatorBase* t_allocator = nullptr) {
+        radix_sort_detail::NoPayload* noPayload = nullptr;
+        radix_sort_detail::radixSort<TKey, radix_sort_detail::NoPayload, false>(t_keys, noPayload, t_count,
+                                                                                t_allocator,
+                                                                                static_cast<AeThreadPool*>(nullptr));
+    };
+
+    /// Sorts an array of keys in ascending order and moves a payload along with each key, such as the index of the
+    /// object the key was made from. The sort is stable.
+    /// \tparam TKey The type of key, one with AeRadixKeyTraits: std::uint32_t, std::uint64_t or float by default.
+    /// \tparam TValue The type of payload, which must be trivially copyable.
+    /// \param t_keys The keys, sorted in place.
+    /// \param t_values The payload of each key, reordered in place with the keys.
+    /// \param t_count The number of keys.
+    /// \param t_allocator The allocator the scratch memory, the size of the keys and payloads, is borrowed from. The
+    /// heap is used when nullptr.
+    template<typename TKey, typename TValue>
+    void radixSort(TKey* t_keys,
+                   TValue* t_values,
+                   std::size_t t_count,
+                   ae_memory::AeAllocatorBase* t_allocator = nullptr) {
+        radix_sort_detail::radixSort<TKey, TValue, true>(t_keys, t_values, t_count, t_allocator,
+                                                         static_cast<AeThreadPool*>(nullptr));
+    };
+
+    /// Sorts an array of keys in ascending order, splitting the counting and scattering of each pass across the
+    /// threads of a pool. Small arrays are given fewer threads, down to sorting on the calling thread alone.
+    /// \tparam TKey The type of key, one with AeRadixKeyTraits: std::uint32_t, std::uint64_t or float by default.
+    /// \tparam TThreadPool The type of thread pool, AeThreadPool or anything with the same getNumThreads() and
+    /// parallelFor(numTasks, task), such as the engine's job system.
+    /// \param t_threadPool The threads to sort with.
+    /// \param t_keys The keys, sorted in place.
+    /// \param t_count The number of keys.
+    /// \param t_allocator The allocator the scratch memory is borrowed from. The heap is used when nullptr.
+    template<typename TKey, typename TThreadPool>
+    void parallelRadixSort(TThreadPool& t_threadPool,
+                           TKey* t_keys,
+                           std::size_t t_count,
+                           ae_memory::AeAllocatorBase* t_allocator = nullptr) {
+        radix_sort_detail::NoPayload* noPayload = nullptr;
+        radix_sort_detail::radixSort<TKey, radix_sort_detail::NoPayload, false>(t_keys, noPayload, t_count,
+                                                                                t_allocator, &t_threadPool);
+    };
+
+    /// Sorts an array of keys in ascending order and moves a payload along with each key, splitting the counting and
+    /// scattering of each pass across the threads of a pool. The sort is stable.
+    /// \tparam TKey The type of key, one with AeRadixKeyTraits: std::uint32_t, std::uint64_t or float by default.
+    /// \tparam TValue The type of payload, which must be trivially copyable.
+    /// \tparam TThreadPool The type of thread pool, AeThreadPool or anything with the same getNumThreads() and
+    /// parallelFor(numTasks, task), such as the engine's job system.
+    /// \param t_threadPool The threads to sort with.
+    /// \param t_keys The keys, sorted in place.
+    /// \param t_values The payload of each key, reordered in place with the keys.
+    /// \param t_count The number of keys.
+    /// \param t_allocator The allocator the scratch memory is borrowed from. The heap is used when nullptr.
+    template<typename TKey, typename TValue, typename TThreadPool>
+    void parallelRadixSort(TThreadPool& t_threadPool,
+                           TKey* t_keys,
+                           TValue* t_values,
+                           std::size_t t_count,
+                           ae_memory::AeAllocatorBase* t_allocator = nullptr) {
+        radix_sort_detail::radixSort<TKey, TValue, true>(t_keys, t_values, t_count, t_allocator, &t_threadPool);
+    };
+
+} // namespace ae
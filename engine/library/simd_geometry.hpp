@@ -0,0 +1,497 @@
+/// \file simd_geometry.hpp
+/// Batch bounding volume functions for the CPU are defined, transforming model OBBs to world AABBs the way
+/// collision.comp does, culling AABBs and spheres against a frustum, casting a ray against AABBs and finding the AABBs
+/// a sphere overlaps.
+#pragma once
+
+// dependencies
+#include "simd_support.hpp"
+
+// libraries
+
+//std
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace ae {
+
+    /// Returned by raycastAabbs when the ray hits no box.
+    inline constexpr std::size_t NO_HIT = static_cast<std::size_t>(-1);
+
+    /// AABBs stored as a structure of arrays, each coordinate of the boxes in its own array, so the batch functions
+    /// load the same coordinate of several boxes at once.
+    struct AabbSoa {
+        /// The minimum x, y and z of each box.
+        std::array<std::vector<float>, 3> m_min;
+
+        /// The maximum x, y and z of each box.
+        std::array<std::vector<float>, 3> m_max;
+
+        /// Resizes every array.
+        /// \param t_size The number of boxes.
+        void resize(std::size_t t_size){
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                m_min[axis].resize(t_size);
+                m_max[axis].resize(t_size);
+            };
+        };
+
+        /// Gets the number of boxes.
+        [[nodiscard]] std::size_t size() const { return m_min[0].size(); };
+
+        /// Sets a box.
+        /// \param t_index The index of the box.
+        /// \param t_positions The minimum x, y and z then the maximum x, y and z, the layout of VkAabbPositionsKHR.
+        void set(std::size_t t_index, const float* t_positions){
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                m_min[axis][t_index] = t_positions[axis];
+                m_max[axis][t_index] = t_positions[axis + 3];
+            };
+        };
+    };
+
+    /// The model matrices of entities stored as a structure of arrays. The upper 3x3 of each matrix is kept column
+    /// major, element column * 3 + row as in glm and GLSL, along with the translation.
+    struct TransformSoa {
+        /// The upper 3x3 of the model matrices.
+        std::array<std::vector<float>, 9> m_model;
+
+        /// The translation of the model matrices.
+        std::array<std::vector<float>, 3> m_translation;
+
+        /// Resizes every array.
+        /// \param t_size The number of entities.
+        void resize(std::size_t t_size){
+            for (std::size_t element = 0; element < 9; element++) {
+                m_model[element].resize(t_size);
+            };
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                m_translation[axis].resize(t_size);
+            };
+        };
+
+        /// Gets the number of entities.
+        [[nodiscard]] std::size_t size() const { return m_translation[0].size(); };
+
+        /// Sets the model matrix of an entity.
+        /// \param t_index The index of the entity.
+        /// \param t_modelMatrix The column major 4x4 model matrix, the layout of Entity3DSSBOData::modelMatrix.
+        void set(std::size_t t_index, const float* t_modelMatrix){
+            for (std::size_t column = 0; column < 3; column++) {
+                for (std::size_t row = 0; row < 3; row++) {
+                    m_model[column * 3 + row][t_index] = t_modelMatrix[column * 4 + row];
+                };
+                m_translation[column][t_index] = t_modelMatrix[12 + column];
+            };
+        };
+    };
+
+    /// Spheres stored as a structure of arrays.
+    struct SphereSoa {
+        /// The x, y and z of the centre of each sphere.
+        std::array<std::vector<float>, 3> m_center;
+
+        /// The radius of each sphere.
+        std::vector<float> m_radius;
+
+        /// Resizes every array.
+        /// \param t_size The number of spheres.
+        void resize(std::size_t t_size){
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                m_center[axis].resize(t_size);
+            };
+            m_radius.resize(t_size);
+        };
+
+        /// Gets the number of spheres.
+        [[nodiscard]] std::size_t size() const { return m_radius.size(); };
+    };
+
+    /// A plane, the points in front of it have dot(m_normal, point) + m_distance >= 0.
+    struct Plane {
+        std::array<float, 3> m_normal{0.0f, 0.0f, 0.0f};
+        float m_distance = 0.0f;
+    };
+
+    /// The six planes bounding a view, facing inwards.
+    struct Frustum {
+        std::array<Plane, 6> m_planes{};
+
+        /// Extracts the planes of the view of a camera from its projection matrix times its view matrix, with the
+        /// planes normalised so distances to them are in world units.
+        /// \param t_viewProjection The column major 4x4 matrix, projecting depth to [0, 1] as Vulkan does.
+        /// \return The frustum of the view, in the left, right, bottom, top, near and far order.
+        static Frustum fromViewProjection(const float* t_viewProjection){
+            auto getRow = [t_viewProjection](std::size_t t_row) {
+                return std::array<float, 4>{t_viewProjection[t_row], t_viewProjection[4 + t_row],
+                                            t_viewProjection[8 + t_row], t_viewProjection[12 + t_row]};
+            };
+            const std::array<float, 4> rowX = getRow(0);
+            const std::array<float, 4> rowY = getRow(1);
+            const std::array<float, 4> rowZ = getRow(2);
+            const std::array<float, 4> rowW = getRow(3);
+
+            // -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space.
+            const std::array<std::array<float, 4>, 6> planeCoefficients{{
+                    {rowW[0] + rowX[0], rowW[1] + rowX[1], rowW[2] + rowX[2], rowW[3] + rowX[3]},
+                    {rowW[0] - rowX[0], rowW[1] - rowX[1], rowW[2] - rowX[2], rowW[3] - rowX[3]},
+                    {rowW[0] + rowY[0], rowW[1] + rowY[1], rowW[2] + rowY[2], rowW[3] + rowY[3]},
+                    {rowW[0] - rowY[0], rowW[1] - rowY[1], rowW[2] - rowY[2], rowW[3] - rowY[3]},
+                    rowZ,
+                    {rowW[0] - rowZ[0], rowW[1] - rowZ[1], rowW[2] - rowZ[2], rowW[3] - rowZ[3]}}};
+
+            Frustum frustum{};
+            for (std::size_t plane = 0; plane < 6; plane++) {
+                const std::array<float, 4>& coefficients = planeCoefficients[plane];
+                float length = std::sqrt(coefficients[0] * coefficients[0] + coefficients[1] * coefficients[1] +
+                                         coefficients[2] * coefficients[2]);
+                frustum.m_planes[plane] = {{coefficients[0] / length, coefficients[1] / length,
+                                            coefficients[2] / length}, coefficients[3] / length};
+            };
+            return frustum;
+        };
+    };
+
+    /// A ray, the points origin + distance * direction for distances from 0.
+    struct Ray {
+        std::array<float, 3> m_origin{0.0f, 0.0f, 0.0f};
+        std::array<float, 3> m_direction{0.0f, 0.0f, 1.0f};
+    };
+
+    namespace simd_geometry_detail {
+
+        /// One float at a time, used when no SIMD instructions are available and for the ends of the batches. Every
+        /// lane type does the same IEEE operations, so each path gives the same bits.
+        struct ScalarLanes {
+            using Value = float;
+            using Mask = bool;
+            static constexpr std::size_t WIDTH = 1;
+
+            static Value load(const float* t_values){ return *t_values; };
+            static Value gather(const float* t_values, const uint32_t* t_indices){ return t_values[*t_indices]; };
+            static void store(float* t_values, Value t_value){ *t_values = t_value; };
+            static Value broadcast(float t_value){ return t_value; };
+            static Value add(Value t_a, Value t_b){ return t_a + t_b; };
+            static Value sub(Value t_a, Value t_b){ return t_a - t_b; };
+            static Value mul(Value t_a, Value t_b){ return t_a * t_b; };
+            /// t_a < t_b ? t_a : t_b, the GLSL ternary and what minps does with NaNs.
+            static Value minimum(Value t_a, Value t_b){ return t_a < t_b ? t_a : t_b; };
+            /// t_a > t_b ? t_a : t_b, the GLSL ternary and what maxps does with NaNs.
+            static Value maximum(Value t_a, Value t_b){ return t_a > t_b ? t_a : t_b; };
+            static Mask lessEqual(Value t_a, Value t_b){ return t_a <= t_b; };
+            static Mask greaterEqual(Value t_a, Value t_b){ return t_a >= t_b; };
+            static Mask allTrue(){ return true; };
+            static Mask maskAnd(Mask t_a, Mask t_b){ return t_a && t_b; };
+            static Value select(Mask t_mask, Value t_a, Value t_b){ return t_mask ? t_a : t_b; };
+
+            /// Stores a mask as one byte per lane, 1 when the lane is set.
+            /// \return The number of set lanes.
+            static std::size_t storeMask(uint8_t* t_results, Mask t_mask){
+                *t_results = t_mask ? 1 : 0;
+                return *t_results;
+            };
+        };
+
+#if defined(AE_SIMD_SSE2)
+        /// Four floats at a time.
+        struct Sse2Lanes {
+            using Value = __m128;
+            using Mask = __m128;
+            static constexpr std::size_t WIDTH = 4;
+
+            static Value load(const float* t_values){ return _mm_loadu_ps(t_values); };
+            static Value gather(const float* t_values, const uint32_t* t_indices){
+                return _mm_setr_ps(t_values[t_indices[0]], t_values[t_indices[1]],
+                                   t_values[t_indices[2]], t_values[t_indices[3]]);
+            };
+            static void store(float* t_values, Value t_value){ _mm_storeu_ps(t_values, t_value); };
+            static Value broadcast(float t_value){ return _mm_set1_ps(t_value); };
+            static Value add(Value t_a, Value t_b){ return _mm_add_ps(t_a, t_b); };
+            static Value sub(Value t_a, Value t_b){ return _mm_sub_ps(t_a, t_b); };
+            static Value mul(Value t_a, Value t_b){ return _mm_mul_ps(t_a, t_b); };
+            static Value minimum(Value t_a, Value t_b){ return _mm_min_ps(t_a, t_b); };
+            static Value maximum(Value t_a, Value t_b){ return _mm_max_ps(t_a, t_b); };
+            static Mask lessEqual(Value t_a, Value t_b){ return _mm_cmple_ps(t_a, t_b); };
+            static Mask greaterEqual(Value t_a, Value t_b){ return _mm_cmpge_ps(t_a, t_b); };
+            static Mask allTrue(){ return _mm_castsi128_ps(_mm_set1_epi32(-1)); };
+            static Mask maskAnd(Mask t_a, Mask t_b){ return _mm_and_ps(t_a, t_b); };
+            static Value select(Mask t_mask, Value t_a, Value t_b){
+                return _mm_or_ps(_mm_and_ps(t_mask, t_a), _mm_andnot_ps(t_mask, t_b));
+            };
+            static std::size_t storeMask(uint8_t* t_results, Mask t_mask){
+                int bits = _mm_movemask_ps(t_mask);
+                std::size_t numSet = 0;
+                for (std::size_t lane = 0; lane < WIDTH; lane++) {
+                    t_results[lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                    numSet += t_results[lane];
+                };
+                return numSet;
+            };
+        };
+#endif
+
+#if defined(AE_SIMD_AVX2)
+        /// Eight floats at a time, with the OBBs gathered by the AVX2 gather instruction.
+        struct Avx2Lanes {
+            using Value = __m256;
+            using Mask = __m256;
+            static constexpr std::size_t WIDTH = 8;
+
+            static Value load(const float* t_values){ return _mm256_loadu_ps(t_values); };
+            static Value gather(const float* t_values, const uint32_t* t_indices){
+                return _mm256_i32gather_ps(t_values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t_indices)), 4);
+            };
+            static void store(float* t_values, Value t_value){ _mm256_storeu_ps(t_values, t_value); };
+            static Value broadcast(float t_value){ return _mm256_set1_ps(t_value); };
+            static Value add(Value t_a, Value t_b){ return _mm256_add_ps(t_a, t_b); };
+            static Value sub(Value t_a, Value t_b){ return _mm256_sub_ps(t_a, t_b); };
+            static Value mul(Value t_a, Value t_b){ return _mm256_mul_ps(t_a, t_b); };
+            static Value minimum(Value t_a, Value t_b){ return _mm256_min_ps(t_a, t_b); };
+            static Value maximum(Value t_a, Value t_b){ return _mm256_max_ps(t_a, t_b); };
+            static Mask lessEqual(Value t_a, Value t_b){ return _mm256_cmp_ps(t_a, t_b, _CMP_LE_OQ); };
+            static Mask greaterEqual(Value t_a, Value t_b){ return _mm256_cmp_ps(t_a, t_b, _CMP_GE_OQ); };
+            static Mask allTrue(){ return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); };
+            static Mask maskAnd(Mask t_a, Mask t_b){ return _mm256_and_ps(t_a, t_b); };
+            static Value select(Mask t_mask, Value t_a, Value t_b){ return _mm256_blendv_ps(t_b, t_a, t_mask); };
+            static std::size_t storeMask(uint8_t* t_results, Mask t_mask){
+                int bits = _mm256_movemask_ps(t_mask);
+                std::size_t numSet = 0;
+                for (std::size_t lane = 0; lane < WIDTH; lane++) {
+                    t_results[lane] = static_cast<uint8_t>((bits >> lane) & 1);
+                    numSet += t_results[lane];
+                };
+                return numSet;
+            };
+        };
+#endif
+
+        /// Runs a kernel over a batch, as many elements at a time as the widest available lanes hold, then narrower
+        /// lanes for the rest.
+        /// \param t_numElements The number of elements in the batch.
+        /// \param t_kernel Called with a lanes object and the index of the first element of those lanes.
+        template<typename TKernel>
+        void forEachLanes(std::size_t t_numElements, TKernel&& t_kernel){
+            std::size_t index = 0;
+#if defined(AE_SIMD_AVX2)
+            for (; index + Avx2Lanes::WIDTH <= t_numElements; index += Avx2Lanes::WIDTH) {
+                t_kernel(Avx2Lanes{}, index);
+            };
+#endif
+#if defined(AE_SIMD_SSE2)
+            for (; index + Sse2Lanes::WIDTH <= t_numElements; index += Sse2Lanes::WIDTH) {
+                t_kernel(Sse2Lanes{}, index);
+            };
+#endif
+            for (; index < t_numElements; index++) {
+                t_kernel(ScalarLanes{}, index);
+            };
+        };
+    }
+
+    /// Calculates the world AABBs of entities from the OBBs of their models, doing the same calculation in the same
+    /// order as collision.comp. Each world axis of an AABB is the translation plus, for each model axis, the smaller
+    /// (or larger) of the OBB's minimum and maximum along that axis scaled by the model matrix element mapping it onto
+    /// the world axis. The shader's sums are precise, so with correctly rounded multiplies and adds on the GPU the
+    /// results match it bit for bit.
+    /// \param t_transforms The model matrices of the entities.
+    /// \param t_modelObbIndices The index of each entity's model OBB in t_modelObbs, like Entity3DSSBOData::modelObbIndex.
+    /// \param t_modelObbs The OBBs of the models.
+    /// \param t_worldAabbs Is resized to hold the AABB of each entity.
+    inline void transformObbsToAabbs(const TransformSoa& t_transforms,
+                                     const std::vector<uint32_t>& t_modelObbIndices,
+                                     const AabbSoa& t_modelObbs,
+                                     AabbSoa& t_worldAabbs){
+        const std::size_t numEntities = t_transforms.size();
+        if (t_modelObbIndices.size() != numEntities) {
+            throw std::runtime_error("Every entity needs the index of its model's OBB!");
+        };
+        for (uint32_t obbIndex: t_modelObbIndices) {
+            if (obbIndex >= t_modelObbs.size()) {
+                throw std::runtime_error("An entity's model OBB index is past the end of the model OBBs!");
+            };
+        };
+        t_worldAabbs.resize(numEntities);
+
+        simd_geometry_detail::forEachLanes(numEntities, [&](auto t_lanes, std::size_t t_index) {
+            using Lanes = decltype(t_lanes);
+            using Value = typename Lanes::Value;
+            Value obbMin[3];
+            Value obbMax[3];
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                obbMin[axis] = Lanes::gather(t_modelObbs.m_min[axis].data(), &t_modelObbIndices[t_index]);
+                obbMax[axis] = Lanes::gather(t_modelObbs.m_max[axis].data(), &t_modelObbIndices[t_index]);
+            };
+
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                Value aabbMin = Lanes::load(&t_transforms.m_translation[axis][t_index]);
+                Value aabbMax = aabbMin;
+                for (std::size_t obbAxis = 0; obbAxis < 3; obbAxis++) {
+                    Value element = Lanes::load(&t_transforms.m_model[obbAxis * 3 + axis][t_index]);
+                    Value e = Lanes::mul(element, obbMin[obbAxis]);
+                    Value f = Lanes::mul(element, obbMax[obbAxis]);
+                    aabbMin = Lanes::add(aabbMin, Lanes::minimum(e, f));
+                    aabbMax = Lanes::add(aabbMax, Lanes::maximum(f, e));
+                };
+                Lanes::store(&t_worldAabbs.m_min[axis][t_index], aabbMin);
+                Lanes::store(&t_worldAabbs.m_max[axis][t_index], aabbMax);
+            };
+        });
+    };
+
+    /// Finds the AABBs that are at least partly inside a frustum. A box is culled when its corner furthest along a
+    /// plane's normal is behind the plane, so a few boxes near the frustum's edges are kept that are outside it.
+    /// \param t_frustum The frustum.
+    /// \param t_aabbs The boxes.
+    /// \param t_isVisible Is resized to hold 1 for each box that is kept and 0 for each box that is culled.
+    /// \return The number of boxes kept.
+    inline std::size_t cullAabbs(const Frustum& t_frustum, const AabbSoa& t_aabbs, std::vector<uint8_t>& t_isVisible){
+        const std::size_t numAabbs = t_aabbs.size();
+        t_isVisible.resize(numAabbs);
+
+        // The corner furthest along each plane's normal takes the same side of the box for every box.
+        std::array<std::array<const float*, 3>, 6> furthestCorners{};
+        for (std::size_t plane = 0; plane < 6; plane++) {
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                furthestCorners[plane][axis] = t_frustum.m_planes[plane].m_normal[axis] >= 0.0f ?
+                                               t_aabbs.m_max[axis].data() : t_aabbs.m_min[axis].data();
+            };
+        };
+
+        std::size_t numVisible = 0;
+        simd_geometry_detail::forEachLanes(numAabbs, [&](auto t_lanes, std::size_t t_index) {
+            using Lanes = decltype(t_lanes);
+            using Value = typename Lanes::Value;
+            auto isInside = Lanes::allTrue();
+            for (std::size_t plane = 0; plane < 6; plane++) {
+                const Plane& frustumPlane = t_frustum.m_planes[plane];
+                Value distance = Lanes::broadcast(frustumPlane.m_distance);
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    distance = Lanes::add(distance, Lanes::mul(Lanes::broadcast(frustumPlane.m_normal[axis]),
+                                                               Lanes::load(furthestCorners[plane][axis] + t_index)));
+                };
+                isInside = Lanes::maskAnd(isInside, Lanes::greaterEqual(distance, Lanes::broadcast(0.0f)));
+            };
+            numVisible += Lanes::storeMask(&t_isVisible[t_index], isInside);
+        });
+        return numVisible;
+    };
+
+    /// Finds the spheres that are at least partly inside a frustum. Like cullAabbs a few spheres near the frustum's
+    /// corners are kept that are outside it.
+    /// \param t_frustum The frustum, its planes must be normalised.
+    /// \param t_spheres The spheres.
+    /// \param t_isVisible Is resized to hold 1 for each sphere that is kept and 0 for each sphere that is culled.
+    /// \return The number of spheres kept.
+    inline std::size_t cullSpheres(const Frustum& t_frustum, const SphereSoa& t_spheres, std::vector<uint8_t>& t_isVisible){
+        const std::size_t numSpheres = t_spheres.size();
+        t_isVisible.resize(numSpheres);
+
+        std::size_t numVisible = 0;
+        simd_geometry_detail::forEachLanes(numSpheres, [&](auto t_lanes, std::size_t t_index) {
+            using Lanes = decltype(t_lanes);
+            using Value = typename Lanes::Value;
+            Value center[3];
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                center[axis] = Lanes::load(&t_spheres.m_center[axis][t_index]);
+            };
+            Value radius = Lanes::load(&t_spheres.m_radius[t_index]);
+
+            auto isInside = Lanes::allTrue();
+            for (const Plane& frustumPlane: t_frustum.m_planes) {
+                Value distance = Lanes::broadcast(frustumPlane.m_distance);
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    distance = Lanes::add(distance, Lanes::mul(Lanes::broadcast(frustumPlane.m_normal[axis]), center[axis]));
+                };
+                isInside = Lanes::maskAnd(isInside, Lanes::greaterEqual(Lanes::add(distance, radius),
+                                                                        Lanes::broadcast(0.0f)));
+            };
+            numVisible += Lanes::storeMask(&t_isVisible[t_index], isInside);
+        });
+        return numVisible;
+    };
+
+    /// Casts a ray against AABBs with the slab test, for picking. An axis where the ray starts on a face of a box and
+    /// runs parallel to it does not rule the box out.
+    /// \param t_ray The ray.
+    /// \param t_maxDistance How far along the ray to look, in multiples of the ray's direction.
+    /// \param t_aabbs The boxes.
+    /// \param t_hitDistances Is resized to hold the distance along the ray each box is entered, 0 for boxes the ray
+    /// starts in and infinity for the boxes it misses.
+    /// \return The index of the box hit closest to the ray's origin, or NO_HIT.
+    inline std::size_t raycastAabbs(const Ray& t_ray, float t_maxDistance, const AabbSoa& t_aabbs,
+                                    std::vector<float>& t_hitDistances){
+        const std::size_t numAabbs = t_aabbs.size();
+        t_hitDistances.resize(numAabbs);
+        const float miss = std::numeric_limits<float>::infinity();
+        std::array<float, 3> inverseDirection{};
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            inverseDirection[axis] = 1.0f / t_ray.m_direction[axis];
+        };
+
+        simd_geometry_detail::forEachLanes(numAabbs, [&](auto t_lanes, std::size_t t_index) {
+            using Lanes = decltype(t_lanes);
+            using Value = typename Lanes::Value;
+            Value entry = Lanes::broadcast(0.0f);
+            Value exit = Lanes::broadcast(t_maxDistance);
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                Value origin = Lanes::broadcast(t_ray.m_origin[axis]);
+                Value inverse = Lanes::broadcast(inverseDirection[axis]);
+                Value minDistance = Lanes::mul(Lanes::sub(Lanes::load(&t_aabbs.m_min[axis][t_index]), origin), inverse);
+                Value maxDistance = Lanes::mul(Lanes::sub(Lanes::load(&t_aabbs.m_max[axis][t_index]), origin), inverse);
+
+                // The slab's distances come first, so a NaN from 0 * infinity leaves entry and exit as they were.
+                entry = Lanes::maximum(Lanes::minimum(minDistance, maxDistance), entry);
+                exit = Lanes::minimum(Lanes::maximum(minDistance, maxDistance), exit);
+            };
+            Lanes::store(&t_hitDistances[t_index],
+                         Lanes::select(Lanes::lessEqual(entry, exit), entry, Lanes::broadcast(miss)));
+        });
+
+        std::size_t closestHit = NO_HIT;
+        float closestDistance = miss;
+        for (std::size_t index = 0; index < numAabbs; index++) {
+            if (t_hitDistances[index] < closestDistance) {
+                closestDistance = t_hitDistances[index];
+                closestHit = index;
+            };
+        };
+        return closestHit;
+    };
+
+    /// Finds the AABBs a sphere overlaps or touches, for queries such as the entities within a radius of a point.
+    /// \param t_center The centre of the sphere.
+    /// \param t_radius The radius of the sphere.
+    /// \param t_aabbs The boxes.
+    /// \param t_isOverlapping Is resized to hold 1 for each box the sphere overlaps and 0 for the others.
+    /// \return The number of boxes the sphere overlaps.
+    inline std::size_t overlapSphereAabbs(const std::array<float, 3>& t_center, float t_radius, const AabbSoa& t_aabbs,
+                                          std::vector<uint8_t>& t_isOverlapping){
+        const std::size_t numAabbs = t_aabbs.size();
+        t_isOverlapping.resize(numAabbs);
+
+        std::size_t numOverlapping = 0;
+        simd_geometry_detail::forEachLanes(numAabbs, [&](auto t_lanes, std::size_t t_index) {
+            using Lanes = decltype(t_lanes);
+            using Value = typename Lanes::Value;
+
+            // The squared distance from the centre to the closest point of the box.
+            Value squaredDistance = Lanes::broadcast(0.0f);
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                Value center = Lanes::broadcast(t_center[axis]);
+                Value closest = Lanes::minimum(Lanes::maximum(center, Lanes::load(&t_aabbs.m_min[axis][t_index])),
+                                           Lanes::load(&t_aabbs.m_max[axis][t_index]));
+                Value offset = Lanes::sub(center, closest);
+                squaredDistance = Lanes::add(squaredDistance, Lanes::mul(offset, offset));
+            };
+            numOverlapping += Lanes::storeMask(&t_isOverlapping[t_index],
+                                               Lanes::lessEqual(squaredDistance, Lanes::broadcast(t_radius * t_radius)));
+        });
+        return numOverlapping;
+    };
+
+} // namespace ae
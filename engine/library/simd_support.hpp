@@ -0,0 +1,22 @@
+/// \file simd_support.hpp
+/// The SIMD instruction sets the engine library is being compiled for are detected. Code using them checks the
+/// AE_SIMD_* macros and keeps a portable path for when they are not defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+
+/// SSE2 is part of every x86-64 processor, and 32 bit x86 when the compiler has been told it may use it.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+/// AVX2 has to be turned on by the compiler flags, -mavx2 or /arch:AVX2, as not every x86-64 processor has it.
+#if defined(__AVX2__)
+#define AE_SIMD_AVX2
+#include <immintrin.h>
+#endif
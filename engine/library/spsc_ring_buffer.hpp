@@ -0,0 +1,157 @@
+/// \file spsc_ring_buffer.hpp
+/// The SpscRingBuffer class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "allocator_buffer.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace ae {
+
+    /// A bounded queue passing elements from exactly one producer thread to exactly one consumer thread without locks,
+    /// such as log lines to a logging thread or loaded assets back to the main thread. The write index is only written
+    /// by the producer and the read index only by the consumer, each on a cache line of its own. Each side also keeps a
+    /// copy of the other side's index on its own cache line, and only reloads the real one when the copy says the
+    /// buffer is full or empty, so the two threads rarely touch each other's cache lines.
+    /// \tparam T The type of element.
+    template<typename T>
+    class SpscRingBuffer {
+    public:
+
+        /// Creates the buffer, its slots are borrowed from an allocator.
+        /// \param t_capacity The most elements the buffer holds, rounded up to a power of two.
+        /// \param t_allocator The allocator the slots are borrowed from, nullptr for the heap.
+        explicit SpscRingBuffer(std::size_t t_capacity, ae_memory::AeAllocatorBase* t_allocator = nullptr) :
+                m_capacity{roundUpToPowerOfTwo(t_capacity)},
+                m_slots{t_allocator, sizeof(T) * m_capacity, std::max(alignof(T), CACHE_LINE_SIZE)} {};
+
+        /// Destroys the elements still in the buffer.
+        ~SpscRingBuffer() {
+            T* slots = m_slots.get<T>();
+            std::size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+            for (std::size_t index = m_readIndex.load(std::memory_order_relaxed); index != writeIndex; index++) {
+                slots[index & (m_capacity - 1)].~T();
+            };
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        SpscRingBuffer(const SpscRingBuffer&) = delete;
+        SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        SpscRingBuffer(SpscRingBuffer&&) = delete;
+        SpscRingBuffer& operator=(SpscRingBuffer&&) = delete;
+
+        /// Constructs an element at the back of the buffer, only called by the producer.
+        /// \param t_args The arguments of the element's constructor.
+        /// \return False if the buffer is full.
+        template<typename... TArgs>
+        bool tryEmplace(TArgs&&... t_args) {
+            std::size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+            if (writeIndex - m_producer.m_cachedReadIndex == m_capacity) {
+                m_producer.m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+                if (writeIndex - m_producer.m_cachedReadIndex == m_capacity) {
+                    return false;
+                };
+            };
+
+            new(m_slots.get<T>() + (writeIndex & (m_capacity - 1))) T(std::forward<TArgs>(t_args)...);
+            m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+            return true;
+        };
+
+        /// Copies an element to the back of the buffer, only called by the producer.
+        /// \param t_value The element.
+        /// \return False if the buffer is full.
+        bool tryPush(const T& t_value) { return tryEmplace(t_value); };
+
+        /// Moves an element to the back of the buffer, only called by the producer.
+        /// \param t_value The element.
+        /// \return False if the buffer is full, the element is not moved from.
+        bool tryPush(T&& t_value) { return tryEmplace(std::move(t_value)); };
+
+        /// Moves the element at the front of the buffer out, only called by the consumer.
+        /// \param t_value Set to the element.
+        /// \return False if the buffer is empty.
+        bool tryPop(T& t_value) {
+            std::size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+            if (readIndex == m_consumer.m_cachedWriteIndex) {
+                m_consumer.m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+                if (readIndex == m_consumer.m_cachedWriteIndex) {
+                    return false;
+                };
+            };
+
+            T* slot = m_slots.get<T>() + (readIndex & (m_capacity - 1));
+            t_value = std::move(*slot);
+            slot->~T();
+            m_readIndex.store(readIndex + 1, std::memory_order_release);
+            return true;
+        };
+
+        /// Gets the number of elements in the buffer, only exact when called by the producer or consumer while the
+        /// other is not using the buffer.
+        [[nodiscard]] std::size_t sizeApprox() const {
+            return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_acquire);
+        };
+
+        /// Gets the most elements the buffer holds.
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; };
+
+    private:
+
+        /// Rounds a capacity up to the power of two that lets slots be found with a mask.
+        static std::size_t roundUpToPowerOfTwo(std::size_t t_capacity) {
+            if (t_capacity == 0) {
+                throw std::runtime_error("A ring buffer must be able to hold at least one element!");
+            };
+            std::size_t capacity = 1;
+            while (capacity < t_capacity) {
+                capacity <<= 1;
+            };
+            return capacity;
+        };
+
+        /// The producer's copy of the read index.
+        struct alignas(CACHE_LINE_SIZE) ProducerCache {
+            std::size_t m_cachedReadIndex = 0;
+        };
+
+        /// The consumer's copy of the write index.
+        struct alignas(CACHE_LINE_SIZE) ConsumerCache {
+            std::size_t m_cachedWriteIndex = 0;
+        };
+
+        /// The most elements the buffer holds, a power of two.
+        std::size_t m_capacity;
+
+        /// The slots of the elements.
+        AllocatorBuffer m_slots;
+
+        /// The number of elements ever pushed, the next slot written is this modulo the capacity.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_writeIndex{0};
+
+        /// The number of elements ever popped, the next slot read is this modulo the capacity.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_readIndex{0};
+
+        /// The producer's copy of the read index.
+        ProducerCache m_producer;
+
+        /// The consumer's copy of the write index.
+        ConsumerCache m_consumer;
+
+    protected:
+
+    };
+
+} // namespace ae
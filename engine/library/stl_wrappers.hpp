@@ -1,16 +1,59 @@
-/// \file ##.hpp
-/// The ## class is defined.
+/// \file stl_wrappers.hpp
+/// The STL containers allocating from the engine allocators are defined.
 #pragma once
 
 // dependencies
 #include "ae_allocator_stl_adapter.hpp"
+#include "ae_memory_resource.hpp"
 
 // libraries
 
 // std
+#include <deque>
+#include <map>
+#include <memory_resource>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace ae {
     template<typename Key, typename T, typename Alloc, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
     using unordered_map = std::unordered_map<Key, T, Hash, KeyEqual, ae_memory::AeAllocatorStlAdaptor<std::pair<const Key, T>, Alloc>>;
-} // namespace ae
\ No newline at end of file
+
+    template<typename Key, typename Alloc, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    using unordered_set = std::unordered_set<Key, Hash, KeyEqual, ae_memory::AeAllocatorStlAdaptor<Key, Alloc>>;
+
+    template<typename Key, typename T, typename Alloc, typename Compare = std::less<Key>>
+    using map = std::map<Key, T, Compare, ae_memory::AeAllocatorStlAdaptor<std::pair<const Key, T>, Alloc>>;
+
+    template<typename T, typename Alloc>
+    using vector = std::vector<T, ae_memory::AeAllocatorStlAdaptor<T, Alloc>>;
+
+    template<typename T, typename Alloc>
+    using deque = std::deque<T, ae_memory::AeAllocatorStlAdaptor<T, Alloc>>;
+
+    template<typename Alloc>
+    using string = std::basic_string<char, std::char_traits<char>, ae_memory::AeAllocatorStlAdaptor<char, Alloc>>;
+
+    /// The containers allocating from a memory resource, their type does not depend on the allocator behind the memory
+    /// resource. Give them a ae_memory::AeMemoryResource to allocate from an engine allocator.
+    namespace pmr {
+        template<typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+        using unordered_map = std::pmr::unordered_map<Key, T, Hash, KeyEqual>;
+
+        template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+        using unordered_set = std::pmr::unordered_set<Key, Hash, KeyEqual>;
+
+        template<typename Key, typename T, typename Compare = std::less<Key>>
+        using map = std::pmr::map<Key, T, Compare>;
+
+        template<typename T>
+        using vector = std::pmr::vector<T>;
+
+        template<typename T>
+        using deque = std::pmr::deque<T>;
+
+        using string = std::pmr::string;
+    } // namespace pmr
+} // namespace ae
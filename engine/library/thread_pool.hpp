@@ -0,0 +1,193 @@
+/// \file thread_pool.hpp
+/// The AeThreadPool class is defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ae {
+
+    /// A fixed set of worker threads which run the tasks of a parallel for loop alongside the calling thread. The
+    /// workers sleep between loops. Only one loop runs at a time, a loop started from inside a task runs on the calling
+    /// thread instead of waiting on the workers it is occupying.
+    class AeThreadPool {
+    public:
+
+        /// Creates the pool and starts its workers.
+        /// \param t_numThreads The number of threads that run a loop, including the calling thread. By default one for
+        /// each hardware thread.
+        explicit AeThreadPool(std::size_t t_numThreads = std::thread::hardware_concurrency()) {
+            std::size_t numWorkers = std::max<std::size_t>(t_numThreads, 1) - 1;
+            m_workers.reserve(numWorkers);
+            for (std::size_t i = 0; i < numWorkers; i++) {
+                m_workers.emplace_back([this]() { workerLoop(); });
+            };
+        };
+
+        /// Stops and joins the workers.
+        ~AeThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_isStopping = true;
+            };
+            m_workAvailable.notify_all();
+            for (auto& worker: m_workers) {
+                worker.join();
+            };
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        AeThreadPool(const AeThreadPool&) = delete;
+        AeThreadPool& operator=(const AeThreadPool&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeThreadPool(AeThreadPool&&) = delete;
+        AeThreadPool& operator=(AeThreadPool&&) = delete;
+
+        /// Gets the number of threads that run a loop, including the calling thread.
+        [[nodiscard]] std::size_t getNumThreads() const { return m_workers.size() + 1; };
+
+        /// Runs a task once for each index from 0 to t_numTasks and returns once every task has finished. The tasks
+        /// are handed out one index at a time, so each should be a sizeable piece of work.
+        /// \param t_numTasks The number of tasks.
+        /// \param t_task The task, given the index of the task to run. It is called from several threads at once.
+        /// \throws The first exception thrown by a task, after the remaining tasks have run.
+        void parallelFor(std::size_t t_numTasks, const std::function<void(std::size_t)>& t_task) {
+            if (t_numTasks == 0) {
+                return;
+            };
+            if (m_workers.empty() || t_numTasks == 1 || m_currentPool == this) {
+                for (std::size_t i = 0; i < t_numTasks; i++) {
+                    t_task(i);
+                };
+                return;
+            };
+
+            std::lock_guard<std::mutex> loopLock{m_loopMutex};
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                m_task = &t_task;
+                m_numTasks = t_numTasks;
+                m_nextTask.store(0, std::memory_order_relaxed);
+                m_numBusyWorkers = m_workers.size();
+                m_exception = nullptr;
+                m_loopNumber++;
+            };
+            m_workAvailable.notify_all();
+
+            runTasks();
+
+            std::exception_ptr exception;
+            {
+                std::unique_lock<std::mutex> lock{m_mutex};
+                m_workDone.wait(lock, [this]() { return m_numBusyWorkers == 0; });
+                m_task = nullptr;
+                exception = m_exception;
+            };
+            if (exception) {
+                std::rethrow_exception(exception);
+            };
+        };
+
+    private:
+
+        /// Sleeps until a loop starts, helps run its tasks, and reports back when there are no more to take.
+        void workerLoop() {
+            std::uint64_t lastLoopNumber = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock{m_mutex};
+                    m_workAvailable.wait(lock, [&]() { return m_isStopping || m_loopNumber != lastLoopNumber; });
+                    if (m_isStopping) {
+                        return;
+                    };
+                    lastLoopNumber = m_loopNumber;
+                };
+
+                runTasks();
+
+                std::lock_guard<std::mutex> lock{m_mutex};
+                if (--m_numBusyWorkers == 0) {
+                    m_workDone.notify_one();
+                };
+            };
+        };
+
+        /// Takes and runs tasks of the current loop until there are none left.
+        void runTasks() {
+            const AeThreadPool* previousPool = m_currentPool;
+            m_currentPool = this;
+            while (true) {
+                std::size_t taskIndex = m_nextTask.fetch_add(1, std::memory_order_relaxed);
+                if (taskIndex >= m_numTasks) {
+                    break;
+                };
+                try {
+                    (*m_task)(taskIndex);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock{m_mutex};
+                    if (!m_exception) {
+                        m_exception = std::current_exception();
+                    };
+                };
+            };
+            m_currentPool = previousPool;
+        };
+
+        /// The worker threads, one fewer than the threads running a loop.
+        std::vector<std::thread> m_workers;
+
+        /// Guards the state of the current loop shared with the workers.
+        std::mutex m_mutex;
+
+        /// Held for the whole of a loop so that only one loop runs at a time.
+        std::mutex m_loopMutex;
+
+        /// Wakes the workers when a loop starts or the pool is stopping.
+        std::condition_variable m_workAvailable;
+
+        /// Wakes the thread that started a loop when the last worker is done with it.
+        std::condition_variable m_workDone;
+
+        /// The task of the current loop.
+        const std::function<void(std::size_t)>* m_task = nullptr;
+
+        /// The number of tasks of the current loop.
+        std::size_t m_numTasks = 0;
+
+        /// The index of the next task of the current loop to be taken.
+        std::atomic<std::size_t> m_nextTask{0};
+
+        /// The number of workers still taking tasks from the current loop.
+        std::size_t m_numBusyWorkers = 0;
+
+        /// Counts the loops started, the workers compare it to the last loop they helped with to find new loops.
+        std::uint64_t m_loopNumber = 0;
+
+        /// The first exception thrown by a task of the current loop.
+        std::exception_ptr m_exception;
+
+        /// Set when the pool is being destroyed and the workers must return.
+        bool m_isStopping = false;
+
+        /// The pool whose tasks the current thread is running, used to run nested loops on the calling thread.
+        inline static thread_local const AeThreadPool* m_currentPool = nullptr;
+
+    protected:
+
+    };
+
+} // namespace ae
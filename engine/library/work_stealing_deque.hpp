@@ -0,0 +1,200 @@
+/// \file work_stealing_deque.hpp
+/// The WorkStealingDeque class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "allocator_buffer.hpp"
+
+// libraries
+
+//std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace ae {
+
+    /// A Chase-Lev work stealing deque, with the memory orderings of Lê, Pop, Cohen and Zappa Nardelli's "Correct and
+    /// Efficient Work-Stealing for Weak Memory Models". One owner thread pushes and pops work at the bottom, last in
+    /// first out so the work it just made is still in its cache. Any other thread steals work from the top, first in
+    /// first out, which takes the oldest and usually largest work. The owner only contends with thieves over the last
+    /// element. The deque grows when full. The arrays it outgrows are kept until the deque is destroyed, because a
+    /// thief may still be reading from one.
+    /// \tparam T The type of element, such as a pointer or index of a job. Thieves read elements they may lose the race
+    /// for, so it must be trivially copyable.
+    template<typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "The elements of a work stealing deque must be trivially copyable.");
+
+    public:
+
+        /// Creates the deque, its elements are borrowed from an allocator.
+        /// \param t_capacity The number of elements the deque holds before it first grows, rounded up to a power of two.
+        /// \param t_allocator The allocator the elements are borrowed from, nullptr for the heap. It is used by the
+        /// owner thread whenever the deque grows.
+        explicit WorkStealingDeque(std::size_t t_capacity = 256, ae_memory::AeAllocatorBase* t_allocator = nullptr) :
+                m_allocator{t_allocator} {
+            std::size_t capacity = 1;
+            while (capacity < t_capacity) {
+                capacity <<= 1;
+            };
+            m_ownedArray = std::make_unique<Array>(capacity, m_allocator, nullptr);
+            m_array.store(m_ownedArray.get(), std::memory_order_relaxed);
+        };
+
+        /// Do not allow this class to be copied (2 lines below)
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        WorkStealingDeque(WorkStealingDeque&&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+        /// Pushes an element onto the bottom of the deque, only called by the owner. Grows the deque when it is full.
+        /// \param t_value The element.
+        void push(T t_value) {
+            std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            std::int64_t top = m_top.load(std::memory_order_acquire);
+            Array* array = m_array.load(std::memory_order_relaxed);
+            if (bottom - top > static_cast<std::int64_t>(array->m_mask)) {
+                array = grow(array, top, bottom);
+            };
+
+            // A release store rather than the paper's release fence and relaxed store. It orders the same and costs
+            // the same, but thread sanitizer can see it publish the element.
+            array->store(bottom, t_value);
+            m_bottom.store(bottom + 1, std::memory_order_release);
+        };
+
+        /// Pops the element at the bottom of the deque, the one pushed last, only called by the owner.
+        /// \param t_value Set to the element.
+        /// \return False if the deque is empty, or a thief took the last element.
+        bool pop(T& t_value) {
+            std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            Array* array = m_array.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            };
+
+            t_value = array->load(bottom);
+            if (top == bottom) {
+                // The last element, thieves may be racing for it.
+                bool isWon = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return isWon;
+            };
+            return true;
+        };
+
+        /// Steals the element at the top of the deque, the oldest one, called by any thread other than the owner.
+        /// \param t_value Set to the element.
+        /// \return False if the deque is empty, or another thread took the element first.
+        bool steal(T& t_value) {
+            std::int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom) {
+                return false;
+            };
+
+            Array* array = m_array.load(std::memory_order_acquire);
+            T value = array->load(top);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            };
+            t_value = value;
+            return true;
+        };
+
+        /// Gets the number of elements in the deque, only exact when no other thread is using the deque.
+        [[nodiscard]] std::size_t sizeApprox() const {
+            std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            std::int64_t top = m_top.load(std::memory_order_relaxed);
+            return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+        };
+
+        /// Checks if the deque looks empty, only exact when no other thread is using the deque.
+        [[nodiscard]] bool emptyApprox() const { return sizeApprox() == 0; };
+
+        /// Gets the number of elements the deque holds before it next grows.
+        [[nodiscard]] std::size_t capacity() const { return m_array.load(std::memory_order_relaxed)->m_mask + 1; };
+
+    private:
+
+        /// A circular array of elements, which owns the array it replaced.
+        struct Array {
+            Array(std::size_t t_capacity, ae_memory::AeAllocatorBase* t_allocator, std::unique_ptr<Array> t_previous) :
+                    m_mask{t_capacity - 1},
+                    m_elements{t_allocator, sizeof(std::atomic<T>) * t_capacity, alignof(std::atomic<T>)},
+                    m_previous{std::move(t_previous)} {
+                std::atomic<T>* elements = m_elements.get<std::atomic<T>>();
+                for (std::size_t index = 0; index < t_capacity; index++) {
+                    new(&elements[index]) std::atomic<T>{};
+                };
+            };
+
+            /// Reads the element at a position.
+            T load(std::int64_t t_position) const {
+                return m_elements.get<std::atomic<T>>()[static_cast<std::size_t>(t_position) & m_mask]
+                        .load(std::memory_order_relaxed);
+            };
+
+            /// Writes the element at a position.
+            void store(std::int64_t t_position, T t_value) {
+                m_elements.get<std::atomic<T>>()[static_cast<std::size_t>(t_position) & m_mask]
+                        .store(t_value, std::memory_order_relaxed);
+            };
+
+            /// The capacity of the array minus one, a position's index in the array is the position masked with it.
+            std::size_t m_mask;
+
+            /// The elements.
+            AllocatorBuffer m_elements;
+
+            /// The array this one replaced, which thieves may still be reading from.
+            std::unique_ptr<Array> m_previous;
+        };
+
+        /// Replaces a full array with one twice the size holding the same elements, only called by the owner.
+        /// \return The new array.
+        Array* grow(Array* t_array, std::int64_t t_top, std::int64_t t_bottom) {
+            auto array = std::make_unique<Array>((t_array->m_mask + 1) * 2, m_allocator, std::move(m_ownedArray));
+            for (std::int64_t position = t_top; position < t_bottom; position++) {
+                array->store(position, t_array->load(position));
+            };
+            m_ownedArray = std::move(array);
+            m_array.store(m_ownedArray.get(), std::memory_order_release);
+            return m_ownedArray.get();
+        };
+
+        /// The position of the next element stolen, only moved forwards.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> m_top{0};
+
+        /// The position the owner pushes the next element to.
+        alignas(CACHE_LINE_SIZE) std::atomic<std::int64_t> m_bottom{0};
+
+        /// The array thieves and the owner read, the same as the owned array.
+        alignas(CACHE_LINE_SIZE) std::atomic<Array*> m_array{nullptr};
+
+        /// The newest array, which owns the arrays it replaced.
+        std::unique_ptr<Array> m_ownedArray;
+
+        /// The allocator the elements are borrowed from, nullptr for the heap.
+        ae_memory::AeAllocatorBase* m_allocator;
+
+    protected:
+
+    };
+
+} // namespace ae
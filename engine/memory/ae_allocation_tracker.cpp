@@ -0,0 +1,429 @@
+/// \file ae_allocation_tracker.cpp
+/// The AeAllocationTracker class is implemented.
+#include "ae_allocation_tracker.hpp"
+
+#ifdef AE_MEMORY_TRACKING
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#endif
+
+namespace ae_memory {
+
+    namespace {
+
+        /// The key of a slot of the table of live allocations that has never been used.
+        constexpr std::uintptr_t EMPTY_KEY = 0;
+
+        /// The key of a slot whose record is being written.
+        constexpr std::uintptr_t CLAIMED_KEY = 1;
+
+        /// The key of a slot whose allocation has been deallocated, probing continues past it up to the longest probe
+        /// length.
+        constexpr std::uintptr_t REMOVED_KEY = 2;
+
+        /// The number of frames at the top of the callstack belonging to the tracker, fewer than there can be so the
+        /// caller of the budget is kept when the tracker's functions are inlined.
+        constexpr std::size_t NUM_SKIPPED_FRAMES = 2;
+
+        /// Hashes the return addresses of a callstack with FNV-1a, never returning 0 since it marks an empty slot.
+        std::uint64_t hashCallstack(void* const* t_callstack, std::size_t t_depth) {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (std::size_t i = 0; i < t_depth; i++) {
+                auto address = reinterpret_cast<std::uintptr_t>(t_callstack[i]);
+                for (std::size_t j = 0; j < sizeof(address); j++) {
+                    hash ^= (address >> (j * 8)) & 0xff;
+                    hash *= 1099511628211ull;
+                };
+            };
+            return hash == 0 ? 1 : hash;
+        };
+
+        /// Captures the return addresses of the calling thread's callstack.
+        std::size_t captureCallstack(void** t_callstack, std::size_t t_maxDepth) {
+#if defined(_WIN32)
+            return CaptureStackBackTrace(NUM_SKIPPED_FRAMES, static_cast<DWORD>(t_maxDepth), t_callstack, nullptr);
+#elif defined(__GLIBC__) || defined(__APPLE__)
+            void* callstack[AeAllocationTracker::MAX_CALLSTACK_DEPTH + NUM_SKIPPED_FRAMES];
+            int depth = backtrace(callstack, static_cast<int>(t_maxDepth + NUM_SKIPPED_FRAMES));
+            if (depth <= static_cast<int>(NUM_SKIPPED_FRAMES)) {
+                return 0;
+            };
+            std::copy(callstack + NUM_SKIPPED_FRAMES, callstack + depth, t_callstack);
+            return static_cast<std::size_t>(depth) - NUM_SKIPPED_FRAMES;
+#else
+            // Without a way to walk the stack only the return address into the tracker is known.
+            t_callstack[0] = __builtin_return_address(0);
+            return t_maxDepth > 0 ? 1 : 0;
+#endif
+        };
+
+        /// Writes an address as a hexadecimal JSON string.
+        std::string addressToString(const void* t_address) {
+            std::ostringstream address;
+            address << "\"0x" << std::hex << reinterpret_cast<std::uintptr_t>(t_address) << "\"";
+            return address.str();
+        };
+    }
+
+
+
+    AeAllocationTracker& AeAllocationTracker::getInstance() {
+        static AeAllocationTracker allocationTracker;
+        return allocationTracker;
+    };
+
+
+
+    AeAllocationTracker::AeAllocationTracker() :
+            m_liveAllocations{std::make_unique<LiveSlot[]>(LIVE_ALLOCATION_CAPACITY)},
+            m_events{std::make_unique<Event[]>(EVENT_CAPACITY)},
+            m_sites{std::make_unique<SiteSlot[]>(SITE_CAPACITY)} {
+    };
+
+
+
+    // Claim a slot of the live allocation table, fill in the record, then publish it under the allocation's address.
+    // The longest probe length is raised before the record is published so a deallocation searches far enough.
+    void AeAllocationTracker::recordAllocation(void* const t_ptr,
+                                               std::size_t const t_size,
+                                               std::size_t const t_alignment,
+                                               MemoryTag const t_memoryTag) noexcept {
+        std::uint64_t siteHash = recordCallSite();
+        std::uint64_t eventIndex = m_nextEvent.fetch_add(1, std::memory_order_relaxed);
+        m_frameBytesAllocated.fetch_add(t_size, std::memory_order_relaxed);
+
+        Event& event = m_events[eventIndex & (EVENT_CAPACITY - 1)];
+        event.m_sequence.store(0, std::memory_order_relaxed);
+        event.m_size.store(t_size, std::memory_order_relaxed);
+        event.m_siteHash.store(siteHash, std::memory_order_relaxed);
+        event.m_sequence.store(eventIndex + 1, std::memory_order_release);
+
+        std::size_t slotIndex = getLiveSlotIndex(reinterpret_cast<std::uintptr_t>(t_ptr));
+        for (std::size_t i = 0; i < LIVE_ALLOCATION_CAPACITY; i++) {
+            LiveSlot& slot = m_liveAllocations[(slotIndex + i) & (LIVE_ALLOCATION_CAPACITY - 1)];
+            std::uintptr_t key = slot.m_key.load(std::memory_order_relaxed);
+            if ((key == EMPTY_KEY || key == REMOVED_KEY) &&
+                slot.m_key.compare_exchange_strong(key, CLAIMED_KEY, std::memory_order_acquire)) {
+
+                std::size_t longestProbeLength = m_longestProbeLength.load(std::memory_order_relaxed);
+                while (i > longestProbeLength &&
+                       !m_longestProbeLength.compare_exchange_weak(longestProbeLength, i, std::memory_order_relaxed)) {
+                };
+
+                std::uint64_t version = slot.m_version.load(std::memory_order_relaxed);
+                slot.m_version.store(version + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                slot.m_size.store(t_size, std::memory_order_relaxed);
+                slot.m_alignment.store(t_alignment, std::memory_order_relaxed);
+                slot.m_memoryTag.store(t_memoryTag, std::memory_order_relaxed);
+                slot.m_siteHash.store(siteHash, std::memory_order_relaxed);
+                slot.m_frameNumber.store(m_frameNumber.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                slot.m_sequenceNumber.store(eventIndex + 1, std::memory_order_relaxed);
+
+                slot.m_version.store(version + 2, std::memory_order_release);
+                slot.m_key.store(reinterpret_cast<std::uintptr_t>(t_ptr), std::memory_order_release);
+                return;
+            };
+        };
+
+        m_numDroppedAllocations.fetch_add(1, std::memory_order_relaxed);
+    };
+
+
+
+    // Probing stops at a slot that has never been used, since the allocation would have been placed before it, or past
+    // the longest probe length, since no allocation was placed further from its first slot.
+    void AeAllocationTracker::recordDeallocation(void* const t_ptr) noexcept {
+        m_frameNumDeallocations.fetch_add(1, std::memory_order_relaxed);
+
+        auto key = reinterpret_cast<std::uintptr_t>(t_ptr);
+        std::size_t slotIndex = getLiveSlotIndex(key);
+        std::size_t probeLength = std::min(m_longestProbeLength.load(std::memory_order_relaxed) + 1,
+                                           LIVE_ALLOCATION_CAPACITY);
+        for (std::size_t i = 0; i < probeLength; i++) {
+            LiveSlot& slot = m_liveAllocations[(slotIndex + i) & (LIVE_ALLOCATION_CAPACITY - 1)];
+            std::uintptr_t slotKey = slot.m_key.load(std::memory_order_acquire);
+            if (slotKey == EMPTY_KEY) {
+                return;
+            };
+            if (slotKey == key) {
+                slot.m_key.store(REMOVED_KEY, std::memory_order_release);
+                return;
+            };
+        };
+    };
+
+
+
+    // Count the bytes each call site allocated in the events of the frame still in the ring.
+    void AeAllocationTracker::endFrame() {
+        std::uint64_t frameEndEvent = m_nextEvent.load(std::memory_order_acquire);
+
+        AeAllocationFrameStats frameStats;
+        frameStats.m_frameNumber = m_frameNumber.load(std::memory_order_relaxed);
+        frameStats.m_numAllocations = static_cast<std::size_t>(frameEndEvent - m_frameFirstEvent);
+        frameStats.m_bytesAllocated = m_frameBytesAllocated.exchange(0, std::memory_order_relaxed);
+        frameStats.m_numDeallocations = m_frameNumDeallocations.exchange(0, std::memory_order_relaxed);
+
+        std::uint64_t firstEvent = m_frameFirstEvent;
+        if (frameEndEvent - firstEvent > EVENT_CAPACITY) {
+            firstEvent = frameEndEvent - EVENT_CAPACITY;
+            frameStats.m_isComplete = false;
+        };
+
+        std::unordered_map<std::uint64_t, AeAllocationSiteStats> sites;
+        for (std::uint64_t i = firstEvent; i < frameEndEvent; i++) {
+            const Event& event = m_events[i & (EVENT_CAPACITY - 1)];
+            std::size_t size = event.m_size.load(std::memory_order_relaxed);
+            std::uint64_t siteHash = event.m_siteHash.load(std::memory_order_relaxed);
+
+            // The event was overwritten, or is still being written, by another thread.
+            if (event.m_sequence.load(std::memory_order_acquire) != i + 1) {
+                frameStats.m_isComplete = false;
+                continue;
+            };
+
+            AeAllocationSiteStats& site = sites[siteHash];
+            site.m_siteHash = siteHash;
+            site.m_numAllocations += 1;
+            site.m_bytesAllocated += size;
+        };
+
+        for (const auto& site: sites) {
+            frameStats.m_topSites.push_back(site.second);
+        };
+        std::size_t numTopSites = std::min(NUM_TOP_SITES, frameStats.m_topSites.size());
+        std::partial_sort(frameStats.m_topSites.begin(),
+                          frameStats.m_topSites.begin() + static_cast<std::ptrdiff_t>(numTopSites),
+                          frameStats.m_topSites.end(),
+                          [](const AeAllocationSiteStats& t_siteA, const AeAllocationSiteStats& t_siteB) {
+                              return t_siteA.m_bytesAllocated > t_siteB.m_bytesAllocated;
+                          });
+        frameStats.m_topSites.resize(numTopSites);
+
+        m_lastFrameStats = std::move(frameStats);
+        m_frameFirstEvent = frameEndEvent;
+        m_frameNumber.fetch_add(1, std::memory_order_relaxed);
+    };
+
+
+
+    std::uint64_t AeAllocationTracker::getMarker() const noexcept {
+        return m_nextEvent.load(std::memory_order_acquire);
+    };
+
+
+
+    // Only published records are read, a record being replaced while it is copied is skipped, which the version shows
+    // even when the new allocation has the same address.
+    std::vector<AeAllocationRecord> AeAllocationTracker::getLiveAllocations(std::uint64_t const t_marker) const {
+        std::vector<AeAllocationRecord> liveAllocations;
+        for (std::size_t i = 0; i < LIVE_ALLOCATION_CAPACITY; i++) {
+            const LiveSlot& slot = m_liveAllocations[i];
+            std::uint64_t version = slot.m_version.load(std::memory_order_acquire);
+            std::uintptr_t key = slot.m_key.load(std::memory_order_acquire);
+            if (version % 2 == 1 || key == EMPTY_KEY || key == CLAIMED_KEY || key == REMOVED_KEY) {
+                continue;
+            };
+
+            AeAllocationRecord record{reinterpret_cast<void*>(key),
+                                      slot.m_size.load(std::memory_order_relaxed),
+                                      slot.m_alignment.load(std::memory_order_relaxed),
+                                      slot.m_memoryTag.load(std::memory_order_relaxed),
+                                      slot.m_siteHash.load(std::memory_order_relaxed),
+                                      slot.m_frameNumber.load(std::memory_order_relaxed),
+                                      slot.m_sequenceNumber.load(std::memory_order_relaxed)};
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.m_version.load(std::memory_order_relaxed) == version && record.m_sequenceNumber > t_marker) {
+                liveAllocations.push_back(record);
+            };
+        };
+
+        std::sort(liveAllocations.begin(),
+                  liveAllocations.end(),
+                  [](const AeAllocationRecord& t_recordA, const AeAllocationRecord& t_recordB) {
+                      return t_recordA.m_sequenceNumber < t_recordB.m_sequenceNumber;
+                  });
+        return liveAllocations;
+    };
+
+
+
+    std::vector<void*> AeAllocationTracker::getCallstack(std::uint64_t const t_siteHash) const {
+        for (std::size_t i = 0; i < SITE_CAPACITY; i++) {
+            const SiteSlot& slot = m_sites[(t_siteHash + i) & (SITE_CAPACITY - 1)];
+            std::uint64_t siteHash = slot.m_siteHash.load(std::memory_order_acquire);
+            if (siteHash == 0) {
+                break;
+            };
+            if (siteHash == t_siteHash && slot.m_isReady.load(std::memory_order_acquire)) {
+                return std::vector<void*>(slot.m_callstack, slot.m_callstack + slot.m_depth);
+            };
+        };
+        return {};
+    };
+
+
+
+    std::size_t AeAllocationTracker::getNumDroppedAllocations() const noexcept {
+        return m_numDroppedAllocations.load(std::memory_order_relaxed);
+    };
+
+
+
+    std::size_t AeAllocationTracker::getLongestProbeLength() const noexcept {
+        return m_longestProbeLength.load(std::memory_order_relaxed);
+    };
+
+
+
+    // The callstacks are written as return addresses, along with the symbols of each address where the platform can
+    // provide them, to be resolved offline against the executable.
+    std::string AeAllocationTracker::toJson(std::uint64_t const t_marker) const {
+        std::vector<AeAllocationRecord> liveAllocations = getLiveAllocations(t_marker);
+        std::ostringstream json;
+
+        json << "{\n";
+        json << "  \"marker\": " << t_marker << ",\n";
+        json << "  \"droppedAllocations\": " << getNumDroppedAllocations() << ",\n";
+
+        json << "  \"lastFrame\": {\n";
+        json << "    \"frame\": " << m_lastFrameStats.m_frameNumber << ",\n";
+        json << "    \"allocations\": " << m_lastFrameStats.m_numAllocations << ",\n";
+        json << "    \"bytesAllocated\": " << m_lastFrameStats.m_bytesAllocated << ",\n";
+        json << "    \"deallocations\": " << m_lastFrameStats.m_numDeallocations << ",\n";
+        json << "    \"isComplete\": " << (m_lastFrameStats.m_isComplete ? "true" : "false") << ",\n";
+        json << "    \"topSites\": [";
+        for (std::size_t i = 0; i < m_lastFrameStats.m_topSites.size(); i++) {
+            const AeAllocationSiteStats& site = m_lastFrameStats.m_topSites[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "      {\"site\": " << site.m_siteHash
+                 << ", \"allocations\": " << site.m_numAllocations
+                 << ", \"bytes\": " << site.m_bytesAllocated << "}";
+        };
+        json << "\n    ]\n";
+        json << "  },\n";
+
+        std::vector<std::uint64_t> siteHashes;
+        for (const AeAllocationSiteStats& site: m_lastFrameStats.m_topSites) {
+            siteHashes.push_back(site.m_siteHash);
+        };
+
+        json << "  \"liveAllocations\": [";
+        for (std::size_t i = 0; i < liveAllocations.size(); i++) {
+            const AeAllocationRecord& record = liveAllocations[i];
+            json << (i == 0 ? "\n" : ",\n");
+            json << "    {\"ptr\": " << addressToString(record.m_ptr)
+                 << ", \"size\": " << record.m_size
+                 << ", \"alignment\": " << record.m_alignment
+                 << ", \"tag\": \"" << getMemoryTagName(record.m_memoryTag) << "\""
+                 << ", \"site\": " << record.m_siteHash
+                 << ", \"frame\": " << record.m_frameNumber
+                 << ", \"sequence\": " << record.m_sequenceNumber << "}";
+            siteHashes.push_back(record.m_siteHash);
+        };
+        json << "\n  ],\n";
+
+        std::sort(siteHashes.begin(), siteHashes.end());
+        siteHashes.erase(std::unique(siteHashes.begin(), siteHashes.end()), siteHashes.end());
+
+        json << "  \"sites\": [";
+        for (std::size_t i = 0; i < siteHashes.size(); i++) {
+            std::vector<void*> callstack = getCallstack(siteHashes[i]);
+            json << (i == 0 ? "\n" : ",\n");
+            json << "    {\"site\": " << siteHashes[i] << ", \"callstack\": [";
+            for (std::size_t j = 0; j < callstack.size(); j++) {
+                json << (j == 0 ? "" : ", ") << addressToString(callstack[j]);
+            };
+            json << "]";
+#if defined(__GLIBC__) || defined(__APPLE__)
+            char** symbols = callstack.empty() ? nullptr :
+                             backtrace_symbols(callstack.data(), static_cast<int>(callstack.size()));
+            if (symbols != nullptr) {
+                json << ", \"symbols\": [";
+                for (std::size_t j = 0; j < callstack.size(); j++) {
+                    std::string symbol = symbols[j];
+                    std::replace(symbol.begin(), symbol.end(), '"', '\'');
+                    std::replace(symbol.begin(), symbol.end(), '\\', '/');
+                    json << (j == 0 ? "\"" : ", \"") << symbol << "\"";
+                };
+                json << "]";
+                free(symbols);
+            };
+#endif
+            json << "}";
+        };
+        json << "\n  ]\n";
+        json << "}\n";
+
+        return json.str();
+    };
+
+
+
+    // Write the JSON document to the file.
+    void AeAllocationTracker::writeJson(const std::string& t_filepath, std::uint64_t const t_marker) const {
+        std::ofstream file{t_filepath};
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open allocation dump file for writing: " + t_filepath);
+        };
+        file << toJson(t_marker);
+    };
+
+
+
+    // A call site's callstack is only written by the thread that claims its slot, later allocations from the same
+    // call site find the slot already taken.
+    std::uint64_t AeAllocationTracker::recordCallSite() noexcept {
+        void* callstack[MAX_CALLSTACK_DEPTH];
+        std::size_t depth = captureCallstack(callstack, MAX_CALLSTACK_DEPTH);
+        std::uint64_t siteHash = hashCallstack(callstack, depth);
+
+        for (std::size_t i = 0; i < SITE_CAPACITY; i++) {
+            SiteSlot& slot = m_sites[(siteHash + i) & (SITE_CAPACITY - 1)];
+            std::uint64_t slotSiteHash = slot.m_siteHash.load(std::memory_order_acquire);
+            if (slotSiteHash == siteHash) {
+                return siteHash;
+            };
+            if (slotSiteHash == 0 &&
+                slot.m_siteHash.compare_exchange_strong(slotSiteHash, siteHash, std::memory_order_acq_rel)) {
+                std::copy(callstack, callstack + depth, slot.m_callstack);
+                slot.m_depth = depth;
+                slot.m_isReady.store(true, std::memory_order_release);
+                return siteHash;
+            };
+            if (slotSiteHash == siteHash) {
+                return siteHash;
+            };
+        };
+
+        // The table of call sites is full, the allocation is still counted under its hash.
+        return siteHash;
+    };
+
+
+
+    // Allocations are aligned so the low bits of their addresses are discarded before mixing.
+    std::size_t AeAllocationTracker::getLiveSlotIndex(std::uintptr_t const t_ptr) noexcept {
+        std::uint64_t hash = static_cast<std::uint64_t>(t_ptr >> 3) * 11400714819323198485ull;
+        return static_cast<std::size_t>(hash >> 40) & (LIVE_ALLOCATION_CAPACITY - 1);
+    };
+
+} //namespace ae_memory
+
+#endif
@@ -0,0 +1,299 @@
+/// \file ae_allocation_tracker.hpp
+/// The AeAllocationTracker class and the allocation tracking macros are defined. Tracking is only compiled in when
+/// AE_MEMORY_TRACKING is defined, otherwise the macros expand to nothing.
+#pragma once
+
+// dependencies
+#include "ae_memory_budget.hpp"
+
+// libraries
+
+//std
+#include <cstdint>
+#include <cstdlib>
+
+#ifdef AE_MEMORY_TRACKING
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ae_memory {
+
+    /// The statistics of the allocations made from a single call site during a frame.
+    struct AeAllocationSiteStats {
+        /// The hash of the callstack of the call site.
+        std::uint64_t m_siteHash = 0;
+
+        /// The number of allocations made from the call site.
+        std::size_t m_numAllocations = 0;
+
+        /// The number of bytes allocated from the call site.
+        std::size_t m_bytesAllocated = 0;
+    };
+
+    /// The statistics of the allocations made during a frame.
+    struct AeAllocationFrameStats {
+        /// The number of the frame.
+        std::uint64_t m_frameNumber = 0;
+
+        /// The number of allocations made during the frame.
+        std::size_t m_numAllocations = 0;
+
+        /// The number of bytes allocated during the frame.
+        std::size_t m_bytesAllocated = 0;
+
+        /// The number of deallocations made during the frame.
+        std::size_t m_numDeallocations = 0;
+
+        /// The call sites that allocated the most bytes during the frame, largest first.
+        std::vector<AeAllocationSiteStats> m_topSites;
+
+        /// False if the frame made more allocations than the event ring holds, so the call sites only include the
+        /// allocations made at the end of the frame.
+        bool m_isComplete = true;
+    };
+
+    /// A live allocation.
+    struct AeAllocationRecord {
+        /// The allocated memory.
+        void* m_ptr = nullptr;
+
+        /// The size in bytes asked for.
+        std::size_t m_size = 0;
+
+        /// The alignment asked for.
+        std::size_t m_alignment = 0;
+
+        /// The memory tag of the budget the allocation was made through.
+        MemoryTag m_memoryTag = memoryTag_general;
+
+        /// The hash of the callstack of the call site.
+        std::uint64_t m_siteHash = 0;
+
+        /// The frame the allocation was made during.
+        std::uint64_t m_frameNumber = 0;
+
+        /// The order the allocation was made in, compared with a marker to find the allocations made after it.
+        std::uint64_t m_sequenceNumber = 0;
+    };
+
+    /// A AeAllocationTracker records every allocation made through a AeMemoryBudget, attributing it to its call site by
+    /// a hash of its callstack. Each live allocation is kept in a lock-free table, and every allocation is also written
+    /// to a lock-free ring of events that is summarised at the end of each frame into the allocations of the frame and
+    /// the call sites that allocated the most. The live allocations and the call sites can be dumped for offline
+    /// analysis, live allocations left after a marker show what was not freed. Lookups of the table only probe as far
+    /// as the longest probe any allocation has needed, so the slots of deallocated allocations can not make them scan
+    /// the whole table. There is a single tracker for the
+    /// process, and it is only compiled in when AE_MEMORY_TRACKING is defined.
+    class AeAllocationTracker {
+    public:
+
+        /// The most live allocations that can be tracked at once, further allocations are counted as dropped.
+        static constexpr std::size_t LIVE_ALLOCATION_CAPACITY = std::size_t{1} << 18;
+
+        /// The number of events the ring holds, older events are overwritten.
+        static constexpr std::size_t EVENT_CAPACITY = std::size_t{1} << 16;
+
+        /// The most distinct call sites that can be recorded.
+        static constexpr std::size_t SITE_CAPACITY = std::size_t{1} << 14;
+
+        /// The number of frames of the callstack kept for each call site.
+        static constexpr std::size_t MAX_CALLSTACK_DEPTH = 12;
+
+        /// The number of call sites kept in the statistics of a frame.
+        static constexpr std::size_t NUM_TOP_SITES = 10;
+
+        /// Gets the tracker of the process.
+        /// \return The allocation tracker.
+        static AeAllocationTracker& getInstance();
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeAllocationTracker(const AeAllocationTracker&) = delete;
+        AeAllocationTracker& operator=(const AeAllocationTracker&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeAllocationTracker(AeAllocationTracker&&) = delete;
+        AeAllocationTracker& operator=(AeAllocationTracker&&) = delete;
+
+        /// Records an allocation and the call site it was made from.
+        /// \param t_ptr The allocated memory.
+        /// \param t_size The size in bytes asked for.
+        /// \param t_alignment The alignment asked for.
+        /// \param t_memoryTag The memory tag of the budget the allocation was made through.
+        void recordAllocation(void* t_ptr, std::size_t t_size, std::size_t t_alignment, MemoryTag t_memoryTag) noexcept;
+
+        /// Records a deallocation, memory that was not tracked when it was allocated is ignored.
+        /// \param t_ptr The deallocated memory.
+        void recordDeallocation(void* t_ptr) noexcept;
+
+        /// Summarises the allocations made since the last frame ended and starts a new frame. Must only be called from
+        /// a single thread.
+        void endFrame();
+
+        /// Gets the statistics of the last frame that ended.
+        /// \return The frame statistics.
+        [[nodiscard]] const AeAllocationFrameStats& getLastFrameStats() const { return m_lastFrameStats; };
+
+        /// Gets a marker of the allocations made so far, to later find the allocations made after it.
+        /// \return The marker.
+        [[nodiscard]] std::uint64_t getMarker() const noexcept;
+
+        /// Gets the live allocations that were made after a marker, such as the allocations still live after an asset
+        /// that was loaded after the marker has been unloaded.
+        /// \param t_marker The marker, 0 for every live allocation.
+        /// \return The live allocations, oldest first.
+        [[nodiscard]] std::vector<AeAllocationRecord> getLiveAllocations(std::uint64_t t_marker = 0) const;
+
+        /// Gets the callstack recorded for a call site.
+        /// \param t_siteHash The hash of the callstack of the call site.
+        /// \return The return addresses of the callstack, innermost first, empty if the call site is not known.
+        [[nodiscard]] std::vector<void*> getCallstack(std::uint64_t t_siteHash) const;
+
+        /// Gets the number of allocations that were not tracked because the table of live allocations was full.
+        /// \return The number of dropped allocations.
+        [[nodiscard]] std::size_t getNumDroppedAllocations() const noexcept;
+
+        /// Gets the longest probe an allocation has needed to find a slot of the table of live allocations, which
+        /// bounds how far deallocations search.
+        /// \return The longest probe length.
+        [[nodiscard]] std::size_t getLongestProbeLength() const noexcept;
+
+        /// Converts the live allocations made after a marker, the call sites they were made from, and the statistics
+        /// of the last frame to a JSON document.
+        /// \param t_marker The marker, 0 for every live allocation.
+        /// \return The JSON document.
+        [[nodiscard]] std::string toJson(std::uint64_t t_marker = 0) const;
+
+        /// Writes the dump to a file as JSON.
+        /// \param t_filepath The path of the file to write.
+        /// \param t_marker The marker, 0 for every live allocation.
+        void writeJson(const std::string& t_filepath, std::uint64_t t_marker = 0) const;
+
+    private:
+
+        /// A slot of the table of live allocations. The key is claimed before the record is written and published
+        /// after. Each field of the record is atomic so a record being replaced can be read without a data race, the
+        /// version tells a reader whether the record changed while it was copied.
+        struct LiveSlot {
+            /// The allocated memory, or one of the empty, claimed, or removed keys.
+            std::atomic<std::uintptr_t> m_key{0};
+
+            /// The number of times the record has started or finished being written, odd while it is being written.
+            std::atomic<std::uint64_t> m_version{0};
+
+            /// The size in bytes asked for.
+            std::atomic<std::size_t> m_size{0};
+
+            /// The alignment asked for.
+            std::atomic<std::size_t> m_alignment{0};
+
+            /// The memory tag of the budget the allocation was made through.
+            std::atomic<MemoryTag> m_memoryTag{memoryTag_general};
+
+            /// The hash of the callstack of the call site.
+            std::atomic<std::uint64_t> m_siteHash{0};
+
+            /// The frame the allocation was made during.
+            std::atomic<std::uint64_t> m_frameNumber{0};
+
+            /// The order the allocation was made in.
+            std::atomic<std::uint64_t> m_sequenceNumber{0};
+        };
+
+        /// An entry of the ring of events. Each field is atomic so an entry being overwritten can be read without a
+        /// data race, the sequence number tells a reader whether the entry is the one it expected.
+        struct Event {
+            /// One more than the index of the event the entry holds, 0 while it is being written.
+            std::atomic<std::uint64_t> m_sequence{0};
+
+            /// The size in bytes allocated.
+            std::atomic<std::size_t> m_size{0};
+
+            /// The hash of the callstack of the call site.
+            std::atomic<std::uint64_t> m_siteHash{0};
+        };
+
+        /// A slot of the table of call sites.
+        struct SiteSlot {
+            /// The hash of the callstack, 0 if the slot is empty.
+            std::atomic<std::uint64_t> m_siteHash{0};
+
+            /// If the callstack has been written.
+            std::atomic<bool> m_isReady{false};
+
+            /// The number of return addresses in the callstack.
+            std::size_t m_depth = 0;
+
+            /// The return addresses of the callstack, innermost first.
+            void* m_callstack[MAX_CALLSTACK_DEPTH] = {};
+        };
+
+        /// Constructor of AeAllocationTracker.
+        AeAllocationTracker();
+
+        /// Records the call site of the allocation being made, the frames of the tracker and the budget are skipped.
+        /// \return The hash of the callstack.
+        std::uint64_t recordCallSite() noexcept;
+
+        /// Gets the slot of the table of live allocations an address starts probing from.
+        /// \param t_ptr The address.
+        /// \return The index of the slot.
+        static std::size_t getLiveSlotIndex(std::uintptr_t t_ptr) noexcept;
+
+        /// The table of live allocations.
+        std::unique_ptr<LiveSlot[]> m_liveAllocations;
+
+        /// The ring of allocation events.
+        std::unique_ptr<Event[]> m_events;
+
+        /// The table of call sites.
+        std::unique_ptr<SiteSlot[]> m_sites;
+
+        /// The index of the next event to write, also the number of allocations made.
+        std::atomic<std::uint64_t> m_nextEvent{0};
+
+        /// The index of the first event of the current frame.
+        std::uint64_t m_frameFirstEvent = 0;
+
+        /// The number of the current frame.
+        std::atomic<std::uint64_t> m_frameNumber{0};
+
+        /// The number of deallocations made during the current frame.
+        std::atomic<std::size_t> m_frameNumDeallocations{0};
+
+        /// The number of bytes allocated during the current frame.
+        std::atomic<std::size_t> m_frameBytesAllocated{0};
+
+        /// The number of allocations that were not tracked because the table of live allocations was full.
+        std::atomic<std::size_t> m_numDroppedAllocations{0};
+
+        /// The longest probe an allocation has needed to find a slot, no allocation is further from its first slot.
+        std::atomic<std::size_t> m_longestProbeLength{0};
+
+        /// The statistics of the last frame that ended.
+        AeAllocationFrameStats m_lastFrameStats;
+
+    protected:
+
+    };
+} // namespace ae_memory
+
+/// Records an allocation made through a memory budget.
+#define AE_MEMORY_TRACK_ALLOCATION(t_ptr, t_size, t_alignment, t_memoryTag) \
+    ae_memory::AeAllocationTracker::getInstance().recordAllocation(t_ptr, t_size, t_alignment, t_memoryTag)
+
+/// Records a deallocation made through a memory budget.
+#define AE_MEMORY_TRACK_DEALLOCATION(t_ptr) ae_memory::AeAllocationTracker::getInstance().recordDeallocation(t_ptr)
+
+/// Ends the frame of the allocation tracker.
+#define AE_MEMORY_TRACK_END_FRAME() ae_memory::AeAllocationTracker::getInstance().endFrame()
+
+#else
+
+#define AE_MEMORY_TRACK_ALLOCATION(t_ptr, t_size, t_alignment, t_memoryTag) ((void)0)
+#define AE_MEMORY_TRACK_DEALLOCATION(t_ptr) ((void)0)
+#define AE_MEMORY_TRACK_END_FRAME() ((void)0)
+
+#endif
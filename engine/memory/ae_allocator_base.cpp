@@ -7,6 +7,7 @@
 // libraries
 
 // std
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -26,6 +27,18 @@ namespace ae_memory {
 
 
 
+    double AeAllocatorBase::getFragmentation() const {
+        std::size_t memoryInUse = getMemoryInUse();
+        if (memoryInUse >= m_allocatedMemorySize) {
+            return 0.0;
+        };
+
+        double freeMemory = static_cast<double>(m_allocatedMemorySize - memoryInUse);
+        return std::clamp(1.0 - static_cast<double>(getLargestFreeBlock()) / freeMemory, 0.0, 1.0);
+    };
+
+
+
     std::size_t AeAllocatorBase::getAllocatedMemorySize() const {
         return m_allocatedMemorySize;
     };
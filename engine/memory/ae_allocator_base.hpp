@@ -44,6 +44,20 @@ namespace ae_memory {
         /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
         virtual void deallocate(void* t_allocatedMemoryPtr)=0;
 
+        /// Gets the number of bytes currently allocated, including the overhead the allocator has for each allocation.
+        /// \return The number of bytes in use.
+        [[nodiscard]] virtual std::size_t getMemoryInUse() const = 0;
+
+        /// Gets the largest allocation with the default alignment that could currently succeed.
+        /// \return The size in bytes of the largest free block.
+        [[nodiscard]] virtual std::size_t getLargestFreeBlock() const = 0;
+
+        /// Gets how fragmented the free memory is, by default one minus the share of the free memory that is in the
+        /// largest free block.
+        /// \return The fragmentation, from 0 when the free memory can serve any allocation it fits to nearly 1 when it
+        /// is split into many small blocks.
+        [[nodiscard]] virtual double getFragmentation() const;
+
         /// Gets the size of the pre-allocated memory block that was given to this allocator to manage.
         [[nodiscard]] std::size_t getAllocatedMemorySize() const;
 
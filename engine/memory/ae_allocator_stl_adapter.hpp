@@ -53,14 +53,18 @@ namespace ae_memory {
             return m_allocator.getAllocatedMemorySize();
         };
 
-        bool operator==(const AeAllocatorStlAdaptor<T,Alloc>& rhs) const noexcept
+        /// Adapters are equal when they use the same allocator, since memory allocated by one can then be deallocated
+        /// by the other.
+        template<typename U>
+        bool operator==(const AeAllocatorStlAdaptor<U,Alloc>& rhs) const noexcept
         {
-            return *this == rhs;
+            return &m_allocator == &rhs.m_allocator;
         };
 
-        bool operator!=(const AeAllocatorStlAdaptor<T,Alloc>& rhs) const noexcept
+        template<typename U>
+        bool operator!=(const AeAllocatorStlAdaptor<U,Alloc>& rhs) const noexcept
         {
-            return *this != rhs;
+            return !(*this == rhs);
         };
 
         Alloc& m_allocator;
@@ -7,6 +7,7 @@
 // libraries
 
 // std
+#include <algorithm>
 #include <cassert>
 
 namespace ae_memory {
@@ -25,6 +26,16 @@ namespace ae_memory {
 
 
 
+    AeDeStackAllocator::AeDeStackAllocator(AeVirtualMemoryArena& t_arena) noexcept :
+    AeDeStackAllocator(t_arena.getReservedSize(),t_arena.getReservedMemoryPtr()){
+        // Nothing is committed until either portion of the stack grows.
+        m_arena = &t_arena;
+        m_bottomCommittedPtr = m_allocatedMemoryPtr;
+        m_topCommittedPtr = m_allocatedMemoryTopPtr;
+    };
+
+
+
     AeDeStackAllocator::~AeDeStackAllocator() noexcept{
         clearDoubleEndedStack();
         m_bottomStackPtr = nullptr;
@@ -57,6 +68,19 @@ namespace ae_memory {
 
 
 
+    void AeDeStackAllocator::decommitUnusedMemory() noexcept {
+        if(m_arena == nullptr){
+            return;
+        }
+
+        // The arena only decommits whole chunks so the chunks holding either end of the stack stay committed.
+        m_arena->decommit(m_bottomStackPtr, pointerDifference(m_topStackPtr, m_bottomStackPtr));
+        m_bottomCommittedPtr = std::min(m_bottomCommittedPtr, m_arena->alignUpToCommitGranularity(m_bottomStackPtr));
+        m_topCommittedPtr = std::max(m_topCommittedPtr, m_arena->alignDownToCommitGranularity(m_topStackPtr));
+    }
+
+
+
     //==================================================================================================================
     // Bottom Stack Functions
     //==================================================================================================================
@@ -74,6 +98,14 @@ namespace ae_memory {
             throw std::bad_alloc();
         }
 
+        // Commit the memory the bottom-up portion of the stack is growing into if it is allocated from a virtual
+        // memory arena.
+        void* newBottomStackPtr = addToPointer(totalAllocation, m_bottomStackPtr);
+        if(m_arena != nullptr && newBottomStackPtr > m_bottomCommittedPtr){
+            m_arena->commit(m_bottomCommittedPtr, pointerDifference(newBottomStackPtr, m_bottomCommittedPtr));
+            m_bottomCommittedPtr = m_arena->alignUpToCommitGranularity(newBottomStackPtr);
+        }
+
         // Get the aligned address.
         void* alignedAddress = addToPointer(alignmentOffset, m_bottomStackPtr);
 
@@ -151,9 +183,17 @@ namespace ae_memory {
             throw std::bad_alloc();
         };
 
+        // Commit the memory the top-down portion of the stack is growing into if it is allocated from a virtual memory
+        // arena.
+        void* newTopStackPtr = subtractFromPointer(alignmentOffset, unalignedAddress);
+        if(m_arena != nullptr && newTopStackPtr < m_topCommittedPtr){
+            m_arena->commit(newTopStackPtr, pointerDifference(m_topCommittedPtr, newTopStackPtr));
+            m_topCommittedPtr = m_arena->alignDownToCommitGranularity(newTopStackPtr);
+        };
+
         // The bottom of stack pointer is the same as the aligned address in the case of the top-down portion of the
         // stack.
-        m_topStackPtr = subtractFromPointer(alignmentOffset, unalignedAddress);
+        m_topStackPtr = newTopStackPtr;
 
         // Track the additional memory used.
         m_topStackMemoryUsage += totalAllocation;
@@ -4,6 +4,7 @@
 
 // dependencies
 #include "ae_allocator_base.hpp"
+#include "ae_virtual_memory_arena.hpp"
 
 // libraries
 
@@ -32,6 +33,11 @@ namespace ae_memory {
         /// Constructor of AeStackAllocator.
         AeDeStackAllocator(std::size_t t_allocatedMemorySize, void* t_allocatedMemoryPtr) noexcept;
 
+        /// Constructor of AeDeStackAllocator managing a virtual memory arena. Memory is committed to the arena as
+        /// either end of the stack grows into it.
+        /// \param t_arena The arena the stack is allocated from, it must outlive the stack allocator.
+        explicit AeDeStackAllocator(AeVirtualMemoryArena& t_arena) noexcept;
+
         /// Destructor of the AeStackAllocator.
         ~AeDeStackAllocator() noexcept override;
 
@@ -54,6 +60,22 @@ namespace ae_memory {
         /// Deallocates all the memory in the stack.
         void clearDoubleEndedStack() noexcept;
 
+        /// Gets the number of bytes allocated by both portions of the stack, including alignment padding.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const noexcept override {
+            return m_bottomStackMemoryUsage + m_topStackMemoryUsage;
+        };
+
+        /// Gets the memory left between the two portions of the stack, it is never fragmented.
+        /// \return The number of bytes free.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const noexcept override {
+            return m_allocatedMemorySize - getMemoryInUse();
+        };
+
+        /// Returns the memory committed to the virtual memory arena between the two ends of the stack to the operating
+        /// system. Does nothing if the stack is not allocated from a virtual memory arena.
+        void decommitUnusedMemory() noexcept;
+
         /// Implements the equals comparison operator.
         bool operator==(const AeDeStackAllocator&) const noexcept { return true;};
 
@@ -123,5 +145,14 @@ namespace ae_memory {
         /// A pointer to the top of the allocated memory for quick reference when doing math for the top-down portion of
         /// the stack.
         void* m_allocatedMemoryTopPtr;
+
+        /// The virtual memory arena the stack is allocated from, nullptr if the memory was given to the stack.
+        AeVirtualMemoryArena* m_arena = nullptr;
+
+        /// The end of the memory committed for the bottom-up portion of the stack.
+        void* m_bottomCommittedPtr = nullptr;
+
+        /// The start of the memory committed for the top-down portion of the stack.
+        void* m_topCommittedPtr = nullptr;
     };
 } // namespace ae_memory
\ No newline at end of file
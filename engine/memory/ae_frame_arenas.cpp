@@ -0,0 +1,54 @@
+/// \file ae_frame_arenas.cpp
+/// The AeFrameArenas class is implemented.
+#include "ae_frame_arenas.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace ae_memory {
+
+    // Allocate the memory for all the arenas at once and split it evenly between the frames.
+    AeFrameArenas::AeFrameArenas(std::size_t const t_numFrames, std::size_t const t_arenaSize) :
+            m_arenaSize{t_arenaSize} {
+
+        assert(t_numFrames > 0 && "AeFrameArenas requires at least one frame!");
+
+        m_arenaMemory = malloc(t_numFrames * t_arenaSize);
+        if (m_arenaMemory == nullptr) {
+            throw std::bad_alloc();
+        };
+
+        m_arenas.reserve(t_numFrames);
+        for (std::size_t i = 0; i < t_numFrames; i++) {
+            m_arenas.push_back(std::make_unique<AeStackAllocator>(
+                    t_arenaSize,
+                    AeAllocatorBase::addToPointer(i * t_arenaSize, m_arenaMemory)));
+        };
+    };
+
+
+
+    AeFrameArenas::~AeFrameArenas() {
+        m_arenas.clear();
+        free(m_arenaMemory);
+        m_arenaMemory = nullptr;
+    };
+
+
+
+    // Record how much the frame used the last time it was in flight before freeing it.
+    void AeFrameArenas::beginFrame(std::size_t const t_frameIndex) noexcept {
+        assert(t_frameIndex < m_arenas.size() && "Frame index is larger than the number of frame arenas!");
+
+        m_currentFrameIndex = t_frameIndex;
+        m_highWaterMark = std::max(m_highWaterMark, m_arenas[m_currentFrameIndex]->getMemoryInUse());
+        m_arenas[m_currentFrameIndex]->clearStack();
+    };
+
+} //namespace ae_memory
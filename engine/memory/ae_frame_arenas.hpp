@@ -0,0 +1,109 @@
+/// \file ae_frame_arenas.hpp
+/// The AeFrameArenas class and the FrameAlloc and FrameVector types are defined.
+#pragma once
+
+// dependencies
+#include "ae_stack_allocator.hpp"
+#include "ae_allocator_stl_adapter.hpp"
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace ae_memory {
+
+    /// The STL adaptor for memory allocated from a frame arena.
+    template<typename T>
+    using FrameAlloc = AeAllocatorStlAdaptor<T, AeStackAllocator>;
+
+    /// A vector whose memory is allocated from a frame arena. Its memory is only valid until the arena it was allocated
+    /// from is reset, and growing it leaves the old memory allocated in the arena until then, so reserve when the size
+    /// is known.
+    template<typename T>
+    using FrameVector = std::vector<T, FrameAlloc<T>>;
+
+    /// A AeFrameArenas implements a linear arena for each frame in flight, so memory that is only needed for a frame
+    /// can be allocated without using the heap. A frame's arena is reset when the frame begins again, the ECS begins a
+    /// frame each time it runs its systems, so the previous frame's arena is still intact while the current frame
+    /// runs. Frames are not tied to the GPU's fences, so data the GPU consumes must not live in the arenas.
+    class AeFrameArenas {
+    public:
+
+        /// Constructor of AeFrameArenas.
+        /// \param t_numFrames The number of frames in flight, an arena is created for each.
+        /// \param t_arenaSize The size in bytes of each frame's arena.
+        AeFrameArenas(std::size_t t_numFrames, std::size_t t_arenaSize);
+
+        /// Destructor of AeFrameArenas.
+        ~AeFrameArenas();
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeFrameArenas(const AeFrameArenas&) = delete;
+        AeFrameArenas& operator=(const AeFrameArenas&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeFrameArenas(AeFrameArenas&&) = delete;
+        AeFrameArenas& operator=(AeFrameArenas&&) = delete;
+
+        /// Makes the frame's arena the current arena and resets it, freeing everything allocated from the arena the
+        /// last time the frame was current.
+        /// \param t_frameIndex The index of the frame that is beginning.
+        void beginFrame(std::size_t t_frameIndex) noexcept;
+
+        /// Gets the arena of the current frame.
+        /// \return The current frame's arena.
+        AeStackAllocator& getCurrentArena() { return *m_arenas[m_currentFrameIndex]; };
+
+        /// Gets the arena of the frame before the current frame, its memory remains valid during the current frame.
+        /// \return The previous frame's arena.
+        AeStackAllocator& getPreviousArena() {
+            return *m_arenas[(m_currentFrameIndex + m_arenas.size() - 1) % m_arenas.size()];
+        };
+
+        /// Gets the arena of a frame.
+        /// \param t_frameIndex The index of the frame.
+        /// \return The frame's arena.
+        AeStackAllocator& getArena(std::size_t t_frameIndex) { return *m_arenas[t_frameIndex]; };
+
+        /// Creates an empty vector allocating from the current frame's arena.
+        /// \tparam T The type of the elements of the vector.
+        /// \return The empty vector.
+        template<typename T>
+        FrameVector<T> makeVector() { return FrameVector<T>(FrameAlloc<T>(getCurrentArena())); };
+
+        /// Gets the number of frames there are arenas for.
+        /// \return The number of frames in flight.
+        [[nodiscard]] std::size_t getNumFrames() const { return m_arenas.size(); };
+
+        /// Gets the size of each frame's arena.
+        /// \return The size in bytes of an arena.
+        [[nodiscard]] std::size_t getArenaSize() const { return m_arenaSize; };
+
+        /// Gets the most memory a frame has used from its arena, measured each time an arena is reset.
+        /// \return The largest number of bytes used by a frame.
+        [[nodiscard]] std::size_t getHighWaterMark() const { return m_highWaterMark; };
+
+    private:
+
+        /// The size in bytes of each frame's arena.
+        std::size_t m_arenaSize;
+
+        /// The memory of all the arenas.
+        void* m_arenaMemory;
+
+        /// The arena of each frame.
+        std::vector<std::unique_ptr<AeStackAllocator>> m_arenas;
+
+        /// The index of the frame currently being allocated for.
+        std::size_t m_currentFrameIndex = 0;
+
+        /// The most memory a frame has used from its arena.
+        std::size_t m_highWaterMark = 0;
+
+    protected:
+
+    };
+} // namespace ae_memory
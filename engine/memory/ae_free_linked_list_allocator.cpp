@@ -85,6 +85,18 @@ namespace ae_memory {
     };
 
 
+    // The free list is not ordered by size so every free chunk has to be checked.
+    std::size_t AeFreeLinkedListAllocator::getLargestFreeChunk() const {
+        std::size_t largestChunkSize = 0;
+        for (FreeChunkInfo* chunk = m_firstFreeChunkPtr; chunk != nullptr; chunk = chunk->m_nextFreeChunk) {
+            if (chunk->m_chunkSize > largestChunkSize) {
+                largestChunkSize = chunk->m_chunkSize;
+            };
+        };
+        return largestChunkSize;
+    };
+
+
     void *AeFreeLinkedListAllocator::getBestFit(std::size_t const t_allocationSize,
                                                 std::size_t const t_byteAlignment) {
 
@@ -106,13 +118,17 @@ namespace ae_memory {
         //  track of the number of free blocks available.
         while (m_currentFreeChunk != nullptr) {
 
-            // Get the pointer for this allocation, use the newFreeChunk
-            m_pointerCalculation = getAlignedAddressWithMinimumOffset(m_currentFreeChunk, sizeof(AllocatedChunkInfo),
-                                                                      t_byteAlignment);
+            // Calculate the offset the aligned address would have in this chunk. The aligned address is not created
+            // here since that stores the offset in the chunk, which would overwrite the chunk following this one when
+            // this chunk is too small.
+            m_pointerCalculation = addToPointer(sizeof(AllocatedChunkInfo), m_currentFreeChunk);
+            std::size_t alignmentOffset = getAlignmentOffset(m_pointerCalculation, t_byteAlignment);
+            if (alignmentOffset == 0) {
+                alignmentOffset = t_byteAlignment;
+            };
 
             // Calculate the full allocation size including the allocation information and the alignment offset.
-            m_fullAllocationSize = t_allocationSize +
-                                   pointerDifference(m_pointerCalculation, m_currentFreeChunk);
+            m_fullAllocationSize = t_allocationSize + sizeof(AllocatedChunkInfo) + alignmentOffset;
 
             // See if the allocation
             if (m_currentFreeChunk->m_chunkSize >= m_fullAllocationSize) {
@@ -130,6 +146,9 @@ namespace ae_memory {
                     m_newFreeChunk->m_chunkSize = m_currentFreeChunk->m_chunkSize - m_fullAllocationSize;
                     m_newFreeChunk->m_nextFreeChunk = m_currentFreeChunk->m_nextFreeChunk;
 
+                    // The chunk split off is a new free chunk.
+                    m_numFreeChunks += 1;
+
                     // Make the previous chunk now point to the new chunk instead of the current one.
                     if (m_prevFreeChunk != nullptr) {
                         m_prevFreeChunk->m_nextFreeChunk = m_newFreeChunk;
@@ -143,7 +162,6 @@ namespace ae_memory {
                     // chunk is being allocated.
                     if (m_prevFreeChunk != nullptr) {
                         m_prevFreeChunk->m_nextFreeChunk = m_currentFreeChunk->m_nextFreeChunk;
-                        m_firstFreeChunkPtr = m_prevFreeChunk;
 
                     } else if (m_numFreeChunks == 0) {
                         // If there are no more chunks to give out then set the next free chunk pointer to nullptr.
@@ -40,6 +40,22 @@ namespace ae_memory {
         /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
         void deallocate(void* t_allocatedMemoryPtr) noexcept override;
 
+        /// Gets the number of bytes currently allocated, including the chunk information and alignment padding.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const override { return m_memoryInUse; };
+
+        /// Gets the number of free chunks.
+        /// \return The number of free chunks.
+        [[nodiscard]] std::size_t getNumFreeChunks() const { return m_numFreeChunks; };
+
+        /// Gets the size of the largest free chunk, walks the entire free list.
+        /// \return The size of the largest free chunk in bytes.
+        [[nodiscard]] std::size_t getLargestFreeChunk() const;
+
+        /// Gets the size of the largest free chunk, walks the entire free list.
+        /// \return The size of the largest free chunk in bytes.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const override { return getLargestFreeChunk(); };
+
         /// Implements the equals comparison operator.
         bool operator==(const AeFreeLinkedListAllocator&) const noexcept { return true;};
 
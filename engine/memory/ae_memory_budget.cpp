@@ -0,0 +1,223 @@
+/// \file ae_memory_budget.cpp
+/// The AeMemoryBudget class is implemented.
+#include "ae_memory_budget.hpp"
+
+// dependencies
+#include "ae_allocation_tracker.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+namespace ae_memory {
+
+    const char* getMemoryTagName(MemoryTag const t_memoryTag) {
+        switch (t_memoryTag) {
+            case memoryTag_general: return "general";
+            case memoryTag_ecs: return "ecs";
+            case memoryTag_rendering: return "rendering";
+            case memoryTag_assets: return "assets";
+            case memoryTag_frame: return "frame";
+            case memoryTag_scratch: return "scratch";
+            default: return "unknown";
+        };
+    };
+
+
+
+    // A budget is added to its parent's children, and starts with the memory its allocator already has in use.
+    AeMemoryBudget::AeMemoryBudget(std::string t_name,
+                                   MemoryTag const t_memoryTag,
+                                   std::size_t const t_budget,
+                                   AeAllocatorBase* const t_allocator,
+                                   AeMemoryBudget* const t_parent,
+                                   MemoryBudgetOverrun const t_overrunPolicy):
+            AeAllocatorBase(t_allocator == nullptr ? 0 : t_allocator->getAllocatedMemorySize(),
+                            t_allocator == nullptr ? nullptr : t_allocator->getAllocatedMemoryPtr()),
+            m_name{std::move(t_name)},
+            m_memoryTag{t_memoryTag},
+            m_budget{t_budget},
+            m_allocator{t_allocator},
+            m_parent{t_parent},
+            m_overrunPolicy{t_overrunPolicy} {
+
+        if (m_parent != nullptr) {
+            if (!m_parent->isGroup()) {
+                throw std::runtime_error("Memory budget " + m_name + " can only be added below a group!");
+            };
+            m_parent->m_children.push_back(this);
+        };
+
+        update();
+    };
+
+
+
+    AeMemoryBudget::~AeMemoryBudget() noexcept {
+        m_children.clear();
+        m_allocator = nullptr;
+        m_parent = nullptr;
+    };
+
+
+
+    // The memory used by the allocation is measured from the allocator so its overhead and rounding are included.
+    void* AeMemoryBudget::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+        if (m_allocator == nullptr) {
+            throw std::runtime_error("Memory budget " + m_name + " is a group and can not allocate!");
+        };
+
+        std::size_t memoryInUseBefore = m_allocator->getMemoryInUse();
+        void* allocation = m_allocator->allocate(t_allocationSize, t_byteAlignment);
+        addMemoryInUse(static_cast<std::ptrdiff_t>(m_allocator->getMemoryInUse() - memoryInUseBefore), true);
+        AE_MEMORY_TRACK_ALLOCATION(allocation, t_allocationSize, t_byteAlignment, m_memoryTag);
+
+        return allocation;
+    };
+
+
+
+    void AeMemoryBudget::deallocate(void* const t_allocatedMemoryPtr) noexcept {
+        assert(m_allocator != nullptr && "Memory budget is a group and can not deallocate!");
+
+        AE_MEMORY_TRACK_DEALLOCATION(t_allocatedMemoryPtr);
+        std::size_t memoryInUseBefore = m_allocator->getMemoryInUse();
+        m_allocator->deallocate(t_allocatedMemoryPtr);
+        addMemoryInUse(-static_cast<std::ptrdiff_t>(memoryInUseBefore - m_allocator->getMemoryInUse()), false);
+    };
+
+
+
+    std::size_t AeMemoryBudget::getLargestFreeBlock() const {
+        if (m_allocator != nullptr) {
+            return m_allocator->getLargestFreeBlock();
+        };
+
+        std::size_t largestFreeBlock = 0;
+        for (const AeMemoryBudget* child: m_children) {
+            largestFreeBlock = std::max(largestFreeBlock, child->getLargestFreeBlock());
+        };
+        return largestFreeBlock;
+    };
+
+
+
+    // Measure the budget and every budget below it, then pass the change on to the budgets above it.
+    void AeMemoryBudget::update() {
+        std::size_t previousMemoryInUse = m_memoryInUse;
+        measureMemoryInUse();
+
+        if (m_parent != nullptr) {
+            m_parent->addMemoryInUse(static_cast<std::ptrdiff_t>(m_memoryInUse - previousMemoryInUse), false);
+        };
+    };
+
+
+
+    AeMemoryBudgetStats AeMemoryBudget::getStats() const {
+        AeMemoryBudgetStats stats;
+        stats.m_capacity = getCapacity();
+        stats.m_budget = m_budget;
+        stats.m_memoryInUse = m_memoryInUse;
+        stats.m_highWaterMark = m_highWaterMark;
+        stats.m_numAllocations = m_numAllocations;
+        stats.m_numOverruns = m_numOverruns;
+        stats.m_largestFreeBlock = getLargestFreeBlock();
+        stats.m_fragmentation = getFragmentation();
+        return stats;
+    };
+
+
+
+    // The free memory of a group is split between its allocators anyway, so a group's fragmentation is that of its
+    // children weighted by their free memory.
+    double AeMemoryBudget::getFragmentation() const {
+        if (m_allocator != nullptr) {
+            return m_allocator->getFragmentation();
+        };
+
+        double freeMemory = 0.0;
+        double fragmentedMemory = 0.0;
+        for (const AeMemoryBudget* child: m_children) {
+            std::size_t capacity = child->getCapacity();
+            double childFreeMemory = capacity > child->m_memoryInUse ?
+                                     static_cast<double>(capacity - child->m_memoryInUse) : 0.0;
+            freeMemory += childFreeMemory;
+            fragmentedMemory += child->getFragmentation() * childFreeMemory;
+        };
+
+        return freeMemory > 0.0 ? fragmentedMemory / freeMemory : 0.0;
+    };
+
+
+
+    void AeMemoryBudget::addMemoryInUse(std::ptrdiff_t const t_memoryInUseChange, bool const t_isAllocation) noexcept {
+        for (AeMemoryBudget* budget = this; budget != nullptr; budget = budget->m_parent) {
+            budget->m_memoryInUse = static_cast<std::size_t>(
+                    static_cast<std::ptrdiff_t>(budget->m_memoryInUse) + t_memoryInUseChange);
+            if (t_isAllocation) {
+                budget->m_numAllocations += 1;
+            };
+            budget->checkBudget();
+        };
+    };
+
+
+
+    // A group's memory in use is the total of its children's.
+    std::size_t AeMemoryBudget::measureMemoryInUse() {
+        if (m_allocator != nullptr) {
+            m_memoryInUse = m_allocator->getMemoryInUse();
+        } else {
+            m_memoryInUse = 0;
+            for (AeMemoryBudget* child: m_children) {
+                m_memoryInUse += child->measureMemoryInUse();
+            };
+        };
+
+        checkBudget();
+        return m_memoryInUse;
+    };
+
+
+
+    // Only the change from being within the budget to being over it is reported, not every allocation while over it.
+    void AeMemoryBudget::checkBudget() noexcept {
+        m_highWaterMark = std::max(m_highWaterMark, m_memoryInUse);
+
+        if (m_budget == 0 || m_memoryInUse <= m_budget) {
+            m_isOverBudget = false;
+            return;
+        };
+
+        if (m_isOverBudget) {
+            return;
+        };
+        m_isOverBudget = true;
+        m_numOverruns += 1;
+
+        std::cerr << "memory budget: " << m_name << " (" << getMemoryTagName(m_memoryTag) << ") has " << m_memoryInUse
+                  << " bytes in use, over its budget of " << m_budget << " bytes." << std::endl;
+        assert((m_overrunPolicy != memoryBudgetOverrun_assert) && "Memory budget exceeded!");
+    };
+
+
+
+    std::size_t AeMemoryBudget::getCapacity() const {
+        if (m_allocator != nullptr) {
+            return m_allocator->getAllocatedMemorySize();
+        };
+
+        std::size_t capacity = 0;
+        for (const AeMemoryBudget* child: m_children) {
+            capacity += child->getCapacity();
+        };
+        return capacity;
+    };
+
+} //namespace ae_memory
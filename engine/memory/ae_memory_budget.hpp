@@ -0,0 +1,217 @@
+/// \file ae_memory_budget.hpp
+/// The AeMemoryBudget class and the memory tags are defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace ae_memory {
+
+    /// The categories memory is tagged with, every allocation made through a AeMemoryBudget is counted in the tag of
+    /// the budget.
+    enum MemoryTag {
+        /// Memory that does not belong to one of the other categories.
+        memoryTag_general = 0,
+        /// Memory used by the entity component system.
+        memoryTag_ecs,
+        /// Memory used by the renderer.
+        memoryTag_rendering,
+        /// Memory used by loaded assets such as models and images.
+        memoryTag_assets,
+        /// Memory that is only needed for a frame.
+        memoryTag_frame,
+        /// Temporary memory that is freed soon after it is allocated.
+        memoryTag_scratch,
+        /// The number of memory tags.
+        memoryTag_count
+    };
+
+    /// Gets the name of a memory tag.
+    /// \param t_memoryTag The memory tag.
+    /// \return The name of the memory tag.
+    const char* getMemoryTagName(MemoryTag t_memoryTag);
+
+    /// What is done when a budget is exceeded.
+    enum MemoryBudgetOverrun {
+        /// The overrun is logged, once each time the memory in use goes from within the budget to over it.
+        memoryBudgetOverrun_log = 0,
+        /// The overrun is logged and then asserts, so it is caught while debugging.
+        memoryBudgetOverrun_assert
+    };
+
+    /// Statistics of a single budget.
+    struct AeMemoryBudgetStats {
+        /// The size in bytes of the memory of the budget's allocator, or of all the allocators below a group.
+        std::size_t m_capacity = 0;
+
+        /// The number of bytes the budget allows to be in use, 0 if the budget is not limited.
+        std::size_t m_budget = 0;
+
+        /// The number of bytes currently in use.
+        std::size_t m_memoryInUse = 0;
+
+        /// The most bytes that have been in use at once.
+        std::size_t m_highWaterMark = 0;
+
+        /// The number of allocations made through the budget.
+        std::size_t m_numAllocations = 0;
+
+        /// The number of times the budget has been exceeded.
+        std::size_t m_numOverruns = 0;
+
+        /// The size in bytes of the largest free block.
+        std::size_t m_largestFreeBlock = 0;
+
+        /// How fragmented the free memory is, from 0 when it is all in a single block to nearly 1 when it is split
+        /// into many small blocks.
+        double m_fragmentation = 0.0;
+    };
+
+    /// A AeMemoryBudget is a node of the tree of budgets kept by the AeMemoryManager. A budget either passes the
+    /// allocations made through it on to an allocator, measuring how much memory each allocation used, or groups the
+    /// budgets below it. The memory in use by a budget is also counted in every budget above it, and each budget
+    /// records its high water mark and reports when its memory in use exceeds its budget. Allocations made directly from
+    /// a budget's allocator, instead of through the budget, are only counted once the budget is updated.
+    class AeMemoryBudget: public AeAllocatorBase {
+    public:
+
+        /// Constructor of AeMemoryBudget.
+        /// \param t_name The name of the budget.
+        /// \param t_memoryTag The memory tag of the allocations made through the budget.
+        /// \param t_budget The number of bytes the budget allows to be in use, 0 if the budget is not limited.
+        /// \param t_allocator The allocator the budget passes its allocations on to, nullptr if the budget is a group.
+        /// \param t_parent The budget above this one, nullptr for the root of the tree.
+        /// \param t_overrunPolicy What is done when the budget is exceeded.
+        AeMemoryBudget(std::string t_name,
+                       MemoryTag t_memoryTag,
+                       std::size_t t_budget,
+                       AeAllocatorBase* t_allocator,
+                       AeMemoryBudget* t_parent,
+                       MemoryBudgetOverrun t_overrunPolicy);
+
+        /// Destructor of the AeMemoryBudget.
+        ~AeMemoryBudget() noexcept override;
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeMemoryBudget(const AeMemoryBudget&) = delete;
+        AeMemoryBudget& operator=(const AeMemoryBudget&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeMemoryBudget(AeMemoryBudget&&) = delete;
+        AeMemoryBudget& operator=(AeMemoryBudget&&) = delete;
+
+        /// Allocates the specified amount of memory from the budget's allocator. Groups can not allocate.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the returned memory. This MUST be a power of 2!
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+
+        /// Deallocates memory allocated by the budget's allocator.
+        /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
+        void deallocate(void* t_allocatedMemoryPtr) noexcept override;
+
+        /// Gets the number of bytes in use by the budget and every budget below it.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const override { return m_memoryInUse; };
+
+        /// Gets the largest free block of the budget's allocator, or of any allocator below a group.
+        /// \return The size in bytes of the largest free block.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const override;
+
+        /// Gets how fragmented the free memory of the budget's allocator is, or of every allocator below a group
+        /// weighted by their free memory.
+        /// \return The fragmentation.
+        [[nodiscard]] double getFragmentation() const override;
+
+        /// Measures the memory in use by the budget's allocator, or by every budget below a group, again. This counts
+        /// the allocations made directly from the allocators.
+        void update();
+
+        /// Gets the statistics of the budget.
+        /// \return The budget statistics.
+        [[nodiscard]] AeMemoryBudgetStats getStats() const;
+
+        /// Gets the name of the budget.
+        /// \return The name.
+        [[nodiscard]] const std::string& getName() const { return m_name; };
+
+        /// Gets the memory tag of the allocations made through the budget.
+        /// \return The memory tag.
+        [[nodiscard]] MemoryTag getMemoryTag() const { return m_memoryTag; };
+
+        /// Gets the allocator the budget passes its allocations on to.
+        /// \return The allocator, nullptr if the budget is a group.
+        [[nodiscard]] AeAllocatorBase* getAllocator() const { return m_allocator; };
+
+        /// Gets the budgets directly below this one.
+        /// \return The child budgets.
+        [[nodiscard]] const std::vector<AeMemoryBudget*>& getChildren() const { return m_children; };
+
+        /// Gets if the budget is a group of other budgets instead of passing allocations on to an allocator.
+        /// \return True if the budget is a group.
+        [[nodiscard]] bool isGroup() const { return m_allocator == nullptr; };
+
+    private:
+
+        /// Changes the memory in use by the budget and every budget above it.
+        /// \param t_memoryInUseChange The number of bytes added to the memory in use.
+        /// \param t_isAllocation If the change comes from an allocation.
+        void addMemoryInUse(std::ptrdiff_t t_memoryInUseChange, bool t_isAllocation) noexcept;
+
+        /// Measures the memory in use by the budget and every budget below it without changing the budgets above it.
+        /// \return The number of bytes in use.
+        std::size_t measureMemoryInUse();
+
+        /// Records the high water mark and reports the budget being exceeded.
+        void checkBudget() noexcept;
+
+        /// Gets the size of the memory of the budget's allocator, or of every allocator below a group.
+        /// \return The capacity in bytes.
+        [[nodiscard]] std::size_t getCapacity() const;
+
+        /// The name of the budget.
+        std::string m_name;
+
+        /// The memory tag of the allocations made through the budget.
+        MemoryTag m_memoryTag;
+
+        /// The number of bytes the budget allows to be in use, 0 if the budget is not limited.
+        std::size_t m_budget;
+
+        /// The allocator the budget passes its allocations on to, nullptr if the budget is a group.
+        AeAllocatorBase* m_allocator;
+
+        /// The budget above this one, nullptr for the root of the tree.
+        AeMemoryBudget* m_parent;
+
+        /// The budgets directly below this one.
+        std::vector<AeMemoryBudget*> m_children;
+
+        /// What is done when the budget is exceeded.
+        MemoryBudgetOverrun m_overrunPolicy;
+
+        /// The number of bytes in use by the budget and every budget below it.
+        std::size_t m_memoryInUse = 0;
+
+        /// The most bytes that have been in use at once.
+        std::size_t m_highWaterMark = 0;
+
+        /// The number of allocations made through the budget and every budget below it.
+        std::size_t m_numAllocations = 0;
+
+        /// The number of times the budget has been exceeded.
+        std::size_t m_numOverruns = 0;
+
+        /// If the memory in use is currently over the budget, so an overrun is only reported once.
+        bool m_isOverBudget = false;
+
+    protected:
+
+    };
+} // namespace ae_memory
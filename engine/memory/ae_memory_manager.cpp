@@ -7,12 +7,38 @@
 // libraries
 
 // std
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
 
 
 namespace ae_memory {
 
-    AeMemoryManager::AeMemoryManager(std::size_t t_memoryBlockSize) : m_memoryBlockSize{t_memoryBlockSize} {
+    namespace {
+
+        /// Escapes the characters of a string that are not allowed within a JSON string.
+        std::string escapeJsonString(const std::string& t_string) {
+            std::string escapedString;
+            escapedString.reserve(t_string.size());
+            for (char character: t_string) {
+                switch (character) {
+                    case '"': escapedString += "\\\""; break;
+                    case '\\': escapedString += "\\\\"; break;
+                    case '\n': escapedString += "\\n"; break;
+                    case '\t': escapedString += "\\t"; break;
+                    default: escapedString += character; break;
+                };
+            };
+            return escapedString;
+        };
+    }
+
+
+
+    AeMemoryManager::AeMemoryManager(std::size_t t_memoryBlockSize, MemoryBudgetOverrun t_overrunPolicy) :
+            m_memoryBlockSize{t_memoryBlockSize},
+            m_overrunPolicy{t_overrunPolicy} {
 
         // Attempt to allocate a block of memory that to be managed by this class.
         m_allocatedMemoryPtr = malloc(m_memoryBlockSize);
@@ -21,11 +47,161 @@ namespace ae_memory {
         if (!m_allocatedMemoryPtr) {
             throw std::bad_alloc();
         };
+
+        // Every budget is placed below the root group.
+        m_budgets.push_back(std::make_unique<AeMemoryBudget>("root",
+                                                             memoryTag_general,
+                                                             0,
+                                                             nullptr,
+                                                             nullptr,
+                                                             m_overrunPolicy));
     }
 
+
+
+    // The allocators are destroyed newest first since an allocator may fall back to one created before it.
     AeMemoryManager::~AeMemoryManager() {
+        while (!m_ownedAllocators.empty()) {
+            m_ownedAllocators.pop_back();
+        };
+        m_budgets.clear();
+
         // Ensure the memory block is freed.
         free(m_allocatedMemoryPtr);
     }
 
-} //namespace ae
\ No newline at end of file
+
+
+    AeMemoryBudget& AeMemoryManager::trackAllocator(std::string t_name,
+                                                    MemoryTag const t_memoryTag,
+                                                    AeAllocatorBase& t_allocator,
+                                                    std::size_t const t_budget,
+                                                    AeMemoryBudget& t_parent) {
+        m_budgets.push_back(std::make_unique<AeMemoryBudget>(std::move(t_name),
+                                                             t_memoryTag,
+                                                             t_budget,
+                                                             &t_allocator,
+                                                             &t_parent,
+                                                             m_overrunPolicy));
+        return *m_budgets.back();
+    }
+
+
+
+    AeMemoryBudget& AeMemoryManager::createGroup(std::string t_name,
+                                                 MemoryTag const t_memoryTag,
+                                                 std::size_t const t_budget,
+                                                 AeMemoryBudget& t_parent) {
+        m_budgets.push_back(std::make_unique<AeMemoryBudget>(std::move(t_name),
+                                                             t_memoryTag,
+                                                             t_budget,
+                                                             nullptr,
+                                                             &t_parent,
+                                                             m_overrunPolicy));
+        return *m_budgets.back();
+    }
+
+
+
+    void AeMemoryManager::update() {
+        getRoot().update();
+    }
+
+
+
+    std::size_t AeMemoryManager::getMemoryInUse(MemoryTag const t_memoryTag) const {
+        std::size_t memoryInUse = 0;
+        for (const auto& budget: m_budgets) {
+            if (!budget->isGroup() && budget->getMemoryTag() == t_memoryTag) {
+                memoryInUse += budget->getMemoryInUse();
+            };
+        };
+        return memoryInUse;
+    }
+
+
+
+    // Write the memory in use by each tag, then the tree of budgets starting from the root.
+    std::string AeMemoryManager::toJson() const {
+        std::ostringstream json;
+
+        json << "{\n";
+        json << "  \"blockSize\": " << m_memoryBlockSize << ",\n";
+        json << "  \"blockRemaining\": " << getRemainingMemory() << ",\n";
+
+        json << "  \"tags\": {";
+        for (int i = 0; i < memoryTag_count; i++) {
+            auto memoryTag = static_cast<MemoryTag>(i);
+            json << (i == 0 ? "\n" : ",\n");
+            json << "    \"" << getMemoryTagName(memoryTag) << "\": " << getMemoryInUse(memoryTag);
+        };
+        json << "\n  },\n";
+
+        json << "  \"budgets\": ";
+        budgetToJson(*m_budgets.front(), 2, json);
+        json << "\n}\n";
+
+        return json.str();
+    }
+
+
+
+    // Write the JSON document to the file.
+    void AeMemoryManager::writeJson(const std::string& t_filepath) const {
+        std::ofstream file{t_filepath};
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open memory statistics file for writing: " + t_filepath);
+        };
+        file << toJson();
+    }
+
+
+
+    // Memory is taken from the block in order, each allocator's memory starting on a new cache line.
+    void* AeMemoryManager::takeMemory(std::size_t const t_allocationSize) {
+        void* allocationPtr = AeAllocatorBase::getAlignedAddress(
+                AeAllocatorBase::addToPointer(m_memoryBlockUsed, m_allocatedMemoryPtr),
+                ALLOCATOR_ALIGNMENT);
+        std::size_t allocationEnd = AeAllocatorBase::pointerDifference(allocationPtr, m_allocatedMemoryPtr) +
+                                    t_allocationSize;
+
+        if (allocationEnd > m_memoryBlockSize) {
+            throw std::bad_alloc();
+        };
+
+        m_memoryBlockUsed = allocationEnd;
+        return allocationPtr;
+    }
+
+
+
+    // Each budget is an object with its children in an array.
+    void AeMemoryManager::budgetToJson(const AeMemoryBudget& t_budget,
+                                       std::size_t const t_indent,
+                                       std::ostream& t_json) {
+        AeMemoryBudgetStats stats = t_budget.getStats();
+        std::string indent(t_indent, ' ');
+
+        t_json << "{\n";
+        t_json << indent << "  \"name\": \"" << escapeJsonString(t_budget.getName()) << "\",\n";
+        t_json << indent << "  \"tag\": \"" << getMemoryTagName(t_budget.getMemoryTag()) << "\",\n";
+        t_json << indent << "  \"isGroup\": " << (t_budget.isGroup() ? "true" : "false") << ",\n";
+        t_json << indent << "  \"capacity\": " << stats.m_capacity << ",\n";
+        t_json << indent << "  \"budget\": " << stats.m_budget << ",\n";
+        t_json << indent << "  \"inUse\": " << stats.m_memoryInUse << ",\n";
+        t_json << indent << "  \"highWaterMark\": " << stats.m_highWaterMark << ",\n";
+        t_json << indent << "  \"allocations\": " << stats.m_numAllocations << ",\n";
+        t_json << indent << "  \"overruns\": " << stats.m_numOverruns << ",\n";
+        t_json << indent << "  \"largestFreeBlock\": " << stats.m_largestFreeBlock << ",\n";
+        t_json << indent << "  \"fragmentation\": " << stats.m_fragmentation << ",\n";
+        t_json << indent << "  \"children\": [";
+        const std::vector<AeMemoryBudget*>& children = t_budget.getChildren();
+        for (std::size_t i = 0; i < children.size(); i++) {
+            t_json << (i == 0 ? "\n" : ",\n") << indent << "    ";
+            budgetToJson(*children[i], t_indent + 4, t_json);
+        };
+        t_json << (children.empty() ? "]\n" : "\n" + indent + "  ]\n");
+        t_json << indent << "}";
+    }
+
+} //namespace ae
@@ -4,38 +4,157 @@
 
 // dependencies
 #include "ae_allocator_base.hpp"
+#include "ae_memory_budget.hpp"
 
 // libraries
 
 // std
 #include <cstdlib>
-#include <forward_list>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace ae_memory {
 
-    /// Allocates and manages the block of memory which the game will utilize.
+    /// Allocates and manages the block of memory which the game will utilize. The block is split between the
+    /// allocators created by the manager, and every allocator is placed in a tree of named budgets so the memory used
+    /// by each part of the game, and by each memory tag, can be measured and limited. Allocators with their own memory
+    /// can be added to the tree to be measured as well.
     class AeMemoryManager{
     public:
 
+        /// The alignment of the memory given to each allocator created by the manager, a cache line so allocators do
+        /// not share one.
+        static constexpr std::size_t ALLOCATOR_ALIGNMENT = 64;
+
         /// Creates a new memory manager that will allocated, and manage, a new block of memory as specified. This will
         /// be responsible for providing allocators with blocks of the pre-allocated memory to give out as requested.
         /// \param t_memoryBlockSize The size of the block of memory to allocate and manage.
-        explicit AeMemoryManager(std::size_t t_memoryBlockSize);
+        /// \param t_overrunPolicy What is done when a budget is exceeded.
+        explicit AeMemoryManager(std::size_t t_memoryBlockSize,
+                                 MemoryBudgetOverrun t_overrunPolicy = memoryBudgetOverrun_log);
 
         /// First cleans up the allocators that utilized the managed memory block, then frees the memory block.
         ~AeMemoryManager();
 
+        /// Do not allow this class to be copied (2 lines below).
+        AeMemoryManager(const AeMemoryManager&) = delete;
+        AeMemoryManager& operator=(const AeMemoryManager&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeMemoryManager(AeMemoryManager&&) = delete;
+        AeMemoryManager& operator=(AeMemoryManager&&) = delete;
+
+        /// Creates an allocator over the next part of the managed memory block, and a budget that allocations are made
+        /// through. The allocator is owned by the manager.
+        /// \tparam T The type of the allocator, constructed from the size and pointer of its memory and then the
+        /// additional arguments.
+        /// \param t_name The name of the budget.
+        /// \param t_memoryTag The memory tag of the allocations made through the budget.
+        /// \param t_allocationSize The size in bytes of the memory given to the allocator.
+        /// \param t_budget The number of bytes the budget allows to be in use, 0 if the budget is not limited.
+        /// \param t_parent The group the budget is placed in.
+        /// \param t_args The additional arguments of the allocator's constructor.
+        /// \return The budget to allocate through.
+        template<typename T, typename... Args>
+        AeMemoryBudget& createAllocator(std::string t_name,
+                                        MemoryTag t_memoryTag,
+                                        std::size_t t_allocationSize,
+                                        std::size_t t_budget,
+                                        AeMemoryBudget& t_parent,
+                                        Args&&... t_args) {
+            void* allocatorMemory = takeMemory(t_allocationSize);
+            m_ownedAllocators.push_back(std::make_unique<T>(t_allocationSize,
+                                                            allocatorMemory,
+                                                            std::forward<Args>(t_args)...));
+            return trackAllocator(std::move(t_name), t_memoryTag, *m_ownedAllocators.back(), t_budget, t_parent);
+        };
+
+        /// Creates a budget for an allocator that is not owned by the manager. The allocator must outlive the manager.
+        /// Allocations made directly from the allocator are counted when the manager is updated.
+        /// \param t_name The name of the budget.
+        /// \param t_memoryTag The memory tag of the allocations made through the budget.
+        /// \param t_allocator The allocator.
+        /// \param t_budget The number of bytes the budget allows to be in use, 0 if the budget is not limited.
+        /// \param t_parent The group the budget is placed in.
+        /// \return The budget to allocate through.
+        AeMemoryBudget& trackAllocator(std::string t_name,
+                                       MemoryTag t_memoryTag,
+                                       AeAllocatorBase& t_allocator,
+                                       std::size_t t_budget,
+                                       AeMemoryBudget& t_parent);
+
+        /// Creates a group of budgets, the memory in use by the group is the total of the budgets placed in it.
+        /// \param t_name The name of the group.
+        /// \param t_memoryTag The memory tag of the group.
+        /// \param t_budget The number of bytes the group allows to be in use, 0 if the group is not limited.
+        /// \param t_parent The group the group is placed in.
+        /// \return The group.
+        AeMemoryBudget& createGroup(std::string t_name,
+                                    MemoryTag t_memoryTag,
+                                    std::size_t t_budget,
+                                    AeMemoryBudget& t_parent);
+
+        /// Gets the group at the root of the tree of budgets.
+        /// \return The root group.
+        AeMemoryBudget& getRoot() { return *m_budgets.front(); };
+
+        /// Measures every budget again, called once a frame so allocations that were not made through a budget are
+        /// counted and their budgets checked.
+        void update();
+
+        /// Gets the number of bytes in use by the budgets with the memory tag, groups are not counted.
+        /// \param t_memoryTag The memory tag.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse(MemoryTag t_memoryTag) const;
+
+        /// Gets the number of bytes of the managed memory block that have not been given to an allocator.
+        /// \return The number of bytes left.
+        [[nodiscard]] std::size_t getRemainingMemory() const { return m_memoryBlockSize - m_memoryBlockUsed; };
+
+        /// Converts the statistics of every budget, and the memory in use by each memory tag, to a JSON document.
+        /// \return The JSON document.
+        [[nodiscard]] std::string toJson() const;
+
+        /// Writes the statistics to a file as JSON.
+        /// \param t_filepath The path of the file to write.
+        void writeJson(const std::string& t_filepath) const;
+
     private:
+
+        /// Takes the next part of the managed memory block for an allocator. Throws std::bad_alloc if the block does
+        /// not have enough memory left.
+        /// \param t_allocationSize The size in bytes of the memory to take.
+        /// \return The start of the memory.
+        void* takeMemory(std::size_t t_allocationSize);
+
+        /// Writes the statistics of a budget, and every budget below it, as a JSON object.
+        /// \param t_budget The budget.
+        /// \param t_indent The number of spaces the object is indented by.
+        /// \param t_json The stream the JSON document is being written to.
+        static void budgetToJson(const AeMemoryBudget& t_budget, std::size_t t_indent, std::ostream& t_json);
+
     protected:
 
         /// The base pointer to the block of allocated memory.
         void* m_allocatedMemoryPtr;
 
-        /// A list of which allocators are being managed.
-        std::forward_list<AeAllocatorBase*> m_managedAllocators;
+        /// The allocators created from the managed memory block, in the order they were created.
+        std::vector<std::unique_ptr<AeAllocatorBase>> m_ownedAllocators;
+
+        /// Every budget, the root group first.
+        std::vector<std::unique_ptr<AeMemoryBudget>> m_budgets;
 
         /// The amount of memory allocated to this manager.
         std::size_t m_memoryBlockSize;
+
+        /// The amount of the managed memory block given to allocators.
+        std::size_t m_memoryBlockUsed = 0;
+
+        /// What is done when a budget is exceeded.
+        MemoryBudgetOverrun m_overrunPolicy;
     };
 
-} // namespace ae
\ No newline at end of file
+} // namespace ae
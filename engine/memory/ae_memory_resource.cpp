@@ -0,0 +1,46 @@
+/// \file ae_memory_resource.cpp
+/// The AeMemoryResource class is implemented.
+#include "ae_memory_resource.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+
+namespace ae_memory {
+
+    AeMemoryResource::AeMemoryResource(AeAllocatorBase& t_allocator) noexcept: m_allocator{t_allocator} {
+    };
+
+
+
+    AeMemoryResource::~AeMemoryResource() = default;
+
+
+
+    void* AeMemoryResource::do_allocate(std::size_t const t_bytes, std::size_t const t_alignment) {
+        return m_allocator.allocate(t_bytes, t_alignment);
+    };
+
+
+
+    void AeMemoryResource::do_deallocate(void* const t_ptr,
+                                         [[maybe_unused]] std::size_t const t_bytes,
+                                         [[maybe_unused]] std::size_t const t_alignment) {
+        m_allocator.deallocate(t_ptr);
+    };
+
+
+
+    // Another kind of memory resource can never deallocate memory from an engine allocator.
+    bool AeMemoryResource::do_is_equal(const std::pmr::memory_resource& t_other) const noexcept {
+        if (this == &t_other) {
+            return true;
+        };
+
+        const auto* otherMemoryResource = dynamic_cast<const AeMemoryResource*>(&t_other);
+        return otherMemoryResource != nullptr && &otherMemoryResource->m_allocator == &m_allocator;
+    };
+
+} //namespace ae_memory
@@ -0,0 +1,68 @@
+/// \file ae_memory_resource.hpp
+/// The AeMemoryResource class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <memory_resource>
+
+namespace ae_memory {
+
+    /// A AeMemoryResource lets the std::pmr containers allocate from an engine allocator. Containers using it all have
+    /// the same type whichever allocator is behind the resource, so a container can be moved to a pool, frame arena, or
+    /// slab allocator without changing its type everywhere it is used. The allocator must outlive the resource and every
+    /// container using it.
+    class AeMemoryResource: public std::pmr::memory_resource {
+    public:
+
+        /// Constructor of AeMemoryResource.
+        /// \param t_allocator The allocator the memory resource allocates from.
+        explicit AeMemoryResource(AeAllocatorBase& t_allocator) noexcept;
+
+        /// Destructor of AeMemoryResource.
+        ~AeMemoryResource() override;
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeMemoryResource(const AeMemoryResource&) = delete;
+        AeMemoryResource& operator=(const AeMemoryResource&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeMemoryResource(AeMemoryResource&&) = delete;
+        AeMemoryResource& operator=(AeMemoryResource&&) = delete;
+
+        /// Gets the allocator the memory resource allocates from.
+        /// \return The allocator.
+        [[nodiscard]] AeAllocatorBase& getAllocator() const { return m_allocator; };
+
+    private:
+
+        /// Allocates from the allocator.
+        /// \param t_bytes The size of the memory in bytes to be allocated.
+        /// \param t_alignment The alignment of the returned memory.
+        /// \return The allocated memory.
+        void* do_allocate(std::size_t t_bytes, std::size_t t_alignment) override;
+
+        /// Deallocates memory allocated from the allocator, the allocators find the size of an allocation themselves.
+        /// \param t_ptr The memory to deallocate.
+        /// \param t_bytes The size of the memory in bytes, unused.
+        /// \param t_alignment The alignment of the memory, unused.
+        void do_deallocate(void* t_ptr, std::size_t t_bytes, std::size_t t_alignment) override;
+
+        /// Memory resources are equal if they allocate from the same allocator, since memory allocated by one can then
+        /// be deallocated by the other.
+        /// \param t_other The memory resource to compare with.
+        /// \return True if the memory resources allocate from the same allocator.
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& t_other) const noexcept override;
+
+        /// The allocator the memory resource allocates from.
+        AeAllocatorBase& m_allocator;
+
+    protected:
+
+    };
+} // namespace ae_memory
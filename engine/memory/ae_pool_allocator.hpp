@@ -43,6 +43,24 @@ namespace ae_memory {
         /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
         void deallocate(void* t_allocatedMemoryPtr) noexcept override;
 
+        /// Gets the number of bytes currently allocated, including the padding of each chunk for alignment.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const noexcept override { return m_memoryInUse; };
+
+        /// Gets the size of a chunk if there are any left, since a pool only allocates a chunk at a time.
+        /// \return The size in bytes of a chunk, or 0 if the pool is full.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const noexcept override {
+            return hasFreeChunks() ? m_chunkSize : 0;
+        };
+
+        /// Any free chunk can serve any allocation the pool takes, so its free memory is never fragmented.
+        /// \return 0.
+        [[nodiscard]] double getFragmentation() const noexcept override { return 0.0; };
+
+        /// Checks if there are any chunks left to allocate.
+        /// \return True if a chunk can be allocated.
+        [[nodiscard]] bool hasFreeChunks() const noexcept { return m_firstFreeChunkPtr != nullptr; };
+
         /// Implements the equals comparison operator.
         bool operator==(const AePoolAllocator&) const noexcept { return true;};
 
@@ -0,0 +1,247 @@
+/// \file ae_slab_allocator.cpp
+/// The AeSlabAllocator class is implemented.
+#include "ae_slab_allocator.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <cassert>
+#include <stdexcept>
+
+namespace ae_memory {
+
+    // Split the memory into pages, all of which start free.
+    AeSlabAllocator::AeSlabAllocator(std::size_t const t_allocatedMemorySize,
+                                     void* const t_allocatedMemoryPtr,
+                                     AeAllocatorBase* const t_fallbackAllocator,
+                                     std::size_t const t_pageSize):
+            AeAllocatorBase(t_allocatedMemorySize, t_allocatedMemoryPtr),
+            m_fallbackAllocator{t_fallbackAllocator},
+            m_pageSize{t_pageSize} {
+
+        if (m_pageSize < 4 * SIZE_CLASSES.back()) {
+            throw std::runtime_error("The page size of AeSlabAllocator is too small for its largest size class!");
+        };
+
+        m_firstPagePtr = getAlignedAddress(m_allocatedMemoryPtr);
+        m_statistics.m_numPages = (m_allocatedMemorySize - pointerDifference(m_firstPagePtr, m_allocatedMemoryPtr)) /
+                                  m_pageSize;
+        m_lastPageEndPtr = addToPointer(m_statistics.m_numPages * m_pageSize, m_firstPagePtr);
+
+        m_pages = std::make_unique<PageInfo[]>(m_statistics.m_numPages);
+        for (std::size_t i = m_statistics.m_numPages; i > 0; i--) {
+            m_pages[i - 1].m_nextPage = m_firstFreePage;
+            m_firstFreePage = &m_pages[i - 1];
+        };
+    };
+
+
+
+    AeSlabAllocator::~AeSlabAllocator() noexcept {
+        assert(m_statistics.m_memoryInUse == 0 && "Huston we have a leak... in a slab... allocator!");
+
+        // The last partially used page of each size class is kept when it empties, release them so the pools are
+        // destroyed empty.
+        for (PageInfo* page: m_partialPages) {
+            while (page != nullptr) {
+                PageInfo* nextPage = page->m_nextPage;
+                if (page->m_pool->getMemoryInUse() == 0) {
+                    releasePage(page);
+                };
+                page = nextPage;
+            };
+        };
+
+        m_pages.reset();
+        m_firstFreePage = nullptr;
+    };
+
+
+
+    // Allocate from the first partially used page of the size class, giving the size class a new page if it has none.
+    void* AeSlabAllocator::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+
+        std::size_t sizeClassIndex = getSizeClassIndex(t_allocationSize, t_byteAlignment);
+        if (sizeClassIndex == NUM_SIZE_CLASSES) {
+            if (m_fallbackAllocator == nullptr) {
+                throw std::bad_alloc();
+            };
+            void* allocation = m_fallbackAllocator->allocate(t_allocationSize, t_byteAlignment);
+            m_statistics.m_numFallbackAllocations += 1;
+            return allocation;
+        };
+
+        PageInfo* page = m_partialPages[sizeClassIndex];
+        if (page == nullptr) {
+            page = acquirePage(sizeClassIndex);
+            pushPartialPage(page);
+        };
+
+        void* allocation = page->m_pool->allocate(SIZE_CLASSES[sizeClassIndex], getSizeClassAlignment(sizeClassIndex));
+        m_statistics.m_memoryInUse += SIZE_CLASSES[sizeClassIndex];
+
+        // A full page leaves the partially used pages until one of its objects is freed.
+        if (!page->m_pool->hasFreeChunks()) {
+            removePartialPage(page);
+        };
+
+        return allocation;
+    };
+
+
+
+    // The page of an allocation is found from its address.
+    void AeSlabAllocator::deallocate(void* const t_allocatedMemoryPtr) noexcept {
+
+        if (t_allocatedMemoryPtr < m_firstPagePtr || t_allocatedMemoryPtr >= m_lastPageEndPtr) {
+            assert(m_fallbackAllocator != nullptr &&
+                   "Memory being deallocated not in range of memory this allocator controls!");
+            m_fallbackAllocator->deallocate(t_allocatedMemoryPtr);
+            return;
+        };
+
+        PageInfo* page = &m_pages[pointerDifference(t_allocatedMemoryPtr, m_firstPagePtr) / m_pageSize];
+        assert(page->m_pool.has_value() && "Memory being deallocated is in a page that is not in use!");
+
+        bool wasFull = !page->m_pool->hasFreeChunks();
+        page->m_pool->deallocate(t_allocatedMemoryPtr);
+        m_statistics.m_memoryInUse -= SIZE_CLASSES[page->m_sizeClassIndex];
+
+        if (wasFull) {
+            pushPartialPage(page);
+        };
+
+        // Release the page once it is empty unless it is the size class's only partially used page, so a size class
+        // repeatedly allocating and freeing a single object does not acquire and release a page every time.
+        if (page->m_pool->getMemoryInUse() == 0 &&
+            (m_partialPages[page->m_sizeClassIndex] != page || page->m_nextPage != nullptr)) {
+            removePartialPage(page);
+            releasePage(page);
+        };
+    };
+
+
+
+    // A free page can take the largest size class, otherwise only the size classes with partially used pages have room.
+    std::size_t AeSlabAllocator::getLargestFreeBlock() const {
+        if (m_firstFreePage != nullptr) {
+            return SIZE_CLASSES.back();
+        };
+
+        for (std::size_t i = NUM_SIZE_CLASSES; i > 0; i--) {
+            if (m_partialPages[i - 1] != nullptr) {
+                return SIZE_CLASSES[i - 1];
+            };
+        };
+
+        return 0;
+    };
+
+
+
+    double AeSlabAllocator::getFragmentation() const {
+        std::size_t freePageMemory = (m_statistics.m_numPages - m_statistics.m_numPagesInUse) * m_pageSize;
+        std::size_t partialPageMemory = m_statistics.m_numPagesInUse * m_pageSize - m_statistics.m_memoryInUse;
+        if (freePageMemory + partialPageMemory == 0) {
+            return 0.0;
+        };
+
+        return static_cast<double>(partialPageMemory) / static_cast<double>(freePageMemory + partialPageMemory);
+    };
+
+
+
+    // Find the first size class at least as large as the allocation that is also aligned enough.
+    std::size_t AeSlabAllocator::getSizeClassIndex(std::size_t const t_allocationSize,
+                                                   std::size_t const t_byteAlignment) {
+        for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+            if (SIZE_CLASSES[i] >= t_allocationSize && getSizeClassAlignment(i) >= t_byteAlignment) {
+                return i;
+            };
+        };
+        return NUM_SIZE_CLASSES;
+    };
+
+
+
+    // The largest power of two dividing a number is its lowest set bit.
+    std::size_t AeSlabAllocator::getSizeClassAlignment(std::size_t const t_sizeClassIndex) {
+        return SIZE_CLASSES[t_sizeClassIndex] & (~SIZE_CLASSES[t_sizeClassIndex] + 1);
+    };
+
+
+
+    // Pop the first free page and create a pool over it for the size class.
+    AeSlabAllocator::PageInfo* AeSlabAllocator::acquirePage(std::size_t const t_sizeClassIndex) {
+        if (m_firstFreePage == nullptr) {
+            throw std::bad_alloc();
+        };
+
+        PageInfo* page = m_firstFreePage;
+        m_firstFreePage = page->m_nextPage;
+
+        std::size_t pageIndex = page - m_pages.get();
+        page->m_pool.emplace(m_pageSize,
+                             addToPointer(pageIndex * m_pageSize, m_firstPagePtr),
+                             SIZE_CLASSES[t_sizeClassIndex],
+                             getSizeClassAlignment(t_sizeClassIndex));
+        page->m_sizeClassIndex = t_sizeClassIndex;
+        page->m_nextPage = nullptr;
+        page->m_prevPage = nullptr;
+
+        m_statistics.m_numPagesInUse += 1;
+        m_statistics.m_numPageAcquisitions += 1;
+        if (page->m_hasBeenUsed) {
+            m_statistics.m_numPageReuses += 1;
+        };
+        page->m_hasBeenUsed = true;
+
+        return page;
+    };
+
+
+
+    // Destroy the page's pool and push the page onto the free pages.
+    void AeSlabAllocator::releasePage(PageInfo* const t_page) noexcept {
+        t_page->m_pool.reset();
+        t_page->m_prevPage = nullptr;
+        t_page->m_nextPage = m_firstFreePage;
+        m_firstFreePage = t_page;
+
+        m_statistics.m_numPagesInUse -= 1;
+        m_statistics.m_numPageReleases += 1;
+    };
+
+
+
+    void AeSlabAllocator::pushPartialPage(PageInfo* const t_page) noexcept {
+        PageInfo*& firstPartialPage = m_partialPages[t_page->m_sizeClassIndex];
+
+        t_page->m_prevPage = nullptr;
+        t_page->m_nextPage = firstPartialPage;
+        if (firstPartialPage != nullptr) {
+            firstPartialPage->m_prevPage = t_page;
+        };
+        firstPartialPage = t_page;
+    };
+
+
+
+    void AeSlabAllocator::removePartialPage(PageInfo* const t_page) noexcept {
+        if (t_page->m_prevPage != nullptr) {
+            t_page->m_prevPage->m_nextPage = t_page->m_nextPage;
+        } else {
+            m_partialPages[t_page->m_sizeClassIndex] = t_page->m_nextPage;
+        };
+
+        if (t_page->m_nextPage != nullptr) {
+            t_page->m_nextPage->m_prevPage = t_page->m_prevPage;
+        };
+
+        t_page->m_nextPage = nullptr;
+        t_page->m_prevPage = nullptr;
+    };
+
+} //namespace ae_memory
@@ -0,0 +1,193 @@
+/// \file ae_slab_allocator.hpp
+/// The AeSlabAllocator class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "ae_pool_allocator.hpp"
+
+// libraries
+
+//std
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+
+namespace ae_memory {
+
+    /// A AeSlabAllocator implements a slab allocator for small objects such as the nodes of node based containers and
+    /// the control blocks of shared pointers. Its memory is split into equal sized pages, and each page in use is an
+    /// AePoolAllocator for one of the size classes, so objects of similar size are packed together and allocating or
+    /// deallocating one takes constant time. A page whose objects have all been freed goes back to the free pages to be
+    /// reused by any size class. Allocations too large for the size classes go to an optional fallback allocator.
+    class AeSlabAllocator: public AeAllocatorBase {
+
+    public:
+
+        /// The number of size classes.
+        static constexpr std::size_t NUM_SIZE_CLASSES = 13;
+
+        /// The size in bytes of the objects in each size class, each power of two with a size halfway between it and
+        /// the next. A size class is aligned to the largest power of two that divides its size.
+        static constexpr std::array<std::size_t, NUM_SIZE_CLASSES> SIZE_CLASSES = {
+                8, 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+
+        /// The default size in bytes of a page.
+        static constexpr std::size_t DEFAULT_PAGE_SIZE = std::size_t{64} << 10;
+
+        /// Statistics on how the pages of the slab allocator are being used.
+        struct SlabStatistics{
+            /// The number of pages the memory of the allocator was split into.
+            std::size_t m_numPages = 0;
+
+            /// The number of pages currently given to a size class.
+            std::size_t m_numPagesInUse = 0;
+
+            /// The number of times a page has been given to a size class.
+            std::size_t m_numPageAcquisitions = 0;
+
+            /// The number of times a page given to a size class had been used and released before.
+            std::size_t m_numPageReuses = 0;
+
+            /// The number of times an empty page has been released by its size class.
+            std::size_t m_numPageReleases = 0;
+
+            /// The number of bytes currently allocated from the pages, including the rounding up to the size class.
+            std::size_t m_memoryInUse = 0;
+
+            /// The number of allocations that went to the fallback allocator.
+            std::size_t m_numFallbackAllocations = 0;
+        };
+
+        /// Constructor of AeSlabAllocator.
+        /// \param t_allocatedMemorySize The size of the pre-allocated memory this allocator will be responsible for.
+        /// \param t_allocatedMemoryPtr A pointer to the pre-allocated memory this allocator will be responsible for
+        /// managing.
+        /// \param t_fallbackAllocator The allocator used for allocations that do not fit a size class, if this is
+        /// nullptr those allocations fail.
+        /// \param t_pageSize The size in bytes of each page, must be big enough to fit several objects of the largest
+        /// size class.
+        AeSlabAllocator(std::size_t t_allocatedMemorySize,
+                        void* t_allocatedMemoryPtr,
+                        AeAllocatorBase* t_fallbackAllocator = nullptr,
+                        std::size_t t_pageSize = DEFAULT_PAGE_SIZE);
+
+        /// Destructor of the AeSlabAllocator.
+        ~AeSlabAllocator() noexcept override;
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeSlabAllocator(const AeSlabAllocator&) = delete;
+        AeSlabAllocator& operator=(const AeSlabAllocator&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeSlabAllocator(AeSlabAllocator&&) = delete;
+        AeSlabAllocator& operator=(AeSlabAllocator&&) = delete;
+
+        /// Allocates the specified amount of memory.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the returned memory. This MUST be a power of 2!
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+
+        /// Deallocates the allocated memory by this allocator, or its fallback allocator, at this pointer.
+        /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
+        void deallocate(void* t_allocatedMemoryPtr) noexcept override;
+
+        /// Gets the statistics on the use of the pages.
+        /// \return The page statistics.
+        [[nodiscard]] const SlabStatistics& getStatistics() const { return m_statistics; };
+
+        /// Gets the number of bytes currently allocated from the pages, including the rounding up to the size class.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const override { return m_statistics.m_memoryInUse; };
+
+        /// Gets the largest allocation the pages could currently take, the fallback allocator is not included.
+        /// \return The size in bytes of the largest allocation possible.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const override;
+
+        /// Gets the share of the free memory in pages given to a size class, which only that size class can use.
+        /// \return The fragmentation, 0 when all the free memory is in free pages.
+        [[nodiscard]] double getFragmentation() const override;
+
+        /// Implements the equals comparison operator.
+        bool operator==(const AeSlabAllocator&) const noexcept { return true;};
+
+        /// Implements the not equals comparison operator.
+        bool operator!=(const AeSlabAllocator&) const noexcept { return false;};
+
+    private:
+
+        /// The state of a page.
+        struct PageInfo{
+            /// The pool managing the page while it is given to a size class.
+            std::optional<AePoolAllocator> m_pool;
+
+            /// The index of the size class the page is given to.
+            std::size_t m_sizeClassIndex = 0;
+
+            /// The next page in the list of free pages, or in the list of partially used pages of its size class.
+            PageInfo* m_nextPage = nullptr;
+
+            /// The previous page in the list of partially used pages of its size class.
+            PageInfo* m_prevPage = nullptr;
+
+            /// If the page has been given to a size class before.
+            bool m_hasBeenUsed = false;
+        };
+
+        /// Gets the index of the smallest size class that satisfies both the size and the alignment.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the memory to be allocated.
+        /// \return The index of the size class, NUM_SIZE_CLASSES if the allocation does not fit any size class.
+        static std::size_t getSizeClassIndex(std::size_t t_allocationSize, std::size_t t_byteAlignment);
+
+        /// Gets the alignment of a size class.
+        /// \param t_sizeClassIndex The index of the size class.
+        /// \return The alignment of the objects of the size class.
+        static std::size_t getSizeClassAlignment(std::size_t t_sizeClassIndex);
+
+        /// Takes a page from the free pages and gives it to a size class.
+        /// \param t_sizeClassIndex The index of the size class to give the page to.
+        /// \return The page given to the size class.
+        PageInfo* acquirePage(std::size_t t_sizeClassIndex);
+
+        /// Takes an empty page from its size class and returns it to the free pages.
+        /// \param t_page The page to release.
+        void releasePage(PageInfo* t_page) noexcept;
+
+        /// Adds a page to the front of the partially used pages of its size class.
+        /// \param t_page The page to add.
+        void pushPartialPage(PageInfo* t_page) noexcept;
+
+        /// Removes a page from the partially used pages of its size class.
+        /// \param t_page The page to remove.
+        void removePartialPage(PageInfo* t_page) noexcept;
+
+        /// The allocator used for allocations that do not fit a size class.
+        AeAllocatorBase* m_fallbackAllocator;
+
+        /// The size in bytes of each page.
+        std::size_t m_pageSize;
+
+        /// The start of the first page.
+        void* m_firstPagePtr;
+
+        /// The end of the last page.
+        void* m_lastPageEndPtr;
+
+        /// The state of every page.
+        std::unique_ptr<PageInfo[]> m_pages;
+
+        /// The first page that is not given to a size class.
+        PageInfo* m_firstFreePage = nullptr;
+
+        /// The first page of each size class that has objects left to allocate.
+        std::array<PageInfo*, NUM_SIZE_CLASSES> m_partialPages{};
+
+        /// The page statistics.
+        SlabStatistics m_statistics;
+
+    protected:
+
+    };
+} // namespace ae_memory
@@ -18,6 +18,15 @@ namespace ae_memory {
 
 
 
+    AeStackAllocator::AeStackAllocator(AeVirtualMemoryArena& t_arena) noexcept :
+    AeAllocatorBase(t_arena.getReservedSize(),t_arena.getReservedMemoryPtr()){
+        m_stackTopPtr = m_allocatedMemoryPtr;
+        m_arena = &t_arena;
+        m_committedEndPtr = m_allocatedMemoryPtr;
+    };
+
+
+
     AeStackAllocator::~AeStackAllocator() noexcept{
         clearStack();
         m_stackTopPtr = nullptr;
@@ -37,6 +46,13 @@ namespace ae_memory {
             throw std::bad_alloc();
         }
 
+        // Commit the memory the stack is growing into if it is allocated from a virtual memory arena.
+        void* newStackTopPtr = addToPointer(totalAllocation,m_stackTopPtr);
+        if(m_arena != nullptr && newStackTopPtr > m_committedEndPtr){
+            m_arena->commit(m_committedEndPtr,pointerDifference(newStackTopPtr,m_committedEndPtr));
+            m_committedEndPtr = m_arena->alignUpToCommitGranularity(newStackTopPtr);
+        }
+
         // Get the aligned address.
         void* alignedAddress = addToPointer(alignmentOffset,m_stackTopPtr);
 
@@ -75,4 +91,14 @@ namespace ae_memory {
         m_stackTopPtr = m_allocatedMemoryPtr;
         m_memoryInUse = 0;
     }
+
+    void AeStackAllocator::decommitUnusedMemory() noexcept {
+        if(m_arena == nullptr || m_committedEndPtr <= m_stackTopPtr){
+            return;
+        }
+
+        // The arena only decommits whole chunks so the chunk holding the top of the stack stays committed.
+        m_arena->decommit(m_stackTopPtr,pointerDifference(m_committedEndPtr,m_stackTopPtr));
+        m_committedEndPtr = m_arena->alignUpToCommitGranularity(m_stackTopPtr);
+    }
 } //namespace ae_memory
\ No newline at end of file
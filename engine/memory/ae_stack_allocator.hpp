@@ -4,6 +4,7 @@
 
 // dependencies
 #include "ae_allocator_base.hpp"
+#include "ae_virtual_memory_arena.hpp"
 
 // libraries
 
@@ -25,6 +26,11 @@ namespace ae_memory {
         /// Constructor of AeStackAllocator.
         AeStackAllocator(std::size_t t_allocatedMemorySize, void* t_allocatedMemoryPtr) noexcept;
 
+        /// Constructor of AeStackAllocator managing a virtual memory arena. Memory is committed to the arena as the
+        /// stack grows into it.
+        /// \param t_arena The arena the stack is allocated from, it must outlive the stack allocator.
+        explicit AeStackAllocator(AeVirtualMemoryArena& t_arena) noexcept;
+
         /// Destructor of the AeStackAllocator.
         ~AeStackAllocator() noexcept override;
 
@@ -56,6 +62,20 @@ namespace ae_memory {
         /// Deallocates all the memory in the stack.
         void clearStack() noexcept;
 
+        /// Returns the memory committed to the virtual memory arena above the top of the stack to the operating system.
+        /// Does nothing if the stack is not allocated from a virtual memory arena.
+        void decommitUnusedMemory() noexcept;
+
+        /// Gets the number of bytes currently allocated from the stack, including alignment padding.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const noexcept override { return m_memoryInUse; };
+
+        /// Gets the memory left above the top of the stack, it is never fragmented.
+        /// \return The number of bytes free.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const noexcept override {
+            return m_allocatedMemorySize - m_memoryInUse;
+        };
+
         /// Implements the equals comparison operator.
         bool operator==(const AeStackAllocator&) const noexcept { return true;};
 
@@ -71,5 +91,11 @@ namespace ae_memory {
 
         /// Tracks how much of the stack's memory is currently being used.
         std::size_t m_memoryInUse = 0;
+
+        /// The virtual memory arena the stack is allocated from, nullptr if the memory was given to the stack.
+        AeVirtualMemoryArena* m_arena = nullptr;
+
+        /// The end of the memory committed to the virtual memory arena.
+        void* m_committedEndPtr = nullptr;
     };
 } // namespace ae_memory
\ No newline at end of file
@@ -0,0 +1,362 @@
+/// \file ae_thread_caching_allocator.cpp
+/// The AeThreadCachingAllocator class is implemented.
+#include "ae_thread_caching_allocator.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <cassert>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace ae_memory {
+
+    namespace {
+
+        /// The ID to give the next allocator created. IDs are never reused, so a binding to a destroyed allocator can
+        /// not be mistaken for a binding to a new one.
+        std::atomic<std::uint64_t> nextAllocatorId{1};
+
+        /// The allocators that exist by ID, so exiting threads and threads out of bindings can tell which of the
+        /// allocators they are bound to have been destroyed.
+        struct LiveAllocators{
+            /// Guards the allocators, held while an exiting thread gives back its caches so the allocator can not be
+            /// destroyed meanwhile.
+            std::mutex m_mutex;
+
+            /// The allocators that exist.
+            std::unordered_map<std::uint64_t, AeThreadCachingAllocator*> m_allocators;
+        };
+
+        /// Gets the allocators that exist.
+        LiveAllocators& getLiveAllocators() {
+            static LiveAllocators liveAllocators;
+            return liveAllocators;
+        };
+
+    } // namespace
+
+
+
+    // Split the memory between the size classes' pools and the large allocator.
+    AeThreadCachingAllocator::AeThreadCachingAllocator(std::size_t const t_allocatedMemorySize,
+                                                       void* const t_allocatedMemoryPtr):
+            AeAllocatorBase(t_allocatedMemorySize, t_allocatedMemoryPtr),
+            m_allocatorId{nextAllocatorId.fetch_add(1, std::memory_order_relaxed)} {
+
+        // Round the memory for each size class down to a multiple of the largest size class so every pool is the same
+        // size, which lets deallocation find the size class of a block from its address alone.
+        m_sizeClassMemorySize = (t_allocatedMemorySize / 2 / NUM_SIZE_CLASSES) & ~(MAX_SIZE_CLASS - 1);
+        if (m_sizeClassMemorySize < 2 * MAX_SIZE_CLASS) {
+            throw std::runtime_error("Memory given to AeThreadCachingAllocator is too small for its size classes!");
+        };
+
+        // Each size class is aligned to its size so it satisfies any alignment up to its size.
+        for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+            std::size_t sizeClass = MIN_SIZE_CLASS << i;
+            m_sizeClasses[i].m_pool = std::make_unique<AePoolAllocator>(
+                    m_sizeClassMemorySize,
+                    addToPointer(i * m_sizeClassMemorySize, m_allocatedMemoryPtr),
+                    sizeClass,
+                    sizeClass);
+        };
+
+        m_largeAllocationMemoryPtr = addToPointer(NUM_SIZE_CLASSES * m_sizeClassMemorySize, m_allocatedMemoryPtr);
+        m_largeAllocator = std::make_unique<AeTlsfAllocator>(
+                t_allocatedMemorySize - NUM_SIZE_CLASSES * m_sizeClassMemorySize,
+                m_largeAllocationMemoryPtr);
+
+        LiveAllocators& liveAllocators = getLiveAllocators();
+        std::lock_guard<std::mutex> lock{liveAllocators.m_mutex};
+        liveAllocators.m_allocators.emplace(m_allocatorId, this);
+    };
+
+
+
+    // Stop exiting threads from giving back their caches, then return every cached block to its pool so the pools can
+    // check for leaks.
+    AeThreadCachingAllocator::~AeThreadCachingAllocator() noexcept {
+        {
+            LiveAllocators& liveAllocators = getLiveAllocators();
+            std::lock_guard<std::mutex> lock{liveAllocators.m_mutex};
+            liveAllocators.m_allocators.erase(m_allocatorId);
+        }
+
+        for (auto& threadCache: m_threadCaches) {
+            for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+                releaseThreadCache(threadCache, i, threadCache.m_numFreeBlocks[i]);
+            };
+        };
+
+        for (auto& sizeClass: m_sizeClasses) {
+            sizeClass.m_pool.reset();
+        };
+        m_largeAllocator.reset();
+        m_largeAllocationMemoryPtr = nullptr;
+    };
+
+
+
+    // Allocate from the thread's cache when possible, otherwise go to the shared back-end.
+    void* AeThreadCachingAllocator::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+
+        std::size_t sizeClassIndex = getSizeClassIndex(t_allocationSize, t_byteAlignment);
+
+        if (sizeClassIndex == NUM_SIZE_CLASSES) {
+            std::lock_guard<std::mutex> lock{m_largeAllocationMutex};
+            return m_largeAllocator->allocate(t_allocationSize, t_byteAlignment);
+        };
+
+        ThreadCache* threadCache = getThreadCache();
+        if (threadCache == nullptr) {
+            std::size_t sizeClass = MIN_SIZE_CLASS << sizeClassIndex;
+            std::lock_guard<std::mutex> lock{m_sizeClasses[sizeClassIndex].m_mutex};
+            return m_sizeClasses[sizeClassIndex].m_pool->allocate(sizeClass, sizeClass);
+        };
+
+        if (threadCache->m_numFreeBlocks[sizeClassIndex] == 0) {
+            refillThreadCache(*threadCache, sizeClassIndex);
+        };
+
+        // Pop the first free block off of the cache.
+        void* allocatedBlock = threadCache->m_freeBlocks[sizeClassIndex];
+        threadCache->m_freeBlocks[sizeClassIndex] = *static_cast<void**>(allocatedBlock);
+        threadCache->m_numFreeBlocks[sizeClassIndex] -= 1;
+
+        return allocatedBlock;
+    };
+
+
+
+    // The size class of a block is found from the pool its address is in.
+    void AeThreadCachingAllocator::deallocate(void* const t_allocatedMemoryPtr) noexcept {
+
+        // Ensure the address being deallocated is actually controlled by the allocator.
+        assert(t_allocatedMemoryPtr >= m_allocatedMemoryPtr &&
+               t_allocatedMemoryPtr < addToPointer(m_allocatedMemorySize, m_allocatedMemoryPtr) &&
+               "Memory being deallocated not in range of memory this allocator controls!");
+
+        if (t_allocatedMemoryPtr >= m_largeAllocationMemoryPtr) {
+            std::lock_guard<std::mutex> lock{m_largeAllocationMutex};
+            m_largeAllocator->deallocate(t_allocatedMemoryPtr);
+            return;
+        };
+
+        std::size_t sizeClassIndex = pointerDifference(t_allocatedMemoryPtr, m_allocatedMemoryPtr) /
+                                     m_sizeClassMemorySize;
+
+        ThreadCache* threadCache = getThreadCache();
+        if (threadCache == nullptr) {
+            std::lock_guard<std::mutex> lock{m_sizeClasses[sizeClassIndex].m_mutex};
+            m_sizeClasses[sizeClassIndex].m_pool->deallocate(t_allocatedMemoryPtr);
+            return;
+        };
+
+        // Push the block onto the front of the cache.
+        *static_cast<void**>(t_allocatedMemoryPtr) = threadCache->m_freeBlocks[sizeClassIndex];
+        threadCache->m_freeBlocks[sizeClassIndex] = t_allocatedMemoryPtr;
+        threadCache->m_numFreeBlocks[sizeClassIndex] += 1;
+
+        // Keep a batch cached so a thread alternating between allocating and deallocating does not go back and forth
+        // to the shared pool, and release the rest.
+        if (threadCache->m_numFreeBlocks[sizeClassIndex] >= 2 * CACHE_BATCH_SIZE) {
+            releaseThreadCache(*threadCache, sizeClassIndex, CACHE_BATCH_SIZE);
+        };
+    };
+
+
+
+    // Release everything the calling thread has cached, if it has a cache.
+    void AeThreadCachingAllocator::flushThreadCache() noexcept {
+        for (auto& binding: getThreadCacheBindings().m_bindings) {
+            if (binding.m_allocatorId == m_allocatorId && binding.m_threadCache != nullptr) {
+                for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+                    releaseThreadCache(*binding.m_threadCache, i, binding.m_threadCache->m_numFreeBlocks[i]);
+                };
+                return;
+            };
+        };
+    };
+
+
+
+    // Lock each size class in turn, the total is only a snapshot while other threads are allocating.
+    std::size_t AeThreadCachingAllocator::getMemoryInUse() const {
+        std::size_t memoryInUse = 0;
+        for (const auto& sizeClass: m_sizeClasses) {
+            std::lock_guard<std::mutex> lock{sizeClass.m_mutex};
+            memoryInUse += sizeClass.m_pool->getMemoryInUse();
+        };
+
+        std::lock_guard<std::mutex> lock{m_largeAllocationMutex};
+        return memoryInUse + m_largeAllocator->getMemoryInUse();
+    };
+
+
+
+    std::size_t AeThreadCachingAllocator::getLargestFreeBlock() const {
+        std::lock_guard<std::mutex> lock{m_largeAllocationMutex};
+        return m_largeAllocator->getLargestFreeBlock();
+    };
+
+
+
+    double AeThreadCachingAllocator::getFragmentation() const {
+        std::lock_guard<std::mutex> lock{m_largeAllocationMutex};
+        return m_largeAllocator->getFragmentation();
+    };
+
+
+
+    // Round the larger of the size and alignment up to a power of two no smaller than the smallest size class.
+    std::size_t AeThreadCachingAllocator::getSizeClassIndex(std::size_t const t_allocationSize,
+                                                            std::size_t const t_byteAlignment) {
+        std::size_t requiredSize = std::max(t_allocationSize, t_byteAlignment);
+
+        std::size_t sizeClassIndex = 0;
+        while (sizeClassIndex < NUM_SIZE_CLASSES && (MIN_SIZE_CLASS << sizeClassIndex) < requiredSize) {
+            sizeClassIndex++;
+        };
+
+        return sizeClassIndex;
+    };
+
+
+
+    // The cache of a thread is found through the thread's bindings, the first time a thread uses this allocator it is
+    // given an unused cache. A thread out of bindings reuses the bindings of allocators that have been destroyed.
+    AeThreadCachingAllocator::ThreadCache* AeThreadCachingAllocator::getThreadCache() noexcept {
+        ThreadCacheBindings& threadCacheBindings = getThreadCacheBindings();
+        for (auto& binding: threadCacheBindings.m_bindings) {
+            if (binding.m_allocatorId == m_allocatorId) {
+                return binding.m_threadCache;
+            };
+        };
+
+        ThreadCacheBinding* unusedBinding = nullptr;
+        for (auto& binding: threadCacheBindings.m_bindings) {
+            if (binding.m_allocatorId == 0) {
+                unusedBinding = &binding;
+                break;
+            };
+        };
+
+        if (unusedBinding == nullptr) {
+            LiveAllocators& liveAllocators = getLiveAllocators();
+            std::lock_guard<std::mutex> lock{liveAllocators.m_mutex};
+            for (auto& binding: threadCacheBindings.m_bindings) {
+                if (liveAllocators.m_allocators.count(binding.m_allocatorId) == 0) {
+                    unusedBinding = &binding;
+                    break;
+                };
+            };
+        };
+
+        // The thread has used too many allocators that still exist to keep a cache for this one as well.
+        if (unusedBinding == nullptr) {
+            return nullptr;
+        };
+
+        unusedBinding->m_allocatorId = m_allocatorId;
+        unusedBinding->m_threadCache = acquireThreadCache();
+        return unusedBinding->m_threadCache;
+    };
+
+
+
+    // Hand out the first cache no thread is using.
+    AeThreadCachingAllocator::ThreadCache* AeThreadCachingAllocator::acquireThreadCache() noexcept {
+        std::lock_guard<std::mutex> lock{m_threadCacheMutex};
+        for (auto& threadCache: m_threadCaches) {
+            if (!threadCache.m_isInUse) {
+                threadCache.m_isInUse = true;
+                m_numThreadCaches.fetch_add(1, std::memory_order_relaxed);
+                return &threadCache;
+            };
+        };
+        return nullptr;
+    };
+
+
+
+    // Empty the cache before another thread can be given it.
+    void AeThreadCachingAllocator::releaseExitingThreadCache(ThreadCache& t_threadCache) noexcept {
+        for (std::size_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+            releaseThreadCache(t_threadCache, i, t_threadCache.m_numFreeBlocks[i]);
+        };
+
+        std::lock_guard<std::mutex> lock{m_threadCacheMutex};
+        t_threadCache.m_isInUse = false;
+        m_numThreadCaches.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+
+
+    // The bindings of a thread are created the first time the thread uses any AeThreadCachingAllocator.
+    AeThreadCachingAllocator::ThreadCacheBindings& AeThreadCachingAllocator::getThreadCacheBindings() noexcept {
+        thread_local ThreadCacheBindings threadCacheBindings{};
+        return threadCacheBindings;
+    };
+
+
+
+    // Hold the lock of the allocators that exist so none of them can be destroyed while its cache is given back.
+    AeThreadCachingAllocator::ThreadCacheBindings::~ThreadCacheBindings() noexcept {
+        LiveAllocators& liveAllocators = getLiveAllocators();
+        std::lock_guard<std::mutex> lock{liveAllocators.m_mutex};
+        for (auto& binding: m_bindings) {
+            auto liveAllocator = liveAllocators.m_allocators.find(binding.m_allocatorId);
+            if (binding.m_threadCache != nullptr && liveAllocator != liveAllocators.m_allocators.end()) {
+                liveAllocator->second->releaseExitingThreadCache(*binding.m_threadCache);
+            };
+        };
+    };
+
+
+
+    // Take as many blocks as the pool has up to a batch, the allocation only fails if the pool has no blocks at all.
+    void AeThreadCachingAllocator::refillThreadCache(ThreadCache& t_threadCache, std::size_t const t_sizeClassIndex) {
+        std::size_t sizeClass = MIN_SIZE_CLASS << t_sizeClassIndex;
+        SizeClass& sharedSizeClass = m_sizeClasses[t_sizeClassIndex];
+
+        std::lock_guard<std::mutex> lock{sharedSizeClass.m_mutex};
+        try {
+            while (t_threadCache.m_numFreeBlocks[t_sizeClassIndex] < CACHE_BATCH_SIZE) {
+                void* block = sharedSizeClass.m_pool->allocate(sizeClass, sizeClass);
+                *static_cast<void**>(block) = t_threadCache.m_freeBlocks[t_sizeClassIndex];
+                t_threadCache.m_freeBlocks[t_sizeClassIndex] = block;
+                t_threadCache.m_numFreeBlocks[t_sizeClassIndex] += 1;
+            };
+        } catch (std::bad_alloc&) {
+            if (t_threadCache.m_numFreeBlocks[t_sizeClassIndex] == 0) {
+                throw;
+            };
+        };
+    };
+
+
+
+    // Pop the blocks off of the front of the cache and return them to the pool under a single lock.
+    void AeThreadCachingAllocator::releaseThreadCache(ThreadCache& t_threadCache,
+                                                      std::size_t const t_sizeClassIndex,
+                                                      std::size_t const t_numBlocks) {
+        assert(t_numBlocks <= t_threadCache.m_numFreeBlocks[t_sizeClassIndex] &&
+               "Cannot release more blocks than are cached!");
+
+        if (t_numBlocks == 0) {
+            return;
+        };
+
+        SizeClass& sharedSizeClass = m_sizeClasses[t_sizeClassIndex];
+        std::lock_guard<std::mutex> lock{sharedSizeClass.m_mutex};
+        for (std::size_t i = 0; i < t_numBlocks; i++) {
+            void* block = t_threadCache.m_freeBlocks[t_sizeClassIndex];
+            t_threadCache.m_freeBlocks[t_sizeClassIndex] = *static_cast<void**>(block);
+            sharedSizeClass.m_pool->deallocate(block);
+        };
+        t_threadCache.m_numFreeBlocks[t_sizeClassIndex] -= t_numBlocks;
+    };
+
+} //namespace ae_memory
@@ -0,0 +1,218 @@
+/// \file ae_thread_caching_allocator.hpp
+/// The AeThreadCachingAllocator class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+#include "ae_pool_allocator.hpp"
+#include "ae_tlsf_allocator.hpp"
+
+// libraries
+
+//std
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+
+namespace ae_memory {
+
+    /// A AeThreadCachingAllocator implements a thread-safe allocator that can be used from any number of threads at
+    /// once. Small allocations are rounded up to a power of two size class, each backed by its own AePoolAllocator, and
+    /// every thread keeps a cache of free blocks for each size class. Allocating and deallocating from the cache takes
+    /// no locks, the cache is only refilled from, or released to, the shared pool a batch of blocks at a time under the
+    /// lock of that size class. Allocations larger than the biggest size class come from a shared AeTlsfAllocator under
+    /// its own lock. Blocks freed by a different thread than the one that allocated them are cached by the freeing
+    /// thread. When a thread exits, its caches are returned to the shared pools and given back so other threads can use
+    /// them, and a thread forgets the allocators it used that have since been destroyed.
+    class AeThreadCachingAllocator: public AeAllocatorBase {
+
+    public:
+
+        /// The number of size classes, each twice as large as the previous.
+        static constexpr std::size_t NUM_SIZE_CLASSES = 7;
+
+        /// The size in bytes of the smallest size class.
+        static constexpr std::size_t MIN_SIZE_CLASS = 16;
+
+        /// The size in bytes of the largest size class, larger allocations come from the shared large allocator.
+        static constexpr std::size_t MAX_SIZE_CLASS = MIN_SIZE_CLASS << (NUM_SIZE_CLASSES - 1);
+
+        /// The number of blocks moved between a thread's cache and the shared pool at a time.
+        static constexpr std::size_t CACHE_BATCH_SIZE = 32;
+
+        /// The maximum number of threads that have a cache at once, any further threads lock the shared pools directly.
+        static constexpr std::size_t MAX_THREAD_CACHES = 64;
+
+        /// The maximum number of allocators a thread can have a cache for at once.
+        static constexpr std::size_t MAX_THREAD_CACHE_BINDINGS = 8;
+
+        /// Constructor of AeThreadCachingAllocator. Half of the memory is split evenly between the size classes and the
+        /// other half is used for the large allocations.
+        /// \param t_allocatedMemorySize The size of the pre-allocated memory this allocator will be responsible for.
+        /// \param t_allocatedMemoryPtr A pointer to the pre-allocated memory this allocator will be responsible for
+        /// managing.
+        AeThreadCachingAllocator(std::size_t t_allocatedMemorySize, void* t_allocatedMemoryPtr);
+
+        /// Destructor of the AeThreadCachingAllocator. No other thread may use the allocator while it is destroyed.
+        ~AeThreadCachingAllocator() noexcept override;
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeThreadCachingAllocator(const AeThreadCachingAllocator&) = delete;
+        AeThreadCachingAllocator& operator=(const AeThreadCachingAllocator&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeThreadCachingAllocator(AeThreadCachingAllocator&&) = delete;
+        AeThreadCachingAllocator& operator=(AeThreadCachingAllocator&&) = delete;
+
+        /// Allocates the specified amount of memory, this may be called from any thread.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the returned memory. This MUST be a power of 2!
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+
+        /// Deallocates the allocated memory by this allocator at this pointer, this may be called from any thread.
+        /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
+        void deallocate(void* t_allocatedMemoryPtr) noexcept override;
+
+        /// Returns all the blocks cached by the calling thread to the shared pools, which also happens when the thread
+        /// exits.
+        void flushThreadCache() noexcept;
+
+        /// Gets the number of bytes allocated from the shared pools and the large allocator, which includes the blocks
+        /// cached by threads.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const override;
+
+        /// Gets the largest allocation that could currently succeed, which is the largest free block of the large
+        /// allocator.
+        /// \return The size in bytes of the largest free block.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const override;
+
+        /// Gets how fragmented the free memory of the large allocator is, the size classes do not fragment.
+        /// \return The fragmentation of the large allocator.
+        [[nodiscard]] double getFragmentation() const override;
+
+        /// Gets the number of threads that currently have a cache.
+        /// \return The number of thread caches in use.
+        [[nodiscard]] std::size_t getNumThreadCaches() const {
+            return m_numThreadCaches.load(std::memory_order_relaxed);
+        };
+
+        /// Implements the equals comparison operator.
+        bool operator==(const AeThreadCachingAllocator&) const noexcept { return true;};
+
+        /// Implements the not equals comparison operator.
+        bool operator!=(const AeThreadCachingAllocator&) const noexcept { return false;};
+
+    private:
+
+        /// A size class's shared pool and the lock guarding it. Aligned to a cache line so threads locking different
+        /// size classes do not contend on the same cache line.
+        struct alignas(64) SizeClass{
+            /// Guards the pool.
+            mutable std::mutex m_mutex;
+
+            /// The pool the blocks of this size class are allocated from.
+            std::unique_ptr<AePoolAllocator> m_pool;
+        };
+
+        /// The free blocks a thread has cached for each size class. The first bytes of each free block point to the
+        /// next free block. Aligned to a cache line so the caches of different threads do not share cache lines.
+        struct alignas(64) ThreadCache{
+            /// The first free block of each size class.
+            std::array<void*, NUM_SIZE_CLASSES> m_freeBlocks{};
+
+            /// The number of free blocks cached for each size class.
+            std::array<std::size_t, NUM_SIZE_CLASSES> m_numFreeBlocks{};
+
+            /// True while the cache is given to a thread.
+            bool m_isInUse = false;
+        };
+
+        /// Binds a thread's cache to the allocator it belongs to.
+        struct ThreadCacheBinding{
+            /// The ID of the allocator, 0 if the binding is unused.
+            std::uint64_t m_allocatorId = 0;
+
+            /// The thread's cache of the allocator, nullptr if the allocator had no caches left to give out.
+            ThreadCache* m_threadCache = nullptr;
+        };
+
+        /// The caches a thread has been given by each allocator it has used. Destroyed when the thread exits, which
+        /// gives the caches of the allocators that still exist back to them.
+        struct ThreadCacheBindings{
+            /// Gives the thread's caches back to the allocators that still exist.
+            ~ThreadCacheBindings() noexcept;
+
+            /// The binding of each allocator the thread has a cache for.
+            std::array<ThreadCacheBinding, MAX_THREAD_CACHE_BINDINGS> m_bindings{};
+        };
+
+        /// Gets the calling thread's bindings.
+        /// \return The bindings of the calling thread.
+        static ThreadCacheBindings& getThreadCacheBindings() noexcept;
+
+        /// Gets the index of the smallest size class that satisfies both the size and the alignment.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the memory to be allocated.
+        /// \return The index of the size class, NUM_SIZE_CLASSES if the allocation is too large for any size class.
+        static std::size_t getSizeClassIndex(std::size_t t_allocationSize, std::size_t t_byteAlignment);
+
+        /// Gets the calling thread's cache, giving the thread a cache if it does not have one yet.
+        /// \return The calling thread's cache, or nullptr if there are no caches left to give out.
+        ThreadCache* getThreadCache() noexcept;
+
+        /// Gives an unused cache to the calling thread.
+        /// \return The cache, or nullptr if every cache is in use.
+        ThreadCache* acquireThreadCache() noexcept;
+
+        /// Returns the blocks of an exiting thread's cache to the shared pools and makes the cache unused.
+        /// \param t_threadCache The cache of the exiting thread.
+        void releaseExitingThreadCache(ThreadCache& t_threadCache) noexcept;
+
+        /// Moves a batch of blocks from the shared pool of a size class to a thread's cache.
+        /// \param t_threadCache The cache to refill.
+        /// \param t_sizeClassIndex The index of the size class to refill.
+        void refillThreadCache(ThreadCache& t_threadCache, std::size_t t_sizeClassIndex);
+
+        /// Moves blocks from a thread's cache back to the shared pool of a size class.
+        /// \param t_threadCache The cache to release the blocks from.
+        /// \param t_sizeClassIndex The index of the size class to release.
+        /// \param t_numBlocks The number of blocks to release, must not be more than the number cached.
+        void releaseThreadCache(ThreadCache& t_threadCache, std::size_t t_sizeClassIndex, std::size_t t_numBlocks);
+
+        /// A unique ID identifying this allocator to the threads that have a cache for it, never reused so a thread
+        /// can not mistake a new allocator for a destroyed one.
+        std::uint64_t m_allocatorId;
+
+        /// The size in bytes of the memory given to each size class's pool.
+        std::size_t m_sizeClassMemorySize;
+
+        /// The start of the memory given to the large allocator.
+        void* m_largeAllocationMemoryPtr;
+
+        /// The size classes.
+        std::array<SizeClass, NUM_SIZE_CLASSES> m_sizeClasses;
+
+        /// Guards the large allocator.
+        mutable std::mutex m_largeAllocationMutex;
+
+        /// The allocator used for allocations larger than the largest size class.
+        std::unique_ptr<AeTlsfAllocator> m_largeAllocator;
+
+        /// The caches given to threads.
+        std::array<ThreadCache, MAX_THREAD_CACHES> m_threadCaches;
+
+        /// Guards which caches are in use.
+        std::mutex m_threadCacheMutex;
+
+        /// The number of caches in use by threads.
+        std::atomic<std::size_t> m_numThreadCaches{0};
+
+    protected:
+
+    };
+} // namespace ae_memory
@@ -0,0 +1,333 @@
+/// \file ae_tlsf_allocator.cpp
+/// The AeTlsfAllocator class is implemented.
+#include "ae_tlsf_allocator.hpp"
+
+// dependencies
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+
+namespace ae_memory {
+
+    namespace {
+
+        /// Finds the index of the highest set bit.
+        std::size_t findLastSetBit(std::size_t t_value) {
+            return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(t_value);
+        };
+    }
+
+
+
+    // Create a single free block covering the memory, followed by an empty allocated block that stops blocks being
+    // merged past the end of the memory.
+    AeTlsfAllocator::AeTlsfAllocator(std::size_t const t_allocatedMemorySize,
+                                     void* const t_allocatedMemoryPtr) noexcept:
+            AeAllocatorBase(t_allocatedMemorySize, t_allocatedMemoryPtr) {
+
+        void* firstBlockPtr = getAlignedAddress(t_allocatedMemoryPtr, BLOCK_ALIGNMENT);
+        std::size_t alignmentOffset = pointerDifference(firstBlockPtr, t_allocatedMemoryPtr);
+
+        assert(t_allocatedMemorySize >= alignmentOffset + 2 * BLOCK_HEADER_OVERHEAD + MIN_BLOCK_SIZE &&
+               "Memory allocated to AeTlsfAllocator is not big enough for a single block.");
+
+        std::size_t blockSize = (t_allocatedMemorySize - alignmentOffset - 2 * BLOCK_HEADER_OVERHEAD) &
+                                ~(BLOCK_ALIGNMENT - 1);
+        blockSize = std::min(blockSize, MAX_BLOCK_SIZE - BLOCK_ALIGNMENT);
+
+        auto* firstBlock = static_cast<BlockHeader*>(firstBlockPtr);
+        firstBlock->m_prevPhysicalBlock = nullptr;
+        firstBlock->m_sizeAndFlags = blockSize | BLOCK_FREE_FLAG;
+
+        BlockHeader* sentinelBlock = getNextPhysicalBlock(firstBlock);
+        sentinelBlock->m_prevPhysicalBlock = firstBlock;
+        sentinelBlock->m_sizeAndFlags = 0;
+
+        insertFreeBlock(firstBlock);
+    };
+
+
+
+    AeTlsfAllocator::~AeTlsfAllocator() noexcept {
+        assert(m_memoryInUse == 0 && "Huston we have a leak... in a TLSF allocator!");
+    };
+
+
+
+    // Find a block big enough for the allocation plus any alignment padding, then give back the unused memory at the
+    // start and end of the block as free blocks.
+    void* AeTlsfAllocator::allocate(std::size_t const t_allocationSize, std::size_t const t_byteAlignment) {
+
+        assert(t_byteAlignment != 0 && (t_byteAlignment & (t_byteAlignment - 1)) == 0 &&
+               "AeTlsfAllocator alignment must be a power of 2!");
+
+        std::size_t byteAlignment = std::max(t_byteAlignment, BLOCK_ALIGNMENT);
+        std::size_t blockSize = std::max((t_allocationSize + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1),
+                                         MIN_BLOCK_SIZE);
+
+        // Larger alignments need room to move the start of the block forward, and to turn the skipped memory into a
+        // free block.
+        std::size_t searchSize = blockSize;
+        if (byteAlignment > BLOCK_ALIGNMENT) {
+            searchSize += byteAlignment + BLOCK_HEADER_OVERHEAD + MIN_BLOCK_SIZE;
+        };
+
+        if (t_allocationSize >= MAX_BLOCK_SIZE || searchSize >= MAX_BLOCK_SIZE) {
+            throw std::bad_alloc();
+        };
+
+        BlockHeader* block = locateFreeBlock(searchSize);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        };
+        block->m_sizeAndFlags &= ~BLOCK_FREE_FLAG;
+
+        if (byteAlignment > BLOCK_ALIGNMENT) {
+            void* blockMemory = getBlockMemory(block);
+            void* alignedMemory = getAlignedAddress(blockMemory, byteAlignment);
+            std::size_t leadingSize = pointerDifference(alignedMemory, blockMemory);
+
+            // The skipped memory must be able to hold a free block.
+            if (leadingSize != 0 && leadingSize < BLOCK_HEADER_OVERHEAD + MIN_BLOCK_SIZE) {
+                alignedMemory = getAlignedAddress(addToPointer(BLOCK_HEADER_OVERHEAD + MIN_BLOCK_SIZE, blockMemory),
+                                                  byteAlignment);
+                leadingSize = pointerDifference(alignedMemory, blockMemory);
+            };
+
+            if (leadingSize != 0) {
+                block = trimBlockLeading(block, leadingSize);
+            };
+        };
+
+        trimBlock(block, blockSize);
+
+        m_memoryInUse += getBlockSize(block) + BLOCK_HEADER_OVERHEAD;
+
+        return getBlockMemory(block);
+    };
+
+
+
+    // Merge the block with its free neighbours before putting it back into a free list.
+    void AeTlsfAllocator::deallocate(void* const t_allocatedMemoryPtr) noexcept {
+
+        // Ensure the address being deallocated is actually controlled by the allocator.
+        assert(t_allocatedMemoryPtr > m_allocatedMemoryPtr &&
+               t_allocatedMemoryPtr < addToPointer(m_allocatedMemorySize, m_allocatedMemoryPtr) &&
+               "Memory being deallocated not in range of memory this allocator controls!");
+
+        BlockHeader* block = getBlockFromMemory(t_allocatedMemoryPtr);
+
+        assert(!isBlockFree(block) && "Memory being deallocated has already been deallocated!");
+
+        m_memoryInUse -= getBlockSize(block) + BLOCK_HEADER_OVERHEAD;
+        block->m_sizeAndFlags |= BLOCK_FREE_FLAG;
+
+        BlockHeader* prevBlock = block->m_prevPhysicalBlock;
+        if (prevBlock != nullptr && isBlockFree(prevBlock)) {
+            removeFreeBlock(prevBlock);
+            block = mergeWithNextBlock(prevBlock);
+        };
+
+        BlockHeader* nextBlock = getNextPhysicalBlock(block);
+        if (isBlockFree(nextBlock)) {
+            removeFreeBlock(nextBlock);
+            block = mergeWithNextBlock(block);
+        };
+
+        insertFreeBlock(block);
+    };
+
+
+
+    // Only the list that the largest free block could be in has to be searched.
+    std::size_t AeTlsfAllocator::getLargestFreeBlock() const {
+        if (m_flBitmap == 0) {
+            return 0;
+        };
+
+        std::size_t flIndex = findLastSetBit(m_flBitmap);
+        std::size_t slIndex = findLastSetBit(m_slBitmap[flIndex]);
+
+        std::size_t largestBlockSize = 0;
+        for (BlockHeader* block = m_freeBlocks[flIndex][slIndex]; block != nullptr; block = block->m_nextFreeBlock) {
+            largestBlockSize = std::max(largestBlockSize, getBlockSize(block));
+        };
+        return largestBlockSize;
+    };
+
+
+
+    AeTlsfAllocator::BlockHeader* AeTlsfAllocator::getNextPhysicalBlock(const BlockHeader* const t_block) {
+        return static_cast<BlockHeader*>(addToPointer(getBlockSize(t_block), getBlockMemory(t_block)));
+    };
+
+
+
+    void* AeTlsfAllocator::getBlockMemory(const BlockHeader* const t_block) {
+        return addToPointer(BLOCK_HEADER_OVERHEAD, const_cast<BlockHeader*>(t_block));
+    };
+
+
+
+    AeTlsfAllocator::BlockHeader* AeTlsfAllocator::getBlockFromMemory(const void* const t_memory) {
+        return static_cast<BlockHeader*>(subtractFromPointer(BLOCK_HEADER_OVERHEAD, const_cast<void*>(t_memory)));
+    };
+
+
+
+    // Small blocks are split linearly, larger blocks by their highest bit and then linearly within that power of two.
+    void AeTlsfAllocator::mappingInsert(std::size_t const t_size, std::size_t& t_flIndex, std::size_t& t_slIndex) {
+        if (t_size < SMALL_BLOCK_SIZE) {
+            t_flIndex = 0;
+            t_slIndex = t_size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+        } else {
+            std::size_t lastSetBit = findLastSetBit(t_size);
+            t_slIndex = (t_size >> (lastSetBit - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+            t_flIndex = lastSetBit - (FL_INDEX_SHIFT - 1);
+        };
+    };
+
+
+
+    // Round the size up to the start of the next list so every block in the list found is big enough.
+    void AeTlsfAllocator::mappingSearch(std::size_t const t_size, std::size_t& t_flIndex, std::size_t& t_slIndex) {
+        std::size_t size = t_size;
+        if (size >= SMALL_BLOCK_SIZE) {
+            size += (std::size_t{1} << (findLastSetBit(size) - SL_INDEX_COUNT_LOG2)) - 1;
+        };
+        mappingInsert(size, t_flIndex, t_slIndex);
+    };
+
+
+
+    // Use the bitmaps to find the first non-empty list at or above the list for the size.
+    AeTlsfAllocator::BlockHeader* AeTlsfAllocator::locateFreeBlock(std::size_t const t_size) {
+        std::size_t flIndex = 0;
+        std::size_t slIndex = 0;
+        mappingSearch(t_size, flIndex, slIndex);
+
+        if (flIndex >= FL_INDEX_COUNT) {
+            return nullptr;
+        };
+
+        uint32_t slBitmap = m_slBitmap[flIndex] & (~uint32_t{0} << slIndex);
+        if (slBitmap == 0) {
+            uint32_t flBitmap = m_flBitmap & (~uint32_t{0} << (flIndex + 1));
+            if (flBitmap == 0) {
+                return nullptr;
+            };
+            flIndex = __builtin_ctz(flBitmap);
+            slBitmap = m_slBitmap[flIndex];
+        };
+        slIndex = __builtin_ctz(slBitmap);
+
+        BlockHeader* block = m_freeBlocks[flIndex][slIndex];
+        removeFreeBlock(block);
+        return block;
+    };
+
+
+
+    // Push the block onto the front of its list and mark the list as having blocks.
+    void AeTlsfAllocator::insertFreeBlock(BlockHeader* const t_block) {
+        std::size_t flIndex = 0;
+        std::size_t slIndex = 0;
+        mappingInsert(getBlockSize(t_block), flIndex, slIndex);
+
+        BlockHeader* firstBlock = m_freeBlocks[flIndex][slIndex];
+        t_block->m_prevFreeBlock = nullptr;
+        t_block->m_nextFreeBlock = firstBlock;
+        if (firstBlock != nullptr) {
+            firstBlock->m_prevFreeBlock = t_block;
+        };
+        m_freeBlocks[flIndex][slIndex] = t_block;
+
+        m_flBitmap |= uint32_t{1} << flIndex;
+        m_slBitmap[flIndex] |= uint32_t{1} << slIndex;
+
+        m_freeMemory += getBlockSize(t_block) + BLOCK_HEADER_OVERHEAD;
+        m_numFreeBlocks++;
+    };
+
+
+
+    // Unlink the block from its list and clear the bitmaps if the list is now empty.
+    void AeTlsfAllocator::removeFreeBlock(BlockHeader* const t_block) {
+        std::size_t flIndex = 0;
+        std::size_t slIndex = 0;
+        mappingInsert(getBlockSize(t_block), flIndex, slIndex);
+
+        if (t_block->m_prevFreeBlock != nullptr) {
+            t_block->m_prevFreeBlock->m_nextFreeBlock = t_block->m_nextFreeBlock;
+        } else {
+            m_freeBlocks[flIndex][slIndex] = t_block->m_nextFreeBlock;
+        };
+        if (t_block->m_nextFreeBlock != nullptr) {
+            t_block->m_nextFreeBlock->m_prevFreeBlock = t_block->m_prevFreeBlock;
+        };
+
+        if (m_freeBlocks[flIndex][slIndex] == nullptr) {
+            m_slBitmap[flIndex] &= ~(uint32_t{1} << slIndex);
+            if (m_slBitmap[flIndex] == 0) {
+                m_flBitmap &= ~(uint32_t{1} << flIndex);
+            };
+        };
+
+        m_freeMemory -= getBlockSize(t_block) + BLOCK_HEADER_OVERHEAD;
+        m_numFreeBlocks--;
+    };
+
+
+
+    // The block following a freshly allocated block is never free, since free blocks are always merged, so the
+    // remainder does not need to be merged.
+    void AeTlsfAllocator::trimBlock(BlockHeader* const t_block, std::size_t const t_size) {
+        std::size_t blockSize = getBlockSize(t_block);
+        if (blockSize < t_size + BLOCK_HEADER_OVERHEAD + MIN_BLOCK_SIZE) {
+            return;
+        };
+
+        auto* remainingBlock = static_cast<BlockHeader*>(addToPointer(t_size, getBlockMemory(t_block)));
+        remainingBlock->m_prevPhysicalBlock = t_block;
+        remainingBlock->m_sizeAndFlags = (blockSize - t_size - BLOCK_HEADER_OVERHEAD) | BLOCK_FREE_FLAG;
+        getNextPhysicalBlock(remainingBlock)->m_prevPhysicalBlock = remainingBlock;
+
+        t_block->m_sizeAndFlags = t_size | (t_block->m_sizeAndFlags & BLOCK_FREE_FLAG);
+
+        insertFreeBlock(remainingBlock);
+    };
+
+
+
+    // The block preceding a freshly allocated block is never free, so the leading block does not need to be merged.
+    AeTlsfAllocator::BlockHeader* AeTlsfAllocator::trimBlockLeading(BlockHeader* const t_block,
+                                                                    std::size_t const t_leadingSize) {
+        std::size_t blockSize = getBlockSize(t_block);
+
+        auto* remainingBlock = static_cast<BlockHeader*>(addToPointer(t_leadingSize, t_block));
+        remainingBlock->m_prevPhysicalBlock = t_block;
+        remainingBlock->m_sizeAndFlags = blockSize - t_leadingSize;
+        getNextPhysicalBlock(remainingBlock)->m_prevPhysicalBlock = remainingBlock;
+
+        t_block->m_sizeAndFlags = (t_leadingSize - BLOCK_HEADER_OVERHEAD) | BLOCK_FREE_FLAG;
+        insertFreeBlock(t_block);
+
+        return remainingBlock;
+    };
+
+
+
+    // Absorb the following block, including its header, into the block.
+    AeTlsfAllocator::BlockHeader* AeTlsfAllocator::mergeWithNextBlock(BlockHeader* const t_block) {
+        BlockHeader* nextBlock = getNextPhysicalBlock(t_block);
+        t_block->m_sizeAndFlags = (getBlockSize(t_block) + BLOCK_HEADER_OVERHEAD + getBlockSize(nextBlock)) |
+                                  BLOCK_FREE_FLAG;
+        getNextPhysicalBlock(t_block)->m_prevPhysicalBlock = t_block;
+        return t_block;
+    };
+
+} //namespace ae_memory
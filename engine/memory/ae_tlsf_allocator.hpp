@@ -0,0 +1,182 @@
+/// \file ae_tlsf_allocator.hpp
+/// The AeTlsfAllocator class is defined.
+#pragma once
+
+// dependencies
+#include "ae_allocator_base.hpp"
+
+// libraries
+
+//std
+#include <cstdint>
+#include <cstdlib>
+
+namespace ae_memory {
+
+    /// A AeTlsfAllocator implements a two level segregated fit (TLSF) allocator. Free blocks are kept in lists
+    /// segregated by size, a first level for each power of two and a second level splitting each power of two into
+    /// linear steps, with a bitmap recording which lists have blocks. Allocation and deallocation take constant time
+    /// regardless of how many blocks exist, and freed blocks are immediately merged with free neighbours so the memory
+    /// does not fragment into unusably small blocks.
+    class AeTlsfAllocator: public AeAllocatorBase {
+
+    public:
+
+        /// Constructor of AeTlsfAllocator.
+        /// \param t_allocatedMemorySize The size of the pre-allocated memory this allocator will be responsible for.
+        /// \param t_allocatedMemoryPtr A pointer to the pre-allocated memory this allocator will be responsible for
+        /// managing.
+        AeTlsfAllocator(std::size_t t_allocatedMemorySize,
+                        void* t_allocatedMemoryPtr) noexcept;
+
+        /// Destructor of the AeTlsfAllocator.
+        ~AeTlsfAllocator() noexcept override;
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeTlsfAllocator(const AeTlsfAllocator&) = delete;
+        AeTlsfAllocator& operator=(const AeTlsfAllocator&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeTlsfAllocator(AeTlsfAllocator&&) = delete;
+        AeTlsfAllocator& operator=(AeTlsfAllocator&&) = delete;
+
+        /// Allocates the specified amount of memory.
+        /// \param t_allocationSize The size of the memory in bytes to be allocated.
+        /// \param t_byteAlignment The alignment of the returned memory. This MUST be a power of 2!
+        void* allocate(std::size_t t_allocationSize, std::size_t t_byteAlignment) override;
+
+        /// Deallocates the allocated memory by this allocator at this pointer and merges it with the neighbouring free
+        /// blocks.
+        /// \param t_allocatedMemoryPtr The pointer to the allocated memory which is to be freed.
+        void deallocate(void* t_allocatedMemoryPtr) noexcept override;
+
+        /// Gets the number of bytes currently allocated, including the block headers.
+        /// \return The number of bytes in use.
+        [[nodiscard]] std::size_t getMemoryInUse() const override { return m_memoryInUse; };
+
+        /// Gets the number of bytes that are free, including the block headers of the free blocks.
+        /// \return The number of free bytes.
+        [[nodiscard]] std::size_t getFreeMemory() const { return m_freeMemory; };
+
+        /// Gets the number of free blocks.
+        /// \return The number of free blocks.
+        [[nodiscard]] std::size_t getNumFreeBlocks() const { return m_numFreeBlocks; };
+
+        /// Gets the largest allocation that could currently succeed with the default alignment.
+        /// \return The size of the largest free block available for allocation.
+        [[nodiscard]] std::size_t getLargestFreeBlock() const override;
+
+        /// Implements the equals comparison operator.
+        bool operator==(const AeTlsfAllocator&) const noexcept { return true;};
+
+        /// Implements the not equals comparison operator.
+        bool operator!=(const AeTlsfAllocator&) const noexcept { return false;};
+
+    private:
+
+        /// The header at the start of every block. The free list pointers are only valid while the block is free, they
+        /// overlap the first bytes of the memory given out when the block is allocated.
+        struct BlockHeader{
+            /// The block physically preceding this block.
+            BlockHeader* m_prevPhysicalBlock = nullptr;
+
+            /// The size of the block's usable memory, the lowest bits are the block's flags.
+            std::size_t m_sizeAndFlags = 0;
+
+            /// The next block in the free list this block belongs to.
+            BlockHeader* m_nextFreeBlock = nullptr;
+
+            /// The previous block in the free list this block belongs to.
+            BlockHeader* m_prevFreeBlock = nullptr;
+        };
+
+        /// The number of bytes of the header that remain in front of the memory given out.
+        static constexpr std::size_t BLOCK_HEADER_OVERHEAD = sizeof(BlockHeader*) + sizeof(std::size_t);
+
+        /// Block sizes are multiples of this, which is also the smallest alignment of the memory given out.
+        static constexpr std::size_t BLOCK_ALIGNMENT = sizeof(void*);
+
+        /// The smallest block, large enough to store the free list pointers once it is freed.
+        static constexpr std::size_t MIN_BLOCK_SIZE = sizeof(BlockHeader) - BLOCK_HEADER_OVERHEAD;
+
+        /// The flag set in the block size when the block is free.
+        static constexpr std::size_t BLOCK_FREE_FLAG = 1;
+
+        /// The second level splits every power of two into 2^SL_INDEX_COUNT_LOG2 lists.
+        static constexpr std::size_t SL_INDEX_COUNT_LOG2 = 5;
+        static constexpr std::size_t SL_INDEX_COUNT = std::size_t{1} << SL_INDEX_COUNT_LOG2;
+
+        /// Blocks smaller than SMALL_BLOCK_SIZE are all in the first first level list, split linearly.
+        static constexpr std::size_t FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + (BLOCK_ALIGNMENT == 8 ? 3 : 2);
+        static constexpr std::size_t SMALL_BLOCK_SIZE = std::size_t{1} << FL_INDEX_SHIFT;
+
+        /// The largest block is just under 2^FL_INDEX_MAX bytes.
+        static constexpr std::size_t FL_INDEX_MAX = sizeof(void*) == 8 ? 38 : 30;
+        static constexpr std::size_t FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+        static constexpr std::size_t MAX_BLOCK_SIZE = std::size_t{1} << FL_INDEX_MAX;
+
+        /// Gets the size of a block without its flags.
+        static std::size_t getBlockSize(const BlockHeader* t_block) { return t_block->m_sizeAndFlags & ~BLOCK_FREE_FLAG; };
+
+        /// Checks if a block is free.
+        static bool isBlockFree(const BlockHeader* t_block) { return t_block->m_sizeAndFlags & BLOCK_FREE_FLAG; };
+
+        /// Gets the block physically following a block.
+        static BlockHeader* getNextPhysicalBlock(const BlockHeader* t_block);
+
+        /// Gets the memory given out for a block.
+        static void* getBlockMemory(const BlockHeader* t_block);
+
+        /// Gets the block from the memory given out for it.
+        static BlockHeader* getBlockFromMemory(const void* t_memory);
+
+        /// Calculates the first and second level list indexes a block of the specified size is stored in.
+        static void mappingInsert(std::size_t t_size, std::size_t& t_flIndex, std::size_t& t_slIndex);
+
+        /// Calculates the first and second level list indexes to start searching in for a block of at least the
+        /// specified size. The size is rounded up to the next list so any block found is big enough.
+        static void mappingSearch(std::size_t t_size, std::size_t& t_flIndex, std::size_t& t_slIndex);
+
+        /// Finds a free block of at least the specified size using the bitmaps, and removes it from its free list.
+        /// \return The free block, nullptr if no block is big enough.
+        BlockHeader* locateFreeBlock(std::size_t t_size);
+
+        /// Adds a free block to the free list for its size.
+        void insertFreeBlock(BlockHeader* t_block);
+
+        /// Removes a free block from the free list for its size.
+        void removeFreeBlock(BlockHeader* t_block);
+
+        /// Splits the end of a block off into a new free block if the remainder can hold a block.
+        void trimBlock(BlockHeader* t_block, std::size_t t_size);
+
+        /// Splits the start of a free block off into a new free block so the remaining block's memory is at the
+        /// specified address.
+        /// \return The remaining block.
+        BlockHeader* trimBlockLeading(BlockHeader* t_block, std::size_t t_leadingSize);
+
+        /// Merges a free block with the physically following block, which must also be free and not in a free list.
+        BlockHeader* mergeWithNextBlock(BlockHeader* t_block);
+
+        /// Bit per first level index, set when any of its second level lists has a block.
+        uint32_t m_flBitmap = 0;
+
+        /// Bit per second level list, set when the list has a block.
+        uint32_t m_slBitmap[FL_INDEX_COUNT]{};
+
+        /// The first block of each free list.
+        BlockHeader* m_freeBlocks[FL_INDEX_COUNT][SL_INDEX_COUNT]{};
+
+        /// Tracks how much of the allocator's memory is currently being used, including the block headers.
+        std::size_t m_memoryInUse = 0;
+
+        /// Tracks how much of the allocator's memory is free, including the block headers.
+        std::size_t m_freeMemory = 0;
+
+        /// Tracks the number of free blocks.
+        std::size_t m_numFreeBlocks = 0;
+
+    protected:
+
+    };
+} // namespace ae_memory
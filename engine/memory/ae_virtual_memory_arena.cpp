@@ -0,0 +1,239 @@
+/// \file ae_virtual_memory_arena.cpp
+/// The AeVirtualMemoryArena class is implemented.
+#include "ae_virtual_memory_arena.hpp"
+
+// dependencies
+#include "ae_allocator_base.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ae_memory {
+
+    // Huge pages are committed a huge page at a time, otherwise memory is committed in chunks of at least a page.
+    AeVirtualMemoryArena::AeVirtualMemoryArena(std::size_t const t_reservedSize,
+                                               VirtualMemoryHugePages const t_hugePages) :
+            m_hugePages{t_hugePages} {
+
+#if defined(_WIN32)
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        std::size_t pageSize = static_cast<std::size_t>(systemInfo.dwAllocationGranularity);
+        m_hugePages = virtualMemoryHugePages_none;
+#else
+        std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+        m_commitGranularity = m_hugePages == virtualMemoryHugePages_none ?
+                              std::max(DEFAULT_COMMIT_GRANULARITY, pageSize) :
+                              std::max(HUGE_PAGE_SIZE, pageSize);
+
+        std::size_t numChunks = (t_reservedSize + m_commitGranularity - 1) / m_commitGranularity;
+        m_reservedSize = numChunks * m_commitGranularity;
+        m_committedChunks.resize(numChunks, false);
+
+        reserveAddressRange();
+    };
+
+
+
+    AeVirtualMemoryArena::~AeVirtualMemoryArena() {
+#if defined(_WIN32)
+        VirtualFree(m_reservedMemoryPtr, 0, MEM_RELEASE);
+#else
+        munmap(m_reservedMemoryPtr, m_reservedSize);
+#endif
+        m_reservedMemoryPtr = nullptr;
+    };
+
+
+
+    // Find the runs of chunks in the range that are not committed yet and commit each run with a single call.
+    void AeVirtualMemoryArena::commit(void* const t_rangePtr, std::size_t const t_rangeSize) {
+        if (t_rangeSize == 0) {
+            return;
+        };
+
+        assert(t_rangePtr >= m_reservedMemoryPtr &&
+               AeAllocatorBase::pointerDifference(t_rangePtr, m_reservedMemoryPtr) + t_rangeSize <= m_reservedSize &&
+               "Range to commit is not in the arena!");
+
+        std::size_t rangeStart = AeAllocatorBase::pointerDifference(t_rangePtr, m_reservedMemoryPtr);
+        std::size_t firstChunk = rangeStart / m_commitGranularity;
+        std::size_t endChunk = (rangeStart + t_rangeSize + m_commitGranularity - 1) / m_commitGranularity;
+
+        std::size_t chunk = firstChunk;
+        while (chunk < endChunk) {
+            if (m_committedChunks[chunk]) {
+                chunk++;
+                continue;
+            };
+
+            std::size_t runStart = chunk;
+            while (chunk < endChunk && !m_committedChunks[chunk]) {
+                chunk++;
+            };
+            commitChunks(runStart, chunk - runStart);
+        };
+    };
+
+
+
+    // Only chunks entirely within the range are decommitted, so memory next to the range that is still in use is kept.
+    void AeVirtualMemoryArena::decommit(void* const t_rangePtr, std::size_t const t_rangeSize) noexcept {
+        assert(t_rangePtr >= m_reservedMemoryPtr &&
+               AeAllocatorBase::pointerDifference(t_rangePtr, m_reservedMemoryPtr) + t_rangeSize <= m_reservedSize &&
+               "Range to decommit is not in the arena!");
+
+        std::size_t rangeStart = AeAllocatorBase::pointerDifference(t_rangePtr, m_reservedMemoryPtr);
+        std::size_t firstChunk = (rangeStart + m_commitGranularity - 1) / m_commitGranularity;
+        std::size_t endChunk = (rangeStart + t_rangeSize) / m_commitGranularity;
+
+        std::size_t chunk = firstChunk;
+        while (chunk < endChunk) {
+            if (!m_committedChunks[chunk]) {
+                chunk++;
+                continue;
+            };
+
+            std::size_t runStart = chunk;
+            while (chunk < endChunk && m_committedChunks[chunk]) {
+                chunk++;
+            };
+            decommitChunks(runStart, chunk - runStart);
+        };
+    };
+
+
+
+    void AeVirtualMemoryArena::reset() noexcept {
+        decommit(m_reservedMemoryPtr, m_reservedSize);
+    };
+
+
+
+    void* AeVirtualMemoryArena::alignUpToCommitGranularity(void* const t_ptr) const {
+        std::size_t offset = AeAllocatorBase::pointerDifference(t_ptr, m_reservedMemoryPtr);
+        offset = (offset + m_commitGranularity - 1) / m_commitGranularity * m_commitGranularity;
+        return AeAllocatorBase::addToPointer(offset, m_reservedMemoryPtr);
+    };
+
+
+
+    void* AeVirtualMemoryArena::alignDownToCommitGranularity(void* const t_ptr) const {
+        std::size_t offset = AeAllocatorBase::pointerDifference(t_ptr, m_reservedMemoryPtr);
+        offset = offset / m_commitGranularity * m_commitGranularity;
+        return AeAllocatorBase::addToPointer(offset, m_reservedMemoryPtr);
+    };
+
+
+
+    // The address range is reserved without any access so touching memory that has not been committed faults.
+    void AeVirtualMemoryArena::reserveAddressRange() {
+#if defined(_WIN32)
+        m_reservedMemoryPtr = VirtualAlloc(nullptr, m_reservedSize, MEM_RESERVE, PAGE_NOACCESS);
+        if (m_reservedMemoryPtr == nullptr) {
+            throw std::bad_alloc();
+        };
+#else
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+#if defined(MAP_HUGETLB)
+        // The reserved huge pages are taken for the whole range up front, since touching a huge page that could not be
+        // taken later would crash instead of failing to commit.
+        if (m_hugePages == virtualMemoryHugePages_explicit) {
+            void* hugeTlbPtr = mmap(nullptr, m_reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                                    -1, 0);
+            if (hugeTlbPtr != MAP_FAILED) {
+                m_reservedMemoryPtr = hugeTlbPtr;
+                return;
+            };
+        };
+#endif
+
+        if (m_hugePages == virtualMemoryHugePages_none) {
+            void* reservedPtr = mmap(nullptr, m_reservedSize, PROT_NONE, flags, -1, 0);
+            if (reservedPtr == MAP_FAILED) {
+                throw std::bad_alloc();
+            };
+            m_reservedMemoryPtr = reservedPtr;
+            return;
+        };
+
+        // Transparent huge pages can only back memory aligned to a huge page, so reserve an extra huge page and unmap
+        // the unaligned ends.
+        m_hugePages = virtualMemoryHugePages_transparent;
+        std::size_t paddedSize = m_reservedSize + HUGE_PAGE_SIZE;
+        void* paddedPtr = mmap(nullptr, paddedSize, PROT_NONE, flags, -1, 0);
+        if (paddedPtr == MAP_FAILED) {
+            throw std::bad_alloc();
+        };
+
+        void* alignedPtr = AeAllocatorBase::getAlignedAddress(paddedPtr, HUGE_PAGE_SIZE);
+        std::size_t leadingSize = AeAllocatorBase::pointerDifference(alignedPtr, paddedPtr);
+        if (leadingSize > 0) {
+            munmap(paddedPtr, leadingSize);
+        };
+        std::size_t trailingSize = paddedSize - leadingSize - m_reservedSize;
+        if (trailingSize > 0) {
+            munmap(AeAllocatorBase::addToPointer(m_reservedSize, alignedPtr), trailingSize);
+        };
+        m_reservedMemoryPtr = alignedPtr;
+
+#if defined(MADV_HUGEPAGE)
+        madvise(m_reservedMemoryPtr, m_reservedSize, MADV_HUGEPAGE);
+#endif
+#endif
+    };
+
+
+
+    void AeVirtualMemoryArena::commitChunks(std::size_t const t_firstChunk, std::size_t const t_numChunks) {
+        void* runPtr = AeAllocatorBase::addToPointer(t_firstChunk * m_commitGranularity, m_reservedMemoryPtr);
+        std::size_t runSize = t_numChunks * m_commitGranularity;
+
+#if defined(_WIN32)
+        if (VirtualAlloc(runPtr, runSize, MEM_COMMIT, PAGE_READWRITE) == nullptr) {
+            throw std::bad_alloc();
+        };
+#else
+        if (mprotect(runPtr, runSize, PROT_READ | PROT_WRITE) != 0) {
+            throw std::bad_alloc();
+        };
+#endif
+
+        std::fill_n(m_committedChunks.begin() + static_cast<std::ptrdiff_t>(t_firstChunk), t_numChunks, true);
+        m_numCommittedChunks += t_numChunks;
+    };
+
+
+
+    // The memory is handed back before access is removed so the pages are not kept resident.
+    void AeVirtualMemoryArena::decommitChunks(std::size_t const t_firstChunk, std::size_t const t_numChunks) noexcept {
+        void* runPtr = AeAllocatorBase::addToPointer(t_firstChunk * m_commitGranularity, m_reservedMemoryPtr);
+        std::size_t runSize = t_numChunks * m_commitGranularity;
+
+#if defined(_WIN32)
+        VirtualFree(runPtr, runSize, MEM_DECOMMIT);
+#else
+        madvise(runPtr, runSize, MADV_DONTNEED);
+        mprotect(runPtr, runSize, PROT_NONE);
+#endif
+
+        std::fill_n(m_committedChunks.begin() + static_cast<std::ptrdiff_t>(t_firstChunk), t_numChunks, false);
+        m_numCommittedChunks -= t_numChunks;
+    };
+
+} //namespace ae_memory
@@ -0,0 +1,140 @@
+/// \file ae_virtual_memory_arena.hpp
+/// The AeVirtualMemoryArena class is defined.
+#pragma once
+
+// dependencies
+
+// libraries
+
+//std
+#include <cstdlib>
+#include <vector>
+
+namespace ae_memory {
+
+    /// The kinds of pages that can back a virtual memory arena.
+    enum VirtualMemoryHugePages {
+        /// Normal pages are used.
+        virtualMemoryHugePages_none = 0,
+        /// The operating system is asked to back the arena with huge pages when it can, falls back to normal pages.
+        virtualMemoryHugePages_transparent,
+        /// The arena is mapped from the reserved huge pages of the system, which are taken for the whole arena when it
+        /// is created. Falls back to transparent huge pages if there are not enough reserved huge pages.
+        virtualMemoryHugePages_explicit
+    };
+
+    /// A AeVirtualMemoryArena reserves a range of address space without using any memory, and commits memory to parts of
+    /// that range only when asked to. A large arena can therefore be reserved up front for an allocator that only
+    /// occasionally needs most of it, with the memory actually used by the process tracking how much of the arena is
+    /// in use. Memory is committed and decommitted in chunks of the commit granularity. On Windows huge pages are not
+    /// used since they require special privileges.
+    class AeVirtualMemoryArena {
+    public:
+
+        /// The default size of the chunks memory is committed in when huge pages are not used, large enough to keep the
+        /// number of calls to the operating system small.
+        static constexpr std::size_t DEFAULT_COMMIT_GRANULARITY = std::size_t{64} << 10;
+
+        /// The size of a huge page, the size memory is committed in when huge pages are used.
+        static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+        /// Constructor of AeVirtualMemoryArena, reserves the address range.
+        /// \param t_reservedSize The size in bytes of the address range to reserve, rounded up to the commit
+        /// granularity.
+        /// \param t_hugePages The kind of pages to back the arena with.
+        explicit AeVirtualMemoryArena(std::size_t t_reservedSize,
+                                      VirtualMemoryHugePages t_hugePages = virtualMemoryHugePages_none);
+
+        /// Destructor of AeVirtualMemoryArena, releases the address range and all the memory committed to it.
+        ~AeVirtualMemoryArena();
+
+        /// Do not allow this class to be copied (2 lines below).
+        AeVirtualMemoryArena(const AeVirtualMemoryArena&) = delete;
+        AeVirtualMemoryArena& operator=(const AeVirtualMemoryArena&) = delete;
+
+        /// Do not allow this class to be moved (2 lines below)
+        AeVirtualMemoryArena(AeVirtualMemoryArena&&) = delete;
+        AeVirtualMemoryArena& operator=(AeVirtualMemoryArena&&) = delete;
+
+        /// Commits memory to every chunk overlapping the range that is not already committed. Throws std::bad_alloc if
+        /// the operating system can not provide the memory.
+        /// \param t_rangePtr The start of the range to commit.
+        /// \param t_rangeSize The size in bytes of the range to commit.
+        void commit(void* t_rangePtr, std::size_t t_rangeSize);
+
+        /// Returns the memory of every chunk entirely within the range to the operating system. The contents of the
+        /// range are lost, and it must be committed again before it is used.
+        /// \param t_rangePtr The start of the range to decommit.
+        /// \param t_rangeSize The size in bytes of the range to decommit.
+        void decommit(void* t_rangePtr, std::size_t t_rangeSize) noexcept;
+
+        /// Decommits the whole arena.
+        void reset() noexcept;
+
+        /// Rounds an address in the arena up to the end of the chunk it is in.
+        /// \param t_ptr The address to round up.
+        /// \return The address of the start of the next chunk, or the address itself if it is the start of a chunk.
+        [[nodiscard]] void* alignUpToCommitGranularity(void* t_ptr) const;
+
+        /// Rounds an address in the arena down to the start of the chunk it is in.
+        /// \param t_ptr The address to round down.
+        /// \return The address of the start of the chunk.
+        [[nodiscard]] void* alignDownToCommitGranularity(void* t_ptr) const;
+
+        /// Gets the start of the reserved address range.
+        /// \return The start of the arena.
+        [[nodiscard]] void* getReservedMemoryPtr() const { return m_reservedMemoryPtr; };
+
+        /// Gets the size of the reserved address range.
+        /// \return The size of the arena in bytes.
+        [[nodiscard]] std::size_t getReservedSize() const { return m_reservedSize; };
+
+        /// Gets the amount of memory currently committed.
+        /// \return The number of bytes committed.
+        [[nodiscard]] std::size_t getCommittedSize() const { return m_numCommittedChunks * m_commitGranularity; };
+
+        /// Gets the size of the chunks memory is committed in.
+        /// \return The commit granularity in bytes.
+        [[nodiscard]] std::size_t getCommitGranularity() const { return m_commitGranularity; };
+
+        /// Gets the kind of pages backing the arena, which may differ from the kind asked for if it was not available.
+        /// \return The kind of pages used.
+        [[nodiscard]] VirtualMemoryHugePages getHugePages() const { return m_hugePages; };
+
+    private:
+
+        /// Asks the operating system to reserve the address range.
+        void reserveAddressRange();
+
+        /// Asks the operating system to commit memory to a run of chunks.
+        /// \param t_firstChunk The index of the first chunk.
+        /// \param t_numChunks The number of chunks.
+        void commitChunks(std::size_t t_firstChunk, std::size_t t_numChunks);
+
+        /// Asks the operating system to take back the memory of a run of chunks.
+        /// \param t_firstChunk The index of the first chunk.
+        /// \param t_numChunks The number of chunks.
+        void decommitChunks(std::size_t t_firstChunk, std::size_t t_numChunks) noexcept;
+
+        /// The start of the reserved address range.
+        void* m_reservedMemoryPtr = nullptr;
+
+        /// The size in bytes of the reserved address range.
+        std::size_t m_reservedSize;
+
+        /// The kind of pages backing the arena.
+        VirtualMemoryHugePages m_hugePages;
+
+        /// The size in bytes of the chunks memory is committed in.
+        std::size_t m_commitGranularity;
+
+        /// If each chunk of the arena is committed.
+        std::vector<bool> m_committedChunks;
+
+        /// The number of chunks currently committed.
+        std::size_t m_numCommittedChunks = 0;
+
+    protected:
+
+    };
+} // namespace ae_memory
@@ -11,7 +11,13 @@
 
 namespace ae {
 
-    AeResourceManager::AeResourceManager(ae::AeDevice &t_aeDevice): m_aeDevice{t_aeDevice} {
+    AeResourceManager::AeResourceManager(ae::AeDevice &t_aeDevice,
+                                         AeSamplers& t_aeSamplers,
+                                         const AeEngineLimits& t_engineLimits):
+        m_aeDevice{t_aeDevice},
+        m_aeSamplers{t_aeSamplers},
+        m_obbArray(t_engineLimits.m_maxModels, VkAabbPositionsKHR{0, 0, 0, 0, 0, 0}),
+        m_3DObbSsboIndexStack{t_engineLimits.m_maxModels} {
 
         // Create the OBB SSBO
     };
@@ -20,29 +26,108 @@ namespace ae {
 
     };
 
-    std::shared_ptr<Ae3DModel> AeResourceManager::use3DModel(const std::string &t_filepath) {
+    // Loaded models are shared by the path they were loaded from.
+    Ae3DModelHandle AeResourceManager::use3DModel(const std::string &t_filepath) {
         // Check if the model is already loaded.
         auto loadedModelIterator = m_loadedModels.find(t_filepath);
 
         if(loadedModelIterator==m_loadedModels.end()){
             // If the model is not already loaded create a new model and track its usage.
-            // TODO: Using the shared pointer method gives me no control to load or unload modes as desired.
-            std::shared_ptr<Ae3DModel> loadedModel = Ae3DModel::createModelFromFile(m_aeDevice, t_filepath, m_3DObbSsboIndexStack.pop());
+            std::unique_ptr<Ae3DModel> loadedModel = Ae3DModel::createModelFromFile(m_aeDevice, t_filepath, m_3DObbSsboIndexStack.pop());
             m_obbArray[loadedModel->getIdxObbSsbo()] = loadedModel->getobb();
-            m_loadedModels[t_filepath] = loadedModel;
             loadedModel->incrementNumUsers();
-            return loadedModel;
+            Ae3DModelHandle modelHandle = m_models.insert({std::move(loadedModel), t_filepath});
+            m_loadedModels[t_filepath] = modelHandle;
+            return modelHandle;
         } else{
-            // Otherwise return the location of the loaded model and track the additional reference.
-            loadedModelIterator->second->incrementNumUsers();
+            // Otherwise return the handle of the loaded model and track the additional reference.
+            get3DModel(loadedModelIterator->second).incrementNumUsers();
             return loadedModelIterator->second;
         }
     };
 
-    void AeResourceManager::unuse3DModel(const std::shared_ptr<Ae3DModel>& t_model){
-        if(t_model->getNumUsers() >= 1){
-            t_model->decrementNumUsers();
-            if(t_model->getNumUsers() == 0){
+
+
+    // Load the image if it is not already loaded.
+    AeImageHandle AeResourceManager::useImage(const std::string &t_filepath) {
+        auto loadedImageIterator = m_loadedImages.find(t_filepath);
+
+        if(loadedImageIterator==m_loadedImages.end()){
+            AeImageHandle imageHandle = m_images.insert({AeImage::createImageFromFile(m_aeDevice, t_filepath),
+                                                         t_filepath});
+            m_loadedImages[t_filepath] = imageHandle;
+            return imageHandle;
+        } else{
+            return loadedImageIterator->second;
+        }
+    };
+
+
+
+    // The path the model or image was loaded from is stored with it.
+    std::string AeResourceManager::getAssetPath(uint32_t t_assetType, uint32_t t_assetHandle){
+        switch (t_assetType) {
+            case resourceSnapshotAssetType_3DModel: {
+                if (!m_models.isValid(Ae3DModelHandle::fromValue(t_assetHandle))) {
+                    throw std::runtime_error("Can not find the model in the loaded models! Models must be loaded "
+                                             "through the resource manager to be saved in a snapshot.");
+                }
+                return m_models.get(Ae3DModelHandle::fromValue(t_assetHandle)).m_filepath;
+            }
+            case resourceSnapshotAssetType_image: {
+                if (!m_images.isValid(AeImageHandle::fromValue(t_assetHandle))) {
+                    throw std::runtime_error("Can not find the image in the loaded images! Images must be loaded "
+                                             "through the resource manager to be saved in a snapshot.");
+                }
+                return m_images.get(AeImageHandle::fromValue(t_assetHandle)).m_filepath;
+            }
+            default:
+                throw std::runtime_error("Unknown snapshot asset type!");
+        }
+    };
+
+
+
+    // Load the model or image, each user restored from a snapshot is tracked the same as any other user.
+    uint32_t AeResourceManager::loadAsset(uint32_t t_assetType, const std::string& t_assetPath){
+        switch (t_assetType) {
+            case resourceSnapshotAssetType_3DModel:
+                return use3DModel(t_assetPath).getValue();
+            case resourceSnapshotAssetType_image:
+                return useImage(t_assetPath).getValue();
+            default:
+                throw std::runtime_error("Unknown snapshot asset type!");
+        }
+    };
+
+
+
+    // Only the default sampler currently exists.
+    std::string AeResourceManager::getSamplerName(const void* t_sampler){
+        if(t_sampler == m_aeSamplers.getDefaultSampler()){
+            return "default";
+        }
+        throw std::runtime_error("Can not find the sampler in the samplers available to the resource manager!");
+    };
+
+
+
+    // Get the sampler with the specified name.
+    void* AeResourceManager::getSampler(const std::string& t_samplerName){
+        if(t_samplerName == "default"){
+            return m_aeSamplers.getDefaultSampler();
+        }
+        throw std::runtime_error("Unknown sampler name in snapshot: " + t_samplerName);
+    };
+
+
+
+    // Unload the model once its last user is done with it.
+    void AeResourceManager::unuse3DModel(Ae3DModelHandle t_model){
+        Ae3DModel& model = get3DModel(t_model);
+        if(model.getNumUsers() >= 1){
+            model.decrementNumUsers();
+            if(model.getNumUsers() == 0){
                 unloadModel(t_model);
             }
         }
@@ -54,28 +139,15 @@ namespace ae {
     // Write the currently loaded model's OBBs into the specified SBBO buffer.
     void AeResourceManager::updateObbSsbo(std::unique_ptr<AeBuffer>& t_obbSsboBuffer){
         // Write the object buffer data to the descriptor set.
-        t_obbSsboBuffer->writeToBuffer(m_obbArray);
+        t_obbSsboBuffer->writeToBuffer(m_obbArray.data());
         t_obbSsboBuffer->flush();
     }
 
-    void AeResourceManager::unloadModel(std::shared_ptr<Ae3DModel> t_model){
-
-        bool model_found = false;
-        std::string model_path;
-
-        // See if the model is in the map.
-        for (auto& it : m_loadedModels) {
-            // If the model is in the map then get the path that represents that model.
-            if (it.second == t_model) {
-                model_path = it.first;
-                model_found = true;
-            }
-        }
-        if(model_found){
-            m_3DObbSsboIndexStack.push(t_model->getIdxObbSsbo());
-            m_loadedModels.erase(model_path);
-        } else{
-            throw std::runtime_error("Can not find model to be removed in map of loaded models!!");
-        }
+    // Return the model's OBB SSBO position to the stack and remove the model, which makes its handles stale.
+    void AeResourceManager::unloadModel(Ae3DModelHandle t_model){
+        LoadedModel& loadedModel = m_models.get(t_model);
+        m_3DObbSsboIndexStack.push(loadedModel.m_model->getIdxObbSsbo());
+        m_loadedModels.erase(loadedModel.m_filepath);
+        m_models.remove(t_model);
     };
 } //namespace ae
\ No newline at end of file
@@ -6,34 +6,107 @@
 
 // dependencies
 #include "ae_3d_model.hpp"
+#include "ae_image.hpp"
+#include "ae_samplers.hpp"
+#include "ae_engine_config.hpp"
+#include "ae_ecs_snapshot.hpp"
 #include "ae_de_stack_allocator.hpp"
 #include "ae_free_linked_list_allocator.hpp"
 
 // libraries
 #include "pre_allocated_stack.hpp"
+#include "handle_pool.hpp"
+#include "flat_hash_map.hpp"
 
 // std
-#include <unordered_map>
+#include <functional>
 #include <string>
 
 namespace ae {
 
-    class AeResourceManager {
+    /// The types of assets the resource manager can store in, and restore from, an ECS snapshot.
+    enum ResourceSnapshotAssetType : uint32_t {
+        resourceSnapshotAssetType_3DModel = 0,
+        resourceSnapshotAssetType_image
+    };
+
+    /// A handle to a 3D model loaded by the resource manager.
+    using Ae3DModelHandle = AeHandle<Ae3DModel>;
+
+    /// A handle to an image loaded by the resource manager.
+    using AeImageHandle = AeHandle<AeImage>;
+
+    class AeResourceManager : public ae_ecs::AeSnapshotAssetResolver {
     public:
         /// Is responsible for handling the creation and destruction of general use assets and keeping them organized.
         /// Examples of these types of assets include models, images, and audio.
-        AeResourceManager(AeDevice& t_aeDevice);
+        /// \param t_engineLimits The engine limits, the maximum number of models sizes the OBB array.
+        AeResourceManager(AeDevice& t_aeDevice, AeSamplers& t_aeSamplers, const AeEngineLimits& t_engineLimits);
 
         ~AeResourceManager();
 
-        /// Loads the model (file/path/filename.obj) at the specified location.
-        std::shared_ptr<Ae3DModel> use3DModel(const std::string& t_filepath);
-
-        /// Informs the resource manager that the model is no longer being utilized by a user.
-        void unuse3DModel(const std::shared_ptr<Ae3DModel>& t_model);
+        /// Loads the model (file/path/filename.obj) at the specified location, or returns the model if it has already
+        /// been loaded. Each call adds a user of the model that must be removed with unuse3DModel.
+        Ae3DModelHandle use3DModel(const std::string& t_filepath);
+
+        /// Informs the resource manager that the model is no longer being utilized by a user. The model is unloaded
+        /// when it has no users left, after which its handles are stale.
+        void unuse3DModel(Ae3DModelHandle t_model);
+
+        /// Loads the image (file/path/filename.png) at the specified location, or returns the image if it has already
+        /// been loaded.
+        AeImageHandle useImage(const std::string& t_filepath);
+
+        /// Gets a loaded model.
+        /// \param t_model The handle to the model.
+        /// \return The model, throws if the handle is null or the model has been unloaded.
+        Ae3DModel& get3DModel(Ae3DModelHandle t_model) { return *m_models.get(t_model).m_model; };
+
+        /// Gets a loaded image.
+        /// \param t_image The handle to the image.
+        /// \return The image, throws if the handle is null or stale.
+        AeImage& getImage(AeImageHandle t_image) { return *m_images.get(t_image).m_image; };
+
+        /// Checks if a handle references a loaded model.
+        /// \param t_model The handle to the model.
+        /// \return False if the handle is null or the model has been unloaded.
+        [[nodiscard]] bool is3DModelLoaded(Ae3DModelHandle t_model) const { return m_models.isValid(t_model); };
+
+        /// Checks if a handle references a loaded image.
+        /// \param t_image The handle to the image.
+        /// \return False if the handle is null or stale.
+        [[nodiscard]] bool isImageLoaded(AeImageHandle t_image) const { return m_images.isValid(t_image); };
+
+        /// Gets the number of slots the image handles index, arrays indexed by image handle index need this size.
+        [[nodiscard]] std::size_t getNumImageSlots() const { return m_images.getNumSlots(); };
+
+        /// Gets the number of slots the model handles index, arrays indexed by model handle index need this size.
+        [[nodiscard]] std::size_t getNum3DModelSlots() const { return m_models.getNumSlots(); };
+
+        /// Gets the path of a loaded model or image so it can be stored in an ECS snapshot.
+        /// \param t_assetType The type of the asset, a ResourceSnapshotAssetType.
+        /// \param t_assetHandle The value of the handle to the model or image.
+        /// \return The path the asset was loaded from.
+        std::string getAssetPath(uint32_t t_assetType, uint32_t t_assetHandle) override;
+
+        /// Loads the model or image referenced by an ECS snapshot.
+        /// \param t_assetType The type of the asset, a ResourceSnapshotAssetType.
+        /// \param t_assetPath The path the asset was loaded from.
+        /// \return The value of the handle to the loaded model or image.
+        uint32_t loadAsset(uint32_t t_assetType, const std::string& t_assetPath) override;
+
+        /// Gets the name of a sampler so it can be stored in an ECS snapshot.
+        /// \param t_sampler The sampler.
+        /// \return The name of the sampler.
+        std::string getSamplerName(const void* t_sampler) override;
+
+        /// Gets the sampler referenced by an ECS snapshot.
+        /// \param t_samplerName The name of the sampler.
+        /// \return The sampler.
+        void* getSampler(const std::string& t_samplerName) override;
 
         /// Get the array with the model OBBs.
-        VkAabbPositionsKHR* getObbArray() { return m_obbArray;}
+        VkAabbPositionsKHR* getObbArray() { return m_obbArray.data();}
 
         /// Writes the OBBs of the currently loaded models into the specified SSBO
         void updateObbSsbo(std::unique_ptr<AeBuffer>& t_obbSsboBuffer);
@@ -44,20 +117,46 @@ namespace ae {
         /// The device the resource manager interacts with.
         AeDevice& m_aeDevice;
 
-        /// Keeps track of the currently loaded 3D models.
-        std::unordered_map<std::string, std::shared_ptr<Ae3DModel>> m_loadedModels;
+        /// The samplers available to the assets.
+        AeSamplers& m_aeSamplers;
+
+        /// A loaded 3D model and the path it was loaded from. Models can not be moved, so the pool stores owning
+        /// pointers to them.
+        struct LoadedModel {
+            std::unique_ptr<Ae3DModel> m_model;
+            std::string m_filepath;
+        };
+
+        /// A loaded image and the path it was loaded from.
+        struct LoadedImage {
+            std::unique_ptr<AeImage> m_image;
+            std::string m_filepath;
+        };
+
+        /// The currently loaded 3D models.
+        HandlePool<LoadedModel, Ae3DModel> m_models;
+
+        /// The currently loaded images.
+        HandlePool<LoadedImage, AeImage> m_images;
+
+        /// The handles of the currently loaded 3D models by the path they were loaded from.
+        ae::flat_hash_map<std::string, Ae3DModelHandle, ae::string_hash, std::equal_to<>> m_loadedModels;
+
+        /// The handles of the currently loaded images by the path they were loaded from.
+        ae::flat_hash_map<std::string, AeImageHandle, ae::string_hash, std::equal_to<>> m_loadedImages;
 
         //==============================================================================================================
         // 3D Oriented Bounding Box (OBB) Array to be used for Shader Storage Buffer Object (SSBO)
         //==============================================================================================================
         /// An for the 3D Oriented Bounding Box (OBB) for the Shader Storage Buffer Object (SSBO)
-        VkAabbPositionsKHR m_obbArray[MAX_MODELS] = {0, 0, 0, 0, 0, 0};
+        std::vector<VkAabbPositionsKHR> m_obbArray;
 
         /// A stack to track the available data positions in the SSBO.
-        PreAllocatedStack<ssbo_idx,MAX_MODELS> m_3DObbSsboIndexStack{};
+        PreAllocatedStack<ssbo_idx,DEFAULT_MAX_MODELS> m_3DObbSsboIndexStack;
 
 
-        void unloadModel(std::shared_ptr<Ae3DModel> t_model);
+        /// Releases the model's OBB SSBO position and destroys the model.
+        void unloadModel(Ae3DModelHandle t_model);
 
         /// Primary Stack Allocator for the game
         //std::size_t m_deStackAllocationSize = 4000000000;
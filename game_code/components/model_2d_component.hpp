@@ -6,6 +6,7 @@
 #include "ae_ecs_include.hpp"
 #include "ae_2d_model.hpp"
 #include "ae_image.hpp"
+#include "ae_resource_manager.hpp"
 
 namespace ae {
 
@@ -24,8 +25,8 @@ namespace ae {
         /// The rotation of the 2D object in radians.
         float rotation = 0.0;
 
-        /// The 2D model's texture.
-        std::shared_ptr<AeImage> m_texture= nullptr;
+        /// The handle to the 2D model's texture, loaded through the resource manager.
+        AeImageHandle m_texture{};
 
         /// The Sampler to use for the image.
         VkSampler m_sampler = nullptr;
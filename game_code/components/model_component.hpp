@@ -7,17 +7,21 @@
 #include "ae_ecs_include.hpp"
 #include "ae_3d_model.hpp"
 #include "ae_image.hpp"
+#include "ae_resource_manager.hpp"
+
+#include <limits>
+#include <type_traits>
 
 namespace ae {
 
     /// This structure defines the model data stored for each entity using the model component.
     struct ModelComponentStruct {
 
-        /// A pointer to the model used by a entity.
-        std::shared_ptr<Ae3DModel> m_model{};
+        /// The handle to the model used by a entity, loaded through the resource manager.
+        Ae3DModelHandle m_model{};
 
-        /// Model Matrix Index.
-        uint32_t m_modelMatrixIndex = MAX_OBJECTS;
+        /// Model Matrix Index, the maximum value until the entity is given a position in the 3D SSBO.
+        uint32_t m_modelMatrixIndex = std::numeric_limits<uint32_t>::max();
 
         /// Defines the scaling factors to be applied to the model being used by the entity.
         glm::vec3 scale{ 1.0f, 1.0f, 1.0f };
@@ -28,13 +32,16 @@ namespace ae {
         /// Y(1) - varphi, X(2) - theta, Z(3) - psi.
         glm::vec3 rotation{ 0.0f, 0.0f, 0.0f };
 
-        /// The 2D model's texture.
-        std::shared_ptr<AeImage> m_texture= nullptr;
+        /// The handle to the model's texture, loaded through the resource manager.
+        AeImageHandle m_texture{};
 
         /// The Sampler to use for the image.
         VkSampler m_sampler = nullptr;
     };
 
+    static_assert(std::is_trivially_copyable<ModelComponentStruct>::value,
+                  "The model component data is copied and written to snapshots as plain bytes.");
+
 
     /// The model component class is derived from the AeComponent template class using the model component structure.
     class ModelComponent : public ae_ecs::AeComponent<ModelComponentStruct> {
@@ -50,5 +57,33 @@ namespace ae {
 
     protected:
 
+        /// The model component data is stored in snapshots using the paths of the model and texture.
+        /// \return True.
+        bool isSnapshotPersistent() const override { return true; };
+
+        /// Writes the paths of the model and texture, the sampler name, and the transform of the entity.
+        /// \param t_data The model data of the entity.
+        /// \param t_writer The writer the snapshot is being written with.
+        void saveEntitySnapshot(const ModelComponentStruct& t_data, ae_ecs::AeSnapshotWriter& t_writer) override {
+            t_writer.writeAsset(resourceSnapshotAssetType_3DModel, t_data.m_model.getValue());
+            t_writer.write(t_data.m_modelMatrixIndex);
+            t_writer.write(t_data.scale);
+            t_writer.write(t_data.rotation);
+            t_writer.writeAsset(resourceSnapshotAssetType_image, t_data.m_texture.getValue());
+            t_writer.writeSampler(t_data.m_sampler);
+        };
+
+        /// Reads the model data of an entity, loading the model and texture through the resource manager.
+        /// \param t_data The model data of the entity.
+        /// \param t_reader The reader the snapshot is being read with.
+        void loadEntitySnapshot(ModelComponentStruct& t_data, ae_ecs::AeSnapshotReader& t_reader) override {
+            t_data.m_model = t_reader.readAsset<Ae3DModelHandle>(resourceSnapshotAssetType_3DModel);
+            t_data.m_modelMatrixIndex = t_reader.read<uint32_t>();
+            t_data.scale = t_reader.read<glm::vec3>();
+            t_data.rotation = t_reader.read<glm::vec3>();
+            t_data.m_texture = t_reader.readAsset<AeImageHandle>(resourceSnapshotAssetType_image);
+            t_data.m_sampler = static_cast<VkSampler>(t_reader.readSampler());
+        };
+
     };
 }
\ No newline at end of file
@@ -21,8 +21,12 @@ namespace ae {
     /// data to improve performance of the system(s) that use this component.
     class WorldPositionComponent : public ae_ecs::AeComponent<WorldPositionComponentStruct> {
     public:
-        /// The WorldPositionComponent constructor uses the AeComponent constructor with no additions.
-        WorldPositionComponent(ae_ecs::AeECS& t_ecs) : AeComponent(t_ecs) {};
+        /// The WorldPositionComponent constructor uses the AeComponent constructor with no additions. The world positions
+        /// are stored in copy on write pages so they can be modified by speculative simulations running on forks of the
+        /// ECS.
+        WorldPositionComponent(ae_ecs::AeECS& t_ecs) : AeComponent(t_ecs,
+                                                                   t_ecs.getMaxNumEntities(),
+                                                                   componentStorageMethod_copyOnWritePages) {};
 
         /// The destructor of the WorldPositionComponent. The WorldPositionComponent destructor
         /// uses the AeComponent constructor with no additions.
@@ -19,13 +19,15 @@ namespace ae {
                                  VkRenderPass t_renderPass,
                                  ae_ecs::AeECS& t_ecs,
                                  MaterialShaderFiles& t_materialShaderFiles,
-                                 std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts):
+                                 std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts,
+                                 AeResourceManager& t_aeResourceManager):
                 Ae3DMaterialLayerType(t_aeDevice,
                                       t_game_components,
                                       t_renderPass,
                                       t_ecs,
                                       t_materialShaderFiles,
-                                      t_descriptorSetLayouts) {};
+                                      t_descriptorSetLayouts,
+                                      t_aeResourceManager) {};
         ~ExampleMaterialLayerType()=default;
     };
 
@@ -36,12 +38,14 @@ namespace ae {
                       GameComponents& t_game_components,
                       VkRenderPass t_renderPass,
                       ae_ecs::AeECS& t_ecs,
-                      std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts)
+                      std::vector<VkDescriptorSetLayout>& t_descriptorSetLayouts,
+                      AeResourceManager& t_aeResourceManager)
                 : m_ecs{t_ecs},
                   m_device{t_aeDevice},
                   m_game_components{t_game_components},
                   m_renderPass{t_renderPass},
-                  m_descriptorSetLayouts{t_descriptorSetLayouts}{
+                  m_descriptorSetLayouts{t_descriptorSetLayouts},
+                  m_aeResourceManager{t_aeResourceManager}{
 
             // Add the simple material to the material list.
             m_materials.push_back(&m_simpleMaterial);
@@ -65,6 +69,7 @@ namespace ae {
         AeDevice& m_device;
         VkRenderPass m_renderPass;
         std::vector<VkDescriptorSetLayout>& m_descriptorSetLayouts;
+        AeResourceManager& m_aeResourceManager;
         std::vector<Ae3DMaterialLayerBase*> m_materials;
 
         // Materials
@@ -77,13 +82,15 @@ namespace ae {
                                                   m_renderPass,
                                                   m_ecs,
                                                   simpleMaterialShaderFiles,
-                                                  m_descriptorSetLayouts};
+                                                  m_descriptorSetLayouts,
+                                                  m_aeResourceManager};
 
         ExampleMaterialLayerType m_newMaterial{m_device,
                                                m_game_components,
                                                m_renderPass,
                                                m_ecs,
                                                simpleMaterialShaderFiles,
-                                               m_descriptorSetLayouts};
+                                               m_descriptorSetLayouts,
+                                               m_aeResourceManager};
     };
 }
\ No newline at end of file
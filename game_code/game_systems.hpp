@@ -30,7 +30,8 @@ namespace ae {
                     AeDevice& t_device,
                     AeRenderer& t_renderer,
                     AeSamplers& t_samplers,
-                    AeResourceManager& t_aeResourceManager) {
+                    AeResourceManager& t_aeResourceManager,
+                    const AeEngineLimits& t_engineLimits) {
 
             timingSystem = new TimingSystem(t_ecs);
             playerInputSystem = new PlayerInputSystem(t_ecs, t_game_components, *timingSystem, t_window);
@@ -44,11 +45,13 @@ namespace ae {
                                                          t_renderer,
                                                          t_device,
                                                          t_samplers,
-                                                         t_aeResourceManager);
+                                                         t_aeResourceManager,
+                                                         t_engineLimits);
 
 
             createDestroyTestSystem = new CreateDestroyTestSystem(t_window,
                                                                   t_device,
+                                                                  t_aeResourceManager,
                                                                   t_ecs,
                                                                   t_game_components,
                                                                   rendererSystem->getGameMaterials(),
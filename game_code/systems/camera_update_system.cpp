@@ -49,7 +49,7 @@ namespace ae {
     void CameraUpdateSystem::executeSystem(){
 
         // Get the entities that use the components this system depends on.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getUpdatedSystemEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getUpdatedSystemEntities(this->getSystemId());
 
         // Loop through the valid entities and update their camera view properties.
         for (ecs_id entityId : validEntityIds){
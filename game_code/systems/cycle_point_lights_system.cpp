@@ -42,7 +42,7 @@ namespace ae {
         // Get the entities that use the components this system depends on. Get enabled entities since this will be a
         // system that will conditionally update their component data no matter if previous systems have acted upon
         // them.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
         // Calculate the transform matrix to update the point light position to make them move in a circle around a
         // fixed normalized axis in space.
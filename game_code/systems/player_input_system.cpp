@@ -45,7 +45,7 @@ namespace ae {
         // Get the entities that use the components this system depends on. Get enabled entities since this will be a
         // system that will conditionally update their component data no matter if previous systems have acted upon
         // them.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
         // TODO: Need to call a function here that calculates the required change in the controlled entities position
         //  before looping through all the entities.
@@ -11,6 +11,7 @@ namespace ae {
     // Constructor implementation
     CreateDestroyTestSystem::CreateDestroyTestSystem(GLFWwindow* t_window,
                                          AeDevice& t_aeDevice,
+                                         AeResourceManager& t_aeResourceManager,
                                          ae_ecs::AeECS& t_aeECS,
                                          GameComponents& t_gameComponents,
                                          GameMaterials& t_gameMaterials,
@@ -20,6 +21,7 @@ namespace ae {
              m_gameComponents{t_gameComponents},
              m_gameMaterials{t_gameMaterials},
              m_aeSamplers{t_samplers},
+             m_aeResourceManager{t_aeResourceManager},
              m_window{t_window},
              ae_ecs::AeSystem<CreateDestroyTestSystem>(t_aeECS) {
 
@@ -34,8 +36,7 @@ namespace ae {
 
     // Destructor implementation
     CreateDestroyTestSystem::~CreateDestroyTestSystem() {
-        m_aeModel = nullptr;
-        m_aeImage = nullptr;
+        m_aeResourceManager.unuse3DModel(m_aeModel);
     };
 
 
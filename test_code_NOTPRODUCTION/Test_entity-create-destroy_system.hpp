@@ -14,6 +14,7 @@
 #include "game_components.hpp"
 #include "game_materials.hpp"
 #include "ae_samplers.hpp"
+#include "ae_resource_manager.hpp"
 #include "game_object_entity.hpp"
 #include "ae_window.hpp"
 
@@ -35,8 +36,10 @@ namespace ae {
         /// \param t_timingSystem The TimingSystem the PlayerInputSystem will depend on executing first
         /// and require information from.
         /// \param t_window A pointer to the GLFW window that will be polling the player's inputs.
+        /// \param t_aeResourceManager The resource manager the model and texture of the entities are loaded through.
         CreateDestroyTestSystem(GLFWwindow* t_window,
                                 AeDevice& t_aeDevice,
+                                AeResourceManager& t_aeResourceManager,
                                 ae_ecs::AeECS& t_aeECS,
                                 GameComponents& t_gameComponents,
                                 GameMaterials& t_gameMaterials,
@@ -76,13 +79,13 @@ namespace ae {
         GameComponents& m_gameComponents;
         GameMaterials& m_gameMaterials;
         AeSamplers& m_aeSamplers;
+        AeResourceManager& m_aeResourceManager;
 
         /// The model in which will be used to create the entities.
-        std::shared_ptr<Ae3DModel> m_aeModel = Ae3DModel::createModelFromFile(m_aeDevice, "assets/models/leaf_enemy_w_tongue.obj");;
+        Ae3DModelHandle m_aeModel = m_aeResourceManager.use3DModel("assets/models/leaf_enemy_w_tongue.obj");
 
         /// The texture which will be used with the model.
-        std::shared_ptr<AeImage> m_aeImage = AeImage::createImageFromFile(m_aeDevice,
-                                                                          "assets/models/leaf_enemy_body_w_tongue.png");
+        AeImageHandle m_aeImage = m_aeResourceManager.useImage("assets/models/leaf_enemy_body_w_tongue.png");
 
         // Components this system utilizes.
 
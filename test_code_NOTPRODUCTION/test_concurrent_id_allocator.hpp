@@ -0,0 +1,184 @@
+/// \file test_concurrent_id_allocator.hpp
+/// The tests of the concurrent ID allocator are defined. A single thread must always be handed the lowest free ID,
+/// whether IDs were freed into its cache, into the bitset or claimed, which is checked against std::set through random
+/// operations. Threads allocating and freeing at once must never be handed the same ID.
+#pragma once
+
+// dependencies
+#include "concurrent_id_allocator.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ae {
+
+    namespace test_concurrent_id_allocator_detail {
+
+        /// Checks freeing an ID throws.
+        bool doesFreeThrow(ConcurrentIdAllocator& t_allocator, std::size_t t_id){
+            try {
+                t_allocator.free(t_id);
+            } catch (const std::runtime_error&) {
+                return true;
+            };
+            return false;
+        };
+    }
+
+    void test_concurrent_id_allocator(){
+        using namespace test_concurrent_id_allocator_detail;
+
+        // An ID freed above the lowest free ID is not handed out before it.
+        {
+            ConcurrentIdAllocator allocator{1000};
+            assert(allocator.claim(0) && allocator.claim(999));
+            allocator.free(999);
+            assert(allocator.allocate() == 1);
+            assert(allocator.allocate() == 2);
+        };
+
+        // An ID freed below the thread's cache replaces the cache, and the cache's IDs are handed out after it.
+        {
+            ConcurrentIdAllocator allocator{1000};
+            for (std::size_t id = 0; id < 100; id++) {
+                assert(allocator.allocate() == id);
+            };
+            assert(allocator.claim(999));
+            allocator.free(999);
+            allocator.free(40);
+            allocator.free(7);
+            allocator.free(41);
+            assert(allocator.allocate() == 7);
+            assert(allocator.allocate() == 40);
+            assert(allocator.allocate() == 41);
+            assert(allocator.allocate() == 100);
+            assert(allocator.getNumAllocated() == 101);
+
+            // Every ID freed into the cache or the bitset is caught when freed twice.
+            allocator.free(5);
+            allocator.free(70);
+            assert(doesFreeThrow(allocator, 5));
+            assert(doesFreeThrow(allocator, 70));
+            assert(doesFreeThrow(allocator, 999));
+            assert(doesFreeThrow(allocator, 1000));
+        };
+
+        // Random allocations, frees and claims against the set of free IDs, the size not a multiple of a word.
+        {
+            const std::size_t numIds = 1000;
+            ConcurrentIdAllocator allocator{numIds};
+            std::set<std::size_t> freeIds;
+            for (std::size_t id = 0; id < numIds; id++) {
+                freeIds.insert(id);
+            };
+            std::vector<std::size_t> allocatedIds;
+
+            std::mt19937 random{43};
+            for (int step = 0; step < 200000; step++) {
+                unsigned int operation = random() % 100;
+                if (operation < 50 || allocatedIds.empty()) {
+                    std::size_t id = allocator.allocate();
+                    assert(id == (freeIds.empty() ? ConcurrentIdAllocator::npos : *freeIds.begin()));
+                    if (id != ConcurrentIdAllocator::npos) {
+                        freeIds.erase(id);
+                        allocatedIds.push_back(id);
+                    };
+                } else if (operation < 95) {
+                    std::size_t index = random() % allocatedIds.size();
+                    std::size_t id = allocatedIds[index];
+                    allocatedIds[index] = allocatedIds.back();
+                    allocatedIds.pop_back();
+                    if (operation < 85) {
+                        allocator.free(id);
+                    } else {
+                        allocator.freeToBitset(id);
+                    };
+                    freeIds.insert(id);
+                } else if (operation < 99) {
+                    // Claiming needs the IDs in the thread caches back in the bitset.
+                    allocator.flushThreadCaches();
+                    std::size_t id = random() % numIds;
+                    bool isFree = freeIds.erase(id) == 1;
+                    assert(allocator.claim(id) == isFree);
+                    if (isFree) {
+                        allocatedIds.push_back(id);
+                    };
+                } else {
+                    HierarchicalBitset allocatedIdBits = allocator.getAllocatedIds();
+                    assert(allocatedIdBits.count() == allocatedIds.size());
+                    for (auto id: allocatedIds) {
+                        assert(allocatedIdBits.test(id));
+                    };
+                };
+                assert(allocator.getNumAllocated() == allocatedIds.size());
+            };
+        };
+
+        // Threads allocating and freeing at once, and taking IDs stranded in the caches of threads that have exited.
+        {
+            const std::size_t numIds = 4096;
+            const int numThreads = 8;
+            ConcurrentIdAllocator allocator{numIds};
+            std::unique_ptr<std::atomic<int>[]> owners = std::make_unique<std::atomic<int>[]>(numIds);
+            for (std::size_t id = 0; id < numIds; id++) {
+                owners[id].store(-1);
+            };
+
+            std::vector<std::thread> threads;
+            for (int thread = 0; thread < numThreads; thread++) {
+                threads.emplace_back([&, thread]() {
+                    std::mt19937 random{static_cast<std::mt19937::result_type>(thread)};
+                    std::vector<std::size_t> heldIds;
+                    for (int step = 0; step < 50000; step++) {
+                        if (heldIds.size() < 256 && (heldIds.empty() || random() % 2 == 0)) {
+                            std::size_t id = allocator.allocate();
+                            assert(id != ConcurrentIdAllocator::npos);
+                            int owner = -1;
+                            bool isUnowned = owners[id].compare_exchange_strong(owner, thread);
+                            assert(isUnowned);
+                            heldIds.push_back(id);
+                        } else {
+                            std::size_t index = random() % heldIds.size();
+                            std::size_t id = heldIds[index];
+                            heldIds[index] = heldIds.back();
+                            heldIds.pop_back();
+                            owners[id].store(-1);
+                            allocator.free(id);
+                        };
+                    };
+                    for (auto id: heldIds) {
+                        owners[id].store(-1);
+                        allocator.free(id);
+                    };
+                });
+            };
+            for (auto& thread: threads) {
+                thread.join();
+            };
+
+            // Every ID can be taken again, from the bitset or from the caches the threads left behind.
+            assert(allocator.getNumAllocated() == 0);
+            std::vector<std::size_t> ids;
+            for (std::size_t n = 0; n < numIds; n++) {
+                ids.push_back(allocator.allocate());
+            };
+            assert(allocator.allocate() == ConcurrentIdAllocator::npos);
+            std::sort(ids.begin(), ids.end());
+            for (std::size_t id = 0; id < numIds; id++) {
+                assert(ids[id] == id);
+            };
+        };
+    };
+
+} // namespace ae
@@ -0,0 +1,71 @@
+/// \file test_dense_slot_table.hpp
+/// The tests of the dense slot table are defined. A buffer is kept alongside the table the way the 3D SSBO is, and
+/// checked to still hold the value of each key at the key's slot after every insert, erase and remap.
+#pragma once
+
+// dependencies
+#include "dense_slot_table.hpp"
+
+// libraries
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace ae {
+
+    void test_dense_slot_table(){
+        constexpr std::size_t maxNumKeys = 1000;
+        constexpr std::size_t maxNumSlots = 300;
+        DenseSlotTable table{maxNumKeys, maxNumSlots};
+
+        // The buffer the table assigns the slots of, each slot holds the key that owns it.
+        std::vector<std::size_t> buffer(maxNumSlots);
+        std::unordered_set<std::size_t> expected;
+
+        uint64_t random = 88172645463325252ull;
+        for (int operation = 0; operation < 100000; operation++) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            std::size_t key = random % maxNumKeys;
+
+            if (random % 3 != 0 && expected.size() < maxNumSlots) {
+                auto [slot, isInserted] = table.insert(key);
+                assert(isInserted == expected.insert(key).second);
+                buffer[slot] = key;
+            } else {
+                DenseSlotMove slotMove = table.erase(key);
+                assert((slotMove.m_toSlot != DenseSlotTable::INVALID_SLOT) == (expected.erase(key) == 1));
+                if (slotMove.m_fromSlot != slotMove.m_toSlot) {
+                    buffer[slotMove.m_toSlot] = buffer[slotMove.m_fromSlot];
+                };
+            };
+            assert(table.size() == expected.size());
+        };
+
+        // The keys are packed in the first size() slots in both directions, and the buffer followed the moves.
+        for (uint32_t slot = 0; slot < table.size(); slot++) {
+            std::size_t key = table.getKey(slot);
+            assert(expected.count(key) == 1 && table.getSlot(key) == slot && buffer[slot] == key);
+        };
+        assert(table.getSlot(maxNumKeys + 5) == DenseSlotTable::INVALID_SLOT);
+
+        // Renumbering a key keeps its slot.
+        std::size_t renumberedKey = table.getKey(0);
+        std::size_t freeKey = 0;
+        while (table.contains(freeKey)) {
+            freeKey++;
+        };
+        table.remapKey(renumberedKey, freeKey);
+        assert(!table.contains(renumberedKey) && table.getSlot(freeKey) == 0 && table.getKey(0) == freeKey);
+
+        // Erasing the key in the last slot does not move anything.
+        uint64_t numSlotMoves = table.getNumSlotMoves();
+        DenseSlotMove slotMove = table.erase(table.getKey(table.size() - 1));
+        assert(slotMove.m_fromSlot == slotMove.m_toSlot && table.getNumSlotMoves() == numSlotMoves);
+    };
+
+} // namespace ae
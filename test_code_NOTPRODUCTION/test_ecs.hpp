@@ -0,0 +1,739 @@
+/// \file test_ecs.hpp
+/// The tests of the entity component system are defined. Each test builds small worlds out of test components, entities
+/// and a system on top of the engine's allocators, so the ECS is exercised without the renderer.
+#pragma once
+
+// dependencies
+#include "ae_ecs_include.hpp"
+#include "ae_ecs_snapshot.hpp"
+#include "ae_de_stack_allocator.hpp"
+#include "ae_free_linked_list_allocator.hpp"
+#include "ae_frame_arenas.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ae {
+
+    namespace test_ecs_detail {
+
+        /// Trivially copyable data stored in an array covering every entity.
+        struct TestEcsPosition {
+            float m_position[3]{};
+            std::uint32_t m_flags = 0;
+        };
+
+        /// Trivially copyable data stored in a map.
+        struct TestEcsVelocity {
+            double m_velocity[2]{};
+        };
+
+        /// Trivially copyable data stored in copy on write pages.
+        struct TestEcsHealth {
+            std::int32_t m_health = 0;
+        };
+
+        /// Data that is not trivially copyable, so it is not persisted in snapshots.
+        struct TestEcsName {
+            std::string m_name;
+        };
+
+        class TestEcsPositionComponent : public ae_ecs::AeComponent<TestEcsPosition> {
+        public:
+            explicit TestEcsPositionComponent(ae_ecs::AeECS& t_ecs) : AeComponent(t_ecs) {};
+        };
+
+        class TestEcsVelocityComponent : public ae_ecs::AeComponent<TestEcsVelocity> {
+        public:
+            explicit TestEcsVelocityComponent(ae_ecs::AeECS& t_ecs) :
+                    AeComponent(t_ecs, 16, componentStorageMethod_unorderedMap) {};
+        };
+
+        class TestEcsHealthComponent : public ae_ecs::AeComponent<TestEcsHealth> {
+        public:
+            explicit TestEcsHealthComponent(ae_ecs::AeECS& t_ecs) :
+                    AeComponent(t_ecs, 0, componentStorageMethod_copyOnWritePages) {};
+        };
+
+        class TestEcsNameComponent : public ae_ecs::AeComponent<TestEcsName> {
+        public:
+            explicit TestEcsNameComponent(ae_ecs::AeECS& t_ecs) :
+                    AeComponent(t_ecs, 16, componentStorageMethod_unorderedMap) {};
+        };
+
+        class TestEcsEntity : public ae_ecs::AeEntity<TestEcsEntity> {
+        public:
+            explicit TestEcsEntity(ae_ecs::AeECS& t_ecs) : AeEntity(t_ecs) {};
+        };
+
+        /// A system requiring the position component, used to read the entity lists the ECS hands to systems.
+        class TestEcsSystem : public ae_ecs::AeSystem<TestEcsSystem> {
+        public:
+            TestEcsSystem(ae_ecs::AeECS& t_ecs, TestEcsPositionComponent& t_positionComponent) : AeSystem(t_ecs) {
+                t_positionComponent.requiredBySystem(m_systemId);
+                enableSystem();
+            };
+
+            /// Gets the enabled entities with every component the system requires.
+            std::vector<ecs_id> getEnabledEntities() {
+                ecs_entityList entityIds = m_systemManager.getEnabledSystemsEntities(m_systemId);
+                return {entityIds.begin(), entityIds.end()};
+            };
+
+            /// Gets the enabled entities updated since the system last cleared its list.
+            std::vector<ecs_id> getUpdatedEntities() {
+                ecs_entityList entityIds = m_systemManager.getUpdatedSystemEntities(m_systemId);
+                return {entityIds.begin(), entityIds.end()};
+            };
+
+            /// Gets the entities destroyed since the system last cleared its list.
+            std::vector<ecs_id> getDestroyedEntities() {
+                ecs_entityList entityIds = m_systemManager.getDestroyedSystemEntities(m_systemId);
+                return {entityIds.begin(), entityIds.end()};
+            };
+
+            /// Clears the updated list, as a system does once it has handled the updated entities.
+            void clearUpdatedEntities() {
+                m_systemManager.clearSystemEntityUpdateSignatures(m_systemId);
+            };
+
+            /// Clears the destroyed list, as a system does once it has cleaned up after the destroyed entities.
+            void clearDestroyedEntities() {
+                m_systemManager.clearSystemEntityDestroyedSignatures(m_systemId);
+            };
+
+            /// Fetches the entity lists each time the systems are run, as a system acting on its entities does.
+            void executeSystem() override {
+                m_numEnabledEntitiesRun = m_systemManager.getEnabledSystemsEntities(m_systemId).size();
+                m_numUpdatedEntitiesRun = m_systemManager.getUpdatedSystemEntities(m_systemId).size();
+                m_numDestroyedEntitiesRun = m_systemManager.getDestroyedSystemEntities(m_systemId).size();
+            };
+
+            /// Renames the entities the system keeps outside the ECS when the entity IDs are compacted.
+            void remapEntityIds(const std::vector<EntityIdMove>& t_entityIdMoves) override {
+                remapEntityIdKeys(m_entityNumbers, t_entityIdMoves);
+            };
+
+            /// The number each entity was created from, kept by entity ID the way a system keeps its own entity data.
+            std::map<ecs_id, std::size_t> m_entityNumbers;
+
+            /// The sizes of the entity lists the last time the system was run.
+            std::size_t m_numEnabledEntitiesRun = 0;
+            std::size_t m_numUpdatedEntitiesRun = 0;
+            std::size_t m_numDestroyedEntitiesRun = 0;
+        };
+
+        /// The allocators, the ECS, the components and the system of a test world. The components are created in the
+        /// same order in every world so they are given the same component IDs.
+        struct TestEcsWorld {
+            explicit TestEcsWorld(std::size_t t_maxNumEntities, std::size_t t_frameArenaSize = 1 << 20) :
+                    m_deStackMemory(t_maxNumEntities * sizeof(TestEcsPosition) + 4096),
+                    m_deStackAllocator{m_deStackMemory.size(), m_deStackMemory.data()},
+                    m_freeListMemory(1 << 20),
+                    m_freeListAllocator{m_freeListMemory.size(), m_freeListMemory.data()},
+                    m_frameArenas{2, t_frameArenaSize},
+                    m_ecs{m_deStackAllocator, m_freeListAllocator, m_frameArenas, t_maxNumEntities},
+                    m_positionComponent{m_ecs},
+                    m_velocityComponent{m_ecs},
+                    m_healthComponent{m_ecs},
+                    m_nameComponent{m_ecs},
+                    m_system{m_ecs, m_positionComponent} {};
+
+            std::vector<std::uint8_t> m_deStackMemory;
+            ae_memory::AeDeStackAllocator m_deStackAllocator;
+            std::vector<std::uint8_t> m_freeListMemory;
+            ae_memory::AeFreeLinkedListAllocator m_freeListAllocator;
+            ae_memory::AeFrameArenas m_frameArenas;
+            ae_ecs::AeECS m_ecs;
+            TestEcsPositionComponent m_positionComponent;
+            TestEcsVelocityComponent m_velocityComponent;
+            TestEcsHealthComponent m_healthComponent;
+            TestEcsNameComponent m_nameComponent;
+            TestEcsSystem m_system;
+        };
+
+        /// Creates an entity using the components picked by its number, with data derived from the number.
+        ecs_id addTestEntity(TestEcsWorld& t_world, std::size_t t_number){
+            TestEcsEntity entity{t_world.m_ecs};
+            ecs_id entityId = entity.getEntityId();
+
+            TestEcsPosition& position = t_world.m_positionComponent.requiredByEntityReference(entityId);
+            position.m_position[0] = static_cast<float>(t_number);
+            position.m_position[2] = -0.5f * static_cast<float>(t_number);
+            position.m_flags = static_cast<std::uint32_t>(t_number * 7);
+            if (t_number % 2 == 0) {
+                t_world.m_velocityComponent.requiredByEntityReference(entityId).m_velocity[1] = 1.0 + t_number;
+            };
+            if (t_number % 3 == 0) {
+                t_world.m_healthComponent.requiredByEntityReference(entityId).m_health = static_cast<std::int32_t>(t_number) - 50;
+            };
+            if (t_number % 5 == 0) {
+                t_world.m_nameComponent.requiredByEntityReference(entityId).m_name = "entity " + std::to_string(t_number);
+            };
+            if (t_number % 4 != 3) {
+                entity.enableEntity();
+            };
+            return entityId;
+        };
+
+        /// Reads a whole file.
+        std::vector<char> readFile(const std::filesystem::path& t_filepath){
+            std::ifstream file{t_filepath, std::ios::binary};
+            return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        };
+
+        /// Writes bytes to a file, replacing it.
+        void writeFile(const std::filesystem::path& t_filepath, const std::vector<char>& t_bytes){
+            std::ofstream file{t_filepath, std::ios::binary | std::ios::trunc};
+            file.write(t_bytes.data(), static_cast<std::streamsize>(t_bytes.size()));
+        };
+
+        /// Checks loading a snapshot file throws.
+        bool doesLoadThrow(TestEcsWorld& t_world, const std::filesystem::path& t_filepath){
+            try {
+                ae_ecs::AeEcsSnapshot::loadSnapshot(t_world.m_ecs, t_filepath.string());
+            } catch (const std::runtime_error&) {
+                return true;
+            };
+            return false;
+        };
+    }
+
+    void test_ecs_snapshot(){
+        using namespace test_ecs_detail;
+        const std::size_t maxNumEntities = 256;
+        const std::filesystem::path filepath = std::filesystem::temp_directory_path() / "ae_test_ecs_snapshot.bin";
+        const std::filesystem::path corruptFilepath = std::filesystem::temp_directory_path() / "ae_test_ecs_snapshot_corrupt.bin";
+
+        // A world with entities using every storage method, some disabled, and holes left by destroyed entities.
+        TestEcsWorld savedWorld{maxNumEntities};
+        std::vector<ecs_id> livingEntityIds;
+        for (std::size_t number = 0; number < 120; number++) {
+            ecs_id entityId = addTestEntity(savedWorld, number);
+            if (number % 7 == 6) {
+                savedWorld.m_ecs.destroyEntity(entityId);
+            } else {
+                livingEntityIds.push_back(entityId);
+            };
+        };
+        ae_ecs::AeEcsSnapshot::saveSnapshot(savedWorld.m_ecs, filepath.string());
+
+        // The world the snapshot is loaded into has entities of its own, which are destroyed by the load.
+        TestEcsWorld loadedWorld{maxNumEntities};
+        for (std::size_t number = 200; number < 240; number++) {
+            addTestEntity(loadedWorld, number);
+        };
+        ae_ecs::AeEcsSnapshot::loadSnapshot(loadedWorld.m_ecs, filepath.string());
+
+        for (ecs_id entityId = 0; entityId < maxNumEntities; entityId++) {
+            assert(loadedWorld.m_positionComponent.doesEntityUseThis(entityId) ==
+                   savedWorld.m_positionComponent.doesEntityUseThis(entityId));
+            assert(loadedWorld.m_velocityComponent.doesEntityUseThis(entityId) ==
+                   savedWorld.m_velocityComponent.doesEntityUseThis(entityId));
+            assert(loadedWorld.m_healthComponent.doesEntityUseThis(entityId) ==
+                   savedWorld.m_healthComponent.doesEntityUseThis(entityId));
+
+            // Entities lose the component that can not be persisted, and keep everything else.
+            assert(!loadedWorld.m_nameComponent.doesEntityUseThis(entityId));
+        };
+        for (ecs_id entityId: livingEntityIds) {
+            const TestEcsPosition& savedPosition = savedWorld.m_positionComponent.getReadOnlyDataReference(entityId);
+            const TestEcsPosition& loadedPosition = loadedWorld.m_positionComponent.getReadOnlyDataReference(entityId);
+            assert(std::memcmp(&savedPosition, &loadedPosition, sizeof(TestEcsPosition)) == 0);
+            if (savedWorld.m_velocityComponent.doesEntityUseThis(entityId)) {
+                assert(loadedWorld.m_velocityComponent.getReadOnlyDataReference(entityId).m_velocity[1] ==
+                       savedWorld.m_velocityComponent.getReadOnlyDataReference(entityId).m_velocity[1]);
+            };
+            if (savedWorld.m_healthComponent.doesEntityUseThis(entityId)) {
+                assert(loadedWorld.m_healthComponent.getReadOnlyDataReference(entityId).m_health ==
+                       savedWorld.m_healthComponent.getReadOnlyDataReference(entityId).m_health);
+            };
+        };
+
+        // The enabled bits survive, dropping the name component kept them, and every restored entity is updated.
+        std::vector<ecs_id> enabledEntityIds = savedWorld.m_system.getEnabledEntities();
+        assert(enabledEntityIds.size() == 77);
+        assert(loadedWorld.m_system.getEnabledEntities() == enabledEntityIds);
+        assert(loadedWorld.m_system.getUpdatedEntities() == enabledEntityIds);
+
+        // New entities are only given the IDs that were free in the snapshot.
+        TestEcsEntity newEntity{loadedWorld.m_ecs};
+        assert(std::find(livingEntityIds.begin(), livingEntityIds.end(), newEntity.getEntityId()) == livingEntityIds.end());
+
+        // Snapshots from another version, of another type of file, or of another component type are rejected.
+        const std::vector<char> snapshotBytes = readFile(filepath);
+        std::vector<char> corruptBytes = snapshotBytes;
+        ae_ecs::EcsSnapshotHeader header{};
+        std::memcpy(&header, corruptBytes.data(), sizeof(header));
+        header.m_version = ae_ecs::ECS_SNAPSHOT_VERSION + 1;
+        std::memcpy(corruptBytes.data(), &header, sizeof(header));
+        writeFile(corruptFilepath, corruptBytes);
+        assert(doesLoadThrow(loadedWorld, corruptFilepath));
+
+        // The version is checked before anything is destroyed.
+        assert(loadedWorld.m_system.getEnabledEntities() == enabledEntityIds);
+
+        corruptBytes = snapshotBytes;
+        corruptBytes[0] = 'X';
+        writeFile(corruptFilepath, corruptBytes);
+        assert(doesLoadThrow(loadedWorld, corruptFilepath));
+
+        // Every component header and entity record is checked before anything is destroyed, so a snapshot that can
+        // not be restored leaves the world as it was.
+        auto isWorldIntact = [&](){
+            if (loadedWorld.m_system.getEnabledEntities() != enabledEntityIds) {
+                return false;
+            };
+            for (ecs_id entityId: livingEntityIds) {
+                const TestEcsPosition& savedPosition = savedWorld.m_positionComponent.getReadOnlyDataReference(entityId);
+                const TestEcsPosition& loadedPosition = loadedWorld.m_positionComponent.getReadOnlyDataReference(entityId);
+                if (std::memcmp(&savedPosition, &loadedPosition, sizeof(TestEcsPosition)) != 0) {
+                    return false;
+                };
+            };
+            return true;
+        };
+        auto loadCorruptSnapshot = [&](const std::vector<char>& t_corruptBytes){
+            writeFile(corruptFilepath, t_corruptBytes);
+            return doesLoadThrow(loadedWorld, corruptFilepath) && isWorldIntact();
+        };
+
+        // The offset of each component header, in the order the components were written.
+        std::vector<std::size_t> componentHeaderOffsets;
+        std::size_t componentHeaderOffset = sizeof(ae_ecs::EcsSnapshotHeader) +
+                                            header.m_numEntities * sizeof(ae_ecs::EcsSnapshotEntity);
+        ae_ecs::EcsSnapshotComponentHeader componentHeader{};
+        for (std::uint64_t i = 0; i < header.m_numComponents; i++) {
+            componentHeaderOffsets.push_back(componentHeaderOffset);
+            std::memcpy(&componentHeader, snapshotBytes.data() + componentHeaderOffset, sizeof(componentHeader));
+            componentHeaderOffset += sizeof(componentHeader) + componentHeader.m_payloadSize;
+        };
+        assert(componentHeaderOffset == snapshotBytes.size());
+
+        auto corruptComponentHeader = [&](std::size_t t_componentIndex, auto t_corrupt){
+            std::vector<char> bytes = snapshotBytes;
+            ae_ecs::EcsSnapshotComponentHeader corruptHeader{};
+            std::memcpy(&corruptHeader, bytes.data() + componentHeaderOffsets[t_componentIndex], sizeof(corruptHeader));
+            t_corrupt(corruptHeader);
+            std::memcpy(bytes.data() + componentHeaderOffsets[t_componentIndex], &corruptHeader, sizeof(corruptHeader));
+            return bytes;
+        };
+        std::size_t lastComponentIndex = componentHeaderOffsets.size() - 1;
+        assert(loadCorruptSnapshot(corruptComponentHeader(0, [](auto& t_header){ t_header.m_typeHash ^= 1; })));
+        assert(loadCorruptSnapshot(corruptComponentHeader(lastComponentIndex,
+                                                          [](auto& t_header){ t_header.m_elementSize += 1; })));
+        assert(loadCorruptSnapshot(corruptComponentHeader(0, [](auto& t_header){ t_header.m_payloadSize -= 4; })));
+        assert(loadCorruptSnapshot(corruptComponentHeader(1, [](auto& t_header){ t_header.m_payloadSize += 1 << 20; })));
+        assert(loadCorruptSnapshot(corruptComponentHeader(1, [](auto& t_header){ t_header.m_componentId = 60; })));
+        assert(loadCorruptSnapshot(corruptComponentHeader(1, [](auto& t_header){ t_header.m_payloadLayout = 7; })));
+
+        // The first record of the velocity component, which is stored in a map and so saved as entity records, is
+        // pointed at an entity beyond the limit, a destroyed entity and an entity without velocity, and is made to run
+        // past the end of the snapshot.
+        std::memcpy(&componentHeader, snapshotBytes.data() + componentHeaderOffsets[1], sizeof(componentHeader));
+        assert(componentHeader.m_payloadLayout == ae_ecs::ecsSnapshotPayloadLayout_entityRecords);
+        std::size_t recordOffset = componentHeaderOffsets[1] + sizeof(componentHeader) + sizeof(std::uint64_t);
+        auto corruptRecord = [&](std::uint64_t t_entityId, std::uint64_t t_recordSize){
+            std::vector<char> bytes = snapshotBytes;
+            std::memcpy(bytes.data() + recordOffset, &t_entityId, sizeof(t_entityId));
+            std::memcpy(bytes.data() + recordOffset + sizeof(t_entityId), &t_recordSize, sizeof(t_recordSize));
+            return bytes;
+        };
+        std::uint64_t firstRecordEntityId = 0;
+        std::uint64_t firstRecordSize = 0;
+        std::memcpy(&firstRecordEntityId, snapshotBytes.data() + recordOffset, sizeof(firstRecordEntityId));
+        std::memcpy(&firstRecordSize, snapshotBytes.data() + recordOffset + sizeof(firstRecordEntityId),
+                    sizeof(firstRecordSize));
+        ecs_id entityWithoutVelocity = 0;
+        while (savedWorld.m_velocityComponent.doesEntityUseThis(entityWithoutVelocity) ||
+               std::find(livingEntityIds.begin(), livingEntityIds.end(), entityWithoutVelocity) == livingEntityIds.end()) {
+            entityWithoutVelocity++;
+        };
+        assert(loadCorruptSnapshot(corruptRecord(std::uint64_t{1} << 40, firstRecordSize)));
+        assert(loadCorruptSnapshot(corruptRecord(maxNumEntities, firstRecordSize)));
+        assert(loadCorruptSnapshot(corruptRecord(6, firstRecordSize)));
+        assert(loadCorruptSnapshot(corruptRecord(entityWithoutVelocity, firstRecordSize)));
+        assert(loadCorruptSnapshot(corruptRecord(firstRecordEntityId, std::uint64_t{1} << 40)));
+        assert(loadCorruptSnapshot(corruptRecord(firstRecordEntityId, componentHeader.m_payloadSize)));
+
+        // Entities listed twice, or beyond the limit, are rejected as well.
+        corruptBytes = snapshotBytes;
+        std::memcpy(corruptBytes.data() + sizeof(ae_ecs::EcsSnapshotHeader) + sizeof(ae_ecs::EcsSnapshotEntity),
+                    snapshotBytes.data() + sizeof(ae_ecs::EcsSnapshotHeader), sizeof(std::uint64_t));
+        assert(loadCorruptSnapshot(corruptBytes));
+
+        corruptBytes.assign(snapshotBytes.begin(), snapshotBytes.begin() + static_cast<std::ptrdiff_t>(snapshotBytes.size() / 2));
+        assert(loadCorruptSnapshot(corruptBytes));
+        corruptBytes.assign(snapshotBytes.begin(), snapshotBytes.end() - 1);
+        assert(loadCorruptSnapshot(corruptBytes));
+
+        // A world with other limits can not load the snapshot.
+        TestEcsWorld smallerWorld{maxNumEntities / 2};
+        assert(doesLoadThrow(smallerWorld, filepath));
+
+        // A failed load can be followed by a good one.
+        ae_ecs::AeEcsSnapshot::loadSnapshot(loadedWorld.m_ecs, filepath.string());
+        assert(loadedWorld.m_system.getEnabledEntities() == enabledEntityIds);
+
+        std::filesystem::remove(filepath);
+        std::filesystem::remove(corruptFilepath);
+    };
+
+    void test_ecs_fork(){
+        using namespace test_ecs_detail;
+        const std::size_t maxNumEntities = 2048;
+
+        // Entities with health spread over all the pages of the health component.
+        TestEcsWorld world{maxNumEntities};
+        std::vector<ecs_id> entityIds;
+        std::vector<std::int32_t> initialHealth;
+        for (std::size_t number = 0; number < 3 * 600; number += 3) {
+            entityIds.push_back(addTestEntity(world, number));
+            initialHealth.push_back(world.m_healthComponent.getReadOnlyDataReference(entityIds.back()).m_health);
+        };
+        auto readHealth = [&world](const ae_ecs::AeEcsFork& t_fork, ecs_id t_entityId) {
+            return world.m_healthComponent.getReadOnlyDataReference(t_fork, t_entityId).m_health;
+        };
+        auto writeHealth = [&world](ae_ecs::AeEcsFork& t_fork, ecs_id t_entityId, std::int32_t t_health) {
+            world.m_healthComponent.getWriteableDataReference(t_fork, t_entityId).m_health = t_health;
+        };
+
+        // A fork shares every page, the world and the fork each copy a page before writing to it.
+        std::unique_ptr<ae_ecs::AeEcsFork> fork = world.m_ecs.fork();
+        std::unique_ptr<ae_ecs::AeEcsFork> siblingFork = world.m_ecs.fork();
+        assert(fork->getNumPages() == maxNumEntities / 256 && fork->getNumSharedPages() == fork->getNumPages());
+
+        world.m_healthComponent.getWriteableDataReference(entityIds[0]).m_health = 1000;
+        assert(readHealth(*fork, entityIds[0]) == initialHealth[0] && readHealth(*siblingFork, entityIds[0]) == initialHealth[0]);
+
+        writeHealth(*fork, entityIds[1], 2000);
+        assert(fork->getNumSharedPages() == fork->getNumPages() - 1);
+        assert(world.m_healthComponent.getReadOnlyDataReference(entityIds[1]).m_health == initialHealth[1]);
+        assert(readHealth(*siblingFork, entityIds[1]) == initialHealth[1]);
+
+        writeHealth(*siblingFork, entityIds[1], 3000);
+        assert(readHealth(*fork, entityIds[1]) == 2000 && readHealth(*siblingFork, entityIds[1]) == 3000);
+
+        // A fork of a fork starts from the fork's data, after which neither sees the other's writes, including to the
+        // page the fork had already copied.
+        std::unique_ptr<ae_ecs::AeEcsFork> childFork = fork->fork();
+        assert(fork->getNumSharedPages() == fork->getNumPages());
+        writeHealth(*fork, entityIds[1], 4000);
+        assert(readHealth(*childFork, entityIds[1]) == 2000);
+        writeHealth(*childFork, entityIds.back(), 5000);
+        assert(readHealth(*fork, entityIds.back()) == initialHealth.back());
+
+        // Enabling and disabling within a fork leaves the world alone.
+        std::vector<ecs_id> enabledEntityIds = world.m_system.getEnabledEntities();
+        fork->disableEntity(enabledEntityIds[0]);
+        assert(!fork->getComponentSignature(enabledEntityIds[0]).test(MAX_NUM_COMPONENTS));
+        assert(childFork->getComponentSignature(enabledEntityIds[0]).test(MAX_NUM_COMPONENTS));
+        assert(world.m_system.getEnabledEntities() == enabledEntityIds);
+
+        // Sibling forks written on worker threads while the world is written here. Halfway through, each thread also
+        // forks its fork and writes to both. Every world and fork only ever sees its own writes.
+        const int numThreads = 4;
+        const int numRounds = 40;
+        std::vector<std::int32_t> worldHealth(entityIds.size());
+        for (std::size_t i = 0; i < entityIds.size(); i++) {
+            worldHealth[i] = world.m_healthComponent.getReadOnlyDataReference(entityIds[i]).m_health;
+        };
+        std::vector<std::unique_ptr<ae_ecs::AeEcsFork>> threadForks;
+        for (int thread = 0; thread < numThreads; thread++) {
+            threadForks.push_back(world.m_ecs.fork());
+        };
+
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < numThreads; thread++) {
+            threads.emplace_back([&, thread]() {
+                ae_ecs::AeEcsFork& threadFork = *threadForks[thread];
+                std::unique_ptr<ae_ecs::AeEcsFork> branchFork;
+                for (int round = 0; round < numRounds; round++) {
+                    if (round == numRounds / 2) {
+                        branchFork = threadFork.fork();
+                    };
+                    for (std::size_t i = 0; i < entityIds.size(); i++) {
+                        std::int32_t expectedHealth = round == 0 ? worldHealth[i] : thread * 1000 + round - 1;
+                        assert(readHealth(threadFork, entityIds[i]) == expectedHealth);
+                        writeHealth(threadFork, entityIds[i], thread * 1000 + round);
+
+                        if (branchFork != nullptr) {
+                            std::int32_t expectedBranchHealth = round == numRounds / 2 ? expectedHealth : -(thread * 1000 + round - 1);
+                            assert(readHealth(*branchFork, entityIds[i]) == expectedBranchHealth);
+                            writeHealth(*branchFork, entityIds[i], -(thread * 1000 + round));
+                        };
+                    };
+                };
+            });
+        };
+        for (int round = 0; round < numRounds; round++) {
+            for (ecs_id entityId: entityIds) {
+                world.m_healthComponent.getWriteableDataReference(entityId).m_health = 100000 + round;
+            };
+        };
+        for (auto& thread: threads) {
+            thread.join();
+        };
+
+        for (std::size_t i = 0; i < entityIds.size(); i++) {
+            assert(world.m_healthComponent.getReadOnlyDataReference(entityIds[i]).m_health == 100000 + numRounds - 1);
+            for (int thread = 0; thread < numThreads; thread++) {
+                assert(readHealth(*threadForks[thread], entityIds[i]) == thread * 1000 + numRounds - 1);
+            };
+            assert(readHealth(*siblingFork, entityIds[i]) == (i == 1 ? 3000 : initialHealth[i]));
+        };
+    };
+
+    void test_ecs_entity_id_order(){
+        using namespace test_ecs_detail;
+        TestEcsWorld world{1000};
+
+        // Destroyed IDs are given out again lowest first, before any ID above them.
+        for (std::size_t number = 0; number < 300; number++) {
+            assert(addTestEntity(world, number) == number);
+        };
+        world.m_ecs.destroyEntity(250);
+        world.m_ecs.destroyEntity(10);
+        world.m_ecs.destroyEntity(100);
+        assert(addTestEntity(world, 0) == 10);
+        assert(addTestEntity(world, 0) == 100);
+        assert(addTestEntity(world, 0) == 250);
+        assert(addTestEntity(world, 0) == 300);
+
+        // Compacting moves the living entities into the lowest IDs, after which new entities take the IDs straight
+        // after them, and a destroyed ID is again given out first.
+        for (ecs_id entityId = 20; entityId < 200; entityId += 2) {
+            world.m_ecs.destroyEntity(entityId);
+        };
+        world.m_system.clearDestroyedEntities();
+        std::vector<EntityIdMove> entityIdMoves = world.m_ecs.compactEntityIds();
+        assert(entityIdMoves.size() == 90);
+        const ecs_id numLiving = 301 - 90;
+        for (const auto& entityIdMove: entityIdMoves) {
+            assert(entityIdMove.m_oldId >= numLiving && entityIdMove.m_newId < numLiving);
+        };
+        assert(world.m_ecs.compactEntityIds().empty());
+
+        assert(addTestEntity(world, 0) == numLiving);
+        assert(addTestEntity(world, 0) == numLiving + 1);
+        world.m_ecs.destroyEntity(5);
+        world.m_ecs.destroyEntity(numLiving - 1);
+        world.m_system.clearDestroyedEntities();
+        assert(addTestEntity(world, 0) == 5);
+        assert(addTestEntity(world, 0) == numLiving - 1);
+        assert(addTestEntity(world, 0) == numLiving + 2);
+    };
+
+    void test_ecs_compaction(){
+        using namespace test_ecs_detail;
+        TestEcsWorld world{500};
+        for (std::size_t number = 0; number < 200; number++) {
+            ecs_id entityId = addTestEntity(world, number);
+            world.m_system.m_entityNumbers[entityId] = number;
+        };
+
+        // Holes below the highest entity, of which 0 and 2 are still waiting for the system to clean them up.
+        std::set<ecs_id> freeEntityIds;
+        for (ecs_id entityId = 1; entityId < 120; entityId += 3) {
+            world.m_ecs.destroyEntity(entityId);
+            world.m_system.m_entityNumbers.erase(entityId);
+            freeEntityIds.insert(entityId);
+        };
+        world.m_system.clearDestroyedEntities();
+        world.m_ecs.destroyEntity(0);
+        world.m_ecs.destroyEntity(2);
+        world.m_system.m_entityNumbers.erase(0);
+        world.m_system.m_entityNumbers.erase(2);
+
+        // Only entities updated after this are in the updated list, among them entities that are going to be moved.
+        world.m_system.clearUpdatedEntities();
+        for (ecs_id entityId: {3, 150, 198, 199}) {
+            world.m_positionComponent.getWriteableDataReference(entityId).m_position[1] = 1.0f;
+        };
+
+        // The highest entities move into the lowest holes that are not waiting to be cleaned up.
+        std::vector<EntityIdMove> entityIdMoves = world.m_ecs.compactEntityIds(5);
+        assert(entityIdMoves.size() == 5);
+        for (std::size_t move = 0; move < entityIdMoves.size(); move++) {
+            assert(entityIdMoves[move].m_oldId == 199 - move);
+            assert(entityIdMoves[move].m_newId == *std::next(freeEntityIds.begin(), static_cast<long>(move)));
+        };
+
+        std::vector<EntityIdMove> remainingEntityIdMoves = world.m_ecs.compactEntityIds();
+        entityIdMoves.insert(entityIdMoves.end(), remainingEntityIdMoves.begin(), remainingEntityIdMoves.end());
+        assert(entityIdMoves.size() == freeEntityIds.size());
+        assert(world.m_ecs.compactEntityIds().empty());
+
+        // The entities now fill every ID below 200 minus the number of holes, apart from the two being cleaned up.
+        std::map<ecs_id, ecs_id> newEntityIds;
+        for (ecs_id entityId = 0; entityId < 200; entityId++) {
+            if (entityId != 0 && entityId != 2 && freeEntityIds.count(entityId) == 0) {
+                newEntityIds[entityId] = entityId;
+            };
+        };
+        for (const auto& entityIdMove: entityIdMoves) {
+            newEntityIds[entityIdMove.m_oldId] = entityIdMove.m_newId;
+        };
+        const ecs_id numIds = 200 - static_cast<ecs_id>(freeEntityIds.size());
+
+        // The component data, the signatures, the entity lists and the system's own entity data follow each entity.
+        std::vector<ecs_id> expectedEnabled;
+        std::vector<ecs_id> expectedUpdated;
+        for (const auto& newEntityId: newEntityIds) {
+            ecs_id entityId = newEntityId.second;
+            std::size_t number = newEntityId.first;
+            assert(entityId < numIds && entityId != 0 && entityId != 2);
+            if (entityId != newEntityId.first) {
+                assert(!world.m_positionComponent.doesEntityUseThis(newEntityId.first));
+            };
+
+            const TestEcsPosition& position = world.m_positionComponent.getReadOnlyDataReference(entityId);
+            assert(position.m_position[0] == static_cast<float>(number) && position.m_flags == number * 7);
+            assert(world.m_velocityComponent.doesEntityUseThis(entityId) == (number % 2 == 0));
+            if (number % 2 == 0) {
+                assert(world.m_velocityComponent.getReadOnlyDataReference(entityId).m_velocity[1] == 1.0 + number);
+            };
+            assert(world.m_healthComponent.doesEntityUseThis(entityId) == (number % 3 == 0));
+            if (number % 3 == 0) {
+                assert(world.m_healthComponent.getReadOnlyDataReference(entityId).m_health ==
+                       static_cast<std::int32_t>(number) - 50);
+            };
+            assert(world.m_nameComponent.doesEntityUseThis(entityId) == (number % 5 == 0));
+            if (number % 5 == 0) {
+                assert(world.m_nameComponent.getReadOnlyDataReference(entityId).m_name == "entity " + std::to_string(number));
+            };
+            assert(world.m_system.m_entityNumbers.at(entityId) == number);
+
+            if (number % 4 != 3) {
+                expectedEnabled.push_back(entityId);
+                if (number == 3 || number == 150 || number == 198 || number == 199) {
+                    expectedUpdated.push_back(entityId);
+                };
+            };
+        };
+        assert(world.m_system.m_entityNumbers.size() == newEntityIds.size());
+
+        std::sort(expectedEnabled.begin(), expectedEnabled.end());
+        std::sort(expectedUpdated.begin(), expectedUpdated.end());
+        std::vector<ecs_id> enabled = world.m_system.getEnabledEntities();
+        std::vector<ecs_id> updated = world.m_system.getUpdatedEntities();
+        std::sort(enabled.begin(), enabled.end());
+        std::sort(updated.begin(), updated.end());
+        assert(enabled == expectedEnabled);
+        assert(updated == expectedUpdated);
+        assert((world.m_system.getDestroyedEntities() == std::vector<ecs_id>{0, 2}));
+
+        // Once cleaned up, the held back IDs are the first to be given out again.
+        world.m_system.clearDestroyedEntities();
+        assert(addTestEntity(world, 0) == 0);
+        assert(addTestEntity(world, 0) == 2);
+        assert(addTestEntity(world, 0) == numIds);
+    };
+
+    void test_ecs_stats(){
+        using namespace test_ecs_detail;
+
+        // Names are escaped so the document stays valid JSON, control characters without a short escape as \u00XX.
+        ae_ecs::AeEcsStats namedStats{};
+        namedStats.m_systems.push_back({});
+        namedStats.m_systems.back().m_systemTypeName = std::string{"a\"b\\c\nd\te\x01\x1f\r"} + '\0';
+        std::string namedJson = namedStats.toJson();
+        assert(namedJson.find("\"systemType\": \"a\\\"b\\\\c\\nd\\te\\u0001\\u001f\\u000d\\u0000\"") != std::string::npos);
+        for (char character: namedJson) {
+            assert(static_cast<unsigned char>(character) >= 0x20 || character == '\n');
+        };
+
+        // The counts of a world with destroyed and disabled entities.
+        TestEcsWorld world{100};
+        for (std::size_t number = 0; number < 10; number++) {
+            addTestEntity(world, number);
+        };
+        world.m_ecs.destroyEntity(0);
+        world.m_ecs.destroyEntity(3);
+        ae_ecs::AeEcsStats stats = world.m_ecs.getStats();
+        assert(stats.m_maxNumEntities == 100);
+        assert(stats.m_numLivingEntities == 8);
+        assert(stats.m_numEnabledEntities == 7);
+        assert(stats.m_entityIdHighWaterMark == 10);
+        assert(stats.m_components.size() == 4);
+        assert(stats.m_components[0].m_entityCount == 8 && stats.m_components[1].m_entityCount == 4);
+        assert(stats.m_components[2].m_entityCount == 2 && stats.m_components[3].m_entityCount == 1);
+        assert(stats.m_systems.size() == 1);
+        assert(stats.m_systems[0].m_matchingEntityCount == 7);
+        assert(stats.m_systems[0].m_updatedEntityCount == 7);
+
+        // Only the destroyed entity that was enabled, and so seen by the system, is in its destroyed list.
+        assert(stats.m_systems[0].m_destroyedEntityCount == 1);
+
+        std::string json = stats.toJson();
+        assert(json.find("\"living\": 8,") != std::string::npos);
+        assert(json.find("\"enabled\": 7,") != std::string::npos);
+        assert(json.find("\"available\": 92,") != std::string::npos);
+        assert(json.find("\"matchingEntityCount\": 7,") != std::string::npos);
+
+        // The file holds the same document, and a file that can not be opened throws.
+        std::filesystem::path filepath = std::filesystem::temp_directory_path() / "test_ecs_stats.json";
+        stats.writeJson(filepath.string());
+        std::vector<char> writtenJson = readFile(filepath);
+        assert(std::string(writtenJson.begin(), writtenJson.end()) == json);
+        std::filesystem::remove(filepath);
+
+        bool isThrown = false;
+        try {
+            stats.writeJson((std::filesystem::temp_directory_path() / "missing_directory" / "stats.json").string());
+        } catch (const std::runtime_error&) {
+            isThrown = true;
+        };
+        assert(isThrown);
+    };
+
+    void test_ecs_frame_arenas(){
+        using namespace test_ecs_detail;
+
+        // Arenas that fit one run's reserved lists but not two runs, nor lists grown one element at a time. The updated
+        // list is reserved for every updated entity, whether or not it is still enabled.
+        const std::size_t numEntities = 3000;
+        const std::size_t numEnabledEntities = numEntities - numEntities / 4;
+        const std::size_t bytesPerRun = (numEnabledEntities + numEntities) * sizeof(ecs_id);
+        TestEcsWorld world{4096, bytesPerRun + bytesPerRun / 2};
+        for (std::size_t number = 0; number < numEntities; number++) {
+            addTestEntity(world, number);
+        };
+
+        // Without a renderer, the ECS begins a frame arena each run so the lists never run out of memory.
+        for (int run = 0; run < 100; run++) {
+            world.m_ecs.runSystems();
+            assert(world.m_system.m_numEnabledEntitiesRun == numEnabledEntities);
+            assert(world.m_system.m_numUpdatedEntitiesRun == numEnabledEntities);
+            assert(world.m_system.m_numDestroyedEntitiesRun == 0);
+        };
+
+        // Each list is allocated once at its reserved size, so a run uses exactly the memory of its lists.
+        assert(world.m_frameArenas.getCurrentArena().getMemoryInUse() == bytesPerRun);
+
+        // The statistics count the entities after a run without building lists in the arena, which has no room left
+        // for them.
+        ae_ecs::AeEcsStats stats = world.m_ecs.getStats();
+        assert(world.m_frameArenas.getCurrentArena().getMemoryInUse() == bytesPerRun);
+        assert(stats.m_systems.size() == 1);
+        assert(stats.m_systems[0].m_matchingEntityCount == numEnabledEntities);
+        assert(stats.m_systems[0].m_updatedEntityCount == numEnabledEntities);
+        assert(stats.m_systems[0].m_destroyedEntityCount == 0);
+    };
+
+} // namespace ae
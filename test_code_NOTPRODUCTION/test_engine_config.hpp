@@ -0,0 +1,97 @@
+/// \file test_engine_config.hpp
+/// The tests of the engine configuration are defined. Configuration files are written to the temporary directory and
+/// read back, checking the specified limits are kept, the others are sized from the host, and malformed files throw.
+#pragma once
+
+// dependencies
+#include "ae_engine_config.hpp"
+
+// libraries
+
+// std
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace ae {
+
+    namespace test_engine_config_detail {
+
+        /// Writes a configuration file, replacing it.
+        std::string writeConfig(const std::string& t_contents){
+            std::filesystem::path filepath = std::filesystem::temp_directory_path() / "test_engine_config.cfg";
+            std::ofstream file{filepath, std::ios::trunc};
+            file << t_contents;
+            return filepath.string();
+        };
+
+        /// Checks loading a configuration throws.
+        bool doesLoadThrow(const std::string& t_contents){
+            std::string filepath = writeConfig(t_contents);
+            try {
+                AeEngineConfig::loadLimits(filepath);
+            } catch (const std::runtime_error&) {
+                return true;
+            };
+            return false;
+        };
+
+        /// Checks the host limits were all sized.
+        void checkHostLimitsSized(const AeEngineLimits& t_limits){
+            assert(t_limits.m_maxNumEntities > 0);
+            assert(t_limits.m_deStackAllocatorBytes > 0);
+            assert(t_limits.m_freeListAllocatorBytes > 0);
+            assert(t_limits.m_frameArenaBytes > 0);
+            assert(t_limits.m_slabAllocatorBytes > 0);
+        };
+    }
+
+    void test_engine_config(){
+        using namespace test_engine_config_detail;
+
+        // A missing file sizes every host limit from the hardware and leaves the GPU limits for fitToDevice.
+        AeEngineLimits defaultLimits = AeEngineConfig::loadLimits(
+                (std::filesystem::temp_directory_path() / "missing_engine_config.cfg").string());
+        checkHostLimitsSized(defaultLimits);
+        assert(defaultLimits.m_maxObjects == 0 && defaultLimits.m_maxModels == 0);
+
+        // Specified limits are kept, comments, blank lines and whitespace are skipped, and auto sizes from the hardware.
+        AeEngineLimits limits = AeEngineConfig::loadLimits(writeConfig("# The limits of a test.\n"
+                                                                       "\n"
+                                                                       "max_entities = 5000\n"
+                                                                       "  max_objects=123  \r\n"
+                                                                       "max_models = auto\n"
+                                                                       "\tframe_arena_bytes =\t65536\n"
+                                                                       "slab_allocator_bytes = auto\n"));
+        checkHostLimitsSized(limits);
+        assert(limits.m_maxNumEntities == 5000);
+        assert(limits.m_maxObjects == 123);
+        assert(limits.m_maxModels == 0);
+        assert(limits.m_frameArenaBytes == 65536);
+
+        // Limits sized from a specified number of entities never pass the fraction of memory they may use.
+        std::size_t physicalMemoryBytes = AeEngineConfig::getPhysicalMemoryBytes();
+        if (physicalMemoryBytes != 0) {
+            assert(limits.m_deStackAllocatorBytes <= physicalMemoryBytes / 4);
+        };
+
+        // Values that are not positive numbers, negative numbers among them, are configuration errors.
+        assert(doesLoadThrow("max_entities = -1\n"));
+        assert(doesLoadThrow("max_entities = -0\n"));
+        assert(doesLoadThrow("max_entities = +5\n"));
+        assert(doesLoadThrow("max_entities = 0\n"));
+        assert(doesLoadThrow("max_entities = 12abc\n"));
+        assert(doesLoadThrow("max_entities = 1.5\n"));
+        assert(doesLoadThrow("max_entities =\n"));
+        assert(doesLoadThrow("max_entities = 99999999999999999999999\n"));
+
+        // Unknown keys and lines that are not pairs are configuration errors too.
+        assert(doesLoadThrow("max_entitys = 5000\n"));
+        assert(doesLoadThrow("max_entities 5000\n"));
+
+        std::filesystem::remove(writeConfig(""));
+    };
+
+} // namespace ae
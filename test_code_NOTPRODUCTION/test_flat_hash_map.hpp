@@ -0,0 +1,145 @@
+/// \file test_flat_hash_map.hpp
+/// The tests of the flat hash map are defined. The map is checked against std::unordered_map through a long random
+/// sequence of inserts, erases and lookups, which also checks that the deleted slots left by erases are reused.
+#pragma once
+
+// dependencies
+#include "ae_allocator_stl_adapter.hpp"
+#include "ae_tlsf_allocator.hpp"
+#include "flat_hash_map.hpp"
+
+// libraries
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ae {
+
+    namespace test_flat_hash_map_detail {
+
+        /// A value that counts how many of it are alive, to catch elements that are not destroyed or destroyed twice.
+        struct CountedValue {
+            explicit CountedValue(int t_value = 0) : m_value{t_value} { numAlive()++; };
+            CountedValue(const CountedValue& t_other) : m_value{t_other.m_value} { numAlive()++; };
+            CountedValue(CountedValue&& t_other) noexcept : m_value{t_other.m_value} { numAlive()++; };
+            CountedValue& operator=(const CountedValue&) = default;
+            CountedValue& operator=(CountedValue&&) = default;
+            ~CountedValue() { numAlive()--; };
+
+            static int& numAlive() {
+                static int alive = 0;
+                return alive;
+            };
+
+            int m_value;
+        };
+    }
+
+    void test_flat_hash_map(){
+        using test_flat_hash_map_detail::CountedValue;
+
+        // Random inserts, erases and lookups give the same results as std::unordered_map. The few keys make erases
+        // and reinserts of the same keys common, and every element is destroyed exactly once.
+        {
+            flat_hash_map<uint64_t, CountedValue> map;
+            std::unordered_map<uint64_t, int> expected;
+            uint64_t random = 88172645463325252ull;
+            for (int operation = 0; operation < 200000; operation++) {
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                uint64_t key = random % 5000;
+                int value = static_cast<int>(random >> 40);
+                switch (random % 4) {
+                    case 0:
+                    case 1: {
+                        bool isInserted = map.try_emplace(key, value).second;
+                        assert(isInserted == expected.emplace(key, value).second);
+                        break;
+                    }
+                    case 2:
+                        assert(map.erase(key) == expected.erase(key));
+                        break;
+                    default: {
+                        auto element = map.find(key);
+                        auto expectedElement = expected.find(key);
+                        assert((element == map.end()) == (expectedElement == expected.end()));
+                        if (element != map.end()) {
+                            assert(element->first == key && element->second.m_value == expectedElement->second);
+                        };
+                        break;
+                    }
+                };
+                assert(map.size() == expected.size());
+            };
+
+            std::size_t numIterated = 0;
+            for (const auto& element: map) {
+                assert(expected.at(element.first) == element.second.m_value);
+                numIterated++;
+            };
+            assert(numIterated == expected.size());
+            assert(CountedValue::numAlive() == static_cast<int>(map.size()));
+
+            // Erasing while iterating visits every element once.
+            for (auto element = map.begin(); element != map.end();) {
+                element = element->first % 2 == 0 ? map.erase(element) : std::next(element);
+            };
+            for (const auto& element: map) {
+                assert(element.first % 2 == 1);
+            };
+
+            flat_hash_map<uint64_t, CountedValue> copy = map;
+            assert(copy.size() == map.size());
+            flat_hash_map<uint64_t, CountedValue> moved = std::move(copy);
+            assert(copy.empty() && moved.size() == map.size());
+            for (const auto& element: map) {
+                assert(moved.at(element.first).m_value == element.second.m_value);
+            };
+            moved.clear();
+            assert(moved.empty() && moved.find(1) == moved.end());
+        }
+        assert(CountedValue::numAlive() == 0);
+
+        // Strings are looked up by string views and literals without making a std::string.
+        {
+            flat_hash_map<std::string, int, string_hash, std::equal_to<>> map{{"a string long enough to be on the heap", 1},
+                                                                              {"b", 2}};
+            map["c"] = 3;
+            assert(map.insert_or_assign("b", 4).second == false);
+            std::string_view key = "a string long enough to be on the heap";
+            assert(map.contains(key) && map.at(key) == 1);
+            assert(map.count("b") == 1 && map.at("b") == 4);
+            assert(!map.contains(std::string_view{"d"}));
+            assert(map.erase("c") == 1 && map.size() == 2);
+        }
+
+        // The slots and control bytes are borrowed from an engine allocator and all given back.
+        {
+            // In bytes.
+            std::size_t preAllocatedSize = 1 << 22;
+            auto preAllocatedMemory = std::make_unique<unsigned char[]>(preAllocatedSize);
+            ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize, preAllocatedMemory.get()};
+            {
+                using Adaptor = ae_memory::AeAllocatorStlAdaptor<std::pair<const uint32_t, uint32_t>,
+                                                                 ae_memory::AeTlsfAllocator>;
+                flat_hash_map<uint32_t, uint32_t, std::hash<uint32_t>, std::equal_to<uint32_t>, Adaptor> map{
+                        Adaptor{tlsfAllocator}};
+                for (uint32_t key = 0; key < 10000; key++) {
+                    map.emplace(key, key * 3);
+                };
+                for (uint32_t key = 0; key < 10000; key++) {
+                    assert(map.at(key) == key * 3);
+                };
+                assert(tlsfAllocator.getMemoryInUse() > 0);
+            }
+            assert(tlsfAllocator.getMemoryInUse() == 0);
+        }
+    };
+
+} // namespace ae
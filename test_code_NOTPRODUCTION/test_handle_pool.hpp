@@ -0,0 +1,163 @@
+/// \file test_handle_pool.hpp
+/// The tests of the handle pool are defined. Handles to removed objects must be rejected, a reused slot must hand out
+/// the next generation, the 12 bit generation must wrap around without ever reaching the null handle, and the pool
+/// must refuse more objects than the 20 bit index can reference.
+#pragma once
+
+// dependencies
+#include "handle_pool.hpp"
+
+// libraries
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace ae {
+
+    namespace test_handle_pool_detail {
+
+        /// The type referenced by the handles of the tests.
+        struct TestObject{
+            int m_value = 0;
+        };
+
+        /// Checks getting the object of a handle throws.
+        bool doesGetThrow(HandlePool<TestObject>& t_pool, AeHandle<TestObject> t_handle){
+            try {
+                t_pool.get(t_handle);
+            } catch (const std::runtime_error&) {
+                return true;
+            };
+            return false;
+        };
+
+        /// Checks removing the object of a handle throws.
+        bool doesRemoveThrow(HandlePool<TestObject>& t_pool, AeHandle<TestObject> t_handle){
+            try {
+                t_pool.remove(t_handle);
+            } catch (const std::runtime_error&) {
+                return true;
+            };
+            return false;
+        };
+    }
+
+    void test_handle_pool(){
+        using namespace test_handle_pool_detail;
+        using Handle = AeHandle<TestObject>;
+
+        // The index and generation are packed into the value and read back, the index masked to its bits.
+        static_assert(Handle::INDEX_BITS == 20 && Handle::GENERATION_BITS == 12);
+        static_assert(Handle::MAX_GENERATION == 4095);
+        static_assert(Handle{5, 3}.getIndex() == 5 && Handle{5, 3}.getGeneration() == 3);
+        static_assert(Handle{Handle::INDEX_MASK + 7, 1}.getIndex() == 6);
+        static_assert(Handle::fromValue(Handle{9, 2}.getValue()) == Handle{9, 2});
+        static_assert(Handle{}.isNull() && !Handle{0, 1}.isNull());
+
+        // Objects are found through their handles and stay dense when one in the middle is removed.
+        {
+            HandlePool<TestObject> pool{4};
+            Handle handleA = pool.insert(TestObject{1});
+            Handle handleB = pool.emplace(TestObject{2});
+            Handle handleC = pool.insert(TestObject{3});
+            assert(pool.size() == 3 && pool.getNumSlots() == 3);
+            assert(handleA.getGeneration() == 1 && handleB.getIndex() == 1);
+
+            pool.remove(handleA);
+            assert(pool.size() == 2);
+            assert(pool.get(handleB).m_value == 2 && pool.get(handleC).m_value == 3);
+            assert(pool.getHandle(0) == handleC && pool.getHandle(1) == handleB);
+            int sum = 0;
+            for (auto& object: pool) {
+                sum += object.m_value;
+            };
+            assert(sum == 5);
+
+            // The removed object's handle, and the null handle, are rejected by every way of using them.
+            for (Handle staleHandle: {handleA, Handle{}}) {
+                assert(!pool.isValid(staleHandle));
+                assert(pool.tryGet(staleHandle) == nullptr);
+                assert(doesGetThrow(pool, staleHandle));
+                assert(doesRemoveThrow(pool, staleHandle));
+            };
+            assert(!pool.isValid(Handle{100, 1}));
+
+            // The freed slot is reused with the next generation, and the old handle still does not reach the new
+            // object.
+            Handle handleD = pool.insert(TestObject{4});
+            assert(handleD.getIndex() == handleA.getIndex());
+            assert(handleD.getGeneration() == handleA.getGeneration() + 1);
+            assert(pool.getNumSlots() == 3);
+            assert(pool.get(handleD).m_value == 4);
+            assert(!pool.isValid(handleA) && pool.tryGet(handleA) == nullptr);
+
+            pool.clear();
+            assert(pool.empty());
+            for (Handle clearedHandle: {handleB, handleC, handleD}) {
+                assert(!pool.isValid(clearedHandle));
+            };
+        };
+
+        // A slot reused MAX_GENERATION times wraps back to generation 1, never to the generation of the null handle.
+        {
+            HandlePool<TestObject> pool{};
+            Handle firstHandle = pool.insert(TestObject{0});
+            Handle handle = firstHandle;
+            for (uint32_t generation = 1; generation < Handle::MAX_GENERATION; generation++) {
+                assert(handle.getGeneration() == generation && handle.getIndex() == firstHandle.getIndex());
+                pool.remove(handle);
+                handle = pool.insert(TestObject{static_cast<int>(generation)});
+            };
+            assert(handle.getGeneration() == Handle::MAX_GENERATION);
+            assert(handle.getValue() == (Handle::MAX_GENERATION << Handle::INDEX_BITS));
+
+            pool.remove(handle);
+            Handle wrappedHandle = pool.insert(TestObject{-1});
+            assert(wrappedHandle.getGeneration() == 1 && !wrappedHandle.isNull());
+            assert(!pool.isValid(handle));
+            assert(pool.get(wrappedHandle).m_value == -1);
+        };
+
+        // Every index the handle can hold is handed out, one more object is refused until a slot is freed.
+        {
+            HandlePool<TestObject> pool{HandlePool<TestObject>::MAX_OBJECTS};
+            std::vector<Handle> handles;
+            handles.reserve(HandlePool<TestObject>::MAX_OBJECTS);
+            for (std::size_t i = 0; i < HandlePool<TestObject>::MAX_OBJECTS; i++) {
+                handles.push_back(pool.insert(TestObject{static_cast<int>(i)}));
+            };
+            assert(handles.back().getIndex() == Handle::INDEX_MASK);
+            assert(pool.getNumSlots() == HandlePool<TestObject>::MAX_OBJECTS);
+
+            bool isFullThrown = false;
+            try {
+                pool.insert(TestObject{});
+            } catch (const std::runtime_error&) {
+                isFullThrown = true;
+            };
+            assert(isFullThrown);
+            assert(pool.size() == HandlePool<TestObject>::MAX_OBJECTS);
+
+            pool.remove(handles[1234]);
+            Handle reusedHandle = pool.insert(TestObject{-2});
+            assert(reusedHandle.getIndex() == 1234 && reusedHandle.getGeneration() == 2);
+            assert(pool.get(handles.back()).m_value == static_cast<int>(Handle::INDEX_MASK));
+        };
+
+        // A pool of owning pointers hands out handles to the objects pointed to, and moves the pointers when removing.
+        {
+            HandlePool<std::unique_ptr<TestObject>, TestObject> pool{};
+            Handle handleA = pool.insert(std::make_unique<TestObject>(TestObject{7}));
+            Handle handleB = pool.insert(std::make_unique<TestObject>(TestObject{8}));
+            TestObject* objectB = pool.get(handleB).get();
+            pool.remove(handleA);
+            assert(pool.get(handleB).get() == objectB && objectB->m_value == 8);
+            assert(pool.tryGet(handleA) == nullptr);
+        };
+    };
+
+} // namespace ae
@@ -0,0 +1,136 @@
+/// \file test_hierarchical_bitset.hpp
+/// The tests of the hierarchical bitset are defined. Bitsets of sizes with one to four levels are checked against
+/// std::set through random sets and resets, the searches, iteration, unions and intersections.
+#pragma once
+
+// dependencies
+#include "hierarchical_bitset.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+
+namespace ae {
+
+    namespace test_hierarchical_bitset_detail {
+
+        /// Checks every query of a bitset against the set of its indices.
+        void checkBitset(const HierarchicalBitset& t_bitset, const std::set<std::size_t>& t_expected){
+            assert(t_bitset.count() == t_expected.size());
+            assert(t_bitset.any() == !t_expected.empty());
+            assert(t_bitset.findFirstSet() == (t_expected.empty() ? HierarchicalBitset::npos : *t_expected.begin()));
+            assert(t_bitset.findLastSet() == (t_expected.empty() ? HierarchicalBitset::npos : *t_expected.rbegin()));
+
+            std::size_t firstZero = 0;
+            while (firstZero < t_bitset.size() && t_expected.count(firstZero) == 1) {
+                firstZero++;
+            };
+            assert(t_bitset.findFirstZero() == (firstZero == t_bitset.size() ? HierarchicalBitset::npos : firstZero));
+
+            assert(std::equal(t_bitset.begin(), t_bitset.end(), t_expected.begin(), t_expected.end()));
+            std::vector<std::size_t> visited;
+            t_bitset.forEachSet([&visited](std::size_t t_index) { visited.push_back(t_index); });
+            assert(std::equal(visited.begin(), visited.end(), t_expected.begin(), t_expected.end()));
+        };
+    }
+
+    void test_hierarchical_bitset(){
+        using test_hierarchical_bitset_detail::checkBitset;
+
+        uint64_t random = 88172645463325252ull;
+        auto nextRandom = [&random]() {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            return random;
+        };
+
+        for (std::size_t numBits: {std::size_t{1}, std::size_t{64}, std::size_t{4097}, std::size_t{300000}}) {
+            HierarchicalBitset bitset{numBits};
+            std::set<std::size_t> expected;
+            checkBitset(bitset, expected);
+
+            // Bits are set in clusters so words fill up and empty out, some runs also setting most of the bits.
+            for (int round = 0; round < 20; round++) {
+                std::size_t clusterStart = nextRandom() % numBits;
+                std::size_t clusterSize = std::min<std::size_t>(nextRandom() % 300 + 1, numBits - clusterStart);
+                bool isSetting = round % 3 != 2;
+                for (std::size_t index = clusterStart; index < clusterStart + clusterSize; index++) {
+                    if (isSetting || nextRandom() % 4 != 0) {
+                        bitset.set(index);
+                        expected.insert(index);
+                    } else {
+                        bitset.reset(index);
+                        expected.erase(index);
+                    };
+                };
+                for (int i = 0; i < 50; i++) {
+                    std::size_t index = nextRandom() % numBits;
+                    bitset.reset(index);
+                    expected.erase(index);
+                };
+                checkBitset(bitset, expected);
+
+                // The next set bit from random places.
+                for (int i = 0; i < 50; i++) {
+                    std::size_t index = nextRandom() % numBits;
+                    auto next = expected.lower_bound(index);
+                    assert(bitset.findNextSet(index) == (next == expected.end() ? HierarchicalBitset::npos : *next));
+                };
+            };
+
+            // Filling every bit leaves no zero, and resetting one makes it the first zero.
+            HierarchicalBitset full{numBits};
+            for (std::size_t index = 0; index < numBits; index++) {
+                full.set(index);
+            };
+            assert(full.findFirstZero() == HierarchicalBitset::npos && full.count() == numBits);
+            full.reset(numBits - 1);
+            assert(full.findFirstZero() == numBits - 1);
+
+            // Union and intersection with a second random bitset.
+            HierarchicalBitset other{numBits};
+            std::set<std::size_t> otherExpected;
+            for (int i = 0; i < 500; i++) {
+                std::size_t index = nextRandom() % numBits;
+                other.set(index);
+                otherExpected.insert(index);
+            };
+            HierarchicalBitset unionBitset = bitset;
+            unionBitset |= other;
+            std::set<std::size_t> unionExpected = expected;
+            unionExpected.insert(otherExpected.begin(), otherExpected.end());
+            checkBitset(unionBitset, unionExpected);
+
+            HierarchicalBitset intersectionBitset = bitset;
+            intersectionBitset &= other;
+            std::set<std::size_t> intersectionExpected;
+            std::set_intersection(expected.begin(), expected.end(), otherExpected.begin(), otherExpected.end(),
+                                  std::inserter(intersectionExpected, intersectionExpected.begin()));
+            checkBitset(intersectionBitset, intersectionExpected);
+            assert(bitset.countCommon(other) == intersectionExpected.size());
+            assert(other.countCommon(bitset) == intersectionExpected.size());
+
+            full |= bitset;
+            assert(full.count() == numBits - 1 + (expected.count(numBits - 1) == 1 ? 1 : 0));
+
+            // Resetting the bits while iterating over them visits every bit once.
+            std::size_t numVisited = 0;
+            for (auto index = unionBitset.begin(); index != unionBitset.end(); ++index) {
+                unionBitset.reset(*index);
+                numVisited++;
+            };
+            assert(numVisited == unionExpected.size() && unionBitset.none());
+
+            bitset.clear();
+            checkBitset(bitset, {});
+        };
+    };
+
+} // namespace ae
@@ -0,0 +1,153 @@
+/// \file test_job_system.hpp
+/// The stress tests of the job system are defined. Run them under -fsanitize=thread as well as normally, a data race
+/// will not always show up as a wrong result.
+#pragma once
+
+// dependencies
+#include "ae_job_system.hpp"
+#include "radix_sort.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace ae_jobs {
+
+    void test_job_system(){
+        // Few job slots so they are reused many times, and scheduling has to help while they are all taken.
+        AeJobSystem jobSystem{3, 64, false};
+
+        // A chain of jobs each depending on the last, and a job depending on a job that has already finished.
+        {
+            std::vector<int> order;
+            AeJobHandle previous{};
+            for (int i = 0; i < 200; i++) {
+                previous = jobSystem.schedule([&order, i](){ order.push_back(i); }, {previous});
+            };
+            jobSystem.wait(previous);
+            assert(order.size() == 200);
+            for (int i = 0; i < 200; i++) {
+                assert(order[i] == i);
+            };
+
+            AeJobHandle finished = jobSystem.schedule([](){});
+            jobSystem.wait(finished);
+            assert(jobSystem.isFinished(finished));
+            bool isRun = false;
+            jobSystem.wait(jobSystem.schedule([&isRun](){ isRun = true; }, {finished, AeJobHandle{}}));
+            assert(isRun);
+        }
+
+        // A diamond, the last job only runs once both of the middle jobs have.
+        for (int repetition = 0; repetition < 1000; repetition++) {
+            std::atomic<int> value{0};
+            AeJobHandle first = jobSystem.schedule([&value](){ value.store(1); });
+            AeJobHandle left = jobSystem.schedule([&value](){ value.fetch_add(10); }, {first});
+            AeJobHandle right = jobSystem.schedule([&value](){ value.fetch_add(100); }, {first});
+            AeJobHandle last = jobSystem.schedule([&value](){ assert(value.load() == 111); value.store(-1); },
+                                                  {left, right});
+            jobSystem.wait(last);
+            assert(value.load() == -1);
+        };
+
+        // Every index of a loop is run exactly once, including by loops nested inside the batches of another, and a
+        // loop waits on the job before it.
+        {
+            constexpr std::size_t count = 100000;
+            std::vector<std::atomic<std::uint8_t>> timesRun(count);
+            jobSystem.parallelFor(count, 0, [&timesRun](std::size_t t_begin, std::size_t t_end) {
+                for (std::size_t i = t_begin; i < t_end; i++) {
+                    timesRun[i].fetch_add(1);
+                };
+            });
+            for (auto& times: timesRun) {
+                assert(times.load() == 1);
+            };
+
+            std::atomic<std::size_t> sum{0};
+            jobSystem.parallelFor(16, [&](std::size_t t_outer) {
+                jobSystem.parallelFor(100, 7, [&](std::size_t t_begin, std::size_t t_end) {
+                    for (std::size_t i = t_begin; i < t_end; i++) {
+                        sum.fetch_add(t_outer * 100 + i);
+                    };
+                });
+            });
+            assert(sum.load() == 1600 * 1599 / 2);
+
+            std::atomic<bool> isFirstRun{false};
+            AeJobHandle first = jobSystem.schedule([&isFirstRun](){ isFirstRun.store(true); });
+            jobSystem.wait(jobSystem.scheduleParallelFor(1000, 10, [&isFirstRun](std::size_t, std::size_t) {
+                assert(isFirstRun.load());
+            }, {first}));
+        }
+
+        // The first exception thrown by a job is rethrown by the next wait, and only once.
+        {
+            bool isThrown = false;
+            try {
+                jobSystem.parallelFor(100, [](std::size_t t_index) {
+                    if (t_index == 42) {
+                        throw std::runtime_error("A job failed!");
+                    };
+                });
+            } catch (const std::runtime_error&) {
+                isThrown = true;
+            };
+            assert(isThrown);
+            jobSystem.wait(jobSystem.schedule([](){}));
+        }
+
+        // The radix sort runs on the job system the same as on a thread pool.
+        {
+            std::vector<std::uint32_t> keys(200000);
+            std::uint32_t random = 12345;
+            for (auto& key: keys) {
+                random = random * 1664525u + 1013904223u;
+                key = random;
+            };
+            std::vector<std::uint32_t> expected = keys;
+            std::sort(expected.begin(), expected.end());
+            ae::parallelRadixSort(jobSystem, keys.data(), keys.size());
+            assert(keys == expected);
+        }
+
+        // Every job run is counted by exactly one thread. A worker counts a job just after finishing it, so the last
+        // counts may land after the wait returns.
+        {
+            jobSystem.resetStatistics();
+            jobSystem.parallelFor(500, [](std::size_t) {});
+            std::uint64_t numJobsRun = 0;
+            while (numJobsRun < 500) {
+                std::this_thread::yield();
+                numJobsRun = jobSystem.getHelperStatistics().m_numJobsRun;
+                for (const auto& statistics: jobSystem.getWorkerStatistics()) {
+                    numJobsRun += statistics.m_numJobsRun;
+                };
+            };
+            assert(numJobsRun == 500);
+            for (const auto& statistics: jobSystem.getWorkerStatistics()) {
+                assert(statistics.m_numSteals <= statistics.m_numStealAttempts);
+            };
+        }
+
+        // Jobs left running when the job system is destroyed are finished first.
+        {
+            std::atomic<int> numRun{0};
+            {
+                AeJobSystem shortLivedJobSystem{2, 16};
+                for (int i = 0; i < 100; i++) {
+                    shortLivedJobSystem.schedule([&numRun](){ numRun.fetch_add(1); });
+                };
+            }
+            assert(numRun.load() == 100);
+        }
+    };
+
+} // namespace ae_jobs
@@ -0,0 +1,232 @@
+/// \file test_linear_bvh.hpp
+/// The tests of the Morton codes and the linear BVH are defined. Trees are built over random boxes, including many
+/// boxes sharing a centre, checked to be well formed, and their queries checked to find the same primitives as the
+/// linear batch functions of simd_geometry.hpp and a brute force search for overlapping pairs, before and after the
+/// boxes move and the tree is refit. Parallel builds are checked to make the same tree as serial builds.
+#pragma once
+
+// dependencies
+#include "linear_bvh.hpp"
+#include "thread_pool.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ae {
+
+    namespace test_linear_bvh_detail {
+
+        /// Checks every primitive has one leaf, every node's parent points back at it and every internal node's bounds
+        /// are exactly the union of its children's.
+        void checkTree(const LinearBvh& t_bvh, const AabbSoa& t_aabbs){
+            const std::vector<BvhNode>& nodes = t_bvh.getNodes();
+            const std::vector<uint32_t>& parents = t_bvh.getParents();
+            const std::size_t numPrimitives = t_aabbs.size();
+            assert(nodes.size() == (numPrimitives == 0 ? 0 : 2 * numPrimitives - 1));
+            if (numPrimitives == 0) {
+                return;
+            };
+            assert(parents[0] == LinearBvh::INVALID_NODE);
+            assert(std::is_sorted(t_bvh.getMortonCodes().begin(), t_bvh.getMortonCodes().end()));
+
+            std::vector<uint32_t> numLeavesOfPrimitive(numPrimitives, 0);
+            for (uint32_t nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++) {
+                const BvhNode& node = nodes[nodeIndex];
+                assert(t_bvh.isLeaf(nodeIndex) == (nodeIndex >= numPrimitives - 1));
+                if (t_bvh.isLeaf(nodeIndex)) {
+                    numLeavesOfPrimitive[node.m_left]++;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        assert(node.m_min[axis] == t_aabbs.m_min[axis][node.m_left]);
+                        assert(node.m_max[axis] == t_aabbs.m_max[axis][node.m_left]);
+                    };
+                } else {
+                    assert(parents[node.m_left] == nodeIndex && parents[node.m_right] == nodeIndex);
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        assert(node.m_min[axis] == std::min(nodes[node.m_left].m_min[axis], nodes[node.m_right].m_min[axis]));
+                        assert(node.m_max[axis] == std::max(nodes[node.m_left].m_max[axis], nodes[node.m_right].m_max[axis]));
+                    };
+                };
+            };
+            assert(std::all_of(numLeavesOfPrimitive.begin(), numLeavesOfPrimitive.end(),
+                               [](uint32_t t_numLeaves) { return t_numLeaves == 1; }));
+        };
+
+        /// Checks the queries of a tree find the same primitives as the batch functions and brute force.
+        template<typename TNextFloat>
+        void checkQueries(const LinearBvh& t_bvh, const AabbSoa& t_aabbs, TNextFloat& t_nextFloat){
+            const std::size_t numPrimitives = t_aabbs.size();
+            auto toSet = [](const std::vector<uint8_t>& t_isFound) {
+                std::set<std::size_t> found;
+                for (std::size_t index = 0; index < t_isFound.size(); index++) {
+                    if (t_isFound[index] == 1) {
+                        found.insert(index);
+                    };
+                };
+                return found;
+            };
+
+            const float near = 1.0f;
+            const float far = 80.0f;
+            const float projection[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+                                          0.0f, 1.0f, 0.0f, 0.0f,
+                                          0.0f, 0.0f, far / (near - far), -1.0f,
+                                          0.0f, 0.0f, -(far * near) / (far - near), 0.0f};
+            Frustum frustum = Frustum::fromViewProjection(projection);
+            std::vector<uint8_t> isFound;
+            cullAabbs(frustum, t_aabbs, isFound);
+            std::set<std::size_t> found;
+            t_bvh.queryFrustum(frustum, [&found](uint32_t t_primitive) { assert(found.insert(t_primitive).second); });
+            assert(found == toSet(isFound));
+
+            for (int query = 0; query < 10; query++) {
+                std::array<float, 3> center{t_nextFloat(-60.0f, 60.0f), t_nextFloat(-60.0f, 60.0f), t_nextFloat(-60.0f, 60.0f)};
+                float radius = t_nextFloat(1.0f, 20.0f);
+                overlapSphereAabbs(center, radius, t_aabbs, isFound);
+                found.clear();
+                t_bvh.querySphere(center, radius, [&found](uint32_t t_primitive) { assert(found.insert(t_primitive).second); });
+                assert(found == toSet(isFound));
+
+                std::array<float, 3> boxMin{center[0] - radius, center[1] - radius, center[2] - radius};
+                std::array<float, 3> boxMax{center[0] + radius, center[1], center[2] + radius * 0.5f};
+                found.clear();
+                t_bvh.queryAabb(boxMin, boxMax, [&found](uint32_t t_primitive) { assert(found.insert(t_primitive).second); });
+                std::set<std::size_t> expected;
+                for (std::size_t primitive = 0; primitive < numPrimitives; primitive++) {
+                    bool isOverlapping = true;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        isOverlapping = isOverlapping && t_aabbs.m_min[axis][primitive] <= boxMax[axis] &&
+                                        t_aabbs.m_max[axis][primitive] >= boxMin[axis];
+                    };
+                    if (isOverlapping) {
+                        expected.insert(primitive);
+                    };
+                };
+                assert(found == expected);
+
+                Ray ray{center, {t_nextFloat(-1.0f, 1.0f), t_nextFloat(-1.0f, 1.0f), t_nextFloat(-1.0f, 1.0f)}};
+                if (query == 0) {
+                    ray.m_direction = {0.0f, 0.0f, -1.0f};
+                };
+                std::vector<float> hitDistances;
+                std::size_t expectedHit = raycastAabbs(ray, 150.0f, t_aabbs, hitDistances);
+                float hitDistance = 0.0f;
+                assert(t_bvh.raycast(ray, 150.0f, &hitDistance) == expectedHit);
+                assert(expectedHit == NO_HIT || std::memcmp(&hitDistance, &hitDistances[expectedHit], sizeof(float)) == 0);
+            };
+
+            // Every overlapping pair once, from one thread and from several.
+            std::set<std::pair<std::size_t, std::size_t>> expectedPairs;
+            for (std::size_t first = 0; first < numPrimitives; first++) {
+                for (std::size_t second = first + 1; second < numPrimitives; second++) {
+                    bool isOverlapping = true;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        isOverlapping = isOverlapping && t_aabbs.m_min[axis][first] <= t_aabbs.m_max[axis][second] &&
+                                        t_aabbs.m_max[axis][first] >= t_aabbs.m_min[axis][second];
+                    };
+                    if (isOverlapping) {
+                        expectedPairs.insert({first, second});
+                    };
+                };
+            };
+            std::set<std::pair<std::size_t, std::size_t>> pairs;
+            t_bvh.findOverlappingPairs([&pairs](uint32_t t_first, uint32_t t_second) {
+                assert(pairs.insert({std::min(t_first, t_second), std::max(t_first, t_second)}).second);
+            });
+            assert(pairs == expectedPairs);
+
+            AeThreadPool threadPool{4};
+            std::mutex pairsMutex;
+            pairs.clear();
+            t_bvh.parallelFindOverlappingPairs(threadPool, [&](uint32_t t_first, uint32_t t_second) {
+                std::lock_guard<std::mutex> lock{pairsMutex};
+                assert(pairs.insert({std::min(t_first, t_second), std::max(t_first, t_second)}).second);
+            });
+            assert(pairs == expectedPairs);
+        };
+    }
+
+    void test_linear_bvh(){
+        using namespace test_linear_bvh_detail;
+
+        // The codes interleave the bits of the coordinates with x the most significant.
+        assert(mortonCode30(0.0f, 0.0f, 0.0f) == 0 && mortonCode30(1.0f, 1.0f, 1.0f) == 0x3fffffffu);
+        assert(mortonCode30(1.0f, 0.0f, 0.0f) == 0x24924924u && mortonCode30(0.0f, 0.0f, 1.0f) == 0x09249249u);
+        assert(mortonCode63(1.0f, 1.0f, 1.0f) == 0x7fffffffffffffffull && mortonCode63(0.0f, 1.0f, 0.0f) == 0x2492492492492492ull);
+        assert(mortonCode30(-5.0f, 2.0f, 0.0f) == mortonCode30(0.0f, 1.0f, 0.0f));
+        for (uint32_t value = 0; value < 1024; value += 37) {
+            uint32_t expected = 0;
+            for (uint32_t bit = 0; bit < 10; bit++) {
+                expected |= ((value >> bit) & 1u) << (3 * bit);
+            };
+            assert(expandMortonBits10(value) == expected);
+            assert(expandMortonBits21(uint64_t{value} << 11) == uint64_t{expected} << 33);
+        };
+
+        uint64_t random = 88172645463325252ull;
+        auto nextFloat = [&random](float t_min, float t_max) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            return t_min + (t_max - t_min) * static_cast<float>(random >> 40) / static_cast<float>(1 << 24);
+        };
+
+        AeThreadPool threadPool{4};
+        for (std::size_t numPrimitives: {std::size_t{0}, std::size_t{1}, std::size_t{2}, std::size_t{3}, std::size_t{700}, std::size_t{20000}}) {
+            for (MortonCodeBits mortonCodeBits: {mortonCodeBits_30, mortonCodeBits_63}) {
+                // A quarter of the boxes share a centre with another box, so many codes are the same.
+                AabbSoa aabbs{};
+                aabbs.resize(numPrimitives);
+                for (std::size_t primitive = 0; primitive < numPrimitives; primitive++) {
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        float center = primitive % 4 == 3 ? (aabbs.m_min[axis][primitive - 1] + aabbs.m_max[axis][primitive - 1]) * 0.5f :
+                                                            nextFloat(-60.0f, 60.0f);
+                        float halfSize = nextFloat(0.1f, 3.0f);
+                        aabbs.m_min[axis][primitive] = center - halfSize;
+                        aabbs.m_max[axis][primitive] = center + halfSize;
+                    };
+                };
+
+                LinearBvh bvh{};
+                bvh.build(aabbs, mortonCodeBits);
+                checkTree(bvh, aabbs);
+
+                LinearBvh parallelBvh{};
+                parallelBvh.parallelBuild(threadPool, aabbs, mortonCodeBits);
+                assert(parallelBvh.getNodes().size() == bvh.getNodes().size());
+                assert(parallelBvh.getNodes().empty() || std::memcmp(parallelBvh.getNodes().data(), bvh.getNodes().data(),
+                                                                     bvh.getNodes().size() * sizeof(BvhNode)) == 0);
+                if (numPrimitives <= 700) {
+                    checkQueries(bvh, aabbs, nextFloat);
+                };
+
+                // The boxes move and grow, the refit tree has the same shape around the new boxes.
+                for (std::size_t primitive = 0; primitive < numPrimitives; primitive++) {
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        float offset = nextFloat(-10.0f, 10.0f);
+                        aabbs.m_min[axis][primitive] += offset - 0.5f;
+                        aabbs.m_max[axis][primitive] += offset;
+                    };
+                };
+                bvh.refit(aabbs);
+                checkTree(bvh, aabbs);
+                parallelBvh.parallelRefit(threadPool, aabbs);
+                assert(parallelBvh.getNodes().empty() || std::memcmp(parallelBvh.getNodes().data(), bvh.getNodes().data(),
+                                                                     bvh.getNodes().size() * sizeof(BvhNode)) == 0);
+                if (numPrimitives <= 700) {
+                    checkQueries(bvh, aabbs, nextFloat);
+                };
+            };
+        };
+    };
+
+} // namespace ae
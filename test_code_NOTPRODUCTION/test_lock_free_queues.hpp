@@ -0,0 +1,219 @@
+/// \file test_lock_free_queues.hpp
+/// The stress tests of the lock free ring buffer, queue and work stealing deque are defined. Run them under
+/// -fsanitize=thread as well as normally, a data race will not always show up as a wrong result.
+#pragma once
+
+// dependencies
+#include "ae_tlsf_allocator.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "mpmc_queue.hpp"
+#include "work_stealing_deque.hpp"
+
+// libraries
+
+// std
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ae {
+
+    void test_spsc_ring_buffer(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 20;
+        auto preAllocatedMemory = std::make_unique<unsigned char[]>(preAllocatedSize);
+        ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize, preAllocatedMemory.get()};
+
+        // Elements that own memory are constructed and destroyed in place, including those left in the buffer.
+        {
+            SpscRingBuffer<std::string> ringBuffer{3, &tlsfAllocator};
+            assert(ringBuffer.capacity() == 4);
+            std::string value;
+            assert(!ringBuffer.tryPop(value));
+            for (int i = 0; i < 4; i++) {
+                assert(ringBuffer.tryPush("a string long enough to be on the heap " + std::to_string(i)));
+            };
+            assert(!ringBuffer.tryPush(std::string{"full"}));
+            assert(ringBuffer.tryPop(value) && value == "a string long enough to be on the heap 0");
+            assert(ringBuffer.tryEmplace(8, 'x'));
+            assert(ringBuffer.sizeApprox() == 4);
+        }
+
+        // The consumer sees every element the producer pushed, in order, while the indices wrap many times.
+        {
+            constexpr std::uint64_t numElements = 1000000;
+            SpscRingBuffer<std::uint64_t> ringBuffer{64, &tlsfAllocator};
+            std::thread producer{[&](){
+                for (std::uint64_t i = 0; i < numElements; i++) {
+                    while (!ringBuffer.tryPush(i)) {
+                        std::this_thread::yield();
+                    };
+                };
+            }};
+
+            std::uint64_t expected = 0;
+            while (expected < numElements) {
+                std::uint64_t value = 0;
+                if (ringBuffer.tryPop(value)) {
+                    assert(value == expected);
+                    expected++;
+                } else {
+                    std::this_thread::yield();
+                };
+            };
+            producer.join();
+            assert(ringBuffer.sizeApprox() == 0);
+        }
+
+        assert(tlsfAllocator.getMemoryInUse() == 0);
+    };
+
+    void test_mpmc_queue(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 20;
+        auto preAllocatedMemory = std::make_unique<unsigned char[]>(preAllocatedSize);
+        ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize, preAllocatedMemory.get()};
+
+        {
+            MpmcQueue<std::string> queue{1, &tlsfAllocator};
+            assert(queue.capacity() == 2);
+            assert(queue.tryPush(std::string{"a string long enough to be on the heap"}));
+            assert(queue.tryEmplace(3, 'y'));
+            assert(!queue.tryPush(std::string{"full"}));
+            std::string value;
+            assert(queue.tryPop(value) && value == "a string long enough to be on the heap");
+        }
+
+        // Every element is popped exactly once, and each consumer sees each producer's elements in the order they
+        // were pushed. The small capacity keeps the queue full or empty most of the time.
+        {
+            constexpr std::size_t numProducers = 4;
+            constexpr std::size_t numConsumers = 4;
+            constexpr std::uint64_t numElementsPerProducer = 200000;
+            MpmcQueue<std::uint64_t> queue{16, &tlsfAllocator};
+            std::vector<std::atomic<std::uint8_t>> timesPopped(numProducers * numElementsPerProducer);
+            std::atomic<std::uint64_t> numPopped{0};
+
+            std::vector<std::thread> threads;
+            for (std::size_t p = 0; p < numProducers; p++) {
+                threads.emplace_back([&, p](){
+                    for (std::uint64_t i = 0; i < numElementsPerProducer; i++) {
+                        while (!queue.tryPush(p * numElementsPerProducer + i)) {
+                            std::this_thread::yield();
+                        };
+                    };
+                });
+            };
+            for (std::size_t c = 0; c < numConsumers; c++) {
+                threads.emplace_back([&](){
+                    std::vector<std::uint64_t> lastSeen(numProducers, 0);
+                    std::vector<bool> isSeen(numProducers, false);
+                    while (numPopped.load() < numProducers * numElementsPerProducer) {
+                        std::uint64_t value = 0;
+                        if (!queue.tryPop(value)) {
+                            std::this_thread::yield();
+                            continue;
+                        };
+                        std::size_t producer = value / numElementsPerProducer;
+                        assert(!isSeen[producer] || value > lastSeen[producer]);
+                        isSeen[producer] = true;
+                        lastSeen[producer] = value;
+                        timesPopped[value].fetch_add(1);
+                        numPopped.fetch_add(1);
+                    };
+                });
+            };
+            for (auto& thread: threads) {
+                thread.join();
+            };
+
+            for (auto& count: timesPopped) {
+                assert(count.load() == 1);
+            };
+            assert(queue.sizeApprox() == 0);
+        }
+
+        assert(tlsfAllocator.getMemoryInUse() == 0);
+    };
+
+    void test_work_stealing_deque(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 22;
+        auto preAllocatedMemory = std::make_unique<unsigned char[]>(preAllocatedSize);
+        ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize, preAllocatedMemory.get()};
+
+        // The owner pops last in first out and thieves steal first in first out, across a growth of the deque.
+        {
+            WorkStealingDeque<int> deque{2, &tlsfAllocator};
+            for (int i = 0; i < 5; i++) {
+                deque.push(i);
+            };
+            assert(deque.capacity() == 8);
+            int value = -1;
+            assert(deque.steal(value) && value == 0);
+            assert(deque.pop(value) && value == 4);
+            assert(deque.pop(value) && value == 3);
+            assert(deque.steal(value) && value == 1);
+            assert(deque.pop(value) && value == 2);
+            assert(!deque.pop(value) && !deque.steal(value));
+            assert(deque.emptyApprox());
+        }
+
+        // The owner keeps pushing, growing the deque from a tiny start, and popping while thieves steal. Every element
+        // is taken exactly once, including the last elements the owner and thieves race for.
+        {
+            constexpr std::size_t numThieves = 3;
+            constexpr std::uint32_t numElements = 500000;
+            WorkStealingDeque<std::uint32_t> deque{4, &tlsfAllocator};
+            std::vector<std::atomic<std::uint8_t>> timesTaken(numElements);
+            std::atomic<std::uint32_t> numTaken{0};
+
+            std::vector<std::thread> thieves;
+            for (std::size_t t = 0; t < numThieves; t++) {
+                thieves.emplace_back([&](){
+                    while (numTaken.load() < numElements) {
+                        std::uint32_t value = 0;
+                        if (deque.steal(value)) {
+                            timesTaken[value].fetch_add(1);
+                            numTaken.fetch_add(1);
+                        } else {
+                            std::this_thread::yield();
+                        };
+                    };
+                });
+            };
+
+            for (std::uint32_t i = 0; i < numElements; i++) {
+                deque.push(i);
+
+                // Pop a third of the time so the deque both grows and often holds only a few elements.
+                std::uint32_t value = 0;
+                if (i % 3 == 0 && deque.pop(value)) {
+                    timesTaken[value].fetch_add(1);
+                    numTaken.fetch_add(1);
+                };
+            };
+            std::uint32_t value = 0;
+            while (numTaken.load() < numElements) {
+                if (deque.pop(value)) {
+                    timesTaken[value].fetch_add(1);
+                    numTaken.fetch_add(1);
+                };
+            };
+            for (auto& thief: thieves) {
+                thief.join();
+            };
+
+            for (auto& count: timesTaken) {
+                assert(count.load() == 1);
+            };
+        }
+
+        assert(tlsfAllocator.getMemoryInUse() == 0);
+    };
+
+} // namespace ae
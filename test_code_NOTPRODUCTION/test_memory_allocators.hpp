@@ -9,13 +9,28 @@
 #include "ae_allocator_stl_adapter.hpp"
 #include "ae_pool_allocator.hpp"
 #include "ae_free_linked_list_allocator.hpp"
+#include "ae_tlsf_allocator.hpp"
+#include "ae_thread_caching_allocator.hpp"
+#include "ae_slab_allocator.hpp"
+#include "ae_virtual_memory_arena.hpp"
+#include "ae_memory_manager.hpp"
+#include "ae_allocation_tracker.hpp"
 #include "stl_wrappers.hpp"
 
 // libraries
 
 // std
+#include <algorithm>
+#include <atomic>
 #include <vector>
+#include <string>
+#include <map>
 #include <cmath>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <thread>
 
 namespace ae {
 
@@ -321,4 +336,686 @@ namespace ae {
         preAllocatedMemoryPtr = nullptr;
     };
 
+    void test_tlsf_allocator(){
+        // In bytes.
+        std::size_t preAllocatedSize = 4096;
+        void* preAllocatedMemoryPtr = malloc(preAllocatedSize);
+
+        // Create a test structure to allocate blocks for.
+        struct testStruct{
+            int x = 5;
+            float y = 5.0f;
+        };
+
+        auto* testTlsfAllocator = new ae_memory::AeTlsfAllocator(preAllocatedSize,preAllocatedMemoryPtr);
+        std::size_t largestFreeBlock = testTlsfAllocator->getLargestFreeBlock();
+
+        void* test_allocationA = testTlsfAllocator->allocate(sizeof(testStruct),ae_memory::MEMORY_ALIGNMENT);
+        void* test_allocationB = testTlsfAllocator->allocate(100,ae_memory::MEMORY_ALIGNMENT);
+        void* test_allocationC = testTlsfAllocator->allocate(sizeof(testStruct),256);
+        void* test_allocationD = testTlsfAllocator->allocate(sizeof(testStruct),ae_memory::MEMORY_ALIGNMENT);
+
+        // The over aligned allocation must be aligned.
+        assert(reinterpret_cast<std::uintptr_t>(test_allocationC) % 256 == 0);
+
+        // Freeing neighbouring blocks must merge them so an allocation bigger than either block fits where they were.
+        testTlsfAllocator->deallocate(test_allocationB);
+        testTlsfAllocator->deallocate(test_allocationA);
+        void* test_allocationE = testTlsfAllocator->allocate(130,ae_memory::MEMORY_ALIGNMENT);
+        assert(test_allocationE == test_allocationA);
+
+        // This should fail due to the lack of memory available.
+        bool allocationFailed = false;
+        try {
+            testTlsfAllocator->allocate(preAllocatedSize,ae_memory::MEMORY_ALIGNMENT);
+        } catch (std::bad_alloc&) {
+            allocationFailed = true;
+        };
+        assert(allocationFailed);
+
+        // Once everything is freed the memory should be back to a single block.
+        testTlsfAllocator->deallocate(test_allocationC);
+        testTlsfAllocator->deallocate(test_allocationD);
+        testTlsfAllocator->deallocate(test_allocationE);
+        assert(testTlsfAllocator->getMemoryInUse() == 0);
+        assert(testTlsfAllocator->getNumFreeBlocks() == 1);
+        assert(testTlsfAllocator->getLargestFreeBlock() == largestFreeBlock);
+
+        // The allocator should work with the stl containers.
+        {
+            std::vector<int, ae_memory::AeAllocatorStlAdaptor<int,ae_memory::AeTlsfAllocator>> myVector(*testTlsfAllocator);
+            for (int i = 0; i < 100; i++) {
+                myVector.push_back(i);
+            };
+        }
+        assert(testTlsfAllocator->getMemoryInUse() == 0);
+
+        delete(testTlsfAllocator);
+        testTlsfAllocator = nullptr;
+
+        free(preAllocatedMemoryPtr);
+        preAllocatedMemoryPtr = nullptr;
+    };
+
+    void test_thread_caching_allocator(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 22;
+        void* preAllocatedMemoryPtr = malloc(preAllocatedSize);
+
+        {
+            ae_memory::AeThreadCachingAllocator threadCachingAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+
+            // Allocations must be aligned even when the alignment is larger than the size.
+            void* test_allocationA = threadCachingAllocator.allocate(8,64);
+            void* test_allocationB = threadCachingAllocator.allocate(4096,ae_memory::MEMORY_ALIGNMENT);
+            assert(reinterpret_cast<std::uintptr_t>(test_allocationA) % 64 == 0);
+            threadCachingAllocator.deallocate(test_allocationA);
+            threadCachingAllocator.deallocate(test_allocationB);
+
+            // Each thread allocates blocks of every size class, writes its own pattern into them, and frees half of
+            // them while passing the other half to the next thread to free so blocks are freed by other threads.
+            constexpr std::size_t numThreads = 4;
+            constexpr std::size_t numAllocations = 20000;
+            std::vector<std::vector<void*>> handedOffAllocations(numThreads);
+            std::vector<std::thread> threads;
+            for (std::size_t t = 0; t < numThreads; t++) {
+                threads.emplace_back([&, t](){
+                    std::mt19937 randomGenerator{static_cast<unsigned int>(t)};
+                    std::uniform_int_distribution<std::size_t> sizeDistribution{1,2048};
+                    std::vector<std::pair<unsigned char*, std::size_t>> liveAllocations;
+                    for (std::size_t i = 0; i < numAllocations; i++) {
+                        std::size_t allocationSize = sizeDistribution(randomGenerator);
+                        auto* allocation = static_cast<unsigned char*>(
+                                threadCachingAllocator.allocate(allocationSize,ae_memory::MEMORY_ALIGNMENT));
+                        std::fill(allocation, allocation + allocationSize, static_cast<unsigned char>(t));
+                        liveAllocations.emplace_back(allocation, allocationSize);
+
+                        if (liveAllocations.size() == 64) {
+                            for (auto& [liveAllocation, liveAllocationSize]: liveAllocations) {
+                                assert(std::all_of(liveAllocation, liveAllocation + liveAllocationSize,
+                                                   [t](unsigned char x){ return x == t; }));
+                            };
+                            for (std::size_t j = 0; j < 32; j++) {
+                                threadCachingAllocator.deallocate(liveAllocations[j].first);
+                            };
+                            liveAllocations.erase(liveAllocations.begin(), liveAllocations.begin() + 32);
+                        };
+                    };
+                    for (auto& liveAllocation: liveAllocations) {
+                        handedOffAllocations[t].push_back(liveAllocation.first);
+                    };
+                });
+            };
+            for (auto& thread: threads) {
+                thread.join();
+            };
+            threads.clear();
+
+            // Only the main thread still has a cache, the caches of the exited threads were given back.
+            assert(threadCachingAllocator.getNumThreadCaches() == 1);
+
+            for (std::size_t t = 0; t < numThreads; t++) {
+                threads.emplace_back([&, t](){
+                    for (void* allocation: handedOffAllocations[(t + 1) % numThreads]) {
+                        threadCachingAllocator.deallocate(allocation);
+                    };
+                });
+            };
+            for (auto& thread: threads) {
+                thread.join();
+            };
+
+            // The blocks cached by the exited threads were returned to the shared pools without flushing.
+            threadCachingAllocator.flushThreadCache();
+            assert(threadCachingAllocator.getMemoryInUse() == 0);
+
+            // Far more threads than there are caches each get a cache while they run.
+            for (std::size_t t = 0; t < 4 * ae_memory::AeThreadCachingAllocator::MAX_THREAD_CACHES; t++) {
+                std::thread thread{[&](){
+                    threadCachingAllocator.deallocate(threadCachingAllocator.allocate(16,16));
+                    assert(threadCachingAllocator.getNumThreadCaches() == 2);
+                }};
+                thread.join();
+            };
+            assert(threadCachingAllocator.getNumThreadCaches() == 1);
+        }
+
+        // A thread that has used far more allocators than it has bindings for still gets a cache from a new one, as
+        // the bindings of destroyed allocators are reused.
+        for (std::size_t i = 0; i < 4 * ae_memory::AeThreadCachingAllocator::MAX_THREAD_CACHE_BINDINGS; i++) {
+            ae_memory::AeThreadCachingAllocator threadCachingAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+            threadCachingAllocator.deallocate(threadCachingAllocator.allocate(16,16));
+            assert(threadCachingAllocator.getNumThreadCaches() == 1);
+        };
+
+        free(preAllocatedMemoryPtr);
+        preAllocatedMemoryPtr = nullptr;
+    };
+
+    void test_slab_allocator(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 20;
+        void* preAllocatedMemoryPtr = malloc(preAllocatedSize);
+        std::size_t fallbackAllocatedSize = 1 << 16;
+        void* fallbackAllocatedMemoryPtr = malloc(fallbackAllocatedSize);
+
+        {
+            ae_memory::AeTlsfAllocator fallbackAllocator{fallbackAllocatedSize,fallbackAllocatedMemoryPtr};
+            ae_memory::AeSlabAllocator slabAllocator{preAllocatedSize,preAllocatedMemoryPtr,&fallbackAllocator,4096};
+
+            // Objects of the same size class should be packed next to each other in the same page.
+            void* test_allocationA = slabAllocator.allocate(40,ae_memory::MEMORY_ALIGNMENT);
+            void* test_allocationB = slabAllocator.allocate(48,ae_memory::MEMORY_ALIGNMENT);
+            assert(ae_memory::AeAllocatorBase::pointerDifference(test_allocationB,test_allocationA) == 48);
+            assert(slabAllocator.getStatistics().m_numPagesInUse == 1);
+
+            // An over aligned allocation goes to a size class with a large enough alignment.
+            void* test_allocationC = slabAllocator.allocate(40,64);
+            assert(reinterpret_cast<std::uintptr_t>(test_allocationC) % 64 == 0);
+            assert(slabAllocator.getStatistics().m_numPagesInUse == 2);
+
+            // Allocations too large for the size classes go to the fallback allocator.
+            void* test_allocationD = slabAllocator.allocate(2048,ae_memory::MEMORY_ALIGNMENT);
+            assert(fallbackAllocator.getMemoryInUse() > 0);
+            slabAllocator.deallocate(test_allocationD);
+            assert(fallbackAllocator.getMemoryInUse() == 0);
+
+            slabAllocator.deallocate(test_allocationA);
+            slabAllocator.deallocate(test_allocationB);
+            slabAllocator.deallocate(test_allocationC);
+            assert(slabAllocator.getMemoryInUse() == 0);
+
+            // Filling and emptying several pages of one size class should release the empty pages for another size
+            // class to reuse.
+            std::vector<void*> allocations;
+            for (int i = 0; i < 1000; i++) {
+                allocations.push_back(slabAllocator.allocate(16,ae_memory::MEMORY_ALIGNMENT));
+            };
+            std::size_t numPagesInUse = slabAllocator.getStatistics().m_numPagesInUse;
+            for (void* allocation: allocations) {
+                slabAllocator.deallocate(allocation);
+            };
+            assert(slabAllocator.getStatistics().m_numPagesInUse < numPagesInUse);
+            allocations.clear();
+            for (int i = 0; i < 100; i++) {
+                allocations.push_back(slabAllocator.allocate(256,ae_memory::MEMORY_ALIGNMENT));
+            };
+            assert(slabAllocator.getStatistics().m_numPageReuses > 0);
+            for (void* allocation: allocations) {
+                slabAllocator.deallocate(allocation);
+            };
+
+            // The allocator should work with the node based stl containers.
+            {
+                std::map<int, int, std::less<>, ae_memory::AeAllocatorStlAdaptor<std::pair<const int, int>,
+                        ae_memory::AeSlabAllocator>> myMap(slabAllocator);
+                for (int i = 0; i < 1000; i++) {
+                    myMap[i] = i;
+                };
+                ae::unordered_map<int, int, ae_memory::AeSlabAllocator> myUnorderedMap(16, slabAllocator);
+                for (int i = 0; i < 1000; i++) {
+                    myUnorderedMap[i] = i;
+                };
+            }
+            assert(slabAllocator.getMemoryInUse() == 0);
+            assert(fallbackAllocator.getMemoryInUse() == 0);
+        }
+
+        free(fallbackAllocatedMemoryPtr);
+        fallbackAllocatedMemoryPtr = nullptr;
+        free(preAllocatedMemoryPtr);
+        preAllocatedMemoryPtr = nullptr;
+    };
+
+    /// Replaces random allocations of a map node's size, keeping a fixed number live like a node based container with
+    /// a steady number of elements, and prints the average time of each allocation and deallocation pair.
+    template<class Alloc>
+    void benchmark_node_churn(const char* t_allocatorName, Alloc&& t_allocate){
+        constexpr std::size_t numOperations = 1000000;
+        constexpr std::size_t numLiveNodes = 10000;
+        constexpr std::size_t nodeSize = 48;
+
+        std::mt19937 randomGenerator{12345};
+        std::vector<void*> liveNodes;
+        for (std::size_t i = 0; i < numLiveNodes; i++) {
+            liveNodes.push_back(t_allocate(nodeSize));
+        };
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < numOperations; i++) {
+            std::size_t index = randomGenerator() % numLiveNodes;
+            t_allocate(liveNodes[index]);
+            liveNodes[index] = t_allocate(nodeSize);
+        };
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        for (void* node: liveNodes) {
+            t_allocate(node);
+        };
+
+        std::cout << t_allocatorName << ": " << std::chrono::duration<double, std::nano>(endTime - startTime).count() /
+                                                 static_cast<double>(numOperations) << " ns/op" << std::endl;
+    };
+
+    void benchmark_slab_allocator_node_churn(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 24;
+        void* preAllocatedMemoryPtr = malloc(preAllocatedSize);
+
+        // Each benchmark is given a callable that allocates when passed a size and deallocates when passed a pointer.
+        struct MallocFree{
+            void* operator()(std::size_t t_size) const { return malloc(t_size); };
+            void* operator()(void* t_ptr) const { free(t_ptr); return nullptr; };
+        };
+        benchmark_node_churn("malloc", MallocFree{});
+
+        {
+            ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+            struct TlsfAllocateDeallocate{
+                ae_memory::AeTlsfAllocator& m_allocator;
+                void* operator()(std::size_t t_size) const {
+                    return m_allocator.allocate(t_size, ae_memory::MEMORY_ALIGNMENT);
+                };
+                void* operator()(void* t_ptr) const { m_allocator.deallocate(t_ptr); return nullptr; };
+            };
+            benchmark_node_churn("AeTlsfAllocator", TlsfAllocateDeallocate{tlsfAllocator});
+        }
+
+        {
+            ae_memory::AeSlabAllocator slabAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+            struct SlabAllocateDeallocate{
+                ae_memory::AeSlabAllocator& m_allocator;
+                void* operator()(std::size_t t_size) const {
+                    return m_allocator.allocate(t_size, ae_memory::MEMORY_ALIGNMENT);
+                };
+                void* operator()(void* t_ptr) const { m_allocator.deallocate(t_ptr); return nullptr; };
+            };
+            benchmark_node_churn("AeSlabAllocator", SlabAllocateDeallocate{slabAllocator});
+            std::cout << "AeSlabAllocator pages acquired " << slabAllocator.getStatistics().m_numPageAcquisitions
+                      << ", reused " << slabAllocator.getStatistics().m_numPageReuses << std::endl;
+        }
+
+        free(preAllocatedMemoryPtr);
+        preAllocatedMemoryPtr = nullptr;
+    };
+
+    void test_virtual_memory_arena(){
+        // Reserving far more than will be used should not commit any of it.
+        ae_memory::AeVirtualMemoryArena arena{std::size_t{16} << 30};
+        assert(arena.getCommittedSize() == 0);
+
+        {
+            ae_memory::AeDeStackAllocator deStackAllocator{arena};
+
+            // Only the memory each end of the stack grows into should be committed.
+            std::size_t allocationSize = 10 * arena.getCommitGranularity();
+            auto* test_allocationA = static_cast<char*>(deStackAllocator.allocateFromBottom(allocationSize));
+            auto* test_allocationB = static_cast<char*>(deStackAllocator.allocateFromTop(allocationSize));
+            std::fill(test_allocationA, test_allocationA + allocationSize, 1);
+            std::fill(test_allocationB, test_allocationB + allocationSize, 2);
+            assert(arena.getCommittedSize() >= 2 * allocationSize);
+            assert(arena.getCommittedSize() <= 2 * allocationSize + 4 * arena.getCommitGranularity());
+
+            // Memory freed from the stack should only be decommitted when asked to, and the memory still in use must
+            // keep its contents.
+            auto bottomMarker = deStackAllocator.getBottomStackMarker();
+            deStackAllocator.allocateFromBottom(allocationSize);
+            std::size_t committedSize = arena.getCommittedSize();
+            deStackAllocator.deallocateToBottomMarker(bottomMarker);
+            assert(arena.getCommittedSize() == committedSize);
+            deStackAllocator.decommitUnusedMemory();
+            assert(arena.getCommittedSize() < committedSize);
+            assert(test_allocationA[allocationSize - 1] == 1 && test_allocationB[0] == 2);
+
+            deStackAllocator.clearDoubleEndedStack();
+        }
+
+        arena.reset();
+        assert(arena.getCommittedSize() == 0);
+
+        // A stack allocator should be able to reuse the arena once it is reset.
+        {
+            ae_memory::AeStackAllocator stackAllocator{arena};
+            stackAllocator.allocate(arena.getCommitGranularity() + 1, ae_memory::MEMORY_ALIGNMENT);
+            assert(arena.getCommittedSize() == 2 * arena.getCommitGranularity());
+            stackAllocator.clearStack();
+            stackAllocator.decommitUnusedMemory();
+            assert(arena.getCommittedSize() == 0);
+        }
+    };
+
+    void test_memory_manager(){
+        ae_memory::AeMemoryManager memoryManager{std::size_t{4} << 20};
+
+        ae_memory::AeMemoryBudget& ecsBudget = memoryManager.createGroup("ecs",
+                                                                         ae_memory::memoryTag_ecs,
+                                                                         std::size_t{256} << 10,
+                                                                         memoryManager.getRoot());
+        ae_memory::AeMemoryBudget& generalAllocator =
+                memoryManager.createAllocator<ae_memory::AeTlsfAllocator>("general",
+                                                                          ae_memory::memoryTag_general,
+                                                                          std::size_t{1} << 20,
+                                                                          0,
+                                                                          memoryManager.getRoot());
+        ae_memory::AeMemoryBudget& slabAllocator =
+                memoryManager.createAllocator<ae_memory::AeSlabAllocator>("ecs small objects",
+                                                                          ae_memory::memoryTag_ecs,
+                                                                          std::size_t{1} << 20,
+                                                                          0,
+                                                                          ecsBudget,
+                                                                          &generalAllocator);
+
+        // Allocations should be counted in their budget, every group above it, and their tag.
+        void* test_allocationA = slabAllocator.allocate(40, ae_memory::MEMORY_ALIGNMENT);
+        assert(slabAllocator.getMemoryInUse() == 48);
+        assert(ecsBudget.getMemoryInUse() == 48);
+        assert(memoryManager.getRoot().getMemoryInUse() == 48);
+        assert(memoryManager.getMemoryInUse(ae_memory::memoryTag_ecs) == 48);
+
+        // Allocations the slab allocator passes on to its fallback should be counted in the fallback's budget.
+        void* test_allocationB = slabAllocator.allocate(4096, ae_memory::MEMORY_ALIGNMENT);
+        assert(slabAllocator.getMemoryInUse() == 48);
+        assert(memoryManager.getMemoryInUse(ae_memory::memoryTag_general) >= 4096);
+
+        // Exceeding the budget of the group should be recorded once, until the group is back within its budget.
+        std::vector<void*> test_allocations;
+        while (ecsBudget.getMemoryInUse() <= (std::size_t{256} << 10)) {
+            test_allocations.push_back(slabAllocator.allocate(1024, ae_memory::MEMORY_ALIGNMENT));
+        };
+        test_allocations.push_back(slabAllocator.allocate(1024, ae_memory::MEMORY_ALIGNMENT));
+        assert(ecsBudget.getStats().m_numOverruns == 1);
+        for (void* allocation: test_allocations) {
+            slabAllocator.deallocate(allocation);
+        };
+        assert(ecsBudget.getMemoryInUse() == 48);
+        assert(ecsBudget.getStats().m_highWaterMark > (std::size_t{256} << 10));
+
+        slabAllocator.deallocate(test_allocationB);
+        slabAllocator.deallocate(test_allocationA);
+        assert(memoryManager.getRoot().getMemoryInUse() == 0);
+
+        // Allocations made directly from an allocator should be counted once the manager is updated.
+        ae_memory::AeAllocatorBase& tlsfAllocator = *generalAllocator.getAllocator();
+        void* test_allocationC = tlsfAllocator.allocate(1000, ae_memory::MEMORY_ALIGNMENT);
+        assert(generalAllocator.getMemoryInUse() == 0);
+        memoryManager.update();
+        assert(generalAllocator.getMemoryInUse() == tlsfAllocator.getMemoryInUse());
+        assert(memoryManager.getRoot().getMemoryInUse() == tlsfAllocator.getMemoryInUse());
+        tlsfAllocator.deallocate(test_allocationC);
+        memoryManager.update();
+        assert(memoryManager.getRoot().getMemoryInUse() == 0);
+
+        // The free memory of an allocator in a single block should not be fragmented.
+        assert(generalAllocator.getStats().m_fragmentation < 0.01);
+
+        // The managed memory block can not give out more memory than it has.
+        bool threwBadAlloc = false;
+        try {
+            memoryManager.createAllocator<ae_memory::AeTlsfAllocator>("too large",
+                                                                      ae_memory::memoryTag_scratch,
+                                                                      std::size_t{4} << 20,
+                                                                      0,
+                                                                      memoryManager.getRoot());
+        } catch (std::bad_alloc&) {
+            threwBadAlloc = true;
+        };
+        assert(threwBadAlloc);
+
+        std::string json = memoryManager.toJson();
+        assert(json.find("\"ecs small objects\"") != std::string::npos);
+    };
+
+    void test_stl_wrappers(){
+        std::size_t poolSize = std::size_t{1} << 20;
+        void* tlsfMemory = malloc(poolSize);
+        void* slabMemory = malloc(poolSize);
+
+        {
+            ae_memory::AeTlsfAllocator tlsfAllocator{poolSize, tlsfMemory};
+            ae_memory::AeSlabAllocator slabAllocator{poolSize, slabMemory, &tlsfAllocator};
+
+            // Each container should allocate from the allocator it was given.
+            {
+                ae::vector<int, ae_memory::AeTlsfAllocator> test_vector(tlsfAllocator);
+                ae::deque<int, ae_memory::AeTlsfAllocator> test_deque(tlsfAllocator);
+                ae::map<int, int, ae_memory::AeSlabAllocator> test_map(slabAllocator);
+                ae::unordered_set<int, ae_memory::AeSlabAllocator> test_unorderedSet(16, slabAllocator);
+                ae::string<ae_memory::AeTlsfAllocator> test_string(
+                        "a string too long to be stored within the string itself", tlsfAllocator);
+                for (int i = 0; i < 100; i++) {
+                    test_vector.push_back(i);
+                    test_deque.push_front(i);
+                    test_map[i] = i;
+                    test_unorderedSet.insert(i);
+                };
+                assert(test_vector[99] == 99 && test_deque[0] == 99 && test_map[50] == 50);
+                assert(test_unorderedSet.count(42) == 1 && test_string.size() > 32);
+                assert(slabAllocator.getMemoryInUse() > 0);
+            }
+            assert(tlsfAllocator.getMemoryInUse() == 0 && slabAllocator.getMemoryInUse() == 0);
+
+            // The pmr containers should have the same type whichever allocator is behind their memory resource.
+            ae_memory::AeMemoryResource tlsfResource{tlsfAllocator};
+            ae_memory::AeMemoryResource slabResource{slabAllocator};
+            {
+                std::vector<ae::pmr::vector<int>> test_vectors;
+                test_vectors.emplace_back(&tlsfResource);
+                test_vectors.emplace_back(&slabResource);
+                for (auto& test_vector: test_vectors) {
+                    for (int i = 0; i < 64; i++) {
+                        test_vector.push_back(i);
+                    };
+                };
+                assert(slabAllocator.getMemoryInUse() > 0);
+
+                ae::pmr::map<int, ae::pmr::string> test_map(&slabResource);
+                test_map[1] = "a string too long to be stored within the string itself";
+                assert(test_map.get_allocator().resource() == &slabResource);
+                assert(test_map[1].get_allocator().resource() == &slabResource);
+
+                ae::pmr::unordered_map<int, int> test_unorderedMap(&tlsfResource);
+                ae::pmr::unordered_set<int> test_unorderedSet(&tlsfResource);
+                ae::pmr::deque<int> test_deque(&tlsfResource);
+                test_unorderedMap[1] = 1;
+                test_unorderedSet.insert(1);
+                test_deque.push_back(1);
+            }
+            assert(tlsfAllocator.getMemoryInUse() == 0 && slabAllocator.getMemoryInUse() == 0);
+
+            // Resources over the same allocator are interchangeable, resources over different allocators are not.
+            ae_memory::AeMemoryResource otherTlsfResource{tlsfAllocator};
+            assert(tlsfResource.is_equal(otherTlsfResource));
+            assert(!tlsfResource.is_equal(slabResource));
+            assert(!tlsfResource.is_equal(*std::pmr::new_delete_resource()));
+        }
+
+        free(slabMemory);
+        free(tlsfMemory);
+    };
+
+#ifdef AE_MEMORY_TRACKING
+    void test_allocation_tracker(){
+        ae_memory::AeAllocationTracker& allocationTracker = ae_memory::AeAllocationTracker::getInstance();
+        ae_memory::AeMemoryManager memoryManager{std::size_t{1} << 20};
+        ae_memory::AeMemoryBudget& assetAllocator =
+                memoryManager.createAllocator<ae_memory::AeTlsfAllocator>("assets",
+                                                                          ae_memory::memoryTag_assets,
+                                                                          std::size_t{512} << 10,
+                                                                          0,
+                                                                          memoryManager.getRoot());
+        allocationTracker.endFrame();
+
+        // Allocations made after the marker and not freed should be reported as live, with their call site.
+        std::uint64_t marker = allocationTracker.getMarker();
+        void* test_allocationA = assetAllocator.allocate(100, 16);
+        void* test_allocationB = assetAllocator.allocate(200, ae_memory::MEMORY_ALIGNMENT);
+        assetAllocator.deallocate(test_allocationA);
+
+        std::vector<ae_memory::AeAllocationRecord> liveAllocations = allocationTracker.getLiveAllocations(marker);
+        assert(liveAllocations.size() == 1);
+        assert(liveAllocations[0].m_ptr == test_allocationB);
+        assert(liveAllocations[0].m_size == 200);
+        assert(liveAllocations[0].m_memoryTag == ae_memory::memoryTag_assets);
+        assert(!allocationTracker.getCallstack(liveAllocations[0].m_siteHash).empty());
+
+        // The frame's statistics should count both allocations, and attribute them to their call sites.
+        allocationTracker.endFrame();
+        const ae_memory::AeAllocationFrameStats& frameStats = allocationTracker.getLastFrameStats();
+        assert(frameStats.m_numAllocations == 2 && frameStats.m_bytesAllocated == 300);
+        assert(frameStats.m_numDeallocations == 1);
+        assert(frameStats.m_isComplete && !frameStats.m_topSites.empty());
+        assert(frameStats.m_topSites[0].m_bytesAllocated >= 200);
+
+        assert(allocationTracker.toJson(marker).find("\"assets\"") != std::string::npos);
+        assetAllocator.deallocate(test_allocationB);
+        assert(allocationTracker.getLiveAllocations(marker).empty());
+
+        // Far more allocations than the table holds are made and freed at addresses no allocator hands out, the slots
+        // they leave behind must not lengthen the probes of the allocations after them.
+        marker = allocationTracker.getMarker();
+        constexpr std::uintptr_t fakeAddressBase = 0x1000;
+        constexpr std::size_t numChurnedAllocations = 4 * ae_memory::AeAllocationTracker::LIVE_ALLOCATION_CAPACITY;
+        constexpr std::size_t numLiveChurnedAllocations = 1000;
+        for (std::size_t i = 0; i < numChurnedAllocations; i++) {
+            allocationTracker.recordAllocation(reinterpret_cast<void*>(fakeAddressBase + i * 16), i, 16,
+                                               ae_memory::memoryTag_general);
+            if (i >= numLiveChurnedAllocations) {
+                allocationTracker.recordDeallocation(
+                        reinterpret_cast<void*>(fakeAddressBase + (i - numLiveChurnedAllocations) * 16));
+            };
+        };
+        liveAllocations = allocationTracker.getLiveAllocations(marker);
+        assert(liveAllocations.size() == numLiveChurnedAllocations);
+        for (auto& liveAllocation: liveAllocations) {
+            assert(liveAllocation.m_ptr == reinterpret_cast<void*>(fakeAddressBase + liveAllocation.m_size * 16));
+        };
+        assert(allocationTracker.getLongestProbeLength() < 64);
+        assert(allocationTracker.getNumDroppedAllocations() == 0);
+        for (std::size_t i = numChurnedAllocations - numLiveChurnedAllocations; i < numChurnedAllocations; i++) {
+            allocationTracker.recordDeallocation(reinterpret_cast<void*>(fakeAddressBase + i * 16));
+        };
+        assert(allocationTracker.getLiveAllocations(marker).empty());
+
+        // Threads reuse a few addresses while the live allocations are read, every record read must be whole, never
+        // mixing the fields of two allocations made at the same address.
+        marker = allocationTracker.getMarker();
+        constexpr std::size_t numThreads = 4;
+        std::atomic<bool> isDone{false};
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < numThreads; t++) {
+            threads.emplace_back([&, t](){
+                std::mt19937 randomGenerator{static_cast<unsigned int>(t)};
+                for (std::size_t i = 0; i < 200000; i++) {
+                    void* address = reinterpret_cast<void*>(fakeAddressBase + (t * 8 + i % 8) * 16);
+                    std::size_t size = randomGenerator() % 4096;
+                    allocationTracker.recordAllocation(address, size, 2 * size + 1, ae_memory::memoryTag_general);
+                    allocationTracker.recordDeallocation(address);
+                };
+            });
+        };
+        std::thread readingThread{[&](){
+            while (!isDone.load()) {
+                for (auto& liveAllocation: allocationTracker.getLiveAllocations(marker)) {
+                    assert(liveAllocation.m_alignment == 2 * liveAllocation.m_size + 1);
+                };
+            };
+        }};
+        for (auto& thread: threads) {
+            thread.join();
+        };
+        isDone.store(true);
+        readingThread.join();
+        assert(allocationTracker.getLiveAllocations(marker).empty());
+    };
+#endif
+
+    /// Runs the same randomized allocation and deallocation trace against an allocator, and prints the average time
+    /// of each operation, the number of allocations that failed, and the fragmentation of the free memory at the end.
+    template<class Alloc, typename LargestFree>
+    void benchmark_allocator_trace(const char* t_allocatorName,
+                                   Alloc& t_allocator,
+                                   LargestFree t_getLargestFree,
+                                   std::size_t t_poolSize){
+        constexpr std::size_t numOperations = 20000;
+        constexpr std::size_t maxLiveAllocations = 1000;
+
+        std::mt19937 randomGenerator{12345};
+        std::uniform_int_distribution<std::size_t> sizeDistribution{8,512};
+        std::uniform_int_distribution<std::size_t> operationDistribution{0,99};
+
+        std::vector<void*> liveAllocations;
+        liveAllocations.reserve(maxLiveAllocations);
+
+        std::size_t numAllocations = 0;
+        std::size_t numFailedAllocations = 0;
+        std::size_t numDeallocations = 0;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (std::size_t i = 0; i < numOperations; i++) {
+            bool shouldAllocate = liveAllocations.empty() ||
+                                  (liveAllocations.size() < maxLiveAllocations &&
+                                   operationDistribution(randomGenerator) < 55);
+            if (shouldAllocate) {
+                // Occasionally make a large allocation to stress the fragmentation of the allocator.
+                std::size_t allocationSize = sizeDistribution(randomGenerator);
+                if (operationDistribution(randomGenerator) < 2) {
+                    allocationSize *= 16;
+                };
+
+                numAllocations++;
+                try {
+                    liveAllocations.push_back(t_allocator.allocate(allocationSize, ae_memory::MEMORY_ALIGNMENT));
+                } catch (std::bad_alloc&) {
+                    numFailedAllocations++;
+                };
+            } else {
+                std::size_t index = randomGenerator() % liveAllocations.size();
+                t_allocator.deallocate(liveAllocations[index]);
+                liveAllocations[index] = liveAllocations.back();
+                liveAllocations.pop_back();
+                numDeallocations++;
+            };
+        };
+        auto endTime = std::chrono::high_resolution_clock::now();
+
+        std::size_t freeMemory = t_poolSize - t_allocator.getMemoryInUse();
+        double fragmentation = freeMemory == 0 ? 0.0 :
+                               1.0 - static_cast<double>(t_getLargestFree()) / static_cast<double>(freeMemory);
+        double nanosecondsPerOperation = std::chrono::duration<double, std::nano>(endTime - startTime).count() /
+                                         static_cast<double>(numAllocations + numDeallocations);
+
+        std::cout << t_allocatorName << ": " << nanosecondsPerOperation << " ns/op, "
+                  << numFailedAllocations << "/" << numAllocations << " allocations failed, "
+                  << "fragmentation " << fragmentation << std::endl;
+
+        for (void* allocation: liveAllocations) {
+            t_allocator.deallocate(allocation);
+        };
+    };
+
+    void benchmark_tlsf_against_free_linked_list_allocator(){
+        // In bytes.
+        std::size_t preAllocatedSize = 1 << 20;
+        void* preAllocatedMemoryPtr = malloc(preAllocatedSize);
+
+        {
+            ae_memory::AeFreeLinkedListAllocator freeLinkedListAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+            benchmark_allocator_trace("AeFreeLinkedListAllocator",
+                                      freeLinkedListAllocator,
+                                      [&](){ return freeLinkedListAllocator.getLargestFreeChunk(); },
+                                      preAllocatedSize);
+        }
+
+        {
+            ae_memory::AeTlsfAllocator tlsfAllocator{preAllocatedSize,preAllocatedMemoryPtr};
+            benchmark_allocator_trace("AeTlsfAllocator",
+                                      tlsfAllocator,
+                                      [&](){ return tlsfAllocator.getLargestFreeBlock(); },
+                                      preAllocatedSize);
+        }
+
+        free(preAllocatedMemoryPtr);
+        preAllocatedMemoryPtr = nullptr;
+    };
+
 } // namespace ae
\ No newline at end of file
@@ -44,7 +44,7 @@ namespace ae {
         // Get the entities that use the components this system depends on. Get enabled entities since this will be a
         // system that will conditionally update their component data no matter if previous systems have acted upon
         // them.
-        std::vector<ecs_id> validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
+        ecs_entityList validEntityIds = m_systemManager.getEnabledSystemsEntities(this->getSystemId());
 
         // Loop through the valid entities and update their world position to make them rotate.
         for (ecs_id entityId : validEntityIds){
@@ -0,0 +1,297 @@
+/// \file test_simd_geometry.hpp
+/// The tests of the batch bounding volume functions are defined. OBBs are transformed by random model matrices and
+/// compared bit for bit with a line by line port of collision.comp and with their transformed corners. The culling,
+/// ray and sphere functions are checked against straightforward per box versions on random boxes. The batches have
+/// lengths that are not multiples of the SIMD widths so the scalar ends of the batches are tested too.
+#pragma once
+
+// dependencies
+#include "simd_geometry.hpp"
+
+// libraries
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace ae {
+
+    namespace test_simd_geometry_detail {
+
+        /// collision.comp for one entity, the GLSL kept as it is apart from the types.
+        /// \param t_modelMatrix The column major 4x4 model matrix.
+        /// \param t_obb The model's OBB as the minimum x, y, z then the maximum x, y, z.
+        /// \param t_aabb Set to the world AABB in the same layout.
+        void collisionShader(const float* t_modelMatrix, const float* t_obb, float* t_aabb){
+            auto modelMatrix = [t_modelMatrix](int t_column, int t_row) { return t_modelMatrix[t_column * 4 + t_row]; };
+
+            float aabb[6] = {modelMatrix(3, 0), modelMatrix(3, 1), modelMatrix(3, 2),
+                             modelMatrix(3, 0), modelMatrix(3, 1), modelMatrix(3, 2)};
+            for (int i = 0; i < 3; i++) {
+                for (int j = 0; j < 3; j++) {
+                    float e = modelMatrix(j, i) * t_obb[j];
+                    float f = modelMatrix(j, i) * t_obb[j + 3];
+                    aabb[i] += e < f ? e : f;
+                    aabb[i + 3] += e < f ? f : e;
+                };
+            };
+            std::copy(aabb, aabb + 6, t_aabb);
+        };
+
+        /// The model matrix AeModel3DBufferSystem::calculateModelMatrixData makes.
+        void makeModelMatrix(const float* t_translation, const float* t_rotation, const float* t_scale,
+                             float* t_modelMatrix){
+            const float c3 = std::cos(t_rotation[2]);
+            const float s3 = std::sin(t_rotation[2]);
+            const float c2 = std::cos(t_rotation[0]);
+            const float s2 = std::sin(t_rotation[0]);
+            const float c1 = std::cos(t_rotation[1]);
+            const float s1 = std::sin(t_rotation[1]);
+            const float rotation[9] = {c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - c3 * s1,
+                                       c3 * s1 * s2 - c1 * s3, c2 * c3, c1 * c3 * s2 + s1 * s3,
+                                       c2 * s1, -s2, c1 * c2};
+            for (int element = 0; element < 16; element++) {
+                t_modelMatrix[element] = element == 15 ? 1.0f : 0.0f;
+            };
+            for (int column = 0; column < 3; column++) {
+                for (int row = 0; row < 3; row++) {
+                    t_modelMatrix[column * 4 + row] = t_scale[column] * rotation[column * 3 + row];
+                };
+                t_modelMatrix[12 + column] = t_translation[column];
+            };
+        };
+
+        /// Checks two floats have the same bits, so NaNs compare equal and 0 differs from -0.
+        bool isSameBits(float t_a, float t_b){
+            return std::memcmp(&t_a, &t_b, sizeof(float)) == 0;
+        };
+    }
+
+    void test_simd_geometry(){
+        using namespace test_simd_geometry_detail;
+
+        uint64_t random = 88172645463325252ull;
+        auto nextFloat = [&random](float t_min, float t_max) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+            return t_min + (t_max - t_min) * static_cast<float>(random >> 40) / static_cast<float>(1 << 24);
+        };
+
+        // OBBs to AABBs match collision.comp, including rotations of exactly 0 and 90 degrees.
+        constexpr std::size_t numModels = 5;
+        constexpr std::size_t numEntities = 1003;
+        AabbSoa modelObbs{};
+        modelObbs.resize(numModels);
+        std::vector<std::array<float, 6>> obbs(numModels);
+        for (std::size_t model = 0; model < numModels; model++) {
+            for (int axis = 0; axis < 3; axis++) {
+                obbs[model][axis] = nextFloat(-3.0f, 0.0f);
+                obbs[model][axis + 3] = nextFloat(0.0f, 3.0f);
+            };
+            modelObbs.set(model, obbs[model].data());
+        };
+
+        TransformSoa transforms{};
+        transforms.resize(numEntities);
+        std::vector<uint32_t> obbIndices(numEntities);
+        std::vector<std::array<float, 16>> modelMatrices(numEntities);
+        for (std::size_t entity = 0; entity < numEntities; entity++) {
+            float translation[3] = {nextFloat(-100.0f, 100.0f), nextFloat(-100.0f, 100.0f), nextFloat(-100.0f, 100.0f)};
+            float rotation[3] = {nextFloat(-3.2f, 3.2f), nextFloat(-3.2f, 3.2f), nextFloat(-3.2f, 3.2f)};
+            float scale[3] = {nextFloat(0.1f, 4.0f), nextFloat(0.1f, 4.0f), nextFloat(0.1f, 4.0f)};
+            if (entity % 7 == 0) {
+                rotation[entity % 3] = 0.0f;
+            } else if (entity % 11 == 0) {
+                rotation[entity % 3] = 1.57079632679f;
+            };
+            makeModelMatrix(translation, rotation, scale, modelMatrices[entity].data());
+            transforms.set(entity, modelMatrices[entity].data());
+            obbIndices[entity] = static_cast<uint32_t>(entity % numModels);
+        };
+
+        AabbSoa worldAabbs{};
+        transformObbsToAabbs(transforms, obbIndices, modelObbs, worldAabbs);
+        assert(worldAabbs.size() == numEntities);
+        for (std::size_t entity = 0; entity < numEntities; entity++) {
+            float expected[6];
+            collisionShader(modelMatrices[entity].data(), obbs[obbIndices[entity]].data(), expected);
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                assert(isSameBits(worldAabbs.m_min[axis][entity], expected[axis]));
+                assert(isSameBits(worldAabbs.m_max[axis][entity], expected[axis + 3]));
+            };
+
+            // The AABB holds every corner of the transformed OBB and is no bigger than it needs to be.
+            std::array<float, 3> cornerMin{INFINITY, INFINITY, INFINITY};
+            std::array<float, 3> cornerMax{-INFINITY, -INFINITY, -INFINITY};
+            const std::array<float, 6>& obb = obbs[obbIndices[entity]];
+            for (int corner = 0; corner < 8; corner++) {
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    float position = modelMatrices[entity][12 + axis];
+                    for (std::size_t obbAxis = 0; obbAxis < 3; obbAxis++) {
+                        position += modelMatrices[entity][obbAxis * 4 + axis] * obb[(corner >> obbAxis) & 1 ? obbAxis + 3 : obbAxis];
+                    };
+                    cornerMin[axis] = std::min(cornerMin[axis], position);
+                    cornerMax[axis] = std::max(cornerMax[axis], position);
+                };
+            };
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                assert(std::abs(worldAabbs.m_min[axis][entity] - cornerMin[axis]) < 1e-3f);
+                assert(std::abs(worldAabbs.m_max[axis][entity] - cornerMax[axis]) < 1e-3f);
+            };
+        };
+
+        // An unrotated, unscaled entity's AABB is its model's OBB moved by its translation.
+        float identityModel[16]{};
+        float translation[3] = {1.0f, 2.0f, 3.0f};
+        float noRotation[3] = {0.0f, 0.0f, 0.0f};
+        float unitScale[3] = {1.0f, 1.0f, 1.0f};
+        makeModelMatrix(translation, noRotation, unitScale, identityModel);
+        TransformSoa identity{};
+        identity.resize(1);
+        identity.set(0, identityModel);
+        transformObbsToAabbs(identity, {0}, modelObbs, worldAabbs);
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            assert(worldAabbs.m_min[axis][0] == obbs[0][axis] + translation[axis]);
+            assert(worldAabbs.m_max[axis][0] == obbs[0][axis + 3] + translation[axis]);
+        };
+
+        // Random boxes and spheres for the queries, also with an end that is not a multiple of the SIMD widths.
+        constexpr std::size_t numBoxes = 2011;
+        AabbSoa boxes{};
+        boxes.resize(numBoxes);
+        SphereSoa spheres{};
+        spheres.resize(numBoxes);
+        for (std::size_t box = 0; box < numBoxes; box++) {
+            for (std::size_t axis = 0; axis < 3; axis++) {
+                float center = nextFloat(-60.0f, 60.0f);
+                float halfSize = nextFloat(0.1f, 5.0f);
+                boxes.m_min[axis][box] = center - halfSize;
+                boxes.m_max[axis][box] = center + halfSize;
+                spheres.m_center[axis][box] = center;
+            };
+            spheres.m_radius[box] = nextFloat(0.1f, 5.0f);
+        };
+
+        // A frustum looking down -z from the origin, 90 degrees wide and high, from 1 to 50, as glm::perspectiveRH_ZO
+        // makes it. Its planes are x = +-z, y = +-z, z = -1 and z = -50.
+        const float near = 1.0f;
+        const float far = 50.0f;
+        const float projection[16] = {1.0f, 0.0f, 0.0f, 0.0f,
+                                      0.0f, 1.0f, 0.0f, 0.0f,
+                                      0.0f, 0.0f, far / (near - far), -1.0f,
+                                      0.0f, 0.0f, -(far * near) / (far - near), 0.0f};
+        Frustum frustum = Frustum::fromViewProjection(projection);
+        assert(std::abs(frustum.m_planes[4].m_normal[2] + 1.0f) < 1e-5f && std::abs(frustum.m_planes[4].m_distance + near) < 1e-4f);
+        assert(std::abs(frustum.m_planes[5].m_normal[2] - 1.0f) < 1e-5f && std::abs(frustum.m_planes[5].m_distance - far) < 1e-3f);
+
+        std::vector<uint8_t> isVisible;
+        std::size_t numVisible = cullAabbs(frustum, boxes, isVisible);
+        std::size_t expectedNumVisible = 0;
+        for (std::size_t box = 0; box < numBoxes; box++) {
+            // Culled when all eight corners are behind one plane.
+            bool isExpectedVisible = true;
+            for (const Plane& plane: frustum.m_planes) {
+                bool isAnyCornerInFront = false;
+                for (int corner = 0; corner < 8; corner++) {
+                    float distance = plane.m_distance;
+                    for (std::size_t axis = 0; axis < 3; axis++) {
+                        distance += plane.m_normal[axis] * ((corner >> axis) & 1 ? boxes.m_max[axis][box] : boxes.m_min[axis][box]);
+                    };
+                    isAnyCornerInFront = isAnyCornerInFront || distance >= 0.0f;
+                };
+                isExpectedVisible = isExpectedVisible && isAnyCornerInFront;
+            };
+            assert(isVisible[box] == (isExpectedVisible ? 1 : 0));
+            expectedNumVisible += isExpectedVisible ? 1 : 0;
+        };
+        assert(numVisible == expectedNumVisible && numVisible > 0 && numVisible < numBoxes);
+
+        numVisible = cullSpheres(frustum, spheres, isVisible);
+        expectedNumVisible = 0;
+        for (std::size_t sphere = 0; sphere < numBoxes; sphere++) {
+            bool isExpectedVisible = true;
+            for (const Plane& plane: frustum.m_planes) {
+                float distance = plane.m_distance;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    distance += plane.m_normal[axis] * spheres.m_center[axis][sphere];
+                };
+                isExpectedVisible = isExpectedVisible && distance + spheres.m_radius[sphere] >= 0.0f;
+            };
+            assert(isVisible[sphere] == (isExpectedVisible ? 1 : 0));
+            expectedNumVisible += isExpectedVisible ? 1 : 0;
+        };
+        assert(numVisible == expectedNumVisible && numVisible > 0 && numVisible < numBoxes);
+
+        // Rays from random points, one along an axis so the other slabs divide by zero.
+        for (int rayIndex = 0; rayIndex < 20; rayIndex++) {
+            Ray ray{{nextFloat(-60.0f, 60.0f), nextFloat(-60.0f, 60.0f), nextFloat(-60.0f, 60.0f)},
+                    {nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f), nextFloat(-1.0f, 1.0f)}};
+            if (rayIndex == 0) {
+                ray.m_direction = {0.0f, 1.0f, 0.0f};
+            };
+            const float maxDistance = 200.0f;
+            std::vector<float> hitDistances;
+            std::size_t closestHit = raycastAabbs(ray, maxDistance, boxes, hitDistances);
+
+            std::size_t expectedClosestHit = NO_HIT;
+            for (std::size_t box = 0; box < numBoxes; box++) {
+                double entry = 0.0;
+                double exit = maxDistance;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    if (ray.m_direction[axis] == 0.0f) {
+                        if (ray.m_origin[axis] < boxes.m_min[axis][box] || ray.m_origin[axis] > boxes.m_max[axis][box]) {
+                            exit = -1.0;
+                        };
+                        continue;
+                    };
+                    double inverse = 1.0 / ray.m_direction[axis];
+                    double minDistance = (boxes.m_min[axis][box] - ray.m_origin[axis]) * inverse;
+                    double maxDistance = (boxes.m_max[axis][box] - ray.m_origin[axis]) * inverse;
+                    entry = std::max(entry, std::min(minDistance, maxDistance));
+                    exit = std::min(exit, std::max(minDistance, maxDistance));
+                };
+                bool isHit = entry <= exit;
+                assert(std::isinf(hitDistances[box]) != isHit || std::abs(entry - exit) < 1e-3);
+                if (isHit && !std::isinf(hitDistances[box])) {
+                    assert(std::abs(hitDistances[box] - entry) < 1e-3 * (1.0 + entry));
+                    if (expectedClosestHit == NO_HIT || hitDistances[box] < hitDistances[expectedClosestHit]) {
+                        expectedClosestHit = box;
+                    };
+                };
+            };
+            assert(closestHit == expectedClosestHit);
+        };
+
+        // Spheres against the boxes, including one touching a box's face.
+        std::vector<uint8_t> isOverlapping;
+        for (int sphereIndex = 0; sphereIndex < 20; sphereIndex++) {
+            std::array<float, 3> center{nextFloat(-60.0f, 60.0f), nextFloat(-60.0f, 60.0f), nextFloat(-60.0f, 60.0f)};
+            float radius = nextFloat(1.0f, 20.0f);
+            std::size_t numOverlapping = overlapSphereAabbs(center, radius, boxes, isOverlapping);
+            std::size_t expectedNumOverlapping = 0;
+            for (std::size_t box = 0; box < numBoxes; box++) {
+                double squaredDistance = 0.0;
+                for (std::size_t axis = 0; axis < 3; axis++) {
+                    double offset = center[axis] - std::min(std::max(center[axis], boxes.m_min[axis][box]), boxes.m_max[axis][box]);
+                    squaredDistance += offset * offset;
+                };
+                bool isExpectedOverlapping = squaredDistance <= static_cast<double>(radius) * radius;
+                if (std::abs(squaredDistance - static_cast<double>(radius) * radius) > 1e-3) {
+                    assert(isOverlapping[box] == (isExpectedOverlapping ? 1 : 0));
+                };
+                expectedNumOverlapping += isOverlapping[box];
+            };
+            assert(numOverlapping == expectedNumOverlapping);
+        };
+        std::array<float, 3> touchingCenter{boxes.m_max[0][0] + 2.0f, boxes.m_min[1][0], boxes.m_min[2][0]};
+        overlapSphereAabbs(touchingCenter, 2.0f, boxes, isOverlapping);
+        assert(isOverlapping[0] == 1);
+    };
+
+} // namespace ae